@@ -1,14 +1,42 @@
 #include "MainWindow.h"
 #include "RangeSelector.h"
 #include "StrategyExplorer.h"
+#include "SolverWorker.h"
+#include "Card.h"
 #include <QApplication>
 #include <QStyle>
 #include <QFile>
+#include <QFileDialog>
 #include <QDebug>
 #include <QSpacerItem>
 #include <QScrollArea>
 #include <QSizePolicy>
 #include <QTextEdit>
+#include <QThread>
+#include <QTimer>
+#include <QStatusBar>
+#include <QRegularExpression>
+#include <optional>
+#include <vector>
+
+namespace config = poker_solver::config;
+namespace solver = poker_solver::solver;
+
+namespace {
+
+// Sizes typed as "50 100" or "50, 100"; nullopt if any is not a number.
+std::optional<std::vector<double>> parseSizes(const QString &text) {
+    std::vector<double> sizes;
+    for (const QString &token : text.split(QRegularExpression("[\\s,]+"), Qt::SkipEmptyParts)) {
+        bool ok = false;
+        double size = token.toDouble(&ok);
+        if (!ok || size <= 0) return std::nullopt;
+        sizes.push_back(size);
+    }
+    return sizes;
+}
+
+} // namespace
 
 // Define inputStyle as a static const member variable
 const QString MainWindow::inputStyle = 
@@ -26,6 +54,23 @@ const QString MainWindow::inputStyle =
 MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
     setupUI();
     applyStyles();
+
+    // Progress is polled rather than signalled per iteration, so a fast
+    // solver cannot flood the GUI thread's event queue.
+    progressTimer = new QTimer(this);
+    progressTimer->setInterval(100);
+    connect(progressTimer, &QTimer::timeout, this, &MainWindow::drainSolverProgress);
+}
+
+MainWindow::~MainWindow() {
+    if (solverWorker) {
+        // Training stops before its next iteration; wait for it so the
+        // worker is not destroyed under its thread.
+        solverWorker->requestStop();
+        solverThread->wait();
+        delete solverWorker;
+        delete solverThread;
+    }
 }
 
 void MainWindow::setupUI() {
@@ -326,13 +371,15 @@ void MainWindow::applyStyles() {
 }
 
 void MainWindow::showIPRangeSelector() {
-    RangeSelector *selector = new RangeSelector(this, true);
-    selector->exec();
+    RangeSelector selector(this, true);
+    selector.setRangeString(ipRange);
+    if (selector.exec() == QDialog::Accepted) ipRange = selector.rangeString();
 }
 
 void MainWindow::showOOPRangeSelector() {
-    RangeSelector *selector = new RangeSelector(this, false);
-    selector->exec();
+    RangeSelector selector(this, false);
+    selector.setRangeString(oopRange);
+    if (selector.exec() == QDialog::Accepted) oopRange = selector.rangeString();
 }
 
 void MainWindow::copyIPtoOOP() {
@@ -351,36 +398,148 @@ void MainWindow::copyIPtoOOP() {
 }
 
 void MainWindow::buildTree() {
-    appendToLog("Loading holdem compairing file");
-    appendToLog("Loading shortdeck compairing file");
-    appendToLog("Loading finished. Good to go.");
-    appendToLog("building tree...");
-    appendToLog("build tree finished");
+    startWorker(false);
 }
 
 void MainWindow::estimateMemory() {
+    // Building the tree reports the estimate; nothing is trained.
     appendToLog("Estimating memory requirements...");
-    // Add actual memory estimation logic here
+    startWorker(false);
 }
 
 void MainWindow::startSolving() {
-    appendToLog("Start Solving..");
-    appendToLog("Using 8 threads");
-    appendToLog("Iter: 0");
-    appendToLog("player 0 exploitability 43.9384");
-    appendToLog("player 1 exploitability 27.9392");
-    appendToLog("Total exploitability 71.8775 precent");
-    appendToLog("------------------");
+    startWorker(true);
 }
 
 void MainWindow::stopSolving() {
+    if (!solverWorker) return;
     appendToLog("Stopping solver...");
+    solverWorker->requestStop();
+}
+
+bool MainWindow::readSolveRequest(SolveRequest &request) {
+    auto fail = [this](const QString &error) {
+        appendToLog(error);
+        return false;
+    };
+
+    request.board.clear();
+    for (const QString &card : boardInput->text().split(QRegularExpression("[\\s,]+"), Qt::SkipEmptyParts)) {
+        std::optional<int> cardInt = poker_solver::core::Card::StringToInt(card.toStdString());
+        if (!cardInt) return fail(QString("Invalid board card: %1").arg(card));
+        request.board.push_back(*cardInt);
+    }
+    if (request.board.size() < 3 || request.board.size() > 5) return fail("The board needs 3 to 5 cards.");
+    if (ipRange.isEmpty() || oopRange.isEmpty()) return fail("Select both players' ranges first.");
+    request.ranges = {ipRange.toStdString(), oopRange.toStdString()};
+
+    bool ok = false;
+    request.pot = potInput->text().toDouble(&ok);
+    if (!ok || request.pot <= 0) return fail("Invalid pot.");
+    request.effectiveStack = effectiveStackInput->text().toDouble(&ok);
+    if (!ok || request.effectiveStack <= 0) return fail("Invalid effective stack.");
+    request.raiseLimit = raiseLimitInput->text().toInt(&ok);
+    if (!ok || request.raiseLimit < 0) return fail("Invalid raise limit.");
+    request.allinThreshold = allinThresholdInput->text().toDouble(&ok);
+    if (!ok || request.allinThreshold <= 0) return fail("Invalid all-in threshold.");
+
+    auto street = [&](const StreetControls &controls, const QString &name,
+                      config::StreetSetting &setting) {
+        std::optional<std::vector<double>> bets = parseSizes(controls.betSizes->text());
+        std::optional<std::vector<double>> raises = parseSizes(controls.raiseSizes->text());
+        if (!bets || !raises) return fail(QString("Invalid %1 bet or raise sizes.").arg(name));
+        setting = config::StreetSetting(*bets, *raises, {}, controls.addAllIn->isChecked());
+        return true;
+    };
+    config::StreetSetting flopIpSetting, turnIpSetting, riverIpSetting;
+    config::StreetSetting flopOopSetting, turnOopSetting, riverOopSetting;
+    if (!street(flopIP, "flop IP", flopIpSetting) || !street(turnIP, "turn IP", turnIpSetting) ||
+        !street(riverIP, "river IP", riverIpSetting) || !street(flopOOP, "flop OOP", flopOopSetting) ||
+        !street(turnOOP, "turn OOP", turnOopSetting) || !street(riverOOP, "river OOP", riverOopSetting)) {
+        return false;
+    }
+    request.buildSettings = config::GameTreeBuildingSettings(flopIpSetting, turnIpSetting, riverIpSetting,
+                                                            flopOopSetting, turnOopSetting, riverOopSetting);
+
+    solver::PCfrSolver::Config &solverConfig = request.solverConfig;
+    solverConfig.iteration_limit = iterationsInput->text().toInt(&ok);
+    if (!ok || solverConfig.iteration_limit <= 0) return fail("Invalid iteration count.");
+    solverConfig.target_exploitability = exploitabilityInput->text().toDouble(&ok);
+    if (!ok || solverConfig.target_exploitability < 0) return fail("Invalid target exploitability.");
+    solverConfig.exploitability_interval = logIntervalInput->text().toInt(&ok);
+    if (!ok || solverConfig.exploitability_interval <= 0) return fail("Invalid log interval.");
+    solverConfig.num_threads = threadsInput->text().toInt(&ok);
+    if (!ok || solverConfig.num_threads <= 0) return fail("Invalid thread count.");
+    solverConfig.use_isomorphism = useIsomorphismCheck->isChecked();
+    return true;
+}
+
+void MainWindow::startWorker(bool train) {
+    if (solverWorker) {
+        appendToLog("The solver is already running.");
+        return;
+    }
+    SolveRequest request;
+    if (!readSolveRequest(request)) return;
+    request.train = train;
+    if (train) appendToLog("Start Solving..");
+
+    solverProgress = std::make_shared<solver::SolverProgressQueue>();
+    solverThread = new QThread;
+    solverWorker = new SolverWorker(std::move(request), solverProgress);
+    solverWorker->moveToThread(solverThread);
+    connect(solverThread, &QThread::started, solverWorker, &SolverWorker::run);
+    connect(solverWorker, &SolverWorker::message, this, &MainWindow::appendToLog);
+    // Direct: ends the thread's event loop from the worker thread itself.
+    connect(solverWorker, &SolverWorker::finished, solverThread, &QThread::quit, Qt::DirectConnection);
+    connect(solverWorker, &SolverWorker::finished, this, &MainWindow::onSolverFinished);
+
+    buildTreeButton->setEnabled(false);
+    startSolvingButton->setEnabled(false);
+    solverThread->start(QThread::LowPriority);
+    progressTimer->start();
+}
+
+void MainWindow::drainSolverProgress() {
+    if (!solverProgress) return;
+    std::optional<solver::SolverProgress> latest;
+    while (std::optional<solver::SolverProgress> progress = solverProgress->Pop()) {
+        latest = progress;
+        if (progress->exploitability >= 0) {
+            appendToLog(QString("Iter: %1  exploitability %2% of pot  (%3 s)")
+                            .arg(progress->iteration)
+                            .arg(progress->exploitability, 0, 'f', 4)
+                            .arg(progress->elapsed_seconds, 0, 'f', 1));
+        }
+    }
+    if (latest) {
+        statusBar()->showMessage(QString("Iteration %1  |  %2 s  |  %3 MB resident")
+                                     .arg(latest->iteration)
+                                     .arg(latest->elapsed_seconds, 0, 'f', 1)
+                                     .arg(static_cast<double>(latest->resident_bytes) / (1024.0 * 1024.0), 0, 'f', 0));
+    }
+}
+
+void MainWindow::onSolverFinished() {
+    progressTimer->stop();
+    drainSolverProgress();
+    solverThread->wait();
+    delete solverWorker;
+    delete solverThread;
+    solverWorker = nullptr;
+    solverThread = nullptr;
+    solverProgress.reset();
+    buildTreeButton->setEnabled(true);
+    startSolvingButton->setEnabled(true);
 }
 
 void MainWindow::showResult() {
     appendToLog("Showing results...");
     // Open the StrategyExplorer dialog as a modal window
     StrategyExplorer explorer(this);
+    QString path = QFileDialog::getOpenFileName(this, "Open strategy file", QString(),
+                                                "Strategy files (*.strategy);;All files (*)");
+    if (!path.isEmpty()) explorer.openStrategyFile(path);
     explorer.exec();
 }
 
@@ -12,6 +12,14 @@
 #include <QGridLayout>
 #include "RangeSelector.h"
 #include <QTextEdit>
+#include <QString>
+#include <memory>
+
+class QThread;
+class QTimer;
+class SolverWorker;
+struct SolveRequest;
+namespace poker_solver { namespace solver { class SolverProgressQueue; } }
 
 struct StreetControls {
     QLineEdit *betSizes;
@@ -24,6 +32,7 @@ class MainWindow : public QMainWindow {
 
 public:
     MainWindow(QWidget *parent = nullptr);
+    ~MainWindow();
 
 private slots:
     void showIPRangeSelector();
@@ -36,6 +45,8 @@ private slots:
     void showResult();
     void clearLog();
     void appendToLog(const QString& text);
+    void drainSolverProgress();
+    void onSolverFinished();
 
 private:
     static const QString inputStyle;
@@ -79,8 +90,20 @@ private:
     
     // Log Area
     QTextEdit *logTextEdit;
-    
+
+    // Range strings chosen in the range selectors
+    QString ipRange;
+    QString oopRange;
+
+    // Solver run; null while idle
+    QThread *solverThread = nullptr;
+    SolverWorker *solverWorker = nullptr;
+    std::shared_ptr<poker_solver::solver::SolverProgressQueue> solverProgress;
+    QTimer *progressTimer;
+
     void setupUI();
+    void startWorker(bool train);
+    bool readSolveRequest(SolveRequest &request);
     QWidget* createStreetControls(const QString& title, StreetControls& controls);
     void applyStyles();
 };
@@ -283,6 +283,14 @@ void RangeSelector::applyStyles() {
     setStyleSheet("QDialog { background-color: #1F2937; }");
 }
 
+QString RangeSelector::rangeString() const {
+    return rangeText->toPlainText().trimmed();
+}
+
+void RangeSelector::setRangeString(const QString &range) {
+    rangeText->setPlainText(range);
+}
+
 void RangeSelector::confirmSelection() {
     // Accept the dialog (you can add further processing here)
     accept();
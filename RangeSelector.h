@@ -14,6 +14,10 @@ class RangeSelector : public QDialog {
 public:
     RangeSelector(QWidget *parent = nullptr, bool isIP = true);
 
+    // Range string as typed or built from the table (e.g. "AA,KQs:0.5").
+    QString rangeString() const;
+    void setRangeString(const QString &range);
+
 private slots:
     void confirmSelection();
     void clearRange();
@@ -0,0 +1,116 @@
+#include "SolverWorker.h"
+
+#include "GameTree.h"
+#include "Card.h"
+#include "Deck.h"
+#include "compairer/Dic5Compairer.h"
+#include "compairer/Dic7Compairer.h"
+#include "ranges/PrivateCardsManager.h"
+#include "ranges/RiverRangeManager.h"
+#include "tools/PrivateRangeConverter.h"
+#include "tools/Rule.h"
+
+#include <exception>
+#include <utility>
+
+namespace core = poker_solver::core;
+namespace solver = poker_solver::solver;
+
+namespace {
+
+// The 7-card table takes a while to build; every solve in the process shares it.
+std::shared_ptr<core::Compairer> sharedCompairer() {
+    static const std::shared_ptr<core::Compairer> compairer =
+        std::make_shared<poker_solver::eval::Dic7Compairer>(poker_solver::eval::Dic5Compairer());
+    return compairer;
+}
+
+QString formatBytes(uint64_t bytes) {
+    const double mb = static_cast<double>(bytes) / (1024.0 * 1024.0);
+    return mb >= 1024.0 ? QString("%1 GB").arg(mb / 1024.0, 0, 'f', 2) : QString("%1 MB").arg(mb, 0, 'f', 1);
+}
+
+core::GameRound startingRound(size_t boardCards) {
+    if (boardCards >= 5) return core::GameRound::kRiver;
+    if (boardCards == 4) return core::GameRound::kTurn;
+    return core::GameRound::kFlop;
+}
+
+} // namespace
+
+SolverWorker::SolverWorker(SolveRequest request, std::shared_ptr<solver::SolverProgressQueue> progress)
+    : request(std::move(request)), progress(std::move(progress)) {}
+
+void SolverWorker::requestStop() {
+    stopRequested = true;
+    std::lock_guard<std::mutex> lock(solverMutex);
+    if (pcfrSolver) pcfrSolver->Stop();
+}
+
+void SolverWorker::run() {
+    try {
+        emit message("Building tree...");
+        core::Deck deck;
+        poker_solver::config::Rule rule(deck, request.pot / 2.0, request.pot / 2.0,
+                                        startingRound(request.board.size()), request.board,
+                                        request.raiseLimit, 0.5, 1.0, request.effectiveStack,
+                                        request.buildSettings, request.allinThreshold);
+        auto tree = std::make_shared<poker_solver::tree::GameTree>(rule);
+        const auto &stats = tree->GetBuildStats();
+        emit message(QString("Tree built: %1 action, %2 chance, %3 showdown, %4 terminal nodes")
+                         .arg(stats.action_nodes)
+                         .arg(stats.chance_nodes)
+                         .arg(stats.showdown_nodes)
+                         .arg(stats.terminal_nodes));
+
+        std::vector<std::vector<core::PrivateCards>> ranges;
+        for (const std::string &range : request.ranges) {
+            ranges.push_back(poker_solver::ranges::PrivateRangeConverter::StringToPrivateCards(range, request.board));
+        }
+        const solver::PCfrSolver::MemoryEstimate estimate = solver::PCfrSolver::EstimateMemory(
+            *tree, rule, {ranges[0].size(), ranges[1].size()}, request.solverConfig);
+        emit message(QString("Memory for %1 IP / %2 OOP hands, %3 threads: %4 total "
+                             "(trainables %5, river cache %6, tree %7, scratch %8)")
+                         .arg(ranges[0].size())
+                         .arg(ranges[1].size())
+                         .arg(request.solverConfig.num_threads)
+                         .arg(formatBytes(estimate.Total()))
+                         .arg(formatBytes(estimate.trainable_bytes))
+                         .arg(formatBytes(estimate.river_cache_bytes))
+                         .arg(formatBytes(estimate.tree_bytes))
+                         .arg(formatBytes(estimate.scratch_bytes)));
+        if (!request.train) {
+            emit finished();
+            return;
+        }
+        const uint64_t physicalBytes = solver::PhysicalMemoryBytes();
+        if (physicalBytes > 0 && estimate.Total() > physicalBytes) {
+            emit message(QString("Not solving: the estimate exceeds the %1 of physical memory. "
+                                 "Use fewer bet sizes, smaller ranges or a lower precision.")
+                             .arg(formatBytes(physicalBytes)));
+            emit finished();
+            return;
+        }
+
+        emit message("Loading hand ranks...");
+        auto pcm = std::make_shared<poker_solver::ranges::PrivateCardsManager>(
+            std::move(ranges), core::Card::CardIntsToUint64(request.board));
+        auto rrm = std::make_shared<poker_solver::ranges::RiverRangeManager>(sharedCompairer());
+        auto newSolver = std::make_shared<solver::PCfrSolver>(tree, pcm, rrm, rule, request.solverConfig);
+        newSolver->SetProgressQueue(progress);
+        {
+            // Published under the lock so requestStop never waits on setup.
+            std::lock_guard<std::mutex> lock(solverMutex);
+            pcfrSolver = newSolver;
+            // A stop that came in during setup is kept for Train().
+            if (stopRequested) pcfrSolver->Stop();
+        }
+
+        emit message(QString("Solving with %1 threads...").arg(request.solverConfig.num_threads));
+        pcfrSolver->Train();
+        emit message(stopRequested ? "Solver stopped." : "Solving finished.");
+    } catch (const std::exception &e) {
+        emit message(QString("Solver error: %1").arg(e.what()));
+    }
+    emit finished();
+}
@@ -0,0 +1,62 @@
+#ifndef SOLVERWORKER_H
+#define SOLVERWORKER_H
+
+#include <QObject>
+#include <QString>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "solver/PCfrSolver.h"
+#include "solver/SolverProgress.h"
+#include "tools/GameTreeBuildingSettings.h"
+
+// Everything the worker needs to build a tree and solve it, read from the
+// main window's inputs on the GUI thread.
+struct SolveRequest {
+    std::vector<int> board;
+    std::array<std::string, 2> ranges; // Range strings of player 0 (IP) and 1 (OOP)
+    double pot = 0;
+    double effectiveStack = 0;
+    int raiseLimit = 0;
+    double allinThreshold = 0.98;
+    poker_solver::config::GameTreeBuildingSettings buildSettings;
+    poker_solver::solver::PCfrSolver::Config solverConfig;
+    bool train = true; // false: build the tree and stop
+};
+
+// Builds the game tree and runs PCfrSolver::Train for one SolveRequest. Meant
+// to be moved to its own QThread: run() blocks for the whole solve while the
+// OpenMP team trains, so the GUI thread only ever drains the progress queue
+// and never waits on the solver.
+class SolverWorker : public QObject {
+    Q_OBJECT
+
+public:
+    SolverWorker(SolveRequest request, std::shared_ptr<poker_solver::solver::SolverProgressQueue> progress);
+
+    // Safe from any thread. Skips training if it has not started yet,
+    // otherwise stops it before its next iteration (PCfrSolver::Stop).
+    void requestStop();
+
+public slots:
+    void run();
+
+signals:
+    // Build steps and errors, for the log.
+    void message(const QString &text);
+    // Emitted once run() is done, whether it trained, was stopped or failed.
+    void finished();
+
+private:
+    SolveRequest request;
+    std::shared_ptr<poker_solver::solver::SolverProgressQueue> progress;
+    std::atomic<bool> stopRequested{false};
+    std::mutex solverMutex; // Guards pcfrSolver against requestStop
+    std::shared_ptr<poker_solver::solver::PCfrSolver> pcfrSolver;
+};
+
+#endif // SOLVERWORKER_H
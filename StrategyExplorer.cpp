@@ -13,16 +13,56 @@
 #include <QBrush>
 #include <QColor>
 #include <QEvent>
+#include <QTreeWidget>
+#include <QTreeWidgetItem>
+#include <QLayoutItem>
+#include <QMetaObject>
+
+#include "solver/HandGrid.h"
+#include "solver/StrategyFile.h"
+#include "Card.h"
+
+#include <algorithm>
+#include <exception>
+#include <string>
+
+namespace solver = poker_solver::solver;
+namespace core = poker_solver::core;
+
+namespace {
+
+// Item data roles of the game tree.
+constexpr int kPathRole = Qt::UserRole;          // Node path in the strategy file
+constexpr int kKindRole = Qt::UserRole + 1;      // ItemKind
+constexpr int kNodeRole = Qt::UserRole + 2;      // Node number (ItemKind::Node)
+constexpr int kExpandedRole = Qt::UserRole + 3;  // Children added
+
+QString childPath(const QString &path, const QString &component) {
+    return path.isEmpty() ? component : path + "/" + component;
+}
+
+// Matrix and rough strategy colour of an action.
+QColor actionColor(const QString &action) {
+    if (action.startsWith("CHECK") || action.startsWith("CALL")) return QColor("#10B981");
+    if (action.startsWith("FOLD")) return QColor("#3B82F6");
+    return QColor("#F87171");
+}
+
+} // namespace
 
 StrategyExplorer::StrategyExplorer(QWidget *parent)
     : QDialog(parent)
 {
     setWindowTitle("Strategy Explorer");
     setMinimumSize(800, 600);
+    loader.setMaxThreadCount(1);
     setupUI();
 }
 
-StrategyExplorer::~StrategyExplorer() {}
+StrategyExplorer::~StrategyExplorer() {
+    // Loads call back into this dialog.
+    loader.waitForDone();
+}
 
 void StrategyExplorer::setupUI() {
     // Main grid layout: 2 columns (left, right) similar to HTML grid-cols-[1fr,1.2fr]
@@ -47,19 +87,16 @@ void StrategyExplorer::setupUI() {
     QLabel *gameTreeTitle = new QLabel("Game Tree");
     gameTreeTitle->setStyleSheet("font-size: 12px; margin-bottom: 8px;");
     gameTreeLayout->addWidget(gameTreeTitle);
-    // "⊟ FLOP begin" label
-    QLabel *flopBeginLabel = new QLabel("⊟ FLOP begin");
-    flopBeginLabel->setStyleSheet("background-color: #2563EB; padding: 4px;");
-    gameTreeLayout->addWidget(flopBeginLabel);
-    // OOP strategies list with left margin
-    QWidget *oopStrategies = new QWidget;
-    QVBoxLayout *oopLayout = new QVBoxLayout(oopStrategies);
-    oopLayout->setContentsMargins(20, 0, 0, 0); // mimic ml-4
-    oopLayout->setSpacing(4);
-    oopLayout->addWidget(new QLabel("⊞ OOP CHECK"));
-    oopLayout->addWidget(new QLabel("⊞ OOP BET 25"));
-    oopLayout->addWidget(new QLabel("⊞ OOP BET 200"));
-    gameTreeLayout->addWidget(oopStrategies);
+    // Filled from a strategy file, one level at a time as items expand
+    gameTree = new QTreeWidget;
+    gameTree->setHeaderHidden(true);
+    gameTree->setStyleSheet("QTreeWidget { background-color: #374151; }");
+    connect(gameTree, &QTreeWidget::itemExpanded, this, &StrategyExplorer::onItemExpanded);
+    connect(gameTree, &QTreeWidget::currentItemChanged, this, &StrategyExplorer::onCurrentItemChanged);
+    gameTreeLayout->addWidget(gameTree);
+    statusLabel = new QLabel("No strategy file loaded");
+    statusLabel->setStyleSheet("color: #9CA3AF; font-size: 12px;");
+    gameTreeLayout->addWidget(statusLabel);
     leftLayout->addWidget(gameTreeFrame);
 
     // --- Card Selectors ---
@@ -187,47 +224,8 @@ void StrategyExplorer::setupUI() {
 
     // Rough Strategy Grid (3 cells)
     QWidget *roughStrategyWidget = new QWidget;
-    QGridLayout *roughStrategyLayout = new QGridLayout(roughStrategyWidget);
+    roughStrategyLayout = new QGridLayout(roughStrategyWidget);
     roughStrategyLayout->setSpacing(5);
-    {
-        // Cell 1: CHECK
-        QFrame *cell = new QFrame;
-        cell->setFrameShape(QFrame::StyledPanel);
-        cell->setStyleSheet("background-color: #10B981; padding: 4px; border-radius: 4px;");
-        QVBoxLayout *cellLayout = new QVBoxLayout(cell);
-        QLabel *cellTitle = new QLabel("CHECK");
-        cellTitle->setStyleSheet("font-weight: bold;");
-        cellLayout->addWidget(cellTitle);
-        cellLayout->addWidget(new QLabel("98.9%"));
-        cellLayout->addWidget(new QLabel("273.2 combos"));
-        roughStrategyLayout->addWidget(cell, 0, 0);
-    }
-    {
-        // Cell 2: BET 25.0
-        QFrame *cell = new QFrame;
-        cell->setFrameShape(QFrame::StyledPanel);
-        cell->setStyleSheet("background-color: #F87171; padding: 4px; border-radius: 4px;");
-        QVBoxLayout *cellLayout = new QVBoxLayout(cell);
-        QLabel *cellTitle = new QLabel("BET 25.0");
-        cellTitle->setStyleSheet("font-weight: bold;");
-        cellLayout->addWidget(cellTitle);
-        cellLayout->addWidget(new QLabel("1.1%"));
-        cellLayout->addWidget(new QLabel("3.0 combos"));
-        roughStrategyLayout->addWidget(cell, 0, 1);
-    }
-    {
-        // Cell 3: BET 200.0
-        QFrame *cell = new QFrame;
-        cell->setFrameShape(QFrame::StyledPanel);
-        cell->setStyleSheet("background-color: #F87171; padding: 4px; border-radius: 4px;");
-        QVBoxLayout *cellLayout = new QVBoxLayout(cell);
-        QLabel *cellTitle = new QLabel("BET 200.0");
-        cellTitle->setStyleSheet("font-weight: bold;");
-        cellLayout->addWidget(cellTitle);
-        cellLayout->addWidget(new QLabel("0.0%"));
-        cellLayout->addWidget(new QLabel("0.0 combos"));
-        roughStrategyLayout->addWidget(cell, 0, 2);
-    }
     miscLayout->addWidget(roughStrategyWidget);
 
     // Board Info
@@ -235,7 +233,7 @@ void StrategyExplorer::setupUI() {
     QVBoxLayout *boardInfoLayout = new QVBoxLayout(boardInfoWidget);
     QLabel *boardLabel = new QLabel("board: Q♠ J♥ 2♥");
     boardLabel->setStyleSheet("color: #9CA3AF; font-size: 12px;");
-    QLabel *decisionNodeLabel = new QLabel("OOP decision node");
+    decisionNodeLabel = new QLabel("");
     decisionNodeLabel->setStyleSheet("color: #9CA3AF; font-size: 12px;");
     boardInfoLayout->addWidget(boardLabel);
     boardInfoLayout->addWidget(decisionNodeLabel);
@@ -301,4 +299,159 @@ bool StrategyExplorer::eventFilter(QObject *obj, QEvent *event)
     }
     // Pass the event on to the base class
     return QDialog::eventFilter(obj, event);
-} 
\ No newline at end of file
+} 
+
+// --- Strategy Files ---
+
+void StrategyExplorer::openStrategyFile(const QString &path) {
+    const int generation = ++loadGeneration;
+    gameTree->clear();
+    strategyFile.reset();
+    gridCache.reset();
+    statusLabel->setText("Opening " + path + "...");
+    const std::string filePath = path.toStdString();
+    loader.start([this, filePath, generation]() {
+        std::shared_ptr<const solver::StrategyFile> file;
+        QString error;
+        try {
+            file = std::make_shared<const solver::StrategyFile>(filePath);
+        } catch (const std::exception &e) {
+            error = QString::fromStdString(e.what());
+        }
+        QMetaObject::invokeMethod(this, [this, file, error, generation]() {
+            if (generation != loadGeneration) return;
+            if (!file) {
+                statusLabel->setText(error);
+                return;
+            }
+            strategyFile = file;
+            gridCache = std::make_shared<solver::HandGridCache>(file);
+            statusLabel->setText(QString("%1 strategy nodes").arg(file->NumNodes()));
+            QTreeWidgetItem *root = makeItem("Root", "");
+            gameTree->addTopLevelItem(root);
+            gameTree->setCurrentItem(root);
+            root->setExpanded(true);
+        }, Qt::QueuedConnection);
+    });
+}
+
+QTreeWidgetItem *StrategyExplorer::makeItem(const QString &label, const QString &path) {
+    QTreeWidgetItem *item = new QTreeWidgetItem(QStringList(label));
+    item->setData(0, kPathRole, path);
+    item->setData(0, kExpandedRole, false);
+    ItemKind kind = ItemKind::Leaf;
+    if (auto node = strategyFile->Find(path.toStdString())) {
+        kind = ItemKind::Node;
+        item->setData(0, kNodeRole, static_cast<qulonglong>(*node));
+    } else {
+        // An action into a chance node: its children are the dealt cards.
+        for (int card = 0; card < core::kNumCardsInDeck; ++card) {
+            QString cardPath = childPath(path, QString::fromStdString(core::Card::IntToString(card)));
+            if (strategyFile->Find(cardPath.toStdString())) {
+                kind = ItemKind::Deal;
+                break;
+            }
+        }
+    }
+    item->setData(0, kKindRole, static_cast<int>(kind));
+    item->setChildIndicatorPolicy(kind == ItemKind::Leaf ? QTreeWidgetItem::DontShowIndicator
+                                                         : QTreeWidgetItem::ShowIndicator);
+    if (kind == ItemKind::Leaf) item->setForeground(0, QBrush(QColor("#9CA3AF")));
+    return item;
+}
+
+void StrategyExplorer::addChildItems(QTreeWidgetItem *item) {
+    if (!strategyFile || item->data(0, kExpandedRole).toBool()) return;
+    item->setData(0, kExpandedRole, true);
+    const QString path = item->data(0, kPathRole).toString();
+    const auto kind = static_cast<ItemKind>(item->data(0, kKindRole).toInt());
+    if (kind == ItemKind::Node) {
+        const size_t node = item->data(0, kNodeRole).toULongLong();
+        const QString player = strategyFile->Player(node) == 1 ? "OOP " : "IP ";
+        for (const std::string &action : strategyFile->Actions(node)) {
+            QString label = QString::fromStdString(action);
+            item->addChild(makeItem(player + label, childPath(path, label)));
+        }
+    } else if (kind == ItemKind::Deal) {
+        for (int card = 0; card < core::kNumCardsInDeck; ++card) {
+            QString label = QString::fromStdString(core::Card::IntToString(card));
+            QString cardPath = childPath(path, label);
+            if (strategyFile->Find(cardPath.toStdString())) item->addChild(makeItem(label, cardPath));
+        }
+    }
+    if (item->childCount() == 0) item->setChildIndicatorPolicy(QTreeWidgetItem::DontShowIndicator);
+}
+
+void StrategyExplorer::onItemExpanded(QTreeWidgetItem *item) {
+    addChildItems(item);
+}
+
+void StrategyExplorer::onCurrentItemChanged(QTreeWidgetItem *current, QTreeWidgetItem *) {
+    if (!current || !strategyFile) return;
+    if (static_cast<ItemKind>(current->data(0, kKindRole).toInt()) != ItemKind::Node) return;
+    const int generation = ++loadGeneration;
+    const size_t node = current->data(0, kNodeRole).toULongLong();
+    std::shared_ptr<const solver::StrategyFile> file = strategyFile;
+    std::shared_ptr<solver::HandGridCache> grids = gridCache;
+    decisionNodeLabel->setText("Loading...");
+    loader.start([this, file, grids, node, generation]() {
+        NodeSummary summary = summarizeNode(*file, *grids, node);
+        QMetaObject::invokeMethod(this, [this, summary, generation]() {
+            if (generation == loadGeneration) showNodeSummary(summary);
+        }, Qt::QueuedConnection);
+    });
+}
+
+StrategyExplorer::NodeSummary StrategyExplorer::summarizeNode(const solver::StrategyFile &file,
+                                                              solver::HandGridCache &grids, size_t node) {
+    NodeSummary summary;
+    summary.player = file.Player(node);
+    for (const std::string &action : file.Actions(node)) summary.actions << QString::fromStdString(action);
+    // Revisited nodes come straight from the cache.
+    summary.grid = grids.Get(node);
+    return summary;
+}
+
+void StrategyExplorer::showNodeSummary(const NodeSummary &summary) {
+    decisionNodeLabel->setText(summary.player == 1 ? "OOP decision node" : "IP decision node");
+
+    // Hand matrix: most played action and its frequency per cell.
+    for (int row = 0; row < core::kNumRanks; ++row) {
+        for (int col = 0; col < core::kNumRanks; ++col) {
+            QTableWidgetItem *item = handMatrix->item(row, col);
+            const QString hand = item->text().section('\n', 0, 0);
+            const size_t cell = row * core::kNumRanks + col;
+            if (summary.grid->num_hands[cell] == 0) {
+                item->setText(hand);
+                item->setBackground(QBrush(QColor("#4B5563")));
+                continue;
+            }
+            const double *frequencies = summary.grid->strategy.data() + cell * summary.grid->num_actions;
+            const size_t top = std::max_element(frequencies, frequencies + summary.grid->num_actions) - frequencies;
+            item->setText(hand + "\n" + QString::number(frequencies[top] * 100.0, 'f', 0) + "%");
+            item->setBackground(QBrush(actionColor(summary.actions[top])));
+        }
+    }
+
+    // Rough strategy: share of the range's combos per action.
+    while (QLayoutItem *child = roughStrategyLayout->takeAt(0)) {
+        delete child->widget();
+        delete child;
+    }
+    double totalCombos = 0.0;
+    for (double combos : summary.grid->action_combos) totalCombos += combos;
+    for (int a = 0; a < summary.actions.size(); ++a) {
+        QFrame *cell = new QFrame;
+        cell->setFrameShape(QFrame::StyledPanel);
+        cell->setStyleSheet(QString("background-color: %1; padding: 4px; border-radius: 4px;")
+                                .arg(actionColor(summary.actions[a]).name()));
+        QVBoxLayout *cellLayout = new QVBoxLayout(cell);
+        QLabel *cellTitle = new QLabel(summary.actions[a]);
+        cellTitle->setStyleSheet("font-weight: bold;");
+        cellLayout->addWidget(cellTitle);
+        double share = totalCombos > 0.0 ? summary.grid->action_combos[a] / totalCombos * 100.0 : 0.0;
+        cellLayout->addWidget(new QLabel(QString::number(share, 'f', 1) + "%"));
+        cellLayout->addWidget(new QLabel(QString::number(summary.grid->action_combos[a], 'f', 1) + " combos"));
+        roughStrategyLayout->addWidget(cell, 0, a);
+    }
+}
@@ -2,10 +2,20 @@
 #define STRATEGYEXPLORER_H
 
 #include <QDialog>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <memory>
+#include <vector>
 
 // Forward declarations
 class QTableWidget;
+class QTreeWidget;
+class QTreeWidgetItem;
+class QLabel;
+class QGridLayout;
 class QEvent;
+namespace poker_solver { namespace solver { class StrategyFile; class HandGridCache; struct HandGrid; } }
 
 class StrategyExplorer : public QDialog {
     Q_OBJECT
@@ -14,15 +24,49 @@ public:
     explicit StrategyExplorer(QWidget *parent = nullptr);
     ~StrategyExplorer();
 
+    // Opens a strategy file written by PCfrSolver::WriteStrategyFile. The
+    // file is mapped and its index checked on a background thread; a node's
+    // strategy is read only when the node is shown, and the game tree grows
+    // as its items are expanded, so opening does not depend on file size.
+    void openStrategyFile(const QString &path);
+
 protected:
     // Declare the event filter override so it can be defined out-of-line.
     bool eventFilter(QObject *obj, QEvent *event) override;
 
+private slots:
+    void onItemExpanded(QTreeWidgetItem *item);
+    void onCurrentItemChanged(QTreeWidgetItem *current, QTreeWidgetItem *previous);
+
 private:
+    // What a game tree item stands for.
+    enum class ItemKind { Node, Deal, Leaf };
+
+    // Strategy of one node summed for display, computed off the GUI thread.
+    struct NodeSummary {
+        size_t player = 0;
+        QStringList actions;
+        std::shared_ptr<const poker_solver::solver::HandGrid> grid; // From gridCache
+    };
+
     void setupUI();
+    QTreeWidgetItem *makeItem(const QString &label, const QString &path);
+    void addChildItems(QTreeWidgetItem *item);
+    void showNodeSummary(const NodeSummary &summary);
+    static NodeSummary summarizeNode(const poker_solver::solver::StrategyFile &file,
+                                     poker_solver::solver::HandGridCache &grids, size_t node);
 
     // Member variable for the hand matrix
     QTableWidget *handMatrix;
+    QTreeWidget *gameTree;
+    QLabel *statusLabel;
+    QLabel *decisionNodeLabel;
+    QGridLayout *roughStrategyLayout;
+
+    std::shared_ptr<const poker_solver::solver::StrategyFile> strategyFile;
+    std::shared_ptr<poker_solver::solver::HandGridCache> gridCache; // Of strategyFile
+    QThreadPool loader;     // One thread, so loads finish in request order
+    int loadGeneration = 0; // Bumped per request; older results are dropped
 };
 
-#endif // STRATEGYEXPLORER_H 
\ No newline at end of file
+#endif // STRATEGYEXPLORER_H
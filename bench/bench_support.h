@@ -0,0 +1,61 @@
+#ifndef POKER_SOLVER_BENCH_BENCH_SUPPORT_H_
+#define POKER_SOLVER_BENCH_BENCH_SUPPORT_H_
+
+#include "Card.h"
+#include "ranges/PrivateCards.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace poker_solver {
+namespace bench {
+
+// The river board every benchmark plays on: As Kd 8h 5c 2s.
+inline std::vector<int> RiverBoard() {
+    std::vector<int> board;
+    for (const char* card : {"As", "Kd", "8h", "5c", "2s"}) board.push_back(core::Card::StringToInt(card).value());
+    return board;
+}
+
+inline uint64_t RiverBoardMask() { return core::Card::CardIntsToUint64(RiverBoard()); }
+
+// The first 'num_combos' of the 1326 two-card combos in the shuffle of
+// 'seed', minus those blocked by 'board_mask'. 1326 is the full range, 1081
+// hands on a river board.
+inline std::vector<core::PrivateCards> MakeRange(size_t num_combos, uint64_t board_mask, uint32_t seed = 1) {
+    std::vector<core::PrivateCards> all;
+    for (int c1 = 0; c1 < core::kNumCardsInDeck; ++c1) {
+        for (int c2 = c1 + 1; c2 < core::kNumCardsInDeck; ++c2) all.emplace_back(c1, c2);
+    }
+    std::mt19937 rng(seed);
+    std::shuffle(all.begin(), all.end(), rng);
+    std::vector<core::PrivateCards> range;
+    for (size_t i = 0; i < num_combos && i < all.size(); ++i) {
+        if (!core::Card::DoBoardsOverlap(all[i].GetBoardMask(), board_mask)) range.push_back(all[i]);
+    }
+    return range;
+}
+
+// Reach in (0, 1], varied so no kernel sees a constant vector.
+inline std::vector<double> MakeReach(size_t size) {
+    std::vector<double> reach(size);
+    std::mt19937 rng(static_cast<uint32_t>(size));
+    std::uniform_real_distribution<double> uniform(0.05, 1.0);
+    for (double& value : reach) value = uniform(rng);
+    return reach;
+}
+
+// Range sizes every per-range benchmark runs at (combos before board removal).
+inline void RangeSizes(benchmark::internal::Benchmark* b) {
+    for (int combos : {100, 500, 1326}) b->Arg(combos);
+    b->ArgName("combos");
+}
+
+} // namespace bench
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_BENCH_BENCH_SUPPORT_H_
@@ -0,0 +1,90 @@
+// Hand evaluation: Dic5Compairer ranks and the river combos built from them.
+
+#include "bench_support.h"
+
+#include "compairer/Dic5Compairer.h"
+#include "ranges/RiverRangeManager.h"
+
+#include <memory>
+#include <vector>
+
+namespace poker_solver {
+namespace bench {
+namespace {
+
+// One hand's rank on the river board, hand by hand over the range.
+void BM_Dic5GetHandRank(benchmark::State& state) {
+    const eval::Dic5Compairer compairer;
+    const uint64_t board_mask = RiverBoardMask();
+    const std::vector<core::PrivateCards> range = MakeRange(static_cast<size_t>(state.range(0)), board_mask);
+    for (auto _ : state) {
+        for (const auto& hand : range) benchmark::DoNotOptimize(compairer.GetHandRank(hand.GetBoardMask(), board_mask));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(range.size()));
+}
+BENCHMARK(BM_Dic5GetHandRank)->Apply(RangeSizes)->ThreadRange(1, 8);
+
+// The batched form RiverRangeManager uses.
+void BM_Dic5RankRange(benchmark::State& state) {
+    const eval::Dic5Compairer compairer;
+    const uint64_t board_mask = RiverBoardMask();
+    const std::vector<core::PrivateCards> range = MakeRange(static_cast<size_t>(state.range(0)), board_mask);
+    std::vector<uint64_t> masks;
+    for (const auto& hand : range) masks.push_back(hand.GetBoardMask());
+    std::vector<int> ranks(masks.size());
+    for (auto _ : state) {
+        compairer.RankRange(masks.data(), masks.size(), board_mask, ranks.data());
+        benchmark::DoNotOptimize(ranks.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(range.size()));
+}
+BENCHMARK(BM_Dic5RankRange)->Apply(RangeSizes)->ThreadRange(1, 8);
+
+// A cache miss: ranking and sorting the range for a new board.
+void BM_RiverCombosCold(benchmark::State& state) {
+    auto compairer = std::make_shared<eval::Dic5Compairer>();
+    const uint64_t board_mask = RiverBoardMask();
+    const std::vector<core::PrivateCards> range = MakeRange(static_cast<size_t>(state.range(0)), board_mask);
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto rrm = std::make_unique<ranges::RiverRangeManager>(compairer);
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(&rrm->GetPackedRiverCombos(0, range, board_mask));
+        state.PauseTiming();
+        rrm.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(range.size()));
+}
+BENCHMARK(BM_RiverCombosCold)->Apply(RangeSizes);
+
+// A cache hit, shared by all benchmark threads as by the solver's workers.
+void BM_RiverCombosWarm(benchmark::State& state) {
+    static std::shared_ptr<ranges::RiverRangeManager> rrm;
+    static std::vector<core::PrivateCards> range;
+    const uint64_t board_mask = RiverBoardMask();
+    if (state.thread_index() == 0) {
+        rrm = std::make_shared<ranges::RiverRangeManager>(std::make_shared<eval::Dic5Compairer>());
+        range = MakeRange(static_cast<size_t>(state.range(0)), board_mask);
+        rrm->GetPackedRiverCombos(0, range, board_mask);
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(&rrm->GetPackedRiverCombos(0, range, board_mask));
+    }
+    if (state.thread_index() == 0) rrm.reset();
+}
+BENCHMARK(BM_RiverCombosWarm)->Apply(RangeSizes)->ThreadRange(1, 8);
+
+// The unpacked copy GetRiverCombos returns, for inspection code paths.
+void BM_GetRiverCombos(benchmark::State& state) {
+    ranges::RiverRangeManager rrm(std::make_shared<eval::Dic5Compairer>());
+    const uint64_t board_mask = RiverBoardMask();
+    const std::vector<core::PrivateCards> range = MakeRange(static_cast<size_t>(state.range(0)), board_mask);
+    for (auto _ : state) benchmark::DoNotOptimize(rrm.GetRiverCombos(0, range, board_mask));
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(range.size()));
+}
+BENCHMARK(BM_GetRiverCombos)->Apply(RangeSizes);
+
+} // namespace
+} // namespace bench
+} // namespace poker_solver
@@ -0,0 +1,59 @@
+// Board-keyed lookups: hashing::FlatHashMap against std::unordered_map.
+
+#include "bench_support.h"
+
+#include "tools/FlatHashMap.h"
+
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace poker_solver {
+namespace bench {
+namespace {
+
+// 'count' distinct random 5-card board masks.
+std::vector<uint64_t> MakeBoardMasks(size_t count) {
+    std::mt19937_64 rng(count);
+    std::unordered_map<uint64_t, bool> seen;
+    std::vector<uint64_t> boards;
+    while (boards.size() < count) {
+        uint64_t board = 0;
+        while (__builtin_popcountll(board) < 5) board |= 1ULL << (rng() % core::kNumCardsInDeck);
+        if (seen.emplace(board, true).second) boards.push_back(board);
+    }
+    return boards;
+}
+
+// What find returns for a missing key.
+const int* Find(const hashing::FlatHashMap<int>&) { return nullptr; }
+std::unordered_map<uint64_t, int>::const_iterator Find(const std::unordered_map<uint64_t, int>& map) {
+    return map.end();
+}
+
+// Every board is looked up once per iteration, half of them absent (as
+// for the river cache before it fills up).
+template <typename Map>
+void LookupBoards(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    const std::vector<uint64_t> boards = MakeBoardMasks(2 * count);
+    Map map;
+    map.reserve(count);
+    for (size_t i = 0; i < count; ++i) map[boards[i]] = static_cast<int>(i);
+    for (auto _ : state) {
+        int found = 0;
+        for (uint64_t board : boards) found += map.find(board) != Find(map);
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(boards.size()));
+}
+
+void BM_FlatHashMapLookup(benchmark::State& state) { LookupBoards<hashing::FlatHashMap<int>>(state); }
+BENCHMARK(BM_FlatHashMapLookup)->RangeMultiplier(16)->Range(64, 1 << 16);
+
+void BM_UnorderedMapLookup(benchmark::State& state) { LookupBoards<std::unordered_map<uint64_t, int>>(state); }
+BENCHMARK(BM_UnorderedMapLookup)->RangeMultiplier(16)->Range(64, 1 << 16);
+
+} // namespace
+} // namespace bench
+} // namespace poker_solver
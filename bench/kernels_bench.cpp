@@ -0,0 +1,71 @@
+// Leaf kernels behind PCfrSolver's showdown and fold (terminal) nodes.
+
+#include "bench_support.h"
+
+#include "compairer/Dic5Compairer.h"
+#include "ranges/RiverRangeManager.h"
+#include "solver/UtilityKernels.h"
+
+#include <memory>
+#include <vector>
+
+namespace poker_solver {
+namespace bench {
+namespace {
+
+// Both players' ranges of 'combos' combos on the river board, drawn from
+// different shuffles.
+struct RiverSpot {
+    explicit RiverSpot(size_t combos)
+        : board_mask(RiverBoardMask()),
+          ranges{MakeRange(combos, board_mask, 1), MakeRange(combos, board_mask, 2)},
+          reach{MakeReach(ranges[0].size()), MakeReach(ranges[1].size())},
+          utility(ranges[0].size()) {}
+
+    uint64_t board_mask;
+    std::vector<core::PrivateCards> ranges[2];
+    std::vector<double> reach[2];
+    std::vector<double> utility;
+};
+
+// What cfr_showdown_node runs per river board: one sorted sweep over the
+// cached combos of both players.
+void BM_ShowdownUtilitySweep(benchmark::State& state) {
+    RiverSpot spot(static_cast<size_t>(state.range(0)));
+    ranges::RiverRangeManager rrm(std::make_shared<eval::Dic5Compairer>());
+    const ranges::PackedRiverCombos& traverser = rrm.GetPackedRiverCombos(0, spot.ranges[0], spot.board_mask);
+    const ranges::PackedRiverCombos& opponent = rrm.GetPackedRiverCombos(1, spot.ranges[1], spot.board_mask);
+    for (auto _ : state) {
+        solver::ShowdownUtilitySweep(traverser, opponent, spot.ranges[0].size(), spot.reach[1].data(),
+                                     spot.reach[1].size(), 10.0, -10.0, 0.0, spot.utility.data());
+        benchmark::DoNotOptimize(spot.utility.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(spot.ranges[0].size()));
+}
+BENCHMARK(BM_ShowdownUtilitySweep)->Apply(RangeSizes)->ThreadRange(1, 8);
+
+// What cfr_terminal_node runs at a fold.
+void BM_FoldUtilityLinear(benchmark::State& state) {
+    RiverSpot spot(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        solver::FoldUtilityLinear(spot.ranges[0], spot.ranges[1], spot.reach[1].data(), 10.0, spot.utility.data());
+        benchmark::DoNotOptimize(spot.utility.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(spot.ranges[0].size()));
+}
+BENCHMARK(BM_FoldUtilityLinear)->Apply(RangeSizes)->ThreadRange(1, 8);
+
+// The O(n^2) reference (FoldEvaluator::kPairwise), for comparison.
+void BM_FoldUtilityPairwise(benchmark::State& state) {
+    RiverSpot spot(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        solver::FoldUtilityPairwise(spot.ranges[0], spot.ranges[1], spot.reach[1].data(), 10.0, spot.utility.data());
+        benchmark::DoNotOptimize(spot.utility.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(spot.ranges[0].size()));
+}
+BENCHMARK(BM_FoldUtilityPairwise)->Apply(RangeSizes);
+
+} // namespace
+} // namespace bench
+} // namespace poker_solver
@@ -0,0 +1,199 @@
+// poker_solver_kuhn_bench: convergence and throughput regression harness.
+//
+// Solves Kuhn poker (kuhn/kuhn_poker_setup.h), whose game value is known,
+// once per trainer mode of kuhn::kuhn_convergence_modes(): every trainer and
+// precision, and the lossy modes (fp16 tables, pruning, chance sampling).
+// The report, written as JSON, gives each mode's exploitability against
+// iterations, its iterations per second (exploitability checks excluded),
+// its final exploitability and best-response value against the game value,
+// and whether it met its bound. It runs in well under a second, so it can
+// gate any change to a trainer or traversal. Exit status: 0 when every mode
+// met its bound, 1 when any missed it (or failed), 2 on bad arguments.
+
+#include "kuhn/kuhn_poker_setup.h"
+#include "solver/PCfrSolver.h"
+#include "solver/SolverProgress.h"
+
+#include <json.hpp>
+
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace kuhn = poker_solver::kuhn;
+namespace solver = poker_solver::solver;
+using json = nlohmann::json;
+
+namespace {
+
+struct Options {
+  std::vector<std::string> modes; // Empty: all
+  int check_every = 10;
+  std::string output = "kuhn_bench.json";
+};
+
+constexpr const char* kUsage =
+    "Usage: poker_solver_kuhn_bench [options] [MODE...]\n"
+    "\n"
+    "Solves Kuhn poker with each trainer mode (default: all of them) and\n"
+    "reports its convergence and speed as JSON.\n"
+    "\n"
+    "      --check-every N      exploitability check interval (default 10)\n"
+    "  -o, --output PATH        report file (default kuhn_bench.json)\n"
+    "  -l, --list               list the modes and their bounds\n"
+    "  -h, --help               show this help\n";
+
+int ParseInt(const std::string& flag, const std::string& value) {
+    size_t used = 0;
+    int result = 0;
+    try {
+        result = std::stoi(value, &used);
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (used == 0 || used != value.size()) throw std::invalid_argument(flag + ": not an integer: " + value);
+    return result;
+}
+
+// Throws std::invalid_argument on bad arguments.
+Options ParseArguments(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument(arg + " needs a value");
+            return argv[++i];
+        };
+        if (arg == "--check-every") {
+            options.check_every = ParseInt(arg, value());
+        } else if (arg == "-o" || arg == "--output") {
+            options.output = value();
+        } else if (!arg.empty() && arg[0] == '-') {
+            throw std::invalid_argument("unknown option " + arg);
+        } else {
+            options.modes.push_back(arg);
+        }
+    }
+    if (options.check_every < 1) throw std::invalid_argument("--check-every must be positive");
+    return options;
+}
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Solves Kuhn poker with one mode and returns its report.
+json RunMode(const Options& options, const kuhn::KuhnConvergenceMode& mode) {
+    solver::PCfrSolver::Config config = mode.config;
+    config.exploitability_interval = options.check_every;
+    auto pcfr_solver = kuhn::make_kuhn_solver(config);
+    auto progress_queue =
+        std::make_shared<solver::SolverProgressQueue>(static_cast<size_t>(config.iteration_limit) + 1);
+    pcfr_solver->SetProgressQueue(progress_queue);
+
+    const auto start = std::chrono::steady_clock::now();
+    pcfr_solver->Train();
+    const double train_seconds = SecondsSince(start);
+
+    double check_seconds = 0.0;
+    json exploitability_trace = json::array();
+    while (std::optional<solver::SolverProgress> progress = progress_queue->Pop()) {
+        if (progress->exploitability < 0.0) continue;
+        check_seconds += progress->exploitability_seconds;
+        exploitability_trace.push_back({{"iteration", progress->iteration},
+                                        {"exploitability", progress->exploitability}});
+    }
+
+    // The last check ran after the last iteration, so these are its values.
+    const double exploitability = pcfr_solver->GetLastExploitability();
+    const double first_player_value = pcfr_solver->GetBestResponseValues()[kuhn::KUHN_FIRST_PLAYER];
+    const int iterations = pcfr_solver->GetCompletedIterations();
+    const double training_seconds = train_seconds - check_seconds;
+    json report;
+    report["mode"] = mode.name;
+    report["iterations"] = iterations;
+    report["iterations_per_second"] = training_seconds > 0.0 ? iterations / training_seconds : 0.0;
+    report["final_exploitability"] = exploitability;
+    report["max_exploitability"] = mode.max_exploitability;
+    report["first_player_best_response"] = first_player_value;
+    report["game_value"] = kuhn::KUHN_GAME_VALUE;
+    report["passed"] = exploitability <= mode.max_exploitability;
+    report["exploitability_trace"] = exploitability_trace;
+    return report;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            std::cout << kUsage;
+            return 0;
+        }
+        if (arg == "-l" || arg == "--list") {
+            for (const kuhn::KuhnConvergenceMode& mode : kuhn::kuhn_convergence_modes()) {
+                std::cout << mode.name << ": " << mode.config.iteration_limit << " iterations, at most "
+                          << mode.max_exploitability << "% of pot\n";
+            }
+            return 0;
+        }
+    }
+    Options options;
+    try {
+        options = ParseArguments(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "poker_solver_kuhn_bench: " << e.what() << "\n\n" << kUsage;
+        return 2;
+    }
+
+    std::vector<kuhn::KuhnConvergenceMode> modes;
+    for (kuhn::KuhnConvergenceMode& mode : kuhn::kuhn_convergence_modes()) {
+        bool selected = options.modes.empty();
+        for (const std::string& name : options.modes) selected = selected || name == mode.name;
+        if (selected) modes.push_back(std::move(mode));
+    }
+    for (const std::string& name : options.modes) {
+        bool known = false;
+        for (const kuhn::KuhnConvergenceMode& mode : modes) known = known || mode.name == name;
+        if (!known) {
+            std::cerr << "poker_solver_kuhn_bench: unknown mode " << name << " (see --list)\n\n" << kUsage;
+            return 2;
+        }
+    }
+
+    json report;
+    report["check_every"] = options.check_every;
+    report["modes"] = json::array();
+    size_t failed = 0;
+    for (const kuhn::KuhnConvergenceMode& mode : modes) {
+        try {
+            json result = RunMode(options, mode);
+            const bool passed = result["passed"].get<bool>();
+            std::cerr << (passed ? "[RESULT] " : "[FAILED] ") << mode.name << ": "
+                      << result["iterations"].get<int>() << " iterations, "
+                      << result["iterations_per_second"].get<double>() << " it/s, exploitability "
+                      << result["final_exploitability"].get<double>() << "% of pot (bound "
+                      << mode.max_exploitability << "%)" << std::endl;
+            if (!passed) ++failed;
+            report["modes"].push_back(std::move(result));
+        } catch (const std::exception& e) {
+            std::cerr << "[ERROR] " << mode.name << ": " << e.what() << std::endl;
+            report["modes"].push_back({{"mode", mode.name}, {"error", e.what()}});
+            ++failed;
+        }
+    }
+
+    std::ofstream out(options.output);
+    if (!out || !(out << report.dump(2) << '\n')) {
+        std::cerr << "[ERROR] Cannot write " << options.output << std::endl;
+        return 1;
+    }
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,334 @@
+// poker_solver_solve_bench: end-to-end solves of reference spots.
+//
+// Each scenario file (see tools/ScenarioFile.h; bench/scenarios holds the
+// reference river SRP, turn 3BP and two-size flop SRP spots) is solved from
+// scratch and timed by phase: tree building, setup, river cache, training
+// and exploitability checks. The report, written as JSON, gives iterations
+// per second, the time and iterations to reach a target exploitability, and
+// peak resident memory per scenario, so runs on different machines or
+// commits can be compared. Exit status: 0 when every scenario was solved, 1
+// when any failed, 2 on bad arguments.
+
+#include "Card.h"
+#include "Deck.h"
+#include "GameTree.h"
+#include "compairer/Dic5Compairer.h"
+#include "ranges/PrivateCardsManager.h"
+#include "ranges/RiverRangeManager.h"
+#include "solver/PCfrSolver.h"
+#include "solver/SolverProgress.h"
+#include "solver/TraceRecorder.h"
+#include "solver/TraversalStats.h"
+#include "solver/BuildInfo.h"
+#include "solver/VectorKernels.h"
+#include "tools/PrivateRangeConverter.h"
+#include "tools/ScenarioFile.h"
+
+#include <json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <omp.h>
+#if defined(__linux__)
+#include <sys/resource.h>
+#endif
+
+namespace core = poker_solver::core;
+namespace config = poker_solver::config;
+namespace eval = poker_solver::eval;
+namespace ranges = poker_solver::ranges;
+namespace solver = poker_solver::solver;
+namespace tree = poker_solver::tree;
+using json = nlohmann::json;
+
+namespace {
+
+struct Options {
+  std::vector<std::string> scenarios;
+  int threads = 0; // 0: hardware concurrency
+  std::optional<int> iterations;
+  double target_exploitability = 0.5;
+  int check_every = 10;
+  std::string output = "solve_bench.json";
+  std::string trace; // Chrome trace path; empty: no tracing
+};
+
+constexpr const char* kUsage =
+    "Usage: poker_solver_solve_bench [options] [SCENARIO.json...]\n"
+    "\n"
+    "Solves each scenario (default: the reference spots in scenarios/ next to\n"
+    "the executable) and reports its timings as JSON.\n"
+    "\n"
+    "  -t, --threads N          solver threads (default: all cores)\n"
+    "  -i, --iterations N       iterations per scenario (default: scenario's)\n"
+    "  -e, --exploitability P   target exploitability, % of the pot (default 0.5);\n"
+    "                           timed, but training runs all iterations\n"
+    "      --check-every N      exploitability check interval (default 10)\n"
+    "  -o, --output PATH        report file (default solve_bench.json)\n"
+    "      --trace PATH         also write a Chrome trace of the solves to PATH\n"
+    "  -h, --help               show this help\n";
+
+constexpr const char* kDefaultScenarios[] = {
+    "scenarios/river_srp.json",
+    "scenarios/turn_3bp.json",
+    "scenarios/flop_srp_2sizes.json",
+};
+
+int ParseInt(const std::string& flag, const std::string& value) {
+    size_t used = 0;
+    int result = 0;
+    try {
+        result = std::stoi(value, &used);
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (used == 0 || used != value.size()) throw std::invalid_argument(flag + ": not an integer: " + value);
+    return result;
+}
+
+double ParseDouble(const std::string& flag, const std::string& value) {
+    size_t used = 0;
+    double result = 0.0;
+    try {
+        result = std::stod(value, &used);
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (used == 0 || used != value.size()) throw std::invalid_argument(flag + ": not a number: " + value);
+    return result;
+}
+
+// Throws std::invalid_argument on bad arguments.
+Options ParseArguments(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument(arg + " needs a value");
+            return argv[++i];
+        };
+        if (arg == "-t" || arg == "--threads") {
+            options.threads = ParseInt(arg, value());
+        } else if (arg == "-i" || arg == "--iterations") {
+            options.iterations = ParseInt(arg, value());
+        } else if (arg == "-e" || arg == "--exploitability") {
+            options.target_exploitability = ParseDouble(arg, value());
+        } else if (arg == "--check-every") {
+            options.check_every = ParseInt(arg, value());
+        } else if (arg == "-o" || arg == "--output") {
+            options.output = value();
+        } else if (arg == "--trace") {
+            options.trace = value();
+        } else if (!arg.empty() && arg[0] == '-') {
+            throw std::invalid_argument("unknown option " + arg);
+        } else {
+            options.scenarios.push_back(arg);
+        }
+    }
+    if (options.threads < 0) throw std::invalid_argument("--threads must not be negative");
+    if (options.iterations && *options.iterations < 1) throw std::invalid_argument("--iterations must be positive");
+    if (options.check_every < 1) throw std::invalid_argument("--check-every must be positive");
+    if (options.scenarios.empty()) options.scenarios.assign(std::begin(kDefaultScenarios), std::end(kDefaultScenarios));
+    return options;
+}
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Starts a new peak resident set measurement where the kernel allows it
+// (Linux: writing 5 to clear_refs resets VmHWM); otherwise peaks carry over
+// from earlier scenarios.
+void ResetPeakResident() {
+#if defined(__linux__)
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    if (clear_refs) clear_refs << "5";
+#endif
+}
+
+// Peak resident set size of the process in bytes, or 0 where unknown.
+uint64_t PeakResidentBytes() {
+#if defined(__linux__)
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) == 0) return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+    return 0;
+}
+
+std::string CompilerName() {
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc " + std::to_string(_MSC_VER);
+#else
+    return "unknown";
+#endif
+}
+
+// Solves one scenario and returns its report. Throws on load or solve errors.
+json RunScenario(const Options& options, const std::string& path, const std::shared_ptr<core::Compairer>& compairer,
+                 int threads, const std::shared_ptr<solver::TraceRecorder>& trace) {
+    core::Deck deck;
+    const config::Scenario scenario = config::LoadScenarioFile(path, deck);
+    const std::vector<int> board = scenario.rule.GetInitialBoardCardsInt();
+    const uint64_t board_mask = core::Card::CardIntsToUint64(board);
+
+    solver::PCfrSolver::Config solver_config;
+    solver_config.iteration_limit = options.iterations.value_or(scenario.iterations > 0 ? scenario.iterations : 100);
+    solver_config.num_threads = threads;
+    solver_config.exploitability_interval = options.check_every;
+    // The river cache is built (and timed) as its own phase below.
+    solver_config.warmup_river_cache = false;
+
+    ResetPeakResident();
+    json phases = json::object();
+    auto phase_start = std::chrono::steady_clock::now();
+    auto game_tree = std::make_shared<tree::GameTree>(scenario.rule);
+    phases["tree_build"] = SecondsSince(phase_start);
+
+    phase_start = std::chrono::steady_clock::now();
+    std::vector<std::vector<core::PrivateCards>> player_ranges;
+    for (const std::string& range : scenario.ranges) {
+        player_ranges.push_back(ranges::PrivateRangeConverter::StringToPrivateCards(range, board));
+    }
+    auto pcm = std::make_shared<ranges::PrivateCardsManager>(player_ranges, board_mask);
+    auto rrm = std::make_shared<ranges::RiverRangeManager>(compairer);
+    solver::PCfrSolver pcfr_solver(game_tree, pcm, rrm, scenario.rule, solver_config);
+    auto progress_queue = std::make_shared<solver::SolverProgressQueue>(
+        static_cast<size_t>(solver_config.iteration_limit) + 1);
+    pcfr_solver.SetProgressQueue(progress_queue);
+    pcfr_solver.SetTraceRecorder(trace);
+    phases["setup"] = SecondsSince(phase_start);
+
+    phase_start = std::chrono::steady_clock::now();
+    {
+        solver::TraceSpan span(trace.get(), "river cache", "solver");
+        rrm->PreloadRiverBoards(pcm->GetPlayerRange(0), pcm->GetPlayerRange(1), board_mask,
+                                scenario.rule.GetDeck().GetCardsMask());
+    }
+    phases["river_cache"] = SecondsSince(phase_start);
+
+    phase_start = std::chrono::steady_clock::now();
+    pcfr_solver.Train();
+    const double train_seconds = SecondsSince(phase_start);
+
+    double check_seconds = 0.0;
+    int checks = 0;
+    json exploitability_trace = json::array();
+    json to_target = nullptr;
+    while (std::optional<solver::SolverProgress> progress = progress_queue->Pop()) {
+        if (progress->exploitability < 0.0) continue;
+        check_seconds += progress->exploitability_seconds;
+        ++checks;
+        exploitability_trace.push_back({{"iteration", progress->iteration},
+                         {"seconds", progress->elapsed_seconds},
+                         {"exploitability", progress->exploitability}});
+        if (to_target.is_null() && progress->exploitability <= options.target_exploitability) {
+            to_target = {{"iteration", progress->iteration},
+                         {"seconds", progress->elapsed_seconds},
+                         {"training_seconds", progress->elapsed_seconds - check_seconds}};
+        }
+    }
+    phases["training"] = train_seconds - check_seconds;
+    phases["exploitability_checks"] = check_seconds;
+
+    const int iterations = pcfr_solver.GetCompletedIterations();
+    const double training_seconds = phases["training"].get<double>();
+    json report;
+    report["scenario"] = scenario.name.empty() ? path : scenario.name;
+    report["file"] = path;
+    report["description"] = scenario.description;
+    report["hands"] = {player_ranges[0].size(), player_ranges[1].size()};
+    report["iterations"] = iterations;
+    report["iterations_per_second"] = training_seconds > 0.0 ? iterations / training_seconds : 0.0;
+    report["final_exploitability"] = pcfr_solver.GetLastExploitability();
+    report["target"] = to_target;
+    report["peak_resident_bytes"] = PeakResidentBytes();
+    const solver::PCfrSolver::MemoryStats memory = pcfr_solver.GetMemoryStats();
+    report["memory_bytes"] = {{"tree", memory.tree_bytes},
+                              {"trainables", memory.trainable_bytes},
+                              {"river_cache", memory.river_cache_bytes}};
+    report["phases_seconds"] = phases;
+    report["exploitability_trace"] = exploitability_trace;
+    if (solver::kTraversalStatsEnabled) report["traversal_stats"] = pcfr_solver.GetTraversalStats().ToJson();
+    return report;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "-h" || std::string(argv[i]) == "--help") {
+            std::cout << kUsage;
+            return 0;
+        }
+    }
+    Options options;
+    try {
+        options = ParseArguments(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "poker_solver_solve_bench: " << e.what() << "\n\n" << kUsage;
+        return 2;
+    }
+
+    const int threads = options.threads > 0 ? options.threads
+                                            : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    omp_set_num_threads(threads);
+    std::shared_ptr<core::Compairer> compairer = std::make_shared<eval::Dic5Compairer>();
+    std::shared_ptr<solver::TraceRecorder> trace;
+    if (!options.trace.empty()) trace = std::make_shared<solver::TraceRecorder>();
+
+    json report;
+    report["host"] = {{"threads", threads},
+                      {"hardware_concurrency", std::thread::hardware_concurrency()},
+                      {"instruction_set", solver::kernels::ActiveInstructionSet()},
+                      {"build", solver::BuildSummary()},
+                      {"compiler", CompilerName()}};
+    report["target_exploitability"] = options.target_exploitability;
+    report["check_every"] = options.check_every;
+    report["scenarios"] = json::array();
+    size_t failed = 0;
+    for (const std::string& path : options.scenarios) {
+        try {
+            json result = RunScenario(options, path, compairer, threads, trace);
+            std::cerr << "[RESULT] " << result["scenario"].get<std::string>() << ": "
+                      << result["iterations"].get<int>() << " iterations, "
+                      << result["iterations_per_second"].get<double>() << " it/s, exploitability "
+                      << result["final_exploitability"].get<double>() << "% of pot, peak "
+                      << result["peak_resident_bytes"].get<uint64_t>() / (1024 * 1024) << " MiB" << std::endl;
+            report["scenarios"].push_back(std::move(result));
+        } catch (const std::exception& e) {
+            std::cerr << "[ERROR] " << path << ": " << e.what() << std::endl;
+            report["scenarios"].push_back({{"file", path}, {"error", e.what()}});
+            ++failed;
+        }
+    }
+
+    std::ofstream out(options.output);
+    if (!out || !(out << report.dump(2) << '\n')) {
+        std::cerr << "[ERROR] Cannot write " << options.output << std::endl;
+        return 1;
+    }
+    if (trace) {
+        try {
+            trace->WriteChromeTrace(options.trace);
+        } catch (const std::exception& e) {
+            std::cerr << "[ERROR] " << e.what() << std::endl;
+            return 1;
+        }
+    }
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,183 @@
+// Whole PCfrSolver iterations on a turn spot: every river card, with the
+// showdown and fold nodes below it, across range sizes and thread counts.
+// A flop spot whose bets are all-ins, for the turn and river runouts.
+// And the same river tree on many boards, one PCfrSolver per board against
+// one MultiBoardRiverSolver for all of them.
+
+#include "bench_support.h"
+
+#include "Deck.h"
+#include "GameTree.h"
+#include "compairer/Dic5Compairer.h"
+#include "ranges/PrivateCardsManager.h"
+#include "ranges/RiverRangeManager.h"
+#include "solver/MultiBoardRiverSolver.h"
+#include "solver/PCfrSolver.h"
+#include "tools/GameTreeBuildingSettings.h"
+#include "tools/Rule.h"
+#include "tools/StreetSetting.h"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace poker_solver {
+namespace bench {
+namespace {
+
+constexpr int kIterationsPerRun = 4;
+
+// Turn As Kd 8h 5c, 20 in the pot, 100 behind; half-pot bets and pot raises.
+void BM_SolverIterations(benchmark::State& state) {
+    const size_t combos = static_cast<size_t>(state.range(0));
+    const int threads = static_cast<int>(state.range(1));
+    std::vector<int> board = RiverBoard();
+    board.pop_back();
+    const uint64_t board_mask = core::Card::CardIntsToUint64(board);
+
+    const config::StreetSetting street{{50.0}, {100.0}, {}, true};
+    const config::GameTreeBuildingSettings settings{street, street, street, street, street, street};
+    const config::Rule rule(core::Deck(), 10.0, 10.0, core::GameRound::kTurn, board, 2, 0.5, 1.0, 110.0, settings);
+    auto game_tree = std::make_shared<tree::GameTree>(rule);
+    // Shared by every run, so only the first one fills the river cache.
+    auto rrm = std::make_shared<ranges::RiverRangeManager>(std::make_shared<eval::Dic5Compairer>());
+    const std::vector<std::vector<core::PrivateCards>> player_ranges{MakeRange(combos, board_mask, 1),
+                                                                     MakeRange(combos, board_mask, 2)};
+    solver::PCfrSolver::Config config;
+    config.iteration_limit = kIterationsPerRun;
+    config.num_threads = threads;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto pcm = std::make_shared<ranges::PrivateCardsManager>(player_ranges, board_mask);
+        auto pcfr_solver = std::make_unique<solver::PCfrSolver>(game_tree, pcm, rrm, rule, config);
+        state.ResumeTiming();
+        pcfr_solver->Train();
+        state.PauseTiming();
+        pcfr_solver.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * kIterationsPerRun);
+    state.counters["hands"] = static_cast<double>(player_ranges[0].size());
+}
+BENCHMARK(BM_SolverIterations)
+    ->ArgsProduct({{100, 500, 1326}, {1, 2, 4, 8}})
+    ->ArgNames({"combos", "threads"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Flop As Kd 8h, 20 in the pot and 20 behind: every pot-sized bet is an
+// all-in, so most of the work is the turn and river runouts after it.
+void BM_FlopAllInRunouts(benchmark::State& state) {
+    const size_t combos = static_cast<size_t>(state.range(0));
+    const int threads = static_cast<int>(state.range(1));
+    std::vector<int> board = RiverBoard();
+    board.resize(3);
+    const uint64_t board_mask = core::Card::CardIntsToUint64(board);
+
+    const config::StreetSetting street{{100.0}, {}, {}, true};
+    const config::GameTreeBuildingSettings settings{street, street, street, street, street, street};
+    const config::Rule rule(core::Deck(), 10.0, 10.0, core::GameRound::kFlop, board, 1, 0.5, 1.0, 30.0, settings);
+    auto game_tree = std::make_shared<tree::GameTree>(rule);
+    auto rrm = std::make_shared<ranges::RiverRangeManager>(std::make_shared<eval::Dic5Compairer>());
+    const std::vector<std::vector<core::PrivateCards>> player_ranges{MakeRange(combos, board_mask, 1),
+                                                                     MakeRange(combos, board_mask, 2)};
+    solver::PCfrSolver::Config config;
+    config.iteration_limit = kIterationsPerRun;
+    config.num_threads = threads;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto pcm = std::make_shared<ranges::PrivateCardsManager>(player_ranges, board_mask);
+        auto pcfr_solver = std::make_unique<solver::PCfrSolver>(game_tree, pcm, rrm, rule, config);
+        state.ResumeTiming();
+        pcfr_solver->Train();
+        state.PauseTiming();
+        pcfr_solver.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * kIterationsPerRun);
+}
+BENCHMARK(BM_FlopAllInRunouts)
+    ->ArgsProduct({{100, 500}, {1, 4}})
+    ->ArgNames({"combos", "threads"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// The first 'num_boards' rivers of the turn As Kd 8h 5c, in card order.
+std::vector<std::vector<int>> RiverBoards(size_t num_boards) {
+    std::vector<int> turn = RiverBoard();
+    turn.pop_back();
+    const uint64_t turn_mask = core::Card::CardIntsToUint64(turn);
+    std::vector<std::vector<int>> boards;
+    for (int card = 0; card < core::kNumCardsInDeck && boards.size() < num_boards; ++card) {
+        if ((turn_mask >> card) & 1ULL) continue;
+        boards.push_back(turn);
+        boards.back().push_back(card);
+    }
+    return boards;
+}
+
+// A river spot with 20 in the pot and 100 behind; half-pot bets and pot raises.
+config::Rule RiverRule(const std::vector<int>& board) {
+    const config::StreetSetting street{{50.0}, {100.0}, {}, true};
+    const config::GameTreeBuildingSettings settings{street, street, street, street, street, street};
+    return config::Rule(core::Deck(), 10.0, 10.0, core::GameRound::kRiver, board, 2, 0.5, 1.0, 110.0, settings);
+}
+
+void BM_RiverBoardsSeparate(benchmark::State& state) {
+    const size_t combos = static_cast<size_t>(state.range(0));
+    const std::vector<std::vector<int>> boards = RiverBoards(static_cast<size_t>(state.range(1)));
+    const std::vector<std::vector<core::PrivateCards>> player_ranges{MakeRange(combos, 0, 1), MakeRange(combos, 0, 2)};
+    auto rrm = std::make_shared<ranges::RiverRangeManager>(std::make_shared<eval::Dic5Compairer>());
+    solver::PCfrSolver::Config config;
+    config.iteration_limit = kIterationsPerRun;
+    config.parallel_level = solver::PCfrSolver::ParallelLevel::kNone;
+
+    for (auto _ : state) {
+        for (const std::vector<int>& board : boards) {
+            state.PauseTiming();
+            const config::Rule rule = RiverRule(board);
+            auto pcm = std::make_shared<ranges::PrivateCardsManager>(player_ranges, core::Card::CardIntsToUint64(board));
+            auto pcfr_solver = std::make_unique<solver::PCfrSolver>(std::make_shared<tree::GameTree>(rule), pcm, rrm,
+                                                                    rule, config);
+            state.ResumeTiming();
+            pcfr_solver->Train();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kIterationsPerRun * static_cast<int64_t>(boards.size()));
+}
+BENCHMARK(BM_RiverBoardsSeparate)
+    ->ArgsProduct({{100, 500, 1326}, {8, 48}})
+    ->ArgNames({"combos", "boards"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+void BM_RiverBoardsLockstep(benchmark::State& state) {
+    const size_t combos = static_cast<size_t>(state.range(0));
+    const std::vector<std::vector<int>> boards = RiverBoards(static_cast<size_t>(state.range(1)));
+    const std::array<std::vector<core::PrivateCards>, 2> player_ranges{MakeRange(combos, 0, 1), MakeRange(combos, 0, 2)};
+    std::vector<uint64_t> board_masks;
+    for (const std::vector<int>& board : boards) board_masks.push_back(core::Card::CardIntsToUint64(board));
+    auto game_tree = std::make_shared<tree::GameTree>(RiverRule(boards.front()));
+    auto rrm = std::make_shared<ranges::RiverRangeManager>(std::make_shared<eval::Dic5Compairer>());
+    solver::MultiBoardRiverSolver::Config config;
+    config.iteration_limit = kIterationsPerRun;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        solver::MultiBoardRiverSolver lockstep(game_tree, player_ranges, board_masks, rrm, config);
+        state.ResumeTiming();
+        lockstep.Train();
+    }
+    state.SetItemsProcessed(state.iterations() * kIterationsPerRun * static_cast<int64_t>(boards.size()));
+}
+BENCHMARK(BM_RiverBoardsLockstep)
+    ->ArgsProduct({{100, 500, 1326}, {8, 48}})
+    ->ArgNames({"combos", "boards"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+} // namespace
+} // namespace bench
+} // namespace poker_solver
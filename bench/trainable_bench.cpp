@@ -0,0 +1,79 @@
+// Trainable updates, run once per action node visit.
+
+#include "bench_support.h"
+
+#include "nodes/ActionNode.h"
+#include "nodes/GameActions.h"
+#include "nodes/TerminalNode.h"
+#include "trainable/DcfrDiscounts.h"
+#include "trainable/DiscountedCfrTrainable.h"
+
+#include <memory>
+#include <vector>
+
+namespace poker_solver {
+namespace bench {
+namespace {
+
+using nodes::ActionNode;
+
+// A river action node with check, a bet and all-in, over a range of
+// 'combos' combos. Each benchmark thread builds its own.
+struct TrainableSpot {
+    explicit TrainableSpot(size_t combos) : range(MakeRange(combos, RiverBoardMask())) {
+        node = std::make_shared<ActionNode>(1, core::GameRound::kRiver, 20.0, std::weak_ptr<core::GameTreeNode>(), 1);
+        auto leaf = std::make_shared<nodes::TerminalNode>(std::vector<double>{0.0, 0.0}, core::GameRound::kRiver,
+                                                          20.0, std::weak_ptr<core::GameTreeNode>(node));
+        node->AddChild(core::GameAction(core::PokerAction::kCheck), leaf);
+        node->AddChild(core::GameAction(core::PokerAction::kBet, 10.0), leaf);
+        node->AddChild(core::GameAction(core::PokerAction::kBet, 90.0), leaf);
+        node->SetPlayerRange(&range);
+        const size_t table_size = node->GetActions().size() * range.size();
+        regrets = MakeReach(table_size);
+        for (size_t i = 0; i < table_size; i += 2) regrets[i] = -regrets[i];
+        reach = MakeReach(range.size());
+    }
+
+    std::vector<core::PrivateCards> range;
+    std::shared_ptr<ActionNode> node;
+    std::vector<double> regrets; // Mixed signs, as after a real visit
+    std::vector<double> reach;
+};
+
+// The vector API: DiscountedCfrTrainable::UpdateRegrets alone.
+void BM_DiscountedUpdateRegrets(benchmark::State& state) {
+    TrainableSpot spot(static_cast<size_t>(state.range(0)));
+    solver::DiscountedCfrTrainable trainable(&spot.range, *spot.node);
+    int iteration = 1;
+    for (auto _ : state) trainable.UpdateRegrets(spot.regrets, iteration++, 1.0);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(spot.range.size()));
+}
+BENCHMARK(BM_DiscountedUpdateRegrets)->Apply(RangeSizes)->ThreadRange(1, 8);
+
+// What cfr_action_node runs per visit: the current strategy, then the fused
+// regret and average strategy update, for each storage type.
+template <ActionNode::TrainablePrecision kPrecision, ActionNode::TrainableAlgorithm kAlgorithm>
+void BM_UpdateFromVisit(benchmark::State& state) {
+    TrainableSpot spot(static_cast<size_t>(state.range(0)));
+    auto trainable = spot.node->GetTrainable(0, kPrecision, kAlgorithm);
+    std::vector<double> scratch(spot.regrets.size());
+    int iteration = 1;
+    for (auto _ : state) {
+        const solver::IterationDiscounts discounts = solver::IterationDiscounts::For(iteration++);
+        const double* strategy = trainable->CurrentStrategy(scratch.data());
+        trainable->UpdateFromVisit(spot.regrets.data(), strategy, spot.reach.data(), discounts);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(spot.range.size()));
+}
+BENCHMARK_TEMPLATE(BM_UpdateFromVisit, ActionNode::TrainablePrecision::kFloat,
+                   ActionNode::TrainableAlgorithm::kDiscounted)->Apply(RangeSizes)->ThreadRange(1, 8);
+BENCHMARK_TEMPLATE(BM_UpdateFromVisit, ActionNode::TrainablePrecision::kSingle,
+                   ActionNode::TrainableAlgorithm::kDiscounted)->Apply(RangeSizes);
+BENCHMARK_TEMPLATE(BM_UpdateFromVisit, ActionNode::TrainablePrecision::kHalf,
+                   ActionNode::TrainableAlgorithm::kDiscounted)->Apply(RangeSizes);
+BENCHMARK_TEMPLATE(BM_UpdateFromVisit, ActionNode::TrainablePrecision::kSingle,
+                   ActionNode::TrainableAlgorithm::kCfrPlus)->Apply(RangeSizes);
+
+} // namespace
+} // namespace bench
+} // namespace poker_solver
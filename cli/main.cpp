@@ -0,0 +1,566 @@
+// poker_solver_cli: solves scenario files without a display, for batch runs.
+//
+// The scenarios (see tools/ScenarioFile.h) are solved in one process by a
+// BatchSolver, which shares the hand evaluator and river caches between
+// them, and each result is written as a JSON strategy dump or a strategy
+// file (solver/StrategyFile.h). Exit status: 0 when every scenario was
+// solved, 1 when any failed, 2 on bad arguments.
+//
+// With --serve it instead runs as a long-lived service (solver/SolveService.h)
+// that takes jobs as JSON lines on stdin and reports their progress as JSON
+// lines on stdout, keeping the hand evaluator and recent river caches
+// loaded between jobs.
+
+#include "Card.h"
+#include "Deck.h"
+#include "compairer/Dic5Compairer.h"
+#include "compairer/Dic7Compairer.h"
+#include "solver/BatchSolver.h"
+#include "solver/PCfrSolver.h"
+#include "solver/SolutionStore.h"
+#include "solver/SolveService.h"
+#include "solver/SolverProgress.h"
+#include "solver/SolverTransport.h"
+#include "solver/TraceRecorder.h"
+#include "tools/ScenarioFile.h"
+
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+namespace core = poker_solver::core;
+namespace config = poker_solver::config;
+namespace eval = poker_solver::eval;
+namespace solver = poker_solver::solver;
+
+namespace {
+
+enum class OutputFormat { kJson, kStrategy, kStrategy16, kStrategy8 };
+
+struct Options {
+  std::vector<std::string> scenarios;
+  std::optional<int> threads;
+  std::optional<int> iterations;
+  double target_exploitability = 0.0;
+  std::optional<int> check_every;
+  poker_solver::nodes::ActionNode::TrainablePrecision precision =
+      poker_solver::nodes::ActionNode::TrainablePrecision::kFloat;
+  solver::PCfrSolver::Trainer trainer = solver::PCfrSolver::Trainer::kDiscounted;
+  bool use_isomorphism = false;
+  bool numa = false;
+  OutputFormat format = OutputFormat::kJson;
+  bool dump_evs = false;
+  int dump_depth = -1;
+  std::string output;
+  std::string output_dir = ".";
+  std::string rank_table;
+  int ranks = 1;
+  int rank = 0;
+  std::string coordinator_host;
+  uint16_t coordinator_port = 0;
+  double max_memory_gb = 0.0; // 0: physical memory
+  std::optional<double> small_spot_mb;
+  std::string trace;
+  std::string solution_store;
+  bool serve = false;
+};
+
+constexpr const char* kUsage =
+    "Usage: poker_solver_cli [options] SCENARIO.json...\n"
+    "\n"
+    "Solves each scenario and writes its strategy.\n"
+    "\n"
+    "  -t, --threads N          total solver threads (default: all cores); large\n"
+    "                           spots use all of them, small ones one each, side\n"
+    "                           by side\n"
+    "      --small-spot-mb X    spots with at most X MB of regret tables count as\n"
+    "                           small (default 32)\n"
+    "  -i, --iterations N       iteration limit (default: scenario, else 1000)\n"
+    "  -e, --exploitability P   stop once exploitability is at most P% of the pot\n"
+    "      --check-every N      exploitability check interval (default 10 with -e)\n"
+    "  -p, --precision P        double | single | half (default double)\n"
+    "      --trainer T          dcfr | linear | cfr+ (default dcfr)\n"
+    "      --isomorphism        solve one of each set of suit-isomorphic deals\n"
+    "      --numa               pin threads to NUMA nodes and keep each node's\n"
+    "                           turn/river subtrees in its own memory\n"
+    "  -f, --format F           json | strategy | strategy16 | strategy8 (default\n"
+    "                           json); strategy8 stores 8-bit values with\n"
+    "                           per-node scales\n"
+    "      --evs                compute EVs and include them in the output\n"
+    "      --depth N            JSON dump depth (default: whole tree)\n"
+    "  -o, --output PATH        output file (single scenario only)\n"
+    "  -d, --output-dir DIR     output directory (default .); files are named\n"
+    "                           after the scenario's test_case_name or file\n"
+    "      --rank-table PATH    map 7-card rank tables from PATH, writing it first\n"
+    "                           if missing; lets processes share one copy\n"
+    "      --max-memory-gb X    skip scenarios estimated above X GB\n"
+    "                           (default: physical memory)\n"
+    "      --trace PATH         write a Chrome trace (chrome://tracing, Perfetto)\n"
+    "                           of the solves' iterations and threads to PATH\n"
+    "      --solution-store DIR reuse spots solved before (up to suit\n"
+    "                           isomorphism) from DIR and add new ones; a\n"
+    "                           stored spot is reported with its file and suit\n"
+    "                           map instead of being written again\n"
+    "\n"
+    "Distributed solving: start one process per machine with the same scenarios\n"
+    "and options; each spot's turn cards are split among them.\n"
+    "      --ranks N            processes in the group\n"
+    "      --rank R             this process, 0 .. N-1; rank 0 coordinates\n"
+    "      --coordinator H:P    rank 0 listens on port P; the others connect to H:P\n"
+    "                           Output files are named NAME.rankR.EXT; each holds\n"
+    "                           the flop strategy and that rank's turn cards.\n"
+    "\n"
+    "Service mode: poker_solver_cli --serve [options] reads one JSON request per\n"
+    "line on stdin and writes one JSON event per line on stdout (solver logs go\n"
+    "to stderr). Jobs run by priority, side by side while their threads fit in\n"
+    "--threads. Requests (an optional \"tag\" is echoed in the reply):\n"
+    "  {\"op\": \"submit\", \"scenario\": {...}, \"priority\": P, \"threads\": N,\n"
+    "   \"iterations\": N, \"output\": PATH}    -> {\"event\": \"submitted\", \"job\": ID}\n"
+    "  {\"op\": \"cancel\", \"job\": ID}\n"
+    "  {\"op\": \"status\", \"job\": ID}\n"
+    "  {\"op\": \"shutdown\", \"cancel\": false}  finish (or cancel) the jobs and exit\n"
+    "Events: running, progress (iteration, seconds, exploitability), done,\n"
+    "failed (error) and cancelled, each with the job id. End of input acts as\n"
+    "shutdown.\n"
+    "      --serve              run as a service\n"
+    "  -h, --help               show this help\n";
+
+int ParseInt(const std::string& flag, const std::string& value) {
+    size_t used = 0;
+    int result = 0;
+    try {
+        result = std::stoi(value, &used);
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (used == 0 || used != value.size()) throw std::invalid_argument(flag + ": not an integer: " + value);
+    return result;
+}
+
+double ParseDouble(const std::string& flag, const std::string& value) {
+    size_t used = 0;
+    double result = 0.0;
+    try {
+        result = std::stod(value, &used);
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (used == 0 || used != value.size()) throw std::invalid_argument(flag + ": not a number: " + value);
+    return result;
+}
+
+// Throws std::invalid_argument on bad arguments.
+Options ParseArguments(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument(arg + " needs a value");
+            return argv[++i];
+        };
+        if (arg == "-t" || arg == "--threads") {
+            options.threads = ParseInt(arg, value());
+        } else if (arg == "-i" || arg == "--iterations") {
+            options.iterations = ParseInt(arg, value());
+        } else if (arg == "-e" || arg == "--exploitability") {
+            options.target_exploitability = ParseDouble(arg, value());
+        } else if (arg == "--check-every") {
+            options.check_every = ParseInt(arg, value());
+        } else if (arg == "-p" || arg == "--precision") {
+            const std::string precision = value();
+            using Precision = poker_solver::nodes::ActionNode::TrainablePrecision;
+            if (precision == "double") options.precision = Precision::kFloat;
+            else if (precision == "single") options.precision = Precision::kSingle;
+            else if (precision == "half") options.precision = Precision::kHalf;
+            else throw std::invalid_argument("Unknown precision: " + precision);
+        } else if (arg == "--trainer") {
+            const std::string trainer = value();
+            if (trainer == "dcfr") options.trainer = solver::PCfrSolver::Trainer::kDiscounted;
+            else if (trainer == "linear") options.trainer = solver::PCfrSolver::Trainer::kLinear;
+            else if (trainer == "cfr+") options.trainer = solver::PCfrSolver::Trainer::kCfrPlus;
+            else throw std::invalid_argument("Unknown trainer: " + trainer);
+        } else if (arg == "--isomorphism") {
+            options.use_isomorphism = true;
+        } else if (arg == "--numa") {
+            options.numa = true;
+        } else if (arg == "-f" || arg == "--format") {
+            const std::string format = value();
+            if (format == "json") options.format = OutputFormat::kJson;
+            else if (format == "strategy") options.format = OutputFormat::kStrategy;
+            else if (format == "strategy16") options.format = OutputFormat::kStrategy16;
+            else if (format == "strategy8") options.format = OutputFormat::kStrategy8;
+            else throw std::invalid_argument("Unknown format: " + format);
+        } else if (arg == "--evs") {
+            options.dump_evs = true;
+        } else if (arg == "--depth") {
+            options.dump_depth = ParseInt(arg, value());
+        } else if (arg == "-o" || arg == "--output") {
+            options.output = value();
+        } else if (arg == "-d" || arg == "--output-dir") {
+            options.output_dir = value();
+        } else if (arg == "--ranks") {
+            options.ranks = ParseInt(arg, value());
+        } else if (arg == "--rank") {
+            options.rank = ParseInt(arg, value());
+        } else if (arg == "--coordinator") {
+            const std::string address = value();
+            const size_t colon = address.rfind(':');
+            if (colon == std::string::npos) throw std::invalid_argument("--coordinator needs HOST:PORT");
+            options.coordinator_host = address.substr(0, colon);
+            const int port = ParseInt(arg, address.substr(colon + 1));
+            if (port <= 0 || port > 65535) throw std::invalid_argument("--coordinator: bad port " + address);
+            options.coordinator_port = static_cast<uint16_t>(port);
+        } else if (arg == "--rank-table") {
+            options.rank_table = value();
+        } else if (arg == "--small-spot-mb") {
+            options.small_spot_mb = ParseDouble(arg, value());
+        } else if (arg == "--trace") {
+            options.trace = value();
+        } else if (arg == "--solution-store") {
+            options.solution_store = value();
+        } else if (arg == "--serve") {
+            options.serve = true;
+        } else if (arg == "--max-memory-gb") {
+            options.max_memory_gb = ParseDouble(arg, value());
+        } else if (!arg.empty() && arg[0] == '-') {
+            throw std::invalid_argument("Unknown option: " + arg);
+        } else {
+            options.scenarios.push_back(arg);
+        }
+    }
+    if (options.serve) {
+        if (!options.scenarios.empty() || !options.output.empty() || options.ranks > 1 || !options.trace.empty()) {
+            throw std::invalid_argument("--serve takes jobs on stdin, not scenario files, --output, --ranks or --trace");
+        }
+    } else if (options.scenarios.empty()) {
+        throw std::invalid_argument("No scenario files given");
+    }
+    if (!options.output.empty() && options.scenarios.size() > 1) {
+        throw std::invalid_argument("--output needs exactly one scenario; use --output-dir");
+    }
+    if ((options.threads && *options.threads <= 0) || (options.iterations && *options.iterations <= 0) ||
+        (options.check_every && *options.check_every <= 0) || options.target_exploitability < 0.0 ||
+        (options.small_spot_mb && *options.small_spot_mb < 0.0)) {
+        throw std::invalid_argument("Counts must be positive and the target non-negative");
+    }
+    if (options.ranks < 1 || options.rank < 0 || options.rank >= options.ranks) {
+        throw std::invalid_argument("--rank must be in 0 .. --ranks - 1");
+    }
+    if (options.ranks > 1 && options.coordinator_port == 0) {
+        throw std::invalid_argument("--ranks needs --coordinator HOST:PORT");
+    }
+    return options;
+}
+
+// Built once per process; mapped from --rank-table when given.
+std::shared_ptr<core::Compairer> MakeCompairer(const Options& options) {
+    if (options.rank_table.empty()) {
+        return std::make_shared<eval::Dic7Compairer>(eval::Dic5Compairer());
+    }
+    if (!fs::exists(options.rank_table)) {
+        std::cout << "[INFO] Writing rank table " << options.rank_table << std::endl;
+        eval::Dic7Compairer(eval::Dic5Compairer()).WriteTableFile(options.rank_table);
+    }
+    return eval::Dic7Compairer::FromTableFile(options.rank_table);
+}
+
+// Output file for a scenario; its directory is created if missing.
+std::string OutputPath(const Options& options, const std::string& scenario_path, const config::Scenario& scenario) {
+    fs::path path = options.output;
+    if (path.empty()) {
+        const std::string stem = scenario.name.empty() ? fs::path(scenario_path).stem().string() : scenario.name;
+        path = fs::path(options.output_dir) / (stem + (options.format == OutputFormat::kJson ? ".json" : ".strategy"));
+    }
+    if (options.ranks > 1) {
+        path = path.parent_path() /
+               (path.stem().string() + ".rank" + std::to_string(options.rank) + path.extension().string());
+    }
+    if (path.has_parent_path()) fs::create_directories(path.parent_path());
+    return path.string();
+}
+
+// Solver settings of a scenario: command-line options first, then the
+// file's solver_config. Threads are left to the batch scheduler.
+solver::PCfrSolver::Config SolverConfig(const Options& options, const config::Scenario& scenario) {
+    solver::PCfrSolver::Config solver_config;
+    solver_config.iteration_limit = options.iterations.value_or(scenario.iterations > 0 ? scenario.iterations : 1000);
+    solver_config.precision = options.precision;
+    solver_config.trainer = options.trainer;
+    solver_config.use_isomorphism = options.use_isomorphism;
+    solver_config.numa_aware = options.numa;
+    solver_config.target_exploitability = options.target_exploitability;
+    solver_config.exploitability_interval =
+        options.check_every.value_or(options.target_exploitability > 0.0 ? 10 : 0);
+    return solver_config;
+}
+
+// Writes a solved spot in the chosen format. Throws on I/O errors.
+void WriteOutput(const Options& options, const std::string& output_path, solver::PCfrSolver& pcfr_solver) {
+    // EVs take a pass of their own, over the nodes that are written only.
+    if (options.dump_evs) {
+        pcfr_solver.ComputeEvs(options.format == OutputFormat::kJson ? options.dump_depth : -1);
+    }
+    if (options.format == OutputFormat::kJson) {
+        std::ofstream out(output_path);
+        if (!out) throw std::runtime_error("Cannot write " + output_path);
+        pcfr_solver.DumpStrategyTo(out, options.dump_evs, options.dump_depth);
+        out << '\n';
+        if (!out) throw std::runtime_error("Failed writing " + output_path);
+    } else {
+        pcfr_solver.WriteStrategyFile(output_path, options.format == OutputFormat::kStrategy16
+                                                       ? solver::StrategyValueType::kFloat16
+                                                   : options.format == OutputFormat::kStrategy8
+                                                       ? solver::StrategyValueType::kUint8
+                                                       : solver::StrategyValueType::kFloat32);
+    }
+}
+
+// One service event as a JSON line.
+nlohmann::json EventJson(const solver::SolveJobStatus& status) {
+    nlohmann::json event;
+    const bool progress = status.state == solver::SolveJobState::kRunning && status.progress;
+    event["event"] = progress ? "progress" : solver::SolveJobStateName(status.state);
+    event["job"] = status.id;
+    event["threads"] = status.threads;
+    if (status.progress) {
+        event["iteration"] = status.progress->iteration;
+        if (status.progress->exploitability >= 0.0) event["exploitability"] = status.progress->exploitability;
+    }
+    if (status.state == solver::SolveJobState::kFailed) event["error"] = status.error;
+    if (status.cached) {
+        event["cached"] = {{"strategy", status.cached->strategy_path}, {"suit_map", status.cached->suit_map}};
+    }
+    if (progress) {
+        event["seconds"] = status.progress->elapsed_seconds;
+    } else if (status.state != solver::SolveJobState::kRunning && status.state != solver::SolveJobState::kQueued) {
+        event["seconds"] = status.seconds;
+    }
+    return event;
+}
+
+// --serve: jobs from stdin until "shutdown" or end of input. Returns the
+// exit status.
+// 'protocol_buffer' is the original stdout; std::cout already writes to stderr.
+int Serve(const Options& options, std::shared_ptr<core::Compairer> compairer,
+          std::shared_ptr<solver::SolutionStore> store, std::streambuf* protocol_buffer) {
+    std::ostream protocol(protocol_buffer);
+    std::mutex protocol_mutex;
+    auto send = [&](const nlohmann::json& message) {
+        std::lock_guard<std::mutex> lock(protocol_mutex);
+        protocol << message.dump() << '\n' << std::flush;
+    };
+
+    solver::SolveService::Options service_options;
+    if (options.threads) service_options.num_threads = *options.threads;
+    service_options.solution_store = std::move(store);
+    solver::SolveService service(compairer, service_options,
+                                 [&](const solver::SolveJobStatus& status) { send(EventJson(status)); });
+    std::cout << "[INFO] Serving with " << service_options.num_threads << " threads." << std::endl;
+
+    bool cancel_on_exit = false;
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+        nlohmann::json reply;
+        try {
+            const nlohmann::json request = nlohmann::json::parse(line);
+            const std::string op = request.at("op").get<std::string>();
+            if (op == "submit") {
+                core::Deck deck;
+                config::Scenario scenario = config::ScenarioFromJson(request.at("scenario"), deck);
+                solver::PCfrSolver::Config job_config = SolverConfig(options, scenario);
+                if (request.contains("iterations")) job_config.iteration_limit = request["iterations"].get<int>();
+                job_config.num_threads = request.value(
+                    "threads", scenario.threads > 0 ? scenario.threads : service_options.num_threads);
+                solver::SolveJob job{std::move(scenario), job_config, request.value("priority", 0),
+                                     request.value("output", std::string())};
+                if (job.config.iteration_limit <= 0 || job.config.num_threads <= 0) {
+                    throw std::invalid_argument("iterations and threads must be positive");
+                }
+                if (fs::path(job.output_path).has_parent_path()) {
+                    fs::create_directories(fs::path(job.output_path).parent_path());
+                }
+                // Held across Submit so "submitted" precedes the job's events.
+                std::lock_guard<std::mutex> lock(protocol_mutex);
+                reply = {{"event", "submitted"}, {"job", service.Submit(std::move(job))}};
+                if (request.contains("tag")) reply["tag"] = request["tag"];
+                protocol << reply.dump() << '\n' << std::flush;
+                continue;
+            } else if (op == "cancel") {
+                const uint64_t id = request.at("job").get<uint64_t>();
+                reply = {{"event", "cancel"}, {"job", id}, {"ok", service.Cancel(id)}};
+            } else if (op == "status") {
+                const uint64_t id = request.at("job").get<uint64_t>();
+                const std::optional<solver::SolveJobStatus> status = service.Status(id);
+                if (!status) throw std::invalid_argument("unknown job " + std::to_string(id));
+                reply = EventJson(*status);
+                reply["state"] = solver::SolveJobStateName(status->state);
+                reply["event"] = "status";
+            } else if (op == "shutdown") {
+                cancel_on_exit = request.value("cancel", false);
+                break;
+            } else {
+                throw std::invalid_argument("unknown op: " + op);
+            }
+            if (request.contains("tag")) reply["tag"] = request["tag"];
+        } catch (const std::exception& e) {
+            reply = {{"event", "error"}, {"message", e.what()}};
+        }
+        send(reply);
+    }
+    service.Shutdown(cancel_on_exit);
+    send({{"event", "shutdown"}});
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "-h" || std::string(argv[i]) == "--help") {
+            std::cout << kUsage;
+            return 0;
+        }
+    }
+    Options options;
+    try {
+        options = ParseArguments(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "poker_solver_cli: " << e.what() << "\n\n" << kUsage;
+        return 2;
+    }
+
+    // In service mode stdout carries only events; all logs go to stderr.
+    std::streambuf* protocol_buffer = std::cout.rdbuf();
+    if (options.serve) std::cout.rdbuf(std::cerr.rdbuf());
+
+    std::shared_ptr<core::Compairer> compairer;
+    try {
+        compairer = MakeCompairer(options);
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] Cannot load hand ranks: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::shared_ptr<solver::SolutionStore> store;
+    if (!options.solution_store.empty()) {
+        try {
+            store = std::make_shared<solver::SolutionStore>(options.solution_store);
+        } catch (const std::exception& e) {
+            std::cerr << "[ERROR] " << e.what() << std::endl;
+            return 1;
+        }
+    }
+    if (options.serve) {
+        const int status = Serve(options, compairer, store, protocol_buffer);
+        std::cout.rdbuf(protocol_buffer);
+        return status;
+    }
+
+    size_t failed = 0;
+    std::vector<solver::BatchSpot> spots;
+    std::vector<std::string> spot_paths;
+    std::vector<std::string> output_paths;
+    for (const std::string& scenario_path : options.scenarios) {
+        try {
+            core::Deck deck;
+            config::Scenario scenario = config::LoadScenarioFile(scenario_path, deck);
+            output_paths.push_back(OutputPath(options, scenario_path, scenario));
+            spots.push_back({std::move(scenario), solver::PCfrSolver::Config()});
+            spots.back().config = SolverConfig(options, spots.back().scenario);
+            spot_paths.push_back(scenario_path);
+        } catch (const std::exception& e) {
+            std::cerr << "[ERROR] " << scenario_path << ": " << e.what() << std::endl;
+            ++failed;
+        }
+    }
+
+    solver::BatchSolver::Options batch_options;
+    if (options.threads) batch_options.num_threads = *options.threads;
+    if (options.small_spot_mb) {
+        batch_options.small_spot_bytes = static_cast<size_t>(*options.small_spot_mb * 1024.0 * 1024.0);
+    }
+    batch_options.memory_limit = options.max_memory_gb > 0.0
+                                     ? static_cast<uint64_t>(options.max_memory_gb * 1024.0 * 1024.0 * 1024.0)
+                                     : solver::PhysicalMemoryBytes();
+    if (!options.trace.empty()) batch_options.trace = std::make_shared<solver::TraceRecorder>();
+    batch_options.solution_store = store;
+    if (options.ranks > 1) {
+        // Every rank must run the same spots in the same order.
+        if (failed > 0) {
+            std::cerr << "[ERROR] Not joining the group: " << failed << " scenarios failed to load." << std::endl;
+            return 1;
+        }
+        try {
+            std::cout << "[INFO] Rank " << options.rank << " of " << options.ranks << ": "
+                      << (options.rank == 0 ? "waiting for workers" : "connecting") << " on "
+                      << options.coordinator_host << ":" << options.coordinator_port << std::endl;
+            batch_options.transport =
+                options.rank == 0 ? solver::CreateTcpCoordinator(options.coordinator_port, options.ranks)
+                                  : solver::CreateTcpWorker(options.coordinator_host, options.coordinator_port,
+                                                            options.rank, options.ranks);
+        } catch (const std::exception& e) {
+            std::cerr << "[ERROR] " << e.what() << std::endl;
+            return 1;
+        }
+    }
+    solver::BatchSolver batch(compairer, batch_options);
+    const auto start = std::chrono::steady_clock::now();
+    const std::vector<solver::BatchSpotResult> results =
+        batch.Solve(spots, [&](size_t spot_index, solver::PCfrSolver& pcfr_solver) {
+            WriteOutput(options, output_paths[spot_index], pcfr_solver);
+        });
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        const solver::BatchSpotResult& result = results[i];
+        if (!result.solved) {
+            std::cerr << "[ERROR] " << spot_paths[i] << ": " << result.error << std::endl;
+            ++failed;
+            continue;
+        }
+        if (result.cached) {
+            std::cout << "[RESULT] " << spot_paths[i] << ": stored solution " << result.cached->strategy_path
+                      << " (suits";
+            for (int suit = 0; suit < core::kNumSuits; ++suit) {
+                std::cout << ' ' << core::Card::SuitIndexToChar(suit) << "->"
+                          << core::Card::SuitIndexToChar(result.cached->suit_map[suit]);
+            }
+            std::cout << ")" << std::endl;
+            continue;
+        }
+        std::cout << "[RESULT] " << spot_paths[i] << ": " << result.iterations << " iterations";
+        if (result.exploitability >= 0.0) std::cout << ", exploitability " << result.exploitability << "% of pot";
+        std::cout << ", " << result.threads << (result.threads == 1 ? " thread" : " threads")
+                  << (result.reused_river_cache ? ", shared river cache" : "") << ", "
+                  << result.memory_bytes / (1024 * 1024) << " MiB, " << result.seconds
+                  << " s -> " << output_paths[i] << std::endl;
+    }
+    std::cout << "[INFO] " << options.scenarios.size() - failed << " scenarios solved in " << seconds << " s."
+              << std::endl;
+    if (batch_options.trace) {
+        try {
+            batch_options.trace->WriteChromeTrace(options.trace);
+            std::cout << "[INFO] Trace written to " << options.trace << " ("
+                      << batch_options.trace->Overwritten() << " early spans overwritten)." << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "[ERROR] " << e.what() << std::endl;
+            ++failed;
+        }
+    }
+    if (failed > 0) {
+        std::cerr << "[ERROR] " << failed << " of " << options.scenarios.size() << " scenarios failed." << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -42,13 +42,27 @@ class Card {
   static std::string IntToString(int card_int);
 
   // --- Static Bitmask Utilities ---
-  static uint64_t CardIntsToUint64(const std::vector<int>& card_ints);
+  // The bit operations are inline (see also the mask primitives below) so
+  // they compile down to a shift or an AND inside the solver's loops.
+  // Throws std::out_of_range for an invalid card.
+  static uint64_t CardIntsToUint64(const std::vector<int>& card_ints) {
+    uint64_t board_mask = 0;
+    for (int card_int : card_ints) board_mask |= CardIntToUint64(card_int);
+    return board_mask;
+  }
   static uint64_t CardsToUint64(const std::vector<Card>& cards);
-  static uint64_t CardIntToUint64(int card_int);
+  // Throws std::out_of_range for an invalid card.
+  static constexpr uint64_t CardIntToUint64(int card_int) {
+    if (!IsValidCardInt(card_int)) ThrowInvalidCardInt(card_int);
+    return static_cast<uint64_t>(1) << card_int;
+  }
   static uint64_t CardToUint64(const Card& card);
+  // Allocates; inner loops should use ForEachCard or CardMaskToInts.
   static std::vector<int> Uint64ToCardInts(uint64_t board_mask);
   static std::vector<Card> Uint64ToCards(uint64_t board_mask);
-  static bool DoBoardsOverlap(uint64_t board_mask1, uint64_t board_mask2);
+  static constexpr bool DoBoardsOverlap(uint64_t board_mask1, uint64_t board_mask2) {
+    return (board_mask1 & board_mask2) != 0;
+  }
 
   // --- Static Rank/Suit Helpers ---
   static char SuitIndexToChar(int suit_index);
@@ -59,12 +73,54 @@ class Card {
   static const std::array<char, kNumRanks>& GetAllRankChars();
 
   // --- Static Validation Helper ---
-  static bool IsValidCardInt(int card_int);
+  static constexpr bool IsValidCardInt(int card_int) { return card_int >= 0 && card_int < kNumCardsInDeck; }
 
  private:
+  [[noreturn]] static void ThrowInvalidCardInt(int card_int);
+
   std::optional<int> card_int_ = std::nullopt;
 };
 
+// --- Card Mask Primitives ---
+// Bit i of a card mask is card int i. Header-only, allocation-free helpers
+// for the hot paths; masks outside the deck are not checked.
+
+// Number of cards in 'mask'.
+constexpr int CountCards(uint64_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_popcountll(mask);
+#else
+  int count = 0;
+  for (; mask != 0; mask &= mask - 1) ++count;
+  return count;
+#endif
+}
+
+// Lowest card in a non-empty 'mask'.
+constexpr int LowestCard(uint64_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctzll(mask);
+#else
+  int card = 0;
+  while (!((mask >> card) & 1ULL)) ++card;
+  return card;
+#endif
+}
+
+// Calls 'visit(card)' for each card in 'mask', ascending.
+template <typename Visitor>
+constexpr void ForEachCard(uint64_t mask, Visitor&& visit) {
+  for (; mask != 0; mask &= mask - 1) visit(LowestCard(mask));
+}
+
+// Writes the cards in 'mask' ascending into 'out', which must have room for
+// CountCards(mask) of them, and returns how many were written.
+constexpr int CardMaskToInts(uint64_t mask, int* out) {
+  int count = 0;
+  for (; mask != 0; mask &= mask - 1) out[count++] = LowestCard(mask);
+  return count;
+}
+
 } // namespace core
 } // namespace poker_solver
 
@@ -5,10 +5,15 @@
 #include <vector>
 #include <string>
 #include <string_view>
+#include <cstdint>
 
 namespace poker_solver {
 namespace core {
 
+// Rank index of the six, the lowest rank of a short (6+) deck.
+constexpr int kShortDeckLowestRank = 4;
+constexpr int kNumCardsInShortDeck = (kNumRanks - kShortDeckLowestRank) * kNumSuits; // 36
+
 // Represents a standard 52-card deck.
 class Deck {
  public:
@@ -20,6 +25,10 @@ class Deck {
   Deck(const std::vector<std::string_view>& ranks,
        const std::vector<std::string_view>& suits);
 
+  // Creates an ordered short (6+) deck: the 36 cards from sixes to aces,
+  // with their standard card integers.
+  static Deck ShortDeck();
+
   // Returns a const reference to the vector of cards in the deck.
   const std::vector<Card>& GetCards() const;
 
@@ -30,9 +39,13 @@ class Deck {
 
   // Finds a card by its integer representation (0-51).
   // Returns an empty Card object if the index is invalid or the deck
-  // doesn't contain the standard 52 cards.
+  // does not hold that card.
   Card FindCard(int card_int) const;
 
+  // Mask of the cards in the deck (bit card_int set, as
+  // Card::CardIntsToUint64). Chance nodes deal only these cards.
+  uint64_t GetCardsMask() const;
+
  private:
   // The collection of cards representing the deck.
   std::vector<Card> cards_;
@@ -0,0 +1,81 @@
+#ifndef POKER_SOLVER_TREE_FLAT_GAME_TREE_H_
+#define POKER_SOLVER_TREE_FLAT_GAME_TREE_H_
+
+#include "nodes/GameTreeNode.h" // For GameTreeNodeType, GameRound
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Forward declarations
+namespace poker_solver { namespace nodes { class ActionNode; } }
+namespace poker_solver { namespace tree { class GameTree; } }
+
+namespace poker_solver {
+namespace tree {
+
+// One node of a FlatGameTree. Plain data: no pointers, no virtual dispatch.
+struct FlatNode {
+  core::GameTreeNodeType type;
+  core::GameRound round;
+  uint8_t player = 0;        // Acting player (action nodes)
+  // Chance: the streets dealt from here to a showdown with no action in
+  // between (1: the river of an all-in, 2: its turn and river), 0 when
+  // betting follows.
+  uint8_t runout_streets = 0;
+  uint32_t first_child = 0;  // Index of the first child; children are contiguous
+  uint32_t num_children = 0; // Action: one per action, in action order. Chance: 0 or 1
+  // Action: index into the tree's action nodes. Terminal: offset of the two
+  // payoffs. Showdown: offset of six payoffs, player 0 wins / player 1 wins /
+  // tie, two per outcome.
+  uint32_t payload = 0;
+  double pot = 0.0;
+};
+
+// Immutable, index-based copy of a built GameTree for traversals: one
+// contiguous node array, children addressed by index range, node type as a
+// tag. Visiting a node costs no reference counting, RTTI or pointer chasing
+// beyond the array. Node 0 is the root; every node's children come after it.
+// Trainables stay on the ActionNodes of the source tree, which must outlive
+// this one.
+class FlatGameTree {
+ public:
+  // Flattens the tree under 'root' (empty if 'root' is null).
+  // Throws:
+  //   std::invalid_argument on a null child, an action node whose actions and
+  //                         children differ in number, or payoffs for fewer
+  //                         than two players.
+  explicit FlatGameTree(const std::shared_ptr<core::GameTreeNode>& root);
+  explicit FlatGameTree(const GameTree& tree);
+
+  bool Empty() const { return nodes_.empty(); }
+  size_t Size() const { return nodes_.size(); }
+  const FlatNode& Node(uint32_t index) const { return nodes_[index]; }
+  const std::vector<FlatNode>& Nodes() const { return nodes_; }
+
+  // Source ActionNode of an action node (trainables, actions, ranges).
+  nodes::ActionNode& Action(const FlatNode& node) const { return *action_nodes_[node.payload]; }
+  size_t NumActionNodes() const { return action_nodes_.size(); }
+
+  // Net payoff of 'player' at a terminal node.
+  double TerminalPayoff(const FlatNode& node, size_t player) const {
+    return payoffs_[node.payload + player];
+  }
+  // Showdown payoffs of 'player' (offset 0: player 0 wins, 2: player 1 wins, 4: tie).
+  const double* ShowdownPayoffs(const FlatNode& node) const { return payoffs_.data() + node.payload; }
+
+  // Number of nodes of 'type'.
+  size_t Count(core::GameTreeNodeType type) const;
+
+  // Heap bytes of the node, action node and payoff arrays.
+  size_t MemoryBytes() const;
+
+ private:
+  std::vector<FlatNode> nodes_;
+  std::vector<nodes::ActionNode*> action_nodes_;
+  std::vector<double> payoffs_;
+};
+
+} // namespace tree
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_TREE_FLAT_GAME_TREE_H_
@@ -4,6 +4,7 @@
 #include "Deck.h"                          // For Deck
 #include "nodes/GameTreeNode.h"                // For GameTreeNode and enums
 #include "nodes/GameActions.h"                  // <<< ADD THIS INCLUDE
+#include "nodes/ActionNode.h"                   // For TrainablePrecision
 #include "tools/Rule.h"                        // For Rule
 #include "tools/GameTreeBuildingSettings.h" // For settings used in build
 #include <string>
@@ -11,6 +12,7 @@
 #include <memory> // For std::shared_ptr
 #include <cstdint> // For uint64_t
 #include <optional> // For std::optional
+#include <array>
 #include <json.hpp> // For JSON loading
 
 // Forward declarations for node types
@@ -24,44 +26,240 @@ namespace poker_solver { namespace nodes {
 namespace poker_solver {
 namespace tree {
 
+// Exact counts gathered while building a tree from a Rule. Deals follow
+// PCfrSolver: turn and river chance nodes deal one card from the deck cards
+// off the initial board.
+struct TreeBuildStats {
+  size_t action_nodes = 0;
+  size_t chance_nodes = 0;
+  size_t showdown_nodes = 0;
+  size_t terminal_nodes = 0;
+  // Chance nodes of chance_nodes built without a child (depth-limit leaves,
+  // see Rule::IsDepthLimited).
+  size_t leaf_nodes = 0;
+  // Deal slots the solver sizes action nodes with, summed over action nodes.
+  uint64_t deal_slots = 0;
+  // trainables_by_actions[p][a]: trainables (one per action node and
+  // reachable deal) of player p at nodes with 'a' actions.
+  std::array<std::vector<uint64_t>, 2> trainables_by_actions;
+  // The same, per street: trainables_by_round[r][p][a] counts those at
+  // nodes of GameRound r.
+  std::array<std::array<std::vector<uint64_t>, 2>, 4> trainables_by_round;
+
+  // Counts 'count' trainables of 'player' at a node of 'round' with
+  // 'num_actions' actions.
+  void AddTrainables(size_t player, core::GameRound round, size_t num_actions, uint64_t count);
+
+  // Total trainables over both players.
+  uint64_t NumTrainables() const;
+
+  // Adds the counts of 'other' (e.g. a subtree built on another thread).
+  void Merge(const TreeBuildStats& other);
+
+  // Approximate bytes of the tree itself: node objects, their child and
+  // action lists, and one trainable pointer per deal slot. Excludes the
+  // trainables. Subtrees below chance nodes are shared by all cards, so only
+  // the deal slots grow with the number of runouts.
+  uint64_t TreeBytes() const;
+
+  // Exact bytes of every trainable's regret/strategy tables, given each
+  // player's range size and the solver's trainable settings (see
+  // ActionNode::TrainableBytes). Suit isomorphism can only lower this.
+  uint64_t TrainableBytes(const std::array<size_t, 2>& range_sizes,
+                          nodes::ActionNode::TrainablePrecision precision,
+                          nodes::ActionNode::TrainableAlgorithm algorithm =
+                              nodes::ActionNode::TrainableAlgorithm::kDiscounted,
+                          bool lazy_strategies = false) const;
+  // The part of TrainableBytes at nodes of 'first_round' and later streets.
+  uint64_t TrainableBytesFrom(core::GameRound first_round, const std::array<size_t, 2>& range_sizes,
+                              nodes::ActionNode::TrainablePrecision precision,
+                              nodes::ActionNode::TrainableAlgorithm algorithm =
+                                  nodes::ActionNode::TrainableAlgorithm::kDiscounted,
+                              bool lazy_strategies = false) const;
+};
+
+// Memory budget for building a tree from a Rule. While the trainables of
+// the built tree would exceed 'max_bytes', bet sizes are thinned street by
+// street, deepest street first: each pass drops one size from every bet,
+// raise and donk list of that street holding more than one, until the tree
+// fits or only single sizes remain. All-in options are kept.
+struct TreeMemoryBudget {
+  uint64_t max_bytes = 0; // 0: no budget
+  std::array<size_t, 2> range_sizes = {0, 0};
+  nodes::ActionNode::TrainablePrecision precision = nodes::ActionNode::TrainablePrecision::kFloat;
+  nodes::ActionNode::TrainableAlgorithm algorithm = nodes::ActionNode::TrainableAlgorithm::kDiscounted;
+  bool lazy_strategies = false;
+};
+
 // Represents the entire game tree for a specific poker scenario.
 class GameTree {
  public:
   // Constructor for loading a pre-built tree from a JSON file.
   GameTree(const std::string& json_filepath, const core::Deck& deck);
 
-  // Constructor for building the tree dynamically based on rules.
+  // Constructor for building the tree dynamically based on rules. Large
+  // betting subtrees near the root are built as OpenMP tasks on the current
+  // thread count; node depths and subtree sizes are set during the build.
   explicit GameTree(const config::Rule& rule);
 
+  // Builds the tree like the Rule constructor, shrinking bet sizes on deeper
+  // streets while the trainables would exceed 'budget' (see
+  // TreeMemoryBudget). If even single sizes do not fit, the smallest tree is
+  // kept and a warning is logged.
+  GameTree(const config::Rule& rule, const TreeMemoryBudget& budget);
+
+  // --- Binary Tree Files ---
+  // A compact alternative to JSON for storing built trees: a 64-byte header
+  // (magic "PSTREE01", version, record counts, deal card count, FNV-1a
+  // checksum of the rest) followed by the nodes in depth-first order as
+  // fixed-size records, the actions of every action node, and two payoffs
+  // (terminal) or commitments (showdown) per leaf. Host byte order.
+
+  // Writes the tree to 'path' through a temporary file renamed into place.
+  // Throws:
+  //   std::runtime_error if the tree is empty or on I/O failure.
+  void WriteBinaryFile(const std::string& path) const;
+
+  // Loads a tree written by WriteBinaryFile with one mapped read. Build
+  // statistics, depths and subtree sizes are restored; there is no build
+  // Rule, so GetBuildRule() is empty.
+  // Throws:
+  //   std::runtime_error if the file cannot be read or fails validation.
+  static std::shared_ptr<GameTree> FromBinaryFile(const std::string& path, const core::Deck& deck);
+
+  // --- Incremental Edits ---
+  // Replaces the bets or raises of the action node at 'path' by one per
+  // entry of 'amounts', each in chips as GameAction amounts count them (a
+  // raise's on top of the call). Steps are action strings from the root,
+  // as PCfrSolver::LockNode takes them; chance nodes are passed through.
+  // Check, call and fold stay. Sizes the node already had keep their child
+  // subtree, trainables included; new ones get a subtree built as the Rule
+  // build would. Depths, subtree sizes and build statistics are updated.
+  // Returns, per action of the edited node, the index it had before, or -1
+  // for a new bet or raise.
+  // Throws:
+  //   std::logic_error if the tree was not built from a Rule.
+  //   std::invalid_argument for a bad path, a node that cannot bet or
+  //   raise, or an amount that is not positive or exceeds the stack.
+  std::vector<int> EditBetSizes(const std::vector<std::string>& path, std::vector<double> amounts);
+
   // --- Accessors ---
   std::shared_ptr<core::GameTreeNode> GetRoot() const { return root_; }
   const core::Deck& GetDeck() const { return deck_; }
 
   // --- Tree Analysis ---
+  // Sets every node's depth and subtree size. Trees built from a Rule
+  // already have them.
   void CalculateTreeMetadata();
   void PrintTree(int max_depth = -1) const;
-  uint64_t EstimateTrainableMemory(size_t p0_range_size, size_t p1_range_size) const;
+  // Exact trainable bytes for the given range sizes and precision (see
+  // TreeBuildStats::TrainableBytes); 0 for trees loaded from JSON.
+  uint64_t EstimateTrainableMemory(size_t p0_range_size, size_t p1_range_size,
+                                   nodes::ActionNode::TrainablePrecision precision =
+                                       nodes::ActionNode::TrainablePrecision::kFloat) const;
+
+  // EstimateTrainableMemory split for an out-of-core solve
+  // (PCfrSolver::Config::trainable_file_directory), whose tables of
+  // 'first_on_disk_round' and later streets are kept in a file. Only
+  // double-precision (kFloat) tables go to the file; other precisions are
+  // all resident.
+  struct TrainableMemorySplit {
+    uint64_t resident_bytes = 0;
+    uint64_t on_disk_bytes = 0;
+  };
+  TrainableMemorySplit EstimateTrainableMemorySplit(size_t p0_range_size, size_t p1_range_size,
+                                                    core::GameRound first_on_disk_round,
+                                                    nodes::ActionNode::TrainablePrecision precision =
+                                                        nodes::ActionNode::TrainablePrecision::kFloat) const;
+
+  // Approximate bytes of the tree structure (see TreeBuildStats::TreeBytes);
+  // 0 for trees loaded from JSON.
+  uint64_t EstimateTreeMemory() const { return build_stats_.TreeBytes(); }
+
+  // Counts gathered while building from a Rule or loading a binary file.
+  const TreeBuildStats& GetBuildStats() const { return build_stats_; }
+
+  // The building settings actually used, after any budget reductions.
+  // Empty for trees not built from a Rule.
+  const std::optional<config::Rule>& GetBuildRule() const { return build_rule_; }
 
 
  private:
+  // Empty tree, filled in by FromBinaryFile.
+  explicit GameTree(const core::Deck& deck) : deck_(deck) {}
+
   // --- Dynamic Tree Building Helpers ---
+  // Deals leading to the node being built, for the build statistics.
+  struct DealPath {
+    uint64_t deal_slots = 1; // Deal slots the solver allocates
+    uint64_t reachable = 1;  // Slots whose dealt cards are distinct
+    int cards_dealt = 0;
+  };
+
+  // A child still to be built, with the betting state leading to it.
+  struct PendingBranch {
+    std::shared_ptr<core::GameTreeNode> node;
+    config::Rule rule;
+    core::GameAction last_action;
+    int actions_this_round;
+    int raises_this_street;
+  };
+
+  // Builds root_ and build_stats_ from 'rule' (replacing any earlier build).
+  void Build(const config::Rule& rule);
+
+  // Drops one bet size from every list of the deepest street that still
+  // has more than one. Returns the street thinned, or nullopt if none could be.
+  static std::optional<core::GameRound> ThinDeepestStreet(config::GameTreeBuildingSettings& settings);
+
+  // The Build* helpers count into 'stats', set the depth and subtree size
+  // of every node they build and return the subtree size. They touch no
+  // other GameTree state, so subtrees can be built concurrently.
+
   // Pass Rule by value because commitments change down branches
-  void BuildBranch(std::shared_ptr<core::GameTreeNode> current_node,
-                   config::Rule current_rule, // Pass Rule by value
-                   const core::GameAction& last_action,
-                   int actions_this_round,
-                   int raises_this_street);
+  int BuildBranch(std::shared_ptr<core::GameTreeNode> current_node,
+                  config::Rule current_rule, // Pass Rule by value
+                  const core::GameAction& last_action,
+                  int actions_this_round,
+                  int raises_this_street,
+                  const DealPath& deals,
+                  int depth,
+                  TreeBuildStats& stats) const;
 
   // Pass original build rule by const ref as it doesn't change state here
-  void BuildChanceNode(std::shared_ptr<nodes::ChanceNode> node,
-                       const config::Rule& rule);
+  int BuildChanceNode(std::shared_ptr<nodes::ChanceNode> node,
+                      const config::Rule& rule,
+                      const DealPath& deals,
+                      int depth,
+                      TreeBuildStats& stats) const;
 
   // Pass Rule by value
-  void BuildActionNode(std::shared_ptr<nodes::ActionNode> node,
-                       config::Rule current_rule_state, // Pass Rule by value
-                       const core::GameAction& last_action,
-                       int actions_this_round,
-                       int raises_this_street);
+  int BuildActionNode(std::shared_ptr<nodes::ActionNode> node,
+                      config::Rule current_rule_state, // Pass Rule by value
+                      const core::GameAction& last_action,
+                      int actions_this_round,
+                      int raises_this_street,
+                      const DealPath& deals,
+                      int depth,
+                      TreeBuildStats& stats) const;
+
+  // The child of 'node' for a bet or raise adding 'amount_to_add' chips
+  // (call included) under 'rule_state', with the betting state below it.
+  PendingBranch BetOrRaiseBranch(const std::shared_ptr<nodes::ActionNode>& node,
+                                 const config::Rule& rule_state, double amount_to_add,
+                                 int actions_this_round, int raises_this_street) const;
+
+  // Counts an existing subtree into 'stats' as building it would.
+  void CountSubtree(const std::shared_ptr<core::GameTreeNode>& node, const DealPath& deals,
+                    TreeBuildStats& stats) const;
+
+  // Builds the children of an action node at 'depth'. Near the root, inside
+  // a parallel region, betting subtrees become tasks with their own stats,
+  // merged once all are done. Returns the children's total subtree size.
+  int BuildChildren(const std::vector<PendingBranch>& children,
+                    const DealPath& deals,
+                    int depth,
+                    TreeBuildStats& stats) const;
 
   // Mark as const
   std::vector<double> GetPossibleBets(
@@ -100,17 +298,14 @@ class GameTree {
   static void PrintTreeRecursive(const std::shared_ptr<core::GameTreeNode>& node,
                                  int current_depth, int max_depth,
                                  const std::string& prefix);
-   // Mark as const
-   uint64_t EstimateMemoryRecursive(
-       const std::shared_ptr<core::GameTreeNode>& node,
-       size_t p0_range_size, size_t p1_range_size,
-       size_t num_deals_multiplier) const;
 
 
   // --- Member Variables ---
   std::shared_ptr<core::GameTreeNode> root_;
   core::Deck deck_;
   std::optional<config::Rule> build_rule_; // Store the rule used for building
+  TreeBuildStats build_stats_;
+  size_t num_deal_cards_ = 0; // Deck cards off the initial board
 
   // Deleted copy/move operations.
   GameTree(const GameTree&) = delete;
@@ -13,13 +13,102 @@
 namespace poker_solver {
 namespace utils {
 
+// --- Combination Enumeration ---
+
+// Returns the binomial coefficient C(n, k), or 0 if k > n.
+// Throws:
+//   std::overflow_error if the result does not fit in uint64_t.
+inline uint64_t CombinationCount(size_t n, size_t k) {
+  if (k > n) {
+    return 0;
+  }
+  if (k * 2 > n) {
+    k = n - k;
+  }
+  uint64_t result = 1;
+  for (size_t i = 1; i <= k; ++i) {
+    if (result > std::numeric_limits<uint64_t>::max() / (n - i + 1)) {
+      throw std::overflow_error("Overflow detected in CombinationCount");
+    }
+    result = result * (n - i + 1) / i;
+  }
+  return result;
+}
+
+// Writes the lexicographic 'rank'-th k-element subset of {0..n-1} into
+// 'out' (k ascending indices). Returns false if rank >= C(n, k).
+inline bool UnrankCombination(uint64_t rank, int n, int k, int* out) {
+  if (k < 0 || k > n || rank >= CombinationCount(n, k)) return false;
+  int next = 0;
+  for (int i = 0; i < k; ++i) {
+    while (true) {
+      const uint64_t starting_here = CombinationCount(n - next - 1, k - i - 1);
+      if (rank < starting_here) break;
+      rank -= starting_here;
+      ++next;
+    }
+    out[i] = next++;
+  }
+  return true;
+}
+
+// Steps through the index sets of every k-element subset of {0..n-1} in
+// lexicographic order without allocating, e.g. for n = 4, k = 2:
+// {0,1} {0,2} {0,3} {1,2} {1,3} {2,3}. Usage:
+//   CombinationIndices<5> combo(7, 5);
+//   do { Use(combo.Indices()); } while (combo.Next());
+// 'MaxK' bounds k; Valid() is false when k > n or k > MaxK.
+template <size_t MaxK>
+class CombinationIndices {
+ public:
+  CombinationIndices(int n, int k) : n_(n), k_(k) {
+    valid_ = k >= 0 && k <= n && static_cast<size_t>(k) <= MaxK;
+    if (valid_) {
+      for (int i = 0; i < k_; ++i) idx_[i] = i;
+    }
+  }
+
+  // Positions the generator at the lexicographic 'rank'-th combination
+  // (0-based), so disjoint rank ranges can be enumerated independently.
+  // Returns false (and leaves the generator unchanged) if rank is out of
+  // range.
+  bool Seek(uint64_t rank) {
+    // UnrankCombination checks the rank before writing anything.
+    return valid_ && UnrankCombination(rank, n_, k_, idx_);
+  }
+
+  // Advances to the next combination. Returns false after the last one.
+  bool Next() {
+    if (!valid_) return false;
+    int i = k_ - 1;
+    while (i >= 0 && idx_[i] == n_ - k_ + i) --i;
+    if (i < 0) return false;
+    ++idx_[i];
+    for (int j = i + 1; j < k_; ++j) idx_[j] = idx_[j - 1] + 1;
+    return true;
+  }
+
+  bool Valid() const { return valid_; }
+  int Size() const { return k_; }
+  // The current combination's k indices, ascending.
+  const int* Indices() const { return idx_; }
+  int operator[](int i) const { return idx_[i]; }
+
+ private:
+  int n_;
+  int k_;
+  bool valid_;
+  int idx_[MaxK > 0 ? MaxK : 1] = {};
+};
+
 // --- Combinations Class ---
 
 // Generates all combinations of M elements chosen from a given input set.
 // Example: Combinations({0, 1, 2, 3}, 2) yields {{0, 1}, {0, 2}, {0, 3},
 // {1, 2}, {1, 3}, {2, 3}}.
 // Warning: Stores all combinations in memory. Can be memory-intensive for
-// large inputs or large combination sizes.
+// large inputs or large combination sizes; hot paths should step a
+// CombinationIndices instead.
 template <typename T>
 class Combinations {
  public:
@@ -103,27 +192,7 @@ class Combinations {
   // Returns:
   //   The number of combinations, or 0 if k > n.
   static uint64_t CalculateCombinationsCount(size_t n, size_t k) {
-    if (k > n) {
-      return 0;
-    }
-    // Optimization: C(n, k) == C(n, n-k). Choose the smaller k.
-    if (k * 2 > n) {
-      k = n - k;
-    }
-    if (k == 0) {
-      return 1;
-    }
-
-    uint64_t result = 1;
-    for (size_t i = 1; i <= k; ++i) {
-        // Check for potential overflow before multiplication
-        if (result > std::numeric_limits<uint64_t>::max() / (n - i + 1) ) {
-             throw std::overflow_error(
-                "Overflow detected in CalculateCombinationsCount");
-        }
-        result = result * (n - i + 1) / i; // Perform division at each step
-    }
-    return result;
+    return CombinationCount(n, k);
   }
 
   const std::vector<T> input_set_;
@@ -4,6 +4,7 @@
 #include "Card.h" // For Card definition (adjust path if needed)
 #include <vector>
 #include <cstdint>
+#include <cstddef>
 
 namespace poker_solver {
 namespace core {
@@ -64,6 +65,18 @@ class Compairer {
   virtual int GetHandRank(uint64_t private_mask,
                           uint64_t public_mask) const = 0;
 
+  // Ranks many hands on one board: out[i] = GetHandRank(private_masks[i],
+  // public_mask) for i < count. Implementations can preprocess the board
+  // once for the whole batch; this default makes one call per hand.
+  // Args:
+  //   private_masks: 'count' hole card bitmasks.
+  //   public_mask: Bitmask for the community cards.
+  //   out: Receives 'count' ranks.
+  virtual void RankRange(const uint64_t* private_masks, size_t count,
+                         uint64_t public_mask, int* out) const {
+    for (size_t i = 0; i < count; ++i) out[i] = GetHandRank(private_masks[i], public_mask);
+  }
+
 
  protected:
   // Protected default constructor to allow inheritance but prevent direct instantiation.
@@ -3,18 +3,23 @@
 
 #include "compairer/Compairer.h" // Base class interface
 #include "Card.h"      // For Card utilities
-#include "Library.h"  // For Combinations
+#include "Library.h"  // For CombinationIndices
 #include <string>
 #include <vector>
 #include <cstdint>
-#include <unordered_map>
+#include "tools/FlatHashMap.h" // For the rank tables
 #include <filesystem> // Required for path manipulation (C++17)
 
 namespace poker_solver {
 namespace eval {
 
 // Concrete implementation of Compairer using a pre-computed dictionary
-// of 5-card hand ranks loaded from a file (with binary caching).
+// of 5-card hand ranks loaded from a file (with binary caching), or
+// generated at compile time (see FiveCardRankTables.h).
+//
+// Building with POKER_SOLVER_EMBEDDED_RANKS (CMake option of the same name)
+// makes the path constructor use the generated ranks as well, so binaries
+// need no dictionary file and do no file I/O to load it.
 class Dic5Compairer : public core::Compairer {
  public:
   // --- Constants ---
@@ -36,6 +41,9 @@ class Dic5Compairer : public core::Compairer {
   //                      or text file, or if cache creation fails.
   explicit Dic5Compairer(const std::string& dictionary_filepath);
 
+  // Uses the ranks generated at compile time; never touches the filesystem.
+  Dic5Compairer();
+
   // --- Overridden Interface Methods ---
   core::ComparisonResult CompareHands(
       const std::vector<int>& private_hand1,
@@ -52,8 +60,16 @@ class Dic5Compairer : public core::Compairer {
   int GetHandRank(uint64_t private_mask,
                   uint64_t public_mask) const override;
 
+  // For 5-card boards the board's own rank and its 3- and 4-card subsets
+  // are formed once, leaving 20 lookups per two-card hand and no
+  // allocation. Other boards fall back to GetHandRank.
+  void RankRange(const uint64_t* private_masks, size_t count,
+                 uint64_t public_mask, int* out) const override;
+
   // --- Helper Methods (Public for testing) ---
   int GetBestRankForCards(const std::vector<int>& cards) const;
+  // Same without a vector: the best 5-card rank of 'cards[0..num_cards)'.
+  int GetBestRankForCards(const int* cards, size_t num_cards) const;
 
 
  private:
@@ -64,12 +80,14 @@ class Dic5Compairer : public core::Compairer {
    bool LoadBinaryCache(const std::filesystem::path& cache_filepath);
    // Saves the loaded ranks to the binary cache file. Returns true on success.
    bool SaveBinaryCache(const std::filesystem::path& cache_filepath) const;
+   // Fills the maps from the compile-time generated ranks.
+   void LoadGeneratedTables();
    // Performs the lookup for a specific 5-card hand mask.
    int Lookup5CardRank(uint64_t hand_mask) const;
 
    // --- Member Variables ---
-   std::unordered_map<uint64_t, int> flush_ranks_;
-   std::unordered_map<uint64_t, int> non_flush_ranks_;
+   hashing::FlatHashMap<int> flush_ranks_;
+   hashing::FlatHashMap<int> non_flush_ranks_;
    // Store the path for potential error messages or future use
    std::filesystem::path dictionary_path_;
    std::filesystem::path cache_path_;
@@ -0,0 +1,135 @@
+#ifndef POKER_SOLVER_EVAL_DIC7_COMPAIRER_H_
+#define POKER_SOLVER_EVAL_DIC7_COMPAIRER_H_
+
+#include "compairer/Compairer.h"     // Base class interface
+#include "compairer/Dic5Compairer.h" // Source of the 5-card ranks
+#include "tools/MappedFile.h"        // For mapped table files
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace poker_solver {
+namespace eval {
+
+// Compairer with direct lookups for 5 to 7 cards, ranking on the same scale
+// as Dic5Compairer (whose dictionary it is built from).
+//
+// Flushes are detected from the per-suit card counts; the flush suit's
+// 13-bit rank pattern indexes a flat table of the best flush. Any other
+// hand depends only on its rank counts, which (as the nibble-wise card
+// counts of RanksHash) are mapped by a perfect hash onto a flat rank table:
+// one read of a displacement, one of the rank.
+//
+// The tables can be saved to a table file and mapped back read-only, which
+// uses them in place: nothing is parsed or rebuilt, and processes mapping
+// the same file share its pages. Layout, in host byte order: a 64-byte
+// header (magic "PSRANK7", uint32 version, uint32 bucket shift, uint64
+// flush/displacement/rank entry counts, uint64 FNV-1a checksum of the
+// payload, zero padding) followed by the int32 flush table, the uint32
+// displacements and the int32 rank table.
+class Dic7Compairer : public core::Compairer {
+ public:
+  // --- Constants ---
+  static constexpr int kInvalidRank = Dic5Compairer::kInvalidRank;
+  static constexpr int kMinCards = 5;
+  static constexpr int kMaxCards = 7;
+
+  // --- Constructors ---
+  // Builds the tables from already loaded 5-card ranks.
+  explicit Dic7Compairer(const Dic5Compairer& five_card_ranks);
+
+  // Maps the table file next to 'dictionary_filepath' (extension .rank7).
+  // If it is missing or invalid, loads the 5-card dictionary (see
+  // Dic5Compairer), builds the tables and writes that file for next time.
+  // Throws:
+  //   std::runtime_error if the dictionary cannot be loaded.
+  explicit Dic7Compairer(const std::string& dictionary_filepath);
+
+  // Maps a table file written by WriteTableFile.
+  // Throws:
+  //   std::runtime_error if it cannot be read or fails validation.
+  static std::shared_ptr<Dic7Compairer> FromTableFile(const std::string& table_filepath);
+
+  // Writes the tables to 'table_filepath', through a temporary file renamed
+  // into place so concurrent readers never see a partial file.
+  // Throws:
+  //   std::runtime_error on I/O failure.
+  void WriteTableFile(const std::string& table_filepath) const;
+
+  // True when the tables are used in place from a mapped table file.
+  bool IsMapped() const { return mapping_ && mapping_->IsMapped(); }
+
+  // --- Overridden Interface Methods ---
+  core::ComparisonResult CompareHands(
+      const std::vector<int>& private_hand1,
+      const std::vector<int>& private_hand2,
+      const std::vector<int>& public_board) const override;
+
+  core::ComparisonResult CompareHands(uint64_t private_mask1,
+                                      uint64_t private_mask2,
+                                      uint64_t public_mask) const override;
+
+  int GetHandRank(const std::vector<int>& private_hand,
+                  const std::vector<int>& public_board) const override;
+
+  int GetHandRank(uint64_t private_mask,
+                  uint64_t public_mask) const override;
+
+  // The board's rank counts and its only possible flush suit are found
+  // once; each two-card hand then adds its own rank counts for a single
+  // perfect-hash lookup, and reads the flush table only when that suit
+  // reaches 5 cards. Other hand and board sizes fall back to GetHandRank.
+  void RankRange(const uint64_t* private_masks, size_t count,
+                 uint64_t public_mask, int* out) const override;
+
+  // Rank of the best 5 cards in 'cards_mask'; kInvalidRank unless it holds
+  // kMinCards to kMaxCards cards.
+  int RankOfMask(uint64_t cards_mask) const;
+
+  // Bytes of the lookup tables (mapped or owned).
+  size_t MemoryBytes() const;
+
+ private:
+  Dic7Compairer() = default; // For FromTableFile
+
+  // --- Private Helper Methods ---
+  void BuildFlushTable(const Dic5Compairer& five_card_ranks);
+  void BuildRankCountTable(const Dic5Compairer& five_card_ranks);
+  // Points the table views at the owned vectors.
+  void UseOwnedTables();
+  // Validates 'mapping' and points the table views into it; false (with
+  // 'error' set) when it is not a usable table file.
+  bool UseMappedTables(std::unique_ptr<utils::MappedFile> mapping, std::string& error);
+  // Slot of a rank-count key in the rank table.
+  size_t RankCountSlot(uint64_t rank_counts) const;
+
+  // --- Member Variables ---
+  // Table views, into the owned vectors or the mapping.
+  // Best flush rank per 13-bit rank pattern of one suit (kInvalidRank for
+  // fewer than 5 cards).
+  const int* flush_ranks_ = nullptr;
+  // Perfect hash: bucket -> displacement, then slot -> rank.
+  const uint32_t* displacements_ = nullptr;
+  const int* rank_count_ranks_ = nullptr;
+  size_t num_buckets_ = 0;
+  size_t num_slots_ = 0;
+  int bucket_shift_ = 0;
+
+  // Storage when built rather than mapped.
+  std::vector<int> owned_flush_ranks_;
+  std::vector<uint32_t> owned_displacements_;
+  std::vector<int> owned_rank_count_ranks_;
+  std::unique_ptr<utils::MappedFile> mapping_;
+
+  // Deleted copy/move operations (the views point into this object).
+  Dic7Compairer(const Dic7Compairer&) = delete;
+  Dic7Compairer& operator=(const Dic7Compairer&) = delete;
+  Dic7Compairer(Dic7Compairer&&) = delete;
+  Dic7Compairer& operator=(Dic7Compairer&&) = delete;
+};
+
+} // namespace eval
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_EVAL_DIC7_COMPAIRER_H_
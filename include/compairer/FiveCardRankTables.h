@@ -0,0 +1,152 @@
+#ifndef POKER_SOLVER_EVAL_FIVE_CARD_RANK_TABLES_H_
+#define POKER_SOLVER_EVAL_FIVE_CARD_RANK_TABLES_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace poker_solver {
+namespace eval {
+
+// Compile-time generation of the 5-card rank scale of five_card_strength.txt:
+// the 7462 hand classes ranked 1 (royal flush) to 7462 (7-5-4-3-2 offsuit),
+// by category and then by descending ranks within it. A flush class is
+// keyed by its 13-bit rank pattern (bit r for rank r, 0 = deuce); any other
+// class by its rank counts in the nibble layout of Dic5Compairer::RanksHash.
+
+struct FiveCardRankEntry {
+  uint64_t key;
+  int rank;
+};
+
+struct FiveCardRankTables {
+  static constexpr size_t kNumFlushClasses = 1287;    // 13 choose 5
+  static constexpr size_t kNumNonFlushClasses = 6175; // 7462 - 1287
+  std::array<FiveCardRankEntry, kNumFlushClasses> flush{};
+  std::array<FiveCardRankEntry, kNumNonFlushClasses> non_flush{};
+};
+
+namespace rank_tables_detail {
+
+constexpr int kNumRanks = 13;
+constexpr int kAce = kNumRanks - 1;
+
+// Rank patterns of the ten straights, best first (the wheel is 5-high).
+constexpr uint64_t StraightPattern(int index) {
+    return index < 9 ? uint64_t{0x1F} << (kAce - 4 - index) : uint64_t{0x100F};
+}
+
+constexpr bool IsStraight(uint64_t pattern) {
+    for (int i = 0; i < 10; ++i) {
+        if (StraightPattern(i) == pattern) return true;
+    }
+    return false;
+}
+
+// Rank counts (RanksHash layout) of a pattern holding each rank once.
+constexpr uint64_t CountsOfPattern(uint64_t pattern) {
+    uint64_t counts = 0;
+    for (int r = 0; r < kNumRanks; ++r) {
+        if (pattern & (uint64_t{1} << r)) counts += uint64_t{1} << (4 * r);
+    }
+    return counts;
+}
+
+constexpr uint64_t Counts(int rank, int copies) {
+    return static_cast<uint64_t>(copies) << (4 * rank);
+}
+
+// Appends classes in rank order.
+struct Builder {
+  FiveCardRankTables tables{};
+  size_t num_flush = 0;
+  size_t num_non_flush = 0;
+  int next_rank = 1;
+
+  constexpr void AddFlush(uint64_t pattern) {
+      tables.flush[num_flush++] = FiveCardRankEntry{pattern, next_rank++};
+  }
+  constexpr void AddNonFlush(uint64_t counts) {
+      tables.non_flush[num_non_flush++] = FiveCardRankEntry{counts, next_rank++};
+  }
+  // Five distinct ranks, highest combination first, skipping straights.
+  template <bool kFlush>
+  constexpr void AddDistinctNonStraights() {
+      for (int a = kAce; a >= 4; --a)
+       for (int b = a - 1; b >= 3; --b)
+        for (int c = b - 1; c >= 2; --c)
+         for (int d = c - 1; d >= 1; --d)
+          for (int e = d - 1; e >= 0; --e) {
+              uint64_t pattern = (uint64_t{1} << a) | (uint64_t{1} << b) | (uint64_t{1} << c) |
+                                 (uint64_t{1} << d) | (uint64_t{1} << e);
+              if (IsStraight(pattern)) continue;
+              if (kFlush) AddFlush(pattern); else AddNonFlush(CountsOfPattern(pattern));
+          }
+  }
+};
+
+} // namespace rank_tables_detail
+
+constexpr FiveCardRankTables GenerateFiveCardRankTables() {
+    using namespace rank_tables_detail;
+    Builder builder;
+    // --- Straight Flushes ---
+    for (int i = 0; i < 10; ++i) builder.AddFlush(StraightPattern(i));
+    // --- Four of a Kind ---
+    for (int quad = kAce; quad >= 0; --quad) {
+        for (int kicker = kAce; kicker >= 0; --kicker) {
+            if (kicker != quad) builder.AddNonFlush(Counts(quad, 4) + Counts(kicker, 1));
+        }
+    }
+    // --- Full Houses ---
+    for (int trips = kAce; trips >= 0; --trips) {
+        for (int pair = kAce; pair >= 0; --pair) {
+            if (pair != trips) builder.AddNonFlush(Counts(trips, 3) + Counts(pair, 2));
+        }
+    }
+    // --- Flushes ---
+    builder.AddDistinctNonStraights<true>();
+    // --- Straights ---
+    for (int i = 0; i < 10; ++i) builder.AddNonFlush(CountsOfPattern(StraightPattern(i)));
+    // --- Three of a Kind ---
+    for (int trips = kAce; trips >= 0; --trips) {
+        for (int k1 = kAce; k1 >= 0; --k1) {
+            if (k1 == trips) continue;
+            for (int k2 = k1 - 1; k2 >= 0; --k2) {
+                if (k2 != trips) builder.AddNonFlush(Counts(trips, 3) + Counts(k1, 1) + Counts(k2, 1));
+            }
+        }
+    }
+    // --- Two Pair ---
+    for (int high = kAce; high >= 1; --high) {
+        for (int low = high - 1; low >= 0; --low) {
+            for (int kicker = kAce; kicker >= 0; --kicker) {
+                if (kicker != high && kicker != low) {
+                    builder.AddNonFlush(Counts(high, 2) + Counts(low, 2) + Counts(kicker, 1));
+                }
+            }
+        }
+    }
+    // --- One Pair ---
+    for (int pair = kAce; pair >= 0; --pair) {
+        for (int k1 = kAce; k1 >= 0; --k1) {
+            if (k1 == pair) continue;
+            for (int k2 = k1 - 1; k2 >= 0; --k2) {
+                if (k2 == pair) continue;
+                for (int k3 = k2 - 1; k3 >= 0; --k3) {
+                    if (k3 != pair) {
+                        builder.AddNonFlush(Counts(pair, 2) + Counts(k1, 1) + Counts(k2, 1) + Counts(k3, 1));
+                    }
+                }
+            }
+        }
+    }
+    // --- High Card ---
+    builder.AddDistinctNonStraights<false>();
+    return builder.tables;
+}
+
+} // namespace eval
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_EVAL_FIVE_CARD_RANK_TABLES_H_
@@ -0,0 +1,77 @@
+#ifndef POKER_SOLVER_EVAL_SHORT_DECK_COMPAIRER_H_
+#define POKER_SOLVER_EVAL_SHORT_DECK_COMPAIRER_H_
+
+#include "compairer/Compairer.h"     // Base class interface
+#include "compairer/Dic5Compairer.h" // For kInvalidRank and RanksHash
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace poker_solver {
+namespace eval {
+
+// Compairer for short-deck (6+) hold'em: 36 cards, sixes to aces, with the
+// standard card integers (see core::Deck::ShortDeck).
+//
+// Hand order follows the common 6+ rules: straight flush, four of a kind,
+// flush, full house, three of a kind, straight, two pair, one pair, high
+// card. A-6-7-8-9 is the lowest straight. The 1404 five-card classes rank
+// 1 (royal flush) to kNumHandClasses, lower is better as for Dic5Compairer.
+//
+// The tables are built in the constructor, without a dictionary file: the
+// best flush per 9-bit rank pattern of one suit (512 entries), and the best
+// non-flush rank per rank-count multiset of 5 to 7 cards, sorted by key for
+// binary search. Either side of a 5-7 card hand is one lookup.
+class ShortDeckCompairer : public core::Compairer {
+ public:
+  // --- Constants ---
+  static constexpr int kInvalidRank = Dic5Compairer::kInvalidRank;
+  static constexpr int kNumHandClasses = 1404;
+  static constexpr int kMinCards = 5;
+  static constexpr int kMaxCards = 7;
+
+  // --- Constructor ---
+  ShortDeckCompairer();
+
+  // --- Overridden Interface Methods ---
+  core::ComparisonResult CompareHands(
+      const std::vector<int>& private_hand1,
+      const std::vector<int>& private_hand2,
+      const std::vector<int>& public_board) const override;
+
+  core::ComparisonResult CompareHands(uint64_t private_mask1,
+                                      uint64_t private_mask2,
+                                      uint64_t public_mask) const override;
+
+  int GetHandRank(const std::vector<int>& private_hand,
+                  const std::vector<int>& public_board) const override;
+
+  int GetHandRank(uint64_t private_mask,
+                  uint64_t public_mask) const override;
+
+  // Rank of the best 5 cards in 'cards_mask'; kInvalidRank unless it holds
+  // kMinCards to kMaxCards cards, all from the short deck.
+  int RankOfMask(uint64_t cards_mask) const;
+
+  // Bytes of the lookup tables.
+  size_t MemoryBytes() const;
+
+ private:
+  // --- Private Helper Methods ---
+  // Ranks the 5-card classes, then derives the 5-7 card tables from them.
+  void BuildTables();
+
+  // --- Member Variables ---
+  // Best flush rank per 9-bit rank pattern (bit 0 = six); kInvalidRank for
+  // fewer than 5 cards.
+  std::vector<int> flush_ranks_;
+  // Rank counts (RanksHash layout, shifted down to the six) ascending, and
+  // the best non-flush rank of each.
+  std::vector<uint64_t> rank_count_keys_;
+  std::vector<int> rank_count_ranks_;
+};
+
+} // namespace eval
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_EVAL_SHORT_DECK_COMPAIRER_H_
@@ -1,36 +1,47 @@
-i#ifndef POKER_SOLVER_KUHN_KUHN_POKER_SETUP_H_
+#ifndef POKER_SOLVER_KUHN_KUHN_POKER_SETUP_H_
 #define POKER_SOLVER_KUHN_KUHN_POKER_SETUP_H_
 
 #include "compairer/Compairer.h" // Base class for comparer
-#include "nodes/GameTreeNode.h"  // Base class for tree nodes
-#include "GameTree.h"            // For GameTree class (optional, could return root node directly)
+#include "ranges/PrivateCards.h" // For PrivateCards
+#include "solver/PCfrSolver.h"   // For PCfrSolver::Config
+#include "tools/Rule.h"          // For Rule
+#include "GameTree.h"            // For GameTree
 
-#include <vector>
+#include <cstdint>
 #include <memory> // For std::shared_ptr
-#include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace poker_solver {
-
-// Forward declare node types used in the builder
-namespace nodes {
-    class ActionNode;
-    class ChanceNode;
-    class ShowdownNode;
-    class TerminalNode;
-} // namespace nodes
-
 namespace kuhn {
 
+// Kuhn poker as a spot PCfrSolver solves: each player antes 1 and holds
+// one of three hands J < Q < K, never the same one; the first player checks
+// or bets 1, and a bet is called or folded. Its Nash value is known, so
+// the solver's convergence can be checked against it.
+//
+// The hands are pocket pairs (J = 2c2d, Q = 3c3d, K = 4c4d), so the only
+// blocked deal is both players holding the same hand, and KuhnCompairer
+// ranks them by which pair they hold, whatever the board. The betting is
+// on the turn with stacks of 2, so the bet is all-in; the river only checks
+// and does not change any showdown, so the game stays Kuhn's while turn
+// chance sampling (Config::sampled_chance_outcomes) has outcomes to draw.
+// The first player is out of position: solver player 1.
+
 // --- Constants for Kuhn Poker ---
 constexpr int KUHN_CARD_J = 0;
 constexpr int KUHN_CARD_Q = 1;
 constexpr int KUHN_CARD_K = 2;
 constexpr int KUHN_DECK_SIZE = 3;
+constexpr size_t KUHN_FIRST_PLAYER = 1;
+// Game value for the first player, in antes per deal.
+constexpr double KUHN_GAME_VALUE = -1.0 / 18.0;
 
-// Represent actions simply for Kuhn
-enum class KuhnActionType { Check = 0, Bet = 1, Fold = 0, Call = 1 }; // Check/Fold=0, Bet/Call=1
+// Card masks of the pocket pair standing for each Kuhn card.
+uint64_t kuhn_hand_mask(int kuhn_card);
 
 // --- Kuhn Hand Comparer ---
+// Ranks a hand by the Kuhn card it holds (K = 0, the best, to J = 2).
 class KuhnCompairer : public core::Compairer {
 public:
     KuhnCompairer() = default;
@@ -39,16 +50,14 @@ public:
     // Compares two single Kuhn cards (higher card wins)
     core::ComparisonResult CompareHands(int private_card1, int private_card2) const;
 
-    // --- Implementations matching the Compairer interface ---
-    // We only really need the single-card comparison for Kuhn.
-    // Others can throw or return default/invalid values.
-
+    // The board is ignored by every overload.
+    // Throws:
+    //   std::invalid_argument if a hand is not one of the three pairs.
     core::ComparisonResult CompareHands(
         const std::vector<int>& private_hand1,
         const std::vector<int>& private_hand2,
         const std::vector<int>& public_board) const override;
 
-    // Mask versions are not applicable to Kuhn in this simple setup
     core::ComparisonResult CompareHands(uint64_t private_mask1,
                                         uint64_t private_mask2,
                                         uint64_t public_mask) const override;
@@ -56,23 +65,40 @@ public:
     int GetHandRank(const std::vector<int>& private_hand,
                     const std::vector<int>& public_board) const override;
 
-    // Mask version not applicable
     int GetHandRank(uint64_t private_mask,
                     uint64_t public_mask) const override;
-
 };
 
-// --- Kuhn Game Tree Builder ---
-// Function to explicitly build the Kuhn Poker game tree.
-// Returns the root node of the constructed tree.
-std::shared_ptr<core::GameTreeNode> build_kuhn_game_tree();
+// --- Kuhn Game ---
+// The rule of the spot above: turn board Ah Kd 8s 7c, 1 committed by each
+// player, 2 behind.
+config::Rule get_kuhn_rule();
 
+// Builds the Kuhn poker game tree from get_kuhn_rule().
+std::shared_ptr<tree::GameTree> build_kuhn_game_tree();
 
-// --- Helper: Kuhn Range ---
-// Creates the initial uniform range {J, Q, K} for Kuhn Poker.
-// Note: Uses the base PrivateCards struct, but only card1_int matters.
+// The range {J, Q, K} of either player, one pocket pair per Kuhn card.
 std::vector<core::PrivateCards> get_kuhn_initial_range();
 
+// A solver of the Kuhn tree with KuhnCompairer and both players on
+// get_kuhn_initial_range().
+std::unique_ptr<solver::PCfrSolver> make_kuhn_solver(const solver::PCfrSolver::Config& config);
+
+// --- Convergence Harness ---
+// One trainer setting and the exploitability it must reach on Kuhn poker.
+struct KuhnConvergenceMode {
+    std::string name;
+    solver::PCfrSolver::Config config; // iteration_limit: iterations to run
+    double max_exploitability = 0.0;   // Percentage of the pot after them
+};
+
+// Every trainer (Discounted, Linear, CFR+) and precision, and the lossy
+// modes (simultaneous updates, regret pruning, chance sampling), each with a
+// bound about twice the exploitability it reaches at this commit. A mode
+// that misses its bound has stopped converging as well as it did; see
+// tests/kuhn_convergence_test.cpp and bench/kuhn_bench.cpp.
+std::vector<KuhnConvergenceMode> kuhn_convergence_modes();
+
 } // namespace kuhn
 } // namespace poker_solver
 
@@ -7,6 +7,7 @@
 #include <vector>
 #include <memory> // For std::shared_ptr
 #include <cstddef> // For size_t
+#include <cstdint> // For uint64_t
 #include <optional> // For optional return values
 #include <trainable/Trainable.h>
 
@@ -14,6 +15,7 @@
 // namespace poker_solver { namespace solver { class Trainable; } }
 // Forward declaration for concrete Trainable types (if needed in header, though unlikely)
 // namespace poker_solver { namespace solver { class DiscountedCfrTrainable; } }
+namespace poker_solver { namespace solver { class TrainableArena; } }
 
 namespace poker_solver {
 namespace nodes {
@@ -21,8 +23,17 @@ namespace nodes {
 // Represents a decision node in the game tree where a player must choose an action.
 class ActionNode : public core::GameTreeNode {
  public:
-  // Enum to specify float precision for Trainable objects (if needed)
-  enum class TrainablePrecision { kFloat, kHalf, kSingle }; // Example
+  // Storage precision for Trainable objects created by GetTrainable.
+  //   kFloat:  double storage (DiscountedCfrTrainable, default).
+  //   kSingle: 32-bit float storage (DiscountedCfrTrainableSF).
+  //   kHalf:   16-bit fixed point with per-hand scale (DiscountedCfrTrainableHF).
+  enum class TrainablePrecision { kFloat, kHalf, kSingle };
+
+  // Update rule of Trainable objects created by GetTrainable.
+  //   kDiscounted: Discounted CFR (types above).
+  //   kCfrPlus:    CFR+ (CfrPlusTrainableSF; CfrPlusTrainableHF for kHalf).
+  //                CFR+ is float based, so kFloat also gets 32-bit storage.
+  enum class TrainableAlgorithm { kDiscounted, kCfrPlus };
 
   // Constructor.
   // Args:
@@ -74,6 +85,14 @@ class ActionNode : public core::GameTreeNode {
   //   deal_index: The index representing the abstract chance outcome (0 for
   //               perfect recall, 0 to num_possible_deals-1 for imperfect recall).
   //   precision: The desired float precision for the Trainable object.
+  //   algorithm: The update rule of the Trainable object.
+  //   arena:     Storage for double-precision Discounted CFR tables; the
+  //              trainable owns its storage when null. Other types ignore it.
+  //   lazy_strategies: Double-precision Discounted CFR only; keep no
+  //              resident current/average strategy (see DiscountedCfrTrainable).
+  //   defer_strategy_sums: Double-precision Discounted CFR only; allocate
+  //              the strategy sums on first use (see DiscountedCfrTrainable).
+  //   On a locked node (see LockStrategy) all but deal_index are ignored.
   // Returns:
   //   A shared pointer to the Trainable object.
   // Throws:
@@ -82,15 +101,67 @@ class ActionNode : public core::GameTreeNode {
   //   std::bad_alloc if creation fails.
   std::shared_ptr<solver::Trainable> GetTrainable(
       size_t deal_index,
-      TrainablePrecision precision = TrainablePrecision::kFloat);
+      TrainablePrecision precision = TrainablePrecision::kFloat,
+      TrainableAlgorithm algorithm = TrainableAlgorithm::kDiscounted,
+      const std::shared_ptr<solver::TrainableArena>& arena = nullptr,
+      bool lazy_strategies = false,
+      bool defer_strategy_sums = false);
+
+  // Bytes of the regret/strategy tables GetTrainable allocates for one deal
+  // slot of a node with 'num_actions' actions and 'num_hands' hands, for the
+  // given precision and algorithm (arena-backed tables are counted with their
+  // 64-byte alignment). Expected values, allocated only on demand, are not
+  // included.
+  static uint64_t TrainableBytes(size_t num_actions, size_t num_hands,
+                                 TrainablePrecision precision,
+                                 TrainableAlgorithm algorithm = TrainableAlgorithm::kDiscounted,
+                                 bool lazy_strategies = false);
 
   // Gets the Trainable object without creating it if it doesn't exist.
   std::shared_ptr<solver::Trainable> GetTrainableIfExists(size_t deal_index) const;
 
+  // Puts 'trainable' in the deal slot in place of the current one, e.g. a
+  // solver::SparseDiscountedCfrTrainable taking over a dense trainable's
+  // state.
+  // Throws:
+  //   std::out_of_range if deal_index is invalid.
+  void ReplaceTrainable(size_t deal_index, std::shared_ptr<solver::Trainable> trainable);
+
+  // Number of deal slots (valid deal_index values are 0..N-1).
+  size_t GetNumPossibleDeals() const { return trainables_.size(); }
+
+  // Resizes the per-deal trainable storage. Slots are only filled lazily by
+  // GetTrainable, so unreached deals cost one null pointer each. Existing
+  // trainables below the new size are kept.
+  // Throws:
+  //   std::invalid_argument if num_possible_deals is zero.
+  void SetNumPossibleDeals(size_t num_possible_deals);
+
   const std::vector<core::PrivateCards>* GetPlayerRangeRaw() const {
     return player_range_; // Defined inline HERE
   }
 
+  // --- Node Locking ---
+
+  // Fixes the node's strategy for every deal: GetTrainable then returns a
+  // solver::LockedTrainable over 'strategy' (hand-major, num_actions values
+  // per hand of the player range, each row summing to 1), shared by all deal
+  // slots, so the node keeps no regrets or strategy sums. Trainables created
+  // before the call are dropped.
+  // Throws:
+  //   std::runtime_error if player_range_ has not been set.
+  //   std::invalid_argument if the size does not match, a value is negative
+  //   or not finite, or a row does not sum to 1.
+  void LockStrategy(std::vector<double> strategy);
+
+  // Drops the lock and any locked trainables; later GetTrainable calls
+  // create regular trainables again.
+  void Unlock();
+
+  bool IsLocked() const { return locked_strategy_ != nullptr; }
+  // The strategy passed to LockStrategy; null when not locked.
+  const std::vector<double>* GetLockedStrategy() const { return locked_strategy_.get(); }
+
  private:
   size_t player_index_; // Player whose turn it is (0=IP, 1=OOP)
   std::vector<core::GameAction> actions_; // Possible actions from this node
@@ -104,6 +175,9 @@ class ActionNode : public core::GameTreeNode {
   // Size is determined by num_possible_deals in the constructor.
   std::vector<std::shared_ptr<solver::Trainable>> trainables_;
 
+  // Set by LockStrategy; shared by the locked trainables of every deal slot.
+  std::shared_ptr<const std::vector<double>> locked_strategy_;
+
   // Deleted copy/move operations because we manage shared_ptrs and a raw pointer.
   ActionNode(const ActionNode&) = delete;
   ActionNode& operator=(const ActionNode&) = delete;
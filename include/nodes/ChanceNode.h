@@ -13,7 +13,11 @@ namespace nodes {
 // Represents a chance node in the game tree, typically occurring after a
 // betting round concludes and community cards are dealt.
 // This node stores the specific cards dealt at this chance event and points
-// to the single resulting child node.
+// to the single resulting child node. Dynamically built trees leave
+// 'dealt_cards' empty: the one child subtree stands for every card the node
+// can deal, and the state that differs per card lives in the deal slots of
+// the ActionNodes below (see ActionNode::SetNumPossibleDeals). The tree thus
+// stays the same size however many runouts the deck allows.
 class ChanceNode : public core::GameTreeNode {
  public:
   // Constructor.
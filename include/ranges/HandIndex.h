@@ -0,0 +1,41 @@
+#ifndef POKER_SOLVER_RANGES_HAND_INDEX_H_
+#define POKER_SOLVER_RANGES_HAND_INDEX_H_
+
+#include "Card.h" // For kNumCardsInDeck
+#include <array>
+#include <cstdint>
+
+namespace poker_solver {
+namespace core {
+
+// Canonical dense index of a two-card hand, shared by ranges, trainables and
+// caches so that hot paths look hands up in flat arrays instead of hashing.
+// Hand {card1, card2} with card1 < card2 has index
+// card2 * (card2 - 1) / 2 + card1 (its colex rank), 0 .. kNumHandCombos - 1.
+
+constexpr int kNumHandCombos = kNumCardsInDeck * (kNumCardsInDeck - 1) / 2; // 1326
+constexpr int kNumCombosPerCard = kNumCardsInDeck - 1; // Hands holding a given card
+
+// Dense index of the hand {card1, card2}; the cards may come in any order
+// but must differ and be valid.
+constexpr int ComboIndex(int card1, int card2) {
+  return card1 < card2 ? card2 * (card2 - 1) / 2 + card1
+                       : card1 * (card1 - 1) / 2 + card2;
+}
+
+// Precomputed per-combo cards and per-card blocker lists.
+struct HandIndexTables {
+  // Lower and higher card of each combo index.
+  std::array<uint8_t, kNumHandCombos> card1{};
+  std::array<uint8_t, kNumHandCombos> card2{};
+  // blockers[c]: the kNumCombosPerCard combo indices holding card c, ascending.
+  std::array<std::array<uint16_t, kNumCombosPerCard>, kNumCardsInDeck> blockers{};
+};
+
+// The shared tables, built on first use.
+const HandIndexTables& GetHandIndexTables();
+
+} // namespace core
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_RANGES_HAND_INDEX_H_
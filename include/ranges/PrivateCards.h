@@ -2,6 +2,7 @@
 #define POKER_SOLVER_CORE_PRIVATE_CARDS_H_
 
 #include "Card.h" // For Card class and constants
+#include "ranges/HandIndex.h" // For ComboIndex
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -39,6 +40,9 @@ class PrivateCards {
   // Returns the weight associated with this hand.
   double Weight() const { return weight_; }
 
+  // Returns the canonical dense index of these two cards (see HandIndex.h).
+  int GetComboIndex() const { return ComboIndex(card1_int_, card2_int_); }
+
   // Returns the pre-calculated 64-bit bitmask for these two cards.
   uint64_t GetBoardMask() const { return board_mask_; }
 
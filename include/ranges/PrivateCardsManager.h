@@ -4,8 +4,8 @@
 #include "PrivateCards.h" // For PrivateCards
 #include "Card.h"          // For Card utilities
 #include <vector>
+#include <array>
 #include <cstdint>
-#include <unordered_map>
 #include <optional> // For optional index return
 
 namespace poker_solver {
@@ -19,7 +19,9 @@ class PrivateCardsManager {
   // Args:
   //   initial_ranges: A vector where each inner vector contains the
   //                   PrivateCards range for a player (e.g., index 0 for P1, 1 for P2).
-  //                   Ranges should be pre-filtered against the initial board.
+  //                   Hands with zero weight or blocked by the initial
+  //                   board are dropped from the ranges the solver sees
+  //                   (see GetPlayerRange / GetOriginalRange).
   //   initial_board_mask: The bitmask representation of the initial board cards.
   // Throws:
   //   std::invalid_argument if initial_ranges is empty.
@@ -30,7 +32,10 @@ class PrivateCardsManager {
   // Returns the number of players managed.
   size_t GetNumPlayers() const { return num_players_; }
 
-  // Returns a const reference to the initial (pre-filtered) range for a player.
+  // Returns a const reference to the compacted range for a player: the
+  // initial range minus hands with zero weight or blocked by the initial
+  // board, in their original relative order. All hand indices taken or
+  // returned by this class and the solver refer to this range.
   // Args:
   //   player_index: The index of the player (0-based).
   // Returns:
@@ -40,8 +45,23 @@ class PrivateCardsManager {
   const std::vector<core::PrivateCards>& GetPlayerRange(
       size_t player_index) const;
 
+  // Returns the range exactly as passed to the constructor.
+  // Throws:
+  //   std::out_of_range if player_index is invalid.
+  const std::vector<core::PrivateCards>& GetOriginalRange(size_t player_index) const;
+
+  // Maps the compacted range back to the original one: element i is the
+  // index in GetOriginalRange(player_index) of GetPlayerRange(player_index)[i].
+  // Throws:
+  //   std::out_of_range if player_index is invalid.
+  const std::vector<int32_t>& GetOriginalHandIndices(size_t player_index) const;
+
+  // Index in the compacted range of original hand 'original_index', or -1 if
+  // that hand was dropped or either index is out of bounds.
+  int GetCompactHandIndex(size_t player_index, size_t original_index) const;
+
   // Finds the index of a specific hand combination within another player's range.
-  // Uses the canonical hash of the PrivateCards.
+  // One lookup in the target player's dense combo table.
   // Args:
   //   from_player_index: The index of the player whose hand we are starting with.
   //   to_player_index: The index of the player whose range we are searching in.
@@ -55,6 +75,18 @@ class PrivateCardsManager {
       size_t to_player_index,
       size_t from_hand_index) const;
 
+  // Returns the index in player_index's range of the hand with dense combo
+  // index 'combo_index' (see HandIndex.h), or -1 if the range lacks it or
+  // either index is out of bounds.
+  int GetHandIndex(size_t player_index, int combo_index) const;
+
+  // Returns the indices, ascending, of the hands in player_index's range that
+  // hold 'card'. Zeroing a dealt card's blocked reach touches only these
+  // (at most 51) hands instead of scanning the range.
+  // Throws:
+  //   std::out_of_range if player_index or card is invalid.
+  const std::vector<int32_t>& GetHandsWithCard(size_t player_index, int card) const;
+
   // Calculates the initial reach probability vector for a specific player.
   // This vector reflects the initial weights, adjusted for card removal effects
   // against the initial board and *all other players'* possible hands.
@@ -81,12 +113,23 @@ class PrivateCardsManager {
   uint64_t initial_board_mask_;
 
   // Stores the initial ranges provided to the constructor.
+  std::vector<std::vector<core::PrivateCards>> original_ranges_;
+
+  // Compacted ranges (see GetPlayerRange).
   std::vector<std::vector<core::PrivateCards>> player_ranges_;
 
-  // Lookup table: maps PrivateCards hash -> player index -> hand index in player_ranges_
-  // Using std::size_t for the hash key (result of std::hash<PrivateCards>).
-  std::unordered_map<std::size_t, std::vector<std::optional<size_t>>>
-      hand_hash_to_indices_;
+  // original_indices_[player][compact]: see GetOriginalHandIndices.
+  std::vector<std::vector<int32_t>> original_indices_;
+
+  // compact_indices_[player][original]: see GetCompactHandIndex.
+  std::vector<std::vector<int32_t>> compact_indices_;
+
+  // combo_to_hand_[player][combo]: index in player_ranges_[player] of the
+  // hand with that dense combo index, or -1. kNumHandCombos entries each.
+  std::vector<std::vector<int32_t>> combo_to_hand_;
+
+  // hands_with_card_[player][card]: see GetHandsWithCard.
+  std::vector<std::array<std::vector<int32_t>, core::kNumCardsInDeck>> hands_with_card_;
 
   // Stores the calculated initial reach probabilities for each player,
   // considering card removal effects.
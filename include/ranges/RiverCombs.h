@@ -3,6 +3,8 @@
 
 #include "PrivateCards.h" // For PrivateCards
 #include <cstddef> // For size_t
+#include <cstdint>
+#include <vector>
 
 namespace poker_solver {
 namespace ranges {
@@ -41,6 +43,33 @@ struct RiverCombs {
   // that is already keyed by the specific river board, making storing it again redundant.
 };
 
+// Struct-of-arrays form of a rank-sorted RiverCombs vector: what
+// RiverRangeManager caches and the showdown kernel streams over. Position r
+// holds the r-th combo (worst first); the two hole cards are kept as card
+// integers since the kernel indexes per-card accumulators with them. About
+// 8 bytes per combo instead of sizeof(RiverCombs).
+struct PackedRiverCombos {
+  std::vector<int32_t> ranks;
+  std::vector<uint16_t> original_indices; // Index in the initial range
+  std::vector<uint8_t> card1s;            // Lower card integer
+  std::vector<uint8_t> card2s;            // Higher card integer
+  // Runs of equal rank: run_starts[k] is the first position of run k, and a
+  // final entry equals size(), so run k spans [run_starts[k], run_starts[k+1]).
+  std::vector<uint32_t> run_starts;
+
+  size_t size() const { return ranks.size(); }
+  bool empty() const { return ranks.empty(); }
+  size_t NumRuns() const { return run_starts.empty() ? 0 : run_starts.size() - 1; }
+
+  // Heap bytes of the arrays.
+  size_t MemoryBytes() const;
+};
+
+// Packs 'combos', keeping their order.
+// Throws:
+//   std::out_of_range if an original_range_index does not fit 16 bits.
+PackedRiverCombos PackRiverCombos(const std::vector<RiverCombs>& combos);
+
 } // namespace ranges
 } // namespace poker_solver
 
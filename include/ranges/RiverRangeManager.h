@@ -7,17 +7,57 @@
 #include "Card.h"              // For Card utilities
 #include <vector>
 #include <cstdint>
-#include <unordered_map>
+#include "tools/FlatHashMap.h"       // For the board caches
 #include <memory>                   // For std::shared_ptr
 #include <mutex>                    // For std::mutex, std::lock_guard
+#include <atomic>                   // For the cache counters
+#include <functional>               // For RiverPreloadPlacement
 #include <stdexcept>                // For exceptions
 
 namespace poker_solver {
 namespace ranges {
 
+// Dense lookup tables between a player's initial range and the rank-sorted
+// RiverCombs vector for one river board. Built once per board alongside the
+// combos so hot paths only do array indexing.
+struct RiverComboIndex {
+  // Marks an initial-range hand that conflicts with the river board.
+  static constexpr int32_t kNotOnRiver = -1;
+
+  // original_to_river[i]: position of initial-range hand i in the combos
+  // vector, or kNotOnRiver. Size equals the initial range size.
+  std::vector<int32_t> original_to_river;
+
+  // river_to_original[r]: initial-range index of combos[r].
+  // Size equals the number of river combos.
+  std::vector<int32_t> river_to_original;
+};
+
+// Counters of the lazy cache (lookups served by the preloaded index are not
+// counted).
+struct RiverCacheStats {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t evictions = 0;
+  size_t entries = 0; // Boards currently cached, both players
+  size_t bytes = 0;   // Estimated bytes of those entries
+};
+
 // Manages the calculation and caching of evaluated hand strengths (ranks)
 // for player ranges on specific river boards.
 // This class is designed to be thread-safe for concurrent read/write access.
+// Which threads PreloadRiverBoards computes each board on, for NUMA
+// placement (see PCfrSolver::Config::numa_aware): a board's entries are
+// computed, and so first written, by the threads of its home.
+struct RiverPreloadPlacement {
+  size_t num_homes = 1;
+  // Home (< num_homes) of a river board.
+  std::function<size_t(uint64_t board_mask)> home_of_board;
+  // Run once by each thread of the loop with its number and the team size;
+  // returns the thread's home, and may pin the thread there.
+  std::function<size_t(int thread, int num_threads)> enter_thread;
+};
+
 class RiverRangeManager {
  public:
   // Constructor.
@@ -28,21 +68,39 @@ class RiverRangeManager {
   //   std::invalid_argument if compairer is null.
   explicit RiverRangeManager(std::shared_ptr<core::Compairer> compairer);
 
-  // Calculates or retrieves the cached vector of evaluated RiverCombs for a
-  // given player, their initial range, and a specific river board.
-  // The resulting vector is sorted by rank (worst hand first, i.e., highest
-  // rank number first, consistent with the original project's sort order).
+  // Calculates or retrieves the cached combos of a given player, their
+  // initial range, and a specific river board, in packed form. The combos
+  // are sorted by rank (worst hand first, i.e., highest rank number first,
+  // consistent with the original project's sort order).
   // Args:
   //   player_index: The index of the player (0 or 1).
   //   initial_player_range: The vector of PrivateCards representing the player's
   //                         range *before* considering the river board.
   //   river_board_mask: The uint64_t bitmask of the 5 river board cards.
   // Returns:
-  //   A const reference to the cached or newly calculated vector of RiverCombs.
+  //   A const reference to the cached or newly calculated combos. With a
+  //   memory budget (SetMemoryBudget) a later lookup may evict them; use
+  //   AcquireRiverCombos to keep them alive.
   // Throws:
   //   std::out_of_range if player_index is invalid (currently only supports 0 or 1).
   //   std::invalid_argument if river_board_mask doesn't represent exactly 5 cards.
-  const std::vector<RiverCombs>& GetRiverCombos(
+  const PackedRiverCombos& GetPackedRiverCombos(
+      size_t player_index,
+      const std::vector<core::PrivateCards>& initial_player_range,
+      uint64_t river_board_mask);
+
+  // Same as GetPackedRiverCombos, but the handle shares ownership of the
+  // cache entry, so it stays valid if the entry is evicted while held.
+  std::shared_ptr<const PackedRiverCombos> AcquireRiverCombos(
+      size_t player_index,
+      const std::vector<core::PrivateCards>& initial_player_range,
+      uint64_t river_board_mask);
+
+  // The cached combos unpacked into RiverCombs, in the same order. Builds a
+  // new vector on every call; meant for inspection, not hot paths.
+  // Throws:
+  //   Same as GetPackedRiverCombos.
+  std::vector<RiverCombs> GetRiverCombos(
       size_t player_index,
       const std::vector<core::PrivateCards>& initial_player_range,
       uint64_t river_board_mask);
@@ -52,17 +110,119 @@ class RiverRangeManager {
   //   std::invalid_argument if river_board_ints contains invalid card integers
   //                         or does not represent exactly 5 cards.
   //   std::out_of_range if player_index is invalid.
-  const std::vector<RiverCombs>& GetRiverCombos(
+  std::vector<RiverCombs> GetRiverCombos(
        size_t player_index,
        const std::vector<core::PrivateCards>& initial_player_range,
        const std::vector<int>& river_board_ints);
 
+  // Returns the dense original-index <-> river-index tables for the combos
+  // that GetPackedRiverCombos returns for the same player/range/board.
+  // Shares the same cache entry, so calling either one computes both.
+  // Throws:
+  //   Same as GetPackedRiverCombos.
+  const RiverComboIndex& GetRiverComboIndex(
+      size_t player_index,
+      const std::vector<core::PrivateCards>& initial_player_range,
+      uint64_t river_board_mask);
+
+  // Caps the estimated bytes of the lazy cache (both players); 0, the
+  // default, means unbounded. Once an insertion goes over the budget, the
+  // inserting player's cache evicts boards with the CLOCK policy (a lookup
+  // marks its board, the clock hand skips marked boards once), keeping the
+  // new board and at least one board per player. The preloaded index is not
+  // counted. Evicts immediately if over the new budget; must not run
+  // concurrently with GetPackedRiverCombos references in use.
+  void SetMemoryBudget(size_t bytes);
+  size_t GetMemoryBudget() const { return memory_budget_.load(std::memory_order_relaxed); }
+
+  // Snapshot of the lazy cache counters.
+  RiverCacheStats GetCacheStats() const;
+
+  // Upper bound of the bytes one cached board takes for a player whose
+  // initial range has 'range_size' hands (every hand unblocked, each rank in
+  // its own run); the same accounting as the cache budget uses.
+  static size_t EstimateEntryBytes(size_t range_size);
+
+  // Precomputes the combos of every river board that completes
+  // 'base_board_mask' with cards from 'deck_mask', for both players, using
+  // an OpenMP parallel loop. The results form an immutable index addressed
+  // by a dense board number, so later lookups of those boards take no lock
+  // and allocate nothing; other boards still go through the lazy cache.
+  // Lookups must pass the same ranges, as for the lazy cache. Replaces any
+  // earlier preload and must not run concurrently with lookups. With a
+  // 'placement', each thread computes its home's boards (and those of homes
+  // left without threads) instead of taking the next board.
+  // Throws:
+  //   std::invalid_argument if base_board_mask holds more than 5 cards.
+  void PreloadRiverBoards(const std::vector<core::PrivateCards>& player_0_range,
+                          const std::vector<core::PrivateCards>& player_1_range,
+                          uint64_t base_board_mask,
+                          uint64_t deck_mask = (1ULL << core::kNumCardsInDeck) - 1,
+                          const RiverPreloadPlacement* placement = nullptr);
+
+  // Number of boards in the preloaded index (0 without a preload).
+  size_t GetNumPreloadedBoards() const { return preloaded_boards_.size(); }
+
+  // Heap bytes of the preloaded index, both players (0 without a preload).
+  size_t GetPreloadedBytes() const { return preloaded_bytes_; }
+
+  // Board masks of the preloaded index, in board-number order.
+  const std::vector<uint64_t>& GetPreloadedBoards() const { return preloaded_boards_; }
+
  private:
-  // Calculates, sorts, and caches the RiverCombs for a given player/board.
-  // This is called internally by GetRiverCombos if the result isn't cached.
+  // One cached board: the sorted combos plus their index tables.
+  struct CacheEntry {
+    PackedRiverCombos combos;
+    RiverComboIndex index;
+  };
+
+  // One board in a player's lazy cache.
+  struct CacheSlot {
+    std::shared_ptr<const CacheEntry> entry;
+    size_t bytes = 0;
+    bool referenced = false; // CLOCK mark, set by hits
+  };
+
+  // A player's lazy cache. The clock ring lists the cached boards in
+  // insertion order; clock_hand is the next eviction candidate.
+  struct PlayerCache {
+    hashing::FlatHashMap<CacheSlot> boards;
+    std::vector<uint64_t> clock_ring;
+    size_t clock_hand = 0;
+    mutable std::mutex mutex;
+  };
+
+  // Estimated heap footprint of a cache entry, including its map node.
+  static size_t EntryBytes(const CacheEntry& entry);
+
+  // Evicts boards other than 'keep_board_mask' from 'cache' until the
+  // cache total fits the budget or only one board is left. Requires
+  // cache.mutex to be held.
+  void EvictOverBudget(PlayerCache& cache, uint64_t keep_board_mask);
+
+  // Looks up the cache entry for a player/board, computing it on a miss.
+  // Entries of the preloaded index come back without an owner.
+  std::shared_ptr<const CacheEntry> GetOrCreateEntry(
+      size_t player_index,
+      const std::vector<core::PrivateCards>& initial_player_range,
+      uint64_t river_board_mask);
+
+  // Dense board number of 'river_board_mask' in the preloaded index, or -1
+  // if the preload does not cover it.
+  int64_t PreloadedBoardNumber(uint64_t river_board_mask) const;
+
+  // Calculates, sorts and packs the combos for a player/board with their
+  // index tables, without touching the caches.
+  // Throws:
+  //   std::invalid_argument if river_board_mask doesn't represent exactly 5 cards.
+  CacheEntry ComputeEntry(const std::vector<core::PrivateCards>& initial_player_range,
+                          uint64_t river_board_mask) const;
+
+  // Calculates, sorts, and caches the combos for a given player/board.
+  // This is called internally by GetOrCreateEntry if the result isn't cached.
   // Assumes the cache lock is NOT held when called.
-  // Returns a const reference to the newly inserted element in the cache.
-  const std::vector<RiverCombs>& CalculateAndCacheRiverCombos(
+  // Returns the newly inserted (or concurrently inserted) cache entry.
+  std::shared_ptr<const CacheEntry> CalculateAndCacheRiverCombos(
       size_t player_index,
       const std::vector<core::PrivateCards>& initial_player_range,
       uint64_t river_board_mask);
@@ -73,14 +233,25 @@ class RiverRangeManager {
   std::shared_ptr<core::Compairer> compairer_;
 
   // Caches for evaluated river ranges. Key is the river board mask.
-  // Separate caches per player (assuming 2 players).
-  std::unordered_map<uint64_t, std::vector<RiverCombs>> player_0_cache_;
-  std::unordered_map<uint64_t, std::vector<RiverCombs>> player_1_cache_;
-
-  // Mutexes to protect access to each player's cache during lookups/insertions.
-  // Using mutable allows locking within const member functions like GetRiverCombos.
-  mutable std::mutex player_0_cache_mutex_;
-  mutable std::mutex player_1_cache_mutex_;
+  // Separate caches per player (assuming 2 players), each with its mutex.
+  PlayerCache caches_[2];
+
+  // Memory budget of the lazy caches (0: unbounded) and their counters.
+  std::atomic<size_t> memory_budget_{0};
+  std::atomic<size_t> cached_bytes_{0};
+  std::atomic<uint64_t> cache_hits_{0};
+  std::atomic<uint64_t> cache_misses_{0};
+  std::atomic<uint64_t> cache_evictions_{0};
+
+  // Preloaded index (see PreloadRiverBoards). A board is the base board
+  // plus preload_num_extra_ cards of preload_free_mask_; its number is the
+  // colex rank of those cards' positions among the free cards.
+  uint64_t preload_base_mask_ = 0;
+  uint64_t preload_free_mask_ = 0;
+  int preload_num_extra_ = 0;
+  std::vector<uint64_t> preloaded_boards_; // Board mask per board number
+  std::vector<CacheEntry> preloaded_entries_[2]; // Per player, by board number
+  size_t preloaded_bytes_ = 0;
 
   // Deleted copy/move operations to prevent accidental copying of caches/mutexes.
   RiverRangeManager(const RiverRangeManager&) = delete;
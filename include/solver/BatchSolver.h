@@ -0,0 +1,92 @@
+#ifndef POKER_SOLVER_SOLVER_BATCH_SOLVER_H_
+#define POKER_SOLVER_SOLVER_BATCH_SOLVER_H_
+
+#include "compairer/Compairer.h"   // For Compairer
+#include "solver/PCfrSolver.h"     // For PCfrSolver, PCfrSolver::Config
+#include "solver/SolutionStore.h"  // For SolutionStore
+#include "solver/SolverTransport.h" // For SolverTransport
+#include "solver/TraceRecorder.h"   // For TraceRecorder
+#include "tools/ScenarioFile.h"    // For Scenario
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace poker_solver {
+namespace solver {
+
+// One spot of a batch: what to solve and how.
+struct BatchSpot {
+  config::Scenario scenario;
+  // Solver settings. num_threads is chosen by BatchSolver; with
+  // warmup_river_cache the preload runs once per shared river cache.
+  PCfrSolver::Config config;
+};
+
+struct BatchSpotResult {
+  bool solved = false;
+  std::string error;              // Why the spot was not solved
+  uint64_t estimated_bytes = 0;   // PCfrSolver::EstimateMemory total
+  uint64_t memory_bytes = 0;      // PCfrSolver::GetMemoryStats total after training
+  int threads = 0;                // Threads the spot was solved with
+  bool reused_river_cache = false; // Its river cache was built for an earlier spot
+  int iterations = 0;
+  double exploitability = -1.0;   // Last measured, or negative
+  double seconds = 0.0;           // Setup, training and the callback
+  // Set when the spot was found in Options::solution_store instead of
+  // solved; iterations, memory and exploitability are then not known.
+  std::optional<SolutionStore::Hit> cached;
+};
+
+// Solves a queue of spots in one process. Every spot shares the hand
+// evaluator, and spots on the same board with the same ranges and deck share
+// one RiverRangeManager, kept until the last of them is solved, so its river
+// combos are evaluated once. Large spots (estimated trainable memory above
+// Options::small_spot_bytes, e.g. flops) run one after another on all
+// threads; small ones (e.g. rivers), which do not scale across threads, run
+// side by side with one thread each.
+class BatchSolver {
+ public:
+  struct Options {
+    int num_threads;          // Total threads; default: hardware concurrency
+    size_t small_spot_bytes;  // Default 32 MiB
+    uint64_t memory_limit;    // Skip spots estimated above this; 0: no limit
+    // Distributed solving (see PCfrSolver::SetTransport). Every rank runs
+    // the same batch; each spot is solved by the whole group, on all local
+    // threads, and skipped on all ranks if any rank would skip it.
+    std::shared_ptr<SolverTransport> transport;
+    // Spans of every spot's solve (see PCfrSolver::SetTraceRecorder); null: none.
+    std::shared_ptr<TraceRecorder> trace;
+    // Solved spots to reuse: a spot found here is not solved (nor passed to
+    // the callback), and each solved spot is added. Not used in
+    // distributed batches.
+    std::shared_ptr<SolutionStore> solution_store;
+    Options();
+  };
+
+  // Called once per solved spot, with its trained solver, e.g. to write the
+  // strategy (after it is added to the solution store). Calls are serialized but may come from any worker thread; an
+  // exception marks the spot as failed.
+  using SolvedCallback = std::function<void(size_t spot_index, PCfrSolver& solver)>;
+
+  // Throws:
+  //   std::invalid_argument if compairer is null.
+  explicit BatchSolver(std::shared_ptr<core::Compairer> compairer, Options options = Options());
+
+  // Solves every spot and returns their results in input order. Errors in a
+  // spot are recorded in its result and do not stop the batch.
+  std::vector<BatchSpotResult> Solve(const std::vector<BatchSpot>& spots,
+                                     const SolvedCallback& on_solved = nullptr);
+
+ private:
+  std::shared_ptr<core::Compairer> compairer_;
+  Options options_;
+};
+
+} // namespace solver
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_SOLVER_BATCH_SOLVER_H_
@@ -0,0 +1,32 @@
+#ifndef POKER_SOLVER_SOLVER_BUILD_INFO_H_
+#define POKER_SOLVER_SOLVER_BUILD_INFO_H_
+
+#include <string>
+
+namespace poker_solver {
+namespace solver {
+
+// How PokerSolverCore was built, from the CMake configuration (see
+// POKER_SOLVER_ARCH and POKER_SOLVER_LTO in CMakeLists.txt). Builds
+// outside CMake report "unknown", no -march and no LTO.
+
+// CMake configuration, e.g. "Release" or "Debug".
+const char* BuildType();
+
+// The -march value, or "" for the compiler's default target.
+const char* TargetArch();
+
+// Whether the library was linked with link-time optimization.
+bool LinkTimeOptimized();
+
+// Whether AddressSanitizer is compiled in.
+bool AddressSanitized();
+
+// One line for logs and reports, e.g.
+// "Release, LTO, -march=native, kernels avx2".
+std::string BuildSummary();
+
+} // namespace solver
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_SOLVER_BUILD_INFO_H_
@@ -0,0 +1,66 @@
+#ifndef POKER_SOLVER_SOLVER_EQUITY_CALCULATOR_H_
+#define POKER_SOLVER_SOLVER_EQUITY_CALCULATOR_H_
+
+#include "compairer/Compairer.h" // For Compairer
+#include "ranges/PrivateCards.h" // For PrivateCards
+#include "Card.h"                // For kNumCardsInDeck
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace poker_solver {
+namespace solver {
+
+// Result of an exact range-vs-range equity enumeration.
+struct EquityResult {
+  // equities[i]: showdown equity (ties count half) of hero_range[i] against
+  // the villain range, over all runouts. 0 for hands blocked by the board or
+  // facing no compatible villain hand.
+  std::vector<double> equities;
+  // matchup_weights[i]: villain weight compatible with hero_range[i],
+  // averaged over the runouts. Weighs hand equities into range equities.
+  std::vector<double> matchup_weights;
+  // Equity of the whole hero range, weighted by hero weight times matchup weight.
+  double range_equity = 0.0;
+  // Number of river boards enumerated.
+  size_t num_runouts = 0;
+};
+
+// Computes exact per-combo equities of one range against another on a flop,
+// turn or river, without running the solver. Every runout is enumerated:
+// the river combos of both ranges are built in parallel through a
+// RiverRangeManager preload, then each board is evaluated with the O(n)
+// sorted showdown sweep, also in parallel across boards. Flop range vs
+// range takes well under a second, so it is usable interactively.
+class EquityCalculator {
+ public:
+  // Constructor.
+  // Args:
+  //   compairer: Hand evaluator used for showdowns (e.g. Dic5Compairer).
+  // Throws:
+  //   std::invalid_argument if compairer is null.
+  explicit EquityCalculator(std::shared_ptr<core::Compairer> compairer);
+
+  // Args:
+  //   hero_range / villain_range: Weighted hands of each side. Hands may
+  //                               overlap the board; they are skipped.
+  //   board: 3 to 5 distinct card integers.
+  //   deck_mask: Cards the runouts are dealt from (e.g. Deck::GetCardsMask()
+  //              for short deck).
+  // Returns:
+  //   Per-hand equities indexed like hero_range.
+  // Throws:
+  //   std::invalid_argument if the board is not 3-5 distinct valid cards.
+  EquityResult Compute(const std::vector<core::PrivateCards>& hero_range,
+                       const std::vector<core::PrivateCards>& villain_range,
+                       const std::vector<int>& board,
+                       uint64_t deck_mask = (1ULL << core::kNumCardsInDeck) - 1) const;
+
+ private:
+  std::shared_ptr<core::Compairer> compairer_;
+};
+
+} // namespace solver
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_SOLVER_EQUITY_CALCULATOR_H_
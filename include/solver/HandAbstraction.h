@@ -0,0 +1,78 @@
+#ifndef POKER_SOLVER_SOLVER_HAND_ABSTRACTION_H_
+#define POKER_SOLVER_SOLVER_HAND_ABSTRACTION_H_
+
+#include "ranges/PrivateCards.h" // For PrivateCards
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace poker_solver {
+namespace ranges { class RiverRangeManager; }
+
+namespace solver {
+
+// A partition of one player's range on one board.
+struct HandBuckets {
+  size_t num_buckets = 0;
+  std::vector<uint32_t> bucket_of_hand; // Per hand of the range, in [0, num_buckets)
+};
+
+// Card abstraction for preview solves of large trees: groups a player's
+// hands on a flop or turn board into buckets whose hands have similar
+// equity distributions, so PCfrSolver can keep one regret row per bucket
+// on those streets (BucketedDiscountedCfrTrainable, Config::
+// abstraction_buckets). River boards are never bucketed.
+//
+// A hand's feature is its histogram of equity against the opponent's range
+// (by its initial weights) over the next card: on the turn, its equity on
+// each river; on the flop, its mean equity over the rivers after each turn
+// card. Hands are clustered by k-means on the cumulative histograms (the
+// squared distance between them approximates the earth mover's distance),
+// seeded at the quantiles of mean equity, so buckets are deterministic.
+// Hands the board blocks share bucket 0. Empty clusters are dropped, and
+// buckets are numbered by ascending mean equity.
+class HandAbstraction {
+ public:
+  // 'river_ranges' ranks the hands on each river board; pass the solver's
+  // own manager, which caches combos by player. 'deck_mask' holds the cards
+  // in play.
+  // Throws:
+  //   std::invalid_argument if river_ranges is null or num_buckets is 0.
+  HandAbstraction(std::shared_ptr<ranges::RiverRangeManager> river_ranges, uint64_t deck_mask, size_t num_buckets);
+
+  size_t NumBuckets() const { return num_buckets_; }
+
+  // Buckets of 'player''s range on 'board_mask', computed on the first
+  // request for the player and board and shared afterwards. Safe to call
+  // from any thread; computations run one at a time.
+  // Throws:
+  //   std::invalid_argument if the board does not have 3 or 4 cards.
+  std::shared_ptr<const HandBuckets> BucketsFor(size_t player,
+                                                const std::vector<core::PrivateCards>& player_range,
+                                                const std::vector<core::PrivateCards>& opponent_range,
+                                                uint64_t board_mask);
+
+ private:
+  // Equity histograms: kEquityBins cumulative values per hand, row-major;
+  // 'mean_equity' gets each hand's mean and 'valid' whether any runout
+  // avoids its cards.
+  std::vector<double> EquityFeatures(size_t player, const std::vector<core::PrivateCards>& player_range,
+                                     const std::vector<core::PrivateCards>& opponent_range, uint64_t board_mask,
+                                     std::vector<double>& mean_equity, std::vector<char>& valid) const;
+
+  std::shared_ptr<ranges::RiverRangeManager> river_ranges_;
+  uint64_t deck_mask_;
+  size_t num_buckets_;
+  std::mutex mutex_;
+  std::map<std::pair<size_t, uint64_t>, std::shared_ptr<const HandBuckets>> buckets_; // By player and board
+};
+
+} // namespace solver
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_SOLVER_HAND_ABSTRACTION_H_
@@ -0,0 +1,74 @@
+#ifndef POKER_SOLVER_SOLVER_HAND_GRID_H_
+#define POKER_SOLVER_SOLVER_HAND_GRID_H_
+
+#include "ranges/PrivateCards.h" // For PrivateCards
+#include "Card.h"                // For kNumRanks
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace poker_solver {
+namespace solver {
+
+class StrategyFile;
+
+// Cells of the 13x13 hand matrix.
+constexpr size_t kHandGridCells = core::kNumRanks * core::kNumRanks;
+
+// Cell of a hand in the 13x13 matrix, row * 13 + column with aces first:
+// pairs on the diagonal, suited hands above it and offsuit ones below.
+size_t HandGridCell(int card1, int card2);
+
+// One action node's strategy summed into the 13x13 matrix, each cell
+// averaging its hands by their reach.
+struct HandGrid {
+  size_t num_actions = 0;
+  bool has_evs = false;
+  // Per cell: hands with positive reach, and their summed reach (combos).
+  std::vector<size_t> num_hands;
+  std::vector<double> reach;
+  // Per cell and action, cell-major (value[cell * num_actions + a]): the
+  // reach-weighted mean strategy and EV; 0 in cells without reach. 'evs'
+  // is empty without EVs.
+  std::vector<double> strategy;
+  std::vector<double> evs;
+  // Per action, the reach-weighted combos taking it over the whole range.
+  std::vector<double> action_combos;
+};
+
+// Aggregates hand-major values (num_actions per hand of 'hands') with the
+// hands' 'reach'; 'evs' may be empty. Cells are summed in parallel for
+// large ranges, each in hand order, so results do not depend on the thread
+// count.
+// Throws:
+//   std::invalid_argument if num_actions is 0 or a vector's size does not
+//   match the hands.
+HandGrid AggregateHandGrid(const std::vector<core::PrivateCards>& hands, const std::vector<double>& reach,
+                           const std::vector<double>& strategy, const std::vector<double>& evs, size_t num_actions);
+
+// The HandGrids of a strategy file's nodes, each built on first request
+// and kept. Files hold no reaches, so every hand counts one combo except
+// those holding a card dealt on the node's path, which are out of play.
+// Thread-safe.
+class HandGridCache {
+ public:
+  // Throws:
+  //   std::invalid_argument if file is null.
+  explicit HandGridCache(std::shared_ptr<const StrategyFile> file);
+
+  // Throws:
+  //   std::out_of_range for a node the file does not have.
+  std::shared_ptr<const HandGrid> Get(size_t node);
+
+ private:
+  std::shared_ptr<const StrategyFile> file_;
+  std::mutex mutex_;
+  std::map<size_t, std::shared_ptr<const HandGrid>> grids_;
+};
+
+} // namespace solver
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_SOLVER_HAND_GRID_H_
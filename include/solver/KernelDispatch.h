@@ -0,0 +1,21 @@
+#ifndef POKER_SOLVER_SOLVER_KERNEL_DISPATCH_H_
+#define POKER_SOLVER_SOLVER_KERNEL_DISPATCH_H_
+
+// Function multi-versioning for the SIMD-friendly loops: marking a
+// definition POKER_SOLVER_KERNEL compiles it for AVX-512F, AVX2 and the
+// build's baseline (-march, see POKER_SOLVER_ARCH), and the dynamic loader
+// resolves it to the best clone for the running CPU. This needs ifunc
+// support (ELF/glibc on x86-64) and does not mix with AddressSanitizer;
+// elsewhere the macro is empty and only the baseline build exists.
+// Kernels must not throw: GCC treats the dispatcher as nothrow, so
+// validate arguments in an unversioned caller.
+#if defined(__x86_64__) && defined(__linux__) && (defined(__GNUC__) || defined(__clang__)) && \
+    !defined(__SANITIZE_ADDRESS__)
+#define POKER_SOLVER_KERNEL_DISPATCH 1
+#define POKER_SOLVER_KERNEL __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define POKER_SOLVER_KERNEL_DISPATCH 0
+#define POKER_SOLVER_KERNEL
+#endif
+
+#endif // POKER_SOLVER_SOLVER_KERNEL_DISPATCH_H_
@@ -0,0 +1,86 @@
+#ifndef POKER_SOLVER_SOLVER_LEAF_VALUE_ESTIMATOR_H_
+#define POKER_SOLVER_SOLVER_LEAF_VALUE_ESTIMATOR_H_
+
+#include "nodes/GameTreeNode.h"  // For GameRound
+#include "ranges/PrivateCards.h" // For PrivateCards
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace poker_solver {
+namespace ranges { class RiverRangeManager; }
+
+namespace solver {
+
+// Values of the leaves of a depth-limited tree (config::Rule::IsDepthLimited):
+// the chance nodes where the next street's betting was cut off. PCfrSolver
+// asks for them in place of traversing that street, one player at a time,
+// so an estimator stands for the play of both players from the leaf on,
+// e.g. check-down equity, the values of a cached solve of the street below,
+// or the best of several continuation strategies.
+class LeafValueEstimator {
+ public:
+  struct Leaf {
+    // Actions from the root, '/'-separated as in strategy files; the same
+    // for every visit of this leaf.
+    std::string_view path;
+    core::GameRound round = core::GameRound::kTurn; // Street the cut chance node deals
+    uint64_t board_mask = 0; // Board before that deal
+    uint64_t deck_mask = 0;  // Cards of the deck in play (board cards included)
+    double pot = 0.0;        // Each player has put in pot / 2
+    size_t player = 0;       // Whose values to fill
+    const std::vector<core::PrivateCards>* player_range = nullptr;   // Solver range order
+    const std::vector<core::PrivateCards>* opponent_range = nullptr; // Solver range order
+    const double* opponent_reach = nullptr; // Per opponent_range hand
+    // player_range->size() values to overwrite: for each hand h, the sum
+    // over opponent hands o that share no card with h or the board of
+    // opponent_reach[o] times h's net winnings against o (a showdown won
+    // at the leaf pays +pot / 2, one lost -pot / 2). This is the form of a
+    // showdown's utility; the solver applies the chance reach.
+    double* values = nullptr;
+  };
+
+  virtual ~LeafValueEstimator() = default;
+
+  // Short name for logs, e.g. "check-down".
+  virtual const char* Name() const = 0;
+
+  // Fills leaf.values. Called from all solver threads at once.
+  virtual void EstimateLeafValues(const Leaf& leaf) = 0;
+};
+
+// PCfrSolver's default: a leaf is worth its showdown after both players
+// check down, each pair of hands averaged over the runouts to the river
+// that neither holds a card of, as the solver's chance nodes weight them
+// (so on trees whose later streets can only check, it is exact). Ignores
+// the betting left in the cut streets, so it undervalues hands that would
+// bet or fold out better ones, but it needs no other solve. Outside a
+// parallel region (no solver fan-out above a one-street tree) the runouts
+// are split over the OpenMP threads, in fixed chunks summed in order, so
+// the values do not depend on the thread count.
+class CheckDownLeafEstimator final : public LeafValueEstimator {
+ public:
+  // 'river_ranges' ranks the hands on each river board. It caches combos
+  // by player, so pass the solver's own manager (or one that only ever
+  // sees the solver's ranges).
+  // Throws:
+  //   std::invalid_argument if river_ranges is null.
+  explicit CheckDownLeafEstimator(std::shared_ptr<ranges::RiverRangeManager> river_ranges);
+
+  const char* Name() const override { return "check-down"; }
+
+  // Throws:
+  //   std::invalid_argument if the leaf's board has fewer than three cards.
+  void EstimateLeafValues(const Leaf& leaf) override;
+
+ private:
+  std::shared_ptr<ranges::RiverRangeManager> river_ranges_;
+};
+
+} // namespace solver
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_SOLVER_LEAF_VALUE_ESTIMATOR_H_
@@ -0,0 +1,145 @@
+#ifndef POKER_SOLVER_SOLVER_MULTI_BOARD_RIVER_SOLVER_H_
+#define POKER_SOLVER_SOLVER_MULTI_BOARD_RIVER_SOLVER_H_
+
+#include "FlatGameTree.h"               // For FlatGameTree
+#include "GameTree.h"                   // For GameTree
+#include "ranges/PrivateCards.h"        // For PrivateCards
+#include "ranges/RiverRangeManager.h"   // For RiverRangeManager
+#include "solver/ShowdownBackend.h"     // For ShowdownBackend
+#include "trainable/DcfrDiscounts.h"    // For DcfrParameters
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <json.hpp>
+
+namespace poker_solver {
+namespace solver {
+
+// Solves one river action tree on many boards at once, e.g. a bet-size
+// study across every river of a turn. Equivalent to one default
+// PCfrSolver (double-precision Discounted CFR, alternating updates) per
+// board, but the boards advance in lockstep through a single traversal:
+// each action node keeps its regrets and strategy sums as
+// [action][board][hand] over the players' whole ranges, so every reach,
+// utility and regret loop runs over all boards' hands as one contiguous
+// vector, and the tree is walked once per iteration instead of once per
+// board. Hands a board blocks keep zero reach there. Showdowns reach the
+// ShowdownBackend as one batch of boards.
+class MultiBoardRiverSolver {
+ public:
+  struct Config {
+    int iteration_limit;
+    // Threads for the per-board showdown and fold kernels; the traversal
+    // itself is one pass.
+    int num_threads;
+    DcfrParameters dcfr;
+    Config() : iteration_limit(1000), num_threads(1), dcfr() {}
+  };
+
+  // 'game_tree' is a river tree (built from a Rule starting on the river);
+  // only its actions and payoffs are used, so any of the boards may have
+  // built it. 'ranges' are both players' ranges before board removal, and
+  // every board is a mask of five cards. 'rrm' caches combos of 'ranges';
+  // do not share it with solvers of other ranges.
+  // Throws:
+  //   std::invalid_argument if the tree is empty, has chance nodes or does
+  //   not start on the river, a board does not have five cards, there are
+  //   no boards, rrm is null, or a player has no hand on some board.
+  MultiBoardRiverSolver(std::shared_ptr<tree::GameTree> game_tree,
+                        std::array<std::vector<core::PrivateCards>, 2> ranges,
+                        std::vector<uint64_t> board_masks,
+                        std::shared_ptr<ranges::RiverRangeManager> rrm,
+                        Config config = Config());
+
+  // Runs the iterations left up to Config::iteration_limit.
+  void Train();
+  int GetCompletedIterations() const { return completed_iterations_; }
+
+  // Evaluates every showdown through 'backend' (null: CpuShowdownBackend).
+  void SetShowdownBackend(std::shared_ptr<ShowdownBackend> backend);
+
+  size_t NumBoards() const { return boards_.size(); }
+  uint64_t BoardMask(size_t board) const { return boards_.at(board); }
+  // The hands the strategies cover: the player's range minus zero-weight
+  // hands, on every board.
+  const std::vector<core::PrivateCards>& GetPlayerRange(size_t player) const { return ranges_.at(player); }
+
+  // Average strategy of the action node at 'path' (action strings as
+  // PCfrSolver::DumpStrategy keys children, e.g. {"BET 25", "CALL"}) on
+  // 'board': hand-major over the acting player's GetPlayerRange. Hands the
+  // board blocks, and hands that never got there, play uniformly.
+  // Throws:
+  //   std::invalid_argument if the path does not lead to an action node.
+  //   std::out_of_range if 'board' is out of range.
+  std::vector<double> GetAverageStrategy(const std::vector<std::string>& path, size_t board) const;
+
+  // The document PCfrSolver::DumpStrategy(false) would give for a solve of
+  // 'board' alone: action nodes' "strategy_data" maps each hand the board
+  // does not block to its average strategy.
+  // Throws:
+  //   std::out_of_range if 'board' is out of range.
+  nlohmann::json DumpStrategy(size_t board) const;
+
+ private:
+  // Regrets, strategy sums and the current (regret-matched) strategy of
+  // one action node, [action][board][hand].
+  struct NodeTables {
+    std::vector<double> regrets;
+    std::vector<double> strategy_sums;
+    std::vector<double> current;
+  };
+
+  // Buffers of one tree depth; children only touch deeper ones.
+  struct Level {
+    std::vector<double> regret_sum;                    // [board][hand]
+    std::vector<double> reach;                         // [action][board][hand] of the acting player
+    std::vector<double> reach_sums;                    // [action][board]
+    std::vector<double> child_utility;                 // [action][board][hand] of the traverser
+    std::vector<double*> batch_utility;                // Per board, its row of the utility
+  };
+
+  using Rows = std::array<const double*, 2>; // Per player, [board][hand]
+
+  // Writes the traverser's utility, [board][hand], and updates its regrets.
+  void Traverse(uint32_t node_index, const Rows& reach, const Rows& reach_sums, size_t traverser,
+                double* utility, const IterationDiscounts& discounts, size_t depth);
+  void TraverseAction(const tree::FlatNode& node, const Rows& reach, const Rows& reach_sums, size_t traverser,
+                      double* utility, const IterationDiscounts& discounts, size_t depth);
+  void EvaluateFold(const tree::FlatNode& node, const Rows& reach, const Rows& reach_sums, size_t traverser,
+                    double* utility);
+  void EvaluateShowdown(const tree::FlatNode& node, const Rows& reach, const Rows& reach_sums, size_t traverser,
+                        double* utility, size_t depth);
+
+  // Average strategy of action node 'node' on 'board', hand-major.
+  std::vector<double> AverageStrategy(const tree::FlatNode& node, size_t board) const;
+  // Flat index of the action node at 'path'.
+  uint32_t FindNode(const std::vector<std::string>& path) const;
+  nlohmann::json DumpNode(uint32_t node_index, size_t board, int depth) const;
+
+  std::shared_ptr<tree::GameTree> game_tree_;
+  std::unique_ptr<tree::FlatGameTree> flat_tree_;
+  std::array<std::vector<core::PrivateCards>, 2> ranges_;
+  std::vector<uint64_t> boards_;
+  std::shared_ptr<ranges::RiverRangeManager> rrm_;
+  std::shared_ptr<ShowdownBackend> showdown_backend_;
+  Config config_;
+  std::array<size_t, 2> num_hands_ = {0, 0};
+  // Root reach, [board][hand]: PrivateCardsManager's initial reach on each
+  // board, zero for the hands it blocks.
+  std::array<std::vector<double>, 2> root_reach_;
+  std::array<std::vector<double>, 2> root_reach_sums_; // [board]
+  // Each player's showdown combos per board, fetched by the first Train().
+  std::array<std::vector<std::shared_ptr<const ranges::PackedRiverCombos>>, 2> combos_;
+  std::array<std::vector<const ranges::PackedRiverCombos*>, 2> combo_ptrs_; // Same, for batches
+  std::vector<NodeTables> tables_; // By FlatNode::payload of action nodes
+  std::vector<Level> levels_;      // By depth
+  int completed_iterations_ = 0;
+};
+
+} // namespace solver
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_SOLVER_MULTI_BOARD_RIVER_SOLVER_H_
@@ -0,0 +1,64 @@
+#ifndef POKER_SOLVER_SOLVER_NUMA_TOPOLOGY_H_
+#define POKER_SOLVER_SOLVER_NUMA_TOPOLOGY_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace poker_solver {
+namespace solver {
+
+// The CPUs of each NUMA node the process may run on, and the mapping of
+// a thread team onto them used by PCfrSolver::Config::numa_aware: a team
+// is cut into one contiguous block of threads per node, in node order.
+class NumaTopology {
+ public:
+  // An empty topology (no nodes); see Detect.
+  NumaTopology() = default;
+  // Throws:
+  //   std::invalid_argument if a node has no CPUs.
+  explicit NumaTopology(std::vector<std::vector<int>> node_cpus);
+
+  // Reads /sys/devices/system/node on Linux, keeping the CPUs the process
+  // may use and the nodes left with any. Elsewhere, or if that fails, one
+  // node holding every allowed CPU.
+  static NumaTopology Detect();
+
+  size_t NumNodes() const { return node_cpus_.size(); }
+  bool empty() const { return node_cpus_.empty(); }
+  const std::vector<int>& Cpus(size_t node) const { return node_cpus_.at(node); }
+
+  // Node of thread 'thread' (0-based) of a team of 'team_size' threads.
+  size_t NodeOfThread(int thread, int team_size) const;
+
+  // Restricts the calling thread to the CPUs of 'node'. Returns false if
+  // the platform cannot pin threads or the OS refused.
+  bool PinCurrentThread(size_t node) const;
+
+ private:
+  std::vector<std::vector<int>> node_cpus_;
+};
+
+// Restores the calling thread's CPU affinity, as of construction, on
+// destruction. Does nothing where threads cannot be pinned.
+class ScopedThreadAffinity {
+ public:
+  ScopedThreadAffinity();
+  ~ScopedThreadAffinity();
+
+  ScopedThreadAffinity(const ScopedThreadAffinity&) = delete;
+  ScopedThreadAffinity& operator=(const ScopedThreadAffinity&) = delete;
+
+ private:
+  std::vector<int> cpus_; // Empty if it could not be read
+};
+
+// Parses a kernel CPU list such as "0-3,8,10-11".
+// Throws:
+//   std::invalid_argument if it is malformed.
+std::vector<int> ParseCpuList(const std::string& list);
+
+} // namespace solver
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_SOLVER_NUMA_TOPOLOGY_H_
@@ -3,6 +3,7 @@
 
 #include "solver/Solver.h"          // Base class
 #include "GameTree.h"               // For tree structure (ensure correct path)
+#include "FlatGameTree.h"           // For the traversal's node array
 #include "nodes/GameTreeNode.h"     // Node types and enums
 #include "ranges/PrivateCardsManager.h" // Range management
 #include "ranges/RiverRangeManager.h"   // River evaluation management
@@ -10,11 +11,33 @@
 #include "Deck.h"                   // For deck info
 #include "Card.h"                   // For Card utilities
 #include "tools/Rule.h"             // For initial game state config
+#include "nodes/ActionNode.h"       // For ActionNode::TrainablePrecision
+#include "solver/TraversalScratch.h" // For ReachPointers
+#include "solver/StrategyFile.h"   // For StrategyValueType
+#include "solver/SolverProgress.h" // For SolverProgressQueue
+#include "solver/StrategySnapshot.h" // For StrategySnapshot
+#include "solver/SolverTransport.h" // For SolverTransport
+#include "solver/TraceRecorder.h" // For TraceRecorder
+#include "solver/NumaTopology.h" // For NumaTopology
+#include "solver/ShowdownBackend.h" // For ShowdownBackend
+#include "solver/LeafValueEstimator.h" // For LeafValueEstimator
+#include "solver/HandAbstraction.h" // For HandAbstraction
+#include "solver/HandGrid.h" // For HandGrid
+#include "solver/TraversalStats.h" // For TraversalStats
+#include "trainable/DcfrDiscounts.h" // For DcfrParameters
+#include "trainable/TrainableArena.h" // For TrainableArena
+#include "tools/FlatHashMap.h" // For the chance deal table
 
+#include <array>
+#include <map>
 #include <vector>
 #include <memory>
 #include <string>
 #include <atomic> // For stopping flag
+#include <functional> // For ForEachActionNode
+#include <thread>     // For the checkpoint writer
+#include <mutex>      // For the snapshot request
+#include <ostream>    // For DumpStrategyTo
 #include <json.hpp> // Include actual json header
 
 // Use alias defined in json.hpp
@@ -33,84 +56,949 @@ namespace solver {
 // Concrete implementation of Solver using Discounted CFR.
 class PCfrSolver : public Solver {
 public:
+    // Kernel used to evaluate fold (terminal) nodes.
+    enum class FoldEvaluator {
+        kLinear,  // O(n) per-card inclusion-exclusion (default)
+        kPairwise // O(n^2) reference, kept for validation/benchmarks
+    };
+
+    // Which part of the traversal runs on several threads. Each mode gives
+    // the same results, bit for bit, for any thread count: work is split
+    // into rows or subtrees that are summed in a fixed order afterwards.
+    enum class ParallelLevel {
+        kOutermostChance, // Outcomes of the first turn/river chance node on each path (default)
+        kNone,            // Everything on the calling thread
+        kTasks            // Subtrees above Config::task_cutoff become OpenMP tasks
+    };
+
+    // How the players' updates are ordered within an iteration.
+    enum class UpdateScheme {
+        kAlternating, // One traversal per player; player 1 sees player 0's update (default)
+        kSimultaneous // One traversal computes and updates both players
+    };
+
+    // Regret minimizer run at every action node.
+    enum class Trainer {
+        kDiscounted, // Discounted CFR with Config::dcfr exponents (default)
+        kLinear,     // Linear CFR: Discounted CFR with all exponents 1
+        kCfrPlus     // CFR+ with linear averaging, float storage
+    };
+
     // Configuration for the solver
     struct Config {
-        int iteration_limit; // Remove default initializer
+        int iteration_limit; // Total, counting iterations restored by LoadCheckpoint
         int num_threads;     // Remove default initializer
+        FoldEvaluator fold_evaluator;
+        // Storage precision of regret/strategy tables. kSingle and kHalf cut
+        // trainable memory to roughly 1/4 and 1/8 of the double default.
+        nodes::ActionNode::TrainablePrecision precision;
 
-        // bool use_isomorphism = false; // Future option
-        // Add trainer type enum if needed (e.g., CFR+, DCFR)
-        // Add precision enum if needed
+        // Solve only one representative of suit-isomorphic turn/river cards
+        // and map its utilities onto the others. Requires a suit-blind
+        // evaluator; suits are only merged when the board and both ranges are
+        // symmetric under the swap.
+        bool use_isomorphism;
+        // Exactly one level fans out, so threads never nest. Chance nodes
+        // below it, and the showdown/fold kernels, run on the worker that
+        // reached them. Multi-card flop deals stay serial because their
+        // children share trainables.
+        ParallelLevel parallel_level;
+        // kTasks only: minimum estimated node visits below a child (action
+        // children, turn/river outcomes) for it to be spawned as a task.
+        // Smaller subtrees run inline on the spawning thread, so tiny all-in
+        // branches do not pay task overhead.
+        double task_cutoff;
+        // kOutermostChance only: minimum estimated work of a chance node,
+        // node visits below it times the hands of both players, for its
+        // outcomes (or a flop all-in's runout boards) to be split over the
+        // threads. Smaller nodes, and so every chance node below them, run
+        // on the thread that reached them, where a parallel region would
+        // cost more than it saves. 0 tunes it over the first iterations
+        // from the timed cost of a region and of a unit of work (see
+        // GetParallelCutoff). Results do not depend on it.
+        double parallel_cutoff;
+        // Simultaneous updates visit every node and showdown once per
+        // iteration instead of twice, at the cost of somewhat slower
+        // convergence per iteration.
+        UpdateScheme update_scheme;
+        // Compute exploitability every this many iterations (and after the
+        // last one); 0 disables it. Each check costs about one iteration.
+        int exploitability_interval;
+        // Stop once a check finds exploitability at or below this percentage
+        // of the starting pot; 0 disables early stopping.
+        double target_exploitability;
+        // Regret-based pruning: in a player's own traversal, actions that no
+        // hand currently plays (all of their cumulative regrets are <= 0) are
+        // not traversed. Their regrets are frozen instead of updated, so the
+        // first pruning_warmup_iterations and every
+        // pruning_full_pass_interval-th iteration (0: never) traverse
+        // everything again. Only used with UpdateScheme::kAlternating.
+        bool regret_pruning;
+        int pruning_warmup_iterations;
+        int pruning_full_pass_interval;
+        Trainer trainer;
+        // Discounted CFR exponents (Trainer::kDiscounted only). Turned into
+        // per-iteration factors once at the start of each iteration.
+        DcfrParameters dcfr;
+        // Average strategy schedule. The first average_warmup_iterations
+        // iterations, which Discounted CFR's t^gamma weights make
+        // negligible anyway, are left out of the average strategy, and
+        // after them it is accumulated only every average_interval-th
+        // iteration (and on the last one and every exploitability check),
+        // weighted by the sum of the strategy weights of the iterations
+        // since the previous accumulation, so every later iteration keeps
+        // its share. Skipped iterations do not touch the strategy sums, and
+        // double-precision Discounted/Linear CFR tables only allocate them
+        // at their node's first accumulation. Until then the average
+        // strategy is uniform. A solve ended by Stop() keeps only the
+        // iterations up to the last accumulation, up to
+        // average_interval - 1 fewer than it ran. 0 and 1 (the defaults)
+        // accumulate every iteration.
+        int average_warmup_iterations;
+        int average_interval;
+        // Back the trainable arena (double-precision Discounted/Linear CFR
+        // tables) with transparent huge pages where the OS supports them.
+        bool huge_pages;
+        // Double-precision Discounted/Linear CFR only: derive current and
+        // average strategies on demand instead of keeping them per trainable,
+        // halving the resident strategy footprint. Results are unchanged;
+        // each visit re-runs regret matching.
+        bool lazy_strategies;
+        // Out-of-core solving: when set, the trainable arena tables
+        // (double-precision Discounted/Linear CFR) of action nodes on
+        // trainable_file_round and later streets live in unlinked files in
+        // this directory, one per street, instead of in RAM. Their disk
+        // space is allocated as they grow, so a full disk makes Train()
+        // throw std::runtime_error rather than crash the process. The
+        // kernel pages them in and writes them back as the traversal
+        // moves, so a solve may exceed physical memory; it is as fast as
+        // the disk (use NVMe). Earlier streets, far smaller and visited
+        // far more often per byte, stay resident. River files are advised
+        // for sequential access, since every traversal walks river tables
+        // in the order they were created. See
+        // GameTree::EstimateTrainableMemorySplit.
+        std::string trainable_file_directory;
+        core::GameRound trainable_file_round;
+        // Before the first iteration, precompute the showdown combos of every
+        // river board the tree reaches, with a parallel loop, into the
+        // RiverRangeManager's lock-free preloaded index. Removes the lazy,
+        // mutex-guarded evaluation from the first iterations. Skipped when
+        // the manager has a memory budget.
+        bool warmup_river_cache;
+        // Log GetMemoryStats every this many iterations (and after the
+        // last one); 0 disables it.
+        int memory_log_interval;
+        // NUMA mode, for ParallelLevel::kOutermostChance on multi-socket
+        // machines. The dealt cards are split into one contiguous block
+        // per node, and each OpenMP thread is pinned to a node (the team is
+        // split the same way). At the fan-out, a node's threads share only
+        // the outcomes dealing its cards. Those subtrees' trainables come
+        // from the node's own arena lane, and the river cache warmup
+        // computes each board on the node that deals its first card. So the
+        // regrets a thread updates were first written, and placed, on its
+        // own node. Worker threads stay pinned after training. Nothing
+        // changes on a single node.
+        bool numa_aware;
+        // Nodes used in NUMA mode; empty (the default) detects them.
+        NumaTopology numa_topology;
+        // Public chance sampling, for quick approximate solves: when
+        // positive, each training traversal evaluates only this many of a
+        // turn or river chance node's outcomes, drawn uniformly without
+        // replacement, and weighs them by outcomes / drawn so the chance
+        // node's utility stays an unbiased estimate. Trainables below the
+        // outcomes left out are not updated (nor discounted) that
+        // traversal. Exploitability checks and subgame extraction still
+        // enumerate every outcome. 0 (the default) enumerates during
+        // training too. Not supported with use_isomorphism.
+        int sampled_chance_outcomes;
+        // Seeds the draws. They depend only on the seed, the traversal and
+        // the board, so any thread count (or rank) samples alike.
+        uint64_t sampling_seed;
+        // Sparse trainables, for deep trees where few hands reach most
+        // nodes: when positive, the iteration after this many replaces each
+        // double-precision Discounted/Linear CFR trainable it updates by a
+        // SparseDiscountedCfrTrainable if the node's live hands make up at
+        // most sparse_trainable_max_support of the range. A hand is live if
+        // it reaches the node on that visit, or if its strategy sums hold at
+        // least sparse_trainable_min_relative_reach of the largest hand's
+        // (its weight in the average strategy). The others' regrets are
+        // dropped and they play uniformly until they reach the node again.
+        // Trainables then do not come from the arena, so replaced ones free
+        // their tables; not supported with trainable_file_directory. 0 (the
+        // default) keeps every trainable dense.
+        int sparse_trainable_warmup;
+        double sparse_trainable_max_support;
+        double sparse_trainable_min_relative_reach;
+        // Card abstraction, for quick preview solves of large flop or turn
+        // trees: when positive, each flop and turn action node keeps one row
+        // of regrets per bucket of at most this many hands of similar
+        // equity distribution on its board (HandAbstraction), in a
+        // BucketedDiscountedCfrTrainable, instead of one per hand. River
+        // nodes stay exact. The buckets of a board are computed when its
+        // first trainable is created. Needs double-precision
+        // Discounted/Linear CFR tables in memory, no sparse trainables and
+        // a flop or turn initial board. 0 (the default) disables it.
+        int abstraction_buckets;
+        // Background checkpoints: every checkpoint_interval iterations (and
+        // after the last one), Train() copies the trainables' state in
+        // SaveCheckpoint's format into a staging buffer and carries on while
+        // a background thread writes it to checkpoint_path, through a
+        // temporary file renamed over it, so the path always holds a
+        // complete checkpoint. Training only waits for a write still running
+        // at the next checkpoint, and for the last one before Train()
+        // returns. The buffer stays allocated between checkpoints, as large
+        // as the file. 0 (the default) disables them.
+        std::string checkpoint_path;
+        int checkpoint_interval;
+        // Compressed checkpoints (SaveCheckpoint and background ones): each
+        // deal slot becomes a chunk of its own, LZ-compressed, with each
+        // hand's regrets stored as 16-bit levels of its largest regret and
+        // its strategy sums as 8-bit levels of its largest sum. A resumed
+        // solve's regrets move by at most 1/32768 of a hand's largest, and
+        // its sums, which only feed the average strategy, by at most 1/128.
+        // Encoding and decoding run on the solver's threads. LoadCheckpoint
+        // reads either format.
+        bool compressed_checkpoints;
+        // Iterations between live strategy snapshots, once a subtree is
+        // requested with SetSnapshotSubtree; 0 disables them.
+        int snapshot_interval;
         Config() :
             iteration_limit(1000),
-            num_threads(1)
+            num_threads(1),
+            fold_evaluator(FoldEvaluator::kLinear),
+            precision(nodes::ActionNode::TrainablePrecision::kFloat),
+            use_isomorphism(false),
+            parallel_level(ParallelLevel::kOutermostChance),
+            task_cutoff(4096.0),
+            parallel_cutoff(0.0),
+            update_scheme(UpdateScheme::kAlternating),
+            exploitability_interval(0),
+            target_exploitability(0.0),
+            regret_pruning(false),
+            pruning_warmup_iterations(10),
+            pruning_full_pass_interval(10),
+            trainer(Trainer::kDiscounted),
+            dcfr(),
+            average_warmup_iterations(0),
+            average_interval(1),
+            huge_pages(false),
+            lazy_strategies(false),
+            trainable_file_round(core::GameRound::kRiver),
+            warmup_river_cache(true),
+            memory_log_interval(0),
+            numa_aware(false),
+            sampled_chance_outcomes(0),
+            sampling_seed(0x5eed),
+            sparse_trainable_warmup(0),
+            sparse_trainable_max_support(0.25),
+            sparse_trainable_min_relative_reach(1e-3),
+            abstraction_buckets(0),
+            checkpoint_interval(0),
+            compressed_checkpoints(false),
+            snapshot_interval(1)
         {}
     };
 
     // Constructor
     // Takes dependencies needed for solving. Rule provides initial state.
+    // Throws std::runtime_error if Config::trainable_file_directory is set
+    // and no file can be created there.
     PCfrSolver(std::shared_ptr<tree::GameTree> game_tree,
                std::shared_ptr<ranges::PrivateCardsManager> pcm,
                std::shared_ptr<ranges::RiverRangeManager> rrm,
                const config::Rule& rule,
                Config solver_config = Config()); // Use default config if none provided
 
+    // Waits for a background checkpoint still being written.
+    ~PCfrSolver() override;
+
     // --- Solver Interface Implementation ---
+    // Throws std::runtime_error if a background checkpoint (see
+    // Config::checkpoint_interval) fails; training stops at the next
+    // checkpoint after the failure.
     void Train() override;
+    // Thread-safe. Training stops before its next iteration; a Stop() issued
+    // before Train() starts makes it return without training. The request
+    // is cleared when Train() returns.
     void Stop() override;
     json DumpStrategy(bool dump_evs, int max_depth = -1) const override;
 
+    // Writes the document DumpStrategy(dump_evs, max_depth) returns to 'out'
+    // while walking the tree, holding one trainable's dump at a time rather
+    // than the whole tree's. Object keys may come out in another order.
+    void DumpStrategyTo(std::ostream& out, bool dump_evs, int max_depth = -1) const;
+
+    // Writes the average strategies, and EVs where set, to a strategy file
+    // (see StrategyFile.h): one entry per action node and dealt card
+    // sequence with a strategy, deals skipped by isomorphism included.
+    // Values cover the compacted ranges (PrivateCardsManager::GetPlayerRange).
+    // Throws std::runtime_error if the file cannot be written.
+    void WriteStrategyFile(const std::string& path,
+                           StrategyValueType value_type = StrategyValueType::kFloat32) const;
+
+    // Reports every iteration Train() completes to 'queue' (null: none).
+    // Train() pushes from the thread that called it and never waits on the
+    // reader; the queue may be drained from another thread while training.
+    void SetProgressQueue(std::shared_ptr<SolverProgressQueue> queue) { progress_queue_ = std::move(queue); }
+
+    // Records spans of training and dumping into 'recorder' (null: none):
+    // each iteration, exploitability check, street dealt by a chance node,
+    // chance outcome handed to a thread or task, river cache fill and
+    // strategy dump, on the thread that ran it.
+    void SetTraceRecorder(std::shared_ptr<TraceRecorder> recorder) { trace_recorder_ = std::move(recorder); }
+
+    // Evaluates every showdown through 'backend' (null: the default
+    // CpuShowdownBackend). Chance nodes that deal straight into a showdown
+    // hand it all their boards in one batch.
+    void SetShowdownBackend(std::shared_ptr<ShowdownBackend> backend);
+
+    // Values the leaves of a depth-limited tree (config::Rule::IsDepthLimited)
+    // with 'estimator' (null: the default CheckDownLeafEstimator on this
+    // solver's RiverRangeManager). Training and exploitability both use the
+    // estimates, so the latter measures play up to the leaves only.
+    void SetLeafValueEstimator(std::shared_ptr<LeafValueEstimator> estimator);
+
+    // Distributed solving (null: none). The ranks of 'transport' each run a
+    // solver on the same tree, ranges and config, and split the outcomes of
+    // the first turn/river chance node on each path (the turn cards of a
+    // flop spot) round-robin among themselves: a rank only traverses, and
+    // only allocates trainables for, its own outcomes, and the outcome
+    // utilities are summed across ranks with AllReduceSum. Everything above
+    // that level is computed identically on every rank. Train, Stop and
+    // ComputeExploitability then act on the whole group; every rank must
+    // call them together. Each rank's strategy dump covers the shared
+    // levels plus its own outcomes.
+    // Throws:
+    //   std::invalid_argument with ParallelLevel::kTasks, whose traversal
+    //   order differs between ranks.
+    void SetTransport(std::shared_ptr<SolverTransport> transport);
+
+    // --- Convergence ---
+    // Exploitability of the current average strategies, as a percentage of
+    // the starting pot: the mean gain of each player's best response against
+    // the other's average strategy. Untrained nodes count as uniform.
+    // Throws std::logic_error when the tree or ranges are unusable.
+    double ComputeExploitability();
+
+    // Result of the most recent ComputeExploitability (negative if none yet).
+    double GetLastExploitability() const { return last_exploitability_; }
+
+    // Per-player best-response values (chips per hand pair) behind it.
+    const std::array<double, 2>& GetBestResponseValues() const { return best_response_values_; }
+
+    // --- Expected Values ---
+    // Sets the EVs (Trainable::SetEv) of the trained action nodes at most
+    // 'max_depth' nodes below the root (-1: all), counted as DumpStrategy
+    // counts them: per hand and action, the chips the acting player expects
+    // from taking the action and then following both average strategies,
+    // averaged over the opponent hands that reach the node (0 where none
+    // do). One traversal per player evaluates the average strategies, in
+    // parallel like ComputeExploitability; no regrets or strategy sums
+    // change and no trainables are created. Training never computes EVs,
+    // so DumpStrategy and WriteStrategyFile only carry them after this;
+    // further training leaves them stale (see EvsCalculated).
+    // Throws std::logic_error when the tree or ranges are unusable.
+    void ComputeEvs(int max_depth = -1);
+
+    // Whether ComputeEvs ran since training or loading last changed the
+    // strategies.
+    bool EvsCalculated() const { return evs_calculated_; }
+
+    // --- Instrumentation ---
+    // Work of Train()'s traversals by node type and street (see
+    // TraversalStats): summed over every iteration so far, and of the last
+    // iteration alone. Exploitability checks are not counted. All zero
+    // unless built with POKER_SOLVER_TRAVERSAL_STATS (kTraversalStatsEnabled).
+    const TraversalStats& GetTraversalStats() const { return traversal_stats_; }
+    const TraversalStats& GetLastIterationTraversalStats() const { return last_iteration_traversal_stats_; }
+
+    // Config::parallel_cutoff in use: the configured one, or the tuned one
+    // once Train() has run the tuning iterations (0 before, and when there
+    // is a single thread or no chance node fanned out).
+    double GetParallelCutoff() const { return parallel_cutoff_; }
+
+    // --- Memory Estimation ---
+    // Bytes a solve of 'tree' needs, by use, before any solver exists.
+    struct MemoryEstimate {
+        uint64_t tree_bytes = 0;        // Tree nodes plus the solver's flattened copy
+        uint64_t trainable_bytes = 0;   // Regret/strategy tables of every reachable trainable
+        uint64_t trainable_file_bytes = 0; // Part of trainable_bytes in files (Config::trainable_file_directory)
+        uint64_t river_cache_bytes = 0; // Showdown combos of every river board, both players
+        uint64_t scratch_bytes = 0;     // Traversal buffers, one stack per thread
+        uint64_t Total() const { return tree_bytes + trainable_bytes + river_cache_bytes + scratch_bytes; }
+    };
+
+    // Estimates the memory of solving 'tree' (built from 'rule') with ranges
+    // of 'range_sizes' hands after board removal, for config's precision,
+    // trainer, lazy strategies and thread count. Trainables are exact (see
+    // TreeBuildStats::TrainableBytes; 0 for trees loaded from JSON); the
+    // river cache and scratch are upper bounds assuming an unbounded cache.
+    static MemoryEstimate EstimateMemory(const tree::GameTree& tree, const config::Rule& rule,
+                                         const std::array<size_t, 2>& range_sizes, const Config& config);
+
+    // Bytes this solver holds now, by subsystem. Unlike EstimateMemory, it
+    // counts only the trainables and river boards created so far. JSON
+    // dumps hold no memory once returned; DumpStrategyTo holds one node's.
+    struct MemoryStats {
+        uint64_t tree_bytes = 0;        // Tree nodes (as TreeBuildStats::TreeBytes), the flat copy and chance deal table
+        uint64_t trainable_bytes = 0;   // Regret/strategy tables of existing trainables (no EVs)
+        uint64_t trainable_count = 0;   // Deal slots holding a trainable, locked ones included
+        uint64_t river_cache_bytes = 0; // Lazy river cache plus preloaded index
+        uint64_t resident_bytes = 0;    // Whole process (CurrentResidentBytes), for comparison
+        uint64_t Total() const { return tree_bytes + trainable_bytes + river_cache_bytes; }
+    };
+
+    // Walks every deal slot of every action node, so it costs about as much
+    // as a strategy dump without the output. Must not run during Train(),
+    // which logs it itself with Config::memory_log_interval. The river
+    // cache may be shared with other solvers.
+    MemoryStats GetMemoryStats() const;
+
+    // --- Checkpointing ---
+    // Iterations trained so far, including any restored by LoadCheckpoint.
+    // Train() continues from here up to Config::iteration_limit.
+    int GetCompletedIterations() const { return completed_iterations_; }
+
+    // Writes every trainable's regrets and strategy sums plus the iteration
+    // count to 'path'. Layout, in host byte order: the magic "PSCKPT01",
+    // uint32 format version, uint32 kind ((abstraction_buckets << 16) |
+    // (trainer << 8) | precision), uint64 tree fingerprint, int64 completed
+    // iterations, uint64 deal slot count; then, for every action node in
+    // depth-first order and every deal slot, a uint8 presence flag followed
+    // by the trainable's raw arrays (version 1) or, with
+    // Config::compressed_checkpoints (version 2), by a uint32 decoded size,
+    // a uint32 stored size and the slot's chunk, stored as is when
+    // compression would not shrink it.
+    // Throws std::runtime_error if the file cannot be written.
+    void SaveCheckpoint(const std::string& path) const;
+
+    // Restores a checkpoint written by SaveCheckpoint for the same tree,
+    // ranges, trainer, precision and abstraction. Meant for a freshly built
+    // tree and solver; trainables present in the file replace any existing
+    // state.
+    // Throws std::runtime_error on an unreadable, truncated or mismatching
+    // file.
+    void LoadCheckpoint(const std::string& path);
+
+    // Seeds this solver's regrets from 'prior', a solve of a similar spot
+    // (e.g. built from last night's scenario and restored with
+    // LoadCheckpoint), before Train(). Both trees are walked together from
+    // the root: action nodes match when they have the same player and the
+    // same action types in order (bet amounts may differ, so changed stacks
+    // still line up), and a mismatch leaves that subtree cold. Within a
+    // matched node each deal slot is copied hand by hand, mapped by hole
+    // cards; hands missing from the prior range start from zero. Trainer and
+    // precision may differ.
+    // Strategy sums start from zero, since the prior's would anchor the
+    // average on the old spot; the iteration count continues from the
+    // prior's, as after LoadCheckpoint, so the regrets keep the discounting
+    // they were accumulated under and Config::iteration_limit counts them.
+    // Returns the number of deal slots seeded.
+    // Throws std::invalid_argument if the initial boards or decks differ.
+    size_t WarmStartFrom(const PCfrSolver& prior);
+
+    // --- Incremental Tree Edits ---
+    // Changes the bet or raise sizes of the action node at 'path' (as for
+    // LockNode) to 'amounts', between Train() calls, keeping what has been
+    // trained (see GameTree::EditBetSizes for the tree side). Nodes outside
+    // the dropped sizes' subtrees keep their trainables, and the edited node
+    // keeps the regrets and strategy sums of its remaining actions; a new
+    // size's row starts from zero. Below a new size, regrets are seeded from
+    // the subtree of the kept bet or raise closest in size wherever the
+    // actions line up, as WarmStartFrom matches nodes; strategy sums start
+    // from zero. The next Train() continues from GetCompletedIterations().
+    // A snapshot request (SetSnapshotSubtree) is dropped.
+    // Returns the number of deal slots seeded below new sizes.
+    // Throws:
+    //   std::invalid_argument for a bad path or amounts, as
+    //   GameTree::EditBetSizes.
+    //   std::logic_error for a locked node or a tree not built from a Rule.
+    size_t EditBetSizes(const std::vector<std::string>& path, std::vector<double> amounts);
+
+    // --- Subgame Re-solving ---
+    // A street start inside a solved tree, with what a re-solve of the
+    // subtree below it needs (see ResolveSubgame in solver/Subgame.h).
+    struct Subgame {
+        core::GameRound round;  // Street the subgame starts on
+        std::vector<int> board; // Initial board, then the cards dealt on the path
+        double pot = 0.0;       // Both players have committed half of it
+        // Each player's range arriving there: the hands off the board, each
+        // weighted by its initial weight times the probability that the
+        // player's average strategy takes the path's actions with it.
+        // Hands that never get there are left out.
+        std::array<std::vector<core::PrivateCards>, 2> ranges;
+        // Blueprint EV in chips of each hand in 'ranges', with both players
+        // following their average strategies below the cut (untrained nodes
+        // count as uniform). Net of the hand's own commitment, like payoffs.
+        std::array<std::vector<double>, 2> values;
+    };
+
+    // Follows 'path' from the root and returns the subgame starting there.
+    // Steps are action strings as DumpStrategy keys children (e.g. "CHECK",
+    // "BET 25") and, at chance nodes, the dealt cards (e.g. "Qs"; a
+    // flop as "Qs7h2c"). The path must be empty or end with a deal that
+    // leaves a betting round, so the cut sits where both commitments are
+    // equal. Non-const like ComputeExploitability: it resets the root reach.
+    // Throws:
+    //   std::invalid_argument if a step does not match the tree, a card is
+    //   unknown or already dealt, or the path ends elsewhere.
+    //   std::logic_error when the tree or ranges are unusable.
+    Subgame ExtractSubgame(const std::vector<std::string>& path);
+
+    // Safe re-solving for the next Train() calls: every hand of 'player' first
+    // chooses between entering the tree and taking 'values[h]', its EV in
+    // chips from the blueprint the subgame was cut from (Subgame::values
+    // mapped to GetPlayerRange order). The choice is trained with regret
+    // matching+ alongside the tree and scales the player's root reach, so a
+    // re-solved opponent strategy that would exploit a hand more than the
+    // blueprint did is not rewarded (the re-solve gadget of Burch, Johanson
+    // and Bowling). ComputeExploitability still measures the fixed ranges.
+    // Not saved in checkpoints.
+    // Throws:
+    //   std::invalid_argument if 'player' is not 0 or 1 or 'values' does not
+    //   match the range size.
+    void SetResolveGadget(size_t player, std::vector<double> values);
+
+    // Per hand of the gadget player, the current probability of entering the
+    // tree rather than taking its value; empty without a gadget.
+    std::vector<double> GetResolveGadgetEnterProbabilities() const;
+
+    // --- Node Locking ---
+    // Fixes the strategy of the action node at 'path' for every deal (see
+    // ActionNode::LockStrategy), e.g. to study how the other player exploits
+    // a known tendency. Steps are action strings as DumpStrategy keys
+    // children; chance nodes are passed through without a step, since the
+    // lock covers every card they deal. 'strategy' is hand-major over the
+    // acting player's GetPlayerRange, one row of action probabilities per
+    // hand. Training skips the regret and average updates of locked nodes
+    // and allocates no tables for them. Best responses keep locked nodes
+    // fixed as well, so ComputeExploitability measures the locked game.
+    // Locks are not saved in checkpoints: set the same locks before
+    // LoadCheckpoint.
+    // Throws:
+    //   std::invalid_argument if a step does not match the tree, the path
+    //   does not end at an action node, or the strategy is malformed.
+    //   std::logic_error with Config::use_isomorphism, whose suit merging
+    //   assumes strategies that a lock may break.
+    void LockNode(const std::vector<std::string>& path, std::vector<double> strategy);
+
+    // Removes a lock set by LockNode; the node trains again from zero.
+    // Throws std::invalid_argument like LockNode for a bad path.
+    void UnlockNode(const std::vector<std::string>& path);
+
+    // --- Live Snapshots ---
+    // Has Train() publish the average strategies of the action nodes from
+    // 'path' (as for LockNode) down to 'max_depth' actions below it (-1: no
+    // limit), stopping at chance nodes, every Config::snapshot_interval
+    // iterations and after the last one. A snapshot is copied on the
+    // training thread between iterations, so the solver threads never wait
+    // on a viewer, and swapped in as a whole; a root street region costs
+    // about a millisecond. Replaces any earlier request.
+    // Thread-safe.
+    // Throws:
+    //   std::invalid_argument for a bad path, like LockNode.
+    void SetSnapshotSubtree(const std::vector<std::string>& path, int max_depth = -1);
+
+    // The latest snapshot; null until one is published. Thread-safe and
+    // lock-free: any thread may call it while Train() runs.
+    std::shared_ptr<const StrategySnapshot> GetStrategySnapshot() const;
+
+    // Publishes a snapshot of the requested subtree now (nothing without a
+    // request). Must not run during Train(), which calls it itself.
+    void PublishStrategySnapshot();
+
+    // The action node at 'path' (steps as LockNode takes them), to read its
+    // trainables directly, e.g. ActionNode::GetTrainableIfExists per deal
+    // slot. Their tables change while Train() runs.
+    // Throws:
+    //   std::invalid_argument for a bad path, like LockNode.
+    const nodes::ActionNode& FindActionNode(const std::vector<std::string>& path) const;
+
+    // The 13x13 matrix view of the node at 'path' for deal slot 'deal',
+    // straight from its trainable: average strategy and EVs (where
+    // ComputeEvs set them) of every hand, weighted by the hand's reach, its
+    // range weight times its player's average strategy along the path.
+    // Hands holding a dealt card have no reach. Grids are cached per node
+    // and deal until training, loading, locking or ComputeEvs change the
+    // strategies, so revisiting a node costs a lookup. Null if the deal has
+    // no strategy. Must not run during Train().
+    // Throws:
+    //   std::invalid_argument for a bad path, like LockNode, or a deal slot
+    //   the node does not have.
+    std::shared_ptr<const HandGrid> GetHandGrid(const std::vector<std::string>& path, size_t deal = 0) const;
+
 private:
-    // The core recursive CFR function
-    // Returns utility vector from the perspective of the 'traverser'.
-    std::vector<double> cfr_utility(
-        std::shared_ptr<core::GameTreeNode> node,
-        const std::vector<std::vector<double>>& reach_probs, // pi_i(h), pi_{-i}(h)
-        int traverser,          // Player whose perspective we calculate utility for
-        int iteration,
+    // The core recursive CFR function.
+    // Writes the utility of every hand of each player with a non-null entry in
+    // 'utility' (from that player's perspective) and updates the trainables
+    // of those players. 'reach_sums' is computed once where each reach vector
+    // is produced, so zero-reach checks below are O(1). All intermediate buffers come from the calling
+    // thread's TraversalScratch at 'depth' and below, so steady-state
+    // iterations do not allocate. Nodes are indices into flat_tree_.
+    void cfr_utility(
+        uint32_t node_index,
+        const ReachPointers& reach_probs, // pi_i(h), pi_{-i}(h)
+        const ReachSums& reach_sums,      // Sum of each player's reach
+        const UtilityPointers& utility, // Players whose utility is computed
+        const IterationDiscounts& discounts, // This iteration's DCFR factors
         uint64_t current_board_mask, // Pass board down
-        double chance_reach);       // Probability of reaching this chance outcome
+        double chance_reach,        // Probability of reaching this chance outcome
+        size_t deal_index,          // Compact index of the cards dealt so far
+        size_t depth);              // Recursion depth (scratch level)
+
+    // Starts a traversal at 'node_index' as cfr_utility does; in
+    // ParallelLevel::kTasks mode from one thread of a parallel region whose
+    // team picks up its tasks. Exceptions cannot leave an OpenMP region, task
+    // or single block, so each of those keeps the first one thrown inside it
+    // and it is rethrown here once the region has ended.
+    void RunTraversal(uint32_t node_index, const ReachPointers& reach_probs, const ReachSums& reach_sums,
+                      const UtilityPointers& utility, const IterationDiscounts& discounts,
+                      uint64_t board_mask, double chance_reach, size_t deal_index);
 
     // Helper function for Action Nodes within cfr_utility
-    std::vector<double> cfr_action_node(
-        std::shared_ptr<nodes::ActionNode> node,
-        const std::vector<std::vector<double>>& reach_probs,
-        int traverser,
-        int iteration,
+    void cfr_action_node(
+        const tree::FlatNode& node,
+        const ReachPointers& reach_probs,
+        const ReachSums& reach_sums,
+        const UtilityPointers& utility,
+        const IterationDiscounts& discounts,
         uint64_t current_board_mask,
-        double chance_reach);
+        double chance_reach,
+        size_t deal_index,
+        size_t depth);
+
+    // Action nodes during ComputeExploitability: the player with a utility
+    // output takes the best action for each hand, the other plays its
+    // average strategy. With evaluating_average_ both play their average
+    // strategies, and with computing_evs_ the player with a utility output
+    // also records its action values on nodes within ev_max_depth_ (see
+    // ComputeEvs). Trainables are read, never created or updated.
+    void best_response_action_node(
+        const tree::FlatNode& node,
+        const ReachPointers& reach_probs,
+        const ReachSums& reach_sums,
+        const UtilityPointers& utility,
+        uint64_t current_board_mask,
+        double chance_reach,
+        size_t deal_index,
+        size_t depth);
 
     // Helper function for Chance Nodes within cfr_utility
-    std::vector<double> cfr_chance_node(
-        std::shared_ptr<nodes::ChanceNode> node,
-        const std::vector<std::vector<double>>& reach_probs,
-        int traverser,
-        int iteration,
+    void cfr_chance_node(
+        const tree::FlatNode& node,
+        const ReachPointers& reach_probs,
+        const ReachSums& reach_sums,
+        const UtilityPointers& utility,
+        const IterationDiscounts& discounts,
+        uint64_t current_board_mask,
+        double parent_chance_reach, // Renamed for clarity
+        size_t deal_index,
+        size_t depth);
+
+    // Deals 'outcome_board_mask' and traverses 'child' into 'utility', using
+    // 'level' for the children's reach. Returns false, leaving 'utility'
+    // untouched, when neither player has a hand left after the deal.
+    bool EvaluateChanceOutcome(
+        uint32_t child,
+        const ReachPointers& reach_probs,
+        const ReachSums& reach_sums,
+        const UtilityPointers& utility,
+        const IterationDiscounts& discounts,
         uint64_t current_board_mask,
-        double parent_chance_reach); // Renamed for clarity
+        uint64_t outcome_board_mask,
+        double chance_reach,
+        size_t deal_index,
+        int num_cards_dealt,
+        size_t depth,
+        TraversalScratch::Level& level);
+
+    // Public chance sampling (Config::sampled_chance_outcomes): draws that
+    // many of 'outcomes' into 'sampled', keeping their order, and returns
+    // the weight the drawn outcomes' chance reach is scaled by.
+    double SampleChanceOutcomes(const std::vector<uint64_t>& outcomes, uint64_t board_mask,
+                                std::vector<uint64_t>& sampled) const;
+
+    // Adds an outcome's utilities to 'sum', plus their suit-swapped copies for
+    // every suit the outcome represents.
+    void AccumulateOutcome(const UtilityPointers& sum, const UtilityPointers& outcome_utility,
+                           int outcome_suit,
+                           const std::array<int, core::kNumSuits>& suit_representative) const;
 
     // Helper function for Showdown Nodes within cfr_utility
-    std::vector<double> cfr_showdown_node(
-        std::shared_ptr<nodes::ShowdownNode> node,
-        const std::vector<std::vector<double>>& reach_probs,
-        int traverser,
+    void cfr_showdown_node(
+        const tree::FlatNode& node,
+        const ReachPointers& reach_probs,
+        const ReachSums& reach_sums,
+        const UtilityPointers& utility,
         uint64_t final_board_mask,
         double chance_reach); // Pass chance reach for correct weighting
 
+    // The showdowns of a chance node whose child is showdown node 'showdown',
+    // on every outcome it deals (one card each), as one backend batch per
+    // traverser. Adds the outcome utilities to 'utility' like the outcome
+    // loop of cfr_chance_node; outcomes outside 'owned_outcomes' and
+    // suit-isomorphic ones are skipped there too.
+    void cfr_showdown_runout(
+        const tree::FlatNode& showdown,
+        const ReachPointers& reach_probs,
+        const ReachSums& reach_sums,
+        const UtilityPointers& utility,
+        const std::vector<uint64_t>& outcomes,
+        const std::array<int, core::kNumSuits>& suit_representative,
+        uint64_t owned_outcomes,
+        uint64_t current_board_mask,
+        double chance_reach,
+        TraversalScratch::Level& level);
+
+    // The showdowns after an all-in on the flop: chance node 'outcomes'
+    // deals the turn, a second one the river, then comes 'showdown'. Each
+    // board of two of the outcomes is evaluated once, at twice the chance
+    // reach of one dealing order ('chance_reach' covers both deals), and
+    // added to 'utility'. 'parallel' splits the batches over the threads.
+    void cfr_two_card_runout(
+        const tree::FlatNode& showdown,
+        const ReachPointers& reach_probs,
+        const ReachSums& reach_sums,
+        const UtilityPointers& utility,
+        const std::vector<uint64_t>& outcomes,
+        uint64_t current_board_mask,
+        double chance_reach,
+        bool parallel,
+        TraversalScratch::Level& level);
+
+    // Evaluates the showdowns on level.runout's boards and reach left into
+    // one utility row per board in level.outcome_utility, as one backend
+    // batch per traverser ('parallel': one slice per thread).
+    void EvaluateRunoutBoards(
+        const tree::FlatNode& showdown,
+        const ReachPointers& reach_probs,
+        const UtilityPointers& utility,
+        double chance_reach,
+        bool parallel,
+        TraversalScratch::Level& level);
+
+    // Showdown payoffs of 'traverser' at 'node' (win, lose, tie), scaled by
+    // 'chance_reach'.
+    std::array<double, 3> ShowdownPayoffs(const tree::FlatNode& node, int traverser, double chance_reach) const;
+
+    // A depth-limit leaf: a chance node built without a child (flat node
+    // 'node_index'), valued by leaf_estimator_.
+    void cfr_leaf_node(
+        const tree::FlatNode& node,
+        uint32_t node_index,
+        const ReachPointers& reach_probs,
+        const ReachSums& reach_sums,
+        const UtilityPointers& utility,
+        uint64_t board_mask,
+        double chance_reach);
+
     // Helper function for Terminal Nodes within cfr_utility
-    std::vector<double> cfr_terminal_node(
-        std::shared_ptr<nodes::TerminalNode> node,
-        const std::vector<std::vector<double>>& reach_probs,
-        int traverser,
+    void cfr_terminal_node(
+        const tree::FlatNode& node,
+        const ReachPointers& reach_probs,
+        const ReachSums& reach_sums,
+        const UtilityPointers& utility,
         double chance_reach); // Pass chance reach for correct weighting
 
-    // Helper to recursively dump strategy from the tree
+    // Helper to recursively dump strategy from the tree.
+    // 'deal_layers' counts the card-specific chance nodes above 'node'.
     json dump_strategy_recursive(
         const std::shared_ptr<core::GameTreeNode>& node,
         bool dump_evs,
         int current_depth,
+        int max_depth,
+        int deal_layers) const;
+
+    // Streaming counterpart of dump_strategy_recursive: writes the members
+    // of the node's object, without braces, for a node has_strategy_dump
+    // accepts.
+    void stream_strategy_recursive(
+        std::ostream& out,
+        const std::shared_ptr<core::GameTreeNode>& node,
+        bool dump_evs,
+        int current_depth,
+        int max_depth,
+        int deal_layers) const;
+
+    // Whether dump_strategy_recursive returns anything for 'node': a leaf or
+    // a trained action node within 'max_depth', at or below it.
+    bool has_strategy_dump(
+        const std::shared_ptr<core::GameTreeNode>& node,
+        int current_depth,
         int max_depth) const;
 
+    // Trainable with the strategy of 'deal_index' at 'action_node': its own,
+    // or for a deal skipped by isomorphism its canonical deal's, with the
+    // suit swaps relating the two appended to 'swaps'. Null if neither.
+    std::shared_ptr<Trainable> DealTrainable(
+        const nodes::ActionNode& action_node,
+        size_t deal_index,
+        int deal_layers,
+        std::vector<std::pair<int, int>>& swaps) const;
+
+    // Drops the GetHandGrid cache; called wherever the strategies change.
+    void ClearHandGrids();
+
+    // Hand of the canonical deal whose strategy 'hand' plays after 'swaps'.
+    size_t SwappedHand(size_t player, size_t hand, const std::vector<std::pair<int, int>>& swaps) const;
+
+    // Dump of one deal's trainable at a card-specific action node; a deal
+    // skipped by isomorphism gets its canonical deal's dump with the hands
+    // relabelled. Null when the deal has no strategy.
+    json dump_deal_strategy(
+        const nodes::ActionNode& action_node,
+        size_t deal_index,
+        int deal_layers,
+        bool dump_evs) const;
+
+    // --- Deal Indexing ---
+    // Every single-card deal below a ChanceNode extends the deal index by one
+    // base-N digit (N = number of cards not on the initial board), so action
+    // nodes after k such deals own N^k lazily filled trainable slots. Deals of
+    // several cards at once (the flop from a preflop root) do not extend the
+    // index and keep sharing one trainable per node.
+
+    // Returns the deal index of the child reached by dealing 'outcome_mask'.
+    size_t NextDealIndex(size_t deal_index, uint64_t outcome_mask, int num_cards_dealt) const;
+
+    // Dealt cards for 'deal_index' after 'deal_layers' deals, e.g. "Qs3d".
+    std::string DealLabel(size_t deal_index, int deal_layers) const;
+
+    // --- NUMA Placement (see Config::numa_aware) ---
+    // Node owning the deal card 'card'.
+    size_t NumaNodeOfCard(int card) const;
+    // Node owning a river board: that of its first card off the initial board.
+    size_t NumaNodeOfBoard(uint64_t board_mask) const;
+    // Pins the calling thread of an OpenMP team to its node and moves its
+    // arena allocations to that node's lane. Returns the node.
+    size_t EnterNumaNode(int thread, int num_threads) const;
+
+    // --- Chance Deals ---
+    // What a chance node deals depends only on the board it is reached
+    // with, so the deals of every board a chance node can see are built once
+    // by the constructor (BuildChanceDealTable) and shared by all threads
+    // and iterations. Boards of chance depths with more than
+    // kMaxTabledChanceBoards boards (the turn and river of a preflop spot)
+    // are computed per visit instead.
+    struct ChanceDeals {
+        std::vector<uint64_t> outcomes; // Dealt card masks, lexicographic; empty if too few cards remain
+        std::array<int, core::kNumSuits> suit_representative{}; // See SuitRepresentatives; identity for flops
+        double outcome_probability = 0.0; // 1 / outcomes compatible with any pair of hands
+    };
+    static constexpr size_t kMaxTabledChanceBoards = 4096;
+
+    // Fills 'outcomes' and 'suit_representative' (see ChanceDeals) for
+    // dealing 'num_cards' cards onto 'board_mask' and returns the outcome
+    // probability (0 with no outcomes).
+    double BuildChanceDeals(uint64_t board_mask, int num_cards, std::vector<uint64_t>& outcomes,
+                            std::array<int, core::kNumSuits>& suit_representative) const;
+    void BuildChanceDealTable();
+
+    // --- Suit Isomorphism ---
+    // Two suits are interchangeable at a chance node when swapping them maps
+    // the initial board and both ranges onto themselves and no card of either
+    // suit has been dealt since. Only the lowest suit of each class is
+    // traversed; the others reuse its utilities with the hands permuted.
+
+    // Fills 'representative[s]' with the suit whose outcomes stand in for 's'
+    // on 'board_mask' (each suit represents itself when isomorphism is off).
+    void SuitRepresentatives(uint64_t board_mask,
+                             std::array<int, core::kNumSuits>& representative) const;
+
+    // Hand permutation of 'player' for exchanging suits 'suit1' and 'suit2'.
+    const std::vector<int>& SuitSwapHands(size_t player, int suit1, int suit2) const;
+
+    // Maps a deal skipped by isomorphism onto the traversed one. Returns the
+    // canonical deal index and appends to 'swaps' the suit exchanges that
+    // carry the original deal onto it, in the order they apply.
+    size_t CanonicalDeal(size_t deal_index, int deal_layers,
+                         std::vector<std::pair<int, int>>& swaps) const;
+
+
+    // Fills root_reach_/num_hands_ from the ranges; false if a range is
+    // empty or has zero weight.
+    bool InitializeRootReach();
+
+    // Preloads every river board the tree reaches into rrm_ (see
+    // Config::warmup_river_cache) and logs the time taken.
+    void WarmupRiverCache();
+
+    // Exponents behind each iteration's IterationDiscounts for config_.trainer.
+    DcfrParameters DiscountParameters() const;
+
+    // Discounts of 'iteration' with 'parameters', its strategy weight set
+    // per the average strategy schedule (Config::average_warmup_iterations).
+    IterationDiscounts DiscountsFor(int iteration, const DcfrParameters& parameters) const;
+
+    // Action node at the end of 'path' (see LockNode); 'caller' prefixes errors.
+    nodes::ActionNode& ActionNodeAt(const std::vector<std::string>& path, const std::string& caller) const;
+
+    // Trainable of 'node' for 'deal_index', created per config_ if missing.
+    std::shared_ptr<Trainable> TrainableFor(nodes::ActionNode& node, size_t deal_index) const;
+
+    // Creates the BucketedDiscountedCfrTrainable of a flop or turn 'node'
+    // for 'deal_index' (see Config::abstraction_buckets).
+    std::shared_ptr<Trainable> CreateBucketedTrainable(nodes::ActionNode& node, size_t deal_index) const;
+
+    // Replaces 'trainable', the dense trainable of 'node' for 'deal_index',
+    // by a SparseDiscountedCfrTrainable with its live hands' state, if few
+    // enough are live (see Config::sparse_trainable_warmup); 'reach_weights'
+    // are the acting player's of the current visit. Returns the new
+    // trainable, or null when it stays dense.
+    std::shared_ptr<Trainable> SparsifyTrainable(nodes::ActionNode& node, size_t deal_index,
+                                                 const Trainable& trainable, const double* reach_weights);
+
+    // --- Checkpoint Helpers ---
+    // Calls 'visit' on every action node, depth-first with children in order.
+    void ForEachActionNode(const std::function<void(nodes::ActionNode&)>& visit) const;
+
+    // SaveCheckpoint's format, written to 'out'.
+    void WriteCheckpoint(std::ostream& out) const;
+    // Snapshots the state into checkpoint_buffer_ and starts
+    // checkpoint_writer_ on it (see Config::checkpoint_interval).
+    void StartBackgroundCheckpoint();
+    // Waits for checkpoint_writer_, if running.
+    // Throws:
+    //   std::runtime_error with the writer's error, if it failed.
+    void FinishBackgroundCheckpoint();
+
+    // Hash of the tree shape, deal slots, board and ranges (see SaveCheckpoint).
+    uint64_t TreeFingerprint() const;
+
+    // --- Re-solve Gadget (see SetResolveGadget) ---
+    // Sizes the gadget for the root reach InitializeRootReach just set.
+    void PrepareResolveGadget();
+    // Current probability of entering the tree with 'hand'.
+    double ResolveGadgetEnterProbability(size_t hand) const;
+    // Scales the gadget player's root reach by that probability.
+    void ApplyResolveGadget(ReachSums& root_reach_sums);
+    // Regret update from the traversal's root utility for the gadget player.
+    void UpdateResolveGadget(const double* enter_utility);
+
+    // Builds flat_tree_ from game_tree_, with the per-node tables derived
+    // from it (leaf paths, subtree work, chance deals).
+    void IndexTree();
+
+    // Copies regrets (strategy sums start from zero) from the subtree at
+    // 'prior_root' into the one at 'root', walking both together as
+    // WarmStartFrom describes. hand_maps[p][h]: the prior index of player p's
+    // hand h, or -1. Returns the number of deal slots seeded.
+    size_t SeedRegrets(const std::shared_ptr<core::GameTreeNode>& root,
+                       const std::shared_ptr<core::GameTreeNode>& prior_root,
+                       const std::array<std::vector<int>, 2>& hand_maps);
+
+    // --- Task Scheduling ---
+    // Estimated node visits per traversal below flat node 'node_index'.
+    double SubtreeWork(uint32_t node_index) const;
+    // Work of a chance node whose first child is 'child', as
+    // Config::parallel_cutoff measures it.
+    double ChanceWork(uint32_t child, size_t num_outcomes) const;
+    // Times an empty parallel region and arms the timing of fan-outs for
+    // the next kParallelTuningIterations iterations.
+    void StartParallelCutoffTuning();
+    // Sets parallel_cutoff_ from the timings.
+    void FinishParallelCutoffTuning();
+
 
     // --- Member Variables ---
     std::shared_ptr<ranges::PrivateCardsManager> pcm_;
@@ -121,6 +1009,86 @@ private:
     std::atomic<bool> stop_signal_{false};
     bool evs_calculated_ = false; // Track if final EVs are computed
     const size_t num_players_ = 2; // Hardcoded for now
+    std::array<size_t, 2> num_hands_{}; // Range size per player, set by Train()
+    std::array<std::vector<double>, 2> root_reach_; // Initial reach, set by InitializeRootReach()
+    std::vector<int> deal_cards_; // Deck cards not on the initial board, ascending
+    std::array<int, core::kNumCardsInDeck> deal_card_position_{}; // Card -> index in deal_cards_ (-1 if on board)
+    // isomorphic_suits_[s1][s2]: suits exchangeable on the initial board and ranges.
+    std::array<std::array<bool, core::kNumSuits>, core::kNumSuits> isomorphic_suits_{};
+    // suit_swap_hands_[player][s1 * kNumSuits + s2][h]: index of hand h with s1/s2 exchanged.
+    std::array<std::vector<std::vector<int>>, 2> suit_swap_hands_;
+    std::unique_ptr<tree::FlatGameTree> flat_tree_; // game_tree_ flattened for cfr_utility
+    std::vector<double> subtree_work_; // Per flat node, see SubtreeWork
+    double parallel_cutoff_ = 0.0; // See GetParallelCutoff
+    bool parallel_cutoff_tuned_ = false;
+    int parallel_tuning_iterations_left_ = 0; // Fan-outs are timed while > 0
+    double parallel_region_seconds_ = 0.0; // Fork and join of an empty region
+    double tuning_busy_seconds_ = 0.0; // Thread time inside timed fan-outs
+    double tuning_work_ = 0.0; // ChanceWork of timed fan-outs
+    hashing::FlatHashMap<ChanceDeals> chance_deals_; // By board mask, see BuildChanceDealTable
+    bool evaluating_best_response_ = false; // Action nodes dispatch to best_response_action_node
+    bool evaluating_average_ = false; // See best_response_action_node
+    bool computing_evs_ = false; // See best_response_action_node
+    int ev_max_depth_ = -1; // Deepest node ComputeEvs sets EVs on (-1: all)
+    bool pruning_this_iteration_ = false; // See Config::regret_pruning
+    uint64_t sampling_round_ = 0; // Training traversal being run, see SampleChanceOutcomes
+    bool sparsify_this_iteration_ = false; // See Config::sparse_trainable_warmup
+    bool sparse_pass_done_ = false;
+    std::atomic<size_t> sparse_trainables_created_{0};
+    std::thread checkpoint_writer_; // See Config::checkpoint_interval
+    std::vector<char> checkpoint_buffer_; // Read by checkpoint_writer_ while it runs
+    std::string checkpoint_error_; // Set by checkpoint_writer_ when it fails
+    // Live snapshots: the requested nodes, guarded by snapshot_mutex_; the
+    // published snapshot, only accessed with std::atomic_load/store; and a
+    // retired one no reader holds, refilled by the next publication.
+    struct SnapshotNode {
+        std::vector<std::string> path;
+        nodes::ActionNode* node;
+    };
+    std::mutex snapshot_mutex_;
+    std::vector<SnapshotNode> snapshot_nodes_;
+    std::shared_ptr<const StrategySnapshot> published_snapshot_;
+    std::shared_ptr<StrategySnapshot> spare_snapshot_;
+    // GetHandGrid results by node and deal slot; see ClearHandGrids.
+    mutable std::mutex hand_grid_mutex_;
+    mutable std::map<std::pair<const nodes::ActionNode*, size_t>, std::shared_ptr<const HandGrid>> hand_grids_;
+    bool river_cache_warmed_ = false; // See WarmupRiverCache
+    double last_exploitability_ = -1.0;
+    int completed_iterations_ = 0; // See GetCompletedIterations
+    // Storage of the trainables GetTrainable creates, sized for every deal
+    // slot up front; null for precisions and trainers that do not use it.
+    // By street (GameRound), so that out-of-core streets get file-backed
+    // arenas of their own; the resident streets share one.
+    std::array<std::shared_ptr<TrainableArena>, 4> trainable_arenas_;
+    // Nodes in NUMA mode, empty otherwise (also on a single node).
+    NumaTopology numa_;
+    // Per node, the next outcome index its threads look at in a fan-out.
+    std::unique_ptr<std::atomic<size_t>[]> numa_next_outcome_;
+    std::shared_ptr<SolverProgressQueue> progress_queue_; // See SetProgressQueue
+    std::shared_ptr<SolverTransport> transport_;          // See SetTransport
+    std::shared_ptr<TraceRecorder> trace_recorder_;       // See SetTraceRecorder
+    std::shared_ptr<ShowdownBackend> showdown_backend_;   // See SetShowdownBackend
+    std::shared_ptr<LeafValueEstimator> leaf_estimator_;  // See SetLeafValueEstimator
+    std::unique_ptr<HandAbstraction> hand_abstraction_;   // See Config::abstraction_buckets
+    // Per flat node, the action path of depth-limit leaves (empty elsewhere);
+    // no entries at all for trees without leaves.
+    std::vector<std::string> leaf_paths_;
+    // Null unless kTraversalStatsEnabled; see GetTraversalStats.
+    std::unique_ptr<TraversalStatsCollector> traversal_stats_collector_;
+    TraversalStats traversal_stats_;
+    TraversalStats last_iteration_traversal_stats_;
+    // See SetResolveGadget. 'regrets' holds, per hand, the regrets of
+    // entering and of taking the value; the rest is set by
+    // PrepareResolveGadget.
+    struct ResolveGadget {
+        size_t player = 0;
+        std::vector<double> values;
+        std::vector<double> base_reach;  // The player's root reach before the choice
+        std::vector<double> alternative; // Values in counterfactual units
+        std::vector<double> regrets;
+    };
+    std::unique_ptr<ResolveGadget> resolve_gadget_;
+    std::array<double, 2> best_response_values_{};
 };
 
 } // namespace solver
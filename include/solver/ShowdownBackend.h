@@ -0,0 +1,64 @@
+#ifndef POKER_SOLVER_SOLVER_SHOWDOWN_BACKEND_H_
+#define POKER_SOLVER_SOLVER_SHOWDOWN_BACKEND_H_
+
+#include "ranges/RiverCombs.h" // For PackedRiverCombos
+
+#include <cstddef>
+#include <cstdint>
+
+namespace poker_solver {
+namespace solver {
+
+// Where PCfrSolver evaluates its showdowns (see SetShowdownBackend). A call
+// covers one showdown node and one traverser on a batch of river boards:
+// a single board for a showdown reached through action nodes, and every
+// board a chance node deals when it leads straight to the showdown (the
+// runouts after an all-in). An accelerator backend can keep the combos of
+// the boards it has seen resident, keyed by board mask, so that a batch
+// only moves the reach in and the utility rows out.
+class ShowdownBackend {
+ public:
+  struct Batch {
+    size_t num_boards = 0;
+    const uint64_t* board_masks = nullptr;
+    // Per board, each player's combos on it (RiverRangeManager order).
+    const ranges::PackedRiverCombos* const* traverser_combos = nullptr;
+    const ranges::PackedRiverCombos* const* opponent_combos = nullptr;
+    // Board i reads opponent_reach + i * opponent_reach_stride; a stride
+    // of 0 shares one reach vector between the boards. The dealt cards need
+    // no masking, since the combos of a board only hold hands it does not
+    // block.
+    const double* opponent_reach = nullptr;
+    size_t opponent_reach_stride = 0;
+    size_t traverser_hands = 0;
+    size_t opponent_hands = 0;
+    // Traverser payoffs, already scaled by the chance reach of the boards.
+    double win_payoff = 0.0;
+    double lose_payoff = 0.0;
+    double tie_payoff = 0.0;
+    // Per board, traverser_hands utilities to overwrite (see
+    // ShowdownUtilitySweep).
+    double* const* utility = nullptr;
+  };
+
+  virtual ~ShowdownBackend() = default;
+
+  // Short name for logs, e.g. "cpu".
+  virtual const char* Name() const = 0;
+
+  // Fills every utility row of 'batch'. Called from all solver threads at
+  // once.
+  virtual void EvaluateShowdowns(const Batch& batch) = 0;
+};
+
+// Runs ShowdownUtilitySweep on each board, on the calling thread.
+class CpuShowdownBackend final : public ShowdownBackend {
+ public:
+  const char* Name() const override { return "cpu"; }
+  void EvaluateShowdowns(const Batch& batch) override;
+};
+
+} // namespace solver
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_SOLVER_SHOWDOWN_BACKEND_H_
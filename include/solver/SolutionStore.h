@@ -0,0 +1,89 @@
+#ifndef POKER_SOLVER_SOLVER_SOLUTION_STORE_H_
+#define POKER_SOLVER_SOLVER_SOLUTION_STORE_H_
+
+#include "Card.h"                // For kNumSuits
+#include "ranges/PrivateCards.h" // For PrivateCards
+#include "solver/PCfrSolver.h"   // For PCfrSolver, PCfrSolver::Config
+#include "tools/Rule.h"          // For Rule
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace poker_solver {
+namespace solver {
+
+// Identity of a spot for SolutionStore: everything that decides its solution
+// (the Rule with its bet sizes, the result-affecting solver settings, the
+// board, deck and ranges), with suits renamed to the lexicographically
+// smallest of the 24 relabelings. Spots that differ only by a suit
+// permutation get the same key. Hands on the board and hands of zero weight
+// are left out, as the solver never deals them.
+//
+// Settings that change speed or memory but not the strategy (threads,
+// parallelism, precision-neutral storage such as the arena or mapped
+// tables, checkpoints) are not part of the key. Keys assume one hand
+// evaluator per store.
+struct SpotKey {
+  std::string canonical;  // Text form; equal keys have equal text
+  uint64_t fingerprint = 0; // FNV-1a of 'canonical'
+  // Spot suit -> canonical suit (suit = card % kNumSuits).
+  std::array<int, core::kNumSuits> to_canonical_suit{};
+
+  // Throws:
+  //   std::invalid_argument if there are not two ranges.
+  static SpotKey Make(const config::Rule& rule, const std::vector<std::vector<core::PrivateCards>>& ranges,
+                      const PCfrSolver::Config& config);
+};
+
+// Content-addressed cache of solved spots in a directory, shared by every
+// process that points at it. Each entry is a strategy file
+// (PCfrSolver::WriteStrategyFile) named by the key's fingerprint, plus a
+// ".key" file holding the full key, which lookups compare so a fingerprint
+// collision is a miss rather than a wrong answer. The strategy is stored in
+// the suits of the spot that first solved it; a hit carries the map from the
+// querying spot's suits to the stored ones.
+class SolutionStore {
+ public:
+  struct Hit {
+    std::string strategy_path;
+    // Querying spot suit -> suit in the stored file. Apply it to cards of
+    // the query (node paths, hands) before looking them up in the file.
+    std::array<int, core::kNumSuits> suit_map{};
+  };
+
+  // Creates 'directory' if it does not exist.
+  // Throws:
+  //   std::invalid_argument if directory is empty.
+  //   std::runtime_error if it cannot be created.
+  explicit SolutionStore(std::string directory);
+
+  // The stored solution for 'key', if any. Unreadable or mismatching
+  // entries are misses.
+  std::optional<Hit> Lookup(const SpotKey& key) const;
+
+  // Writes the trained solver's strategy under 'key', replacing any entry
+  // with the same fingerprint. Files are renamed into place, the key last,
+  // so concurrent lookups see either no entry or a complete one.
+  // Throws:
+  //   std::runtime_error if the files cannot be written.
+  Hit Store(const SpotKey& key, const PCfrSolver& solver) const;
+
+  const std::string& Directory() const { return directory_; }
+
+ private:
+  std::string EntryPath(const SpotKey& key, const char* extension) const;
+
+  std::string directory_;
+};
+
+// Maps a card's suit with a SolutionStore::Hit::suit_map.
+inline int MapCardSuit(int card, const std::array<int, core::kNumSuits>& suit_map) {
+    return card - card % core::kNumSuits + suit_map[card % core::kNumSuits];
+}
+
+} // namespace solver
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_SOLVER_SOLUTION_STORE_H_
@@ -0,0 +1,155 @@
+#ifndef POKER_SOLVER_SOLVER_SOLVE_SERVICE_H_
+#define POKER_SOLVER_SOLVER_SOLVE_SERVICE_H_
+
+#include "compairer/Compairer.h"    // For Compairer
+#include "solver/PCfrSolver.h"      // For PCfrSolver, PCfrSolver::Config
+#include "solver/SolutionStore.h"   // For SolutionStore
+#include "solver/SolverProgress.h"  // For SolverProgress
+#include "tools/ScenarioFile.h"     // For Scenario
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace poker_solver {
+namespace ranges { class RiverRangeManager; }
+
+namespace solver {
+
+// One solve request for a SolveService.
+struct SolveJob {
+  config::Scenario scenario;
+  // Solver settings; num_threads is the job's thread budget (at least 1,
+  // at most the service's). With warmup_river_cache the service preloads
+  // the shared river cache once instead of each solver.
+  PCfrSolver::Config config;
+  int priority = 0;        // Higher runs first; equal priorities in submission order
+  // Strategy file (PCfrSolver::WriteStrategyFile) to write; empty: none.
+  // Not written on a solution store hit (see SolveJobStatus::cached).
+  std::string output_path;
+};
+
+enum class SolveJobState { kQueued, kRunning, kDone, kFailed, kCancelled };
+
+// "queued", "running", "done", "failed" or "cancelled".
+const char* SolveJobStateName(SolveJobState state);
+
+struct SolveJobStatus {
+  uint64_t id = 0;
+  SolveJobState state = SolveJobState::kQueued;
+  int threads = 0;
+  std::optional<SolverProgress> progress; // Last report of a running or finished job
+  std::string error;                      // kFailed only
+  // Set when the spot was found in Options::solution_store instead of solved.
+  std::optional<SolutionStore::Hit> cached;
+  double seconds = 0.0; // From start to end of the run; 0 while queued
+};
+
+// A long-lived solver process core: holds the hand evaluator and the river
+// caches of recent spots across jobs, and runs submitted jobs from a
+// priority queue, as many side by side as their thread budgets fit in
+// Options::num_threads. The queue is strict: a job that does not fit yet
+// holds back the jobs behind it, so large jobs are not starved by small
+// ones. Each running job has its own std::thread (and OpenMP team).
+//
+// One scheduler thread starts jobs, polls running ones for progress and
+// calls the event callback: once per state change, and per poll with the
+// latest progress report of each running job (reports that measured
+// exploitability are all passed on). Callbacks are serialized, in order
+// per job, and must not call back into the service except Status.
+class SolveService {
+ public:
+  struct Options {
+    int num_threads;           // Total threads; default: hardware concurrency
+    size_t river_caches;       // River caches kept for later jobs; default 4
+    std::chrono::milliseconds poll_interval; // Progress polling; default 100 ms
+    size_t finished_jobs;      // Finished jobs whose status is kept; default 1024
+    // Spots found here are not solved; solved spots are added. Null: none.
+    std::shared_ptr<SolutionStore> solution_store;
+    Options();
+  };
+
+  using EventCallback = std::function<void(const SolveJobStatus& status)>;
+
+  // Throws:
+  //   std::invalid_argument if compairer is null.
+  SolveService(std::shared_ptr<core::Compairer> compairer, Options options = Options(),
+               EventCallback on_event = nullptr);
+
+  // Cancels queued and running jobs and waits for them.
+  ~SolveService();
+
+  SolveService(const SolveService&) = delete;
+  SolveService& operator=(const SolveService&) = delete;
+
+  // Queues a job and returns its id (ids start at 1).
+  // Throws:
+  //   std::logic_error after Shutdown.
+  uint64_t Submit(SolveJob job);
+
+  // Cancels a queued job, or stops a running one (PCfrSolver::Stop) after
+  // its current iteration without writing its output. Returns false for
+  // unknown or already finished jobs.
+  bool Cancel(uint64_t id);
+
+  std::optional<SolveJobStatus> Status(uint64_t id) const;
+
+  // Blocks until the job has finished and its events were delivered;
+  // returns its final status, or nullopt for unknown ids.
+  std::optional<SolveJobStatus> Wait(uint64_t id);
+
+  // Blocks until no job is queued or running.
+  void WaitIdle();
+
+  // Stops accepting jobs; with 'cancel', also cancels the queued and
+  // running ones. Returns once every job has finished.
+  void Shutdown(bool cancel = false);
+
+ private:
+  struct Job;
+  struct RiverCache;
+
+  void SchedulerLoop();
+  void RunJob(const std::shared_ptr<Job>& job);
+  std::shared_ptr<RiverCache> AcquireRiverCache(const std::string& key);
+  void Emit(std::vector<SolveJobStatus>& events);
+
+  std::shared_ptr<core::Compairer> compairer_;
+  Options options_;
+  EventCallback on_event_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable wake_;     // Scheduler: new, cancelled or finished jobs
+  std::condition_variable finished_; // Waiters: a job's final event was delivered
+  std::map<uint64_t, std::shared_ptr<Job>> jobs_;
+  std::set<std::pair<int, uint64_t>> queue_; // (-priority, id)
+  std::vector<std::shared_ptr<Job>> cancelled_queued_; // Final events still to deliver
+  std::deque<uint64_t> finished_ids_;        // Oldest first, for forgetting
+  uint64_t next_id_ = 1;
+  int running_threads_ = 0;
+  size_t active_jobs_ = 0; // Queued or running, or finished with events not yet delivered
+  bool shutting_down_ = false;
+  bool pending_wake_ = false; // Set with every wake_ notification
+
+  std::mutex river_mutex_;
+  std::list<std::pair<std::string, std::shared_ptr<RiverCache>>> river_caches_; // Most recent first
+
+  std::thread scheduler_;
+};
+
+} // namespace solver
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_SOLVER_SOLVE_SERVICE_H_
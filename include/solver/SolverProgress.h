@@ -0,0 +1,64 @@
+#ifndef POKER_SOLVER_SOLVER_SOLVER_PROGRESS_H_
+#define POKER_SOLVER_SOLVER_SOLVER_PROGRESS_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace poker_solver {
+namespace solver {
+
+// One training iteration as reported by PCfrSolver::Train.
+struct SolverProgress {
+  int iteration = 0;          // Completed iterations, including restored ones
+  double elapsed_seconds = 0; // Since this Train() call started
+  double exploitability = -1; // Percentage of the pot; negative if not measured this iteration
+  double exploitability_seconds = 0; // Part of elapsed_seconds spent measuring it
+  uint64_t resident_bytes = 0; // Process resident set size; 0 where unknown
+};
+
+// Bounded single-producer/single-consumer queue of progress reports. The
+// solver's training thread pushes and one reader (e.g. a GUI timer) pops;
+// neither side locks or waits. A report that finds the queue full is dropped
+// and counted, so a reader that falls behind never slows training down.
+class SolverProgressQueue {
+ public:
+  // Capacity is rounded up to a power of two (at least 2).
+  explicit SolverProgressQueue(size_t capacity = 1024);
+
+  SolverProgressQueue(const SolverProgressQueue&) = delete;
+  SolverProgressQueue& operator=(const SolverProgressQueue&) = delete;
+
+  // Producer only. Returns false, dropping the report, if the queue is full.
+  bool Push(const SolverProgress& progress);
+
+  // Consumer only. Oldest report not yet popped, if any.
+  std::optional<SolverProgress> Pop();
+
+  size_t Capacity() const { return slots_.size(); }
+  // Reports Push has dropped so far; safe from any thread.
+  uint64_t Dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+ private:
+  std::vector<SolverProgress> slots_;
+  size_t mask_;
+  // Monotonic counters; slot = counter & mask_. Kept on separate cache lines
+  // so the two threads do not share one.
+  alignas(64) std::atomic<size_t> write_index_{0}; // Written by the producer
+  alignas(64) std::atomic<size_t> read_index_{0};  // Written by the consumer
+  alignas(64) std::atomic<uint64_t> dropped_{0};
+};
+
+// Resident set size of the calling process in bytes (Linux /proc), or 0
+// where it cannot be read.
+uint64_t CurrentResidentBytes();
+
+// Physical memory of the machine in bytes (Linux), or 0 where unknown.
+uint64_t PhysicalMemoryBytes();
+
+} // namespace solver
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_SOLVER_SOLVER_PROGRESS_H_
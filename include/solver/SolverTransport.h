@@ -0,0 +1,55 @@
+#ifndef POKER_SOLVER_SOLVER_SOLVER_TRANSPORT_H_
+#define POKER_SOLVER_SOLVER_SOLVER_TRANSPORT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace poker_solver {
+namespace solver {
+
+// Collective communication between the ranks of a distributed solve (see
+// PCfrSolver::SetTransport). Every rank must make the same calls in the
+// same order.
+class SolverTransport {
+ public:
+  virtual ~SolverTransport() = default;
+
+  virtual int Rank() const = 0; // 0 .. Size() - 1; rank 0 coordinates
+  virtual int Size() const = 0;
+
+  // Replaces data[0 .. count) on every rank by its element-wise sum over all
+  // ranks. The sum is taken in rank order, so every rank gets bit-identical
+  // results. Blocks until every rank has contributed.
+  // Throws:
+  //   std::runtime_error if a peer disconnects or sends a mismatched count.
+  virtual void AllReduceSum(double* data, size_t count) = 0;
+};
+
+// Transports of 'size' ranks in one process, one per thread; for tests and
+// for trying partitions on one machine.
+// Throws:
+//   std::invalid_argument if size < 1.
+std::vector<std::shared_ptr<SolverTransport>> CreateLocalTransportGroup(int size);
+
+// TCP transport in a star around rank 0: workers send their vectors to the
+// coordinator, which sums them and sends the result back.
+//
+// The coordinator listens on 'port' (all interfaces) and waits for
+// 'size' - 1 workers; each worker connects to 'host':'port' and announces
+// its rank, retrying for 'connect_timeout_seconds' while the coordinator is
+// not up yet.
+// Throws:
+//   std::invalid_argument on a bad rank/size.
+//   std::runtime_error if the connection cannot be set up, or on platforms
+//   without POSIX sockets.
+std::shared_ptr<SolverTransport> CreateTcpCoordinator(uint16_t port, int size);
+std::shared_ptr<SolverTransport> CreateTcpWorker(const std::string& host, uint16_t port, int rank, int size,
+                                                 int connect_timeout_seconds = 60);
+
+} // namespace solver
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_SOLVER_SOLVER_TRANSPORT_H_
@@ -0,0 +1,161 @@
+#ifndef POKER_SOLVER_SOLVER_STRATEGY_FILE_H_
+#define POKER_SOLVER_SOLVER_STRATEGY_FILE_H_
+
+#include "ranges/PrivateCards.h" // For PrivateCards
+#include "tools/MappedFile.h"    // For MappedFile
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace poker_solver {
+namespace solver {
+
+// Width of the strategy and EV values in a strategy file. kUint8 stores
+// each node's matrices as bytes with a per-node affine scale (see
+// QuantizedScale), a quarter of kFloat32's size for 1/255 of the node's
+// value range in error.
+enum class StrategyValueType : uint8_t { kFloat32 = 0, kFloat16 = 1, kUint8 = 2 };
+
+// Decoding of a kUint8 matrix: value = offset + byte * scale. Strategies
+// have offset 0 and scale max / 255, EVs span their [min, max]. Other value
+// types, and nodes without EVs, have {0, 1}.
+struct QuantizedScale {
+  float offset = 0.0f;
+  float scale = 1.0f;
+};
+
+// IEEE 754 binary16 conversions (round to nearest even; out of range
+// values become infinities).
+uint16_t FloatToHalf(float value);
+float HalfToFloat(uint16_t half);
+
+// Strategy files: a binary export of average strategies for analytics and
+// query services, mapped rather than parsed.
+//
+// Layout (host byte order):
+//   64-byte header: magic "PSSTRAT1", version, value type, counts and an
+//                   FNV-1a checksum of the index sections
+//   hands:          both players' ranges as (card1, card2) byte pairs
+//   node table:     one 64-byte entry per node (path, player, dimensions,
+//                   offset of its values, kUint8 scales)
+//   hash slots:     open-addressed table from FNV-1a(path) to node
+//   strings:        node paths and '\n'-separated action labels
+//   values:         from a 64-byte boundary, per node the strategy and then,
+//                   if present, the EV matrix, action-major
+//                   (value[a * num_hands + h]), each node 8-byte aligned
+//
+// A node path names the actions leading to an action node and the cards
+// dealt on the way, separated by '/', e.g. "CHECK/BET 2.000000/CALL/Qs". The
+// root's path is empty. Card-specific nodes get one entry per dealt card
+// sequence. The checksum covers the index, not the values, so opening a
+// file reads only its index.
+
+// Collects a strategy file's node index, then writes the file, asking for
+// each node's values in turn so only the index and one node are in memory.
+class StrategyFileWriter {
+ public:
+  // Fills 'strategy' (and 'evs' for nodes added with EVs) hand-major,
+  // num_actions * num_hands values, for the node AddNode numbered 'node'.
+  using NodeValues = std::function<void(size_t node, std::vector<double>& strategy, std::vector<double>& evs)>;
+
+  // Args:
+  //   ranges: Hands of each player; a node's values cover its player's range.
+  StrategyFileWriter(StrategyValueType value_type, const std::array<std::vector<core::PrivateCards>, 2>& ranges);
+
+  // Declares the next node and returns its number.
+  // Throws:
+  //   std::invalid_argument on a player other than 0/1, no actions, or an
+  //                         action label containing '\n'.
+  size_t AddNode(const std::string& path, size_t player, const std::vector<std::string>& actions, bool has_evs);
+
+  size_t NumNodes() const { return nodes_.size(); }
+
+  // Writes the file through a temporary file renamed into place.
+  // Throws:
+  //   std::invalid_argument if two nodes share a path.
+  //   std::runtime_error if the file cannot be written.
+  void Write(const std::string& path, const NodeValues& values) const;
+
+ private:
+  struct PendingNode {
+    uint64_t path_hash;
+    uint64_t path_offset;
+    uint64_t actions_offset;
+    uint32_t path_length;
+    uint32_t actions_length;
+    uint32_t num_actions;
+    uint8_t player;
+    bool has_evs;
+  };
+
+  StrategyValueType value_type_;
+  std::array<std::vector<uint8_t>, 2> hands_; // Card pairs
+  std::vector<PendingNode> nodes_;
+  std::string strings_;
+};
+
+// Read-only view of a strategy file. Opening validates the header and index;
+// node lookups by path are O(1) and values are read straight from the
+// mapping. Node numbers follow the order the nodes were written in.
+class StrategyFile {
+ public:
+  // Throws:
+  //   std::runtime_error if the file cannot be read, is not a strategy file,
+  //                      has another version or fails its checksum.
+  explicit StrategyFile(const std::string& path);
+
+  StrategyValueType ValueType() const { return value_type_; }
+  size_t NumNodes() const { return num_nodes_; }
+
+  // Number of the node at 'path', if the file has one.
+  std::optional<size_t> Find(std::string_view path) const;
+
+  std::string_view Path(size_t node) const;
+  size_t Player(size_t node) const;
+  size_t NumActions(size_t node) const;
+  size_t NumHands(size_t node) const;
+  bool HasEvs(size_t node) const;
+  std::vector<std::string> Actions(size_t node) const;
+  // Hand 'hand' of the node's player.
+  core::PrivateCards Hand(size_t node, size_t hand) const;
+
+  // Average strategy / EV of 'hand' for 'action'. Ev() is NaN for nodes
+  // without EVs.
+  float Strategy(size_t node, size_t action, size_t hand) const;
+  float Ev(size_t node, size_t action, size_t hand) const;
+  // Whole matrices, action-major.
+  std::vector<float> StrategyMatrix(size_t node) const;
+  std::vector<float> EvMatrix(size_t node) const;
+  // The same matrices in place in the mapping, as ValueType() values
+  // (8-byte aligned), valid while this object lives; EvValues() is null
+  // for nodes without EVs. kUint8 values decode with the node's scales.
+  const unsigned char* StrategyValues(size_t node) const;
+  const unsigned char* EvValues(size_t node) const;
+  QuantizedScale StrategyScale(size_t node) const;
+  QuantizedScale EvScale(size_t node) const;
+
+ private:
+  float Value(const unsigned char* values, size_t index, QuantizedScale scale) const;
+  std::vector<float> Matrix(const unsigned char* values, size_t count, QuantizedScale scale) const;
+
+  utils::MappedFile file_;
+  StrategyValueType value_type_ = StrategyValueType::kFloat32;
+  size_t value_size_ = sizeof(float);
+  size_t num_nodes_ = 0;
+  uint64_t slot_mask_ = 0;
+  std::array<size_t, 2> num_hands_{};
+  const unsigned char* hands_ = nullptr;
+  const unsigned char* nodes_ = nullptr;
+  const unsigned char* slots_ = nullptr;
+  const char* strings_ = nullptr;
+  const unsigned char* values_ = nullptr;
+};
+
+} // namespace solver
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_SOLVER_STRATEGY_FILE_H_
@@ -0,0 +1,33 @@
+#ifndef POKER_SOLVER_SOLVER_STRATEGY_SNAPSHOT_H_
+#define POKER_SOLVER_SOLVER_STRATEGY_SNAPSHOT_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace poker_solver {
+namespace solver {
+
+// Average strategies of one subtree, copied between two training iterations
+// (see PCfrSolver::SetSnapshotSubtree). Immutable once published, so a
+// viewer may keep reading one for as long as it holds it.
+struct StrategySnapshot {
+  struct Node {
+    // Action strings from the tree root (as PCfrSolver::LockNode takes them).
+    std::vector<std::string> path;
+    size_t player = 0;
+    std::vector<std::string> actions;
+    // Per deal slot, the average strategy, hand-major over the player's
+    // range (PrivateCardsManager::GetPlayerRange); empty for slots that have
+    // no trainable yet.
+    std::vector<std::vector<double>> strategies;
+  };
+
+  int iteration = 0;       // Completed iterations when it was taken
+  std::vector<Node> nodes; // Depth-first from the requested node, children in action order
+};
+
+} // namespace solver
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_SOLVER_STRATEGY_SNAPSHOT_H_
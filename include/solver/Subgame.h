@@ -0,0 +1,55 @@
+#ifndef POKER_SOLVER_SOLVER_SUBGAME_H_
+#define POKER_SOLVER_SOLVER_SUBGAME_H_
+
+#include "compairer/Compairer.h"            // For Compairer
+#include "solver/LeafValueEstimator.h"      // For LeafValueEstimator
+#include "solver/PCfrSolver.h"              // For PCfrSolver, PCfrSolver::Subgame
+#include "tools/GameTreeBuildingSettings.h" // For GameTreeBuildingSettings
+#include "tools/Rule.h"                     // For Rule
+#include <cstddef>
+#include <memory>
+
+namespace poker_solver {
+namespace solver {
+
+// How ResolveSubgame treats the ranges arriving at the subgame, and how far
+// it solves.
+struct ResolveOptions {
+  // Safe re-solving: the opponent of 'resolving_player' gets the re-solve
+  // gadget (see PCfrSolver::SetResolveGadget) with its blueprint values, so
+  // the new strategy of 'resolving_player' is no more exploitable there than
+  // the blueprint's. Unsafe re-solving fixes both ranges, which converges to
+  // the subgame's own equilibrium but may exploit, and be exploited, beyond
+  // the blueprint.
+  bool safe = true;
+  size_t resolving_player = 0;
+  // Solve only the subgame's first street (see config::Rule::IsDepthLimited),
+  // valuing its end with 'leaf_estimator' (null: the check-down default).
+  // A depth-limited 'rule' makes every re-solve depth-limited.
+  bool depth_limited = false;
+  std::shared_ptr<LeafValueEstimator> leaf_estimator;
+};
+
+// The rule of a subgame cut from a solve of 'rule': its street, board and
+// pot (half committed by each player), with 'build_settings' as the bet
+// sizes; deck, stacks, blinds, raise limit and depth limit are kept.
+config::Rule SubgameRule(const PCfrSolver::Subgame& subgame, const config::Rule& rule,
+                         const config::GameTreeBuildingSettings& build_settings);
+
+// Builds the subgame's tree with 'build_settings', solves it from the
+// subgame's ranges (see ResolveOptions) with 'config', and returns the
+// trained solver, e.g. to dump the re-solved strategy. Only the subtree is
+// solved, so a what-if on the river bet sizes costs a river solve.
+// Throws:
+//   std::invalid_argument if compairer is null, a subgame range is empty,
+//   or options.resolving_player is not 0 or 1.
+std::unique_ptr<PCfrSolver> ResolveSubgame(const PCfrSolver::Subgame& subgame, const config::Rule& rule,
+                                           const config::GameTreeBuildingSettings& build_settings,
+                                           std::shared_ptr<core::Compairer> compairer,
+                                           const PCfrSolver::Config& config,
+                                           const ResolveOptions& options = ResolveOptions());
+
+} // namespace solver
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_SOLVER_SUBGAME_H_
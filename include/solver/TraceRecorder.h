@@ -0,0 +1,103 @@
+#ifndef POKER_SOLVER_SOLVER_TRACE_RECORDER_H_
+#define POKER_SOLVER_SOLVER_TRACE_RECORDER_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace poker_solver {
+namespace solver {
+
+// Records timed spans (iterations, streets, chance outcomes, river cache
+// fills, dumps; see PCfrSolver::SetTraceRecorder) from every thread that
+// runs them, for viewing in chrome://tracing or Perfetto. Each thread
+// writes into its own fixed-size ring buffer, registered the first time
+// the thread records, so recording never locks and never allocates
+// afterwards; once a ring is full its oldest spans are overwritten.
+class TraceRecorder {
+ public:
+  // One completed span. 'name' and 'category' must outlive the recorder
+  // (string literals).
+  struct Event {
+    const char* name = nullptr;
+    const char* category = nullptr;
+    int64_t start_ns = 0; // Since the recorder was created
+    int64_t duration_ns = 0;
+    int64_t arg = -1; // Shown as args.value when not negative
+  };
+
+  // Keeps the last 'events_per_thread' spans of each thread.
+  // Throws:
+  //   std::invalid_argument if events_per_thread is 0.
+  explicit TraceRecorder(size_t events_per_thread = 1 << 16);
+
+  TraceRecorder(const TraceRecorder&) = delete;
+  TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+  // Nanoseconds since the recorder was created.
+  int64_t Now() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin_).count();
+  }
+
+  // Appends a span to the calling thread's ring.
+  void Record(const char* name, const char* category, int64_t start_ns, int64_t end_ns, int64_t arg = -1);
+
+  // Writes every recorded span as Chrome trace JSON ({"traceEvents":
+  // [...]}, complete "X" events in microseconds, one tid per recording
+  // thread). Must not run while other threads record.
+  void WriteChromeTrace(std::ostream& out) const;
+  // Throws std::runtime_error if 'path' cannot be written.
+  void WriteChromeTrace(const std::string& path) const;
+
+  // Spans overwritten because a ring was full.
+  uint64_t Overwritten() const;
+
+ private:
+  struct alignas(64) Ring {
+    std::vector<Event> events;
+    std::atomic<uint64_t> written{0}; // Total appended; only its thread writes
+    std::thread::id owner;
+  };
+
+  Ring& ForCurrentThread();
+
+  const uint64_t id_; // Distinguishes recorders reusing an address
+  const size_t events_per_thread_;
+  const std::chrono::steady_clock::time_point origin_;
+  mutable std::mutex mutex_; // Guards rings_ (registration and reads)
+  std::vector<std::unique_ptr<Ring>> rings_;
+};
+
+// Records a span from construction to destruction. Does nothing if the
+// recorder is null, so untraced code pays one branch.
+class TraceSpan {
+ public:
+  TraceSpan(TraceRecorder* recorder, const char* name, const char* category, int64_t arg = -1)
+      : recorder_(recorder), name_(name), category_(category), arg_(arg),
+        start_ns_(recorder ? recorder->Now() : 0) {}
+  ~TraceSpan() {
+    if (recorder_) recorder_->Record(name_, category_, start_ns_, recorder_->Now(), arg_);
+  }
+
+ private:
+  TraceRecorder* recorder_;
+  const char* name_;
+  const char* category_;
+  int64_t arg_;
+  int64_t start_ns_;
+
+  TraceSpan(const TraceSpan&) = delete;
+  TraceSpan& operator=(const TraceSpan&) = delete;
+};
+
+} // namespace solver
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_SOLVER_TRACE_RECORDER_H_
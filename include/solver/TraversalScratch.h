@@ -0,0 +1,132 @@
+#ifndef POKER_SOLVER_SOLVER_TRAVERSAL_SCRATCH_H_
+#define POKER_SOLVER_SOLVER_TRAVERSAL_SCRATCH_H_
+
+#include "ranges/RiverCombs.h" // For PackedRiverCombos
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace poker_solver {
+namespace solver {
+
+// Reach of both players at a node, hand-indexed like each player's range.
+// Points into a TraversalScratch level (or the solver's root reach); never owned.
+using ReachPointers = std::array<const double*, 2>;
+
+// Sum of each ReachPointers vector, carried alongside it down the traversal.
+using ReachSums = std::array<double, 2>;
+
+// Per-player utility outputs of a traversal, hand-indexed like each range.
+// A null entry means that player's utility is not being computed.
+using UtilityPointers = std::array<double*, 2>;
+
+// Per-thread stack of reusable buffers for the recursive CFR traversal.
+//
+// Each recursion depth owns one Level. A node at depth d writes the reach it
+// passes to its children, and the utilities it gets back, into Level(d); the
+// children use Level(d + 1) and up. Buffers only ever grow (std::vector
+// capacity is kept), so after the first iteration has touched every depth the
+// traversal performs no heap allocation.
+//
+// Instances are per OS thread (see ForCurrentThread), so a worker that picks
+// up a chance outcome inside an OpenMP region continues on its own stack.
+class TraversalScratch {
+ public:
+  struct Level {
+    // Reach handed to the children of this level, one buffer per player.
+    std::array<std::vector<double>, 2> reach;
+    // Action nodes: child utilities per player, action-major (a * hands + h).
+    std::array<std::vector<double>, 2> child_utility;
+    // Action nodes: the acting player's current strategy, for trainables that
+    // do not cache it (see Trainable::CurrentStrategy).
+    std::vector<double> strategy;
+    // Action nodes: regrets and reach weights handed to the trainable.
+    std::vector<double> regrets;
+    std::vector<double> reach_weights;
+    // Chance nodes on boards missing from the solver's deal table: board
+    // masks of the dealt outcomes.
+    std::vector<uint64_t> outcomes;
+    // Chance nodes under public chance sampling: the outcomes drawn.
+    std::vector<uint64_t> sampled_outcomes;
+    // Chance nodes: per-player utility of the outcome being evaluated by this thread.
+    std::array<std::vector<double>, 2> utility;
+    // Chance nodes: per-player sum of the outcome utilities this thread evaluated.
+    std::array<std::vector<double>, 2> outcome_sum;
+    // Chance nodes in task mode or fanning out over threads: per player, one
+    // utility row per outcome, summed in outcome order once all are done.
+    std::array<std::vector<double>, 2> outcome_utility;
+    // Chance nodes fanning out over threads: whether each outcome was
+    // evaluated (and so its row written).
+    std::vector<uint8_t> outcome_evaluated;
+    // Chance nodes dealing straight into a showdown (see
+    // PCfrSolver::cfr_showdown_runout and cfr_two_card_runout): the
+    // outcomes evaluated, their boards, each player's reach left on them
+    // and combos, and the batch pointers handed to the showdown backend.
+    // Two-card runouts also keep each player's reach holding each card.
+    struct Runout {
+      std::vector<size_t> outcomes;
+      std::array<std::vector<double>, 2> held_reach;
+      std::vector<uint64_t> boards;
+      std::vector<std::array<double, 2>> reach_left;
+      std::array<std::vector<std::shared_ptr<const ranges::PackedRiverCombos>>, 2> combos;
+      std::vector<uint64_t> batch_boards;
+      std::array<std::vector<const ranges::PackedRiverCombos*>, 2> batch_combos;
+      std::vector<double*> batch_utility;
+    } runout;
+  };
+
+  TraversalScratch() = default;
+
+  // Returns the level for 'depth', creating it (and any below it) on first use.
+  // References stay valid when deeper levels are added later.
+  Level& At(size_t depth);
+
+  // Number of levels created so far.
+  size_t Depth() const { return levels_.size(); }
+
+  // Upper bound of one level's buffers once used by action nodes with up
+  // to 'max_actions' actions and chance nodes with up to 'max_outcomes'
+  // outcomes, for ranges of 'num_hands' hands. Buffers are assumed sized
+  // to fit; a stack holds one level per tree depth.
+  static size_t LevelBytes(const std::array<size_t, 2>& num_hands, size_t max_actions, size_t max_outcomes);
+
+  // Scratch stack of the calling thread, or of the task it is running (see
+  // TaskScope).
+  static TraversalScratch& ForCurrentThread();
+
+  // Gives an OpenMP task its own scratch stack for its lifetime.
+  //
+  // A thread waiting in taskwait may run an unrelated task, which would
+  // otherwise reuse the levels its suspended frames still hold. Stacks are
+  // recycled through a process-wide pool, so after warm-up no new ones are
+  // created.
+  class TaskScope {
+   public:
+    TaskScope();
+    ~TaskScope();
+
+   private:
+    std::unique_ptr<TraversalScratch> scratch_;
+    TraversalScratch* previous_;
+
+    TaskScope(const TaskScope&) = delete;
+    TaskScope& operator=(const TaskScope&) = delete;
+  };
+
+ private:
+  std::vector<std::unique_ptr<Level>> levels_;
+
+  // Deleted copy/move operations.
+  TraversalScratch(const TraversalScratch&) = delete;
+  TraversalScratch& operator=(const TraversalScratch&) = delete;
+  TraversalScratch(TraversalScratch&&) = delete;
+  TraversalScratch& operator=(TraversalScratch&&) = delete;
+};
+
+} // namespace solver
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_SOLVER_TRAVERSAL_SCRATCH_H_
@@ -0,0 +1,154 @@
+#ifndef POKER_SOLVER_SOLVER_TRAVERSAL_STATS_H_
+#define POKER_SOLVER_SOLVER_TRAVERSAL_STATS_H_
+
+#include "nodes/GameTreeNode.h" // For GameTreeNodeType, GameRound
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <json.hpp>
+
+namespace poker_solver {
+namespace solver {
+
+// Whether the CFR traversal records TraversalStats. Set by the CMake option
+// POKER_SOLVER_TRAVERSAL_STATS; when off, TraversalStatsScope compiles to
+// nothing and the solver's stats stay zero.
+#ifdef POKER_SOLVER_TRAVERSAL_STATS
+constexpr bool kTraversalStatsEnabled = true;
+#else
+constexpr bool kTraversalStatsEnabled = false;
+#endif
+
+// Work done at the nodes of one type on one street.
+struct NodeWorkStats {
+  uint64_t visits = 0;
+  uint64_t hands = 0;       // Hands whose utility the visits computed
+  uint64_t nanoseconds = 0; // Time in the nodes themselves, not their children
+
+  NodeWorkStats& operator+=(const NodeWorkStats& other) {
+    visits += other.visits;
+    hands += other.hands;
+    nanoseconds += other.nanoseconds;
+    return *this;
+  }
+};
+
+// Training traversal work by node type and street, summed over threads.
+// Times are thread time: on several threads they add up to more than the
+// wall time, and a chance node that hands its outcomes to other threads
+// counts the time it waits for them. Comparing the node types shows whether
+// a spot is bound by showdowns, chance nodes (dealing and summing outcomes)
+// or action nodes (regret updates).
+struct TraversalStats {
+  static constexpr size_t kNumNodeTypes = 4; // core::GameTreeNodeType
+  static constexpr size_t kNumRounds = 4;    // core::GameRound
+
+  int iterations = 0; // Training iterations covered
+  std::array<std::array<NodeWorkStats, kNumRounds>, kNumNodeTypes> nodes{};
+
+  NodeWorkStats& At(core::GameTreeNodeType type, core::GameRound round) {
+    return nodes[static_cast<size_t>(type)][static_cast<size_t>(round)];
+  }
+  const NodeWorkStats& At(core::GameTreeNodeType type, core::GameRound round) const {
+    return nodes[static_cast<size_t>(type)][static_cast<size_t>(round)];
+  }
+  // All streets of one node type.
+  NodeWorkStats Total(core::GameTreeNodeType type) const;
+  // Every node.
+  NodeWorkStats Total() const;
+
+  TraversalStats& operator+=(const TraversalStats& other);
+
+  // {"iterations": n, "total": {...}, "action": {"total": {...}, "flop":
+  // {...}, ...}, "chance": ..., "showdown": ..., "terminal": ...}, each
+  // entry {"visits", "hands", "nanoseconds"}; streets without visits are
+  // left out.
+  nlohmann::json ToJson() const;
+};
+
+// Collects TraversalStats from the threads of one solver's traversals.
+// Each thread records into its own buffer, registered with the collector
+// the first time the thread records for it, so recording never locks or
+// shares a cache line. Collect() must not run while a traversal does.
+class TraversalStatsCollector {
+ public:
+  TraversalStatsCollector();
+
+  // The calling thread's buffer.
+  TraversalStats& ForCurrentThread();
+
+  // Sum of every thread's buffer since the last Collect; resets them.
+  TraversalStats Collect();
+
+  // Per-thread bookkeeping of TraversalStatsScope: time spent so far in the
+  // children of the node being timed on this thread.
+  struct ThreadClock {
+    uint64_t child_nanoseconds = 0;
+  };
+  static ThreadClock& CurrentThreadClock();
+
+ private:
+  struct alignas(64) Buffer {
+    TraversalStats stats;
+    std::thread::id owner;
+  };
+
+  const uint64_t id_; // Distinguishes collectors reusing an address
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<Buffer>> buffers_;
+};
+
+// Records one node visit for the duration of its scope: a visit, the hands
+// computed and the time spent in the node minus its children (nested scopes
+// on the same thread, including OpenMP tasks a waiting thread runs).
+#ifdef POKER_SOLVER_TRAVERSAL_STATS
+class TraversalStatsScope {
+ public:
+  // Records nothing if 'collector' is null.
+  TraversalStatsScope(TraversalStatsCollector* collector, core::GameTreeNodeType type, core::GameRound round,
+                      size_t hands)
+      : collector_(collector) {
+    if (!collector_) return;
+    entry_ = &collector_->ForCurrentThread().At(type, round);
+    ++entry_->visits;
+    entry_->hands += hands;
+    TraversalStatsCollector::ThreadClock& clock = TraversalStatsCollector::CurrentThreadClock();
+    saved_child_nanoseconds_ = clock.child_nanoseconds;
+    clock.child_nanoseconds = 0;
+    start_ = std::chrono::steady_clock::now();
+  }
+
+  ~TraversalStatsScope() {
+    if (!collector_) return;
+    const uint64_t elapsed = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count());
+    TraversalStatsCollector::ThreadClock& clock = TraversalStatsCollector::CurrentThreadClock();
+    entry_->nanoseconds += elapsed > clock.child_nanoseconds ? elapsed - clock.child_nanoseconds : 0;
+    clock.child_nanoseconds = saved_child_nanoseconds_ + elapsed;
+  }
+
+ private:
+  TraversalStatsCollector* collector_;
+  NodeWorkStats* entry_ = nullptr;
+  uint64_t saved_child_nanoseconds_ = 0;
+  std::chrono::steady_clock::time_point start_;
+
+  TraversalStatsScope(const TraversalStatsScope&) = delete;
+  TraversalStatsScope& operator=(const TraversalStatsScope&) = delete;
+};
+#else
+class TraversalStatsScope {
+ public:
+  TraversalStatsScope(TraversalStatsCollector*, core::GameTreeNodeType, core::GameRound, size_t) {}
+};
+#endif
+
+} // namespace solver
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_SOLVER_TRAVERSAL_STATS_H_
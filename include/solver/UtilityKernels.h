@@ -0,0 +1,119 @@
+#ifndef POKER_SOLVER_SOLVER_UTILITY_KERNELS_H_
+#define POKER_SOLVER_SOLVER_UTILITY_KERNELS_H_
+
+#include "ranges/RiverCombs.h" // For RiverCombs
+#include "ranges/PrivateCards.h" // For PrivateCards
+#include <vector>
+
+namespace poker_solver {
+namespace solver {
+
+// Leaf utility kernels used by PCfrSolver at showdown and terminal nodes.
+// Kept as free functions so they can be tested and benchmarked in isolation
+// from the recursive traversal.
+
+// Computes showdown utilities for every traverser hand with a single sorted
+// sweep over both river ranges (O(n) per board instead of O(n^2)).
+// Both combo vectors must be in RiverRangeManager order, i.e. sorted by rank
+// descending (worst hand first). Card removal is handled with per-card reach
+// accumulators, so each traverser hand only "sees" opponent hands that do not
+// share a card with it.
+// Args:
+//   traverser_combos: River combos of the traverser (sorted, worst first).
+//   opponent_combos: River combos of the opponent (sorted, worst first).
+//   traverser_hands: Size of the traverser's range. A hand's counterfactual
+//                    utility does not depend on its own reach, so the
+//                    traverser's reach is not an input.
+//   opponent_reach: Opponent reach, indexed by original range index.
+//   win_payoff: Traverser payoff when its hand is stronger.
+//   lose_payoff: Traverser payoff when the opponent's hand is stronger.
+//   tie_payoff: Traverser payoff when the hands are equal.
+// Returns:
+//   Utility vector indexed by traverser original range index
+//   (size traverser_hands). Hands blocked by the board stay at 0.
+// Throws:
+//   std::out_of_range if a traverser combo's original_range_index is not
+//   below traverser_hands, or an opponent one is outside opponent_reach.
+std::vector<double> ShowdownUtilitySweep(
+    const std::vector<ranges::RiverCombs>& traverser_combos,
+    const std::vector<ranges::RiverCombs>& opponent_combos,
+    size_t traverser_hands,
+    const std::vector<double>& opponent_reach,
+    double win_payoff,
+    double lose_payoff,
+    double tie_payoff);
+
+// Raw-buffer form of ShowdownUtilitySweep: reads a raw opponent reach
+// buffer and writes all 'traverser_hands' entries of 'utility'. Packs the
+// combos first; same preconditions and exceptions as the vector overload.
+void ShowdownUtilitySweep(
+    const std::vector<ranges::RiverCombs>& traverser_combos,
+    const std::vector<ranges::RiverCombs>& opponent_combos,
+    size_t traverser_hands,
+    const double* opponent_reach, size_t opponent_hands,
+    double win_payoff,
+    double lose_payoff,
+    double tie_payoff,
+    double* utility);
+
+// Allocation-free form used by the traversal, streaming the packed combos
+// RiverRangeManager caches. Equal-rank runs are handled together, so the
+// opponent pointers only move between runs. Same preconditions and
+// exceptions as the vector overload.
+void ShowdownUtilitySweep(
+    const ranges::PackedRiverCombos& traverser_combos,
+    const ranges::PackedRiverCombos& opponent_combos,
+    size_t traverser_hands,
+    const double* opponent_reach, size_t opponent_hands,
+    double win_payoff,
+    double lose_payoff,
+    double tie_payoff,
+    double* utility);
+
+// Computes fold (terminal) utilities: for every traverser hand, the payoff
+// times the total reach of opponent hands that share no card with it.
+// Uses one pass to build 52 per-card reach buckets and derives each hand's
+// compatible reach by inclusion-exclusion, so the cost is O(n).
+// Args:
+//   traverser_range / opponent_range: Hands of each player.
+//   opponent_reach: Reach per opponent hand, same size as opponent_range.
+//                   The traverser's own reach does not enter a fold payoff.
+//   payoff: Traverser payoff at this terminal node (already scaled as desired).
+// Returns:
+//   Utility vector indexed like traverser_range.
+// Throws:
+//   std::invalid_argument if opponent_reach's size does not match its range.
+std::vector<double> FoldUtilityLinear(
+    const std::vector<core::PrivateCards>& traverser_range,
+    const std::vector<core::PrivateCards>& opponent_range,
+    const std::vector<double>& opponent_reach,
+    double payoff);
+
+// Allocation-free form of FoldUtilityLinear; opponent_reach is sized like
+// opponent_range and 'utility' receives traverser_range.size() values.
+void FoldUtilityLinear(
+    const std::vector<core::PrivateCards>& traverser_range,
+    const std::vector<core::PrivateCards>& opponent_range,
+    const double* opponent_reach,
+    double payoff,
+    double* utility);
+
+// Reference O(n^2) version of FoldUtilityLinear that checks every hand pair.
+// Kept for validation and benchmarking; same arguments and results.
+std::vector<double> FoldUtilityPairwise(
+    const std::vector<core::PrivateCards>& traverser_range,
+    const std::vector<core::PrivateCards>& opponent_range,
+    const std::vector<double>& opponent_reach,
+    double payoff);
+
+void FoldUtilityPairwise(
+    const std::vector<core::PrivateCards>& traverser_range,
+    const std::vector<core::PrivateCards>& opponent_range,
+    const double* opponent_reach,
+    double payoff,
+    double* utility);
+
+} // namespace solver
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_SOLVER_UTILITY_KERNELS_H_
@@ -0,0 +1,51 @@
+#ifndef POKER_SOLVER_SOLVER_VECTOR_KERNELS_H_
+#define POKER_SOLVER_SOLVER_VECTOR_KERNELS_H_
+
+#include <cstddef>
+
+namespace poker_solver {
+namespace solver {
+namespace kernels {
+
+// Per-hand vector kernels used by the CFR traversal. The loops are written so
+// the compiler can vectorize them; on x86-64 Linux builds (GCC/Clang) each
+// kernel is additionally compiled for AVX-512F, AVX2 and a baseline target,
+// and the best clone is picked at load time from the running CPU. Elsewhere
+// (e.g. macOS, AArch64 where NEON is baseline) only the portable build is used.
+//
+// Strategy buffers are hand-major: strategy[h * num_actions + a].
+// Unless noted otherwise, output buffers must not overlap the inputs.
+
+// Returns the name of the instruction set the kernels dispatch to on this
+// machine ("avx512f", "avx2" or "scalar").
+const char* ActiveInstructionSet();
+
+// dst[h] = src[h] * strategy[h * num_actions + action]
+void MultiplyByActionStrategy(double* dst, const double* src,
+                              const double* strategy, size_t num_actions,
+                              size_t action, size_t num_hands);
+
+// dst[h] += strategy[h * num_actions + action] * child_utility[h]
+void AccumulateWeightedByAction(double* dst, const double* strategy,
+                                size_t num_actions, size_t action,
+                                const double* child_utility, size_t num_hands);
+
+// regrets[h * num_actions + action] = child_utility[h] - node_utility[h]
+void StoreActionRegrets(double* regrets, size_t num_actions, size_t action,
+                        const double* child_utility, const double* node_utility,
+                        size_t num_hands);
+
+// dst[h] += src[h]
+void Accumulate(double* dst, const double* src, size_t num_hands);
+
+// dst[h] = src[h] * scale (dst may equal src)
+void Scale(double* dst, const double* src, double scale, size_t num_hands);
+
+// Returns the sum of src[0..num_hands).
+double Sum(const double* src, size_t num_hands);
+
+} // namespace kernels
+} // namespace solver
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_SOLVER_VECTOR_KERNELS_H_
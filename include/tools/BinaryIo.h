@@ -0,0 +1,61 @@
+#ifndef POKER_SOLVER_UTILS_BINARY_IO_H_
+#define POKER_SOLVER_UTILS_BINARY_IO_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace poker_solver {
+namespace utils {
+
+// Raw host-byte-order I/O of trivially copyable values, used by solver
+// checkpoints and rank table files. Both throw std::runtime_error when the stream fails.
+
+template <typename T>
+void WriteRaw(std::ostream& out, const T* data, size_t count) {
+    static_assert(std::is_trivially_copyable<T>::value, "WriteRaw needs trivially copyable values");
+    out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * sizeof(T)));
+    if (!out) throw std::runtime_error("Binary write failed.");
+}
+
+template <typename T>
+void ReadRaw(std::istream& in, T* data, size_t count) {
+    static_assert(std::is_trivially_copyable<T>::value, "ReadRaw needs trivially copyable values");
+    in.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(count * sizeof(T)));
+    if (!in) throw std::runtime_error("Binary read failed: truncated or unreadable data.");
+}
+
+// 64-bit FNV-1a, folded over raw bytes; used for file fingerprints and
+// checksums.
+class Fnv1a {
+ public:
+    template <typename T>
+    void Add(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "Fnv1a needs trivially copyable values");
+        AddBytes(&value, sizeof(T));
+    }
+    void Add(const std::string& text) {
+        Add(text.size());
+        AddBytes(text.data(), text.size());
+    }
+    void AddBytes(const void* data, size_t size) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash_ ^= bytes[i];
+            hash_ *= 1099511628211ULL;
+        }
+    }
+    uint64_t Value() const { return hash_; }
+
+ private:
+    uint64_t hash_ = 14695981039346656037ULL;
+};
+
+} // namespace utils
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_UTILS_BINARY_IO_H_
@@ -0,0 +1,54 @@
+#ifndef POKER_SOLVER_UTILS_COMPRESSION_H_
+#define POKER_SOLVER_UTILS_COMPRESSION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace poker_solver {
+namespace utils {
+
+// Byte-level encoders for compressed checkpoints: an LZ77 block codec and
+// zigzag varints for delta-coded integers.
+
+// Compresses 'size' bytes into 'out' (replacing its contents) as one
+// self-contained block: sequences of a token byte (literal count in the
+// high nibble, match length - 4 in the low one, 15 meaning more follow in
+// 255-capped bytes), the literals, and a 16-bit little-endian back
+// reference; the last sequence has literals only. Greedy, one hash probe
+// per position, so it runs at memory speed rather than ratio.
+void CompressBlock(const uint8_t* data, size_t size, std::vector<uint8_t>& out);
+
+// Inverse of CompressBlock into exactly 'out_size' bytes at 'out'.
+// Throws:
+//   std::runtime_error if the block is corrupt or does not decode to
+//   out_size bytes.
+void DecompressBlock(const uint8_t* data, size_t size, uint8_t* out, size_t out_size);
+
+// Maps signed values onto unsigned ones with small magnitudes first
+// (0, -1, 1, -2, ...), so small deltas of either sign make short varints.
+inline uint64_t ZigZagEncode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+inline int64_t ZigZagDecode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// LEB128: 7 bits per byte, low bits first, high bit set on all but the last.
+inline void AppendVarint(uint64_t value, std::vector<uint8_t>& out) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// Reads a varint at 'cursor', advancing it.
+// Throws:
+//   std::runtime_error if it runs past 'end' or over 64 bits.
+uint64_t ReadVarint(const uint8_t*& cursor, const uint8_t* end);
+
+} // namespace utils
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_UTILS_COMPRESSION_H_
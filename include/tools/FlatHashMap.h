@@ -0,0 +1,184 @@
+#ifndef POKER_SOLVER_HASHING_FLAT_HASH_MAP_H_
+#define POKER_SOLVER_HASHING_FLAT_HASH_MAP_H_
+
+#include "tools/lookup8.h" // For HashWord
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace poker_solver {
+namespace hashing {
+
+// Open-addressing hash map from 64-bit keys (card and board masks, rank
+// hashes) to 'V', for the board-keyed caches. Slots live in one
+// power-of-two array probed linearly from HashWord(key), so a lookup is
+// one hash plus a short scan of adjacent slots instead of a walk down a
+// bucket's node chain. The table doubles once it is a quarter full, which
+// keeps misses (the river cache's common case) to about one extra probe,
+// and erase shifts later entries back instead of leaving tombstones.
+//
+// kEmptyKey (all bits set; no card mask has it) marks a free slot and
+// cannot be inserted. Inserts and erases invalidate iterators and
+// pointers to values, like rehashing in std::unordered_map; 'V' must be
+// default-constructible and movable. Not thread-safe.
+template <typename V>
+class FlatHashMap {
+ public:
+  using value_type = std::pair<uint64_t, V>;
+  static constexpr uint64_t kEmptyKey = ~0ULL;
+
+  template <typename Slot>
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = FlatHashMap::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Slot*;
+    using reference = Slot&;
+
+    Iterator(Slot* slot, Slot* end) : slot_(slot), end_(end) { SkipEmpty(); }
+    reference operator*() const { return *slot_; }
+    pointer operator->() const { return slot_; }
+    Iterator& operator++() {
+      ++slot_;
+      SkipEmpty();
+      return *this;
+    }
+    bool operator==(const Iterator& other) const { return slot_ == other.slot_; }
+    bool operator!=(const Iterator& other) const { return slot_ != other.slot_; }
+
+   private:
+    void SkipEmpty() {
+      while (slot_ != end_ && slot_->first == kEmptyKey) ++slot_;
+    }
+    Slot* slot_;
+    Slot* end_;
+  };
+  using iterator = Iterator<value_type>;
+  using const_iterator = Iterator<const value_type>;
+
+  FlatHashMap() = default;
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // Removes every entry; the table keeps its capacity.
+  void clear() {
+    for (value_type& slot : slots_) slot = value_type(kEmptyKey, V());
+    size_ = 0;
+  }
+
+  // Grows the table so 'count' entries fit without rehashing.
+  void reserve(size_t count) {
+    size_t capacity = slots_.empty() ? kMinCapacity : slots_.size();
+    while (capacity < 4 * count) capacity *= 2;
+    if (capacity != slots_.size()) Rehash(capacity);
+  }
+
+  // Returns the value of 'key', or null if it is absent.
+  V* find(uint64_t key) {
+    const size_t slot = FindSlot(key);
+    return slot == kNotFound ? nullptr : &slots_[slot].second;
+  }
+  const V* find(uint64_t key) const {
+    const size_t slot = FindSlot(key);
+    return slot == kNotFound ? nullptr : &slots_[slot].second;
+  }
+  bool contains(uint64_t key) const { return FindSlot(key) != kNotFound; }
+
+  // Returns the value of 'key'.
+  // Throws:
+  //   std::out_of_range if it is absent.
+  V& at(uint64_t key) {
+    V* value = find(key);
+    if (!value) throw std::out_of_range("FlatHashMap::at: key not found.");
+    return *value;
+  }
+
+  // Inserts 'value' under 'key' unless the key is present. Returns the
+  // key's value and whether it was inserted.
+  // Throws:
+  //   std::invalid_argument if key is kEmptyKey.
+  std::pair<V*, bool> try_emplace(uint64_t key, V value = V()) {
+    if (key == kEmptyKey) throw std::invalid_argument("FlatHashMap: the empty key cannot be inserted.");
+    if (4 * (size_ + 1) > slots_.size()) reserve(size_ + 1);
+    const uint64_t mask = slots_.size() - 1;
+    size_t slot = HashWord(key) & mask;
+    while (slots_[slot].first != kEmptyKey) {
+      if (slots_[slot].first == key) return {&slots_[slot].second, false};
+      slot = (slot + 1) & mask;
+    }
+    slots_[slot] = value_type(key, std::move(value));
+    ++size_;
+    return {&slots_[slot].second, true};
+  }
+
+  // The value of 'key', default-constructed first if absent.
+  V& operator[](uint64_t key) { return *try_emplace(key).first; }
+
+  // Removes 'key'. Returns whether it was present.
+  bool erase(uint64_t key) {
+    size_t hole = FindSlot(key);
+    if (hole == kNotFound) return false;
+    // Backward-shift deletion: pull each later entry of the probe run into
+    // the hole unless that would move it before its home slot.
+    const uint64_t mask = slots_.size() - 1;
+    for (size_t next = (hole + 1) & mask; slots_[next].first != kEmptyKey; next = (next + 1) & mask) {
+      const size_t home = HashWord(slots_[next].first) & mask;
+      if (((next - home) & mask) >= ((next - hole) & mask)) {
+        slots_[hole] = std::move(slots_[next]);
+        hole = next;
+      }
+    }
+    slots_[hole] = value_type(kEmptyKey, V());
+    --size_;
+    return true;
+  }
+
+  iterator begin() { return iterator(slots_.data(), slots_.data() + slots_.size()); }
+  iterator end() { return iterator(slots_.data() + slots_.size(), slots_.data() + slots_.size()); }
+  const_iterator begin() const { return const_iterator(slots_.data(), slots_.data() + slots_.size()); }
+  const_iterator end() const {
+    return const_iterator(slots_.data() + slots_.size(), slots_.data() + slots_.size());
+  }
+
+  // Bytes of the slot array (not of anything the values own).
+  size_t MemoryBytes() const { return slots_.capacity() * sizeof(value_type); }
+
+ private:
+  static constexpr size_t kMinCapacity = 16;
+  static constexpr size_t kNotFound = ~static_cast<size_t>(0);
+
+  size_t FindSlot(uint64_t key) const {
+    if (slots_.empty() || key == kEmptyKey) return kNotFound;
+    const uint64_t mask = slots_.size() - 1;
+    for (size_t slot = HashWord(key) & mask; slots_[slot].first != kEmptyKey; slot = (slot + 1) & mask) {
+      if (slots_[slot].first == key) return slot;
+    }
+    return kNotFound;
+  }
+
+  void Rehash(size_t capacity) {
+    std::vector<value_type> old(capacity, value_type(kEmptyKey, V()));
+    old.swap(slots_);
+    const uint64_t mask = capacity - 1;
+    for (value_type& entry : old) {
+      if (entry.first == kEmptyKey) continue;
+      size_t slot = HashWord(entry.first) & mask;
+      while (slots_[slot].first != kEmptyKey) slot = (slot + 1) & mask;
+      slots_[slot] = std::move(entry);
+    }
+  }
+
+  std::vector<value_type> slots_; // Power-of-two size, or empty
+  size_t size_ = 0;
+};
+
+} // namespace hashing
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_HASHING_FLAT_HASH_MAP_H_
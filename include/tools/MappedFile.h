@@ -0,0 +1,42 @@
+#ifndef POKER_SOLVER_UTILS_MAPPED_FILE_H_
+#define POKER_SOLVER_UTILS_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace poker_solver {
+namespace utils {
+
+// Read-only view of a whole file. On POSIX systems the file is mmap'ed, so
+// its pages come from (and are shared through) the OS page cache; elsewhere
+// it is read into memory. Data() is page aligned when mapped.
+class MappedFile {
+ public:
+  // Throws:
+  //   std::runtime_error if the file cannot be opened, mapped or read.
+  explicit MappedFile(const std::string& path);
+  ~MappedFile();
+
+  const unsigned char* Data() const { return data_; }
+  size_t Size() const { return size_; }
+  // True when Data() points into a mapping rather than a private copy.
+  bool IsMapped() const { return mapped_; }
+
+ private:
+  const unsigned char* data_ = nullptr;
+  size_t size_ = 0;
+  bool mapped_ = false;
+  std::vector<unsigned char> buffer_; // Used when not mapped
+
+  // Deleted copy/move operations.
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&&) = delete;
+  MappedFile& operator=(MappedFile&&) = delete;
+};
+
+} // namespace utils
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_UTILS_MAPPED_FILE_H_
@@ -7,6 +7,8 @@
 #include <string>
 #include <string_view>
 #include <stdexcept> // For exceptions
+#include <memory>    // For std::shared_ptr
+#include <cstdint>
 
 namespace poker_solver {
 namespace ranges {
@@ -35,10 +37,32 @@ class PrivateRangeConverter {
       std::string_view range_string,
       const std::vector<int>& initial_board_ints = {});
 
+  // Immutable parsed range, shared between all callers asking for it.
+  using SharedRange = std::shared_ptr<const std::vector<core::PrivateCards>>;
+
+  // Interned variant of StringToPrivateCards: ranges are cached process-wide
+  // by (range string, initial board mask), so repeated setups from the same
+  // canonical ranges parse each string once. Thread-safe. Invalid strings
+  // throw exactly as StringToPrivateCards does and are not cached.
+  static SharedRange GetSharedRange(
+      std::string_view range_string,
+      const std::vector<int>& initial_board_ints = {});
+
+  // Number of interned ranges.
+  static size_t GetRangeCacheSize();
+
+  // Drops every interned range. Ranges already handed out stay valid.
+  static void ClearRangeCache();
+
  private:
    // Prevent instantiation - static methods only.
    PrivateRangeConverter() = delete;
 
+   // Parses the whole range string against an already-built board mask.
+   static std::vector<core::PrivateCards> ParseRangeString(
+       std::string_view range_string,
+       uint64_t initial_board_mask);
+
    // Helper to parse a single range component (e.g., "AKs", "QQ:0.5").
    // Adds the generated PrivateCards to the output vector.
    static void ParseRangeComponent(
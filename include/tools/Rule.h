@@ -41,10 +41,16 @@ class Rule {
   double GetAllInThresholdRatio() const { return all_in_threshold_ratio_; }
   double GetInitialPot() const;
   double GetInitialCommitment(size_t player_index) const;
+  // Depth-limited trees stop at the end of the starting street: a chance
+  // node that would lead to more betting is built without a child and
+  // valued by PCfrSolver's leaf value estimator. All-in runouts are kept.
+  bool IsDepthLimited() const { return depth_limited_; }
 
   // --- Modifiers ---
   void SetInitialOopCommit(double amount) { initial_oop_commit_ = amount; }
   void SetInitialIpCommit(double amount) { initial_ip_commit_ = amount; }
+  void SetBuildSettings(const GameTreeBuildingSettings& settings) { build_settings_ = settings; }
+  void SetDepthLimited(bool depth_limited) { depth_limited_ = depth_limited; }
 
  private:
   core::Deck deck_;
@@ -58,6 +64,7 @@ class Rule {
   double initial_effective_stack_;
   GameTreeBuildingSettings build_settings_;
   double all_in_threshold_ratio_;
+  bool depth_limited_ = false;
 
   const std::vector<size_t> players_ = {0, 1};
 };
@@ -0,0 +1,71 @@
+#ifndef POKER_SOLVER_CONFIG_SCENARIO_FILE_H_
+#define POKER_SOLVER_CONFIG_SCENARIO_FILE_H_
+
+#include "Deck.h"                            // For Deck
+#include "tools/Rule.h"                      // For Rule
+#include "tools/StreetSetting.h"             // For StreetSetting
+#include <json.hpp>                          // For nlohmann::json
+#include <array>
+#include <string>
+
+namespace poker_solver {
+namespace config {
+
+// A spot to solve as described by a scenario file, e.g.
+// test_data/simple_flop_scenario.json:
+//
+//   {
+//     "test_case_name": "...",           (optional)
+//     "description": "...",              (optional)
+//     "solver_config": {"iterations": 100, "threads": 8},   (optional)
+//     "game_rule": {
+//       "starting_round": "Flop",        Preflop / Flop / Turn / River
+//       "initial_commitments": {"ip": 15, "oop": 15},       (default 0)
+//       "blinds": {"sb": 1, "bb": 2},                       (default 0)
+//       "effective_stack": 100,
+//       "raise_limit_per_street": 1,
+//       "all_in_threshold_ratio": 0.67,  (default 0.98)
+//       "depth_limited": true,           (default false; see Rule::IsDepthLimited)
+//       "initial_board": ["Ts", "Jh", "2h"],
+//       "building_settings": {           (optional) flop_ip ... river_oop, each
+//         "flop_ip": {"bet_sizes_percent": [33], "raise_sizes_percent": [50],
+//                     "donk_sizes_percent": [], "allow_all_in": false}, ...}
+//     },
+//     "player_ranges": {"ip": "KJs,AKo", "oop": "66,77"}
+//   }
+struct Scenario {
+  std::string name;
+  std::string description;
+  Rule rule;
+  // Range strings (PrivateRangeConverter syntax) of player 0 (IP) and 1 (OOP).
+  std::array<std::string, 2> ranges;
+  // "solver_config" values; 0 where the file has none.
+  int iterations = 0;
+  int threads = 0;
+};
+
+// Street setting from its JSON object; missing lists are empty and
+// "allow_all_in" defaults to false.
+StreetSetting StreetSettingFromJson(const nlohmann::json& j_setting);
+
+// Rule from a scenario's "game_rule" object.
+// Throws:
+//   std::invalid_argument on an unknown starting round, a bad board card or
+//                         missing required keys.
+Rule RuleFromJson(const nlohmann::json& j_rule, const core::Deck& deck);
+
+// Parses a whole scenario object.
+// Throws:
+//   std::invalid_argument as RuleFromJson, or without "player_ranges".
+Scenario ScenarioFromJson(const nlohmann::json& j_scenario, const core::Deck& deck);
+
+// Reads and parses a scenario file.
+// Throws:
+//   std::runtime_error if the file cannot be read or is not valid JSON.
+//   std::invalid_argument as ScenarioFromJson.
+Scenario LoadScenarioFile(const std::string& path, const core::Deck& deck);
+
+} // namespace config
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_CONFIG_SCENARIO_FILE_H_
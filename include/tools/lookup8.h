@@ -53,6 +53,16 @@ inline void mix(uint64_t& a, uint64_t& b, uint64_t& c) {
 //   A 64-bit hash value.
 uint64_t lookup8_hash(const uint8_t* key, size_t length, uint64_t initval = 0);
 
+// lookup8_hash of a single 64-bit word (its 8 little-endian bytes),
+// inlined for hash tables keyed by card masks (see FlatHashMap).
+inline uint64_t HashWord(uint64_t key, uint64_t initval = 0) {
+  uint64_t a = initval + key;
+  uint64_t b = initval;
+  uint64_t c = 0x9e3779b97f4a7c13ULL + sizeof(key); // Golden ratio plus the length
+  mix(a, b, c);
+  return c;
+}
+
 // Note: The original C code included hash2() and hash3() which were faster
 // but less portable (requiring aligned uint64_t arrays or specific
 // endianness). They are omitted here for better C++ practice and portability.
@@ -7,8 +7,7 @@
 #include <stdexcept> // For std::runtime_error, std::invalid_argument, std::out_of_range
 #include <numeric>   // For std::iota (potentially useful for index mapping)
 #include <algorithm> // For std::swap
-#include <unordered_map> // For hash map
-#include <functional>    // For std::hash
+#include <cstdint>
 
 namespace poker_solver {
 namespace utils {
@@ -32,14 +31,11 @@ void ExchangeColorIsomorphism(std::vector<T>& value,
     }
 
     size_t range_size = range.size();
-    // Map from the PrivateCards object itself back to its original index.
-    std::unordered_map<core::PrivateCards, size_t, std::hash<core::PrivateCards>>
-        hand_to_original_index;
-    hand_to_original_index.reserve(range_size);
-
+    // Dense combo index -> first index of that hand in the range (-1: absent).
+    std::vector<int32_t> combo_to_original_index(core::kNumHandCombos, -1);
     for (size_t i = 0; i < range_size; ++i) {
-         // Map the hand object to its first encountered index
-         hand_to_original_index.try_emplace(range[i], i);
+         int32_t& slot = combo_to_original_index[range[i].GetComboIndex()];
+         if (slot < 0) slot = static_cast<int32_t>(i);
     }
 
     // Vector to track which indices have already been swapped.
@@ -70,23 +66,12 @@ void ExchangeColorIsomorphism(std::vector<T>& value,
             continue;
         }
 
-        core::PrivateCards isomorphic_hand;
-        try {
-             isomorphic_hand = core::PrivateCards(c1_iso, c2_iso, original_hand.Weight());
-        } catch (const std::invalid_argument& ) {
-             // This can happen if c1_iso == c2_iso after suit swapping,
-             // which means the original hand didn't have a distinct isomorphic partner
-             // with these particular suit swaps (e.g. swapping c->d on AcAd when board doesn't block).
-             // Or if the resulting card ints become invalid (less likely with just suit swap).
-             swapped[i] = true;
-             continue;
-        }
-
-        // Find the original index of this isomorphic hand using the object map
-        auto it = hand_to_original_index.find(isomorphic_hand);
+        // Find the original index of this isomorphic hand in the dense table.
+        // A suit swap keeps two distinct cards distinct, so the combo is valid.
+        int32_t partner = combo_to_original_index[core::ComboIndex(c1_iso, c2_iso)];
 
-        if (it != hand_to_original_index.end()) {
-            size_t j = it->second; // Index of the isomorphic partner hand
+        if (partner >= 0) {
+            size_t j = static_cast<size_t>(partner); // Index of the isomorphic partner hand
 
             // Only swap if i < j to handle duplicates cleanly and ensure each pair is swapped once.
             // And ensure partner hasn't been involved in a swap initiated by itself (covered by swapped[j]).
@@ -131,6 +116,39 @@ void ExchangeColorIsomorphism(std::vector<T>& value,
     }
 }
 
+// Returns, for every hand in 'range', the index of the hand obtained by
+// exchanging suits 'suit_index1' and 'suit_index2', or -1 if that hand is
+// missing or has a different weight. Unlike ExchangeColorIsomorphism this
+// builds the mapping once so hot loops can gather through it.
+inline std::vector<int> ColorIsomorphismPermutation(const std::vector<core::PrivateCards>& range,
+                                                    int suit_index1, int suit_index2) {
+    if (suit_index1 < 0 || suit_index1 >= core::kNumSuits ||
+        suit_index2 < 0 || suit_index2 >= core::kNumSuits) {
+         throw std::out_of_range("Invalid suit index provided to ColorIsomorphismPermutation.");
+    }
+    auto swap_suit = [=](int card) {
+        int suit = card % core::kNumSuits;
+        if (suit == suit_index1) return card - suit_index1 + suit_index2;
+        if (suit == suit_index2) return card - suit_index2 + suit_index1;
+        return card;
+    };
+
+    std::vector<int32_t> combo_to_index(core::kNumHandCombos, -1);
+    for (size_t i = 0; i < range.size(); ++i) {
+        int32_t& slot = combo_to_index[range[i].GetComboIndex()];
+        if (slot < 0) slot = static_cast<int32_t>(i);
+    }
+
+    std::vector<int> permutation(range.size(), -1);
+    for (size_t i = 0; i < range.size(); ++i) {
+        int32_t j = combo_to_index[core::ComboIndex(swap_suit(range[i].Card1Int()),
+                                                    swap_suit(range[i].Card2Int()))];
+        if (j >= 0 && range[j].Weight() == range[i].Weight()) {
+            permutation[i] = static_cast<int>(j);
+        }
+    }
+    return permutation;
+}
 
 } // namespace utils
 } // namespace poker_solver
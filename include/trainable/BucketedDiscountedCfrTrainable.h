@@ -0,0 +1,104 @@
+#ifndef POKER_SOLVER_SOLVER_BUCKETED_DISCOUNTED_CFR_TRAINABLE_H_
+#define POKER_SOLVER_SOLVER_BUCKETED_DISCOUNTED_CFR_TRAINABLE_H_
+
+#include "trainable/Trainable.h"   // Base class interface
+#include "ranges/PrivateCards.h"   // For PrivateCards
+#include "solver/HandAbstraction.h" // For HandBuckets
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <json.hpp>
+
+// Forward declare ActionNode to break potential include cycle
+namespace poker_solver { namespace nodes { class ActionNode; } }
+
+namespace poker_solver {
+namespace solver {
+
+// Double-precision Discounted CFR, like DiscountedCfrTrainable, over hand
+// buckets (HandAbstraction): the hands of a bucket share one row of regrets
+// and strategy sums, so the tables scale with the buckets rather than the
+// range. A visit adds each hand's weighted regrets and reach-weighted
+// strategy into its bucket's row, and every hand plays its bucket's
+// strategy.
+//
+// The interface stays hand-major over the whole range. GetHandState reads a
+// hand's bucket row; SetHandState overwrites it, so of the hands of one
+// bucket the last one set wins. WriteState/ReadState hold the bucket rows
+// alone, so checkpoints only move between trainables with the same
+// buckets. GetCurrentStrategy and GetAverageStrategy fill per-thread
+// buffers, valid until the next such call on the same thread.
+class BucketedDiscountedCfrTrainable : public Trainable {
+ public:
+  // 'buckets' partitions 'player_range' at the node's board.
+  // Throws:
+  //   std::invalid_argument if player_range or buckets is null, or the
+  //   buckets do not cover the range.
+  BucketedDiscountedCfrTrainable(const std::vector<core::PrivateCards>* player_range,
+                                 const nodes::ActionNode& action_node,
+                                 std::shared_ptr<const HandBuckets> buckets);
+
+  ~BucketedDiscountedCfrTrainable() override = default;
+
+  const std::vector<double>& GetCurrentStrategy() const override;
+  const std::vector<double>& GetAverageStrategy() const override;
+
+  void UpdateRegrets(const std::vector<double>& weighted_regrets, int iteration,
+                     double reach_prob_opponent_chance_scalar) override;
+  void AccumulateAverageStrategy(const std::vector<double>& current_strategy,
+                                 int iteration,
+                                 const std::vector<double>& reach_probs_player_chance_vector) override;
+
+  const double* CurrentStrategy(double* scratch) const override;
+  void UpdateFromVisit(const double* weighted_regrets, const double* current_strategy,
+                       const double* reach_weights, const IterationDiscounts& discounts) override;
+
+  void WriteState(std::ostream& out) const override;
+  void ReadState(std::istream& in) override;
+  void GetHandState(size_t hand, double* regrets, double* strategy_sums) const override;
+  void SetHandState(size_t hand, const double* regrets, const double* strategy_sums) override;
+
+  void SetEv(const std::vector<double>& evs) override;
+  json DumpStrategy(bool with_ev) const override;
+  json DumpEvs() const override;
+  std::vector<double> GetEvs() const override;
+
+  // Copies another BucketedDiscountedCfrTrainable of the same dimensions.
+  // Throws:
+  //   std::invalid_argument for other types or dimensions.
+  void CopyStateFrom(const Trainable& other) override;
+
+  size_t NumBuckets() const { return buckets_->num_buckets; }
+
+  // Bytes of the bucket tables (EVs, allocated only on demand, and the
+  // shared bucket map are not included).
+  uint64_t TableBytes() const;
+
+ private:
+  // Regret matching of bucket row 'bucket' into 'out'.
+  void RegretMatchRow(size_t bucket, double* out) const;
+  // Folds per-hand regrets into the bucket rows with 'discounts'.
+  void AddRegrets(const double* weighted_regrets, const IterationDiscounts& discounts);
+
+  const nodes::ActionNode& action_node_;
+  const std::vector<core::PrivateCards>* player_range_; // Not owned
+  std::shared_ptr<const HandBuckets> buckets_;
+  size_t num_actions_;
+  size_t num_hands_;
+  // buckets_->num_buckets * num_actions_ values each, row-major.
+  std::vector<double> cumulative_regrets_;
+  std::vector<double> cumulative_strategy_sum_;
+  std::vector<double> bucket_regret_scratch_;
+  std::vector<double> expected_values_; // Hand-major over the range; empty until SetEv
+
+  BucketedDiscountedCfrTrainable(const BucketedDiscountedCfrTrainable&) = delete;
+  BucketedDiscountedCfrTrainable& operator=(const BucketedDiscountedCfrTrainable&) = delete;
+  BucketedDiscountedCfrTrainable(BucketedDiscountedCfrTrainable&&) = delete;
+  BucketedDiscountedCfrTrainable& operator=(BucketedDiscountedCfrTrainable&&) = delete;
+};
+
+} // namespace solver
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_SOLVER_BUCKETED_DISCOUNTED_CFR_TRAINABLE_H_
@@ -1,117 +1,109 @@
-#ifndef POKERSOLVER_CFRPLUS_H
-#define POKERSOLVER_CFRPLUS_H
+#ifndef POKER_SOLVER_SOLVER_CFR_PLUS_H_
+#define POKER_SOLVER_SOLVER_CFR_PLUS_H_
 
-#include "trainable/Trainable.h"
+#include "trainable/Trainable.h"                     // Base class interface
+#include "trainable/CompactDiscountedCfrTrainable.h" // For the storage policies
+#include "ranges/PrivateCards.h"                     // For PrivateCards
 #include <vector>
-#include <algorithm>
-#include <numeric>
-#include <stdexcept>
-
-namespace PokerSolver {
-
-/**
- * @brief Concrete implementation of a training strategy based on CFR+.
- *
- * This class implements the Counterfactual Regret Minimization Plus (CFR+)
- * algorithm. It maintains cumulative (positive) regrets, strategy sums for
- * averaging, and computes the current strategy by normalizing the positive regrets.
- */
-class CFRPlus : public Trainable {
-public:
-    /**
-     * @brief Constructor for CFRPlus.
-     * @param numActions The number of available actions at the decision node.
-     */
-    explicit CFRPlus(int numActions);
-
-    /// Virtual destructor.
-    virtual ~CFRPlus() override = default;
-
-    /**
-     * @brief Returns the average strategy (normalized strategySum) as a vector of probabilities.
-     * @return A vector of floats representing the average strategy.
-     */
-    virtual std::vector<float> getAverageStrategy() const override;
-
-    /**
-     * @brief Returns the current (instantaneous) strategy as a vector of probabilities.
-     * @return A vector of floats representing the current strategy.
-     */
-    virtual std::vector<float> getCurrentStrategy() const override;
-
-    /**
-     * @brief Updates the cumulative regrets and recomputes the current strategy.
-     *
-     * For each action, the cumulative regret is updated using:
-     *   newRegret = max(cumulativeRegret + regret, 0)
-     * Then the current strategy is computed by normalizing the positive regrets.
-     *
-     * The strategy sum is updated using reach probabilities so that the average strategy
-     * can be computed later.
-     *
-     * @param regrets The vector of immediate regrets for each action.
-     * @param iterationNumber The current iteration (unused in this basic implementation).
-     * @param reachProbs The vector of reach probabilities to weight the current strategy.
-     */
-    virtual void updateRegrets(const std::vector<float>& regrets,
-                               int iterationNumber,
-                               const std::vector<float>& reachProbs) override;
-
-    /**
-     * @brief Sets the expected values for each action.
-     *
-     * In this implementation we simply store the provided EVs.
-     *
-     * @param evs A vector of floats representing the expected values.
-     */
-    virtual void setEv(const std::vector<float>& evs) override;
-
-    /**
-     * @brief Copies the internal strategy from another Trainable instance.
-     *
-     * Only works if the other Trainable is a CFRPlus instance.
-     *
-     * @param other A shared pointer to another Trainable instance.
-     */
-    virtual void copyStrategy(const std::shared_ptr<Trainable>& other) override;
-
-    /**
-     * @brief Dumps the current strategy and internal state to a JSON object.
-     *
-     * @param withState If true, include detailed state (cumulative regrets, strategy sum).
-     * @param depth The level of detail desired.
-     * @return A JSON object containing the dumped state.
-     */
-    virtual json dumpStrategy(bool withState, int depth) const override;
-
-    /**
-     * @brief Dumps the expected values (EVs) as a JSON object.
-     * @return A JSON object containing the EVs.
-     */
-    virtual json dumpEvs() const override;
-
-    /**
-     * @brief Returns the type of this Trainable instance.
-     * @return The enumerated type Trainable::Type::CFR_PLUS.
-     */
-    virtual Type getType() const override;
-
-private:
-    int numActions_;
-    // For each action we store:
-    std::vector<float> cumulativeRegrets_;   // CFR+: Only nonnegative cumulative regrets.
-    std::vector<float> strategySum_;         // Accumulated weighted strategy over iterations.
-    std::vector<float> currentStrategy_;       // The current strategy computed on this iteration.
-    std::vector<float> evs_;                   // Expected values for each action (if applicable).
-
-    /**
-     * @brief Recalculates the current strategy by normalizing cumulative regrets.
-     *
-     * If the sum of positive regrets is zero, a uniform distribution is used.
-     */
-    void recalcCurrentStrategy();
+#include <cstddef>
+#include <json.hpp>
+
+// Forward declare ActionNode to break potential include cycle
+namespace poker_solver { namespace nodes { class ActionNode; } }
+// Use alias from trainable.h
+using json = nlohmann::json;
+
+namespace poker_solver {
+namespace solver {
+
+// CFR+ trainable: regret matching+ (cumulative regrets are floored at zero
+// after every update, with no discounting) and a weighted average strategy.
+// Each visit's contribution to the average is weighted by
+// IterationDiscounts::strategy_weight; PCfrSolver passes t (linear
+// averaging), and the int-iteration calls use t as well.
+//
+// Cumulative values live in a compact storage policy (see
+// CompactDiscountedCfrTrainable.h). The current/average strategy buffers
+// follow the same per-thread rules as CompactDiscountedCfrTrainable.
+template <typename Storage>
+class CfrPlusTrainable : public Trainable {
+ public:
+  // Constructor.
+  // Throws:
+  //   std::invalid_argument if player_range is null.
+  CfrPlusTrainable(const std::vector<core::PrivateCards>* player_range,
+                   const nodes::ActionNode& action_node);
+
+  ~CfrPlusTrainable() override = default;
+
+  // --- Overridden Interface Methods ---
+  const std::vector<double>& GetCurrentStrategy() const override;
+  const std::vector<double>& GetAverageStrategy() const override;
+
+  void UpdateRegrets(const std::vector<double>& weighted_regrets, int iteration,
+                     double reach_prob_opponent_chance_scalar) override;
+
+  void AccumulateAverageStrategy(const std::vector<double>& current_strategy,
+                                 int iteration,
+                                 const std::vector<double>& reach_probs_player_chance_vector) override;
+
+  // Decodes into 'scratch'; no per-thread buffer is involved. Only the
+  // strategy weight of 'discounts' is used.
+  const double* CurrentStrategy(double* scratch) const override;
+  void UpdateFromVisit(const double* weighted_regrets, const double* current_strategy,
+                       const double* reach_weights, const IterationDiscounts& discounts) override;
+
+  void WriteState(std::ostream& out) const override;
+  void ReadState(std::istream& in) override;
+  void GetHandState(size_t hand, double* regrets, double* strategy_sums) const override;
+  void SetHandState(size_t hand, const double* regrets, const double* strategy_sums) override;
+
+  void SetEv(const std::vector<double>& evs) override;
+
+  json DumpStrategy(bool with_ev) const override;
+  json DumpEvs() const override;
+  std::vector<double> GetEvs() const override;
+
+  void CopyStateFrom(const Trainable& other) override;
+
+  // Bytes held by the cumulative buffers and EVs (excludes per-thread scratch).
+  size_t MemoryBytes() const;
+
+ private:
+  // Normalizes each row of 'storage' into 'out' (num_actions * num_hands
+  // values); uniform when a row sums to ~0.
+  void NormalizeRows(const Storage& storage, double* out) const;
+  // Regret matching+ update of every hand row.
+  void AddRegrets(const double* weighted_regrets);
+  // Adds 'weight' * reach * strategy to the strategy sums.
+  void AddStrategy(const double* current_strategy, const double* reach_weights, double weight);
+
+  // --- Member Variables ---
+  const nodes::ActionNode& action_node_;
+  const std::vector<core::PrivateCards>* player_range_; // Not owned
+  size_t num_actions_;
+  size_t num_hands_;
+  Storage cumulative_regrets_; // Never negative
+  Storage cumulative_strategy_sum_;
+  std::vector<float> expected_values_; // Empty until SetEv
+
+  // Deleted copy/move operations.
+  CfrPlusTrainable(const CfrPlusTrainable&) = delete;
+  CfrPlusTrainable& operator=(const CfrPlusTrainable&) = delete;
+  CfrPlusTrainable(CfrPlusTrainable&&) = delete;
+  CfrPlusTrainable& operator=(CfrPlusTrainable&&) = delete;
 };
 
-} // namespace PokerSolver
+// Single precision (4 bytes per value).
+using CfrPlusTrainableSF = CfrPlusTrainable<FloatRowStorage>;
+// Half width, 16-bit fixed point with per-hand scale (2 bytes per value).
+using CfrPlusTrainableHF = CfrPlusTrainable<Int16RowStorage>;
 
-#endif // POKERSOLVER_CFRPLUS_H
+// Explicitly instantiated in CFRPlus.cpp.
+extern template class CfrPlusTrainable<FloatRowStorage>;
+extern template class CfrPlusTrainable<Int16RowStorage>;
+
+} // namespace solver
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_SOLVER_CFR_PLUS_H_
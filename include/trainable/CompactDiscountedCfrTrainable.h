@@ -0,0 +1,148 @@
+#ifndef POKER_SOLVER_SOLVER_COMPACT_DISCOUNTED_CFR_TRAINABLE_H_
+#define POKER_SOLVER_SOLVER_COMPACT_DISCOUNTED_CFR_TRAINABLE_H_
+
+#include "trainable/Trainable.h"   // Base class interface
+#include "ranges/PrivateCards.h" // For PrivateCards
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <iosfwd>
+#include <json.hpp>
+
+// Forward declare ActionNode to break potential include cycle
+namespace poker_solver { namespace nodes { class ActionNode; } }
+// Use alias from trainable.h
+using json = nlohmann::json;
+
+namespace poker_solver {
+namespace solver {
+
+// --- Storage Policies ---
+// A storage policy holds a hand-major (rows = hands, cols = actions) matrix of
+// cumulative values in a reduced-precision format. Values are read and written
+// one hand row at a time as doubles.
+
+// 32-bit float storage.
+class FloatRowStorage {
+ public:
+  void Resize(size_t rows, size_t cols);
+  void DecodeRow(size_t row, double* out) const;
+  void EncodeRow(size_t row, const double* in);
+  size_t MemoryBytes() const;
+  // Raw contents, for checkpoints. Read expects the current dimensions.
+  void Write(std::ostream& out) const;
+  void Read(std::istream& in);
+
+ private:
+  size_t cols_ = 0;
+  std::vector<float> data_;
+};
+
+// 16-bit fixed point with one float scale per hand row. Regret matching and
+// strategy averaging only compare values within a hand, so a per-row scale
+// keeps ~15 bits of relative precision where it matters.
+class Int16RowStorage {
+ public:
+  void Resize(size_t rows, size_t cols);
+  void DecodeRow(size_t row, double* out) const;
+  void EncodeRow(size_t row, const double* in);
+  size_t MemoryBytes() const;
+  // Raw contents, for checkpoints. Read expects the current dimensions.
+  void Write(std::ostream& out) const;
+  void Read(std::istream& in);
+
+ private:
+  size_t cols_ = 0;
+  std::vector<int16_t> data_;
+  std::vector<float> row_scales_; // Value = data * scale
+};
+
+// Discounted CFR trainable (same update rules as DiscountedCfrTrainable) with
+// cumulative regrets and strategy sums kept in a compact storage policy.
+//
+// To keep the footprint small, current/average strategies are not cached per
+// node: GetCurrentStrategy()/GetAverageStrategy() compute into a per-thread
+// scratch buffer. The returned reference is only valid until the next
+// Get*Strategy() call on any compact trainable from the same thread, so
+// callers must copy it before touching another node. PCfrSolver instead
+// decodes into its own traversal buffer through CurrentStrategy().
+// Expected values are allocated only when SetEv is called.
+template <typename Storage>
+class CompactDiscountedCfrTrainable : public Trainable {
+ public:
+  // Constructor.
+  // Throws:
+  //   std::invalid_argument if player_range is null.
+  CompactDiscountedCfrTrainable(
+    const std::vector<core::PrivateCards>* player_range,
+    const nodes::ActionNode& action_node);
+
+  ~CompactDiscountedCfrTrainable() override = default;
+
+  // --- Overridden Interface Methods ---
+  const std::vector<double>& GetCurrentStrategy() const override;
+  const std::vector<double>& GetAverageStrategy() const override;
+
+  void UpdateRegrets(const std::vector<double>& weighted_regrets, int iteration,
+                     double reach_prob_opponent_chance_scalar) override;
+
+  void AccumulateAverageStrategy(const std::vector<double>& current_strategy,
+                                 int iteration,
+                                 const std::vector<double>& reach_probs_player_chance_vector) override;
+
+  // Decodes into 'scratch'; no per-thread buffer is involved.
+  const double* CurrentStrategy(double* scratch) const override;
+  void UpdateFromVisit(const double* weighted_regrets, const double* current_strategy,
+                       const double* reach_weights, const IterationDiscounts& discounts) override;
+
+  void WriteState(std::ostream& out) const override;
+  void ReadState(std::istream& in) override;
+  void GetHandState(size_t hand, double* regrets, double* strategy_sums) const override;
+  void SetHandState(size_t hand, const double* regrets, const double* strategy_sums) override;
+
+  void SetEv(const std::vector<double>& evs) override;
+
+  json DumpStrategy(bool with_ev) const override;
+  json DumpEvs() const override;
+  std::vector<double> GetEvs() const override;
+
+  void CopyStateFrom(const Trainable& other) override;
+
+  // Bytes held by the cumulative buffers and EVs (excludes per-thread scratch).
+  size_t MemoryBytes() const;
+
+ private:
+  // Normalizes each row of 'storage' (clamping negatives when
+  // 'positive_part' is set) into 'out' (num_actions * num_hands values);
+  // uniform when a row sums to ~0.
+  void NormalizeRows(const Storage& storage, bool positive_part, double* out) const;
+
+  // --- Member Variables ---
+  const nodes::ActionNode& action_node_;
+  const std::vector<core::PrivateCards>* player_range_; // Not owned
+  size_t num_actions_;
+  size_t num_hands_;
+  Storage cumulative_regrets_;
+  Storage cumulative_strategy_sum_;
+  std::vector<float> expected_values_; // Empty until SetEv
+
+  // Deleted copy/move operations.
+  CompactDiscountedCfrTrainable(const CompactDiscountedCfrTrainable&) = delete;
+  CompactDiscountedCfrTrainable& operator=(const CompactDiscountedCfrTrainable&) = delete;
+  CompactDiscountedCfrTrainable(CompactDiscountedCfrTrainable&&) = delete;
+  CompactDiscountedCfrTrainable& operator=(CompactDiscountedCfrTrainable&&) = delete;
+};
+
+// Single precision (4 bytes per value).
+using DiscountedCfrTrainableSF = CompactDiscountedCfrTrainable<FloatRowStorage>;
+// Half width, 16-bit fixed point with per-hand scale (2 bytes per value).
+using DiscountedCfrTrainableHF = CompactDiscountedCfrTrainable<Int16RowStorage>;
+
+// Explicitly instantiated in CompactDiscountedCfrTrainable.cpp.
+extern template class CompactDiscountedCfrTrainable<FloatRowStorage>;
+extern template class CompactDiscountedCfrTrainable<Int16RowStorage>;
+
+} // namespace solver
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_SOLVER_COMPACT_DISCOUNTED_CFR_TRAINABLE_H_
@@ -0,0 +1,35 @@
+#ifndef POKER_SOLVER_SOLVER_DCFR_DISCOUNTS_H_
+#define POKER_SOLVER_SOLVER_DCFR_DISCOUNTS_H_
+
+namespace poker_solver {
+namespace solver {
+
+// Exponents of the Discounted CFR schedule. At iteration t, positive
+// cumulative regrets are scaled by t^alpha / (t^alpha + 1), negative ones by
+// t^beta / (t^beta + 1), and the iteration's average strategy contribution
+// is weighted by t^gamma.
+struct DcfrParameters {
+  double alpha = 1.5;
+  double beta = 0.5;
+  double gamma = 2.0;
+};
+
+// Discount factors of one iteration. The solver computes them once per
+// iteration and hands the same object to every trainable update, so the
+// std::pow calls are not repeated per node.
+struct IterationDiscounts {
+  int iteration = 0;
+  double positive_regret = 0.0; // t^alpha / (t^alpha + 1)
+  double negative_regret = 0.0; // t^beta / (t^beta + 1)
+  double strategy_weight = 0.0; // t^gamma
+
+  // Throws:
+  //   std::invalid_argument if iteration is not positive.
+  static IterationDiscounts For(int iteration,
+                                const DcfrParameters& parameters = DcfrParameters());
+};
+
+} // namespace solver
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_SOLVER_DCFR_DISCOUNTS_H_
@@ -2,6 +2,7 @@
 #define POKER_SOLVER_SOLVER_DISCOUNTED_CFR_TRAINABLE_H_
 
 #include "trainable/Trainable.h"   // Base class interface
+#include "trainable/TrainableArena.h" // For arena-backed storage
 #include "ranges/PrivateCards.h" // For PrivateCards
 // #include "nodes/action_node.h" // Use forward declaration below
 #include <vector>
@@ -25,12 +26,32 @@ namespace solver {
 
 // Concrete implementation of the Trainable interface using the
 // Discounted Counterfactual Regret Minimization (DCFR) algorithm.
+//
+// Cumulative regrets, strategy sums and the current strategy share one
+// contiguous block, taken from 'arena' when one is given (the solver passes
+// a TrainableArena so consecutive trainables are adjacent in memory) and
+// owned by the trainable otherwise. The average strategy and EVs are only
+// allocated when first requested.
+//
+// With 'lazy_strategies' the block holds only regrets and strategy sums:
+// CurrentStrategy regret-matches into the caller's scratch buffer, and
+// GetCurrentStrategy/GetAverageStrategy derive their result on demand into
+// per-thread buffers (valid until the next such call on the same thread),
+// so neither strategy stays resident between visits.
+//
+// With 'defer_strategy_sums' the block leaves out the strategy sums, which
+// are allocated (from the arena, if any) by the first update that adds to
+// them, for solvers that start averaging late; until then they read as
+// zeros.
 class DiscountedCfrTrainable : public Trainable {
  public:
   // Constructor.
   DiscountedCfrTrainable(
     const std::vector<core::PrivateCards>* player_range, // Pass range pointer
-    const nodes::ActionNode& action_node);
+    const nodes::ActionNode& action_node,
+    std::shared_ptr<TrainableArena> arena = nullptr,
+    bool lazy_strategies = false,
+    bool defer_strategy_sums = false);
 
   // Virtual destructor.
   ~DiscountedCfrTrainable() override = default;
@@ -49,36 +70,67 @@ class DiscountedCfrTrainable : public Trainable {
                                  int iteration,
                                  const std::vector<double>& reach_probs_player_chance_vector) override; // VECTOR
 
+  const double* CurrentStrategy(double* scratch) const override;
+  void UpdateFromVisit(const double* weighted_regrets, const double* current_strategy,
+                       const double* reach_weights, const IterationDiscounts& discounts) override;
+
+  void WriteState(std::ostream& out) const override;
+  void ReadState(std::istream& in) override;
+  void GetHandState(size_t hand, double* regrets, double* strategy_sums) const override;
+  void SetHandState(size_t hand, const double* regrets, const double* strategy_sums) override;
+
   void SetEv(const std::vector<double>& evs) override;
 
   json DumpStrategy(bool with_ev) const override;
   json DumpEvs() const override;
+  std::vector<double> GetEvs() const override;
 
   void CopyStateFrom(const Trainable& other) override;
 
+  size_t NumActions() const { return num_actions_; }
+  size_t NumHands() const { return num_hands_; }
+  // The cumulative regret and strategy sum tables in the block, hand-major
+  // (NumHands() rows of NumActions() values), which later updates write in
+  // place. StrategySums() is null while deferred strategy sums are not
+  // allocated yet.
+  const double* CumulativeRegrets() const { return cumulative_regrets_; }
+  const double* StrategySums() const { return cumulative_strategy_sum_; }
+
+  // Doubles this trainable keeps in its block: 2 or 3 tables of
+  // num_actions * num_hands values (see the class comment).
+  static size_t BlockDoubles(size_t table_size, bool lazy_strategies) {
+    return (lazy_strategies ? 2 : 3) * table_size;
+  }
 
  private:
   // Helper methods for lazy calculation
   void CalculateCurrentStrategy(); // Non-const as it modifies mutable members
   void CalculateAverageStrategy() const; // Const is appropriate
-
-  // --- DCFR Parameters ---
-  static constexpr double kAlpha = 1.5;
-  static constexpr double kBeta = 0.5;
-  static constexpr double kGamma = 2.0;
+  // Regret matching of the cumulative regrets into 'out'.
+  void RegretMatch(double* out) const;
+  // Normalized strategy sums into 'out'.
+  void NormalizeStrategySums(double* out) const;
+  // Allocates deferred strategy sums, zeroed, if they are not yet.
+  void EnsureStrategySums();
 
   // --- Member Variables ---
   const nodes::ActionNode& action_node_; // Store reference to get action count etc.
   const std::vector<core::PrivateCards>* player_range_; // Not owned
   size_t num_actions_;
   size_t num_hands_;
-  std::vector<double> cumulative_regrets_;
-  std::vector<double> cumulative_strategy_sum_;
-  mutable std::vector<double> current_strategy_;
+  bool lazy_strategies_;
+  std::shared_ptr<TrainableArena> arena_; // Keeps the block below alive
+  std::vector<double> owned_storage_;     // The block when there is no arena
+  std::vector<double> owned_strategy_sums_; // Deferred sums when there is no arena
+  // num_actions_ * num_hands_ values each, hand-major, in one block.
+  double* cumulative_regrets_ = nullptr;
+  double* cumulative_strategy_sum_ = nullptr;
+  double* current_strategy_ = nullptr; // Null with lazy_strategies_
+  mutable std::vector<double> current_strategy_view_; // Filled by GetCurrentStrategy
   mutable std::vector<double> average_strategy_;
   mutable bool current_strategy_valid_ = false;
   mutable bool average_strategy_valid_ = false;
-  std::vector<double> expected_values_;
+  std::vector<double> expected_values_; // Empty until SetEv
 
   // Deleted copy/move operations.
   DiscountedCfrTrainable(const DiscountedCfrTrainable&) = delete;
@@ -0,0 +1,87 @@
+#ifndef POKER_SOLVER_SOLVER_LOCKED_TRAINABLE_H_
+#define POKER_SOLVER_SOLVER_LOCKED_TRAINABLE_H_
+
+#include "trainable/Trainable.h" // Base class interface
+#include "ranges/PrivateCards.h" // For PrivateCards
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <json.hpp>
+
+// Forward declare ActionNode to break potential include cycle
+namespace poker_solver { namespace nodes { class ActionNode; } }
+// Use alias from trainable.h
+using json = nlohmann::json;
+
+namespace poker_solver {
+namespace solver {
+
+// Trainable of a locked action node (see ActionNode::LockStrategy): plays a
+// fixed hand-major strategy, which is both its current and its average
+// strategy, and ignores updates. The strategy is shared by every deal slot
+// of the node, so a slot holds no regrets or strategy sums, only EVs once
+// SetEv is called.
+class LockedTrainable : public Trainable {
+ public:
+  // Constructor. 'strategy' holds num_actions * num_hands values.
+  // Throws:
+  //   std::invalid_argument if player_range or strategy is null, or the
+  //   strategy does not match the node's dimensions.
+  LockedTrainable(const std::vector<core::PrivateCards>* player_range,
+                  const nodes::ActionNode& action_node,
+                  std::shared_ptr<const std::vector<double>> strategy);
+
+  ~LockedTrainable() override = default;
+
+  // --- Overridden Interface Methods ---
+  const std::vector<double>& GetCurrentStrategy() const override { return *strategy_; }
+  const std::vector<double>& GetAverageStrategy() const override { return *strategy_; }
+
+  // No-ops: a locked strategy is never trained.
+  void UpdateRegrets(const std::vector<double>&, int, double) override {}
+  void AccumulateAverageStrategy(const std::vector<double>&, int, const std::vector<double>&) override {}
+
+  // Returns the shared strategy; 'scratch' is not written.
+  const double* CurrentStrategy(double*) const override { return strategy_->data(); }
+  void UpdateFromVisit(const double*, const double*, const double*, const IterationDiscounts&) override {}
+
+  // No state to save: the lock is part of the solver setup, not training.
+  void WriteState(std::ostream&) const override {}
+  void ReadState(std::istream&) override {}
+  // Zero regrets and the locked strategy as strategy sums; SetHandState
+  // ignores its input.
+  void GetHandState(size_t hand, double* regrets, double* strategy_sums) const override;
+  void SetHandState(size_t, const double*, const double*) override {}
+
+  void SetEv(const std::vector<double>& evs) override;
+
+  json DumpStrategy(bool with_ev) const override;
+  json DumpEvs() const override;
+  std::vector<double> GetEvs() const override { return expected_values_; }
+
+  // Copies the EVs of another LockedTrainable of the same dimensions.
+  void CopyStateFrom(const Trainable& other) override;
+
+ private:
+  // Strategy/EV map of every hand, keyed like the other trainables' dumps.
+  json HandMap(const std::vector<double>& values) const;
+
+  // --- Member Variables ---
+  const nodes::ActionNode& action_node_;
+  const std::vector<core::PrivateCards>* player_range_; // Not owned
+  size_t num_actions_;
+  size_t num_hands_;
+  std::shared_ptr<const std::vector<double>> strategy_;
+  std::vector<double> expected_values_; // Empty until SetEv
+
+  // Deleted copy/move operations.
+  LockedTrainable(const LockedTrainable&) = delete;
+  LockedTrainable& operator=(const LockedTrainable&) = delete;
+  LockedTrainable(LockedTrainable&&) = delete;
+  LockedTrainable& operator=(LockedTrainable&&) = delete;
+};
+
+} // namespace solver
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_SOLVER_LOCKED_TRAINABLE_H_
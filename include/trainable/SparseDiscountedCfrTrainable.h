@@ -0,0 +1,112 @@
+#ifndef POKER_SOLVER_SOLVER_SPARSE_DISCOUNTED_CFR_TRAINABLE_H_
+#define POKER_SOLVER_SOLVER_SPARSE_DISCOUNTED_CFR_TRAINABLE_H_
+
+#include "trainable/Trainable.h"   // Base class interface
+#include "ranges/PrivateCards.h"   // For PrivateCards
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <json.hpp>
+
+// Forward declare ActionNode to break potential include cycle
+namespace poker_solver { namespace nodes { class ActionNode; } }
+
+namespace poker_solver {
+namespace solver {
+
+// Double-precision Discounted CFR, like DiscountedCfrTrainable, for nodes
+// only a few hands of the range reach (deep lines after raises). Tables
+// hold rows for the "live" hands alone, in ascending hand order, so memory
+// and the update loops scale with the live hands rather than the range.
+//
+// The interface stays hand-major over the whole range. Hands that are not
+// live have no regrets or strategy sums and play uniformly, in both the
+// current and the average strategy; a visit or SetHandState that gives one
+// of them a nonzero reach or value makes it live, starting from zeros.
+// Unlike the dense trainable, a hand's regrets are therefore not kept
+// while nothing reaches it.
+//
+// GetCurrentStrategy and GetAverageStrategy fill per-thread buffers, valid
+// until the next such call on the same thread. WriteState/ReadState use
+// DiscountedCfrTrainable's layout, with zero rows for the hands that are
+// not live, so checkpoints move freely between the two types.
+class SparseDiscountedCfrTrainable : public Trainable {
+ public:
+  // 'live_hands' are ascending indices into 'player_range'; their rows
+  // start at zero regrets and strategy sums.
+  // Throws:
+  //   std::invalid_argument if player_range is null, or live_hands is not
+  //   ascending or holds an index outside the range.
+  SparseDiscountedCfrTrainable(const std::vector<core::PrivateCards>* player_range,
+                               const nodes::ActionNode& action_node,
+                               std::vector<uint32_t> live_hands,
+                               bool lazy_strategies = false);
+
+  ~SparseDiscountedCfrTrainable() override = default;
+
+  const std::vector<double>& GetCurrentStrategy() const override;
+  const std::vector<double>& GetAverageStrategy() const override;
+
+  void UpdateRegrets(const std::vector<double>& weighted_regrets, int iteration,
+                     double reach_prob_opponent_chance_scalar) override;
+  void AccumulateAverageStrategy(const std::vector<double>& current_strategy,
+                                 int iteration,
+                                 const std::vector<double>& reach_probs_player_chance_vector) override;
+
+  const double* CurrentStrategy(double* scratch) const override;
+  void UpdateFromVisit(const double* weighted_regrets, const double* current_strategy,
+                       const double* reach_weights, const IterationDiscounts& discounts) override;
+
+  void WriteState(std::ostream& out) const override;
+  void ReadState(std::istream& in) override;
+  void GetHandState(size_t hand, double* regrets, double* strategy_sums) const override;
+  void SetHandState(size_t hand, const double* regrets, const double* strategy_sums) override;
+
+  void SetEv(const std::vector<double>& evs) override;
+  json DumpStrategy(bool with_ev) const override;
+  json DumpEvs() const override;
+  std::vector<double> GetEvs() const override;
+
+  // Copies another SparseDiscountedCfrTrainable of the same dimensions.
+  // Throws:
+  //   std::invalid_argument for other types or dimensions.
+  void CopyStateFrom(const Trainable& other) override;
+
+  size_t NumLiveHands() const { return live_hands_.size(); }
+  bool IsLive(size_t hand) const { return slot_of_hand_[hand] != kNotLive; }
+
+  // Bytes of the tables and hand indices (EVs, allocated only on demand,
+  // are not included).
+  uint64_t TableBytes() const;
+
+ private:
+  static constexpr uint32_t kNotLive = UINT32_MAX;
+
+  // Inserts 'hand' into the live hands with zero rows; returns its slot.
+  uint32_t MakeLive(size_t hand);
+  // Regret matching of the live rows into 'out' (compact rows).
+  void RegretMatchRows(double* out) const;
+
+  const nodes::ActionNode& action_node_;
+  const std::vector<core::PrivateCards>* player_range_; // Not owned
+  size_t num_actions_;
+  size_t num_hands_;
+  bool lazy_strategies_;
+  std::vector<uint32_t> live_hands_;   // Ascending hand indices, one per row
+  std::vector<uint32_t> slot_of_hand_; // Per hand of the range, its row or kNotLive
+  // live_hands_.size() * num_actions_ values each, row-major.
+  std::vector<double> cumulative_regrets_;
+  std::vector<double> cumulative_strategy_sum_;
+  std::vector<double> current_strategy_; // Empty with lazy_strategies_
+  std::vector<double> expected_values_;  // Hand-major over the range; empty until SetEv
+
+  SparseDiscountedCfrTrainable(const SparseDiscountedCfrTrainable&) = delete;
+  SparseDiscountedCfrTrainable& operator=(const SparseDiscountedCfrTrainable&) = delete;
+  SparseDiscountedCfrTrainable(SparseDiscountedCfrTrainable&&) = delete;
+  SparseDiscountedCfrTrainable& operator=(SparseDiscountedCfrTrainable&&) = delete;
+};
+
+} // namespace solver
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_SOLVER_SPARSE_DISCOUNTED_CFR_TRAINABLE_H_
@@ -1,12 +1,16 @@
 #ifndef POKER_SOLVER_SOLVER_TRAINABLE_H_
 #define POKER_SOLVER_SOLVER_TRAINABLE_H_
 
+#include <cstddef>
 #include <vector>
 #include <string>
 #include <memory>
 #include <map>
+#include <iosfwd>
 #include <json.hpp>
 
+#include "trainable/DcfrDiscounts.h"
+
 using json = nlohmann::json;
 
 namespace poker_solver {
@@ -21,7 +25,8 @@ class Trainable {
 
   // Regrets arrive pre-weighted by opp_reach * chance_reach.
   // Implementations should apply iteration discounting to cumulative values
-  // and add the incoming weighted regret.
+  // and add the incoming weighted regret. The int-iteration calls here use
+  // the default DcfrParameters.
   virtual void UpdateRegrets(const std::vector<double>& weighted_regrets, int iteration,
                              double reach_prob_opponent_chance_scalar) = 0; // Weight scalar might be unused by some impls
 
@@ -32,9 +37,46 @@ class Trainable {
                                          int iteration,
                                          const std::vector<double>& reach_probs_player_chance_vector) = 0; // VECTOR of weights
 
+  // --- Pointer-based traversal interface ---
+  // Used once per action node visit by the solver. Strategy and regret
+  // buffers are hand-major with num_actions * num_hands values; weights hold
+  // num_hands values. Sizes are not checked.
+
+  // Returns the current strategy. Implementations that cache it return their
+  // own buffer, valid until this trainable is next updated; the others write
+  // into 'scratch' and return it.
+  virtual const double* CurrentStrategy(double* scratch) const = 0;
+
+  // Fused equivalent of UpdateRegrets(weighted_regrets, iteration, ...)
+  // followed by AccumulateAverageStrategy(current_strategy, iteration,
+  // reach_weights), in one pass over the hands, with the iteration's
+  // precomputed 'discounts'. 'current_strategy' is the strategy the visit
+  // played and may point at the trainable's own buffer from
+  // CurrentStrategy(); a cached current strategy is recomputed in place.
+  virtual void UpdateFromVisit(const double* weighted_regrets, const double* current_strategy,
+                               const double* reach_weights, const IterationDiscounts& discounts) = 0;
+
+  // --- Checkpointing ---
+  // WriteState appends the cumulative regrets and strategy sums (not cached
+  // strategies or EVs) to 'out' as raw host-order values. ReadState restores
+  // them into a trainable of the same type and dimensions.
+  // Throws:
+  //   std::runtime_error if the stream fails or ends early.
+  virtual void WriteState(std::ostream& out) const = 0;
+  virtual void ReadState(std::istream& in) = 0;
+
+  // --- Warm starts ---
+  // Cumulative regrets and strategy sums of one hand, num_actions values
+  // each, as doubles whatever the storage precision. SetHandState replaces
+  // them (and drops cached strategies); hand indices are not checked.
+  virtual void GetHandState(size_t hand, double* regrets, double* strategy_sums) const = 0;
+  virtual void SetHandState(size_t hand, const double* regrets, const double* strategy_sums) = 0;
+
   virtual void SetEv(const std::vector<double>& evs) = 0;
   virtual json DumpStrategy(bool with_ev) const = 0;
   virtual json DumpEvs() const = 0;
+  // Hand-major EVs passed to SetEv, empty until then.
+  virtual std::vector<double> GetEvs() const = 0;
   virtual void CopyStateFrom(const Trainable& other) = 0;
 
  protected:
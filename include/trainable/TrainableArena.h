@@ -0,0 +1,122 @@
+#ifndef POKER_SOLVER_SOLVER_TRAINABLE_ARENA_H_
+#define POKER_SOLVER_SOLVER_TRAINABLE_ARENA_H_
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace poker_solver {
+namespace solver {
+
+// Bump allocator for trainable regret/strategy tables.
+//
+// Memory comes in large slabs: the first one holds 'capacity_hint' doubles,
+// later ones are added when it runs out. Trainables created one after the
+// other therefore sit next to each other instead of in many separate heap
+// blocks. Slab pages are only committed by the OS once touched, so the hint
+// may be an upper bound (e.g. every deal slot of every action node) without
+// costing physical memory for slots that are never reached.
+//
+// An arena may keep several lanes, independent slab chains, so that blocks
+// created by the threads of one NUMA node share pages only with each
+// other: the OS places a page on the node of the thread that first writes
+// it, and trainables are written (zeroed) by the thread that creates them.
+//
+// A file-backed arena maps its slabs from a temporary file instead, for
+// tables larger than physical memory: the kernel writes cold pages back to
+// the file and drops them under memory pressure. The file is unlinked as
+// soon as it is created, so it disappears with the arena (or the process).
+// Blocks follow allocation order in the file, which for trainables is the
+// order the first traversal created them in, and so the order later
+// traversals read them in.
+//
+// Allocate is thread-safe. Memory is released only when the arena is
+// destroyed; trainables keep the arena alive through a shared_ptr.
+class TrainableArena {
+ public:
+  // Args:
+  //   capacity_hint: Doubles in the first slab (0: use the default slab size).
+  //                  If the OS refuses that much address space, the arena
+  //                  starts empty and grows in default-sized slabs.
+  //   huge_pages:    Align slabs to 2 MiB and, on Linux, ask for transparent
+  //                  huge pages. Silently ignored where unsupported.
+  //   lanes:         Slab chains; the hint is split evenly between them.
+  explicit TrainableArena(size_t capacity_hint, bool huge_pages = false, size_t lanes = 1);
+
+  // Where a file-backed arena keeps its file.
+  struct FileBacking {
+    std::string directory;
+    // Advise the kernel that blocks are read in allocation order (read
+    // ahead, reclaim behind) rather than at random.
+    bool sequential_access = false;
+  };
+
+  // File-backed arena. Slabs have their disk blocks allocated when they are
+  // mapped, so a full disk is reported by Allocate rather than faulting on
+  // a write; their pages cost no memory until written.
+  // Throws:
+  //   std::runtime_error if the file cannot be created, or on platforms
+  //                      without mmap.
+  TrainableArena(size_t capacity_hint, const FileBacking& file, size_t lanes = 1);
+  ~TrainableArena();
+
+  // Sets the lane the calling thread allocates from, in every arena; arenas
+  // with fewer lanes use lane 0. Threads start in lane 0.
+  static void SetThreadLane(size_t lane);
+
+  // Returns 'count' uninitialized doubles, 64-byte aligned, from the
+  // calling thread's lane.
+  // Throws:
+  //   std::bad_alloc if a new slab cannot be allocated.
+  //   std::runtime_error if a file-backed arena's file cannot grow (e.g. the
+  //                      disk is full).
+  double* Allocate(size_t count);
+
+  // Doubles handed out so far.
+  size_t AllocatedDoubles() const;
+  // Bytes reserved in slabs (address space, not necessarily resident).
+  size_t ReservedBytes() const;
+  bool IsFileBacked() const { return file_ >= 0; }
+  // The used part of each slab, lane by lane in allocation order. Writing
+  // these regions out saves every arena-backed table in as many writes as
+  // there are slabs.
+  std::vector<std::pair<const double*, size_t>> Regions() const;
+
+  // Doubles in slabs added after the first one fills up.
+  static constexpr size_t kDefaultSlabDoubles = size_t{1} << 21; // 16 MiB
+
+ private:
+  struct Slab {
+    double* data;
+    size_t capacity; // Doubles
+    size_t used;     // Doubles
+  };
+
+  // Maps 'bytes' more of the backing file. Called like AddSlab.
+  void* MapFileSlab(size_t bytes);
+
+  // Adds a slab of at least 'min_doubles' to 'lane'. Called with mutex_
+  // held (or from the constructor).
+  void AddSlab(std::vector<Slab>& lane, size_t min_doubles);
+
+  const bool huge_pages_;
+  const bool sequential_access_ = false;
+  int file_ = -1;          // Backing file descriptor; -1 for anonymous memory
+  size_t file_bytes_ = 0;  // Backing file size, all of it mapped
+  mutable std::mutex mutex_;
+  std::vector<std::vector<Slab>> lanes_; // Slabs of each lane
+  size_t allocated_doubles_ = 0;
+
+  // Deleted copy/move operations.
+  TrainableArena(const TrainableArena&) = delete;
+  TrainableArena& operator=(const TrainableArena&) = delete;
+  TrainableArena(TrainableArena&&) = delete;
+  TrainableArena& operator=(TrainableArena&&) = delete;
+};
+
+} // namespace solver
+} // namespace poker_solver
+
+#endif // POKER_SOLVER_SOLVER_TRAINABLE_ARENA_H_
@@ -0,0 +1,282 @@
+// poker_solver: Python bindings (pybind11) for solving spots and reading
+// their tables as NumPy arrays, without going through DumpStrategy JSON.
+//
+//   import json, poker_solver
+//   tree = poker_solver.GameTree(json.dumps(scenario))   # scenario file syntax
+//   solver = poker_solver.Solver(json.dumps(scenario), iterations=200, threads=8, tree=tree)
+//   solver.train()                               # releases the GIL
+//   regrets = solver.regrets(["CHECK"])          # (hands, actions), no copy
+//   solver.write_strategy_file("spot.strategy")
+//   f = poker_solver.StrategyFile("spot.strategy")
+//   strategy = f.strategy(f.find("CHECK"))       # (actions, hands) over the mapping
+//
+// Arrays that view solver tables or a mapped file are read-only and keep
+// their owner alive. Solver views are live: training writes them in place,
+// so copy one to keep a version. Regret and strategy sum views are
+// zero-copy for double-precision Discounted/Linear CFR tables; other
+// storage (single/half precision, sparse, CFR+) is converted into a new
+// array. Average strategies are derived from the sums and always copied;
+// strategy files hold them (and EVs, when present) ready to map.
+
+#include "Card.h"
+#include "Deck.h"
+#include "GameTree.h"
+#include "compairer/Dic5Compairer.h"
+#include "compairer/Dic7Compairer.h"
+#include "nodes/ActionNode.h"
+#include "ranges/PrivateCardsManager.h"
+#include "ranges/RiverRangeManager.h"
+#include "solver/PCfrSolver.h"
+#include "solver/StrategyFile.h"
+#include "tools/PrivateRangeConverter.h"
+#include "tools/ScenarioFile.h"
+#include "trainable/DiscountedCfrTrainable.h"
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <json.hpp>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace py = pybind11;
+namespace core = poker_solver::core;
+namespace config = poker_solver::config;
+namespace eval = poker_solver::eval;
+namespace nodes = poker_solver::nodes;
+namespace ranges = poker_solver::ranges;
+namespace solver = poker_solver::solver;
+namespace tree = poker_solver::tree;
+
+namespace {
+
+// Built on first use and shared by every solver of the process.
+std::shared_ptr<core::Compairer> SharedCompairer() {
+    static const std::shared_ptr<core::Compairer> compairer =
+        std::make_shared<eval::Dic7Compairer>(eval::Dic5Compairer());
+    return compairer;
+}
+
+config::Scenario ParseScenario(const std::string& scenario_json) {
+    return config::ScenarioFromJson(nlohmann::json::parse(scenario_json), core::Deck());
+}
+
+nodes::ActionNode::TrainablePrecision ParsePrecision(const std::string& precision) {
+    using Precision = nodes::ActionNode::TrainablePrecision;
+    if (precision == "double") return Precision::kFloat;
+    if (precision == "single") return Precision::kSingle;
+    if (precision == "half") return Precision::kHalf;
+    throw std::invalid_argument("Unknown precision: " + precision + " (double, single or half)");
+}
+
+// A solver with the ranges and tree it was built from.
+class PySolver {
+  public:
+    PySolver(const std::string& scenario_json, int iterations, int threads, const std::string& precision,
+             std::shared_ptr<tree::GameTree> game_tree)
+        : scenario_(ParseScenario(scenario_json)) {
+        std::vector<std::vector<core::PrivateCards>> player_ranges;
+        for (const std::string& range : scenario_.ranges) {
+            player_ranges.push_back(ranges::PrivateRangeConverter::StringToPrivateCards(
+                range, scenario_.rule.GetInitialBoardCardsInt()));
+        }
+        pcm_ = std::make_shared<ranges::PrivateCardsManager>(
+            std::move(player_ranges), core::Card::CardIntsToUint64(scenario_.rule.GetInitialBoardCardsInt()));
+        if (!game_tree) game_tree = std::make_shared<tree::GameTree>(scenario_.rule);
+        solver::PCfrSolver::Config config;
+        config.iteration_limit = iterations > 0 ? iterations : (scenario_.iterations > 0 ? scenario_.iterations : 1000);
+        config.num_threads = threads > 0 ? threads : (scenario_.threads > 0 ? scenario_.threads : 1);
+        config.precision = ParsePrecision(precision);
+        solver_ = std::make_unique<solver::PCfrSolver>(
+            std::move(game_tree), pcm_, std::make_shared<ranges::RiverRangeManager>(SharedCompairer()),
+            scenario_.rule, config);
+    }
+
+    solver::PCfrSolver& Get() { return *solver_; }
+    const ranges::PrivateCardsManager& Ranges() const { return *pcm_; }
+
+  private:
+    config::Scenario scenario_;
+    std::shared_ptr<ranges::PrivateCardsManager> pcm_;
+    std::unique_ptr<solver::PCfrSolver> solver_;
+};
+
+std::shared_ptr<solver::Trainable> TrainableAt(PySolver& self, const std::vector<std::string>& path, size_t deal) {
+    std::shared_ptr<solver::Trainable> trainable = self.Get().FindActionNode(path).GetTrainableIfExists(deal);
+    if (!trainable) throw py::value_error("No table yet for this node and deal (not reached in training).");
+    return trainable;
+}
+
+// (hands, actions) view of a hand-major table owned by 'trainable'.
+py::array TableView(const std::shared_ptr<solver::Trainable>& trainable, const double* data, size_t num_hands,
+                    size_t num_actions) {
+    auto* owner = new std::shared_ptr<solver::Trainable>(trainable);
+    py::capsule base(owner, [](void* pointer) { delete static_cast<std::shared_ptr<solver::Trainable>*>(pointer); });
+    py::array_t<double> array({static_cast<py::ssize_t>(num_hands), static_cast<py::ssize_t>(num_actions)},
+                              {static_cast<py::ssize_t>(num_actions * sizeof(double)),
+                               static_cast<py::ssize_t>(sizeof(double))},
+                              data, base);
+    array.attr("setflags")(py::arg("write") = false);
+    return array;
+}
+
+// Cumulative regrets (or strategy sums) of a node's deal slot, (hands, actions).
+py::array Table(PySolver& self, const std::vector<std::string>& path, size_t deal, bool regrets) {
+    const nodes::ActionNode& node = self.Get().FindActionNode(path);
+    std::shared_ptr<solver::Trainable> trainable = TrainableAt(self, path, deal);
+    const size_t num_actions = node.GetActions().size();
+    const size_t num_hands = self.Ranges().GetPlayerRange(node.GetPlayerIndex()).size();
+    if (auto* dense = dynamic_cast<const solver::DiscountedCfrTrainable*>(trainable.get())) {
+        return TableView(trainable, regrets ? dense->CumulativeRegrets() : dense->StrategySums(), num_hands,
+                         num_actions);
+    }
+    py::array_t<double> array({static_cast<py::ssize_t>(num_hands), static_cast<py::ssize_t>(num_actions)});
+    auto out = array.mutable_unchecked<2>();
+    std::vector<double> hand_regrets(num_actions), hand_sums(num_actions);
+    for (size_t h = 0; h < num_hands; ++h) {
+        trainable->GetHandState(h, hand_regrets.data(), hand_sums.data());
+        const std::vector<double>& row = regrets ? hand_regrets : hand_sums;
+        for (size_t a = 0; a < num_actions; ++a) out(h, a) = row[a];
+    }
+    return array;
+}
+
+// Copy of a hand-major vector as (hands, actions).
+py::array HandMajorCopy(const std::vector<double>& values, size_t num_actions) {
+    const size_t num_hands = num_actions > 0 ? values.size() / num_actions : 0;
+    py::array_t<double> array({static_cast<py::ssize_t>(num_hands), static_cast<py::ssize_t>(num_actions)});
+    std::copy(values.begin(), values.begin() + num_hands * num_actions, array.mutable_data());
+    return array;
+}
+
+// (actions, hands) view of a strategy file's values; 8-bit files are
+// decoded into a copy.
+py::array FileMatrix(py::object self, size_t node, bool evs) {
+    const auto& file = self.cast<const solver::StrategyFile&>();
+    if (node >= file.NumNodes()) throw py::index_error("Strategy file node out of range.");
+    const unsigned char* values = evs ? file.EvValues(node) : file.StrategyValues(node);
+    if (!values) return py::none();
+    if (file.ValueType() == solver::StrategyValueType::kUint8) {
+        const std::vector<float> matrix = evs ? file.EvMatrix(node) : file.StrategyMatrix(node);
+        py::array_t<float> array({static_cast<py::ssize_t>(file.NumActions(node)),
+                                  static_cast<py::ssize_t>(file.NumHands(node))});
+        std::copy(matrix.begin(), matrix.end(), array.mutable_data());
+        return array;
+    }
+    const bool half = file.ValueType() == solver::StrategyValueType::kFloat16;
+    const size_t value_size = half ? sizeof(uint16_t) : sizeof(float);
+    py::array array(half ? py::dtype("e") : py::dtype::of<float>(),
+                    {static_cast<py::ssize_t>(file.NumActions(node)), static_cast<py::ssize_t>(file.NumHands(node))},
+                    {static_cast<py::ssize_t>(file.NumHands(node) * value_size), static_cast<py::ssize_t>(value_size)},
+                    values, self);
+    array.attr("setflags")(py::arg("write") = false);
+    return array;
+}
+
+std::vector<std::string> HandStrings(const std::vector<core::PrivateCards>& range) {
+    std::vector<std::string> hands;
+    hands.reserve(range.size());
+    for (const core::PrivateCards& hand : range) hands.push_back(hand.ToString());
+    return hands;
+}
+
+} // namespace
+
+PYBIND11_MODULE(poker_solver, m) {
+    m.doc() = "Poker CFR solver with NumPy access to strategies and regrets.";
+
+    py::class_<tree::GameTree, std::shared_ptr<tree::GameTree>>(m, "GameTree")
+        .def(py::init([](const std::string& scenario_json) {
+                 return std::make_shared<tree::GameTree>(ParseScenario(scenario_json).rule);
+             }),
+             py::arg("scenario_json"), "Builds the betting tree of a scenario (scenario file JSON).")
+        .def_property_readonly("num_action_nodes",
+                               [](const tree::GameTree& t) { return t.GetBuildStats().action_nodes; })
+        .def_property_readonly("num_trainables",
+                               [](const tree::GameTree& t) { return t.GetBuildStats().NumTrainables(); })
+        .def_property_readonly("tree_bytes", &tree::GameTree::EstimateTreeMemory);
+
+    py::class_<PySolver>(m, "Solver")
+        .def(py::init<const std::string&, int, int, const std::string&, std::shared_ptr<tree::GameTree>>(),
+             py::arg("scenario_json"), py::arg("iterations") = 0, py::arg("threads") = 0,
+             py::arg("precision") = "double", py::arg("tree") = nullptr,
+             "iterations and threads default to the scenario's solver_config (else 1000 and 1).")
+        .def("train", [](PySolver& self) { self.Get().Train(); }, py::call_guard<py::gil_scoped_release>(),
+             "Trains up to the iteration limit; other Python threads run meanwhile.")
+        .def("stop", [](PySolver& self) { self.Get().Stop(); },
+             "Makes a running train() return after its current iteration; safe from any thread.")
+        .def_property_readonly("iterations", [](PySolver& self) { return self.Get().GetCompletedIterations(); })
+        .def("exploitability", [](PySolver& self) { return self.Get().ComputeExploitability(); },
+             py::call_guard<py::gil_scoped_release>(), "Exploitability in percent of the starting pot.")
+        .def("compute_evs", [](PySolver& self, int max_depth) { self.Get().ComputeEvs(max_depth); },
+             py::arg("max_depth") = -1, py::call_guard<py::gil_scoped_release>(),
+             "Sets the EVs of the nodes at most max_depth below the root (-1: all).")
+        .def("range", [](PySolver& self, size_t player) { return HandStrings(self.Ranges().GetPlayerRange(player)); },
+             py::arg("player"), "Hands of a player (0: IP, 1: OOP), in table row order.")
+        .def("actions",
+             [](PySolver& self, const std::vector<std::string>& path) {
+                 std::vector<std::string> actions;
+                 for (const auto& action : self.Get().FindActionNode(path).GetActions()) {
+                     actions.push_back(action.ToString());
+                 }
+                 return actions;
+             },
+             py::arg("path"))
+        .def("player", [](PySolver& self, const std::vector<std::string>& path) {
+                 return self.Get().FindActionNode(path).GetPlayerIndex();
+             }, py::arg("path"))
+        .def("num_deals", [](PySolver& self, const std::vector<std::string>& path) {
+                 return self.Get().FindActionNode(path).GetNumPossibleDeals();
+             }, py::arg("path"))
+        .def("regrets", [](PySolver& self, const std::vector<std::string>& path, size_t deal) {
+                 return Table(self, path, deal, true);
+             }, py::arg("path"), py::arg("deal") = 0, "Cumulative regrets, (hands, actions).")
+        .def("strategy_sums", [](PySolver& self, const std::vector<std::string>& path, size_t deal) {
+                 return Table(self, path, deal, false);
+             }, py::arg("path"), py::arg("deal") = 0, "Cumulative strategy sums, (hands, actions).")
+        .def("average_strategy",
+             [](PySolver& self, const std::vector<std::string>& path, size_t deal) {
+                 std::shared_ptr<solver::Trainable> trainable = TrainableAt(self, path, deal);
+                 return HandMajorCopy(trainable->GetAverageStrategy(),
+                                      self.Get().FindActionNode(path).GetActions().size());
+             },
+             py::arg("path"), py::arg("deal") = 0, "Average strategy (a copy), (hands, actions).")
+        .def("evs",
+             [](PySolver& self, const std::vector<std::string>& path, size_t deal) {
+                 std::shared_ptr<solver::Trainable> trainable = TrainableAt(self, path, deal);
+                 return HandMajorCopy(trainable->GetEvs(), self.Get().FindActionNode(path).GetActions().size());
+             },
+             py::arg("path"), py::arg("deal") = 0, "EVs (a copy), (hands, actions); empty if none were set.")
+        .def("write_strategy_file",
+             [](PySolver& self, const std::string& path, bool half, bool quantized) {
+                 self.Get().WriteStrategyFile(path, quantized ? solver::StrategyValueType::kUint8
+                                                    : half    ? solver::StrategyValueType::kFloat16
+                                                              : solver::StrategyValueType::kFloat32);
+             },
+             py::arg("path"), py::arg("half") = false, py::arg("quantized") = false,
+             py::call_guard<py::gil_scoped_release>(),
+             "half: 16-bit floats; quantized: 8-bit values with per-node scales.");
+
+    py::class_<solver::StrategyFile, std::shared_ptr<solver::StrategyFile>>(m, "StrategyFile")
+        .def(py::init<const std::string&>(), py::arg("path"))
+        .def_property_readonly("num_nodes", &solver::StrategyFile::NumNodes)
+        .def("find", [](const solver::StrategyFile& file, const std::string& path) { return file.Find(path); },
+             py::arg("path"), "Node number of a '/'-separated path, or None.")
+        .def("path", [](const solver::StrategyFile& file, size_t node) { return std::string(file.Path(node)); })
+        .def("player", &solver::StrategyFile::Player)
+        .def("actions", &solver::StrategyFile::Actions)
+        .def("hands",
+             [](const solver::StrategyFile& file, size_t node) {
+                 std::vector<std::string> hands;
+                 for (size_t h = 0; h < file.NumHands(node); ++h) hands.push_back(file.Hand(node, h).ToString());
+                 return hands;
+             })
+        .def("strategy", [](py::object self, size_t node) { return FileMatrix(self, node, false); },
+             py::arg("node"), "Average strategy over the mapping (no copy, except for 8-bit files), (actions, hands).")
+        .def("evs", [](py::object self, size_t node) { return FileMatrix(self, node, true); },
+             py::arg("node"),
+             "EVs over the mapping (no copy, except for 8-bit files), (actions, hands); None if the node has none.");
+}
@@ -23,8 +23,10 @@ const std::array<char, kNumRanks>& Card::GetAllRankChars() {
 
 // --- Helper Functions ---
 
-bool Card::IsValidCardInt(int card_int) {
-    return card_int >= 0 && card_int < kNumCardsInDeck;
+void Card::ThrowInvalidCardInt(int card_int) {
+    std::ostringstream oss;
+    oss << "Invalid card integer for bitmask: " << card_int;
+    throw std::out_of_range(oss.str());
 }
 
 char Card::SuitIndexToChar(int suit_index) {
@@ -134,14 +136,6 @@ std::string Card::IntToString(int card_int) {
 
 // --- Static Bitmask Utilities ---
 
-uint64_t Card::CardIntsToUint64(const std::vector<int>& card_ints) {
-    uint64_t board_mask = 0;
-    for (int card_int : card_ints) {
-        board_mask |= CardIntToUint64(card_int);
-    }
-    return board_mask;
-}
-
 uint64_t Card::CardsToUint64(const std::vector<Card>& cards) {
     uint64_t board_mask = 0;
     for (const auto& card : cards) {
@@ -150,15 +144,6 @@ uint64_t Card::CardsToUint64(const std::vector<Card>& cards) {
     return board_mask;
 }
 
-uint64_t Card::CardIntToUint64(int card_int) {
-    if (!IsValidCardInt(card_int)) {
-        std::ostringstream oss;
-        oss << "Invalid card integer for bitmask: " << card_int;
-        throw std::out_of_range(oss.str());
-    }
-    return static_cast<uint64_t>(1) << card_int;
-}
-
 uint64_t Card::CardToUint64(const Card& card) {
     if (card.IsEmpty()) {
         return 0;
@@ -168,29 +153,17 @@ uint64_t Card::CardToUint64(const Card& card) {
 
 std::vector<int> Card::Uint64ToCardInts(uint64_t board_mask) {
     std::vector<int> card_ints;
-    card_ints.reserve(7);
-    for (int i = 0; i < kNumCardsInDeck; ++i) {
-        if ((board_mask >> i) & 1) {
-            card_ints.push_back(i);
-        }
-    }
+    card_ints.reserve(CountCards(board_mask));
+    ForEachCard(board_mask & ((1ULL << kNumCardsInDeck) - 1), [&](int card) { card_ints.push_back(card); });
     return card_ints;
 }
 
 std::vector<Card> Card::Uint64ToCards(uint64_t board_mask) {
     std::vector<Card> cards;
-    cards.reserve(7);
-    std::vector<int> card_ints = Uint64ToCardInts(board_mask);
-    for (int card_int : card_ints) {
-        cards.emplace_back(card_int);
-    }
+    cards.reserve(CountCards(board_mask));
+    ForEachCard(board_mask & ((1ULL << kNumCardsInDeck) - 1), [&](int card) { cards.emplace_back(card); });
     return cards;
 }
 
-bool Card::DoBoardsOverlap(uint64_t board_mask1, uint64_t board_mask2) {
-    return (board_mask1 & board_mask2) != 0;
-}
-
-
 } // namespace core
 } // namespace poker_solver
@@ -44,6 +44,11 @@ Deck::Deck(const std::vector<std::string_view>& ranks,
     // This class primarily assumes a standard deck structure internally.
 }
 
+Deck Deck::ShortDeck() {
+    Deck deck;
+    deck.cards_.erase(deck.cards_.begin(), deck.cards_.begin() + kShortDeckLowestRank * kNumSuits);
+    return deck;
+}
 
 const std::vector<Card>& Deck::GetCards() const {
     return cards_;
@@ -59,26 +64,33 @@ Card Deck::FindCard(std::string_view card_str) const {
 }
 
 Card Deck::FindCard(int card_int) const {
-    // Check if the integer is valid and if the deck is standard size.
-    // This check assumes the deck intends to be standard if FindCard(int) is used.
-    if (Card::IsValidCardInt(card_int) && cards_.size() == kNumCardsInDeck) {
-         // In a standard ordered deck, the card at index `card_int` should
-         // be the card with that integer value.
-         if (!cards_[card_int].IsEmpty() && cards_[card_int].card_int() == card_int) {
-             return cards_[card_int];
-         }
-         // Fallback: If deck isn't ordered or standard, search linearly.
-         // This shouldn't happen with the default constructor.
-         for (const auto& card : cards_) {
-             if (!card.IsEmpty() && card.card_int() == card_int) {
-                 return card;
-             }
-         }
+    if (!Card::IsValidCardInt(card_int)) {
+        return Card();
+    }
+    // In a standard ordered deck, the card at index `card_int` should
+    // be the card with that integer value.
+    if (cards_.size() == kNumCardsInDeck && !cards_[card_int].IsEmpty() &&
+        cards_[card_int].card_int() == card_int) {
+        return cards_[card_int];
+    }
+    // Otherwise (short or custom decks), search linearly.
+    for (const auto& card : cards_) {
+        if (!card.IsEmpty() && card.card_int() == card_int) {
+            return card;
+        }
     }
-    // Return empty card if not found or index is invalid for standard deck.
+    // Return empty card if the deck does not hold it.
     return Card();
 }
 
+uint64_t Deck::GetCardsMask() const {
+    uint64_t mask = 0;
+    for (const auto& card : cards_) {
+        if (!card.IsEmpty()) mask |= Card::CardToUint64(card);
+    }
+    return mask;
+}
+
 
 } // namespace core
 } // namespace poker_solver
@@ -0,0 +1,125 @@
+#include "FlatGameTree.h"
+#include "GameTree.h"
+#include "nodes/ActionNode.h"
+#include "nodes/ChanceNode.h"
+#include "nodes/ShowdownNode.h"
+#include "nodes/TerminalNode.h"
+
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace core = poker_solver::core;
+namespace nodes = poker_solver::nodes;
+
+namespace poker_solver {
+namespace tree {
+
+FlatGameTree::FlatGameTree(const GameTree& tree) : FlatGameTree(tree.GetRoot()) {}
+
+FlatGameTree::FlatGameTree(const std::shared_ptr<core::GameTreeNode>& root) {
+    if (!root) return;
+
+    // Breadth-first: a node's children get consecutive slots when the node
+    // is filled in, and are filled in themselves later. sources[i] is the
+    // node behind nodes_[i]; the source tree keeps it alive.
+    std::vector<core::GameTreeNode*> sources = {root.get()};
+    auto add_children = [&](FlatNode& flat, const std::vector<core::GameTreeNode*>& children) {
+        if (sources.size() + children.size() > std::numeric_limits<uint32_t>::max()) {
+            throw std::length_error("FlatGameTree: too many nodes for 32-bit indices.");
+        }
+        flat.first_child = static_cast<uint32_t>(sources.size());
+        flat.num_children = static_cast<uint32_t>(children.size());
+        sources.insert(sources.end(), children.begin(), children.end());
+    };
+    auto require_payoffs = [](const std::vector<double>& payoffs) {
+        if (payoffs.size() < 2) {
+            throw std::invalid_argument("FlatGameTree: payoffs must cover both players.");
+        }
+    };
+
+    std::vector<core::GameTreeNode*> children;
+    for (size_t i = 0; i < sources.size(); ++i) {
+        core::GameTreeNode* source = sources[i];
+        FlatNode flat;
+        flat.type = source->GetNodeType();
+        flat.round = source->GetRound();
+        flat.pot = source->GetPot();
+        children.clear();
+
+        switch (flat.type) {
+            case core::GameTreeNodeType::kAction: {
+                auto* action_node = static_cast<nodes::ActionNode*>(source);
+                if (action_node->GetChildren().size() != action_node->GetActions().size()) {
+                    std::ostringstream oss;
+                    oss << "FlatGameTree: action node with " << action_node->GetActions().size()
+                        << " actions has " << action_node->GetChildren().size() << " children.";
+                    throw std::invalid_argument(oss.str());
+                }
+                for (const auto& child : action_node->GetChildren()) {
+                    if (!child) throw std::invalid_argument("FlatGameTree: null child of an action node.");
+                    children.push_back(child.get());
+                }
+                flat.player = static_cast<uint8_t>(action_node->GetPlayerIndex());
+                flat.payload = static_cast<uint32_t>(action_nodes_.size());
+                action_nodes_.push_back(action_node);
+                break;
+            }
+            case core::GameTreeNodeType::kChance: {
+                // A chance node without a child is kept; traversals reject it.
+                auto* chance_node = static_cast<nodes::ChanceNode*>(source);
+                if (chance_node->GetChild()) children.push_back(chance_node->GetChild().get());
+                break;
+            }
+            case core::GameTreeNodeType::kShowdown: {
+                auto* showdown_node = static_cast<nodes::ShowdownNode*>(source);
+                flat.payload = static_cast<uint32_t>(payoffs_.size());
+                for (auto result : {core::ComparisonResult::kPlayer1Wins, core::ComparisonResult::kPlayer2Wins,
+                                    core::ComparisonResult::kTie}) {
+                    const auto& payoffs = showdown_node->GetPayoffs(result);
+                    require_payoffs(payoffs);
+                    payoffs_.insert(payoffs_.end(), payoffs.begin(), payoffs.begin() + 2);
+                }
+                break;
+            }
+            case core::GameTreeNodeType::kTerminal: {
+                const auto& payoffs = static_cast<nodes::TerminalNode*>(source)->GetPayoffs();
+                require_payoffs(payoffs);
+                flat.payload = static_cast<uint32_t>(payoffs_.size());
+                payoffs_.insert(payoffs_.end(), payoffs.begin(), payoffs.begin() + 2);
+                break;
+            }
+        }
+        add_children(flat, children);
+        nodes_.push_back(flat);
+    }
+
+    // Children come after their parents, so a backward pass sees a chance
+    // node's child finished.
+    for (size_t i = nodes_.size(); i-- > 0;) {
+        FlatNode& node = nodes_[i];
+        if (node.type != core::GameTreeNodeType::kChance || node.num_children == 0) continue;
+        const FlatNode& child = nodes_[node.first_child];
+        if (child.type == core::GameTreeNodeType::kShowdown) {
+            node.runout_streets = 1;
+        } else if (child.type == core::GameTreeNodeType::kChance && child.runout_streets > 0) {
+            node.runout_streets = static_cast<uint8_t>(child.runout_streets + 1);
+        }
+    }
+}
+
+size_t FlatGameTree::Count(core::GameTreeNodeType type) const {
+    size_t count = 0;
+    for (const FlatNode& node : nodes_) {
+        if (node.type == type) ++count;
+    }
+    return count;
+}
+
+size_t FlatGameTree::MemoryBytes() const {
+    return nodes_.capacity() * sizeof(FlatNode) + action_nodes_.capacity() * sizeof(nodes::ActionNode*) +
+           payoffs_.capacity() * sizeof(double);
+}
+
+} // namespace tree
+} // namespace poker_solver
@@ -6,7 +6,8 @@
 #include "nodes/GameActions.h"
 #include "Card.h"
 #include "tools/StreetSetting.h"
-#include "trainable/Trainable.h" // Needed for EstimateMemoryRecursive
+#include "tools/BinaryIo.h"   // For tree files
+#include "tools/MappedFile.h" // For tree files
 
 #include <fstream>   // For std::ifstream
 #include <stdexcept> // For exceptions
@@ -21,6 +22,12 @@
 #include <utility>   // For std::move
 #include <optional>  // For build_rule_ member
 #include <bit>       // For std::popcount (optional)
+#include <array>
+#include <limits>
+#include <exception> // For std::exception_ptr
+#include <cstring>   // For std::memcpy, std::memcmp
+#include <filesystem> // For renaming tree files into place
+#include <omp.h>
 
 // Use aliases
 using json = nlohmann::json;
@@ -67,6 +74,45 @@ GameTree::GameTree(const std::string& json_filepath, const core::Deck& deck)
 
 GameTree::GameTree(const config::Rule& rule)
     : deck_(rule.GetDeck()), build_rule_(rule) { // Copy deck and store rule
+    Build(rule);
+}
+
+GameTree::GameTree(const config::Rule& rule, const TreeMemoryBudget& budget)
+    : deck_(rule.GetDeck()), build_rule_(rule) {
+    Build(rule);
+    if (budget.max_bytes == 0) return;
+
+    auto estimate_bytes = [&]() {
+        return build_stats_.TrainableBytes(budget.range_sizes, budget.precision,
+                                           budget.algorithm, budget.lazy_strategies);
+    };
+    config::Rule reduced_rule = rule;
+    config::GameTreeBuildingSettings settings = rule.GetBuildSettings();
+    uint64_t bytes = estimate_bytes();
+    while (bytes > budget.max_bytes) {
+        std::optional<core::GameRound> street = ThinDeepestStreet(settings);
+        if (!street) {
+            std::cerr << "[WARNING] Game tree needs " << bytes << " bytes of trainables, over the "
+                      << budget.max_bytes << " byte budget, even with one bet size per street." << std::endl;
+            break;
+        }
+        reduced_rule.SetBuildSettings(settings);
+        Build(reduced_rule);
+        uint64_t reduced_bytes = estimate_bytes();
+        std::cout << "[INFO] Game tree over memory budget (" << bytes << " > " << budget.max_bytes
+                  << " bytes); thinned " << core::GameTreeNode::GameRoundToString(*street)
+                  << " bet sizes, now " << reduced_bytes << " bytes." << std::endl;
+        bytes = reduced_bytes;
+    }
+    build_rule_.emplace(reduced_rule);
+}
+
+void GameTree::Build(const config::Rule& rule) {
+    build_stats_ = TreeBuildStats();
+    uint64_t board_mask = core::Card::CardIntsToUint64(rule.GetInitialBoardCardsInt());
+    num_deal_cards_ = 0;
+    uint64_t deal_mask = rule.GetDeck().GetCardsMask() & ~board_mask;
+    for (; deal_mask != 0; deal_mask &= deal_mask - 1) ++num_deal_cards_;
 
     size_t starting_player = 1; // Default to OOP acting first postflop
     if (rule.GetStartingRound() == core::GameRound::kPreflop) {
@@ -82,47 +128,257 @@ GameTree::GameTree(const config::Rule& rule)
         1 // Assume perfect recall initially
     );
 
-    // Start the recursive build process
-    // Pass the initial rule by value as it will be modified
-    BuildBranch(root_, rule, core::GameAction(core::PokerAction::kRoundBegin), 0, 0);
+    // Start the recursive build process; it also sets every node's depth and
+    // subtree size. One thread starts it, the team picks up subtree tasks.
+    // Exceptions may not leave the region, so they are carried out of it.
+    std::exception_ptr error;
+    #pragma omp parallel
+    #pragma omp single
+    {
+        try {
+            BuildBranch(root_, rule, core::GameAction(core::PokerAction::kRoundBegin), 0, 0, DealPath(),
+                        0, build_stats_);
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+    if (error) std::rethrow_exception(error);
+}
 
-    // Calculate metadata after building
-    CalculateTreeMetadata();
+namespace {
+
+// Drops one size from 'sizes' if it holds more than one: the smaller of the
+// two closest sizes (by ratio), i.e. the most redundant one.
+bool ThinSizes(std::vector<double>& sizes) {
+    if (sizes.size() < 2) return false;
+    std::vector<double> sorted = sizes;
+    std::sort(sorted.begin(), sorted.end());
+    size_t drop = 0;
+    double closest_ratio = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i + 1 < sorted.size(); ++i) {
+        double ratio = sorted[i] > 0.0 ? sorted[i + 1] / sorted[i] : 0.0;
+        if (ratio < closest_ratio) {
+            closest_ratio = ratio;
+            drop = i;
+        }
+    }
+    sizes.erase(std::find(sizes.begin(), sizes.end(), sorted[drop]));
+    return true;
+}
+
+} // namespace
+
+std::optional<core::GameRound> GameTree::ThinDeepestStreet(config::GameTreeBuildingSettings& settings) {
+    const std::pair<core::GameRound, std::array<config::StreetSetting*, 2>> streets[] = {
+        {core::GameRound::kRiver, {&settings.river_ip_setting, &settings.river_oop_setting}},
+        {core::GameRound::kTurn, {&settings.turn_ip_setting, &settings.turn_oop_setting}},
+        {core::GameRound::kFlop, {&settings.flop_ip_setting, &settings.flop_oop_setting}},
+    };
+    for (const auto& street : streets) {
+        bool thinned = false;
+        for (config::StreetSetting* setting : street.second) {
+            thinned |= ThinSizes(setting->bet_sizes_percent);
+            thinned |= ThinSizes(setting->raise_sizes_percent);
+            thinned |= ThinSizes(setting->donk_sizes_percent);
+        }
+        if (thinned) return street.first;
+    }
+    return std::nullopt;
+}
+
+// --- Build Statistics ---
+
+void TreeBuildStats::Merge(const TreeBuildStats& other) {
+    action_nodes += other.action_nodes;
+    chance_nodes += other.chance_nodes;
+    showdown_nodes += other.showdown_nodes;
+    terminal_nodes += other.terminal_nodes;
+    leaf_nodes += other.leaf_nodes;
+    deal_slots += other.deal_slots;
+    auto add = [](std::vector<uint64_t>& counts, const std::vector<uint64_t>& other_counts) {
+        if (counts.size() < other_counts.size()) counts.resize(other_counts.size(), 0);
+        for (size_t a = 0; a < other_counts.size(); ++a) counts[a] += other_counts[a];
+    };
+    for (size_t p = 0; p < trainables_by_actions.size(); ++p) {
+        add(trainables_by_actions[p], other.trainables_by_actions[p]);
+        for (size_t r = 0; r < trainables_by_round.size(); ++r) {
+            add(trainables_by_round[r][p], other.trainables_by_round[r][p]);
+        }
+    }
+}
+
+void TreeBuildStats::AddTrainables(size_t player, core::GameRound round, size_t num_actions, uint64_t count) {
+    for (auto* per_actions : {&trainables_by_actions[player],
+                              &trainables_by_round[core::GameTreeNode::GameRoundToInt(round)][player]}) {
+        if (per_actions->size() <= num_actions) per_actions->resize(num_actions + 1, 0);
+        (*per_actions)[num_actions] += count;
+    }
+}
+
+uint64_t TreeBuildStats::TreeBytes() const {
+    const uint64_t num_nodes = action_nodes + chance_nodes + showdown_nodes + terminal_nodes;
+    if (num_nodes == 0) return 0;
+    // make_shared puts each node next to its control block.
+    constexpr uint64_t kControlBlockBytes = 2 * sizeof(long);
+    uint64_t bytes = action_nodes * (sizeof(nodes::ActionNode) + kControlBlockBytes) +
+                     chance_nodes * (sizeof(nodes::ChanceNode) + kControlBlockBytes) +
+                     showdown_nodes * (sizeof(nodes::ShowdownNode) + kControlBlockBytes +
+                                       3 * 2 * sizeof(double)) +
+                     terminal_nodes * (sizeof(nodes::TerminalNode) + kControlBlockBytes + 2 * sizeof(double));
+    // Every node but the root and the chance children is an action's child.
+    const uint64_t chance_edges = chance_nodes - std::min<uint64_t>(leaf_nodes, chance_nodes);
+    const uint64_t action_edges = num_nodes - 1 - std::min<uint64_t>(chance_edges, num_nodes - 1);
+    bytes += action_edges * (sizeof(core::GameAction) + sizeof(std::shared_ptr<core::GameTreeNode>));
+    bytes += deal_slots * sizeof(std::shared_ptr<solver::Trainable>);
+    return bytes;
+}
+
+uint64_t TreeBuildStats::NumTrainables() const {
+    uint64_t total = 0;
+    for (const auto& per_player : trainables_by_actions) {
+        for (uint64_t count : per_player) total += count;
+    }
+    return total;
+}
+
+uint64_t TreeBuildStats::TrainableBytes(const std::array<size_t, 2>& range_sizes,
+                                        nodes::ActionNode::TrainablePrecision precision,
+                                        nodes::ActionNode::TrainableAlgorithm algorithm,
+                                        bool lazy_strategies) const {
+    uint64_t bytes = 0;
+    for (size_t p = 0; p < trainables_by_actions.size(); ++p) {
+        const auto& per_player = trainables_by_actions[p];
+        for (size_t num_actions = 0; num_actions < per_player.size(); ++num_actions) {
+            if (per_player[num_actions] == 0) continue;
+            bytes += per_player[num_actions] *
+                     nodes::ActionNode::TrainableBytes(num_actions, range_sizes[p], precision,
+                                                       algorithm, lazy_strategies);
+        }
+    }
+    return bytes;
+}
+
+uint64_t TreeBuildStats::TrainableBytesFrom(core::GameRound first_round, const std::array<size_t, 2>& range_sizes,
+                                            nodes::ActionNode::TrainablePrecision precision,
+                                            nodes::ActionNode::TrainableAlgorithm algorithm,
+                                            bool lazy_strategies) const {
+    uint64_t bytes = 0;
+    for (size_t r = static_cast<size_t>(core::GameTreeNode::GameRoundToInt(first_round)); r < trainables_by_round.size();
+         ++r) {
+        for (size_t p = 0; p < trainables_by_round[r].size(); ++p) {
+            const auto& per_player = trainables_by_round[r][p];
+            for (size_t num_actions = 0; num_actions < per_player.size(); ++num_actions) {
+                if (per_player[num_actions] == 0) continue;
+                bytes += per_player[num_actions] *
+                         nodes::ActionNode::TrainableBytes(num_actions, range_sizes[p], precision,
+                                                           algorithm, lazy_strategies);
+            }
+        }
+    }
+    return bytes;
 }
 
 
 // --- Dynamic Tree Building Helpers ---
 
 // Pass Rule by value because commitments are modified for child branches
-void GameTree::BuildBranch(std::shared_ptr<core::GameTreeNode> current_node,
-                           config::Rule current_rule, // Pass Rule by value
-                           const core::GameAction& last_action,
-                           int actions_this_round,
-                           int raises_this_street) {
-    if (!current_node) return;
-
+int GameTree::BuildBranch(std::shared_ptr<core::GameTreeNode> current_node,
+                          config::Rule current_rule, // Pass Rule by value
+                          const core::GameAction& last_action,
+                          int actions_this_round,
+                          int raises_this_street,
+                          const DealPath& deals,
+                          int depth,
+                          TreeBuildStats& stats) const {
+    if (!current_node) return 0;
+
+    current_node->SetDepth(depth);
+    int subtree_size = 1;
     switch(current_node->GetNodeType()) {
         case core::GameTreeNodeType::kAction: {
-            auto action_node = std::dynamic_pointer_cast<nodes::ActionNode>(current_node);
-            BuildActionNode(action_node, current_rule, last_action, actions_this_round, raises_this_street);
+            auto action_node = std::static_pointer_cast<nodes::ActionNode>(current_node);
+            subtree_size = BuildActionNode(action_node, current_rule, last_action, actions_this_round,
+                                           raises_this_street, deals, depth, stats);
             break;
         }
         case core::GameTreeNodeType::kChance: {
-             auto chance_node = std::dynamic_pointer_cast<nodes::ChanceNode>(current_node);
+             auto chance_node = std::static_pointer_cast<nodes::ChanceNode>(current_node);
              if (!build_rule_.has_value()) {
                  // This should not happen if built dynamically via the Rule constructor
                  throw std::logic_error("Build rule not set in GameTree for ChanceNode building.");
              }
-            BuildChanceNode(chance_node, current_rule); // Use stored original rule
+            subtree_size = BuildChanceNode(chance_node, current_rule, deals, depth, stats); // Use stored original rule
             break;
         }
         case core::GameTreeNodeType::kShowdown: // Terminal state
+            ++stats.showdown_nodes; // Recursion stops here
+            break;
         case core::GameTreeNodeType::kTerminal: // Terminal state
-            // Do nothing, recursion stops here
+            ++stats.terminal_nodes; // Recursion stops here
             break;
         // default: // Optional: Add default for robustness
         //     throw std::logic_error("Unknown node type encountered during tree build.");
     }
+    current_node->SetSubtreeSize(subtree_size);
+    return subtree_size;
+}
+
+namespace {
+
+// Action nodes up to this depth build their betting children as tasks. The
+// first few levels already give far more subtrees than threads.
+constexpr int kMaxTaskDepth = 4;
+
+} // namespace
+
+int GameTree::BuildChildren(const std::vector<PendingBranch>& children,
+                            const DealPath& deals,
+                            int depth,
+                            TreeBuildStats& stats) const {
+    auto is_leaf = [](const PendingBranch& child) {
+        core::GameTreeNodeType type = child.node->GetNodeType();
+        return type == core::GameTreeNodeType::kShowdown || type == core::GameTreeNodeType::kTerminal;
+    };
+    int subtree_size = 0;
+    if (depth > kMaxTaskDepth || !omp_in_parallel()) {
+        for (const PendingBranch& child : children) {
+            subtree_size += BuildBranch(child.node, child.rule, child.last_action, child.actions_this_round,
+                                        child.raises_this_street, deals, depth, stats);
+        }
+        return subtree_size;
+    }
+
+    std::vector<TreeBuildStats> child_stats(children.size());
+    std::vector<int> child_sizes(children.size(), 0);
+    std::vector<std::exception_ptr> errors(children.size());
+    for (size_t i = 0; i < children.size(); ++i) {
+        const PendingBranch& child = children[i];
+        if (is_leaf(child)) {
+            child_sizes[i] = BuildBranch(child.node, child.rule, child.last_action, child.actions_this_round,
+                                         child.raises_this_street, deals, depth, child_stats[i]);
+            continue;
+        }
+        #pragma omp task default(shared) firstprivate(i)
+        {
+            const PendingBranch& task_child = children[i];
+            try {
+                child_sizes[i] = BuildBranch(task_child.node, task_child.rule, task_child.last_action,
+                                             task_child.actions_this_round, task_child.raises_this_street,
+                                             deals, depth, child_stats[i]);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        }
+    }
+    #pragma omp taskwait
+    for (const std::exception_ptr& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+    for (size_t i = 0; i < children.size(); ++i) {
+        subtree_size += child_sizes[i];
+        stats.Merge(child_stats[i]);
+    }
+    return subtree_size;
 }
 
 // Builds the structure following a ChanceNode
@@ -132,9 +388,13 @@ void GameTree::BuildBranch(std::shared_ptr<core::GameTreeNode> current_node,
 // src/GameTree.cpp
 
 // Builds the structure following a ChanceNode
-void GameTree::BuildChanceNode(std::shared_ptr<nodes::ChanceNode> node,
-                               const config::Rule& rule_at_chance_creation) { // Rule state when this ChanceNode was decided
-    if (!node) return;
+int GameTree::BuildChanceNode(std::shared_ptr<nodes::ChanceNode> node,
+                              const config::Rule& rule_at_chance_creation, // Rule state when this ChanceNode was decided
+                              const DealPath& deals,
+                              int depth,
+                              TreeBuildStats& stats) const {
+    if (!node) return 0;
+    ++stats.chance_nodes;
 
     // round_completed_by_this_chance_deal is the round that this ChanceNode's dealt cards complete.
     // e.g., if this node deals the Turn card, this variable will be GameRound::kTurn.
@@ -187,6 +447,10 @@ void GameTree::BuildChanceNode(std::shared_ptr<nodes::ChanceNode> node,
              round_for_next_deal, current_pot, node,
              std::vector<core::Card>{}, nullptr
          );
+    } else if (rule_at_chance_creation.IsDepthLimited()) {
+        // Depth limit: the next street's betting is left to the solver's leaf values.
+        ++stats.leaf_nodes;
+        return 1;
     } else {
         // Not an all-in runout, and not the river deal. Next is an ActionNode for betting on the current street.
         // The round for this ActionNode is the street that was just completed by this ChanceNode's deal.
@@ -201,9 +465,18 @@ void GameTree::BuildChanceNode(std::shared_ptr<nodes::ChanceNode> node,
     }
 
     node->SetChild(child_node_after_this_deal);
+    // Turn and river deals multiply the deal slots below (the solver does not
+    // split flop deals).
+    DealPath child_deals = deals;
+    if (round_completed_by_this_chance_deal != core::GameRound::kFlop) {
+        child_deals.deal_slots *= num_deal_cards_;
+        child_deals.reachable *= num_deal_cards_ - static_cast<uint64_t>(deals.cards_dealt);
+        ++child_deals.cards_dealt;
+    }
     // When recursing from a ChanceNode, the 'rule_at_chance_creation' is passed along.
     // The actions_this_round and raises_this_street are reset because a new street/betting sequence begins.
-    BuildBranch(child_node_after_this_deal, rule_at_chance_creation, core::GameAction(core::PokerAction::kRoundBegin), 0, 0);
+    return 1 + BuildBranch(child_node_after_this_deal, rule_at_chance_creation,
+                           core::GameAction(core::PokerAction::kRoundBegin), 0, 0, child_deals, depth + 1, stats);
 }}
 
 
@@ -213,12 +486,17 @@ void GameTree::BuildChanceNode(std::shared_ptr<nodes::ChanceNode> node,
 
 // Builds the structure for an ActionNode
 // Takes Rule by value as it modifies it for recursive calls
-void tree::GameTree::BuildActionNode(std::shared_ptr<nodes::ActionNode> node,
+int tree::GameTree::BuildActionNode(std::shared_ptr<nodes::ActionNode> node,
     config::Rule current_rule_state, // Takes Rule by value
     const core::GameAction& last_action,
     int actions_this_round,
-    int raises_this_street) {
-    if (!node) return;
+    int raises_this_street,
+    const DealPath& deals,
+    int depth,
+    TreeBuildStats& stats) const {
+    if (!node) return 0;
+    ++stats.action_nodes;
+    stats.deal_slots += deals.deal_slots;
 
     size_t current_player = node->GetPlayerIndex();
     size_t opponent_player = 1 - current_player;
@@ -253,15 +531,16 @@ void tree::GameTree::BuildActionNode(std::shared_ptr<nodes::ActionNode> node,
         // If not, this node should probably be a Showdown or Terminal.
         // To prevent infinite loops or errors, we stop further branching from here.
         node->SetActionsAndChildren({}, {});
-        return;
+        return 1;
     } else if (player_stack_remaining <= 1e-9) { // Player is all-in and no decision to make
         node->SetActionsAndChildren({}, {}); // No actions if all-in
-        return;
+        return 1;
     }
 
 
     std::vector<core::GameAction> possible_node_actions;
     std::vector<std::shared_ptr<core::GameTreeNode>> children_nodes;
+    std::vector<PendingBranch> pending_children; // Built once all actions are known
 
     constexpr double eps = 1e-9;
 
@@ -313,7 +592,8 @@ void tree::GameTree::BuildActionNode(std::shared_ptr<nodes::ActionNode> node,
             //<< ". Pot: " << pot_before_action << std::endl;
         }
     children_nodes.push_back(child_node_after_check);
-    BuildBranch(child_node_after_check, current_rule_state, check_action, actions_this_round + 1, raises_this_street);
+    pending_children.push_back({child_node_after_check, current_rule_state, check_action,
+                                actions_this_round + 1, raises_this_street});
     }
 
     // --- 2. Call Action ---
@@ -361,7 +641,8 @@ void tree::GameTree::BuildActionNode(std::shared_ptr<nodes::ActionNode> node,
     config::Rule next_rule_call = current_rule_state;
     if (current_player == 0) next_rule_call.SetInitialIpCommit(next_player_commit);
     else next_rule_call.SetInitialOopCommit(next_player_commit);
-    BuildBranch(child_node_after_call, next_rule_call, call_action, actions_this_round + 1, raises_this_street);
+    pending_children.push_back({child_node_after_call, next_rule_call, call_action,
+                                actions_this_round + 1, raises_this_street});
 }
 
 // --- 3. Fold Action ---
@@ -398,14 +679,14 @@ void tree::GameTree::BuildActionNode(std::shared_ptr<nodes::ActionNode> node,
     // std::cout << "    [GTB Debug BuildActionNode] Fold -> Created TerminalNode. Pot: " << pot_before_action << std::endl;
 
     children_nodes.push_back(child_node_after_fold);
-    // No BuildBranch for TerminalNode
+    pending_children.push_back({child_node_after_fold, current_rule_state, fold_action,
+                                actions_this_round + 1, raises_this_street});
     }
 
     // --- 4. Bet / Raise Actions ---
     if (can_bet_or_raise) {
         bool is_facing_action = opponent_commit > current_player_commit + eps;
         bool is_raise = is_facing_action;
-        auto action_type = is_raise ? core::PokerAction::kRaise : core::PokerAction::kBet;
 
         std::vector<double> bet_amounts_to_add = GetPossibleBets(
         current_rule_state, current_player, current_player_commit, opponent_commit,
@@ -423,71 +704,235 @@ void tree::GameTree::BuildActionNode(std::shared_ptr<nodes::ActionNode> node,
         }
 
 
-        core::GameAction bet_raise_action(action_type, actual_bet_or_raise_value);
-        possible_node_actions.push_back(bet_raise_action);
+        PendingBranch branch = BetOrRaiseBranch(node, current_rule_state,
+                                                total_amount_player_will_put_in_for_this_action,
+                                                actions_this_round, raises_this_street);
+        possible_node_actions.push_back(branch.last_action);
+        children_nodes.push_back(branch.node);
+        pending_children.push_back(std::move(branch));
+    }
+    }
+    // One trainable per reachable deal once the solver visits this node.
+    if (!possible_node_actions.empty()) {
+        stats.AddTrainables(current_player, current_round, possible_node_actions.size(), deals.reachable);
+    }
+    node->SetActionsAndChildren(possible_node_actions, children_nodes);
+    return 1 + BuildChildren(pending_children, deals, depth + 1, stats);
+}
 
-        double next_pot = pot_before_action + total_amount_player_will_put_in_for_this_action;
-        double next_player_commit = current_player_commit + total_amount_player_will_put_in_for_this_action;
+tree::GameTree::PendingBranch tree::GameTree::BetOrRaiseBranch(const std::shared_ptr<nodes::ActionNode>& node,
+                                                                 const config::Rule& rule_state, double amount_to_add,
+                                                                 int actions_this_round, int raises_this_street) const {
+    constexpr double eps = 1e-9;
+    const size_t current_player = node->GetPlayerIndex();
+    const size_t opponent_player = 1 - current_player;
+    const double current_player_commit = rule_state.GetInitialCommitment(current_player);
+    const double opponent_commit = rule_state.GetInitialCommitment(opponent_player);
+    const double stack = rule_state.GetInitialEffectiveStack();
+    const core::GameRound current_round = node->GetRound();
+    const bool is_raise = opponent_commit > current_player_commit + eps;
+
+    // A raise's action amount is what it adds on top of the call.
+    const double action_amount = is_raise ? amount_to_add - (opponent_commit - current_player_commit) : amount_to_add;
+    core::GameAction action(is_raise ? core::PokerAction::kRaise : core::PokerAction::kBet, action_amount);
+    const double next_pot = node->GetPot() + amount_to_add;
+    const double next_player_commit = current_player_commit + amount_to_add;
+
+    // The opponent acts next, unless already all-in and covered.
+    std::shared_ptr<core::GameTreeNode> child;
+    const bool opponent_is_all_in = stack - opponent_commit <= eps;
+    if (next_player_commit >= stack - eps && opponent_is_all_in && next_player_commit >= opponent_commit) {
+        if (current_round == core::GameRound::kRiver) {
+            std::vector<double> commitments = current_player == 0
+                                                  ? std::vector<double>{next_player_commit, opponent_commit}
+                                                  : std::vector<double>{opponent_commit, next_player_commit};
+            child = std::make_shared<nodes::ShowdownNode>(core::GameRound::kRiver, next_pot, node, 2, commitments);
+        } else {
+            core::GameRound next_round =
+                core::GameTreeNode::IntToGameRound(core::GameTreeNode::GameRoundToInt(current_round) + 1);
+            child = std::make_shared<nodes::ChanceNode>(next_round, next_pot, node, std::vector<core::Card>{}, nullptr);
+        }
+    } else {
+        child = std::make_shared<nodes::ActionNode>(opponent_player, current_round, next_pot, node, 1);
+    }
 
-        std::shared_ptr<core::GameTreeNode> child_node_after_bet_raise;
-        bool bet_makes_current_player_all_in = (next_player_commit >= stack - eps);
+    config::Rule next_rule = rule_state;
+    if (current_player == 0) next_rule.SetInitialIpCommit(next_player_commit);
+    else next_rule.SetInitialOopCommit(next_player_commit);
+    return {child, next_rule, action, actions_this_round + 1, raises_this_street + 1};
+}
 
-        // After a bet/raise, it's always the opponent's turn to act on the same street,
-        // unless the bet/raise was an all-in that the opponent is already covering or is forced to call all-in.
-        if (bet_makes_current_player_all_in && opponent_commit >= next_player_commit) {
-        // Player raised all-in, but opponent already has them covered or committed the same.
-        // This should effectively be a showdown after this action if opponent's previous action was a bet/raise.
-        // Or, if opponent checked, they now face an all-in.
-        // This case is tricky: if P0 bets all-in, P1 must act (call/fold).
-        // If P0 raises all-in over P1's bet, P1 must act (call/fold).
-        // The only way it goes to showdown immediately is if P0 calls P1's all-in (handled by Call logic)
-        // OR P0 raises all-in and P1 already has less stack and is thus all-in by calling.
-        // For simplicity, if current player bets/raises all-in, next node is ActionNode for opponent
-        // unless opponent is already all-in and covered.
+void tree::GameTree::CountSubtree(const std::shared_ptr<core::GameTreeNode>& node, const DealPath& deals,
+                                  TreeBuildStats& stats) const {
+    if (!node) return;
+    switch (node->GetNodeType()) {
+        case core::GameTreeNodeType::kAction: {
+            auto action_node = std::static_pointer_cast<nodes::ActionNode>(node);
+            ++stats.action_nodes;
+            stats.deal_slots += deals.deal_slots;
+            if (!action_node->GetActions().empty()) {
+                stats.AddTrainables(action_node->GetPlayerIndex(), action_node->GetRound(),
+                                    action_node->GetActions().size(), deals.reachable);
+            }
+            for (const auto& child : action_node->GetChildren()) CountSubtree(child, deals, stats);
+            break;
+        }
+        case core::GameTreeNodeType::kChance: {
+            auto chance_node = std::static_pointer_cast<nodes::ChanceNode>(node);
+            ++stats.chance_nodes;
+            if (!chance_node->GetChild()) {
+                ++stats.leaf_nodes;
+                break;
+            }
+            // As BuildChanceNode counts the deals below it.
+            DealPath child_deals = deals;
+            if (chance_node->GetRound() != core::GameRound::kFlop) {
+                child_deals.deal_slots *= num_deal_cards_;
+                child_deals.reachable *= num_deal_cards_ - static_cast<uint64_t>(deals.cards_dealt);
+                ++child_deals.cards_dealt;
+            }
+            CountSubtree(chance_node->GetChild(), child_deals, stats);
+            break;
+        }
+        case core::GameTreeNodeType::kShowdown:
+            ++stats.showdown_nodes;
+            break;
+        case core::GameTreeNodeType::kTerminal:
+            ++stats.terminal_nodes;
+            break;
+    }
+}
 
-        // If opponent IS all-in and player's bet/raise covers them:
-        if (opponent_is_all_in && next_player_commit >= opponent_commit) {
-            if (current_round == core::GameRound::kRiver) {
-                std::vector<double> final_commitments_for_showdown;
-                if (current_player == 0) { // IP made the final bet/raise
-                    final_commitments_for_showdown = {next_player_commit, opponent_commit};
-                } else { // OOP made the final bet/raise
-                    final_commitments_for_showdown = {opponent_commit, next_player_commit};
-                }
-                child_node_after_bet_raise = std::make_shared<nodes::ShowdownNode>(
-                    core::GameRound::kRiver, next_pot, node, 2,
-                    final_commitments_for_showdown);
-                // std::cout << "    [GTB Debug BuildActionNode] Bet/Raise (P" << current_player << " covers Opponent All-in) on River -> Showdown. Pot: " << next_pot << std::endl;
-                } else {
-                core::GameRound round_for_next_deal = core::GameTreeNode::IntToGameRound(core::GameTreeNode::GameRoundToInt(current_round) + 1);
-                child_node_after_bet_raise = std::make_shared<nodes::ChanceNode>(
-                round_for_next_deal, next_pot, node, std::vector<core::Card>{}, nullptr);
-                //std::cout << "    [GTB Debug BuildActionNode] Bet/Raise (P" << current_player << " covers Opponent All-in) on " << core::GameTreeNode::GameRoundToString(current_round)
-                 //   << " -> ChanceNode for " << core::GameTreeNode::GameRoundToString(round_for_next_deal) << ". Pot: " << next_pot << std::endl;
+// --- Incremental Edits ---
+
+std::vector<int> tree::GameTree::EditBetSizes(const std::vector<std::string>& path, std::vector<double> amounts) {
+    if (!build_rule_) throw std::logic_error("EditBetSizes: the tree was not built from a Rule.");
+    constexpr double eps = 1e-9;
+
+    // Replays the betting along the path, as BuildActionNode passes it down.
+    std::shared_ptr<core::GameTreeNode> node = root_;
+    config::Rule rule_state = *build_rule_;
+    core::GameAction last_action(core::PokerAction::kRoundBegin);
+    int actions_this_round = 0;
+    int raises_this_street = 0;
+    DealPath deals;
+    auto skip_chance = [&]() {
+        while (auto chance_node = std::dynamic_pointer_cast<nodes::ChanceNode>(node)) {
+            if (chance_node->GetRound() != core::GameRound::kFlop) {
+                deals.deal_slots *= num_deal_cards_;
+                deals.reachable *= num_deal_cards_ - static_cast<uint64_t>(deals.cards_dealt);
+                ++deals.cards_dealt;
             }
-        } else { // Player bets/raises (possibly all-in), opponent is NOT all-in or is not covered yet
-        child_node_after_bet_raise = std::make_shared<nodes::ActionNode>(
-        opponent_player, current_round, next_pot, node, 1);
-        //std::cout << "    [GTB Debug BuildActionNode] Bet/Raise by P" << current_player << " on " << core::GameTreeNode::GameRoundToString(current_round)
-        //<< " (Amount: " << actual_bet_or_raise_value << ", All-in: " << bet_makes_current_player_all_in
-        //<< ") -> ActionNode for P" << opponent_player << ". Pot: " << next_pot << std::endl;
+            last_action = core::GameAction(core::PokerAction::kRoundBegin);
+            actions_this_round = 0;
+            raises_this_street = 0;
+            node = chance_node->GetChild();
+        }
+    };
+    skip_chance();
+    for (const std::string& step : path) {
+        auto action_node = std::dynamic_pointer_cast<nodes::ActionNode>(node);
+        if (!action_node) throw std::invalid_argument("EditBetSizes: the path leaves the betting at '" + step + "'.");
+        const auto& actions = action_node->GetActions();
+        size_t a = 0;
+        while (a < actions.size() && actions[a].ToString() != step) ++a;
+        if (a == actions.size()) throw std::invalid_argument("EditBetSizes: no action '" + step + "' here.");
+        const size_t player = action_node->GetPlayerIndex();
+        const double commit = rule_state.GetInitialCommitment(player);
+        const double opponent_commit = rule_state.GetInitialCommitment(1 - player);
+        double next_commit = commit;
+        switch (actions[a].GetAction()) {
+            case core::PokerAction::kCall:
+                next_commit = std::min(opponent_commit, rule_state.GetInitialEffectiveStack());
+                break;
+            case core::PokerAction::kBet:
+                next_commit = commit + actions[a].GetAmount();
+                ++raises_this_street;
+                break;
+            case core::PokerAction::kRaise:
+                next_commit = opponent_commit + actions[a].GetAmount();
+                ++raises_this_street;
+                break;
+            default:
+                break;
+        }
+        if (player == 0) rule_state.SetInitialIpCommit(next_commit);
+        else rule_state.SetInitialOopCommit(next_commit);
+        last_action = actions[a];
+        ++actions_this_round;
+        node = action_node->GetChildren()[a];
+        skip_chance();
+    }
+    auto action_node = std::dynamic_pointer_cast<nodes::ActionNode>(node);
+    if (!action_node) throw std::invalid_argument("EditBetSizes: the path does not end at an action node.");
+
+    const size_t player = action_node->GetPlayerIndex();
+    const double commit = rule_state.GetInitialCommitment(player);
+    const double opponent_commit = rule_state.GetInitialCommitment(1 - player);
+    const double stack_remaining = rule_state.GetInitialEffectiveStack() - commit;
+    const double call_amount = std::max(0.0, opponent_commit - commit);
+    const bool is_raise = call_amount > eps;
+    if (stack_remaining <= eps || rule_state.GetInitialEffectiveStack() - opponent_commit <= eps ||
+        raises_this_street >= rule_state.GetRaiseLimitPerStreet()) {
+        throw std::invalid_argument("EditBetSizes: no bet or raise is possible at this node.");
     }
-    } else { // Not an all-in situation by current player that ends action
-        child_node_after_bet_raise = std::make_shared<nodes::ActionNode>(
-        opponent_player, current_round, next_pot, node, 1);
-        // std::cout << "    [GTB Debug BuildActionNode] Bet/Raise by P" << current_player << " on " << core::GameTreeNode::GameRoundToString(current_round)
-        // << " (Amount: " << actual_bet_or_raise_value
-        // << ") -> ActionNode for P" << opponent_player << ". Pot: " << next_pot << std::endl;
+    std::sort(amounts.begin(), amounts.end());
+    amounts.erase(std::unique(amounts.begin(), amounts.end(),
+                              [](double a, double b) { return std::abs(a - b) < eps; }),
+                  amounts.end());
+    for (double amount : amounts) {
+        if (!(amount > eps) || call_amount + amount > stack_remaining + eps) {
+            std::ostringstream oss;
+            oss << "EditBetSizes: a " << (is_raise ? "raise" : "bet") << " of " << amount
+                << " is not between 0 and the " << stack_remaining - call_amount << " chips left.";
+            throw std::invalid_argument(oss.str());
+        }
     }
-        children_nodes.push_back(child_node_after_bet_raise);
 
-        config::Rule next_rule_bet_raise = current_rule_state;
-        if (current_player == 0) next_rule_bet_raise.SetInitialIpCommit(next_player_commit);
-        else next_rule_bet_raise.SetInitialOopCommit(next_player_commit);
-        BuildBranch(child_node_after_bet_raise, next_rule_bet_raise, bet_raise_action, actions_this_round + 1, raises_this_street + 1);
+    // Check, call and fold stay, then one bet or raise per amount, reusing
+    // the children of the sizes the node already had.
+    const std::vector<core::GameAction> old_actions = action_node->GetActions();
+    const std::vector<std::shared_ptr<core::GameTreeNode>> old_children = action_node->GetChildren();
+    std::vector<core::GameAction> actions;
+    std::vector<std::shared_ptr<core::GameTreeNode>> children;
+    std::vector<int> kept;
+    std::vector<PendingBranch> pending;
+    for (size_t a = 0; a < old_actions.size(); ++a) {
+        const core::PokerAction type = old_actions[a].GetAction();
+        if (type == core::PokerAction::kBet || type == core::PokerAction::kRaise) continue;
+        actions.push_back(old_actions[a]);
+        children.push_back(old_children[a]);
+        kept.push_back(static_cast<int>(a));
     }
+    for (double amount : amounts) {
+        int old_index = -1;
+        for (size_t a = 0; a < old_actions.size() && old_index < 0; ++a) {
+            const core::PokerAction type = old_actions[a].GetAction();
+            if ((type == core::PokerAction::kBet || type == core::PokerAction::kRaise) &&
+                std::abs(old_actions[a].GetAmount() - amount) < eps) {
+                old_index = static_cast<int>(a);
+            }
+        }
+        if (old_index >= 0) {
+            actions.push_back(old_actions[old_index]);
+            children.push_back(old_children[old_index]);
+        } else {
+            PendingBranch branch =
+                BetOrRaiseBranch(action_node, rule_state, call_amount + amount, actions_this_round, raises_this_street);
+            actions.push_back(branch.last_action);
+            children.push_back(branch.node);
+            pending.push_back(std::move(branch));
+        }
+        kept.push_back(old_index);
     }
-    node->SetActionsAndChildren(possible_node_actions, children_nodes);
+    action_node->SetActionsAndChildren(std::move(actions), std::move(children));
+    TreeBuildStats new_stats; // Recounted over the whole tree below
+    BuildChildren(pending, deals, action_node->GetDepth() + 1, new_stats);
+
+    CalculateTreeMetadata();
+    build_stats_ = TreeBuildStats();
+    CountSubtree(root_, DealPath(), build_stats_);
+    return kept;
 }
 
 
@@ -694,41 +1139,321 @@ void tree::GameTree::PrintTreeRecursive(const std::shared_ptr<core::GameTreeNode
          // std::cout << "})" << std::endl;
     } else { std::cout << "Unknown Node Type" << std::endl; }
 }
-// Added const qualifier
-uint64_t tree::GameTree::EstimateTrainableMemory(size_t p0_range_size, size_t p1_range_size) const { if (!root_) return 0; return EstimateMemoryRecursive(root_, p0_range_size, p1_range_size, 1); }
-// Added const qualifier
-uint64_t tree::GameTree::EstimateMemoryRecursive(const std::shared_ptr<core::GameTreeNode>& node, size_t p0_range_size, size_t p1_range_size, size_t num_deals_multiplier) const {
-    if (!node) return 0;
-    uint64_t current_node_memory = 0;
-    uint64_t children_memory = 0;
-    if (auto action_node = std::dynamic_pointer_cast<const nodes::ActionNode>(node)) {
-        size_t num_actions = action_node->GetActions().size();
-        size_t range_size = (action_node->GetPlayerIndex() == 0) ? p0_range_size : p1_range_size;
-        size_t trainable_size = num_actions * range_size;
-        // Estimate size based on DiscountedCfrTrainable members
-        size_t bytes_per_trainable = trainable_size * (sizeof(float) + sizeof(double) + sizeof(float)); // regrets + sum + evs
-        // Need to know how many deal states the node actually stores
-        // This info isn't directly on the node, assume perfect recall for now (multiplier=1)
-        // A more accurate estimate would need to query the ActionNode's internal trainable vector size.
-        // Let's use num_deals_multiplier passed down for approximation.
-        current_node_memory = num_deals_multiplier * bytes_per_trainable;
-        for (const auto& child : action_node->GetChildren()) {
-            children_memory += EstimateMemoryRecursive(child, p0_range_size, p1_range_size, num_deals_multiplier);
+uint64_t tree::GameTree::EstimateTrainableMemory(size_t p0_range_size, size_t p1_range_size,
+                                                nodes::ActionNode::TrainablePrecision precision) const {
+    return build_stats_.TrainableBytes({p0_range_size, p1_range_size}, precision);
+}
+
+tree::GameTree::TrainableMemorySplit tree::GameTree::EstimateTrainableMemorySplit(
+        size_t p0_range_size, size_t p1_range_size, core::GameRound first_on_disk_round,
+        nodes::ActionNode::TrainablePrecision precision) const {
+    TrainableMemorySplit split;
+    const uint64_t total = build_stats_.TrainableBytes({p0_range_size, p1_range_size}, precision);
+    if (precision == nodes::ActionNode::TrainablePrecision::kFloat) {
+        split.on_disk_bytes =
+            build_stats_.TrainableBytesFrom(first_on_disk_round, {p0_range_size, p1_range_size}, precision);
+    }
+    split.resident_bytes = total - split.on_disk_bytes;
+    return split;
+}
+
+
+// --- Binary Tree Files ---
+
+namespace {
+
+constexpr char kTreeFileMagic[8] = {'P', 'S', 'T', 'R', 'E', 'E', '0', '1'};
+constexpr uint32_t kTreeFileVersion = 1;
+
+// First 64 bytes of a tree file (see GameTree::WriteBinaryFile).
+struct TreeFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t num_nodes;
+    uint64_t num_actions;
+    uint64_t num_values;   // Payoffs and commitments, two per leaf
+    uint64_t num_deal_cards;
+    uint64_t checksum;     // FNV-1a of everything after the header
+    char padding[8];
+};
+static_assert(sizeof(TreeFileHeader) == 64, "Tree file header must be 64 bytes");
+
+struct TreeFileNode {
+    uint8_t type;   // core::GameTreeNodeType
+    uint8_t round;  // core::GameRound
+    uint8_t player; // Action nodes
+    uint8_t reserved;
+    uint32_t num_children;
+    double pot;
+};
+static_assert(sizeof(TreeFileNode) == 16, "Tree file node record must be 16 bytes");
+
+struct TreeFileAction {
+    uint8_t action; // core::PokerAction
+    uint8_t reserved[7];
+    double amount;
+};
+static_assert(sizeof(TreeFileAction) == 16, "Tree file action record must be 16 bytes");
+
+// Flattens the tree depth-first into the three record arrays.
+void AppendTreeRecords(const std::shared_ptr<core::GameTreeNode>& node,
+                       std::vector<TreeFileNode>& node_records,
+                       std::vector<TreeFileAction>& action_records,
+                       std::vector<double>& values) {
+    if (!node) throw std::runtime_error("tree has a null node");
+    TreeFileNode record{};
+    record.type = static_cast<uint8_t>(node->GetNodeType());
+    record.round = static_cast<uint8_t>(core::GameTreeNode::GameRoundToInt(node->GetRound()));
+    record.pot = node->GetPot();
+    switch (node->GetNodeType()) {
+        case core::GameTreeNodeType::kAction: {
+            auto action_node = std::static_pointer_cast<nodes::ActionNode>(node);
+            const auto& actions = action_node->GetActions();
+            const auto& children = action_node->GetChildren();
+            if (actions.size() != children.size()) throw std::runtime_error("action node actions and children differ");
+            record.player = static_cast<uint8_t>(action_node->GetPlayerIndex());
+            record.num_children = static_cast<uint32_t>(children.size());
+            node_records.push_back(record);
+            for (const auto& action : actions) {
+                TreeFileAction action_record{};
+                action_record.action = static_cast<uint8_t>(action.GetAction());
+                action_record.amount = action.GetAmount();
+                action_records.push_back(action_record);
+            }
+            for (const auto& child : children) AppendTreeRecords(child, node_records, action_records, values);
+            return;
         }
-    } else if (auto chance_node = std::dynamic_pointer_cast<const nodes::ChanceNode>(node)) {
-        // Approximation: Multiply deals by cards per street
-        size_t deals_this_round = 1;
-        core::GameRound round = node->GetRound(); // Round *before* the chance
-        if (round == core::GameRound::kPreflop) deals_this_round = 3; // Flop
-        else if (round == core::GameRound::kFlop) deals_this_round = 1; // Turn
-        else if (round == core::GameRound::kTurn) deals_this_round = 1; // River
-        // This is extremely rough, doesn't account for deck size reduction
-        size_t next_multiplier = num_deals_multiplier * deals_this_round;
-        children_memory = EstimateMemoryRecursive(chance_node->GetChild(), p0_range_size, p1_range_size, next_multiplier);
-    }
-    return current_node_memory + children_memory;
+        case core::GameTreeNodeType::kChance: {
+            auto chance_node = std::static_pointer_cast<nodes::ChanceNode>(node);
+            record.num_children = chance_node->GetChild() ? 1 : 0;
+            node_records.push_back(record);
+            if (chance_node->GetChild()) AppendTreeRecords(chance_node->GetChild(), node_records, action_records, values);
+            return;
+        }
+        case core::GameTreeNodeType::kShowdown: {
+            // The commitments the payoffs were derived from.
+            auto showdown_node = std::static_pointer_cast<nodes::ShowdownNode>(node);
+            node_records.push_back(record);
+            values.push_back(showdown_node->GetPayoffs(core::ComparisonResult::kPlayer2Wins)[1]);
+            values.push_back(showdown_node->GetPayoffs(core::ComparisonResult::kPlayer1Wins)[0]);
+            return;
+        }
+        case core::GameTreeNodeType::kTerminal: {
+            const auto& payoffs = std::static_pointer_cast<nodes::TerminalNode>(node)->GetPayoffs();
+            if (payoffs.size() != 2) throw std::runtime_error("terminal node payoffs are not for two players");
+            node_records.push_back(record);
+            values.insert(values.end(), payoffs.begin(), payoffs.end());
+            return;
+        }
+    }
+    throw std::runtime_error("tree has a node of unknown type");
+}
+
+// Rebuilds nodes from the record arrays of a validated file, restoring the
+// build statistics and metadata the builder would have produced.
+class TreeFileReader {
+ public:
+    TreeFileReader(const unsigned char* data, const TreeFileHeader& header, tree::TreeBuildStats& stats)
+        : nodes_(data), actions_(nodes_ + header.num_nodes * sizeof(TreeFileNode)),
+          values_(actions_ + header.num_actions * sizeof(TreeFileAction)),
+          num_nodes_(header.num_nodes), num_actions_(header.num_actions), num_values_(header.num_values),
+          num_deal_cards_(header.num_deal_cards), stats_(stats) {}
+
+    // Reads the node at the cursor and its subtree. 'slots'/'reachable'/
+    // 'cards_dealt' describe the deals above it, as in the builder.
+    std::shared_ptr<core::GameTreeNode> ReadNode(const std::shared_ptr<core::GameTreeNode>& parent, int depth,
+                                                 uint64_t slots, uint64_t reachable, int cards_dealt,
+                                                 int& subtree_size) {
+        if (next_node_ >= num_nodes_) throw std::runtime_error("node records end early");
+        TreeFileNode record;
+        std::memcpy(&record, nodes_ + next_node_++ * sizeof(TreeFileNode), sizeof(record));
+        if (record.round > core::GameTreeNode::GameRoundToInt(core::GameRound::kRiver)) {
+            throw std::runtime_error("invalid round");
+        }
+        const core::GameRound round = core::GameTreeNode::IntToGameRound(record.round);
+        std::weak_ptr<core::GameTreeNode> weak_parent = parent;
+
+        std::shared_ptr<core::GameTreeNode> node;
+        subtree_size = 1;
+        switch (static_cast<core::GameTreeNodeType>(record.type)) {
+            case core::GameTreeNodeType::kAction: {
+                if (record.player > 1) throw std::runtime_error("invalid player");
+                if (next_action_ + record.num_children > num_actions_) throw std::runtime_error("action records end early");
+                auto action_node = std::make_shared<nodes::ActionNode>(record.player, round, record.pot, weak_parent, 1);
+                ++stats_.action_nodes;
+                stats_.deal_slots += slots;
+                std::vector<core::GameAction> actions;
+                actions.reserve(record.num_children);
+                for (uint32_t a = 0; a < record.num_children; ++a) {
+                    TreeFileAction action_record;
+                    std::memcpy(&action_record, actions_ + next_action_++ * sizeof(TreeFileAction), sizeof(action_record));
+                    if (action_record.action > static_cast<uint8_t>(core::PokerAction::kCall)) {
+                        throw std::runtime_error("invalid action");
+                    }
+                    actions.emplace_back(static_cast<core::PokerAction>(action_record.action), action_record.amount);
+                }
+                if (!actions.empty()) stats_.AddTrainables(record.player, round, actions.size(), reachable);
+                std::vector<std::shared_ptr<core::GameTreeNode>> children;
+                children.reserve(record.num_children);
+                for (uint32_t a = 0; a < record.num_children; ++a) {
+                    int child_size = 0;
+                    children.push_back(ReadNode(action_node, depth + 1, slots, reachable, cards_dealt, child_size));
+                    subtree_size += child_size;
+                }
+                action_node->SetActionsAndChildren(std::move(actions), std::move(children));
+                node = action_node;
+                break;
+            }
+            case core::GameTreeNodeType::kChance: {
+                if (record.num_children > 1) throw std::runtime_error("chance node with several children");
+                auto chance_node = std::make_shared<nodes::ChanceNode>(round, record.pot, weak_parent,
+                                                                       std::vector<core::Card>{}, nullptr);
+                ++stats_.chance_nodes;
+                if (record.num_children == 0) ++stats_.leaf_nodes;
+                if (record.num_children == 1) {
+                    // Turn and river deals multiply the deal slots below.
+                    if (round != core::GameRound::kFlop) {
+                        slots *= num_deal_cards_;
+                        reachable *= num_deal_cards_ - static_cast<uint64_t>(cards_dealt);
+                        ++cards_dealt;
+                    }
+                    int child_size = 0;
+                    chance_node->SetChild(ReadNode(chance_node, depth + 1, slots, reachable, cards_dealt, child_size));
+                    subtree_size += child_size;
+                }
+                node = chance_node;
+                break;
+            }
+            case core::GameTreeNodeType::kShowdown: {
+                std::array<double, 2> commitments = ReadValues();
+                node = std::make_shared<nodes::ShowdownNode>(round, record.pot, weak_parent, 2,
+                                                             std::vector<double>(commitments.begin(), commitments.end()));
+                ++stats_.showdown_nodes;
+                break;
+            }
+            case core::GameTreeNodeType::kTerminal: {
+                std::array<double, 2> payoffs = ReadValues();
+                node = std::make_shared<nodes::TerminalNode>(std::vector<double>(payoffs.begin(), payoffs.end()),
+                                                             round, record.pot, weak_parent);
+                ++stats_.terminal_nodes;
+                break;
+            }
+            default:
+                throw std::runtime_error("invalid node type");
+        }
+        if (record.num_children > 0 && (record.type == static_cast<uint8_t>(core::GameTreeNodeType::kShowdown) ||
+                                        record.type == static_cast<uint8_t>(core::GameTreeNodeType::kTerminal))) {
+            throw std::runtime_error("leaf node with children");
+        }
+        node->SetDepth(depth);
+        node->SetSubtreeSize(subtree_size);
+        return node;
+    }
+
+    // True once every record has been consumed.
+    bool AtEnd() const {
+        return next_node_ == num_nodes_ && next_action_ == num_actions_ && next_value_ == num_values_;
+    }
+
+ private:
+    std::array<double, 2> ReadValues() {
+        if (next_value_ + 2 > num_values_) throw std::runtime_error("payoff records end early");
+        std::array<double, 2> values;
+        std::memcpy(values.data(), values_ + next_value_ * sizeof(double), sizeof(values));
+        next_value_ += 2;
+        return values;
+    }
+
+    const unsigned char* nodes_;
+    const unsigned char* actions_;
+    const unsigned char* values_;
+    uint64_t num_nodes_, num_actions_, num_values_, num_deal_cards_;
+    uint64_t next_node_ = 0, next_action_ = 0, next_value_ = 0;
+    tree::TreeBuildStats& stats_;
+};
+
+} // namespace
+
+void tree::GameTree::WriteBinaryFile(const std::string& path) const {
+    if (!root_) throw std::runtime_error("WriteBinaryFile: the tree is empty.");
+    std::vector<TreeFileNode> node_records;
+    std::vector<TreeFileAction> action_records;
+    std::vector<double> values;
+    try {
+        AppendTreeRecords(root_, node_records, action_records, values);
+    } catch (const std::exception& e) {
+        throw std::runtime_error(std::string("WriteBinaryFile: ") + e.what() + ".");
+    }
+
+    TreeFileHeader header{};
+    std::memcpy(header.magic, kTreeFileMagic, sizeof(kTreeFileMagic));
+    header.version = kTreeFileVersion;
+    header.num_nodes = node_records.size();
+    header.num_actions = action_records.size();
+    header.num_values = values.size();
+    header.num_deal_cards = num_deal_cards_;
+    utils::Fnv1a checksum;
+    checksum.AddBytes(node_records.data(), node_records.size() * sizeof(TreeFileNode));
+    checksum.AddBytes(action_records.data(), action_records.size() * sizeof(TreeFileAction));
+    checksum.AddBytes(values.data(), values.size() * sizeof(double));
+    header.checksum = checksum.Value();
+
+    std::string temporary_path = path + ".tmp";
+    try {
+        std::ofstream out(temporary_path, std::ios::binary | std::ios::trunc);
+        if (!out) throw std::runtime_error("cannot open for writing");
+        utils::WriteRaw(out, &header, 1);
+        utils::WriteRaw(out, node_records.data(), node_records.size());
+        utils::WriteRaw(out, action_records.data(), action_records.size());
+        utils::WriteRaw(out, values.data(), values.size());
+        out.close();
+        if (!out) throw std::runtime_error("write failed");
+        std::filesystem::rename(temporary_path, path);
+    } catch (const std::exception& e) {
+        std::error_code ignored;
+        std::filesystem::remove(temporary_path, ignored);
+        throw std::runtime_error("WriteBinaryFile: failed to write '" + path + "': " + e.what());
+    }
 }
 
+std::shared_ptr<tree::GameTree> tree::GameTree::FromBinaryFile(const std::string& path, const core::Deck& deck) {
+    auto fail = [&](const std::string& reason) {
+        return std::runtime_error("GameTree: tree file '" + path + "' " + reason + ".");
+    };
+    utils::MappedFile file(path);
+    if (file.Size() < sizeof(TreeFileHeader)) throw fail("is too small to be a tree file");
+    TreeFileHeader header;
+    std::memcpy(&header, file.Data(), sizeof(header));
+    if (std::memcmp(header.magic, kTreeFileMagic, sizeof(kTreeFileMagic)) != 0) throw fail("is not a tree file");
+    if (header.version != kTreeFileVersion) {
+        throw fail("has unsupported version " + std::to_string(header.version));
+    }
+    // Bounded first, so the byte count below cannot overflow.
+    const uint64_t max_records = file.Size() / sizeof(double);
+    if (header.num_nodes == 0 || header.num_nodes > max_records || header.num_actions > max_records ||
+        header.num_values > max_records ||
+        file.Size() != sizeof(TreeFileHeader) + header.num_nodes * sizeof(TreeFileNode) +
+                           header.num_actions * sizeof(TreeFileAction) + header.num_values * sizeof(double)) {
+        throw fail("has an inconsistent layout");
+    }
+    const unsigned char* payload = file.Data() + sizeof(TreeFileHeader);
+    utils::Fnv1a checksum;
+    checksum.AddBytes(payload, file.Size() - sizeof(TreeFileHeader));
+    if (checksum.Value() != header.checksum) throw fail("fails its checksum");
+
+    std::shared_ptr<tree::GameTree> tree(new tree::GameTree(deck));
+    tree->num_deal_cards_ = header.num_deal_cards;
+    TreeFileReader reader(payload, header, tree->build_stats_);
+    try {
+        int subtree_size = 0;
+        tree->root_ = reader.ReadNode(nullptr, 0, 1, 1, 0, subtree_size);
+    } catch (const std::exception& e) {
+        throw fail(std::string("is corrupt: ") + e.what());
+    }
+    if (!reader.AtEnd()) throw fail("has records not reachable from the root");
+    return tree;
+}
 
 } // namespace tree
  // namespace poker_solver
@@ -1,4 +1,5 @@
 #include "compairer/Dic5Compairer.h" // Adjust path if necessary
+#include "compairer/FiveCardRankTables.h" // For the generated ranks
 
 #include <fstream>   // For std::ifstream, std::ofstream
 #include <sstream>   // For std::stringstream, std::ostringstream
@@ -50,10 +51,23 @@ bool Dic5Compairer::IsFlush(uint64_t cards_mask) {
     return false;
 }
 
-// --- Constructor ---
+// Generated once, at compile time.
+constexpr FiveCardRankTables kGeneratedRanks = GenerateFiveCardRankTables();
+static_assert(kGeneratedRanks.flush.back().rank == 1599, "Last flush class must rank 1599.");
+static_assert(kGeneratedRanks.non_flush.back().rank == 7462, "Last hand class must rank 7462.");
+
+// --- Constructors ---
+
+Dic5Compairer::Dic5Compairer() {
+    LoadGeneratedTables();
+}
 
 Dic5Compairer::Dic5Compairer(const std::string& dictionary_filepath)
     : dictionary_path_(dictionary_filepath) {
+#ifdef POKER_SOLVER_EMBEDDED_RANKS
+    LoadGeneratedTables();
+    return;
+#endif
 
     // Derive cache path from text path (e.g., change .txt to .bin)
     cache_path_ = dictionary_path_;
@@ -195,6 +209,28 @@ bool Dic5Compairer::SaveBinaryCache(const fs::path& cache_filepath) const {
 }
 
 
+// --- Generated Ranks ---
+
+void Dic5Compairer::LoadGeneratedTables() {
+    flush_ranks_.clear();
+    non_flush_ranks_.clear();
+    flush_ranks_.reserve(kGeneratedRanks.flush.size() * core::kNumSuits);
+    non_flush_ranks_.reserve(kGeneratedRanks.non_flush.size());
+    for (const FiveCardRankEntry& entry : kGeneratedRanks.flush) {
+        // Spread the rank pattern onto each suit's cards (rank * 4 + suit).
+        for (int suit = 0; suit < core::kNumSuits; ++suit) {
+            uint64_t hand_mask = 0;
+            for (int rank = 0; rank < core::kNumRanks; ++rank) {
+                if (entry.key & (1ULL << rank)) hand_mask |= 1ULL << (rank * core::kNumSuits + suit);
+            }
+            flush_ranks_[hand_mask] = entry.rank;
+        }
+    }
+    for (const FiveCardRankEntry& entry : kGeneratedRanks.non_flush) {
+        non_flush_ranks_[entry.key] = entry.rank;
+    }
+}
+
 // --- Dictionary Loading (from Text) ---
 
 void Dic5Compairer::LoadDictionaryFromText(const std::string& filepath) {
@@ -259,33 +295,40 @@ void Dic5Compairer::LoadDictionaryFromText(const std::string& filepath) {
 int Dic5Compairer::Lookup5CardRank(uint64_t hand_mask) const {
     bool is_flush = IsFlush(hand_mask);
     if (is_flush) {
-        auto it = flush_ranks_.find(hand_mask);
-        return (it != flush_ranks_.end()) ? it->second : kInvalidRank;
+        const int* rank = flush_ranks_.find(hand_mask);
+        return rank ? *rank : kInvalidRank;
     } else {
         uint64_t rank_hash = RanksHash(hand_mask);
-        auto it = non_flush_ranks_.find(rank_hash);
-        return (it != non_flush_ranks_.end()) ? it->second : kInvalidRank;
+        const int* rank = non_flush_ranks_.find(rank_hash);
+        return rank ? *rank : kInvalidRank;
     }
 }
 
 // --- Private Rank Calculation Helper ---
 int Dic5Compairer::GetBestRankForCards(const std::vector<int>& cards) const {
-    size_t num_cards = cards.size();
-    if (num_cards < 5) return kInvalidRank;
-    if (num_cards == 5) {
-        try { uint64_t hand_mask = core::Card::CardIntsToUint64(cards); return Lookup5CardRank(hand_mask); }
-        catch (...) { return kInvalidRank; }
-    }
+    return GetBestRankForCards(cards.data(), cards.size());
+}
+
+int Dic5Compairer::GetBestRankForCards(const int* cards, size_t num_cards) const {
+    if (num_cards < 5 || num_cards > static_cast<size_t>(core::kNumCardsInDeck)) return kInvalidRank;
     int min_rank = kInvalidRank;
-    std::vector<int> cards_copy = cards;
-    utils::Combinations<int> combos(std::move(cards_copy), 5);
-    for (const std::vector<int>& five_card_combo : combos.GetCombinations()) {
-        try {
-            uint64_t hand_mask = core::Card::CardIntsToUint64(five_card_combo);
-            int current_rank = Lookup5CardRank(hand_mask);
-            if (current_rank != kInvalidRank) min_rank = std::min(min_rank, current_rank);
-        } catch (...) { continue; }
+    // Bit of each card; 0 for invalid cards, whose combinations are skipped.
+    std::array<uint64_t, core::kNumCardsInDeck> card_bits;
+    for (size_t i = 0; i < num_cards; ++i) {
+        card_bits[i] = core::Card::IsValidCardInt(cards[i]) ? core::Card::CardIntToUint64(cards[i]) : 0;
     }
+    utils::CombinationIndices<5> combo(static_cast<int>(num_cards), 5);
+    do {
+        uint64_t hand_mask = 0;
+        bool valid = true;
+        for (int i = 0; i < 5; ++i) {
+            valid = valid && card_bits[combo[i]] != 0;
+            hand_mask |= card_bits[combo[i]];
+        }
+        if (!valid) continue;
+        int current_rank = Lookup5CardRank(hand_mask);
+        if (current_rank != kInvalidRank) min_rank = std::min(min_rank, current_rank);
+    } while (combo.Next());
     return min_rank;
 }
 
@@ -300,9 +343,49 @@ int Dic5Compairer::GetHandRank(const std::vector<int>& private_hand, const std::
 }
 int Dic5Compairer::GetHandRank(uint64_t private_mask, uint64_t public_mask) const {
     if (core::Card::DoBoardsOverlap(private_mask, public_mask)) return kInvalidRank;
-    uint64_t combined_mask = private_mask | public_mask; std::vector<int> all_cards = core::Card::Uint64ToCardInts(combined_mask);
-    return GetBestRankForCards(all_cards);
+    uint64_t combined_mask = (private_mask | public_mask) & ((1ULL << core::kNumCardsInDeck) - 1);
+    int all_cards[core::kNumCardsInDeck];
+    return GetBestRankForCards(all_cards, core::CardMaskToInts(combined_mask, all_cards));
 }
+void Dic5Compairer::RankRange(const uint64_t* private_masks, size_t count,
+                              uint64_t public_mask, int* out) const {
+    int board_cards[5];
+    if (core::CountCards(public_mask & ((1ULL << core::kNumCardsInDeck) - 1)) != 5) {
+        for (size_t i = 0; i < count; ++i) out[i] = GetHandRank(private_masks[i], public_mask);
+        return;
+    }
+    core::CardMaskToInts(public_mask, board_cards);
+    // Board subsets joined by one (4 cards) or both (3 cards) hole cards.
+    uint64_t board_fours[5];
+    uint64_t board_threes[10];
+    size_t num_threes = 0;
+    for (int skip = 0; skip < 5; ++skip) board_fours[skip] = public_mask & ~(1ULL << board_cards[skip]);
+    for (int skip1 = 0; skip1 < 5; ++skip1) {
+        for (int skip2 = skip1 + 1; skip2 < 5; ++skip2) {
+            board_threes[num_threes++] = public_mask & ~(1ULL << board_cards[skip1]) & ~(1ULL << board_cards[skip2]);
+        }
+    }
+    const int board_rank = Lookup5CardRank(public_mask);
+
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t hand = private_masks[i];
+        uint64_t first_card = hand & (~hand + 1); // Lowest set bit
+        uint64_t second_card = hand ^ first_card;
+        if (core::Card::DoBoardsOverlap(hand, public_mask) || first_card == 0 || second_card == 0 ||
+            (second_card & (second_card - 1)) != 0) {
+            out[i] = GetHandRank(hand, public_mask); // Not two cards, or on the board
+            continue;
+        }
+        int best = board_rank;
+        for (uint64_t four : board_fours) {
+            best = std::min(best, Lookup5CardRank(four | first_card));
+            best = std::min(best, Lookup5CardRank(four | second_card));
+        }
+        for (uint64_t three : board_threes) best = std::min(best, Lookup5CardRank(three | hand));
+        out[i] = best;
+    }
+}
+
 core::ComparisonResult Dic5Compairer::CompareHands(const std::vector<int>& private_hand1, const std::vector<int>& private_hand2, const std::vector<int>& public_board) const {
     std::vector<int> hand1_combined = private_hand1; hand1_combined.insert(hand1_combined.end(), public_board.begin(), public_board.end());
     uint64_t mask1 = 0; try { mask1 = core::Card::CardIntsToUint64(hand1_combined); } catch (...) { return core::ComparisonResult::kTie; }
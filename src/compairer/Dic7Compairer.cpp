@@ -0,0 +1,415 @@
+#include "compairer/Dic7Compairer.h"
+#include "tools/BinaryIo.h" // For table file I/O and checksums
+
+#include <algorithm> // For std::sort, std::min
+#include <cstring>   // For std::memcmp, std::memcpy
+#include <filesystem> // For table file paths
+#include <fstream>   // For std::ofstream
+#include <functional> // For std::function
+#include <iostream>  // For progress output
+#include <limits>    // For std::numeric_limits
+#include <sstream>   // For error messages
+#include <stdexcept> // For std::runtime_error
+#include <utility>   // For std::pair
+
+// Use aliases for namespaces to reduce typing
+namespace core = poker_solver::core;
+namespace fs = std::filesystem;
+
+namespace poker_solver {
+namespace eval {
+
+namespace {
+
+constexpr uint64_t kSuitMasks[core::kNumSuits] = {
+    0x1111111111111ULL, 0x2222222222222ULL, 0x4444444444444ULL, 0x8888888888888ULL};
+constexpr size_t kNumRankPatterns = size_t{1} << core::kNumRanks;
+constexpr uint64_t kBucketMultiplier = 0x9E3779B97F4A7C15ULL;
+constexpr uint64_t kSlotMultiplier = 0xBF58476D1CE4E5B9ULL;
+
+constexpr char kTableMagic[8] = {'P', 'S', 'R', 'A', 'N', 'K', '7', '\0'};
+constexpr uint32_t kTableVersion = 1;
+
+// First 64 bytes of a table file (see the class comment).
+struct TableFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t bucket_shift;
+    uint64_t num_flush_ranks;
+    uint64_t num_displacements;
+    uint64_t num_rank_count_ranks;
+    uint64_t checksum;
+    char padding[16];
+};
+static_assert(sizeof(TableFileHeader) == 64, "Table file header must be 64 bytes");
+
+bool IsPowerOfTwo(uint64_t value) { return value != 0 && (value & (value - 1)) == 0; }
+
+// The 13-bit rank pattern of the cards of 'suit' in 'cards_mask'.
+uint32_t RankPattern(uint64_t cards_mask, int suit) {
+    uint64_t suit_bits = cards_mask >> suit;
+    uint32_t pattern = 0;
+    for (int rank = 0; rank < core::kNumRanks; ++rank) {
+        pattern |= static_cast<uint32_t>((suit_bits >> (rank * core::kNumSuits)) & 1ULL) << rank;
+    }
+    return pattern;
+}
+
+// Bits of the slot hash; the slot table has 2^kSlotBits entries.
+int SlotBits(size_t num_keys) {
+    int bits = 1;
+    while ((size_t{1} << bits) < num_keys + num_keys / 2) ++bits;
+    return bits;
+}
+
+} // namespace
+
+// --- Constructors ---
+
+Dic7Compairer::Dic7Compairer(const Dic5Compairer& five_card_ranks) {
+    BuildFlushTable(five_card_ranks);
+    BuildRankCountTable(five_card_ranks);
+    std::cout << "[INFO] Dic7Compairer tables built (" << MemoryBytes() / 1024 << " KiB)." << std::endl;
+}
+
+Dic7Compairer::Dic7Compairer(const std::string& dictionary_filepath) {
+    fs::path table_path = dictionary_filepath;
+    table_path.replace_extension(".rank7");
+    std::string error;
+    try {
+        if (UseMappedTables(std::make_unique<utils::MappedFile>(table_path.string()), error)) {
+            std::cout << "[INFO] Mapped rank table file: " << table_path.string() << std::endl;
+            return;
+        }
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
+    std::cout << "[INFO] Rank table file not usable (" << error << "). Building from dictionary." << std::endl;
+
+    Dic5Compairer five_card_ranks(dictionary_filepath);
+    BuildFlushTable(five_card_ranks);
+    BuildRankCountTable(five_card_ranks);
+    try {
+        WriteTableFile(table_path.string());
+        std::cout << "[INFO] Saved rank table file: " << table_path.string() << std::endl;
+    } catch (const std::exception& e) {
+        // Warning only, the tables built here are complete.
+        std::cerr << "[WARNING] " << e.what() << std::endl;
+    }
+}
+
+std::shared_ptr<Dic7Compairer> Dic7Compairer::FromTableFile(const std::string& table_filepath) {
+    std::shared_ptr<Dic7Compairer> compairer(new Dic7Compairer());
+    std::string error;
+    if (!compairer->UseMappedTables(std::make_unique<utils::MappedFile>(table_filepath), error)) {
+        throw std::runtime_error("Dic7Compairer: '" + table_filepath + "' " + error);
+    }
+    return compairer;
+}
+
+// --- Table Files ---
+
+void Dic7Compairer::WriteTableFile(const std::string& table_filepath) const {
+    TableFileHeader header{};
+    std::memcpy(header.magic, kTableMagic, sizeof(kTableMagic));
+    header.version = kTableVersion;
+    header.bucket_shift = static_cast<uint32_t>(bucket_shift_);
+    header.num_flush_ranks = kNumRankPatterns;
+    header.num_displacements = num_buckets_;
+    header.num_rank_count_ranks = num_slots_;
+    utils::Fnv1a checksum;
+    checksum.AddBytes(flush_ranks_, kNumRankPatterns * sizeof(int));
+    checksum.AddBytes(displacements_, num_buckets_ * sizeof(uint32_t));
+    checksum.AddBytes(rank_count_ranks_, num_slots_ * sizeof(int));
+    header.checksum = checksum.Value();
+
+    std::string temporary_path = table_filepath + ".tmp";
+    try {
+        std::ofstream out(temporary_path, std::ios::binary | std::ios::trunc);
+        if (!out) throw std::runtime_error("cannot open for writing");
+        utils::WriteRaw(out, &header, 1);
+        utils::WriteRaw(out, flush_ranks_, kNumRankPatterns);
+        utils::WriteRaw(out, displacements_, num_buckets_);
+        utils::WriteRaw(out, rank_count_ranks_, num_slots_);
+        out.close();
+        if (!out) throw std::runtime_error("write failed");
+        fs::rename(temporary_path, table_filepath);
+    } catch (const std::exception& e) {
+        std::error_code ignored;
+        fs::remove(temporary_path, ignored);
+        throw std::runtime_error("Dic7Compairer: failed to write rank table file '" + table_filepath +
+                                 "': " + e.what());
+    }
+}
+
+bool Dic7Compairer::UseMappedTables(std::unique_ptr<utils::MappedFile> mapping, std::string& error) {
+    if (mapping->Size() < sizeof(TableFileHeader)) {
+        error = "is too small to be a rank table file";
+        return false;
+    }
+    TableFileHeader header;
+    std::memcpy(&header, mapping->Data(), sizeof(header));
+    if (std::memcmp(header.magic, kTableMagic, sizeof(kTableMagic)) != 0) {
+        error = "is not a rank table file";
+        return false;
+    }
+    if (header.version != kTableVersion) {
+        error = "has unsupported version " + std::to_string(header.version);
+        return false;
+    }
+    bool valid_shape = header.num_flush_ranks == kNumRankPatterns &&
+                       IsPowerOfTwo(header.num_rank_count_ranks) &&
+                       header.num_displacements <= header.num_rank_count_ranks &&
+                       header.bucket_shift > 0 && header.bucket_shift < 64 &&
+                       (uint64_t{1} << (64 - header.bucket_shift)) == header.num_displacements;
+    uint64_t payload_bytes = header.num_flush_ranks * sizeof(int) + header.num_displacements * sizeof(uint32_t) +
+                             header.num_rank_count_ranks * sizeof(int);
+    if (!valid_shape || mapping->Size() != sizeof(TableFileHeader) + payload_bytes) {
+        error = "has an inconsistent layout";
+        return false;
+    }
+    const unsigned char* payload = mapping->Data() + sizeof(TableFileHeader);
+    utils::Fnv1a checksum;
+    checksum.AddBytes(payload, payload_bytes);
+    if (checksum.Value() != header.checksum) {
+        error = "fails its checksum";
+        return false;
+    }
+
+    // The payload starts 64 bytes into a page-aligned mapping, so the int
+    // and uint32 arrays are suitably aligned.
+    flush_ranks_ = reinterpret_cast<const int*>(payload);
+    displacements_ = reinterpret_cast<const uint32_t*>(payload + header.num_flush_ranks * sizeof(int));
+    rank_count_ranks_ = reinterpret_cast<const int*>(
+        payload + header.num_flush_ranks * sizeof(int) + header.num_displacements * sizeof(uint32_t));
+    num_buckets_ = header.num_displacements;
+    num_slots_ = header.num_rank_count_ranks;
+    bucket_shift_ = static_cast<int>(header.bucket_shift);
+    mapping_ = std::move(mapping);
+    return true;
+}
+
+// --- Table Construction ---
+
+void Dic7Compairer::BuildFlushTable(const Dic5Compairer& five_card_ranks) {
+    owned_flush_ranks_.assign(kNumRankPatterns, kInvalidRank);
+    std::vector<int> cards;
+    for (uint32_t pattern = 0; pattern < kNumRankPatterns; ++pattern) {
+        int num_cards = core::CountCards(pattern);
+        if (num_cards < kMinCards || num_cards > kMaxCards) continue;
+        cards.clear();
+        for (int rank = 0; rank < core::kNumRanks; ++rank) {
+            if (pattern & (1u << rank)) cards.push_back(rank * core::kNumSuits); // All of suit 0
+        }
+        owned_flush_ranks_[pattern] = five_card_ranks.GetBestRankForCards(cards);
+    }
+}
+
+void Dic7Compairer::BuildRankCountTable(const Dic5Compairer& five_card_ranks) {
+    // Every multiset of kMinCards..kMaxCards ranks (at most 4 of each), as
+    // nibble counts, with its best non-flush rank.
+    std::vector<std::pair<uint64_t, int>> entries;
+    std::vector<int> counts(core::kNumRanks, 0);
+    std::vector<int> cards;
+    auto add_entry = [&]() {
+        // Suits are dealt round-robin, so no suit gets more than 2 cards.
+        cards.clear();
+        uint64_t key = 0;
+        int next_suit = 0;
+        for (int rank = 0; rank < core::kNumRanks; ++rank) {
+            for (int c = 0; c < counts[rank]; ++c) {
+                cards.push_back(rank * core::kNumSuits + next_suit);
+                next_suit = (next_suit + 1) % core::kNumSuits;
+            }
+            key |= static_cast<uint64_t>(counts[rank]) << (rank * core::kNumSuits);
+        }
+        int rank = five_card_ranks.GetBestRankForCards(cards);
+        if (rank == kInvalidRank) {
+            throw std::runtime_error("Dic7Compairer: 5-card dictionary is missing non-flush hands.");
+        }
+        entries.emplace_back(key, rank);
+    };
+    std::function<void(int, int)> enumerate = [&](int rank, int num_cards) {
+        if (rank == core::kNumRanks) {
+            if (num_cards >= kMinCards) add_entry();
+            return;
+        }
+        for (int c = 0; c <= core::kNumSuits && num_cards + c <= kMaxCards; ++c) {
+            counts[rank] = c;
+            enumerate(rank + 1, num_cards + c);
+        }
+        counts[rank] = 0;
+    };
+    enumerate(0, 0);
+
+    // Hash and displace: keys are grouped into buckets (4 to 5 per bucket),
+    // and each bucket, largest first, gets the first displacement (slot hash
+    // seed) that puts all of its keys into free slots.
+    int slot_bits = SlotBits(entries.size());
+    int bucket_bits = std::max(1, slot_bits - 3);
+    bucket_shift_ = 64 - bucket_bits;
+    size_t num_slots = size_t{1} << slot_bits;
+    std::vector<std::vector<size_t>> buckets(size_t{1} << bucket_bits);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        buckets[(entries[i].first * kBucketMultiplier) >> bucket_shift_].push_back(i);
+    }
+    std::vector<size_t> order(buckets.size());
+    for (size_t b = 0; b < order.size(); ++b) order[b] = b;
+    std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+        return buckets[lhs].size() > buckets[rhs].size();
+    });
+
+    owned_displacements_.assign(buckets.size(), 0);
+    owned_rank_count_ranks_.assign(num_slots, kInvalidRank);
+    UseOwnedTables();
+    std::vector<bool> used(num_slots, false);
+    std::vector<size_t> slots;
+    for (size_t b : order) {
+        if (buckets[b].empty()) break;
+        bool placed = false;
+        for (uint64_t d = 0; d < num_slots && !placed; ++d) {
+            owned_displacements_[b] = static_cast<uint32_t>(d);
+            slots.clear();
+            placed = true;
+            for (size_t i : buckets[b]) {
+                size_t slot = RankCountSlot(entries[i].first);
+                if (used[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end()) {
+                    placed = false;
+                    break;
+                }
+                slots.push_back(slot);
+            }
+        }
+        if (!placed) throw std::runtime_error("Dic7Compairer: perfect hash construction failed.");
+        for (size_t k = 0; k < slots.size(); ++k) {
+            used[slots[k]] = true;
+            owned_rank_count_ranks_[slots[k]] = entries[buckets[b][k]].second;
+        }
+    }
+}
+
+void Dic7Compairer::UseOwnedTables() {
+    flush_ranks_ = owned_flush_ranks_.data();
+    displacements_ = owned_displacements_.data();
+    rank_count_ranks_ = owned_rank_count_ranks_.data();
+    num_buckets_ = owned_displacements_.size();
+    num_slots_ = owned_rank_count_ranks_.size();
+}
+
+size_t Dic7Compairer::RankCountSlot(uint64_t rank_counts) const {
+    size_t slot_mask = num_slots_ - 1;
+    uint32_t displacement = displacements_[(rank_counts * kBucketMultiplier) >> bucket_shift_];
+    // The displacement reseeds the slot hash of its bucket.
+    uint64_t mixed = ((rank_counts ^ (rank_counts >> 29)) + displacement * kBucketMultiplier) * kSlotMultiplier;
+    return static_cast<size_t>(mixed >> 32) & slot_mask;
+}
+
+// --- Lookup ---
+
+int Dic7Compairer::RankOfMask(uint64_t cards_mask) const {
+    int num_cards = core::CountCards(cards_mask);
+    if (num_cards < kMinCards || num_cards > kMaxCards) return kInvalidRank;
+
+    int rank = rank_count_ranks_[RankCountSlot(Dic5Compairer::RanksHash(cards_mask))];
+    for (int suit = 0; suit < core::kNumSuits; ++suit) {
+        if (core::CountCards(cards_mask & kSuitMasks[suit]) >= kMinCards) {
+            // Only one suit can hold 5 of at most 7 cards.
+            return std::min(rank, flush_ranks_[RankPattern(cards_mask, suit)]);
+        }
+    }
+    return rank;
+}
+
+size_t Dic7Compairer::MemoryBytes() const {
+    return kNumRankPatterns * sizeof(int) + num_buckets_ * sizeof(uint32_t) + num_slots_ * sizeof(int);
+}
+
+// --- Public Interface Methods ---
+
+int Dic7Compairer::GetHandRank(const std::vector<int>& private_hand,
+                               const std::vector<int>& public_board) const {
+    if (private_hand.size() != 2) return kInvalidRank;
+    std::vector<int> all_cards = private_hand;
+    all_cards.insert(all_cards.end(), public_board.begin(), public_board.end());
+    uint64_t combined_mask = 0;
+    try { combined_mask = core::Card::CardIntsToUint64(all_cards); } catch (...) { return kInvalidRank; }
+    if (core::CountCards(combined_mask) != static_cast<int>(all_cards.size())) return kInvalidRank;
+    return RankOfMask(combined_mask);
+}
+
+int Dic7Compairer::GetHandRank(uint64_t private_mask, uint64_t public_mask) const {
+    if (core::Card::DoBoardsOverlap(private_mask, public_mask)) return kInvalidRank;
+    return RankOfMask(private_mask | public_mask);
+}
+
+void Dic7Compairer::RankRange(const uint64_t* private_masks, size_t count,
+                              uint64_t public_mask, int* out) const {
+    int board_size = core::CountCards(public_mask);
+    if (board_size + 2 < kMinCards || board_size + 2 > kMaxCards) {
+        for (size_t i = 0; i < count; ++i) out[i] = GetHandRank(private_masks[i], public_mask);
+        return;
+    }
+    // Rank counts add up nibble by nibble (at most 4 per rank). With two
+    // hole cards a flush needs 3 board cards of one suit, which at most one
+    // suit of a board of up to 5 cards can have.
+    const uint64_t board_counts = Dic5Compairer::RanksHash(public_mask);
+    int flush_suit = -1;
+    for (int suit = 0; suit < core::kNumSuits; ++suit) {
+        if (core::CountCards(public_mask & kSuitMasks[suit]) >= kMinCards - 2) flush_suit = suit;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t hand = private_masks[i];
+        if (core::CountCards(hand) != 2 || core::Card::DoBoardsOverlap(hand, public_mask)) {
+            out[i] = GetHandRank(hand, public_mask);
+            continue;
+        }
+        int rank = rank_count_ranks_[RankCountSlot(board_counts + Dic5Compairer::RanksHash(hand))];
+        if (flush_suit >= 0) {
+            uint64_t cards = hand | public_mask;
+            if (core::CountCards(cards & kSuitMasks[flush_suit]) >= kMinCards) {
+                rank = std::min(rank, flush_ranks_[RankPattern(cards, flush_suit)]);
+            }
+        }
+        out[i] = rank;
+    }
+}
+
+namespace {
+
+core::ComparisonResult CompareRanks(int rank1, int rank2) {
+    // Lower ranks are stronger; an invalid rank loses to any valid one.
+    if (rank1 < rank2) return core::ComparisonResult::kPlayer1Wins;
+    if (rank2 < rank1) return core::ComparisonResult::kPlayer2Wins;
+    return core::ComparisonResult::kTie;
+}
+
+} // namespace
+
+core::ComparisonResult Dic7Compairer::CompareHands(const std::vector<int>& private_hand1,
+                                                   const std::vector<int>& private_hand2,
+                                                   const std::vector<int>& public_board) const {
+    uint64_t private1_mask = 0;
+    uint64_t private2_mask = 0;
+    try {
+        private1_mask = core::Card::CardIntsToUint64(private_hand1);
+        private2_mask = core::Card::CardIntsToUint64(private_hand2);
+    } catch (...) {
+        return core::ComparisonResult::kTie;
+    }
+    if (core::Card::DoBoardsOverlap(private1_mask, private2_mask)) return core::ComparisonResult::kTie;
+    return CompareRanks(GetHandRank(private_hand1, public_board), GetHandRank(private_hand2, public_board));
+}
+
+core::ComparisonResult Dic7Compairer::CompareHands(uint64_t private_mask1, uint64_t private_mask2,
+                                                   uint64_t public_mask) const {
+    if (core::Card::DoBoardsOverlap(private_mask1, public_mask) ||
+        core::Card::DoBoardsOverlap(private_mask2, public_mask) ||
+        core::Card::DoBoardsOverlap(private_mask1, private_mask2)) {
+        return core::ComparisonResult::kTie;
+    }
+    return CompareRanks(GetHandRank(private_mask1, public_mask), GetHandRank(private_mask2, public_mask));
+}
+
+} // namespace eval
+} // namespace poker_solver
@@ -0,0 +1,249 @@
+#include "compairer/ShortDeckCompairer.h"
+#include "Card.h" // For card masks
+#include "Deck.h" // For kShortDeckLowestRank
+
+#include <algorithm>     // For std::lower_bound, std::min, std::sort
+#include <functional>    // For std::function
+#include <stdexcept>     // For std::logic_error
+#include <unordered_map> // For the 5-card classes while building
+#include <utility>       // For std::pair
+
+namespace core = poker_solver::core;
+
+namespace poker_solver {
+namespace eval {
+
+namespace {
+
+constexpr int kNumShortRanks = core::kNumRanks - core::kShortDeckLowestRank; // 9
+constexpr uint32_t kNumRankPatterns = 1u << kNumShortRanks;
+// RanksHash keeps 4 bits per rank; shifting drops the deuce to five.
+constexpr int kRankCountShift = core::kShortDeckLowestRank * 4;
+constexpr uint64_t kShortDeckCards =
+    ((1ULL << core::kNumCardsInDeck) - 1) & ~((1ULL << (core::kShortDeckLowestRank * core::kNumSuits)) - 1);
+constexpr uint64_t kSuitMasks[core::kNumSuits] = {
+    0x1111111111111ULL, 0x2222222222222ULL, 0x4444444444444ULL, 0x8888888888888ULL};
+
+// The 9-bit rank pattern (bit 0 = six) of the cards of 'suit' in 'cards_mask'.
+uint32_t RankPattern(uint64_t cards_mask, int suit) {
+    uint64_t suit_bits = cards_mask >> suit;
+    uint32_t pattern = 0;
+    for (int rank = 0; rank < kNumShortRanks; ++rank) {
+        int card_rank = rank + core::kShortDeckLowestRank;
+        pattern |= static_cast<uint32_t>((suit_bits >> (card_rank * core::kNumSuits)) & 1ULL) << rank;
+    }
+    return pattern;
+}
+
+// Rank counts of 'copies' cards of short-deck 'rank'.
+uint64_t Counts(int rank, int copies) { return static_cast<uint64_t>(copies) << (4 * rank); }
+
+uint64_t CountsOfPattern(uint32_t pattern) {
+    uint64_t counts = 0;
+    for (int rank = 0; rank < kNumShortRanks; ++rank) {
+        if (pattern & (1u << rank)) counts += Counts(rank, 1);
+    }
+    return counts;
+}
+
+// The six straights, best first; A-6-7-8-9 is the lowest.
+constexpr int kNumStraights = 6;
+uint32_t StraightPattern(int index) {
+    return index < kNumStraights - 1 ? 0x1Fu << (kNumShortRanks - 5 - index) : 0x10Fu;
+}
+
+bool IsStraight(uint32_t pattern) {
+    for (int i = 0; i < kNumStraights; ++i) {
+        if (StraightPattern(i) == pattern) return true;
+    }
+    return false;
+}
+
+// Patterns of 'size' distinct ranks outside 'excluded', best first: for
+// equally many ranks, a larger bitmask holds the higher ranks.
+std::vector<uint32_t> PatternsDescending(int size, uint32_t excluded) {
+    std::vector<uint32_t> patterns;
+    for (uint32_t pattern = kNumRankPatterns; pattern-- > 0;) {
+        if (core::CountCards(pattern) == size && (pattern & excluded) == 0) patterns.push_back(pattern);
+    }
+    return patterns;
+}
+
+core::ComparisonResult CompareRanks(int rank1, int rank2) {
+    // Lower ranks are stronger; an invalid rank loses to any valid one.
+    if (rank1 < rank2) return core::ComparisonResult::kPlayer1Wins;
+    if (rank2 < rank1) return core::ComparisonResult::kPlayer2Wins;
+    return core::ComparisonResult::kTie;
+}
+
+} // namespace
+
+// --- Constructor ---
+
+ShortDeckCompairer::ShortDeckCompairer() {
+    BuildTables();
+}
+
+// --- Table Construction ---
+
+void ShortDeckCompairer::BuildTables() {
+    // 5-card classes in rank order.
+    std::vector<int> five_card_flushes(kNumRankPatterns, kInvalidRank);
+    std::unordered_map<uint64_t, int> five_card_counts;
+    int next_rank = 1;
+    auto add_flush = [&](uint32_t pattern) { five_card_flushes[pattern] = next_rank++; };
+    auto add_counts = [&](uint64_t counts) { five_card_counts[counts] = next_rank++; };
+
+    for (int i = 0; i < kNumStraights; ++i) add_flush(StraightPattern(i));
+    for (int quads = kNumShortRanks - 1; quads >= 0; --quads) {
+        for (int kicker = kNumShortRanks - 1; kicker >= 0; --kicker) {
+            if (kicker != quads) add_counts(Counts(quads, 4) + Counts(kicker, 1));
+        }
+    }
+    for (uint32_t pattern : PatternsDescending(5, 0)) {
+        if (!IsStraight(pattern)) add_flush(pattern);
+    }
+    for (int trips = kNumShortRanks - 1; trips >= 0; --trips) {
+        for (int pair = kNumShortRanks - 1; pair >= 0; --pair) {
+            if (pair != trips) add_counts(Counts(trips, 3) + Counts(pair, 2));
+        }
+    }
+    for (int trips = kNumShortRanks - 1; trips >= 0; --trips) {
+        for (uint32_t kickers : PatternsDescending(2, 1u << trips)) {
+            add_counts(Counts(trips, 3) + CountsOfPattern(kickers));
+        }
+    }
+    for (int i = 0; i < kNumStraights; ++i) add_counts(CountsOfPattern(StraightPattern(i)));
+    for (uint32_t pairs : PatternsDescending(2, 0)) {
+        for (int kicker = kNumShortRanks - 1; kicker >= 0; --kicker) {
+            if (!(pairs & (1u << kicker))) add_counts(2 * CountsOfPattern(pairs) + Counts(kicker, 1));
+        }
+    }
+    for (int pair = kNumShortRanks - 1; pair >= 0; --pair) {
+        for (uint32_t kickers : PatternsDescending(3, 1u << pair)) {
+            add_counts(Counts(pair, 2) + CountsOfPattern(kickers));
+        }
+    }
+    for (uint32_t pattern : PatternsDescending(5, 0)) {
+        if (!IsStraight(pattern)) add_counts(CountsOfPattern(pattern));
+    }
+    if (next_rank - 1 != kNumHandClasses) {
+        throw std::logic_error("ShortDeckCompairer: unexpected number of hand classes.");
+    }
+
+    // Best flush of every suited pattern of 5 to 7 ranks.
+    flush_ranks_.assign(kNumRankPatterns, kInvalidRank);
+    for (uint32_t pattern = 0; pattern < kNumRankPatterns; ++pattern) {
+        int num_cards = core::CountCards(pattern);
+        if (num_cards < kMinCards || num_cards > kMaxCards) continue;
+        for (uint32_t subset = pattern; subset != 0; subset = (subset - 1) & pattern) {
+            if (core::CountCards(subset) == kMinCards) {
+                flush_ranks_[pattern] = std::min(flush_ranks_[pattern], five_card_flushes[subset]);
+            }
+        }
+    }
+
+    // Best 5 of every rank-count multiset of 5 to 7 cards (at most 4 per rank).
+    std::function<int(int, int, uint64_t, uint64_t)> best_five =
+        [&](int rank, int remaining, uint64_t counts, uint64_t chosen) -> int {
+            if (remaining == 0) return five_card_counts.at(chosen);
+            if (rank == kNumShortRanks) return kInvalidRank;
+            int available = static_cast<int>((counts >> (4 * rank)) & 0xF);
+            int best = kInvalidRank;
+            for (int take = std::min(available, remaining); take >= 0; --take) {
+                best = std::min(best, best_five(rank + 1, remaining - take, counts, chosen + Counts(rank, take)));
+            }
+            return best;
+        };
+    std::vector<std::pair<uint64_t, int>> entries;
+    std::function<void(int, int, uint64_t)> enumerate = [&](int rank, int num_cards, uint64_t counts) {
+        if (rank == kNumShortRanks) {
+            if (num_cards >= kMinCards) entries.emplace_back(counts, best_five(0, kMinCards, counts, 0));
+            return;
+        }
+        for (int copies = 0; copies <= core::kNumSuits && num_cards + copies <= kMaxCards; ++copies) {
+            enumerate(rank + 1, num_cards + copies, counts + Counts(rank, copies));
+        }
+    };
+    enumerate(0, 0, 0);
+    std::sort(entries.begin(), entries.end());
+    rank_count_keys_.clear();
+    rank_count_ranks_.clear();
+    rank_count_keys_.reserve(entries.size());
+    rank_count_ranks_.reserve(entries.size());
+    for (const auto& entry : entries) {
+        rank_count_keys_.push_back(entry.first);
+        rank_count_ranks_.push_back(entry.second);
+    }
+}
+
+// --- Lookup ---
+
+int ShortDeckCompairer::RankOfMask(uint64_t cards_mask) const {
+    int num_cards = core::CountCards(cards_mask);
+    if (num_cards < kMinCards || num_cards > kMaxCards || (cards_mask & ~kShortDeckCards) != 0) {
+        return kInvalidRank;
+    }
+    uint64_t key = Dic5Compairer::RanksHash(cards_mask) >> kRankCountShift;
+    auto it = std::lower_bound(rank_count_keys_.begin(), rank_count_keys_.end(), key);
+    int rank = rank_count_ranks_[static_cast<size_t>(it - rank_count_keys_.begin())];
+    for (int suit = 0; suit < core::kNumSuits; ++suit) {
+        if (core::CountCards(cards_mask & kSuitMasks[suit]) >= kMinCards) {
+            // With at most 7 cards a flush rules out quads and full houses,
+            // so the better of the two lookups is the hand.
+            return std::min(rank, flush_ranks_[RankPattern(cards_mask, suit)]);
+        }
+    }
+    return rank;
+}
+
+size_t ShortDeckCompairer::MemoryBytes() const {
+    return flush_ranks_.size() * sizeof(int) + rank_count_keys_.size() * sizeof(uint64_t) +
+           rank_count_ranks_.size() * sizeof(int);
+}
+
+// --- Public Interface Methods ---
+
+int ShortDeckCompairer::GetHandRank(const std::vector<int>& private_hand,
+                                    const std::vector<int>& public_board) const {
+    if (private_hand.size() != 2) return kInvalidRank;
+    std::vector<int> all_cards = private_hand;
+    all_cards.insert(all_cards.end(), public_board.begin(), public_board.end());
+    uint64_t combined_mask = 0;
+    try { combined_mask = core::Card::CardIntsToUint64(all_cards); } catch (...) { return kInvalidRank; }
+    if (core::CountCards(combined_mask) != static_cast<int>(all_cards.size())) return kInvalidRank;
+    return RankOfMask(combined_mask);
+}
+
+int ShortDeckCompairer::GetHandRank(uint64_t private_mask, uint64_t public_mask) const {
+    if (core::Card::DoBoardsOverlap(private_mask, public_mask)) return kInvalidRank;
+    return RankOfMask(private_mask | public_mask);
+}
+
+core::ComparisonResult ShortDeckCompairer::CompareHands(const std::vector<int>& private_hand1,
+                                                        const std::vector<int>& private_hand2,
+                                                        const std::vector<int>& public_board) const {
+    uint64_t private1_mask = 0;
+    uint64_t private2_mask = 0;
+    try {
+        private1_mask = core::Card::CardIntsToUint64(private_hand1);
+        private2_mask = core::Card::CardIntsToUint64(private_hand2);
+    } catch (...) {
+        return core::ComparisonResult::kTie;
+    }
+    if (core::Card::DoBoardsOverlap(private1_mask, private2_mask)) return core::ComparisonResult::kTie;
+    return CompareRanks(GetHandRank(private_hand1, public_board), GetHandRank(private_hand2, public_board));
+}
+
+core::ComparisonResult ShortDeckCompairer::CompareHands(uint64_t private_mask1, uint64_t private_mask2,
+                                                        uint64_t public_mask) const {
+    if (core::Card::DoBoardsOverlap(private_mask1, public_mask) ||
+        core::Card::DoBoardsOverlap(private_mask2, public_mask) ||
+        core::Card::DoBoardsOverlap(private_mask1, private_mask2)) {
+        return core::ComparisonResult::kTie;
+    }
+    return CompareRanks(GetHandRank(private_mask1, public_mask), GetHandRank(private_mask2, public_mask));
+}
+
+} // namespace eval
+} // namespace poker_solver
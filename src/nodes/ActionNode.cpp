@@ -3,11 +3,14 @@
 
 // Include concrete Trainable implementations needed for lazy creation
 #include "trainable/DiscountedCfrTrainable.h" // Adjust path
-// #include "solver/discounted_cfr_trainable_hf.h" // Include if using half-float
-// #include "solver/discounted_cfr_trainable_sf.h" // Include if using single-float
+#include "trainable/CompactDiscountedCfrTrainable.h" // For SF / HF storage
+#include "trainable/CFRPlus.h"                       // For CfrPlusTrainable
+#include "trainable/LockedTrainable.h"               // For locked nodes
 
 #include <stdexcept>
 #include <sstream>
+#include <cmath>   // For std::isfinite
+#include <algorithm> // For std::fill
 #include <utility> // For std::move
 
 namespace poker_solver {
@@ -75,6 +78,33 @@ void ActionNode::SetPlayerRange(const std::vector<core::PrivateCards>* player_ra
     player_range_ = player_range;
 }
 
+uint64_t ActionNode::TrainableBytes(size_t num_actions, size_t num_hands,
+                                    TrainablePrecision precision,
+                                    TrainableAlgorithm algorithm,
+                                    bool lazy_strategies) {
+    const uint64_t table_size = static_cast<uint64_t>(num_actions) * num_hands;
+    if (table_size == 0) return 0;
+    // Regrets and strategy sums: 16-bit values plus a float scale per hand
+    // row, or plain floats.
+    const uint64_t half_bytes = 2 * (table_size * sizeof(int16_t) + num_hands * sizeof(float));
+    const uint64_t single_bytes = 2 * table_size * sizeof(float);
+    if (algorithm == TrainableAlgorithm::kCfrPlus) {
+        return precision == TrainablePrecision::kHalf ? half_bytes : single_bytes;
+    }
+    switch (precision) {
+        case TrainablePrecision::kHalf:
+            return half_bytes;
+        case TrainablePrecision::kSingle:
+            return single_bytes;
+        case TrainablePrecision::kFloat:
+        default: {
+            // One arena block, rounded up to a 64-byte cache line.
+            uint64_t block_bytes = solver::DiscountedCfrTrainable::BlockDoubles(table_size, lazy_strategies) * sizeof(double);
+            return (block_bytes + 63) / 64 * 64;
+        }
+    }
+}
+
 std::shared_ptr<solver::Trainable> ActionNode::GetTrainableIfExists(size_t deal_index) const {
      if (deal_index >= trainables_.size()) {
         std::ostringstream oss;
@@ -85,10 +115,30 @@ std::shared_ptr<solver::Trainable> ActionNode::GetTrainableIfExists(size_t deal_
     return trainables_[deal_index];
 }
 
+void ActionNode::ReplaceTrainable(size_t deal_index, std::shared_ptr<solver::Trainable> trainable) {
+    if (deal_index >= trainables_.size()) {
+        std::ostringstream oss;
+        oss << "Invalid deal_index (" << deal_index << ") for ActionNode. Max index is "
+            << (trainables_.size() > 0 ? trainables_.size() - 1 : 0) << ".";
+        throw std::out_of_range(oss.str());
+    }
+    trainables_[deal_index] = std::move(trainable);
+}
+
+void ActionNode::SetNumPossibleDeals(size_t num_possible_deals) {
+    if (num_possible_deals == 0) {
+        throw std::invalid_argument("Number of possible deals cannot be zero.");
+    }
+    trainables_.resize(num_possible_deals, nullptr);
+}
 
 std::shared_ptr<solver::Trainable> ActionNode::GetTrainable(
     size_t deal_index,
-    TrainablePrecision precision) {
+    TrainablePrecision precision,
+    TrainableAlgorithm algorithm,
+    const std::shared_ptr<solver::TrainableArena>& arena,
+    bool lazy_strategies,
+    bool defer_strategy_sums) {
 
     if (!player_range_) {
          throw std::runtime_error(
@@ -101,10 +151,20 @@ std::shared_ptr<solver::Trainable> ActionNode::GetTrainable(
         throw std::out_of_range(oss.str());
     }
 
+    if (!trainables_[deal_index] && locked_strategy_) {
+        trainables_[deal_index] =
+            std::make_shared<solver::LockedTrainable>(player_range_, *this, locked_strategy_);
+    }
     // Lazy creation: If the pointer at this index is null, create the object.
+    if (!trainables_[deal_index] && algorithm == TrainableAlgorithm::kCfrPlus) {
+        if (precision == TrainablePrecision::kHalf) {
+            trainables_[deal_index] = std::make_shared<solver::CfrPlusTrainableHF>(player_range_, *this);
+        } else {
+            trainables_[deal_index] = std::make_shared<solver::CfrPlusTrainableSF>(player_range_, *this);
+        }
+    }
     if (!trainables_[deal_index]) {
         // Select concrete Trainable type based on precision (or other config)
-        // For now, we only have DiscountedCfrTrainable implemented.
         switch (precision) {
             case TrainablePrecision::kFloat:
                 // Pass the associated player range and a reference to this node
@@ -113,19 +173,17 @@ std::shared_ptr<solver::Trainable> ActionNode::GetTrainable(
                 // The original passed 'this', let's stick to that for now.
                 trainables_[deal_index] =
                     std::make_shared<solver::DiscountedCfrTrainable>(
-                        player_range_, *this);
+                        player_range_, *this, arena, lazy_strategies, defer_strategy_sums);
                 break;
             case TrainablePrecision::kHalf:
-                 throw std::runtime_error("Half-float Trainable not implemented yet.");
-                 // trainables_[deal_index] =
-                 //    std::make_shared<solver::DiscountedCfrTrainableHF>(
-                 //        player_range_, *this);
+                 trainables_[deal_index] =
+                    std::make_shared<solver::DiscountedCfrTrainableHF>(
+                        player_range_, *this);
                 break;
             case TrainablePrecision::kSingle:
-                 throw std::runtime_error("Single-float Trainable not implemented yet.");
-                 // trainables_[deal_index] =
-                 //    std::make_shared<solver::DiscountedCfrTrainableSF>(
-                 //        player_range_, *this);
+                 trainables_[deal_index] =
+                    std::make_shared<solver::DiscountedCfrTrainableSF>(
+                        player_range_, *this);
                 break;
             default:
                  throw std::runtime_error("Unknown TrainablePrecision specified.");
@@ -135,6 +193,43 @@ std::shared_ptr<solver::Trainable> ActionNode::GetTrainable(
     return trainables_[deal_index];
 }
 
+void ActionNode::LockStrategy(std::vector<double> strategy) {
+    if (!player_range_) {
+         throw std::runtime_error(
+            "Player range must be set via SetPlayerRange before calling LockStrategy.");
+    }
+    const size_t num_actions = actions_.size();
+    const size_t num_hands = player_range_->size();
+    if (strategy.size() != num_actions * num_hands) {
+        std::ostringstream oss;
+        oss << "Locked strategy has " << strategy.size() << " values; expected " << num_actions
+            << " actions * " << num_hands << " hands.";
+        throw std::invalid_argument(oss.str());
+    }
+    for (size_t h = 0; h < num_hands; ++h) {
+        double row_sum = 0.0;
+        for (size_t a = 0; a < num_actions; ++a) {
+            const double probability = strategy[h * num_actions + a];
+            if (!std::isfinite(probability) || probability < 0.0) {
+                throw std::invalid_argument("Locked strategy values must be finite and non-negative.");
+            }
+            row_sum += probability;
+        }
+        if (std::abs(row_sum - 1.0) > 1e-6) {
+            std::ostringstream oss;
+            oss << "Locked strategy row of hand " << h << " sums to " << row_sum << ", not 1.";
+            throw std::invalid_argument(oss.str());
+        }
+    }
+    locked_strategy_ = std::make_shared<const std::vector<double>>(std::move(strategy));
+    std::fill(trainables_.begin(), trainables_.end(), nullptr);
+}
+
+void ActionNode::Unlock() {
+    if (!locked_strategy_) return;
+    locked_strategy_.reset();
+    std::fill(trainables_.begin(), trainables_.end(), nullptr);
+}
 
 } // namespace nodes
 } // namespace poker_solver
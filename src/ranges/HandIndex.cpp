@@ -0,0 +1,36 @@
+#include "ranges/HandIndex.h"
+
+namespace poker_solver {
+namespace core {
+
+namespace {
+
+HandIndexTables BuildHandIndexTables() {
+    HandIndexTables tables;
+    std::array<int, kNumCardsInDeck> num_blockers{};
+    // Walking combos in index order keeps each blocker list ascending.
+    for (int card2 = 1; card2 < kNumCardsInDeck; ++card2) {
+        for (int card1 = 0; card1 < card2; ++card1) {
+            int combo = ComboIndex(card1, card2);
+            tables.card1[combo] = static_cast<uint8_t>(card1);
+            tables.card2[combo] = static_cast<uint8_t>(card2);
+        }
+    }
+    for (int combo = 0; combo < kNumHandCombos; ++combo) {
+        int card1 = tables.card1[combo];
+        int card2 = tables.card2[combo];
+        tables.blockers[card1][num_blockers[card1]++] = static_cast<uint16_t>(combo);
+        tables.blockers[card2][num_blockers[card2]++] = static_cast<uint16_t>(combo);
+    }
+    return tables;
+}
+
+} // namespace
+
+const HandIndexTables& GetHandIndexTables() {
+    static const HandIndexTables tables = BuildHandIndexTables();
+    return tables;
+}
+
+} // namespace core
+} // namespace poker_solver
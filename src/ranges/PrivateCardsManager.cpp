@@ -8,8 +8,6 @@
 #include <iostream> // For std::cout / std::cerr
 #include <iomanip> // For std::fixed / std::setprecision (optional)
 #include <optional>
-#include <functional> // For std::hash
-#include <unordered_map> // Included for hand_hash_to_indices_
 #include <cmath> // For std::abs
 
 // Use aliases for namespaces
@@ -23,7 +21,7 @@ PrivateCardsManager::PrivateCardsManager(
     uint64_t initial_board_mask)
     : num_players_(initial_ranges.size()),
       initial_board_mask_(initial_board_mask),
-      player_ranges_(std::move(initial_ranges)), // Use move constructor
+      original_ranges_(std::move(initial_ranges)), // Use move constructor
       initial_reach_probs_(num_players_) {
 
     if (num_players_ == 0) {
@@ -36,32 +34,64 @@ PrivateCardsManager::PrivateCardsManager(
             "for initial reach probability calculation.");
     }
 
-    // --- Build the Hand Hash Lookup Table ---
-    std::hash<core::PrivateCards> hasher;
+    // --- Compact the Ranges ---
+    // Hands with no weight or blocked by the initial board can never be
+    // reached, so the solver's ranges leave them out entirely.
+    player_ranges_.resize(num_players_);
+    original_indices_.resize(num_players_);
+    compact_indices_.resize(num_players_);
+    for (size_t player_idx = 0; player_idx < num_players_; ++player_idx) {
+        const auto& original = original_ranges_[player_idx];
+        auto& compact = player_ranges_[player_idx];
+        compact.reserve(original.size());
+        compact_indices_[player_idx].assign(original.size(), -1);
+        for (size_t hand_idx = 0; hand_idx < original.size(); ++hand_idx) {
+            const core::PrivateCards& hand = original[hand_idx];
+            if (hand.Weight() <= 0.0 ||
+                core::Card::DoBoardsOverlap(hand.GetBoardMask(), initial_board_mask_)) {
+                continue;
+            }
+            compact_indices_[player_idx][hand_idx] = static_cast<int32_t>(compact.size());
+            original_indices_[player_idx].push_back(static_cast<int32_t>(hand_idx));
+            compact.push_back(hand);
+        }
+        if (compact.size() != original.size()) {
+            std::cout << "[INFO PCM] Player " << player_idx << " range compacted from "
+                      << original.size() << " to " << compact.size() << " hands." << std::endl;
+        }
+    }
+
+    // --- Build the Dense Combo Lookup Tables ---
+    combo_to_hand_.assign(num_players_, std::vector<int32_t>(core::kNumHandCombos, -1));
     for (size_t player_idx = 0; player_idx < num_players_; ++player_idx) {
         const auto& range = player_ranges_[player_idx];
         for (size_t hand_idx = 0; hand_idx < range.size(); ++hand_idx) {
             const core::PrivateCards& hand = range[hand_idx];
-            std::size_t hand_hash = hasher(hand);
-
-            // Ensure map entry exists for this hash
-            // Use try_emplace for potentially better efficiency if hash exists
-            auto [it, inserted] = hand_hash_to_indices_.try_emplace(hand_hash, std::vector<std::optional<size_t>>(num_players_, std::nullopt));
+            int32_t& slot = combo_to_hand_[player_idx][hand.GetComboIndex()];
 
             // Check for duplicate hands within the same player's range (optional but recommended)
-            if (it->second[player_idx].has_value()) { // Check if index already set
+            if (slot >= 0) {
                  std::ostringstream oss;
                  oss << "Duplicate hand found in range for player " << player_idx
-                     << " at index " << hand_idx << " and "
-                     << it->second[player_idx].value()
+                     << " at index " << hand_idx << " and " << slot
                      << " (Hand: " << hand.ToString() << ")";
                  // Depending on requirements, could throw or just warn
                  std::cerr << "[WARNING PCM] " << oss.str() << std::endl;
                  // If throwing is desired: throw std::invalid_argument(oss.str());
             }
 
-            // Store the index for this player and hand hash
-            it->second[player_idx] = hand_idx;
+            // The last occurrence wins, as with the former hash table.
+            slot = static_cast<int32_t>(hand_idx);
+        }
+    }
+
+    // --- Build the Per-Card Hand Lists ---
+    hands_with_card_.resize(num_players_);
+    for (size_t player_idx = 0; player_idx < num_players_; ++player_idx) {
+        const auto& range = player_ranges_[player_idx];
+        for (size_t hand_idx = 0; hand_idx < range.size(); ++hand_idx) {
+            hands_with_card_[player_idx][range[hand_idx].Card1Int()].push_back(static_cast<int32_t>(hand_idx));
+            hands_with_card_[player_idx][range[hand_idx].Card2Int()].push_back(static_cast<int32_t>(hand_idx));
         }
     }
 
@@ -80,6 +110,35 @@ const std::vector<core::PrivateCards>& PrivateCardsManager::GetPlayerRange(
     return player_ranges_[player_index];
 }
 
+const std::vector<core::PrivateCards>& PrivateCardsManager::GetOriginalRange(
+    size_t player_index) const {
+    if (player_index >= num_players_) {
+        std::ostringstream oss;
+        oss << "Invalid player index: " << player_index << ". Must be less than "
+            << num_players_ << ".";
+        throw std::out_of_range(oss.str());
+    }
+    return original_ranges_[player_index];
+}
+
+const std::vector<int32_t>& PrivateCardsManager::GetOriginalHandIndices(
+    size_t player_index) const {
+    if (player_index >= num_players_) {
+        std::ostringstream oss;
+        oss << "Invalid player index: " << player_index << ". Must be less than "
+            << num_players_ << ".";
+        throw std::out_of_range(oss.str());
+    }
+    return original_indices_[player_index];
+}
+
+int PrivateCardsManager::GetCompactHandIndex(size_t player_index, size_t original_index) const {
+    if (player_index >= num_players_ || original_index >= compact_indices_[player_index].size()) {
+        return -1;
+    }
+    return compact_indices_[player_index][original_index];
+}
+
 std::optional<size_t> PrivateCardsManager::GetOpponentHandIndex(
     size_t from_player_index,
     size_t to_player_index,
@@ -91,26 +150,32 @@ std::optional<size_t> PrivateCardsManager::GetOpponentHandIndex(
     }
 
     const core::PrivateCards& source_hand = player_ranges_[from_player_index][from_hand_index];
-    std::hash<core::PrivateCards> hasher;
-    std::size_t hand_hash = hasher(source_hand);
-
-    auto it = hand_hash_to_indices_.find(hand_hash);
-    if (it == hand_hash_to_indices_.end()) {
+    int hand_index = combo_to_hand_[to_player_index][source_hand.GetComboIndex()];
+    if (hand_index < 0) {
         // This might happen if a hand exists for one player but not the other
         // (e.g., asymmetric ranges after filtering or initial setup)
         return std::nullopt;
     }
+    return static_cast<size_t>(hand_index);
+}
 
-    // Return the optional index stored for the target player
-    // Check bounds just in case vector wasn't initialized correctly (shouldn't happen)
-    if (to_player_index < it->second.size()) {
-        return it->second[to_player_index];
-    } else {
-        return std::nullopt;
+int PrivateCardsManager::GetHandIndex(size_t player_index, int combo_index) const {
+    if (player_index >= num_players_ || combo_index < 0 || combo_index >= core::kNumHandCombos) {
+        return -1;
     }
+    return combo_to_hand_[player_index][combo_index];
 }
 
 
+const std::vector<int32_t>& PrivateCardsManager::GetHandsWithCard(size_t player_index, int card) const {
+    if (player_index >= num_players_ || !core::Card::IsValidCardInt(card)) {
+        std::ostringstream oss;
+        oss << "Invalid player index " << player_index << " or card " << card << ".";
+        throw std::out_of_range(oss.str());
+    }
+    return hands_with_card_[player_index][card];
+}
+
 // Calculates initial reach probabilities considering card removal.
 // Assumes num_players_ == 2.
 void PrivateCardsManager::CalculateInitialReachProbs() {
@@ -124,6 +189,14 @@ void PrivateCardsManager::CalculateInitialReachProbs() {
         const auto& oppo_range = player_ranges_[oppo_id];
         initial_reach_probs_[player_id].resize(player_range.size()); // Ensure size
 
+        // Opponent hands that do not conflict with the initial board.
+        std::vector<bool> oppo_valid(oppo_range.size());
+        double oppo_valid_weight = 0.0;
+        for (size_t j = 0; j < oppo_range.size(); ++j) {
+            oppo_valid[j] = !core::Card::DoBoardsOverlap(oppo_range[j].GetBoardMask(), initial_board_mask_);
+            if (oppo_valid[j]) oppo_valid_weight += oppo_range[j].Weight();
+        }
+
         for (size_t i = 0; i < player_range.size(); ++i) {
             const core::PrivateCards& player_hand = player_range[i];
             uint64_t player_mask = player_hand.GetBoardMask();
@@ -134,15 +207,18 @@ void PrivateCardsManager::CalculateInitialReachProbs() {
                 continue;
             }
 
-            double opponent_weight_sum = 0.0;
-            for (const auto& oppo_hand : oppo_range) {
-                uint64_t oppo_mask = oppo_hand.GetBoardMask();
-                // Accumulate weight only if opponent hand is valid (no overlap)
-                if (!core::Card::DoBoardsOverlap(oppo_mask, initial_board_mask_) &&
-                    !core::Card::DoBoardsOverlap(oppo_mask, player_mask)) {
-                    opponent_weight_sum += oppo_hand.Weight();
+            // Opponent weight off the board, minus the hands sharing a card
+            // with this one (the identical hand is in both card lists).
+            double opponent_weight_sum = oppo_valid_weight;
+            for (int card : {player_hand.Card1Int(), player_hand.Card2Int()}) {
+                for (int32_t oppo_idx : hands_with_card_[oppo_id][card]) {
+                    if (oppo_valid[oppo_idx]) opponent_weight_sum -= oppo_range[oppo_idx].Weight();
                 }
             }
+            int32_t same_idx = combo_to_hand_[oppo_id][player_hand.GetComboIndex()];
+            if (same_idx >= 0 && oppo_valid[same_idx]) {
+                opponent_weight_sum += oppo_range[same_idx].Weight();
+            }
 
             // Relative probability = P(Hand) * Sum(P(Opponent Hands not blocked by Hand))
             // Use hand weight directly as P(Hand) before normalization
@@ -1,5 +1,9 @@
 #include "ranges/RiverCombs.h" // Adjust path if necessary
 
+#include <limits>    // For std::numeric_limits
+#include <sstream>   // For error messages
+#include <stdexcept> // For std::out_of_range
+
 namespace poker_solver {
 namespace ranges {
 
@@ -17,5 +21,36 @@ RiverCombs::RiverCombs(const core::PrivateCards& pc, int r,
   // Initialization done via member initializer list.
 }
 
+size_t PackedRiverCombos::MemoryBytes() const {
+  return ranks.capacity() * sizeof(int32_t) + original_indices.capacity() * sizeof(uint16_t) +
+         card1s.capacity() + card2s.capacity() + run_starts.capacity() * sizeof(uint32_t);
+}
+
+PackedRiverCombos PackRiverCombos(const std::vector<RiverCombs>& combos) {
+  PackedRiverCombos packed;
+  packed.ranks.reserve(combos.size());
+  packed.original_indices.reserve(combos.size());
+  packed.card1s.reserve(combos.size());
+  packed.card2s.reserve(combos.size());
+  for (size_t r = 0; r < combos.size(); ++r) {
+    const RiverCombs& combo = combos[r];
+    if (combo.original_range_index > std::numeric_limits<uint16_t>::max()) {
+      std::ostringstream oss;
+      oss << "PackRiverCombos: original index " << combo.original_range_index
+          << " does not fit 16 bits.";
+      throw std::out_of_range(oss.str());
+    }
+    if (r == 0 || combo.rank != combos[r - 1].rank) {
+      packed.run_starts.push_back(static_cast<uint32_t>(r));
+    }
+    packed.ranks.push_back(combo.rank);
+    packed.original_indices.push_back(static_cast<uint16_t>(combo.original_range_index));
+    packed.card1s.push_back(static_cast<uint8_t>(combo.private_cards.Card1Int()));
+    packed.card2s.push_back(static_cast<uint8_t>(combo.private_cards.Card2Int()));
+  }
+  packed.run_starts.push_back(static_cast<uint32_t>(combos.size()));
+  return packed;
+}
+
 } // namespace ranges
 } // namespace poker_solver
@@ -11,6 +11,7 @@
 #include <bit>       // For std::popcount (C++20) - include if using
 #include <iostream>  // For std::cout, std::cerr
 #include <iomanip>   // For std::hex, std::dec
+#include <omp.h>     // For omp_get_thread_num
 
 // Use aliases for namespaces
 namespace core = poker_solver::core;
@@ -19,6 +20,20 @@ namespace eval = poker_solver::eval; // For kInvalidRank
 namespace poker_solver {
 namespace ranges {
 
+namespace {
+
+// n choose k for the small k of a board (k <= 5).
+uint64_t Binomial(int n, int k) {
+    if (k < 0 || k > n) return 0;
+    uint64_t result = 1;
+    for (int i = 1; i <= k; ++i) {
+        result = result * static_cast<uint64_t>(n - k + i) / static_cast<uint64_t>(i);
+    }
+    return result;
+}
+
+} // namespace
+
 // --- Constructor ---
 
 RiverRangeManager::RiverRangeManager(std::shared_ptr<core::Compairer> compairer)
@@ -30,14 +45,70 @@ RiverRangeManager::RiverRangeManager(std::shared_ptr<core::Compairer> compairer)
 
 // --- Public Methods ---
 
-const std::vector<RiverCombs>& RiverRangeManager::GetRiverCombos(
+const PackedRiverCombos& RiverRangeManager::GetPackedRiverCombos(
+    size_t player_index,
+    const std::vector<core::PrivateCards>& initial_player_range,
+    uint64_t river_board_mask) {
+    // The cache (or the preloaded index) still owns the entry.
+    return GetOrCreateEntry(player_index, initial_player_range, river_board_mask)->combos;
+}
+
+std::shared_ptr<const PackedRiverCombos> RiverRangeManager::AcquireRiverCombos(
+    size_t player_index,
+    const std::vector<core::PrivateCards>& initial_player_range,
+    uint64_t river_board_mask) {
+    std::shared_ptr<const CacheEntry> entry =
+        GetOrCreateEntry(player_index, initial_player_range, river_board_mask);
+    return std::shared_ptr<const PackedRiverCombos>(entry, &entry->combos);
+}
+
+std::vector<RiverCombs> RiverRangeManager::GetRiverCombos(
     size_t player_index,
     const std::vector<core::PrivateCards>& initial_player_range,
     uint64_t river_board_mask) {
+    std::shared_ptr<const PackedRiverCombos> packed =
+        AcquireRiverCombos(player_index, initial_player_range, river_board_mask);
+    std::vector<RiverCombs> combos;
+    combos.reserve(packed->size());
+    for (size_t r = 0; r < packed->size(); ++r) {
+        size_t original_index = packed->original_indices[r];
+        combos.emplace_back(initial_player_range[original_index], packed->ranks[r], original_index);
+    }
+    return combos;
+}
 
-    // Select the appropriate cache and mutex based on player index
-    auto& cache = (player_index == 0) ? player_0_cache_ : player_1_cache_;
-    auto& cache_mutex = (player_index == 0) ? player_0_cache_mutex_ : player_1_cache_mutex_;
+const RiverComboIndex& RiverRangeManager::GetRiverComboIndex(
+    size_t player_index,
+    const std::vector<core::PrivateCards>& initial_player_range,
+    uint64_t river_board_mask) {
+    return GetOrCreateEntry(player_index, initial_player_range, river_board_mask)->index;
+}
+
+void RiverRangeManager::SetMemoryBudget(size_t bytes) {
+    memory_budget_.store(bytes, std::memory_order_relaxed);
+    for (auto& cache : caches_) {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        EvictOverBudget(cache, 0);
+    }
+}
+
+RiverCacheStats RiverRangeManager::GetCacheStats() const {
+    RiverCacheStats stats;
+    stats.hits = cache_hits_.load(std::memory_order_relaxed);
+    stats.misses = cache_misses_.load(std::memory_order_relaxed);
+    stats.evictions = cache_evictions_.load(std::memory_order_relaxed);
+    stats.bytes = cached_bytes_.load(std::memory_order_relaxed);
+    for (const auto& cache : caches_) {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        stats.entries += cache.boards.size();
+    }
+    return stats;
+}
+
+std::shared_ptr<const RiverRangeManager::CacheEntry> RiverRangeManager::GetOrCreateEntry(
+    size_t player_index,
+    const std::vector<core::PrivateCards>& initial_player_range,
+    uint64_t river_board_mask) {
 
     if (player_index > 1) { // Basic check for 2 players
          std::ostringstream oss;
@@ -45,35 +116,35 @@ const std::vector<RiverCombs>& RiverRangeManager::GetRiverCombos(
          throw std::out_of_range(oss.str());
     }
 
-    // --- DEBUG LOGGING ---
-    // std::cout << "[RRM_GET] P" << player_index << " Board: 0x" << std::hex << river_board_mask << std::dec
-    //           << " RangeSize: " << initial_player_range.size() << std::endl;
-    // --- END DEBUG ---
+    // --- Preloaded Index (Lock-Free) ---
+    // Handed out without an owner: no reference count to touch.
+    int64_t board_number = PreloadedBoardNumber(river_board_mask);
+    if (board_number >= 0) {
+        return std::shared_ptr<const CacheEntry>(
+            std::shared_ptr<const CacheEntry>(),
+            &preloaded_entries_[player_index][static_cast<size_t>(board_number)]);
+    }
 
     // --- Cache Lookup (Thread-Safe) ---
+    PlayerCache& cache = caches_[player_index];
     { // Scope for lock guard
-        std::lock_guard<std::mutex> lock(cache_mutex);
-        auto it = cache.find(river_board_mask);
-        if (it != cache.end()) {
-            // --- DEBUG LOGGING ---
-            // std::cout << "[RRM_GET] Cache HIT! Board: 0x" << std::hex << river_board_mask << std::dec << std::endl;
-            // --- END DEBUG ---
-            return it->second;
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        CacheSlot* slot = cache.boards.find(river_board_mask);
+        if (slot) {
+            slot->referenced = true;
+            cache_hits_.fetch_add(1, std::memory_order_relaxed);
+            return slot->entry;
         }
     } // Lock released here
 
-    // --- DEBUG LOGGING ---
-    // std::cout << "[RRM_GET] Cache MISS. Board: 0x" << std::hex << river_board_mask << std::dec << ". Calculating..." << std::endl;
-    // --- END DEBUG ---
-
     // --- Not found in cache, calculate it ---
-    // Call the private method to do the calculation and caching
+    cache_misses_.fetch_add(1, std::memory_order_relaxed);
     return CalculateAndCacheRiverCombos(player_index, initial_player_range,
                                         river_board_mask);
 }
 
 // Overload for vector<int> board input
-const std::vector<RiverCombs>& RiverRangeManager::GetRiverCombos(
+std::vector<RiverCombs> RiverRangeManager::GetRiverCombos(
      size_t player_index,
      const std::vector<core::PrivateCards>& initial_player_range,
      const std::vector<int>& river_board_ints) {
@@ -94,10 +165,9 @@ const std::vector<RiverCombs>& RiverRangeManager::GetRiverCombos(
 
 // --- Private Calculation and Caching Method ---
 
-const std::vector<RiverCombs>& RiverRangeManager::CalculateAndCacheRiverCombos(
-    size_t player_index,
+RiverRangeManager::CacheEntry RiverRangeManager::ComputeEntry(
     const std::vector<core::PrivateCards>& initial_player_range,
-    uint64_t river_board_mask) {
+    uint64_t river_board_mask) const {
 
     // --- DEBUG LOGGING ---
     // std::cout << "[RRM_CALC] P" << player_index << " Board: 0x" << std::hex << river_board_mask << std::dec
@@ -105,19 +175,7 @@ const std::vector<RiverCombs>& RiverRangeManager::CalculateAndCacheRiverCombos(
     // --- END DEBUG ---
 
     // Validate board mask represents 5 cards
-    int pop_count = 0;
-    #if defined(__cpp_lib_bitops) && __cpp_lib_bitops >= 201907L
-        pop_count = std::popcount(river_board_mask);
-    #elif defined(__GNUC__) || defined(__clang__)
-        pop_count = __builtin_popcountll(river_board_mask);
-    #else
-        // Fallback popcount for older compilers
-        uint64_t temp_mask = river_board_mask;
-        while(temp_mask > 0) {
-            temp_mask &= (temp_mask - 1);
-            pop_count++;
-        }
-    #endif
+    int pop_count = core::CountCards(river_board_mask);
 
     if (pop_count != 5) {
         std::ostringstream oss;
@@ -127,31 +185,26 @@ const std::vector<RiverCombs>& RiverRangeManager::CalculateAndCacheRiverCombos(
     }
 
 
-    std::vector<RiverCombs> calculated_combos;
-    calculated_combos.reserve(initial_player_range.size()); // Pre-allocate approx size
-
+    // Collect the hands that do not conflict with the river board, then rank
+    // them in one batch so the board is preprocessed once.
+    std::vector<uint64_t> private_masks;
+    std::vector<size_t> range_indices;
+    private_masks.reserve(initial_player_range.size());
+    range_indices.reserve(initial_player_range.size());
     for (size_t i = 0; i < initial_player_range.size(); ++i) {
-        const core::PrivateCards& hand = initial_player_range[i];
-        uint64_t private_mask = hand.GetBoardMask();
-
-        // Skip hands that conflict with the river board
-        if (core::Card::DoBoardsOverlap(private_mask, river_board_mask)) {
-            // --- DEBUG LOGGING ---
-            // std::cout << "[RRM_CALC] Skipping hand " << hand.ToString()
-            //           << " (Idx " << i << ") due to board conflict with 0x" << std::hex << river_board_mask << std::dec << std::endl;
-            // --- END DEBUG ---
-            continue;
-        }
-
-        // Evaluate the 7-card hand rank using the injected compairer
-        int rank = compairer_->GetHandRank(private_mask, river_board_mask);
-
-        // --- DEBUG LOGGING ---
-        // std::cout << "[RRM_CALC] Hand: " << hand.ToString()
-        //           << " (Orig Idx " << i << "), Rank: " << rank << std::endl;
-        // --- END DEBUG ---
+        uint64_t private_mask = initial_player_range[i].GetBoardMask();
+        if (core::Card::DoBoardsOverlap(private_mask, river_board_mask)) continue;
+        private_masks.push_back(private_mask);
+        range_indices.push_back(i);
+    }
+    std::vector<int> ranks(private_masks.size());
+    compairer_->RankRange(private_masks.data(), private_masks.size(), river_board_mask, ranks.data());
 
-        calculated_combos.emplace_back(hand, rank, i);
+    std::vector<RiverCombs> calculated_combos;
+    calculated_combos.reserve(private_masks.size());
+    for (size_t k = 0; k < private_masks.size(); ++k) {
+        size_t i = range_indices[k];
+        calculated_combos.emplace_back(initial_player_range[i], ranks[k], i);
     }
 
     // --- DEBUG LOGGING ---
@@ -177,23 +230,190 @@ const std::vector<RiverCombs>& RiverRangeManager::CalculateAndCacheRiverCombos(
               });
 
 
+    // Build the dense index tables for the sorted order.
+    CacheEntry entry;
+    entry.index.original_to_river.assign(initial_player_range.size(), RiverComboIndex::kNotOnRiver);
+    entry.index.river_to_original.resize(calculated_combos.size());
+    for (size_t r = 0; r < calculated_combos.size(); ++r) {
+        size_t orig = calculated_combos[r].original_range_index;
+        entry.index.original_to_river[orig] = static_cast<int32_t>(r);
+        entry.index.river_to_original[r] = static_cast<int32_t>(orig);
+    }
+    entry.combos = PackRiverCombos(calculated_combos);
+    return entry;
+}
+
+std::shared_ptr<const RiverRangeManager::CacheEntry> RiverRangeManager::CalculateAndCacheRiverCombos(
+    size_t player_index,
+    const std::vector<core::PrivateCards>& initial_player_range,
+    uint64_t river_board_mask) {
+    auto entry = std::make_shared<const CacheEntry>(ComputeEntry(initial_player_range, river_board_mask));
+    size_t bytes = EntryBytes(*entry);
+
     // --- Cache Insertion (Thread-Safe) ---
-    // Select cache and mutex again
-    auto& cache = (player_index == 0) ? player_0_cache_ : player_1_cache_;
-    auto& cache_mutex = (player_index == 0) ? player_0_cache_mutex_ : player_1_cache_mutex_;
+    PlayerCache& cache = caches_[player_index];
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto result = cache.boards.try_emplace(river_board_mask, CacheSlot{entry, bytes, false});
+    if (!result.second) {
+        // Another thread cached this board first; share its entry.
+        return result.first->entry;
+    }
+    cache.clock_ring.push_back(river_board_mask);
+    cached_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    EvictOverBudget(cache, river_board_mask);
+    return entry;
+}
 
-    { // Scope for lock guard
-        std::lock_guard<std::mutex> lock(cache_mutex);
-        // --- DEBUG LOGGING ---
-        // std::cout << "[RRM_CALC] Inserting into cache. Player: " << player_index
-        //           << ", Board: 0x" << std::hex << river_board_mask << std::dec
-        //           << ", NumCombos: " << calculated_combos.size() << std::endl;
-        // --- END DEBUG ---
-        auto result = cache.emplace(river_board_mask, std::move(calculated_combos));
-        return result.first->second;
+// --- Eviction ---
+
+size_t RiverRangeManager::EntryBytes(const CacheEntry& entry) {
+    // Up to eight hash slots (the table is at least an eighth full once it
+    // has grown) and a ring slot.
+    constexpr size_t kSlotOverhead = 8 * (sizeof(uint64_t) + sizeof(CacheSlot));
+    return sizeof(CacheEntry) + kSlotOverhead + sizeof(uint64_t) + entry.combos.MemoryBytes() +
+           (entry.index.original_to_river.capacity() + entry.index.river_to_original.capacity()) *
+               sizeof(int32_t);
+}
+
+size_t RiverRangeManager::EstimateEntryBytes(size_t range_size) {
+    // Packed combos: rank, original index and two cards per hand, plus the
+    // run starts, which grow by push_back to at most twice their count.
+    const size_t combo_bytes = range_size * (sizeof(int32_t) + sizeof(uint16_t) + 2 * sizeof(uint8_t)) +
+                               2 * (range_size + 1) * sizeof(uint32_t);
+    constexpr size_t kSlotOverhead = 8 * (sizeof(uint64_t) + sizeof(CacheSlot));
+    return sizeof(CacheEntry) + kSlotOverhead + sizeof(uint64_t) + combo_bytes + 2 * range_size * sizeof(int32_t);
+}
+
+void RiverRangeManager::EvictOverBudget(PlayerCache& cache, uint64_t keep_board_mask) {
+    size_t budget = memory_budget_.load(std::memory_order_relaxed);
+    if (budget == 0) return;
+    // The board just inserted is kept, so its caller's reference stays valid
+    // and each cache holds at least one board.
+    while (cached_bytes_.load(std::memory_order_relaxed) > budget && cache.clock_ring.size() > 1) {
+        if (cache.clock_hand >= cache.clock_ring.size()) cache.clock_hand = 0;
+        uint64_t board = cache.clock_ring[cache.clock_hand];
+        CacheSlot& slot = cache.boards.at(board);
+        if (slot.referenced || board == keep_board_mask) {
+            slot.referenced = false; // Second chance
+            ++cache.clock_hand;
+            continue;
+        }
+        cached_bytes_.fetch_sub(slot.bytes, std::memory_order_relaxed);
+        cache.boards.erase(board);
+        // Fill the hole with the last board; the hand then examines it next.
+        cache.clock_ring[cache.clock_hand] = cache.clock_ring.back();
+        cache.clock_ring.pop_back();
+        cache_evictions_.fetch_add(1, std::memory_order_relaxed);
     }
 }
 
+// --- Preloaded Index ---
+
+void RiverRangeManager::PreloadRiverBoards(
+    const std::vector<core::PrivateCards>& player_0_range,
+    const std::vector<core::PrivateCards>& player_1_range,
+    uint64_t base_board_mask,
+    uint64_t deck_mask,
+    const RiverPreloadPlacement* placement) {
+    int num_base_cards = core::CountCards(base_board_mask);
+    if (num_base_cards > 5) {
+        std::ostringstream oss;
+        oss << "Preload base board must hold at most 5 cards, got " << num_base_cards << ".";
+        throw std::invalid_argument(oss.str());
+    }
+
+    // Enumerate the boards in board-number order: Gosper's hack walks the
+    // k-subsets of free-card positions in increasing (colex) order.
+    uint64_t free_mask = deck_mask & ~base_board_mask & ((1ULL << core::kNumCardsInDeck) - 1);
+    std::vector<int> free_cards;
+    for (int card = 0; card < core::kNumCardsInDeck; ++card) {
+        if ((free_mask >> card) & 1ULL) free_cards.push_back(card);
+    }
+    int num_free = static_cast<int>(free_cards.size());
+    int num_extra = 5 - num_base_cards;
+    std::vector<uint64_t> boards;
+    boards.reserve(Binomial(num_free, num_extra));
+    if (num_extra <= num_free) {
+        uint64_t positions = (1ULL << num_extra) - 1;
+        while (positions < (1ULL << num_free)) {
+            uint64_t board = base_board_mask;
+            for (int p = 0; p < num_free; ++p) {
+                if ((positions >> p) & 1ULL) board |= 1ULL << free_cards[p];
+            }
+            boards.push_back(board);
+            if (positions == 0) break;
+            uint64_t lowest = positions & (~positions + 1);
+            uint64_t ripple = positions + lowest;
+            positions = (((ripple ^ positions) >> 2) / lowest) | ripple;
+        }
+    }
+
+    std::vector<CacheEntry> entries[2];
+    entries[0].resize(boards.size());
+    entries[1].resize(boards.size());
+    const std::vector<core::PrivateCards>* ranges[2] = {&player_0_range, &player_1_range};
+    const int64_t num_boards = static_cast<int64_t>(boards.size());
+    if (placement && placement->num_homes > 1) {
+        const size_t num_homes = placement->num_homes;
+        std::vector<std::vector<size_t>> home_boards(num_homes);
+        for (size_t board = 0; board < boards.size(); ++board) {
+            home_boards[std::min(placement->home_of_board(boards[board]), num_homes - 1)].push_back(board);
+        }
+        // Per home, the next (board, player) item to compute.
+        std::vector<std::atomic<size_t>> next_item(num_homes);
+        #pragma omp parallel
+        {
+            const int num_threads = omp_get_num_threads();
+            const size_t home = placement->enter_thread(omp_get_thread_num(), num_threads);
+            const size_t homes_served = static_cast<size_t>(num_threads) < num_homes ? num_homes : 1;
+            for (size_t k = 0; k < homes_served; ++k) {
+                const size_t served = (home + k) % num_homes;
+                const std::vector<size_t>& mine = home_boards[served];
+                for (size_t item; (item = next_item[served].fetch_add(1)) < 2 * mine.size();) {
+                    const size_t player = item % 2;
+                    entries[player][mine[item / 2]] = ComputeEntry(*ranges[player], boards[mine[item / 2]]);
+                }
+            }
+        }
+    } else {
+        #pragma omp parallel for schedule(dynamic)
+        for (int64_t b = 0; b < 2 * num_boards; ++b) {
+            size_t player = static_cast<size_t>(b % 2);
+            size_t board = static_cast<size_t>(b / 2);
+            entries[player][board] = ComputeEntry(*ranges[player], boards[board]);
+        }
+    }
+
+    preload_base_mask_ = base_board_mask;
+    preload_free_mask_ = free_mask;
+    preload_num_extra_ = num_extra;
+    preloaded_boards_ = std::move(boards);
+    preloaded_entries_[0] = std::move(entries[0]);
+    preloaded_entries_[1] = std::move(entries[1]);
+    preloaded_bytes_ = preloaded_boards_.capacity() * sizeof(uint64_t);
+    for (const std::vector<CacheEntry>& player_entries : preloaded_entries_) {
+        preloaded_bytes_ += player_entries.capacity() * sizeof(CacheEntry);
+        for (const CacheEntry& entry : player_entries) {
+            preloaded_bytes_ += entry.combos.MemoryBytes() + (entry.index.original_to_river.capacity() +
+                                                              entry.index.river_to_original.capacity()) *
+                                                                 sizeof(int32_t);
+        }
+    }
+}
+
+int64_t RiverRangeManager::PreloadedBoardNumber(uint64_t river_board_mask) const {
+    if (preloaded_boards_.empty() || (river_board_mask & preload_base_mask_) != preload_base_mask_) {
+        return -1;
+    }
+    uint64_t extra = river_board_mask & ~preload_base_mask_;
+    if ((extra & ~preload_free_mask_) != 0 || core::CountCards(extra) != preload_num_extra_) return -1;
+    uint64_t number = 0;
+    for (int i = 1; extra != 0; ++i, extra &= extra - 1) {
+        uint64_t below = (extra & (~extra + 1)) - 1;
+        number += Binomial(core::CountCards(preload_free_mask_ & below), i);
+    }
+    return static_cast<int64_t>(number);
+}
 
 } // namespace ranges
-} // namespace poker_solver
\ No newline at end of file
+} // namespace poker_solver
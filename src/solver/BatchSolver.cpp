@@ -0,0 +1,248 @@
+#include "solver/BatchSolver.h"
+
+#include "Card.h"
+#include "GameTree.h"
+#include "ranges/PrivateCardsManager.h"
+#include "ranges/RiverRangeManager.h"
+#include "tools/PrivateRangeConverter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <omp.h>
+
+namespace poker_solver {
+namespace solver {
+
+namespace {
+
+// River caches shared by the spots of a batch. Spots with the same key
+// (board, deck, ranges, warmup) produce identical player ranges, so one
+// RiverRangeManager serves all of them; it is dropped once the last spot
+// expected for its key releases it.
+class RiverCachePool {
+  public:
+    struct Lease {
+        std::shared_ptr<ranges::RiverRangeManager> rrm;
+        bool reused = false;
+    };
+
+    explicit RiverCachePool(std::shared_ptr<core::Compairer> compairer) : compairer_(std::move(compairer)) {}
+
+    // Counts one more spot that will acquire 'key'. Call before any Acquire.
+    void Expect(const std::string& key) { ++entries_[key].remaining; }
+
+    // The manager for 'key', preloading the river boards of 'pcm's ranges
+    // on first use when 'preload' is set. Concurrent callers with the same
+    // key wait for that preload, so no lookup overlaps it.
+    Lease Acquire(const std::string& key, const ranges::PrivateCardsManager& pcm, uint64_t board_mask,
+                  uint64_t deck_mask, bool preload) {
+        std::shared_ptr<Shared> shared;
+        Lease lease;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            Entry& entry = entries_[key];
+            if (!entry.shared) {
+                entry.shared = std::make_shared<Shared>();
+                entry.shared->rrm = std::make_shared<ranges::RiverRangeManager>(compairer_);
+            }
+            lease.reused = entry.acquired;
+            entry.acquired = true;
+            shared = entry.shared;
+        }
+        if (preload) {
+            std::call_once(shared->preloaded, [&]() {
+                shared->rrm->PreloadRiverBoards(pcm.GetPlayerRange(0), pcm.GetPlayerRange(1), board_mask, deck_mask);
+            });
+        }
+        lease.rrm = shared->rrm;
+        return lease;
+    }
+
+    void Release(const std::string& key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end() && --it->second.remaining == 0) entries_.erase(it);
+    }
+
+  private:
+    struct Shared {
+        std::shared_ptr<ranges::RiverRangeManager> rrm;
+        std::once_flag preloaded;
+    };
+    struct Entry {
+        std::shared_ptr<Shared> shared;
+        size_t remaining = 0;
+        bool acquired = false;
+    };
+
+    std::shared_ptr<core::Compairer> compairer_;
+    std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+};
+
+uint64_t BoardMask(const config::Scenario& scenario) {
+    return core::Card::CardIntsToUint64(scenario.rule.GetInitialBoardCardsInt());
+}
+
+std::string RiverCacheKey(const BatchSpot& spot) {
+    return std::to_string(BoardMask(spot.scenario)) + '/' +
+           std::to_string(spot.scenario.rule.GetDeck().GetCardsMask()) + '/' +
+           (spot.config.warmup_river_cache ? "w/" : "l/") + spot.scenario.ranges[0] + '/' + spot.scenario.ranges[1];
+}
+
+std::vector<std::vector<core::PrivateCards>> ParseRanges(const config::Scenario& scenario) {
+    std::vector<std::vector<core::PrivateCards>> player_ranges;
+    for (const std::string& range : scenario.ranges) {
+        player_ranges.push_back(
+            ranges::PrivateRangeConverter::StringToPrivateCards(range, scenario.rule.GetInitialBoardCardsInt()));
+    }
+    return player_ranges;
+}
+
+// Estimates a spot from its tree (cheap next to training). Returns whether
+// it is small; sets result.error if it is over the memory limit.
+bool PlanSpot(const BatchSpot& spot, const BatchSolver::Options& options, BatchSpotResult& result) {
+    const std::vector<std::vector<core::PrivateCards>> player_ranges = ParseRanges(spot.scenario);
+    tree::GameTree game_tree(spot.scenario.rule);
+    PCfrSolver::Config config = spot.config;
+    config.num_threads = options.num_threads;
+    const PCfrSolver::MemoryEstimate estimate = PCfrSolver::EstimateMemory(
+        game_tree, spot.scenario.rule, {player_ranges[0].size(), player_ranges[1].size()}, config);
+    result.estimated_bytes = estimate.Total();
+    if (options.memory_limit > 0 && estimate.Total() > options.memory_limit) {
+        result.error = "estimated " + std::to_string(estimate.Total()) + " bytes exceed the " +
+                       std::to_string(options.memory_limit) + " byte limit";
+    }
+    return estimate.trainable_bytes <= options.small_spot_bytes;
+}
+
+} // namespace
+
+BatchSolver::Options::Options()
+    : num_threads(static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))),
+      small_spot_bytes(32u << 20),
+      memory_limit(0) {}
+
+BatchSolver::BatchSolver(std::shared_ptr<core::Compairer> compairer, Options options)
+    : compairer_(std::move(compairer)), options_(options) {
+    if (!compairer_) throw std::invalid_argument("BatchSolver: compairer cannot be null.");
+    options_.num_threads = std::max(1, options_.num_threads);
+}
+
+std::vector<BatchSpotResult> BatchSolver::Solve(const std::vector<BatchSpot>& spots,
+                                                const SolvedCallback& on_solved) {
+    std::vector<BatchSpotResult> results(spots.size());
+    RiverCachePool river_caches(compairer_);
+    std::vector<std::string> cache_keys(spots.size());
+    std::vector<std::optional<SpotKey>> spot_keys(spots.size());
+    std::vector<size_t> large_spots;
+    std::vector<size_t> small_spots;
+
+    // Plan: pick each spot's lane and count the spots per river cache.
+    const bool distributed = options_.transport && options_.transport->Size() > 1;
+    const bool use_store = options_.solution_store && !distributed;
+    omp_set_num_threads(options_.num_threads);
+    for (size_t i = 0; i < spots.size(); ++i) {
+        bool small = false;
+        try {
+            if (use_store) {
+                const auto start = std::chrono::steady_clock::now();
+                spot_keys[i] = SpotKey::Make(spots[i].scenario.rule, ParseRanges(spots[i].scenario), spots[i].config);
+                results[i].cached = options_.solution_store->Lookup(*spot_keys[i]);
+                results[i].seconds =
+                    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                if (results[i].cached) {
+                    results[i].solved = true;
+                    continue;
+                }
+            }
+            small = PlanSpot(spots[i], options_, results[i]);
+        } catch (const std::exception& e) {
+            results[i].error = e.what();
+        }
+        if (distributed) {
+            // Planning depends on local memory and may fail on one rank
+            // only; the group skips a spot if any rank does.
+            double skipped = results[i].error.empty() ? 0.0 : 1.0;
+            options_.transport->AllReduceSum(&skipped, 1);
+            if (skipped > 0.0 && results[i].error.empty()) results[i].error = "skipped by another rank";
+            small = false;
+        }
+        if (!results[i].error.empty()) continue;
+        (small ? small_spots : large_spots).push_back(i);
+        cache_keys[i] = RiverCacheKey(spots[i]);
+        river_caches.Expect(cache_keys[i]);
+    }
+
+    std::mutex callback_mutex;
+    auto solve_spot = [&](size_t i, int threads) {
+        const auto start = std::chrono::steady_clock::now();
+        const BatchSpot& spot = spots[i];
+        BatchSpotResult& result = results[i];
+        result.threads = threads;
+        bool released = false;
+        try {
+            omp_set_num_threads(threads);
+            PCfrSolver::Config config = spot.config;
+            config.num_threads = threads;
+            const bool preload = config.warmup_river_cache;
+            // The shared cache is preloaded once below instead of by each solver.
+            config.warmup_river_cache = false;
+
+            const uint64_t board_mask = BoardMask(spot.scenario);
+            auto game_tree = std::make_shared<tree::GameTree>(spot.scenario.rule);
+            auto pcm = std::make_shared<ranges::PrivateCardsManager>(ParseRanges(spot.scenario), board_mask);
+            RiverCachePool::Lease lease = river_caches.Acquire(cache_keys[i], *pcm, board_mask,
+                                                               spot.scenario.rule.GetDeck().GetCardsMask(), preload);
+            result.reused_river_cache = lease.reused;
+
+            PCfrSolver pcfr_solver(game_tree, pcm, lease.rrm, spot.scenario.rule, config);
+            if (distributed) pcfr_solver.SetTransport(options_.transport);
+            pcfr_solver.SetTraceRecorder(options_.trace);
+            pcfr_solver.Train();
+            result.iterations = pcfr_solver.GetCompletedIterations();
+            result.exploitability = pcfr_solver.GetLastExploitability();
+            result.memory_bytes = pcfr_solver.GetMemoryStats().Total();
+            // The solver holds its own reference to the manager.
+            river_caches.Release(cache_keys[i]);
+            released = true;
+            if (spot_keys[i]) options_.solution_store->Store(*spot_keys[i], pcfr_solver);
+            if (on_solved) {
+                std::lock_guard<std::mutex> lock(callback_mutex);
+                on_solved(i, pcfr_solver);
+            }
+            result.solved = true;
+        } catch (const std::exception& e) {
+            if (!released) river_caches.Release(cache_keys[i]);
+            result.error = e.what();
+        }
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    // Large spots scale across threads: one at a time, all threads each.
+    for (size_t i : large_spots) solve_spot(i, options_.num_threads);
+
+    // Small spots do not: one thread each, as many at once as threads.
+    std::atomic<size_t> next_small{0};
+    auto small_worker = [&]() {
+        for (size_t n = next_small++; n < small_spots.size(); n = next_small++) solve_spot(small_spots[n], 1);
+    };
+    const size_t num_workers = std::min(small_spots.size(), static_cast<size_t>(options_.num_threads));
+    std::vector<std::thread> workers;
+    for (size_t w = 1; w < num_workers; ++w) workers.emplace_back(small_worker);
+    if (num_workers > 0) small_worker();
+    for (std::thread& worker : workers) worker.join();
+    return results;
+}
+
+} // namespace solver
+} // namespace poker_solver
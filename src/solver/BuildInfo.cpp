@@ -0,0 +1,51 @@
+#include "solver/BuildInfo.h"
+#include "solver/VectorKernels.h" // For ActiveInstructionSet
+
+// Set by CMakeLists.txt on this file's target.
+#ifndef POKER_SOLVER_BUILD_TYPE
+#define POKER_SOLVER_BUILD_TYPE "unknown"
+#endif
+#ifndef POKER_SOLVER_TARGET_ARCH
+#define POKER_SOLVER_TARGET_ARCH ""
+#endif
+#ifndef POKER_SOLVER_LTO_ENABLED
+#define POKER_SOLVER_LTO_ENABLED 0
+#endif
+
+namespace poker_solver {
+namespace solver {
+
+const char* BuildType() {
+    // Multi-config generators leave an empty $<CONFIG> for the default one.
+    return POKER_SOLVER_BUILD_TYPE[0] != '\0' ? POKER_SOLVER_BUILD_TYPE : "unknown";
+}
+
+const char* TargetArch() { return POKER_SOLVER_TARGET_ARCH; }
+
+bool LinkTimeOptimized() { return POKER_SOLVER_LTO_ENABLED != 0; }
+
+bool AddressSanitized() {
+#if defined(__SANITIZE_ADDRESS__)
+    return true;
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+    return true;
+#else
+    return false;
+#endif
+#else
+    return false;
+#endif
+}
+
+std::string BuildSummary() {
+    std::string summary = BuildType();
+    if (LinkTimeOptimized()) summary += ", LTO";
+    if (TargetArch()[0] != '\0') summary += std::string(", -march=") + TargetArch();
+    if (AddressSanitized()) summary += ", AddressSanitizer";
+    summary += std::string(", kernels ") + kernels::ActiveInstructionSet();
+    return summary;
+}
+
+} // namespace solver
+} // namespace poker_solver
@@ -0,0 +1,116 @@
+#include "solver/EquityCalculator.h"
+#include "solver/UtilityKernels.h"      // For ShowdownUtilitySweep
+#include "solver/VectorKernels.h"       // For kernels::Accumulate
+#include "ranges/RiverRangeManager.h"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace core = poker_solver::core;
+
+namespace poker_solver {
+namespace solver {
+
+namespace {
+
+// Runouts are summed in this many fixed chunks, whatever the thread count.
+constexpr int64_t kRunoutChunks = 64;
+
+} // namespace
+
+EquityCalculator::EquityCalculator(std::shared_ptr<core::Compairer> compairer)
+    : compairer_(std::move(compairer)) {
+    if (!compairer_) {
+        throw std::invalid_argument("EquityCalculator: Compairer cannot be null.");
+    }
+}
+
+EquityResult EquityCalculator::Compute(
+    const std::vector<core::PrivateCards>& hero_range,
+    const std::vector<core::PrivateCards>& villain_range,
+    const std::vector<int>& board,
+    uint64_t deck_mask) const {
+
+    uint64_t board_mask = 0;
+    try {
+        board_mask = core::Card::CardIntsToUint64(board);
+    } catch (const std::out_of_range&) {
+        throw std::invalid_argument("EquityCalculator: Invalid card integer on the board.");
+    }
+    if (board.size() < 3 || board.size() > 5 ||
+        core::Card::Uint64ToCardInts(board_mask).size() != board.size()) {
+        std::ostringstream oss;
+        oss << "EquityCalculator: Board must hold 3 to 5 distinct cards, got " << board.size() << ".";
+        throw std::invalid_argument(oss.str());
+    }
+
+    // A private manager: its caches are keyed by player and board only, so
+    // they must not be shared with other ranges.
+    ranges::RiverRangeManager rrm(compairer_);
+    rrm.PreloadRiverBoards(hero_range, villain_range, board_mask, deck_mask);
+    const std::vector<uint64_t>& runouts = rrm.GetPreloadedBoards();
+
+    const size_t num_hero = hero_range.size();
+    const size_t num_villain = villain_range.size();
+    std::vector<double> hero_weights(num_hero);
+    std::vector<double> villain_weights(num_villain);
+    for (size_t i = 0; i < num_hero; ++i) hero_weights[i] = hero_range[i].Weight();
+    for (size_t j = 0; j < num_villain; ++j) villain_weights[j] = villain_range[j].Weight();
+
+    // Per hero hand, summed over runouts: villain weight beaten (ties half)
+    // and villain weight compatible with the hand and board. Runouts are
+    // summed in fixed chunks, added in order, so the sums do not depend on
+    // the thread count.
+    const int64_t num_runouts = static_cast<int64_t>(runouts.size());
+    const int64_t num_chunks = std::min<int64_t>(kRunoutChunks, num_runouts);
+    std::vector<double> chunk_sums(2 * static_cast<size_t>(num_chunks) * num_hero, 0.0);
+
+    #pragma omp parallel
+    {
+        std::vector<double> utility(num_hero);
+
+        #pragma omp for schedule(dynamic, 1) nowait
+        for (int64_t c = 0; c < num_chunks; ++c) {
+            double* chunk_won = chunk_sums.data() + 2 * c * num_hero;
+            double* chunk_faced = chunk_won + num_hero;
+            for (int64_t b = c * num_runouts / num_chunks; b < (c + 1) * num_runouts / num_chunks; ++b) {
+                const auto& hero_combos = rrm.GetPackedRiverCombos(0, hero_range, runouts[b]);
+                const auto& villain_combos = rrm.GetPackedRiverCombos(1, villain_range, runouts[b]);
+                ShowdownUtilitySweep(hero_combos, villain_combos,
+                                     num_hero, villain_weights.data(), num_villain,
+                                     1.0, 0.0, 0.5, utility.data());
+                kernels::Accumulate(chunk_won, utility.data(), num_hero);
+                ShowdownUtilitySweep(hero_combos, villain_combos,
+                                     num_hero, villain_weights.data(), num_villain,
+                                     1.0, 1.0, 1.0, utility.data());
+                kernels::Accumulate(chunk_faced, utility.data(), num_hero);
+            }
+        }
+    }
+    std::vector<double> won(num_hero, 0.0);
+    std::vector<double> faced(num_hero, 0.0);
+    for (int64_t c = 0; c < num_chunks; ++c) {
+        kernels::Accumulate(won.data(), chunk_sums.data() + 2 * c * num_hero, num_hero);
+        kernels::Accumulate(faced.data(), chunk_sums.data() + (2 * c + 1) * num_hero, num_hero);
+    }
+
+    EquityResult result;
+    result.num_runouts = runouts.size();
+    result.equities.assign(num_hero, 0.0);
+    result.matchup_weights.assign(num_hero, 0.0);
+    double range_won = 0.0;
+    double range_faced = 0.0;
+    for (size_t i = 0; i < num_hero; ++i) {
+        if (faced[i] > 0.0) result.equities[i] = won[i] / faced[i];
+        if (num_runouts > 0) result.matchup_weights[i] = faced[i] / static_cast<double>(num_runouts);
+        range_won += hero_weights[i] * won[i];
+        range_faced += hero_weights[i] * faced[i];
+    }
+    if (range_faced > 0.0) result.range_equity = range_won / range_faced;
+    return result;
+}
+
+} // namespace solver
+} // namespace poker_solver
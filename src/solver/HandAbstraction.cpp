@@ -0,0 +1,206 @@
+#include "solver/HandAbstraction.h"
+
+#include "ranges/RiverRangeManager.h"
+#include "solver/UtilityKernels.h"
+#include "Card.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace poker_solver {
+namespace solver {
+
+namespace {
+
+constexpr size_t kEquityBins = 10;
+constexpr int kMaxKMeansRounds = 25;
+
+double SquaredDistance(const double* a, const double* b) {
+    double distance = 0.0;
+    for (size_t i = 0; i < kEquityBins; ++i) distance += (a[i] - b[i]) * (a[i] - b[i]);
+    return distance;
+}
+
+} // namespace
+
+HandAbstraction::HandAbstraction(std::shared_ptr<ranges::RiverRangeManager> river_ranges, uint64_t deck_mask,
+                                 size_t num_buckets)
+    : river_ranges_(std::move(river_ranges)), deck_mask_(deck_mask), num_buckets_(num_buckets) {
+    if (!river_ranges_) throw std::invalid_argument("HandAbstraction: RiverRangeManager cannot be null.");
+    if (num_buckets_ == 0) throw std::invalid_argument("HandAbstraction: num_buckets must be positive.");
+}
+
+std::vector<double> HandAbstraction::EquityFeatures(size_t player,
+                                                    const std::vector<core::PrivateCards>& player_range,
+                                                    const std::vector<core::PrivateCards>& opponent_range,
+                                                    uint64_t board_mask, std::vector<double>& mean_equity,
+                                                    std::vector<char>& valid) const {
+    const size_t num_hands = player_range.size();
+    const size_t opponent = 1 - player;
+    std::vector<double> opponent_weights(opponent_range.size());
+    for (size_t o = 0; o < opponent_range.size(); ++o) opponent_weights[o] = std::max(0.0, opponent_range[o].Weight());
+
+    // Equity of every hand on one river board, or -1 where the board blocks
+    // it or leaves it no opponent hands.
+    std::vector<double> net(num_hands);
+    std::vector<double> weight(num_hands);
+    auto river_equity = [&](uint64_t river_board, std::vector<double>& equity) {
+        const auto player_combos = river_ranges_->AcquireRiverCombos(player, player_range, river_board);
+        const auto opponent_combos = river_ranges_->AcquireRiverCombos(opponent, opponent_range, river_board);
+        ShowdownUtilitySweep(*player_combos, *opponent_combos, num_hands, opponent_weights.data(),
+                             opponent_weights.size(), 1.0, -1.0, 0.0, net.data());
+        ShowdownUtilitySweep(*player_combos, *opponent_combos, num_hands, opponent_weights.data(),
+                             opponent_weights.size(), 1.0, 1.0, 1.0, weight.data());
+        for (size_t h = 0; h < num_hands; ++h) {
+            equity[h] = weight[h] > 0.0 ? 0.5 + 0.5 * net[h] / weight[h] : -1.0;
+        }
+    };
+
+    // Equities per hand and next card (the turn card on the flop, the river
+    // on the turn), -1 where the card is blocked.
+    const uint64_t remaining = deck_mask_ & ~board_mask;
+    std::vector<double> next_card_equity(num_hands * core::kNumCardsInDeck, -1.0);
+    std::vector<double> equity(num_hands);
+    if (core::CountCards(board_mask) == 4) {
+        core::ForEachCard(remaining, [&](int river) {
+            river_equity(board_mask | (1ULL << river), equity);
+            for (size_t h = 0; h < num_hands; ++h) next_card_equity[h * core::kNumCardsInDeck + river] = equity[h];
+        });
+    } else {
+        // Each turn card's equity is the mean over its rivers; every river
+        // board counts for both of its cards.
+        std::vector<double> sums(num_hands * core::kNumCardsInDeck, 0.0);
+        std::vector<int> counts(num_hands * core::kNumCardsInDeck, 0);
+        core::ForEachCard(remaining, [&](int first) {
+            core::ForEachCard(remaining & ~((2ULL << first) - 1), [&](int second) {
+                river_equity(board_mask | (1ULL << first) | (1ULL << second), equity);
+                for (size_t h = 0; h < num_hands; ++h) {
+                    if (equity[h] < 0.0) continue;
+                    for (int card : {first, second}) {
+                        sums[h * core::kNumCardsInDeck + card] += equity[h];
+                        ++counts[h * core::kNumCardsInDeck + card];
+                    }
+                }
+            });
+        });
+        for (size_t i = 0; i < sums.size(); ++i) {
+            if (counts[i] > 0) next_card_equity[i] = sums[i] / counts[i];
+        }
+    }
+
+    std::vector<double> features(num_hands * kEquityBins, 0.0);
+    mean_equity.assign(num_hands, 0.0);
+    valid.assign(num_hands, 0);
+    for (size_t h = 0; h < num_hands; ++h) {
+        double* histogram = features.data() + h * kEquityBins;
+        int outcomes = 0;
+        for (int card = 0; card < core::kNumCardsInDeck; ++card) {
+            const double value = next_card_equity[h * core::kNumCardsInDeck + card];
+            if (value < 0.0) continue;
+            histogram[std::min(kEquityBins - 1, static_cast<size_t>(value * kEquityBins))] += 1.0;
+            mean_equity[h] += value;
+            ++outcomes;
+        }
+        if (outcomes == 0) continue;
+        valid[h] = 1;
+        mean_equity[h] /= outcomes;
+        double cumulative = 0.0;
+        for (size_t b = 0; b < kEquityBins; ++b) {
+            cumulative += histogram[b] / outcomes;
+            histogram[b] = cumulative;
+        }
+    }
+    return features;
+}
+
+std::shared_ptr<const HandBuckets> HandAbstraction::BucketsFor(size_t player,
+                                                               const std::vector<core::PrivateCards>& player_range,
+                                                               const std::vector<core::PrivateCards>& opponent_range,
+                                                               uint64_t board_mask) {
+    const int board_cards = core::CountCards(board_mask);
+    if (board_cards != 3 && board_cards != 4) {
+        throw std::invalid_argument("HandAbstraction: only flop and turn boards are bucketed.");
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto cached = buckets_.find({player, board_mask});
+    if (cached != buckets_.end()) return cached->second;
+
+    std::vector<double> mean_equity;
+    std::vector<char> valid;
+    const std::vector<double> features =
+        EquityFeatures(player, player_range, opponent_range, board_mask, mean_equity, valid);
+    std::vector<size_t> hands; // Valid hands by ascending mean equity
+    for (size_t h = 0; h < player_range.size(); ++h) {
+        if (valid[h]) hands.push_back(h);
+    }
+    std::stable_sort(hands.begin(), hands.end(), [&](size_t a, size_t b) { return mean_equity[a] < mean_equity[b]; });
+
+    auto buckets = std::make_shared<HandBuckets>();
+    buckets->bucket_of_hand.assign(player_range.size(), 0);
+    const size_t k = std::min(num_buckets_, hands.size());
+    if (k > 0) {
+        std::vector<double> centroids(k * kEquityBins);
+        for (size_t c = 0; c < k; ++c) {
+            const size_t seed = hands[(2 * c + 1) * hands.size() / (2 * k)];
+            std::copy(features.begin() + seed * kEquityBins, features.begin() + (seed + 1) * kEquityBins,
+                      centroids.begin() + c * kEquityBins);
+        }
+        std::vector<size_t> cluster(player_range.size(), k);
+        for (int round = 0; round < kMaxKMeansRounds; ++round) {
+            bool changed = false;
+            for (size_t h : hands) {
+                size_t best = 0;
+                double best_distance = SquaredDistance(features.data() + h * kEquityBins, centroids.data());
+                for (size_t c = 1; c < k; ++c) {
+                    const double distance =
+                        SquaredDistance(features.data() + h * kEquityBins, centroids.data() + c * kEquityBins);
+                    if (distance < best_distance) {
+                        best = c;
+                        best_distance = distance;
+                    }
+                }
+                changed = changed || cluster[h] != best;
+                cluster[h] = best;
+            }
+            if (!changed) break;
+            // Empty clusters keep their centroid.
+            std::vector<double> sums(k * kEquityBins, 0.0);
+            std::vector<size_t> sizes(k, 0);
+            for (size_t h : hands) {
+                ++sizes[cluster[h]];
+                for (size_t b = 0; b < kEquityBins; ++b) sums[cluster[h] * kEquityBins + b] += features[h * kEquityBins + b];
+            }
+            for (size_t c = 0; c < k; ++c) {
+                if (sizes[c] == 0) continue;
+                for (size_t b = 0; b < kEquityBins; ++b) centroids[c * kEquityBins + b] = sums[c * kEquityBins + b] / sizes[c];
+            }
+        }
+
+        // Non-empty clusters, numbered by the mean equity of their hands.
+        std::vector<double> cluster_equity(k, 0.0);
+        std::vector<size_t> cluster_size(k, 0);
+        for (size_t h : hands) {
+            cluster_equity[cluster[h]] += mean_equity[h];
+            ++cluster_size[cluster[h]];
+        }
+        std::vector<size_t> order;
+        for (size_t c = 0; c < k; ++c) {
+            if (cluster_size[c] > 0) order.push_back(c);
+        }
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return cluster_equity[a] / cluster_size[a] < cluster_equity[b] / cluster_size[b];
+        });
+        std::vector<uint32_t> label(k, 0);
+        for (size_t i = 0; i < order.size(); ++i) label[order[i]] = static_cast<uint32_t>(i);
+        for (size_t h : hands) buckets->bucket_of_hand[h] = label[cluster[h]];
+        buckets->num_buckets = order.size();
+    }
+    if (buckets->num_buckets == 0 && !player_range.empty()) buckets->num_buckets = 1;
+    buckets_.emplace(std::make_pair(player, board_mask), buckets);
+    return buckets;
+}
+
+} // namespace solver
+} // namespace poker_solver
@@ -0,0 +1,138 @@
+#include "solver/HandGrid.h"
+
+#include "solver/StrategyFile.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace poker_solver {
+namespace solver {
+
+namespace {
+
+// Below this many hand values a grid is summed on the calling thread.
+constexpr size_t kParallelGridValues = 1 << 14;
+
+} // namespace
+
+size_t HandGridCell(int card1, int card2) {
+    const int index1 = core::kNumRanks - 1 - card1 / core::kNumSuits;
+    const int index2 = core::kNumRanks - 1 - card2 / core::kNumSuits;
+    if (index1 == index2) return static_cast<size_t>(index1 * core::kNumRanks + index1);
+    const bool suited = card1 % core::kNumSuits == card2 % core::kNumSuits;
+    const int high = std::min(index1, index2);
+    const int low = std::max(index1, index2);
+    return static_cast<size_t>(suited ? high * core::kNumRanks + low : low * core::kNumRanks + high);
+}
+
+HandGrid AggregateHandGrid(const std::vector<core::PrivateCards>& hands, const std::vector<double>& reach,
+                           const std::vector<double>& strategy, const std::vector<double>& evs, size_t num_actions) {
+    const size_t num_hands = hands.size();
+    if (num_actions == 0) throw std::invalid_argument("AggregateHandGrid: num_actions must be positive.");
+    if (reach.size() != num_hands || strategy.size() != num_hands * num_actions ||
+        (!evs.empty() && evs.size() != num_hands * num_actions)) {
+        throw std::invalid_argument("AggregateHandGrid: values do not match the hands.");
+    }
+
+    // Hands of each cell, in range order.
+    std::vector<std::vector<size_t>> cell_hands(kHandGridCells);
+    for (size_t h = 0; h < num_hands; ++h) {
+        if (reach[h] > 0.0) cell_hands[HandGridCell(hands[h].Card1Int(), hands[h].Card2Int())].push_back(h);
+    }
+
+    HandGrid grid;
+    grid.num_actions = num_actions;
+    grid.has_evs = !evs.empty();
+    grid.num_hands.assign(kHandGridCells, 0);
+    grid.reach.assign(kHandGridCells, 0.0);
+    grid.strategy.assign(kHandGridCells * num_actions, 0.0);
+    if (grid.has_evs) grid.evs.assign(kHandGridCells * num_actions, 0.0);
+    const long num_cells = static_cast<long>(kHandGridCells);
+    #pragma omp parallel for schedule(dynamic, 8) if(num_hands * num_actions >= kParallelGridValues)
+    for (long c = 0; c < num_cells; ++c) {
+        const size_t cell = static_cast<size_t>(c);
+        double* cell_strategy = grid.strategy.data() + cell * num_actions;
+        double* cell_evs = grid.has_evs ? grid.evs.data() + cell * num_actions : nullptr;
+        double cell_reach = 0.0;
+        for (size_t h : cell_hands[cell]) {
+            cell_reach += reach[h];
+            for (size_t a = 0; a < num_actions; ++a) {
+                cell_strategy[a] += reach[h] * strategy[h * num_actions + a];
+                if (cell_evs) cell_evs[a] += reach[h] * evs[h * num_actions + a];
+            }
+        }
+        grid.num_hands[cell] = cell_hands[cell].size();
+        grid.reach[cell] = cell_reach;
+        if (cell_reach <= 0.0) continue;
+        for (size_t a = 0; a < num_actions; ++a) {
+            cell_strategy[a] /= cell_reach;
+            if (cell_evs) cell_evs[a] /= cell_reach;
+        }
+    }
+
+    grid.action_combos.assign(num_actions, 0.0);
+    for (size_t cell = 0; cell < kHandGridCells; ++cell) {
+        for (size_t a = 0; a < num_actions; ++a) {
+            grid.action_combos[a] += grid.reach[cell] * grid.strategy[cell * num_actions + a];
+        }
+    }
+    return grid;
+}
+
+HandGridCache::HandGridCache(std::shared_ptr<const StrategyFile> file) : file_(std::move(file)) {
+    if (!file_) throw std::invalid_argument("HandGridCache: StrategyFile cannot be null.");
+}
+
+std::shared_ptr<const HandGrid> HandGridCache::Get(size_t node) {
+    if (node >= file_->NumNodes()) throw std::out_of_range("HandGridCache: no node " + std::to_string(node) + ".");
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto cached = grids_.find(node);
+        if (cached != grids_.end()) return cached->second;
+    }
+
+    // Cards dealt on the way are path components; hands holding them are
+    // not in play here.
+    uint64_t dealt_mask = 0;
+    std::string_view path = file_->Path(node);
+    while (!path.empty()) {
+        const size_t end = std::min(path.find('/'), path.size());
+        const std::string_view component = path.substr(0, end);
+        if (component.size() == 2) {
+            if (auto card = core::Card::StringToInt(std::string(component))) dealt_mask |= 1ULL << *card;
+        }
+        path.remove_prefix(std::min(end + 1, path.size()));
+    }
+
+    // The file's matrices are action-major.
+    const size_t num_actions = file_->NumActions(node);
+    const size_t num_hands = file_->NumHands(node);
+    std::vector<core::PrivateCards> hands;
+    std::vector<double> reach(num_hands);
+    hands.reserve(num_hands);
+    for (size_t h = 0; h < num_hands; ++h) {
+        hands.push_back(file_->Hand(node, h));
+        reach[h] = (dealt_mask & hands.back().GetBoardMask()) ? 0.0 : 1.0;
+    }
+    auto hand_major = [&](const std::vector<float>& matrix) {
+        std::vector<double> values(matrix.size());
+        for (size_t a = 0; a < num_actions; ++a) {
+            for (size_t h = 0; h < num_hands; ++h) values[h * num_actions + a] = matrix[a * num_hands + h];
+        }
+        return values;
+    };
+    auto grid = std::make_shared<const HandGrid>(
+        AggregateHandGrid(hands, reach, hand_major(file_->StrategyMatrix(node)),
+                          file_->HasEvs(node) ? hand_major(file_->EvMatrix(node)) : std::vector<double>(),
+                          num_actions));
+
+    // A concurrent Get of the same node may have won; both grids are equal.
+    std::lock_guard<std::mutex> lock(mutex_);
+    return grids_.emplace(node, std::move(grid)).first->second;
+}
+
+} // namespace solver
+} // namespace poker_solver
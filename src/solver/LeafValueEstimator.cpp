@@ -0,0 +1,92 @@
+#include "solver/LeafValueEstimator.h"
+
+#include "ranges/RiverRangeManager.h"
+#include "solver/UtilityKernels.h"
+#include "solver/VectorKernels.h"
+#include "Card.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <omp.h>
+
+namespace poker_solver {
+namespace solver {
+
+namespace {
+
+// Runouts are summed in this many fixed chunks, whatever the thread count.
+constexpr size_t kRunoutChunks = 16;
+
+} // namespace
+
+CheckDownLeafEstimator::CheckDownLeafEstimator(std::shared_ptr<ranges::RiverRangeManager> river_ranges)
+    : river_ranges_(std::move(river_ranges)) {
+    if (!river_ranges_) throw std::invalid_argument("CheckDownLeafEstimator: RiverRangeManager cannot be null.");
+}
+
+void CheckDownLeafEstimator::EstimateLeafValues(const Leaf& leaf) {
+    const size_t num_hands = leaf.player_range->size();
+    std::fill(leaf.values, leaf.values + num_hands, 0.0);
+    const int board_cards = core::CountCards(leaf.board_mask);
+    if (board_cards < 3) throw std::invalid_argument("CheckDownLeafEstimator: leaves need at least a flop.");
+
+    // Every river board the leaf's board can still become, used through a
+    // plain reference so that the worker threads below read this thread's.
+    thread_local std::vector<uint64_t> thread_boards;
+    std::vector<uint64_t>& boards = thread_boards;
+    boards.clear();
+    const uint64_t remaining = leaf.deck_mask & ~leaf.board_mask;
+    if (board_cards >= 5) {
+        boards.push_back(leaf.board_mask);
+    } else if (board_cards == 4) {
+        core::ForEachCard(remaining, [&](int card) { boards.push_back(leaf.board_mask | (1ULL << card)); });
+    } else {
+        core::ForEachCard(remaining, [&](int first) {
+            core::ForEachCard(remaining & ~((2ULL << first) - 1), [&](int second) {
+                boards.push_back(leaf.board_mask | (1ULL << first) | (1ULL << second));
+            });
+        });
+    }
+    if (boards.empty()) return;
+
+    // A pair of hands sees the runouts that avoid its four cards, C(n - 4, k)
+    // of the boards, so each board counts 1 / C(n - 4, k), as chance nodes
+    // weight their deals.
+    const int cards_left = core::CountCards(remaining);
+    const int cards_to_deal = std::max(0, 5 - board_cards);
+    double compatible_boards = 1.0;
+    for (int c = 0; c < cards_to_deal; ++c) compatible_boards = compatible_boards * (cards_left - 4 - c) / (c + 1);
+    if (compatible_boards < 1.0) return;
+    const size_t opponent = 1 - leaf.player;
+    const double stake = leaf.pot / 2.0 / compatible_boards;
+    auto add_boards = [&](size_t begin, size_t end, double* sum, double* row) {
+        for (size_t b = begin; b < end; ++b) {
+            const auto player_combos = river_ranges_->AcquireRiverCombos(leaf.player, *leaf.player_range, boards[b]);
+            const auto opponent_combos =
+                river_ranges_->AcquireRiverCombos(opponent, *leaf.opponent_range, boards[b]);
+            ShowdownUtilitySweep(*player_combos, *opponent_combos, num_hands, leaf.opponent_reach,
+                                 leaf.opponent_range->size(), stake, -stake, 0.0, row);
+            kernels::Accumulate(sum, row, num_hands);
+        }
+    };
+
+    const size_t chunks = std::min(kRunoutChunks, boards.size());
+    if (omp_in_parallel() || omp_get_max_threads() == 1 || chunks == 1) {
+        thread_local std::vector<double> row;
+        row.resize(num_hands);
+        add_boards(0, boards.size(), leaf.values, row.data());
+        return;
+    }
+    // One sum and one scratch row per chunk; chunks are added in order.
+    std::vector<double> sums(2 * chunks * num_hands, 0.0);
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (size_t c = 0; c < chunks; ++c) {
+        double* sum = sums.data() + 2 * c * num_hands;
+        add_boards(c * boards.size() / chunks, (c + 1) * boards.size() / chunks, sum, sum + num_hands);
+    }
+    for (size_t c = 0; c < chunks; ++c) kernels::Accumulate(leaf.values, sums.data() + 2 * c * num_hands, num_hands);
+}
+
+} // namespace solver
+} // namespace poker_solver
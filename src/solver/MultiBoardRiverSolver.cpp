@@ -0,0 +1,411 @@
+#include "solver/MultiBoardRiverSolver.h"
+
+#include "nodes/ActionNode.h"
+#include "ranges/PrivateCardsManager.h"
+#include "solver/UtilityKernels.h"
+#include "solver/VectorKernels.h"
+#include "Card.h"
+#include "Library.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#include <omp.h>
+
+namespace poker_solver {
+namespace solver {
+
+MultiBoardRiverSolver::MultiBoardRiverSolver(std::shared_ptr<tree::GameTree> game_tree,
+                                             std::array<std::vector<core::PrivateCards>, 2> ranges,
+                                             std::vector<uint64_t> board_masks,
+                                             std::shared_ptr<ranges::RiverRangeManager> rrm,
+                                             Config config)
+    : game_tree_(std::move(game_tree)),
+      boards_(std::move(board_masks)),
+      rrm_(std::move(rrm)),
+      showdown_backend_(std::make_shared<CpuShowdownBackend>()),
+      config_(config)
+{
+    if (!game_tree_ || !game_tree_->GetRoot()) throw std::invalid_argument("MultiBoardRiverSolver: empty game tree.");
+    if (!rrm_) throw std::invalid_argument("MultiBoardRiverSolver: RiverRangeManager cannot be null.");
+    if (boards_.empty()) throw std::invalid_argument("MultiBoardRiverSolver: no boards.");
+    for (uint64_t board : boards_) {
+        if (core::CountCards(board) != 5) throw std::invalid_argument("MultiBoardRiverSolver: a board does not have five cards.");
+    }
+    flat_tree_ = std::make_unique<tree::FlatGameTree>(*game_tree_);
+    if (flat_tree_->Node(0).round != core::GameRound::kRiver || flat_tree_->Count(core::GameTreeNodeType::kChance) > 0) {
+        throw std::invalid_argument("MultiBoardRiverSolver: the tree must be a river tree.");
+    }
+
+    // The strategies cover each range minus its zero-weight hands, on every
+    // board; a board's own PrivateCardsManager gives the initial reach of
+    // the hands it does not block.
+    const ranges::PrivateCardsManager all_boards(std::vector<std::vector<core::PrivateCards>>(ranges.begin(), ranges.end()), 0);
+    for (size_t p = 0; p < 2; ++p) {
+        ranges_[p] = all_boards.GetPlayerRange(p);
+        num_hands_[p] = ranges_[p].size();
+        root_reach_[p].assign(boards_.size() * num_hands_[p], 0.0);
+        root_reach_sums_[p].assign(boards_.size(), 0.0);
+    }
+    for (size_t b = 0; b < boards_.size(); ++b) {
+        const ranges::PrivateCardsManager on_board(std::vector<std::vector<core::PrivateCards>>(ranges.begin(), ranges.end()),
+                                                   boards_[b]);
+        for (size_t p = 0; p < 2; ++p) {
+            const std::vector<double>& reach = on_board.GetInitialReachProbs(p);
+            const std::vector<int32_t>& original = on_board.GetOriginalHandIndices(p);
+            double* row = root_reach_[p].data() + b * num_hands_[p];
+            for (size_t i = 0; i < reach.size(); ++i) {
+                row[all_boards.GetCompactHandIndex(p, static_cast<size_t>(original[i]))] = reach[i];
+            }
+            root_reach_sums_[p][b] = kernels::Sum(row, num_hands_[p]);
+            if (root_reach_sums_[p][b] < 1e-12) {
+                throw std::invalid_argument("MultiBoardRiverSolver: player " + std::to_string(p) +
+                                            " has no hand on a board.");
+            }
+        }
+    }
+
+    // Tables for every action node, and scratch for every depth.
+    tables_.resize(flat_tree_->NumActionNodes());
+    size_t max_depth = 0;
+    std::vector<std::pair<uint32_t, size_t>> stack = {{0, 0}};
+    while (!stack.empty()) {
+        auto [index, depth] = stack.back();
+        stack.pop_back();
+        max_depth = std::max(max_depth, depth);
+        const tree::FlatNode& node = flat_tree_->Node(index);
+        if (node.type != core::GameTreeNodeType::kAction) continue;
+        NodeTables& tables = tables_[node.payload];
+        tables.regrets.assign(node.num_children * boards_.size() * num_hands_[node.player], 0.0);
+        tables.strategy_sums.assign(tables.regrets.size(), 0.0);
+        tables.current.assign(tables.regrets.size(), 1.0 / static_cast<double>(node.num_children));
+        for (uint32_t a = 0; a < node.num_children; ++a) stack.emplace_back(node.first_child + a, depth + 1);
+    }
+    levels_.resize(max_depth + 1);
+}
+
+void MultiBoardRiverSolver::SetShowdownBackend(std::shared_ptr<ShowdownBackend> backend) {
+    showdown_backend_ = backend ? std::move(backend) : std::make_shared<CpuShowdownBackend>();
+}
+
+void MultiBoardRiverSolver::Train() {
+    const uint64_t start_time = utils::TimeSinceEpochMillisec();
+    const int num_boards = static_cast<int>(boards_.size());
+    if (combos_[0].empty() && flat_tree_->Count(core::GameTreeNodeType::kShowdown) > 0) {
+        for (size_t p = 0; p < 2; ++p) {
+            combos_[p].resize(boards_.size());
+            #pragma omp parallel for num_threads(std::max(1, config_.num_threads)) schedule(dynamic)
+            for (int b = 0; b < num_boards; ++b) {
+                combos_[p][b] = rrm_->AcquireRiverCombos(p, ranges_[p], boards_[b]);
+            }
+            combo_ptrs_[p].clear();
+            for (const auto& combos : combos_[p]) combo_ptrs_[p].push_back(combos.get());
+        }
+    }
+
+    const Rows reach = {root_reach_[0].data(), root_reach_[1].data()};
+    const Rows reach_sums = {root_reach_sums_[0].data(), root_reach_sums_[1].data()};
+    std::vector<double> root_utility(boards_.size() * std::max(num_hands_[0], num_hands_[1]));
+    const int first_iteration = completed_iterations_ + 1;
+    for (int i = first_iteration; i <= config_.iteration_limit; ++i) {
+        const IterationDiscounts discounts = IterationDiscounts::For(i, config_.dcfr);
+        // Alternating updates, as PCfrSolver's default.
+        for (size_t traverser = 0; traverser < 2; ++traverser) {
+            Traverse(0, reach, reach_sums, traverser, root_utility.data(), discounts, 0);
+        }
+        completed_iterations_ = i;
+    }
+    std::cout << "[INFO] Multi-board river solve: " << boards_.size() << " boards, "
+              << std::max(0, completed_iterations_ - first_iteration + 1) << " iterations in "
+              << (utils::TimeSinceEpochMillisec() - start_time) << " ms." << std::endl;
+}
+
+void MultiBoardRiverSolver::Traverse(uint32_t node_index, const Rows& reach, const Rows& reach_sums,
+                                     size_t traverser, double* utility, const IterationDiscounts& discounts,
+                                     size_t depth) {
+    const tree::FlatNode& node = flat_tree_->Node(node_index);
+    switch (node.type) {
+        case core::GameTreeNodeType::kAction:
+            TraverseAction(node, reach, reach_sums, traverser, utility, discounts, depth);
+            return;
+        case core::GameTreeNodeType::kTerminal:
+            EvaluateFold(node, reach, reach_sums, traverser, utility);
+            return;
+        case core::GameTreeNodeType::kShowdown:
+            EvaluateShowdown(node, reach, reach_sums, traverser, utility, depth);
+            return;
+        default:
+            throw std::logic_error("MultiBoardRiverSolver: unexpected node type.");
+    }
+}
+
+void MultiBoardRiverSolver::TraverseAction(const tree::FlatNode& node, const Rows& reach, const Rows& reach_sums,
+                                           size_t traverser, double* utility, const IterationDiscounts& discounts,
+                                           size_t depth) {
+    const size_t num_boards = boards_.size();
+    const size_t acting_player = node.player;
+    const size_t num_actions = node.num_children;
+    const size_t acting_hands = num_hands_[acting_player];
+    const size_t acting_lanes = num_boards * acting_hands;
+    const size_t traverser_lanes = num_boards * num_hands_[traverser];
+
+    // As in PCfrSolver, a board is only skipped once neither player can
+    // reach the node there; its utility is zero and its tables stay as they
+    // are.
+    bool any_live = false;
+    for (size_t b = 0; b < num_boards && !any_live; ++b) {
+        any_live = reach_sums[0][b] >= 1e-12 || reach_sums[1][b] >= 1e-12;
+    }
+    if (!any_live || num_actions == 0) {
+        std::fill(utility, utility + traverser_lanes, 0.0);
+        return;
+    }
+
+    NodeTables& tables = tables_[node.payload];
+    Level& level = levels_[depth];
+    const double* strategy = tables.current.data();
+
+    // One pass per action over every board's hands: the kernels see the
+    // [board][hand] rows as a single vector (one action, hand-major).
+    level.reach.resize(num_actions * acting_lanes);
+    level.reach_sums.resize(num_actions * num_boards);
+    level.child_utility.resize(num_actions * traverser_lanes);
+    for (size_t a = 0; a < num_actions; ++a) {
+        double* child_reach = level.reach.data() + a * acting_lanes;
+        kernels::MultiplyByActionStrategy(child_reach, reach[acting_player], strategy + a * acting_lanes, 1, 0,
+                                          acting_lanes);
+        double* child_sums = level.reach_sums.data() + a * num_boards;
+        for (size_t b = 0; b < num_boards; ++b) {
+            child_sums[b] = reach_sums[acting_player][b] > 0.0
+                                ? kernels::Sum(child_reach + b * acting_hands, acting_hands) : 0.0;
+        }
+        Rows next_reach = reach;
+        next_reach[acting_player] = child_reach;
+        Rows next_reach_sums = reach_sums;
+        next_reach_sums[acting_player] = child_sums;
+        Traverse(node.first_child + static_cast<uint32_t>(a), next_reach, next_reach_sums, traverser,
+                 level.child_utility.data() + a * traverser_lanes, discounts, depth + 1);
+    }
+
+    // Acting player: strategy-weighted sum. Other player: the acting
+    // player's strategy is already in the reach passed down.
+    std::fill(utility, utility + traverser_lanes, 0.0);
+    for (size_t a = 0; a < num_actions; ++a) {
+        const double* child_utility = level.child_utility.data() + a * traverser_lanes;
+        if (acting_player == traverser) {
+            kernels::AccumulateWeightedByAction(utility, strategy + a * acting_lanes, 1, 0,
+                                                child_utility, traverser_lanes);
+        } else {
+            kernels::Accumulate(utility, child_utility, traverser_lanes);
+        }
+    }
+    if (acting_player != traverser) return;
+
+    // The DiscountedCfrTrainable update, lane by lane: average first, then
+    // the discounted regrets plus this visit's, then regret matching.
+    // Branch-free, so each board's lanes vectorize; adding a zero weight
+    // leaves a strategy sum as it was.
+    const double gamma = discounts.strategy_weight;
+    level.regret_sum.resize(acting_lanes);
+    for (size_t b = 0; b < num_boards; ++b) {
+        if (reach_sums[0][b] < 1e-12 && reach_sums[1][b] < 1e-12) continue;
+        const size_t begin = b * acting_hands;
+        const size_t end = begin + acting_hands;
+        double* regret_sum = level.regret_sum.data();
+        std::fill(regret_sum + begin, regret_sum + end, 0.0);
+        for (size_t a = 0; a < num_actions; ++a) {
+            double* regrets = tables.regrets.data() + a * acting_lanes;
+            double* strategy_sums = tables.strategy_sums.data() + a * acting_lanes;
+            const double* current = strategy + a * acting_lanes;
+            const double* child_utility = level.child_utility.data() + a * acting_lanes;
+            for (size_t l = begin; l < end; ++l) {
+                const double weight = std::max(0.0, reach[acting_player][l]) * gamma;
+                strategy_sums[l] += (weight >= 1e-12 ? weight : 0.0) * current[l];
+                const double regret = regrets[l];
+                regrets[l] = regret * (regret > 0 ? discounts.positive_regret : discounts.negative_regret) +
+                             (child_utility[l] - utility[l]);
+                regret_sum[l] += std::max(0.0, regrets[l]);
+            }
+        }
+        const double default_prob = 1.0 / static_cast<double>(num_actions);
+        for (size_t a = 0; a < num_actions; ++a) {
+            const double* regrets = tables.regrets.data() + a * acting_lanes;
+            double* current = tables.current.data() + a * acting_lanes;
+            for (size_t l = begin; l < end; ++l) {
+                current[l] = regret_sum[l] > 1e-12 ? std::max(0.0, regrets[l]) / regret_sum[l] : default_prob;
+            }
+        }
+    }
+}
+
+void MultiBoardRiverSolver::EvaluateFold(const tree::FlatNode& node, const Rows& reach, const Rows& reach_sums,
+                                         size_t traverser, double* utility) {
+    const size_t opponent = 1 - traverser;
+    const double payoff = flat_tree_->TerminalPayoff(node, traverser);
+    const size_t traverser_hands = num_hands_[traverser];
+    const int num_boards = static_cast<int>(boards_.size());
+    #pragma omp parallel for num_threads(std::max(1, config_.num_threads)) schedule(static) if(config_.num_threads > 1)
+    for (int b = 0; b < num_boards; ++b) {
+        double* row = utility + b * traverser_hands;
+        if (reach_sums[opponent][b] < 1e-12) {
+            std::fill(row, row + traverser_hands, 0.0);
+            continue;
+        }
+        // Hands the board blocks have zero reach, so the card removal of
+        // the full ranges is that of the board's own.
+        FoldUtilityLinear(ranges_[traverser], ranges_[opponent], reach[opponent] + b * num_hands_[opponent], payoff,
+                          row);
+    }
+}
+
+void MultiBoardRiverSolver::EvaluateShowdown(const tree::FlatNode& node, const Rows& reach, const Rows& reach_sums,
+                                             size_t traverser, double* utility, size_t depth) {
+    const size_t opponent = 1 - traverser;
+    const size_t traverser_hands = num_hands_[traverser];
+    const size_t num_boards = boards_.size();
+    Level& level = levels_[depth];
+    level.batch_utility.resize(num_boards);
+    for (size_t b = 0; b < num_boards; ++b) level.batch_utility[b] = utility + b * traverser_hands;
+
+    // Every board goes in one batch, boards nobody reaches included, so the
+    // opponent reach rows keep a fixed stride.
+    const double* payoffs = flat_tree_->ShowdownPayoffs(node); // Player 0 wins / player 1 wins / tie
+    ShowdownBackend::Batch batch;
+    batch.num_boards = num_boards;
+    batch.board_masks = boards_.data();
+    batch.traverser_combos = combo_ptrs_[traverser].data();
+    batch.opponent_combos = combo_ptrs_[opponent].data();
+    batch.opponent_reach = reach[opponent];
+    batch.opponent_reach_stride = num_hands_[opponent];
+    batch.traverser_hands = traverser_hands;
+    batch.opponent_hands = num_hands_[opponent];
+    batch.win_payoff = traverser == 0 ? payoffs[0] : payoffs[3];
+    batch.lose_payoff = traverser == 0 ? payoffs[2] : payoffs[1];
+    batch.tie_payoff = payoffs[4 + traverser];
+    batch.utility = level.batch_utility.data();
+    const int threads = std::max(1, std::min(config_.num_threads, static_cast<int>(num_boards)));
+    if (threads == 1) {
+        showdown_backend_->EvaluateShowdowns(batch);
+    } else {
+        // One contiguous slice of the boards per thread.
+        #pragma omp parallel for num_threads(threads) schedule(static)
+        for (int slice = 0; slice < threads; ++slice) {
+            const size_t begin = num_boards * slice / threads;
+            const size_t end = num_boards * (slice + 1) / threads;
+            ShowdownBackend::Batch part = batch;
+            part.num_boards = end - begin;
+            part.board_masks += begin;
+            part.traverser_combos += begin;
+            part.opponent_combos += begin;
+            part.opponent_reach += begin * batch.opponent_reach_stride;
+            part.utility += begin;
+            if (part.num_boards > 0) showdown_backend_->EvaluateShowdowns(part);
+        }
+    }
+    for (size_t b = 0; b < num_boards; ++b) {
+        if (reach_sums[opponent][b] < 1e-12) { // Nobody left to play against
+            std::fill(level.batch_utility[b], level.batch_utility[b] + traverser_hands, 0.0);
+        }
+    }
+}
+
+uint32_t MultiBoardRiverSolver::FindNode(const std::vector<std::string>& path) const {
+    uint32_t index = 0;
+    for (const std::string& step : path) {
+        const tree::FlatNode& node = flat_tree_->Node(index);
+        if (node.type != core::GameTreeNodeType::kAction) {
+            throw std::invalid_argument("MultiBoardRiverSolver: path continues past a leaf at '" + step + "'.");
+        }
+        const auto& actions = flat_tree_->Action(node).GetActions();
+        auto it = std::find_if(actions.begin(), actions.end(),
+                               [&step](const core::GameAction& action) { return action.ToString() == step; });
+        if (it == actions.end()) throw std::invalid_argument("MultiBoardRiverSolver: no action '" + step + "'.");
+        index = node.first_child + static_cast<uint32_t>(it - actions.begin());
+    }
+    if (flat_tree_->Node(index).type != core::GameTreeNodeType::kAction) {
+        throw std::invalid_argument("MultiBoardRiverSolver: path does not end at an action node.");
+    }
+    return index;
+}
+
+std::vector<double> MultiBoardRiverSolver::AverageStrategy(const tree::FlatNode& node, size_t board) const {
+    const NodeTables& tables = tables_[node.payload];
+    const size_t num_actions = node.num_children;
+    const size_t num_hands = num_hands_[node.player];
+    const size_t lanes = boards_.size() * num_hands;
+    // NormalizeStrategySums of the board's lanes, turned hand-major.
+    std::vector<double> strategy(num_actions * num_hands);
+    for (size_t h = 0; h < num_hands; ++h) {
+        const size_t lane = board * num_hands + h;
+        double total = 0.0;
+        for (size_t a = 0; a < num_actions; ++a) total += tables.strategy_sums[a * lanes + lane];
+        for (size_t a = 0; a < num_actions; ++a) {
+            strategy[h * num_actions + a] = total > 1e-12 ? tables.strategy_sums[a * lanes + lane] / total
+                                                          : 1.0 / static_cast<double>(num_actions);
+        }
+    }
+    return strategy;
+}
+
+std::vector<double> MultiBoardRiverSolver::GetAverageStrategy(const std::vector<std::string>& path,
+                                                              size_t board) const {
+    if (board >= boards_.size()) throw std::out_of_range("MultiBoardRiverSolver: board index out of range.");
+    return AverageStrategy(flat_tree_->Node(FindNode(path)), board);
+}
+
+nlohmann::json MultiBoardRiverSolver::DumpStrategy(size_t board) const {
+    if (board >= boards_.size()) throw std::out_of_range("MultiBoardRiverSolver: board index out of range.");
+    nlohmann::json result = DumpNode(0, board, 0);
+    std::string board_string;
+    for (int card : core::Card::Uint64ToCardInts(boards_[board])) board_string += core::Card::IntToString(card);
+    result["metadata"]["board"] = board_string;
+    return result;
+}
+
+nlohmann::json MultiBoardRiverSolver::DumpNode(uint32_t node_index, size_t board, int depth) const {
+    const tree::FlatNode& node = flat_tree_->Node(node_index);
+    nlohmann::json result;
+    result["round"] = core::GameTreeNode::GameRoundToString(node.round);
+    result["pot"] = node.pot;
+    result["depth"] = depth;
+    switch (node.type) {
+        case core::GameTreeNodeType::kAction: {
+            result["node_type"] = "Action";
+            result["player"] = node.player;
+            const auto& actions = flat_tree_->Action(node).GetActions();
+            const size_t num_actions = node.num_children;
+            const std::vector<double> average = AverageStrategy(node, board);
+            nlohmann::json action_strings = nlohmann::json::array();
+            for (const auto& action : actions) action_strings.push_back(action.ToString());
+            nlohmann::json strategy = nlohmann::json::object();
+            for (size_t h = 0; h < num_hands_[node.player]; ++h) {
+                const core::PrivateCards& hand = ranges_[node.player][h];
+                if (core::Card::DoBoardsOverlap(hand.GetBoardMask(), boards_[board])) continue;
+                strategy[hand.ToString()] = std::vector<double>(average.begin() + h * num_actions,
+                                                                average.begin() + (h + 1) * num_actions);
+            }
+            result["strategy_data"] = {{"actions", action_strings}, {"strategy", strategy}};
+            nlohmann::json children = nlohmann::json::object();
+            for (size_t a = 0; a < num_actions; ++a) {
+                children[actions[a].ToString()] = DumpNode(node.first_child + static_cast<uint32_t>(a), board, depth + 1);
+            }
+            if (!children.empty()) result["children"] = children;
+            break;
+        }
+        case core::GameTreeNodeType::kShowdown:
+            result["node_type"] = "Showdown";
+            break;
+        case core::GameTreeNodeType::kTerminal:
+            result["node_type"] = "Terminal";
+            result["payoffs"] = {flat_tree_->TerminalPayoff(node, 0), flat_tree_->TerminalPayoff(node, 1)};
+            break;
+        default:
+            result["node_type"] = "Unknown";
+            break;
+    }
+    return result;
+}
+
+} // namespace solver
+} // namespace poker_solver
@@ -0,0 +1,138 @@
+#include "solver/NumaTopology.h"
+
+#include <algorithm> // For std::sort
+#include <cctype>    // For std::isspace
+#include <cstdio>    // For std::sscanf
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <sched.h>
+#endif
+
+namespace poker_solver {
+namespace solver {
+
+namespace {
+
+// CPUs the calling thread may run on, or empty if they cannot be read.
+std::vector<int> AllowedCpus() {
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+    }
+#endif
+    return cpus;
+}
+
+bool SetAffinity(const std::vector<int>& cpus) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    return CPU_COUNT(&set) > 0 && sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)cpus;
+    return false;
+#endif
+}
+
+} // namespace
+
+NumaTopology::NumaTopology(std::vector<std::vector<int>> node_cpus) : node_cpus_(std::move(node_cpus)) {
+    for (const std::vector<int>& cpus : node_cpus_) {
+        if (cpus.empty()) throw std::invalid_argument("NumaTopology: every node needs a CPU.");
+    }
+}
+
+NumaTopology NumaTopology::Detect() {
+    std::vector<int> allowed = AllowedCpus();
+    if (allowed.empty()) {
+        for (unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); ++cpu) {
+            allowed.push_back(static_cast<int>(cpu));
+        }
+    }
+    std::vector<std::vector<int>> nodes;
+#ifdef __linux__
+    std::vector<int> node_ids;
+    if (DIR* dir = opendir("/sys/devices/system/node")) {
+        while (const dirent* entry = readdir(dir)) {
+            int id = 0;
+            char tail = 0;
+            if (std::sscanf(entry->d_name, "node%d%c", &id, &tail) == 1) node_ids.push_back(id);
+        }
+        closedir(dir);
+    }
+    std::sort(node_ids.begin(), node_ids.end());
+    for (int id : node_ids) {
+        std::ifstream in("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist");
+        std::string list;
+        if (!std::getline(in, list)) continue;
+        std::vector<int> cpus;
+        try {
+            for (int cpu : ParseCpuList(list)) {
+                if (std::binary_search(allowed.begin(), allowed.end(), cpu)) cpus.push_back(cpu);
+            }
+        } catch (const std::invalid_argument&) {
+            continue;
+        }
+        if (!cpus.empty()) nodes.push_back(std::move(cpus));
+    }
+#endif
+    if (nodes.empty()) nodes.push_back(std::move(allowed));
+    return NumaTopology(std::move(nodes));
+}
+
+size_t NumaTopology::NodeOfThread(int thread, int team_size) const {
+    if (node_cpus_.empty() || team_size <= 0 || thread < 0) return 0;
+    const size_t node = static_cast<size_t>(thread) * node_cpus_.size() / static_cast<size_t>(team_size);
+    return std::min(node, node_cpus_.size() - 1);
+}
+
+bool NumaTopology::PinCurrentThread(size_t node) const {
+    return node < node_cpus_.size() && SetAffinity(node_cpus_[node]);
+}
+
+ScopedThreadAffinity::ScopedThreadAffinity() : cpus_(AllowedCpus()) {}
+
+ScopedThreadAffinity::~ScopedThreadAffinity() {
+    if (!cpus_.empty()) SetAffinity(cpus_);
+}
+
+std::vector<int> ParseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::istringstream in(list);
+    std::string range;
+    while (std::getline(in, range, ',')) {
+        while (!range.empty() && std::isspace(static_cast<unsigned char>(range.back()))) range.pop_back();
+        if (range.empty()) continue;
+        int first = 0;
+        int last = 0;
+        char dash = 0;
+        char extra = 0;
+        const int fields = std::sscanf(range.c_str(), "%d%c%d%c", &first, &dash, &last, &extra);
+        if (fields == 1) {
+            last = first;
+        } else if (fields != 3 || dash != '-') {
+            throw std::invalid_argument("Malformed CPU list: " + list);
+        }
+        if (first < 0 || last < first) throw std::invalid_argument("Malformed CPU list: " + list);
+        for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+} // namespace solver
+} // namespace poker_solver
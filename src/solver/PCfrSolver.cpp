@@ -5,21 +5,41 @@
 #include "nodes/TerminalNode.h"
 #include "trainable/Trainable.h"
 #include "trainable/DiscountedCfrTrainable.h"
+#include "trainable/SparseDiscountedCfrTrainable.h"
+#include "trainable/BucketedDiscountedCfrTrainable.h"
+#include "solver/UtilityKernels.h"
+#include "solver/VectorKernels.h"
+#include "solver/TraversalScratch.h"
+#include "solver/BuildInfo.h"
+#include "solver/ShowdownBackend.h"
+#include "solver/LeafValueEstimator.h"
+#include "ranges/HandIndex.h"
 #include "Library.h"
 #include "Card.h"
 #include "tools/Rule.h"
+#include "tools/utils.h"
+#include "tools/BinaryIo.h"
+#include "tools/Compression.h"
 
 #include <stdexcept>
+#include <sstream>
 #include <vector>
 #include <numeric>
 #include <cmath>
+#include <limits>
 #include <iostream>
 #include <future>
 #include <thread>
 #include <algorithm>
+#include <array>
 #include <map>
 #include <iomanip>
 #include <utility> // For std::move
+#include <functional> // For std::function
+#include <fstream>    // For checkpoint files
+#include <cstring>    // For std::memcmp
+#include <cstdio>     // For std::rename
+#include <exception>  // For std::exception_ptr
 #include <omp.h>
 
 // Use aliases for namespaces (optional, but can make definitions cleaner)
@@ -34,6 +54,58 @@
 namespace poker_solver {
 namespace solver {
 
+namespace {
+
+// Writes the board mask of every 'k'-card subset of 'cards' into 'outcomes'
+// (cleared first), in the lexicographic order utils::Combinations produces.
+void EnumerateDealMasks(const int* cards, int num_cards, int k,
+                        std::vector<uint64_t>& outcomes) {
+    outcomes.clear();
+    if (k <= 0) return;
+    utils::CombinationIndices<core::kNumCardsInDeck> combo(num_cards, k);
+    if (!combo.Valid()) return;
+    do {
+        uint64_t mask = 0;
+        for (int i = 0; i < k; ++i) mask |= 1ULL << cards[combo[i]];
+        outcomes.push_back(mask);
+    } while (combo.Next());
+}
+
+// Bits of every rank for suit 0; shift by a suit index to select that suit.
+constexpr uint64_t kSuitRankBits = 0x0001111111111111ULL;
+
+int SwapSuit(int card, int suit1, int suit2) {
+    int suit = card % core::kNumSuits;
+    if (suit == suit1) return card - suit1 + suit2;
+    if (suit == suit2) return card - suit2 + suit1;
+    return card;
+}
+
+// True if no hand plays 'action' under the hand-major 'strategy'.
+bool ActionNeverPlayed(const double* strategy, size_t num_actions, size_t action, size_t num_hands) {
+    for (size_t h = 0; h < num_hands; ++h) {
+        if (strategy[h * num_actions + action] > 0.0) return false;
+    }
+    return true;
+}
+
+// Keeps the first exception of the threads or tasks of one parallel
+// construct in 'error', to rethrow once they have joined. Call from a catch
+// block.
+void CaptureFirstError(std::exception_ptr& error) {
+    #pragma omp critical(poker_solver_first_error)
+    {
+        if (!error) error = std::current_exception();
+    }
+}
+
+// Parallel cutoff tuning: fan-outs are timed over this many iterations and
+// must then do this many times the work of an empty region's fork and join.
+constexpr int kParallelTuningIterations = 2;
+constexpr double kParallelOverheadRatio = 10.0;
+
+} // namespace
+
 // --- Constructor ---
 PCfrSolver::PCfrSolver(std::shared_ptr<tree::GameTree> game_tree, // Use tree::GameTree
                        std::shared_ptr<ranges::PrivateCardsManager> pcm,
@@ -45,7 +117,8 @@ PCfrSolver::PCfrSolver(std::shared_ptr<tree::GameTree> game_tree, // Use tree::G
       rrm_(std::move(rrm)),
       deck_(rule.GetDeck()),
       config_(std::move(solver_config)),
-      initial_board_mask_(core::Card::CardIntsToUint64(rule.GetInitialBoardCardsInt()))
+      initial_board_mask_(core::Card::CardIntsToUint64(rule.GetInitialBoardCardsInt())),
+      showdown_backend_(std::make_shared<CpuShowdownBackend>())
 {
     const auto& board_ints_from_rule = rule.GetInitialBoardCardsInt();
     std::cout << "[DEBUG_SOLVER_CONSTRUCTOR] Board ints from Rule object: ";
@@ -72,14 +145,116 @@ PCfrSolver::PCfrSolver(std::shared_ptr<tree::GameTree> game_tree, // Use tree::G
     if (!rrm_) {
         throw std::invalid_argument("PCfrSolver: RiverRangeManager cannot be null.");
     }
+    if (config_.sampled_chance_outcomes < 0) {
+        throw std::invalid_argument("PCfrSolver: sampled_chance_outcomes cannot be negative.");
+    }
+    if (config_.sampled_chance_outcomes > 0 && config_.use_isomorphism) {
+        throw std::invalid_argument("PCfrSolver: chance sampling does not support use_isomorphism.");
+    }
+    if (config_.sparse_trainable_warmup < 0) {
+        throw std::invalid_argument("PCfrSolver: sparse_trainable_warmup cannot be negative.");
+    }
+    if (config_.sparse_trainable_warmup > 0 &&
+        (config_.precision != nodes::ActionNode::TrainablePrecision::kFloat || config_.trainer == Trainer::kCfrPlus ||
+         !config_.trainable_file_directory.empty())) {
+        throw std::invalid_argument(
+            "PCfrSolver: sparse trainables need double-precision Discounted/Linear CFR tables in memory.");
+    }
+    if (config_.abstraction_buckets < 0) {
+        throw std::invalid_argument("PCfrSolver: abstraction_buckets cannot be negative.");
+    }
+    if (config_.abstraction_buckets > 0) {
+        if (config_.precision != nodes::ActionNode::TrainablePrecision::kFloat ||
+            config_.trainer == Trainer::kCfrPlus || !config_.trainable_file_directory.empty() ||
+            config_.sparse_trainable_warmup > 0) {
+            throw std::invalid_argument(
+                "PCfrSolver: hand abstraction needs double-precision Discounted/Linear CFR tables in memory "
+                "and no sparse trainables.");
+        }
+        const int board_cards = core::CountCards(initial_board_mask_);
+        if (board_cards != 3 && board_cards != 4) {
+            throw std::invalid_argument("PCfrSolver: hand abstraction needs a flop or turn initial board.");
+        }
+        hand_abstraction_ = std::make_unique<HandAbstraction>(rrm_, deck_.GetCardsMask(),
+                                                              static_cast<size_t>(config_.abstraction_buckets));
+    }
+    if (config_.average_warmup_iterations < 0 || config_.average_interval < 1) {
+        throw std::invalid_argument(
+            "PCfrSolver: average_warmup_iterations cannot be negative and average_interval must be positive.");
+    }
+    if (config_.parallel_cutoff < 0.0) {
+        throw std::invalid_argument("PCfrSolver: parallel_cutoff cannot be negative.");
+    }
+    if (config_.snapshot_interval < 0) {
+        throw std::invalid_argument("PCfrSolver: snapshot_interval cannot be negative.");
+    }
+    if (config_.checkpoint_interval < 0) {
+        throw std::invalid_argument("PCfrSolver: checkpoint_interval cannot be negative.");
+    }
+    if (config_.checkpoint_interval > 0 && config_.checkpoint_path.empty()) {
+        throw std::invalid_argument("PCfrSolver: checkpoint_interval needs a checkpoint_path.");
+    }
+    leaf_estimator_ = std::make_shared<CheckDownLeafEstimator>(rrm_);
+    if (kTraversalStatsEnabled) traversal_stats_collector_ = std::make_unique<TraversalStatsCollector>();
+
+     // Positions of the cards that can still be dealt (see NextDealIndex):
+     // the deck's cards (36 for a short deck) off the initial board.
+     deal_card_position_.fill(-1);
+     const uint64_t deck_mask = deck_.GetCardsMask();
+     for (int card = 0; card < core::kNumCardsInDeck; ++card) {
+         if (((deck_mask >> card) & 1ULL) &&
+             !core::Card::DoBoardsOverlap(1ULL << card, initial_board_mask_)) {
+             deal_card_position_[card] = static_cast<int>(deal_cards_.size());
+             deal_cards_.push_back(card);
+         }
+     }
+
+     // Suit pairs the initial board and both ranges are symmetric under.
+     if (config_.use_isomorphism) {
+         for (size_t p = 0; p < num_players_; ++p) {
+             suit_swap_hands_[p].assign(core::kNumSuits * core::kNumSuits, {});
+         }
+         for (int s1 = 0; s1 < core::kNumSuits; ++s1) {
+             for (int s2 = s1 + 1; s2 < core::kNumSuits; ++s2) {
+                 bool symmetric = ((initial_board_mask_ >> s1) & kSuitRankBits) ==
+                                  ((initial_board_mask_ >> s2) & kSuitRankBits);
+                 for (size_t p = 0; p < num_players_ && symmetric; ++p) {
+                     std::vector<int> permutation =
+                         utils::ColorIsomorphismPermutation(pcm_->GetPlayerRange(p), s1, s2);
+                     symmetric = std::find(permutation.begin(), permutation.end(), -1) == permutation.end();
+                     suit_swap_hands_[p][s1 * core::kNumSuits + s2] = permutation;
+                     suit_swap_hands_[p][s2 * core::kNumSuits + s1] = std::move(permutation);
+                 }
+                 isomorphic_suits_[s1][s2] = isomorphic_suits_[s2][s1] = symmetric;
+             }
+         }
+     }
+
+     if (config_.numa_aware) {
+         numa_ = config_.numa_topology.empty() ? NumaTopology::Detect() : config_.numa_topology;
+         if (numa_.NumNodes() > 1) {
+             numa_next_outcome_.reset(new std::atomic<size_t>[numa_.NumNodes()]);
+             std::cout << "[INFO] NUMA mode: " << numa_.NumNodes() << " nodes." << std::endl;
+         } else {
+             numa_ = NumaTopology();
+             std::cout << "[INFO] NUMA mode: a single node, threads are not pinned." << std::endl;
+         }
+     }
 
-     std::vector<std::shared_ptr<core::GameTreeNode>> node_stack;
+     // Each entry carries the number of distinct deals that can precede the node.
+     std::vector<std::pair<std::shared_ptr<core::GameTreeNode>, size_t>> node_stack;
      if (game_tree_->GetRoot()) { // Use game_tree_ member
-        node_stack.push_back(game_tree_->GetRoot());
+        node_stack.emplace_back(game_tree_->GetRoot(), 1);
      }
      int associated_nodes = 0;
+     // Sparse trainables free the dense tables they replace, which an
+     // arena cannot give back.
+     bool use_arena = config_.precision == nodes::ActionNode::TrainablePrecision::kFloat &&
+                      config_.trainer != Trainer::kCfrPlus && config_.sparse_trainable_warmup == 0;
+     std::array<size_t, 4> arena_doubles = {0, 0, 0, 0}; // By street
      while (!node_stack.empty()) {
-         std::shared_ptr<core::GameTreeNode> current = node_stack.back();
+         std::shared_ptr<core::GameTreeNode> current = node_stack.back().first;
+         size_t num_deals = node_stack.back().second;
          node_stack.pop_back();
 
          if (!current) continue;
@@ -87,25 +262,123 @@ PCfrSolver::PCfrSolver(std::shared_ptr<tree::GameTree> game_tree, // Use tree::G
          if (auto action_node = std::dynamic_pointer_cast<nodes::ActionNode>(current)) {
              size_t player_idx = action_node->GetPlayerIndex();
              action_node->SetPlayerRange(&(pcm_->GetPlayerRange(player_idx))); // Use pcm_ member
+             action_node->SetNumPossibleDeals(num_deals);
              associated_nodes++;
+             // One trainable block per deal slot, plus the arena's cache-line
+             // rounding.
+             size_t table_size = action_node->GetActions().size() * pcm_->GetPlayerRange(player_idx).size();
+             // Bucketed flop and turn trainables are not arena blocks.
+             if (hand_abstraction_ && action_node->GetRound() != core::GameRound::kRiver) table_size = 0;
+             if (table_size > 0) {
+                 arena_doubles[core::GameTreeNode::GameRoundToInt(action_node->GetRound())] += num_deals *
+                     (DiscountedCfrTrainable::BlockDoubles(table_size, config_.lazy_strategies) + 7);
+             }
              for(const auto& child : action_node->GetChildren()) {
-                 if (child) node_stack.push_back(child);
+                 if (child) node_stack.emplace_back(child, num_deals);
              }
          } else if (auto chance_node = std::dynamic_pointer_cast<nodes::ChanceNode>(current)) {
              auto chance_child = chance_node->GetChild();
              if (chance_child) {
-                 node_stack.push_back(chance_child);
+                 bool single_card = chance_node->GetRound() != core::GameRound::kFlop;
+                 node_stack.emplace_back(chance_child, single_card ? num_deals * deal_cards_.size() : num_deals);
              }
          }
      }
      std::cout << "[INFO] Pre-associated player ranges with " << associated_nodes << " action nodes." << std::endl;
+     if (use_arena) {
+         const size_t lanes = std::max<size_t>(numa_.NumNodes(), 1);
+         const int first_file_round = config_.trainable_file_directory.empty()
+                                          ? static_cast<int>(arena_doubles.size())
+                                          : core::GameTreeNode::GameRoundToInt(config_.trainable_file_round);
+         size_t resident_doubles = 0;
+         for (int r = 0; r < first_file_round && r < static_cast<int>(arena_doubles.size()); ++r) {
+             resident_doubles += arena_doubles[r];
+         }
+         std::shared_ptr<TrainableArena> resident;
+         if (resident_doubles > 0) {
+             resident = std::make_shared<TrainableArena>(resident_doubles, config_.huge_pages, lanes);
+         }
+         for (int r = 0; r < static_cast<int>(arena_doubles.size()); ++r) {
+             if (r < first_file_round) {
+                 trainable_arenas_[r] = resident;
+             } else if (arena_doubles[r] > 0) {
+                 TrainableArena::FileBacking file;
+                 file.directory = config_.trainable_file_directory;
+                 file.sequential_access = r == core::GameTreeNode::GameRoundToInt(core::GameRound::kRiver);
+                 trainable_arenas_[r] = std::make_shared<TrainableArena>(arena_doubles[r], file, lanes);
+             }
+         }
+         if (first_file_round < static_cast<int>(arena_doubles.size())) {
+             size_t file_doubles = 0;
+             for (size_t r = first_file_round; r < arena_doubles.size(); ++r) file_doubles += arena_doubles[r];
+             std::cout << "[INFO] Out-of-core trainables: up to " << file_doubles * sizeof(double) / (1024 * 1024)
+                       << " MiB from the " << core::GameTreeNode::GameRoundToString(config_.trainable_file_round)
+                       << " on in files under '" << config_.trainable_file_directory << "'." << std::endl;
+         }
+     }
+
+     IndexTree();
+}
+
+void PCfrSolver::IndexTree() {
+    flat_tree_ = std::make_unique<tree::FlatGameTree>(*game_tree_);
+    // Leaf paths for the estimator, in strategy file form. Children come
+    // after their parent, so one pass in index order sees every parent first.
+    leaf_paths_.clear();
+    for (uint32_t i = 0; i < flat_tree_->Size(); ++i) {
+        const tree::FlatNode& node = flat_tree_->Node(i);
+        if (node.type == core::GameTreeNodeType::kChance && node.num_children == 0) {
+            leaf_paths_.resize(flat_tree_->Size());
+            break;
+        }
+    }
+    if (!leaf_paths_.empty()) {
+        std::vector<std::string> paths(flat_tree_->Size());
+        for (uint32_t i = 0; i < flat_tree_->Size(); ++i) {
+            const tree::FlatNode& node = flat_tree_->Node(i);
+            if (node.type == core::GameTreeNodeType::kChance) {
+                if (node.num_children == 0) leaf_paths_[i] = paths[i];
+                else paths[node.first_child] = paths[i];
+            } else if (node.type == core::GameTreeNodeType::kAction) {
+                const auto& actions = flat_tree_->Action(node).GetActions();
+                for (uint32_t a = 0; a < node.num_children; ++a) {
+                    paths[node.first_child + a] = paths[i].empty() ? actions[a].ToString()
+                                                                   : paths[i] + "/" + actions[a].ToString();
+                }
+            }
+            std::string().swap(paths[i]);
+        }
+    }
+
+    // Node visits per traversal below each node, used by the task and
+    // parallel cutoffs. Children come after their parent, so a backward
+    // pass sees them first.
+    subtree_work_.assign(flat_tree_->Size(), 0.0);
+    for (size_t i = flat_tree_->Size(); i-- > 0;) {
+        const tree::FlatNode& node = flat_tree_->Node(static_cast<uint32_t>(i));
+        double work = 1.0;
+        for (uint32_t c = 0; c < node.num_children; ++c) {
+            double child_work = subtree_work_[node.first_child + c];
+            work += node.type == core::GameTreeNodeType::kChance
+                        ? static_cast<double>(deal_cards_.size()) * child_work : child_work;
+        }
+        subtree_work_[i] = work;
+    }
+
+    BuildChanceDealTable();
 }
 
 // --- Solver Interface Implementation ---
 
+PCfrSolver::~PCfrSolver() {
+    if (checkpoint_writer_.joinable()) checkpoint_writer_.join();
+}
+
 void PCfrSolver::Train() {
-    stop_signal_ = false;
+    // stop_signal_ is not reset here: a Stop() that lands before training
+    // starts must still stop it. It is cleared on the way out instead.
     evs_calculated_ = false;
+    ClearHandGrids();
 
     // --- Set OpenMP Threads ---
     if (config_.num_threads > 0) {
@@ -119,48 +392,149 @@ void PCfrSolver::Train() {
     std::cout << "[INFO] Starting PCFR training for " << config_.iteration_limit << " iterations..." << std::endl;
     std::cout << "[INFO] Initial Board Mask: 0x" << std::hex << initial_board_mask_ << std::dec << std::endl;
     std::cout << "[INFO] Threads: " << config_.num_threads << std::endl;
-
-    std::vector<std::vector<double>> initial_reach_probs(num_players_);
-    bool possible_to_train = true;
-    for (size_t p = 0; p < num_players_; ++p) {
-        const auto& reach_doubles = pcm_->GetInitialReachProbs(p);
-        initial_reach_probs[p] = reach_doubles;
-        if (pcm_->GetPlayerRange(p).empty() || initial_reach_probs[p].empty() ||
-            std::accumulate(initial_reach_probs[p].begin(), initial_reach_probs[p].end(), 0.0) < 1e-12) {
-             std::cerr << "[ERROR] Player " << p << " has an empty initial range or zero total reach probability. Cannot train." << std::endl;
-             possible_to_train = false;
-        }
+    std::cout << "[INFO] Build: " << BuildSummary() << std::endl;
+    if (!leaf_paths_.empty()) {
+        std::cout << "[INFO] Depth-limited tree: leaves valued by the " << leaf_estimator_->Name()
+                  << " estimator." << std::endl;
     }
 
+    bool possible_to_train = InitializeRootReach();
+
     if (!possible_to_train) {
         std::cerr << "[ERROR] Training aborted due to empty range or zero reach probability for a player." << std::endl;
+        stop_signal_ = false;
         return;
     }
 
+    if (config_.warmup_river_cache && !river_cache_warmed_) {
+        WarmupRiverCache();
+    }
+
+    const ReachPointers initial_reach_probs = {root_reach_[0].data(), root_reach_[1].data()};
+    ReachSums initial_reach_sums = {kernels::Sum(root_reach_[0].data(), num_hands_[0]),
+                                    kernels::Sum(root_reach_[1].data(), num_hands_[1])};
+    if (resolve_gadget_) PrepareResolveGadget();
+    std::array<std::vector<double>, 2> root_utility = {std::vector<double>(num_hands_[0]),
+                                                       std::vector<double>(num_hands_[1])};
+
+    const DcfrParameters discount_parameters = DiscountParameters();
+    if (config_.parallel_cutoff > 0.0) {
+        parallel_cutoff_ = config_.parallel_cutoff;
+    } else if (!parallel_cutoff_tuned_ && parallel_tuning_iterations_left_ == 0 &&
+               config_.parallel_level == ParallelLevel::kOutermostChance && omp_get_max_threads() > 1 &&
+               config_.iteration_limit > completed_iterations_) {
+        StartParallelCutoffTuning();
+    }
     uint64_t start_time = utils::TimeSinceEpochMillisec();
-    int completed_iterations = 0; // Variable to track iterations run
 
     if (config_.iteration_limit <= 0) {
         std::cout << "[INFO] Iteration limit is " << config_.iteration_limit << ". No training will occur." << std::endl;
     } else {
-        for (int i = 1; i <= config_.iteration_limit; ++i) {
-            completed_iterations = i; // Update completed iterations
-            if (stop_signal_) {
+        if (completed_iterations_ > 0) {
+            std::cout << "[INFO] Resuming after " << completed_iterations_ << " completed iterations." << std::endl;
+        }
+        // Iterations restored from a checkpoint are not repeated.
+        for (int i = completed_iterations_ + 1; i <= config_.iteration_limit; ++i) {
+            TraceSpan iteration_span(trace_recorder_.get(), "iteration", "solver", i);
+            bool stop = stop_signal_;
+            if (transport_ && transport_->Size() > 1) {
+                // A stop on any rank stops the whole group at the same iteration.
+                double stops = stop ? 1.0 : 0.0;
+                transport_->AllReduceSum(&stops, 1);
+                stop = stops > 0.0;
+            }
+            if (stop) {
                 std::cout << "[INFO] Training stopped prematurely during iteration " << i << "." << std::endl;
-                // If stopped, completed_iterations will hold the iteration number it was stopped *during*.
-                // If you want strictly completed iterations, you might use `completed_iterations = i - 1;` here
-                // before breaking, but `i` is usually what's reported.
                 break;
             }
 
-            for (int traverser = 0; traverser < static_cast<int>(num_players_); ++traverser) {
+            // Alternating: one traversal per player, the second already seeing
+            // the first player's update. Simultaneous: one traversal for both.
+            bool simultaneous = config_.update_scheme == UpdateScheme::kSimultaneous;
+            pruning_this_iteration_ = config_.regret_pruning && !simultaneous &&
+                                      i > config_.pruning_warmup_iterations &&
+                                      (config_.pruning_full_pass_interval <= 0 ||
+                                       i % config_.pruning_full_pass_interval != 0);
+            sparsify_this_iteration_ = config_.sparse_trainable_warmup > 0 && !sparse_pass_done_ &&
+                                       i > config_.sparse_trainable_warmup;
+            const IterationDiscounts discounts = DiscountsFor(i, discount_parameters);
+            for (int traverser = 0; traverser < (simultaneous ? 1 : static_cast<int>(num_players_)); ++traverser) {
+                 UtilityPointers utility = {root_utility[0].data(), root_utility[1].data()};
+                 if (!simultaneous) utility[1 - traverser] = nullptr;
+                 // Also after ComputeExploitability, which resets the root reach.
+                 if (resolve_gadget_) ApplyResolveGadget(initial_reach_sums);
+                 sampling_round_ = 2 * static_cast<uint64_t>(i) + static_cast<uint64_t>(traverser);
                  try {
-                     cfr_utility(game_tree_->GetRoot(), initial_reach_probs, traverser, i, this->initial_board_mask_, 1.0);
+                     RunTraversal(0, initial_reach_probs, initial_reach_sums, utility, discounts,
+                                  this->initial_board_mask_, 1.0, 0);
                  } catch (const std::exception& e) {
                      std::cerr << "[FATAL ERROR] Exception during CFR iteration " << i
                                << " for traverser " << traverser << ": " << e.what() << std::endl;
                      throw; // Re-throw to stop execution
                  }
+                 if (resolve_gadget_ && utility[resolve_gadget_->player]) {
+                     UpdateResolveGadget(utility[resolve_gadget_->player]);
+                 }
+            }
+            completed_iterations_ = i;
+            if (parallel_tuning_iterations_left_ > 0 && --parallel_tuning_iterations_left_ == 0) {
+                FinishParallelCutoffTuning();
+            }
+            if (sparsify_this_iteration_) {
+                sparsify_this_iteration_ = false;
+                sparse_pass_done_ = true;
+                std::cout << "[INFO] Iteration " << i << ": " << sparse_trainables_created_.load()
+                          << " trainables switched to sparse tables." << std::endl;
+            }
+            if (traversal_stats_collector_) {
+                last_iteration_traversal_stats_ = traversal_stats_collector_->Collect();
+                last_iteration_traversal_stats_.iterations = 1;
+                traversal_stats_ += last_iteration_traversal_stats_;
+            }
+
+            SolverProgress progress;
+            progress.iteration = i;
+            bool target_reached = false;
+            if (config_.exploitability_interval > 0 &&
+                (i % config_.exploitability_interval == 0 || i == config_.iteration_limit)) {
+                const uint64_t check_start = utils::TimeSinceEpochMillisec();
+                double exploitability = ComputeExploitability();
+                progress.exploitability_seconds =
+                    static_cast<double>(utils::TimeSinceEpochMillisec() - check_start) / 1000.0;
+                std::cout << "[INFO] Iteration " << i << ": exploitability " << exploitability
+                          << "% of pot (player 0 best response " << best_response_values_[0]
+                          << ", player 1 " << best_response_values_[1] << ")" << std::endl;
+                progress.exploitability = exploitability;
+                target_reached = config_.target_exploitability > 0.0 &&
+                                 exploitability <= config_.target_exploitability;
+            }
+            if (progress_queue_) {
+                progress.elapsed_seconds =
+                    static_cast<double>(utils::TimeSinceEpochMillisec() - start_time) / 1000.0;
+                progress.resident_bytes = CurrentResidentBytes();
+                progress_queue_->Push(progress);
+            }
+            if (config_.memory_log_interval > 0 &&
+                (i % config_.memory_log_interval == 0 || i == config_.iteration_limit || target_reached)) {
+                const MemoryStats memory = GetMemoryStats();
+                auto mib = [](uint64_t bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); };
+                std::cout << "[INFO] Iteration " << i << " memory: trainables " << mib(memory.trainable_bytes)
+                          << " MiB (" << memory.trainable_count << "), river cache "
+                          << mib(memory.river_cache_bytes) << " MiB, tree " << mib(memory.tree_bytes)
+                          << " MiB, resident " << mib(memory.resident_bytes) << " MiB" << std::endl;
+            }
+            if (config_.checkpoint_interval > 0 &&
+                (i % config_.checkpoint_interval == 0 || i == config_.iteration_limit || target_reached)) {
+                StartBackgroundCheckpoint();
+            }
+            if (config_.snapshot_interval > 0 &&
+                (i % config_.snapshot_interval == 0 || i == config_.iteration_limit || target_reached)) {
+                PublishStrategySnapshot();
+            }
+            if (target_reached) {
+                std::cout << "[INFO] Target exploitability " << config_.target_exploitability
+                          << "% reached after " << i << " iterations." << std::endl;
+                break;
             }
 
             if (i % 100 == 0 || i == config_.iteration_limit) {
@@ -173,577 +547,2665 @@ void PCfrSolver::Train() {
     }
 
 
+     stop_signal_ = false;
+     FinishBackgroundCheckpoint();
+
      uint64_t end_time = utils::TimeSinceEpochMillisec();
      double total_sec = static_cast<double>(end_time - start_time) / 1000.0;
 
-     // Use completed_iterations for the log message
+     // Use completed_iterations_ for the log message
      //std::cout << "[INFO] Training finished after "
-       //        << completed_iterations // Use the tracked variable
+       //        << completed_iterations_ // Use the tracked variable
          //      << " iterations. Total time: " << std::fixed << std::setprecision(2) << total_sec << "s." << std::endl;
 }
 
-void PCfrSolver::Stop() {
-    stop_signal_ = true;
-}
-
-json PCfrSolver::DumpStrategy(bool dump_evs, int max_depth) const {
-    json result;
-    if (!game_tree_ || !game_tree_->GetRoot()) {
-        result["error"] = "Game tree is empty or not initialized.";
-        return result;
+bool PCfrSolver::InitializeRootReach() {
+    bool valid = true;
+    for (size_t p = 0; p < num_players_; ++p) {
+        root_reach_[p] = pcm_->GetInitialReachProbs(p);
+        num_hands_[p] = pcm_->GetPlayerRange(p).size();
+        if (num_hands_[p] == 0 || root_reach_[p].size() != num_hands_[p] ||
+            std::accumulate(root_reach_[p].begin(), root_reach_[p].end(), 0.0) < 1e-12) {
+             std::cerr << "[ERROR] Player " << p << " has an empty initial range or zero total reach probability. Cannot train." << std::endl;
+             valid = false;
+        }
     }
-    std::cout << "[INFO] Dumping strategy... (EVs: " << dump_evs << ", MaxDepth: " << max_depth << ")" << std::endl;
-    result = dump_strategy_recursive(game_tree_->GetRoot(), dump_evs, 0, max_depth);
-    // Ensure metadata is added to the result from dump_strategy_recursive, not overwriting it
-    if (result.is_null()) result = json::object(); // Ensure result is an object if tree was empty/pruned
-    result["metadata"]["dump_evs"] = dump_evs;
-    result["metadata"]["max_depth"] = max_depth == -1 ? "unlimited" : std::to_string(max_depth);
-    return result;
+    return valid;
 }
 
-// --- Private Recursive CFR Function ---
-std::vector<double> PCfrSolver::cfr_utility(
-    std::shared_ptr<core::GameTreeNode> node,
-    const std::vector<std::vector<double>>& reach_probs,
-    int traverser,
-    int iteration,
-    uint64_t current_board_mask,
-    double chance_reach)
-{
-    if (!node) {
-        throw std::logic_error("cfr_utility called with null node.");
-    }
-
-    // --- DEBUG PRINT ---
-    //std::cout << "[DEBUG CFRUtil] Iter: " << iteration << ", Trav: " << traverser
-      //        << ", NodeDepth: " << node->GetDepth() // Assuming depth is set
-        //      << ", NodeType: ";
-    switch(node->GetNodeType()) {
-        case core::GameTreeNodeType::kAction: /*std::cout << "Action (P" << std::dynamic_pointer_cast<nodes::ActionNode>(node)->GetPlayerIndex() << ")";*/ break;
-        case core::GameTreeNodeType::kChance: /*std::cout << "Chance";*/ break;
-        case core::GameTreeNodeType::kShowdown: /*std::cout << "Showdown";*/ break;
-        case core::GameTreeNodeType::kTerminal: /*std::cout << "Terminal";*/ break;
-        default: std::cout << "Unknown";
-    }
-    //std::cout << ", Round: " << core::GameTreeNode::GameRoundToString(node->GetRound())
-      //        << ", Board: 0x" << std::hex << current_board_mask << std::dec
-        //      << " (Cards: " << core::Card::Uint64ToCards(current_board_mask).size() << ")"
-          //    << ", ChanceReach: " << chance_reach
-            //  << std::endl;
-
-    bool is_terminal = false;
-    core::GameTreeNodeType node_type = node->GetNodeType();
-    if (node_type == core::GameTreeNodeType::kTerminal ||
-        node_type == core::GameTreeNodeType::kShowdown) {
-        is_terminal = true;
+DcfrParameters PCfrSolver::DiscountParameters() const {
+    DcfrParameters parameters = config_.dcfr;
+    if (config_.trainer != Trainer::kDiscounted) {
+        // Linear CFR weights regrets and strategies by t; CFR+ only reads the
+        // strategy weight, which is t as well.
+        parameters.alpha = 1.0;
+        parameters.beta = 1.0;
+        parameters.gamma = 1.0;
     }
+    return parameters;
+}
 
-    if (traverser < 0 || traverser >= static_cast<int>(reach_probs.size())) {
-         throw std::out_of_range("Invalid traverser index in cfr_utility.");
+IterationDiscounts PCfrSolver::DiscountsFor(int iteration, const DcfrParameters& parameters) const {
+    IterationDiscounts discounts = IterationDiscounts::For(iteration, parameters);
+    const int warmup = config_.average_warmup_iterations;
+    const int interval = config_.average_interval;
+    if (warmup == 0 && interval == 1) return discounts;
+    // Exploitability checks accumulate too, so the average they measure, and
+    // the one a target_exploitability stop keeps, covers every iteration.
+    const auto accumulates = [&](int t) {
+        return t > warmup && ((t - warmup) % interval == 0 || t == config_.iteration_limit ||
+                              (config_.exploitability_interval > 0 && t % config_.exploitability_interval == 0));
+    };
+    if (!accumulates(iteration)) {
+        discounts.strategy_weight = 0.0;
+        return discounts;
     }
-    if (!is_terminal && std::accumulate(reach_probs[traverser].begin(), reach_probs[traverser].end(), 0.0) < 1e-12) {
-         return std::vector<double>(pcm_->GetPlayerRange(traverser).size(), 0.0);
+    // Stands in for the iterations since the previous accumulation.
+    int previous = iteration - 1;
+    while (previous > warmup && !accumulates(previous)) --previous;
+    for (int skipped = previous + 1; skipped < iteration; ++skipped) {
+        discounts.strategy_weight += std::pow(static_cast<double>(skipped), parameters.gamma);
     }
+    return discounts;
+}
 
-    switch (node_type) {
-        case core::GameTreeNodeType::kTerminal:
-            return cfr_terminal_node(std::dynamic_pointer_cast<nodes::TerminalNode>(node), reach_probs, traverser, chance_reach);
-        case core::GameTreeNodeType::kShowdown:
-            return cfr_showdown_node(std::dynamic_pointer_cast<nodes::ShowdownNode>(node), reach_probs, traverser, current_board_mask, chance_reach);
-        case core::GameTreeNodeType::kChance:
-            return cfr_chance_node(std::dynamic_pointer_cast<nodes::ChanceNode>(node), reach_probs, traverser, iteration, current_board_mask, chance_reach);
-        case core::GameTreeNodeType::kAction:
-            return cfr_action_node(std::dynamic_pointer_cast<nodes::ActionNode>(node), reach_probs, traverser, iteration, current_board_mask, chance_reach);
-        default:
-            throw std::logic_error("cfr_utility encountered unknown node type.");
+std::shared_ptr<Trainable> PCfrSolver::TrainableFor(nodes::ActionNode& node, size_t deal_index) const {
+    if (hand_abstraction_ && node.GetRound() != core::GameRound::kRiver && !node.IsLocked()) {
+        if (auto existing = node.GetTrainableIfExists(deal_index)) return existing;
+        return CreateBucketedTrainable(node, deal_index);
     }
+    return node.GetTrainable(deal_index, config_.precision,
+                             config_.trainer == Trainer::kCfrPlus
+                                 ? nodes::ActionNode::TrainableAlgorithm::kCfrPlus
+                                 : nodes::ActionNode::TrainableAlgorithm::kDiscounted,
+                             trainable_arenas_[core::GameTreeNode::GameRoundToInt(node.GetRound())],
+                             config_.lazy_strategies,
+                             config_.average_warmup_iterations > 0 || config_.average_interval > 1);
 }
 
-
-// --- Action Node Helper ---
-std::vector<double> PCfrSolver::cfr_action_node(
-    std::shared_ptr<nodes::ActionNode> node,
-    const std::vector<std::vector<double>>& reach_probs,
-    int traverser,
-    int iteration,
-    uint64_t current_board_mask,
-    double chance_reach)
-{
-    size_t acting_player = node->GetPlayerIndex();
-    size_t opponent_player = 1 - acting_player;
-    const auto& actions = node->GetActions();
-    const auto& children = node->GetChildren();
-    size_t num_actions = actions.size();
-
-    size_t traverser_num_hands = pcm_->GetPlayerRange(traverser).size();
-    std::vector<double> node_utility(traverser_num_hands, 0.0);
-
-    const auto* player_range_ptr = node->GetPlayerRangeRaw();
-    if (!player_range_ptr) throw std::runtime_error("Player range not set on ActionNode.");
-    size_t acting_player_num_hands = player_range_ptr->size();
-
-    if (num_actions == 0 || acting_player_num_hands == 0) {
-        return node_utility;
+std::shared_ptr<Trainable> PCfrSolver::CreateBucketedTrainable(nodes::ActionNode& node, size_t deal_index) const {
+    // The deal slot encodes the cards dealt since the initial board, one
+    // per street (see NextDealIndex).
+    const int deal_layers = core::GameTreeNode::GameRoundToInt(node.GetRound()) -
+                            (core::CountCards(initial_board_mask_) - 2);
+    uint64_t board_mask = initial_board_mask_;
+    size_t remaining_index = deal_index;
+    for (int layer = 0; layer < deal_layers; ++layer) {
+        board_mask |= 1ULL << deal_cards_[remaining_index % deal_cards_.size()];
+        remaining_index /= deal_cards_.size();
     }
+    const size_t player = node.GetPlayerIndex();
+    auto buckets = hand_abstraction_->BucketsFor(player, pcm_->GetPlayerRange(player),
+                                                 pcm_->GetPlayerRange(1 - player), board_mask);
+    auto trainable = std::make_shared<BucketedDiscountedCfrTrainable>(node.GetPlayerRangeRaw(), node,
+                                                                      std::move(buckets));
+    node.ReplaceTrainable(deal_index, trainable);
+    return trainable;
+}
 
-    auto trainable = node->GetTrainable(0);
-    if (!trainable) throw std::runtime_error("Failed to get Trainable object.");
+std::shared_ptr<Trainable> PCfrSolver::SparsifyTrainable(nodes::ActionNode& node, size_t deal_index,
+                                                         const Trainable& trainable, const double* reach_weights) {
+    if (!dynamic_cast<const DiscountedCfrTrainable*>(&trainable)) return nullptr;
+    const std::vector<core::PrivateCards>* range = node.GetPlayerRangeRaw();
+    const size_t num_actions = node.GetActions().size();
+    const size_t num_hands = range->size();
+    std::vector<double> regrets(num_actions);
+    std::vector<double> strategy_sums(num_actions);
+    std::vector<double> reach_totals(num_hands, 0.0); // Strategy sums per hand
+    double largest_total = 0.0;
+    for (size_t h = 0; h < num_hands; ++h) {
+        trainable.GetHandState(h, regrets.data(), strategy_sums.data());
+        for (double value : strategy_sums) reach_totals[h] += value;
+        largest_total = std::max(largest_total, reach_totals[h]);
+    }
+    std::vector<uint32_t> live_hands;
+    for (size_t h = 0; h < num_hands; ++h) {
+        if (reach_weights[h] > 0.0 ||
+            (reach_totals[h] > 0.0 && reach_totals[h] >= config_.sparse_trainable_min_relative_reach * largest_total)) {
+            live_hands.push_back(static_cast<uint32_t>(h));
+        }
+    }
+    if (static_cast<double>(live_hands.size()) > config_.sparse_trainable_max_support * static_cast<double>(num_hands)) {
+        return nullptr;
+    }
+    auto sparse = std::make_shared<SparseDiscountedCfrTrainable>(range, node, live_hands, config_.lazy_strategies);
+    for (uint32_t h : live_hands) {
+        trainable.GetHandState(h, regrets.data(), strategy_sums.data());
+        sparse->SetHandState(h, regrets.data(), strategy_sums.data());
+    }
+    node.ReplaceTrainable(deal_index, sparse);
+    ++sparse_trainables_created_;
+    return sparse;
+}
 
-    std::vector<double> current_strategy_local;
-    const std::vector<double>& trainable_strategy = trainable->GetCurrentStrategy();
+void PCfrSolver::WarmupRiverCache() {
+    river_cache_warmed_ = true;
+    if (rrm_->GetMemoryBudget() > 0) {
+        std::cout << "[INFO] River cache warmup skipped: the cache has a memory budget." << std::endl;
+        return;
+    }
+    // Every showdown sits on a complete board, and chance nodes deal every
+    // deck card off the board, so one showdown anywhere makes every
+    // completion of the initial board reachable.
+    if (flat_tree_->Count(core::GameTreeNodeType::kShowdown) == 0) return;
 
-    if (trainable_strategy.size() == (num_actions * acting_player_num_hands)) {
-        current_strategy_local = trainable_strategy;
+    TraceSpan span(trace_recorder_.get(), "river cache", "solver");
+    uint64_t start_time = utils::TimeSinceEpochMillisec();
+    if (numa_.empty()) {
+        rrm_->PreloadRiverBoards(pcm_->GetPlayerRange(0), pcm_->GetPlayerRange(1),
+                                 initial_board_mask_, deck_.GetCardsMask());
     } else {
-        //std::cerr << "[ERROR] Strategy size mismatch (" << trainable_strategy.size()
-          //        << ") from GetCurrentStrategy() in ActionNode (expected "
-            //      << (num_actions * acting_player_num_hands) << "). Using uniform." << std::endl;
-        double uniform_prob = (num_actions > 0) ? 1.0 / static_cast<double>(num_actions) : 0.0;
-        current_strategy_local.assign(num_actions * acting_player_num_hands, uniform_prob);
+        ranges::RiverPreloadPlacement placement;
+        placement.num_homes = numa_.NumNodes();
+        placement.home_of_board = [this](uint64_t board_mask) { return NumaNodeOfBoard(board_mask); };
+        placement.enter_thread = [this](int thread, int num_threads) { return EnterNumaNode(thread, num_threads); };
+        ScopedThreadAffinity caller_affinity;
+        rrm_->PreloadRiverBoards(pcm_->GetPlayerRange(0), pcm_->GetPlayerRange(1),
+                                 initial_board_mask_, deck_.GetCardsMask(), &placement);
+        TrainableArena::SetThreadLane(0);
     }
+    std::cout << "[INFO] River cache warmup: " << rrm_->GetNumPreloadedBoards() << " boards in "
+              << (utils::TimeSinceEpochMillisec() - start_time) << " ms." << std::endl;
+}
 
-    std::vector<std::vector<double>> child_utilities(num_actions, std::vector<double>(traverser_num_hands, 0.0));
-    for (size_t a = 0; a < num_actions; ++a) {
-        std::vector<std::vector<double>> next_reach_probs = reach_probs;
-        for (size_t h = 0; h < acting_player_num_hands; ++h) {
-            size_t strat_idx = h * num_actions + a; // Corrected to Hand-Major for current_strategy_local access
-             if (acting_player < next_reach_probs.size() && h < next_reach_probs[acting_player].size() && strat_idx < current_strategy_local.size()){
-                next_reach_probs[acting_player][h] *= current_strategy_local[strat_idx];
-            } else {
-                 std::cerr << "[ERROR] Index out of bounds during reach prob update in cfr_action_node. "
-                           << "acting_player=" << acting_player << ", next_reach_probs.size()=" << next_reach_probs.size()
-                           << ", h=" << h 
-                           << ", strat_idx=" << strat_idx << ", current_strategy_local.size()=" << current_strategy_local.size()
-                           << std::endl;
-                 if(acting_player < next_reach_probs.size() && h < next_reach_probs[acting_player].size()) {
-                    next_reach_probs[acting_player][h] = 0.0;
-                 }
-            }
-        }
-        if (a < children.size() && children[a]) {
-            child_utilities[a] = cfr_utility(children[a], next_reach_probs, traverser, iteration, current_board_mask, chance_reach);
-        } else {
-             std::cerr << "[ERROR] Missing or null child node for action index " << a << " in cfr_action_node." << std::endl;
-             child_utilities[a].assign(traverser_num_hands, 0.0);
-        }
+double PCfrSolver::ComputeExploitability() {
+    if (flat_tree_->Empty() || !InitializeRootReach()) {
+        throw std::logic_error("ComputeExploitability: solver has no tree or no valid ranges.");
+    }
+    TraceSpan span(trace_recorder_.get(), "exploitability", "solver");
+    const ReachPointers initial_reach_probs = {root_reach_[0].data(), root_reach_[1].data()};
+    const ReachSums initial_reach_sums = {kernels::Sum(root_reach_[0].data(), num_hands_[0]),
+                                          kernels::Sum(root_reach_[1].data(), num_hands_[1])};
+
+    // Weight of all non-conflicting hand pairs; utilities are relative to it.
+    std::vector<double> compatible_reach(num_hands_[0]);
+    FoldUtilityLinear(pcm_->GetPlayerRange(0), pcm_->GetPlayerRange(1), root_reach_[1].data(), 1.0,
+                      compatible_reach.data());
+    double total_weight = 0.0;
+    for (size_t h = 0; h < num_hands_[0]; ++h) total_weight += root_reach_[0][h] * compatible_reach[h];
+    if (total_weight <= 0.0) {
+        throw std::logic_error("ComputeExploitability: ranges have no compatible hand pairs.");
     }
 
-    if (acting_player == traverser) {
-        for (size_t h = 0; h < traverser_num_hands; ++h) {
-            node_utility[h] = 0.0;
-            for (size_t a = 0; a < num_actions; ++a) {
-                size_t strat_idx = h * num_actions + a; // Corrected to Hand-Major
-                 if (strat_idx < current_strategy_local.size() && a < child_utilities.size() && h < child_utilities[a].size()) {
-                    node_utility[h] += current_strategy_local[strat_idx] * child_utilities[a][h];
-                 }
-            }
-        }
-    } else {
-        for (size_t h = 0; h < traverser_num_hands; ++h) {
-            node_utility[h] = 0.0;
-            for (size_t a = 0; a < num_actions; ++a) {
-                 if (a < child_utilities.size() && h < child_utilities[a].size()) {
-                    node_utility[h] += child_utilities[a][h];
-                 }
-            }
+    evaluating_best_response_ = true;
+    for (size_t p = 0; p < num_players_; ++p) {
+        std::vector<double> utility(num_hands_[p]);
+        UtilityPointers outputs = {nullptr, nullptr};
+        outputs[p] = utility.data();
+        try {
+            RunTraversal(0, initial_reach_probs, initial_reach_sums, outputs, IterationDiscounts(),
+                         initial_board_mask_, 1.0, 0);
+        } catch (...) {
+            evaluating_best_response_ = false;
+            throw;
         }
+        double value = 0.0;
+        for (size_t h = 0; h < num_hands_[p]; ++h) value += root_reach_[p][h] * utility[h];
+        best_response_values_[p] = value / total_weight;
     }
+    evaluating_best_response_ = false;
 
-    if (acting_player == traverser) {
-        std::vector<double> weighted_regrets(num_actions * acting_player_num_hands);
-        double opponent_reach_sum = 0.0;
-        if (opponent_player < reach_probs.size()) { // Bounds check for opponent_player
-             opponent_reach_sum = std::accumulate(reach_probs[opponent_player].begin(), reach_probs[opponent_player].end(), 0.0);
-        }
-        double scalar_weight_for_regret_update = opponent_reach_sum * chance_reach;
+    // Net payoffs are zero-sum, so at equilibrium the two values cancel.
+    double pot = flat_tree_->Node(0).pot;
+    double exploitability = (best_response_values_[0] + best_response_values_[1]) / 2.0;
+    last_exploitability_ = pot > 0.0 ? exploitability / pot * 100.0 : exploitability;
+    return last_exploitability_;
+}
 
-        std::vector<double> player_reach_weights_vec(acting_player_num_hands);
-        for (size_t h = 0; h < acting_player_num_hands; ++h) {
-             if (acting_player < reach_probs.size() && h < reach_probs[acting_player].size()){ // Bounds check
-                player_reach_weights_vec[h] = reach_probs[acting_player][h] * chance_reach;
-             } else {
-                player_reach_weights_vec[h] = 0.0;
-             }
-            for (size_t a = 0; a < num_actions; ++a) {
-                 size_t idx = h * num_actions + a; // Corrected to Hand-Major
-                 if (idx < weighted_regrets.size() && a < child_utilities.size() && h < child_utilities[a].size() && h < node_utility.size()) {
-                     weighted_regrets[idx] = child_utilities[a][h] - node_utility[h];
-                 } else {
-                      if (idx < weighted_regrets.size()) {
-                          weighted_regrets[idx] = 0.0;
-                      }
-                 }
-            }
+void PCfrSolver::ComputeEvs(int max_depth) {
+    if (flat_tree_->Empty() || !InitializeRootReach()) {
+        throw std::logic_error("ComputeEvs: solver has no tree or no valid ranges.");
+    }
+    TraceSpan span(trace_recorder_.get(), "evs", "solver");
+    const ReachPointers initial_reach_probs = {root_reach_[0].data(), root_reach_[1].data()};
+    const ReachSums initial_reach_sums = {kernels::Sum(root_reach_[0].data(), num_hands_[0]),
+                                          kernels::Sum(root_reach_[1].data(), num_hands_[1])};
+
+    evaluating_best_response_ = true;
+    evaluating_average_ = true;
+    computing_evs_ = true;
+    ev_max_depth_ = max_depth;
+    for (size_t p = 0; p < num_players_; ++p) {
+        std::vector<double> utility(num_hands_[p]);
+        UtilityPointers outputs = {nullptr, nullptr};
+        outputs[p] = utility.data();
+        try {
+            RunTraversal(0, initial_reach_probs, initial_reach_sums, outputs, IterationDiscounts(),
+                         initial_board_mask_, 1.0, 0);
+        } catch (...) {
+            evaluating_best_response_ = false;
+            evaluating_average_ = false;
+            computing_evs_ = false;
+            throw;
         }
-        trainable->UpdateRegrets(weighted_regrets, iteration, scalar_weight_for_regret_update);
-        trainable->AccumulateAverageStrategy(current_strategy_local, iteration, player_reach_weights_vec);
     }
-    return node_utility;
+    evaluating_best_response_ = false;
+    evaluating_average_ = false;
+    computing_evs_ = false;
+    evs_calculated_ = true;
+    ClearHandGrids();
 }
 
+void PCfrSolver::Stop() {
+    stop_signal_ = true;
+}
 
-// --- Chance Node Helper ---
-std::vector<double> PCfrSolver::cfr_chance_node(
-    std::shared_ptr<nodes::ChanceNode> node,
-    const std::vector<std::vector<double>>& reach_probs,
-    int traverser,
-    int iteration,
-    uint64_t current_board_mask,
-    double parent_chance_reach)
-{
-    // --- Get necessary info from the node ---
-    std::shared_ptr<core::GameTreeNode> child = node->GetChild();
-    if (!child) throw std::logic_error("Chance node has no child.");
-
-    core::GameRound round_after_chance = node->GetRound();
-    int num_cards_to_deal = 0;
-    if (round_after_chance == core::GameRound::kFlop) num_cards_to_deal = 3;
-    else if (round_after_chance == core::GameRound::kTurn) num_cards_to_deal = 1;
-    else if (round_after_chance == core::GameRound::kRiver) num_cards_to_deal = 1;
-    else {
-        std::cerr << "[ERROR] cfr_chance_node: Invalid round after chance: " << core::GameTreeNode::GameRoundToString(round_after_chance) << std::endl;
-        throw std::logic_error("Invalid round after ChanceNode in cfr_chance_node.");
+void PCfrSolver::SetTransport(std::shared_ptr<SolverTransport> transport) {
+    if (transport && config_.parallel_level == ParallelLevel::kTasks) {
+        throw std::invalid_argument("PCfrSolver: distributed solving does not support ParallelLevel::kTasks.");
     }
+    transport_ = std::move(transport);
+}
 
-    // --- Determine unavailable cards (board + player hands) ---
-    uint64_t unavailable_mask = current_board_mask; // Start with existing board
-    for(size_t p=0; p < num_players_; ++p) {
-        if (p >= reach_probs.size()) continue; // Safety check
-        const auto& range = pcm_->GetPlayerRange(p); // Read-only access to shared pcm_
-        if (range.size() != reach_probs[p].size() && std::abs(static_cast<long>(range.size()) - static_cast<long>(reach_probs[p].size())) > 5) {
-            continue;
-        }
-        for(size_t h=0; h < std::min(range.size(), reach_probs[p].size()); ++h) {
-            if (reach_probs[p][h] > 1e-12) {
-                unavailable_mask |= range[h].GetBoardMask();
-            }
-        }
+void PCfrSolver::SetShowdownBackend(std::shared_ptr<ShowdownBackend> backend) {
+    showdown_backend_ = backend ? std::move(backend) : std::make_shared<CpuShowdownBackend>();
+}
+
+void PCfrSolver::SetLeafValueEstimator(std::shared_ptr<LeafValueEstimator> estimator) {
+    leaf_estimator_ = estimator ? std::move(estimator) : std::make_shared<CheckDownLeafEstimator>(rrm_);
+}
+
+json PCfrSolver::DumpStrategy(bool dump_evs, int max_depth) const {
+    TraceSpan span(trace_recorder_.get(), "dump", "output");
+    json result;
+    if (!game_tree_ || !game_tree_->GetRoot()) {
+        result["error"] = "Game tree is empty or not initialized.";
+        return result;
+    }
+    std::cout << "[INFO] Dumping strategy... (EVs: " << dump_evs << ", MaxDepth: " << max_depth << ")" << std::endl;
+    result = dump_strategy_recursive(game_tree_->GetRoot(), dump_evs, 0, max_depth, 0);
+    // Ensure metadata is added to the result from dump_strategy_recursive, not overwriting it
+    if (result.is_null()) result = json::object(); // Ensure result is an object if tree was empty/pruned
+    result["metadata"]["dump_evs"] = dump_evs;
+    result["metadata"]["max_depth"] = max_depth == -1 ? "unlimited" : std::to_string(max_depth);
+    // Strategies cover the compacted ranges; map them back to the caller's.
+    json range_info = json::array();
+    for (size_t p = 0; p < num_players_; ++p) {
+        range_info.push_back({{"original_size", pcm_->GetOriginalRange(p).size()},
+                              {"original_indices", pcm_->GetOriginalHandIndices(p)}});
     }
+    result["metadata"]["ranges"] = range_info;
+    return result;
+}
 
-    // --- Determine available cards for dealing ---
-    std::vector<int> available_card_indices;
-    const auto& all_deck_cards = deck_.GetCards(); // Read-only access to shared deck_
-    available_card_indices.reserve(core::kNumCardsInDeck);
-    for(int i=0; i < core::kNumCardsInDeck; ++i) {
-        if (!core::Card::DoBoardsOverlap(1ULL << i, unavailable_mask)) {
-            available_card_indices.push_back(i);
+// --- Memory Estimation ---
+
+PCfrSolver::MemoryEstimate PCfrSolver::EstimateMemory(const tree::GameTree& tree, const config::Rule& rule,
+                                                      const std::array<size_t, 2>& range_sizes,
+                                                      const Config& config) {
+    MemoryEstimate estimate;
+    const size_t board_cards = rule.GetInitialBoardCardsInt().size();
+    const size_t deck_cards = rule.GetDeck().GetCards().size();
+    const size_t deal_cards = deck_cards > board_cards ? deck_cards - board_cards : 0;
+
+    // Shape of the tree: node counts for the flat copy, and the deepest path
+    // and widest node for the traversal scratch.
+    size_t num_nodes = 0;
+    size_t num_action_nodes = 0;
+    size_t num_payoffs = 0;
+    size_t max_depth = 0;
+    size_t max_actions = 0;
+    bool has_showdowns = false;
+    std::vector<std::pair<const core::GameTreeNode*, size_t>> stack;
+    if (tree.GetRoot()) stack.emplace_back(tree.GetRoot().get(), 0);
+    while (!stack.empty()) {
+        auto [node, depth] = stack.back();
+        stack.pop_back();
+        ++num_nodes;
+        max_depth = std::max(max_depth, depth);
+        switch (node->GetNodeType()) {
+            case core::GameTreeNodeType::kAction: {
+                auto* action_node = static_cast<const nodes::ActionNode*>(node);
+                ++num_action_nodes;
+                max_actions = std::max(max_actions, action_node->GetActions().size());
+                for (const auto& child : action_node->GetChildren()) {
+                    if (child) stack.emplace_back(child.get(), depth + 1);
+                }
+                break;
+            }
+            case core::GameTreeNodeType::kChance: {
+                auto* chance_node = static_cast<const nodes::ChanceNode*>(node);
+                if (chance_node->GetChild()) stack.emplace_back(chance_node->GetChild().get(), depth + 1);
+                break;
+            }
+            case core::GameTreeNodeType::kShowdown:
+                has_showdowns = true;
+                num_payoffs += 6;
+                break;
+            case core::GameTreeNodeType::kTerminal:
+                num_payoffs += 2;
+                break;
         }
     }
 
-    // --- Check if enough cards are available ---
-    if (static_cast<int>(available_card_indices.size()) < num_cards_to_deal) {
-        return std::vector<double>(pcm_->GetPlayerRange(traverser).size(), 0.0);
+    // The flat copy keeps a FlatNode and a subtree work estimate per node.
+    estimate.tree_bytes = tree.EstimateTreeMemory() +
+                          num_nodes * (sizeof(tree::FlatNode) + sizeof(double)) +
+                          num_action_nodes * sizeof(nodes::ActionNode*) + num_payoffs * sizeof(double);
+
+    const auto algorithm = config.trainer == Trainer::kCfrPlus ? nodes::ActionNode::TrainableAlgorithm::kCfrPlus
+                                                               : nodes::ActionNode::TrainableAlgorithm::kDiscounted;
+    estimate.trainable_bytes =
+        tree.GetBuildStats().TrainableBytes(range_sizes, config.precision, algorithm, config.lazy_strategies);
+    // Only arena-backed tables go to the files.
+    if (!config.trainable_file_directory.empty() &&
+        config.precision == nodes::ActionNode::TrainablePrecision::kFloat && config.trainer != Trainer::kCfrPlus) {
+        estimate.trainable_file_bytes = tree.GetBuildStats().TrainableBytesFrom(
+            config.trainable_file_round, range_sizes, config.precision, algorithm, config.lazy_strategies);
     }
 
-    // --- Generate card combinations (outcomes) ---
-    utils::Combinations<int> combinations(available_card_indices, num_cards_to_deal);
-    const auto& outcomes = combinations.GetCombinations();
-    double num_possible_outcomes = static_cast<double>(outcomes.size());
-
-    if (num_possible_outcomes < 1.0) {
-        return std::vector<double>(pcm_->GetPlayerRange(traverser).size(), 0.0);
+    if (has_showdowns && board_cards <= 5) {
+        // Every completion of the board to five cards may be reached.
+        uint64_t river_boards = 1;
+        for (size_t k = 0; k < 5 - board_cards; ++k) {
+            river_boards = river_boards * (deal_cards - k) / (k + 1);
+        }
+        estimate.river_cache_bytes = river_boards * (ranges::RiverRangeManager::EstimateEntryBytes(range_sizes[0]) +
+                                                     ranges::RiverRangeManager::EstimateEntryBytes(range_sizes[1]));
     }
 
-    // --- Prepare for parallel loop ---
-    double outcome_probability = 1.0 / num_possible_outcomes;
-    double next_node_chance_reach = parent_chance_reach * outcome_probability;
-
-    size_t traverser_num_hands = pcm_->GetPlayerRange(traverser).size();
-    // Initialize the shared result vector *before* the parallel region
-    std::vector<double> total_expected_utility(traverser_num_hands, 0.0);
-
-    // --- Parallel Loop over Chance Outcomes ---
-    // We removed the reduction clause. We will manually add to the shared
-    // total_expected_utility vector inside a critical section.
-    #pragma omp parallel for schedule(dynamic)
-    for (size_t i = 0; i < outcomes.size(); ++i) {
-        const auto& outcome_cards = outcomes[i];
-
-        // --- Thread-Local Variables ---
-        uint64_t outcome_board_mask = core::Card::CardIntsToUint64(outcome_cards);
-        uint64_t next_board_mask = current_board_mask | outcome_board_mask;
-        std::vector<std::vector<double>> next_reach_probs = reach_probs; // Thread-local copy
-        bool traverser_can_reach_this_outcome = false;
-        bool opponent_can_reach_this_outcome = false;
-        int opponent_player = 1 - traverser;
+    const size_t stacks = static_cast<size_t>(std::max(1, config.num_threads));
+    estimate.scratch_bytes = stacks * (max_depth + 1) *
+                             TraversalScratch::LevelBytes(range_sizes, max_actions, deal_cards);
+    return estimate;
+}
 
-        // --- Update thread-local reach probabilities ---
-        for (size_t p = 0; p < num_players_; ++p) {
-            if (p >= next_reach_probs.size()) continue;
-            const auto& range = pcm_->GetPlayerRange(p);
-            double current_reach_sum_for_outcome = 0.0;
-            size_t current_range_size = std::min(range.size(), next_reach_probs[p].size());
-            for (size_t h = 0; h < current_range_size; ++h) {
-                 if (core::Card::DoBoardsOverlap(range[h].GetBoardMask(), outcome_board_mask)) {
-                     next_reach_probs[p][h] = 0.0;
-                 }
-                 current_reach_sum_for_outcome += next_reach_probs[p][h];
-            }
-            if (p == static_cast<size_t>(traverser) && current_reach_sum_for_outcome > 1e-12) traverser_can_reach_this_outcome = true;
-            if (p == static_cast<size_t>(opponent_player) && current_reach_sum_for_outcome > 1e-12) opponent_can_reach_this_outcome = true;
-        }
-
-        // --- Recurse if possible ---
-        if (traverser_can_reach_this_outcome || opponent_can_reach_this_outcome) {
-            // Calculate utility for this specific outcome (thread-local result)
-            std::vector<double> child_utility = cfr_utility(child, next_reach_probs, traverser, iteration, next_board_mask, next_node_chance_reach);
-
-            // --- Manual Reduction using Critical Section ---
-            // Check size before entering critical section for efficiency
-            if (total_expected_utility.size() == child_utility.size()) {
-                // This critical section ensures only one thread at a time
-                // modifies the shared 'total_expected_utility' vector.
-                #pragma omp critical
-                {
-                    for (size_t util_idx = 0; util_idx < total_expected_utility.size(); ++util_idx) {
-                        total_expected_utility[util_idx] += child_utility[util_idx];
-                    }
-                } // --- End of critical section ---
-            } else if (!child_utility.empty()) {
-                 // Handle error (still use critical for safe output)
-                 #pragma omp critical
-                 {
-                    std::cerr << "[ERROR] Utility vector size mismatch from chance node child in parallel region. Thread: "
-                              << omp_get_thread_num() << ". Expected: " << total_expected_utility.size()
-                              << ", Got: " << child_utility.size() << std::endl;
-                 }
+PCfrSolver::MemoryStats PCfrSolver::GetMemoryStats() const {
+    MemoryStats stats;
+    stats.tree_bytes = game_tree_->EstimateTreeMemory() + flat_tree_->MemoryBytes() +
+                       subtree_work_.capacity() * sizeof(double);
+    stats.tree_bytes += chance_deals_.MemoryBytes();
+    for (const auto& entry : chance_deals_) stats.tree_bytes += entry.second.outcomes.capacity() * sizeof(uint64_t);
+    const auto algorithm = config_.trainer == Trainer::kCfrPlus ? nodes::ActionNode::TrainableAlgorithm::kCfrPlus
+                                                                : nodes::ActionNode::TrainableAlgorithm::kDiscounted;
+    ForEachActionNode([&](nodes::ActionNode& node) {
+        const std::vector<core::PrivateCards>* range = node.GetPlayerRangeRaw();
+        if (!range) return;
+        // Every slot of a node has the same tables; locked slots share one strategy.
+        const uint64_t slot_bytes = node.IsLocked() ? 0
+                                                    : nodes::ActionNode::TrainableBytes(
+                                                          node.GetActions().size(), range->size(), config_.precision,
+                                                          algorithm, config_.lazy_strategies);
+        for (size_t d = 0; d < node.GetNumPossibleDeals(); ++d) {
+            auto trainable = node.GetTrainableIfExists(d);
+            if (!trainable) continue;
+            ++stats.trainable_count;
+            if (const auto* sparse = dynamic_cast<const SparseDiscountedCfrTrainable*>(trainable.get())) {
+                stats.trainable_bytes += sparse->TableBytes();
+            } else if (const auto* bucketed = dynamic_cast<const BucketedDiscountedCfrTrainable*>(trainable.get())) {
+                stats.trainable_bytes += bucketed->TableBytes();
+            } else {
+                // Deferred strategy sums may not be allocated yet.
+                const auto* dense = dynamic_cast<const DiscountedCfrTrainable*>(trainable.get());
+                const bool no_sums = dense && !dense->StrategySums();
+                stats.trainable_bytes += slot_bytes - (no_sums ? range->size() * node.GetActions().size() *
+                                                                     sizeof(double) : 0);
             }
         }
-    } // --- End of parallel loop ---
-
-    // Return the final accumulated utility vector
-    return total_expected_utility;
+    });
+    stats.river_cache_bytes = rrm_->GetCacheStats().bytes + rrm_->GetPreloadedBytes();
+    stats.resident_bytes = CurrentResidentBytes();
+    return stats;
 }
 
+// --- Checkpointing ---
 
+namespace {
 
+// Appends everything streamed through it to 'buffer', which keeps its
+// capacity from one checkpoint to the next.
+class VectorSink : public std::streambuf {
+ public:
+    explicit VectorSink(std::vector<char>& buffer) : buffer_(buffer) { buffer_.clear(); }
 
-// --- Showdown Node Helper ---
-std::vector<double> PCfrSolver::cfr_showdown_node(
-    std::shared_ptr<nodes::ShowdownNode> node,
-    const std::vector<std::vector<double>>& reach_probs,
-    int traverser,
-    uint64_t final_board_mask,
-    double chance_reach)
-{
-    // --- Basic Setup ---
-    int opponent_player = 1 - traverser;
-    const auto& traverser_range = pcm_->GetPlayerRange(traverser); // Read-only access
-    const auto& opponent_range = pcm_->GetPlayerRange(opponent_player); // Read-only access
-    size_t traverser_hands = traverser_range.size();
-    size_t opponent_hands = opponent_range.size();
-
-    // Initialize result vector
-    std::vector<double> traverser_utility(traverser_hands, 0.0);
-
-    // --- Pre-computation and Checks (Before Parallel Region) ---
-
-    // Check for potential size mismatches or invalid opponent index
-    if (opponent_player < 0 || static_cast<size_t>(opponent_player) >= reach_probs.size() || (opponent_hands > 0 && opponent_hands != reach_probs[opponent_player].size())) {
-        // std::cerr << "[WARN] cfr_showdown_node: Opponent range/reach_probs mismatch or invalid index. Opponent: " << opponent_player
-        //           << ", Opponent Hands: " << opponent_hands
-        //           << ", Reach Probs size for opp: " << (static_cast<size_t>(opponent_player) < reach_probs.size() ? reach_probs[opponent_player].size() : -1)
-        //           << ". Returning zero utility." << std::endl;
-        return traverser_utility; // Cannot proceed safely
-    }
-    // Check traverser reach_probs size as well
-     if (static_cast<size_t>(traverser) >= reach_probs.size() || (traverser_hands > 0 && traverser_hands != reach_probs[traverser].size())) {
-        // std::cerr << "[WARN] cfr_showdown_node: Traverser range/reach_probs mismatch or invalid index. Traverser: " << traverser
-        //           << ", Traverser Hands: " << traverser_hands
-        //           << ", Reach Probs size for trav: " << (static_cast<size_t>(traverser) < reach_probs.size() ? reach_probs[traverser].size() : -1)
-        //           << ". Returning zero utility." << std::endl;
-         return traverser_utility; // Cannot proceed safely
-     }
-
-
-    // Get river combos (potentially expensive, do it once)
-    // Assumes rrm_ is thread-safe for concurrent reads if called inside parallel region,
-    // but safer to call it outside.
-    const auto& traverser_combos = rrm_->GetRiverCombos(traverser, traverser_range, final_board_mask);
-    const auto& opponent_combos = rrm_->GetRiverCombos(opponent_player, opponent_range, final_board_mask);
+ protected:
+    std::streamsize xsputn(const char* data, std::streamsize count) override {
+        buffer_.insert(buffer_.end(), data, data + count);
+        return count;
+    }
+    int_type overflow(int_type c) override {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) buffer_.push_back(traits_type::to_char_type(c));
+        return traits_type::not_eof(c);
+    }
 
-    // Get payoffs (read-only access is safe)
-    const auto& p0_wins_payoffs = node->GetPayoffs(core::ComparisonResult::kPlayer1Wins);
-    const auto& p1_wins_payoffs = node->GetPayoffs(core::ComparisonResult::kPlayer2Wins);
-    const auto& tie_payoffs     = node->GetPayoffs(core::ComparisonResult::kTie);
+ private:
+    std::vector<char>& buffer_;
+};
+
+constexpr char kCheckpointMagic[8] = {'P', 'S', 'C', 'K', 'P', 'T', '0', '1'};
+constexpr uint32_t kCheckpointVersion = 1;
+constexpr uint32_t kCompressedCheckpointVersion = 2;
+// Bytes of a zigzag varint change in a row's exponent.
+constexpr uint64_t kCheckpointExponentBytes = 2;
+
+// Appends 'values' as the zigzag varint change from 'exponent' to their own
+// exponent e, where every magnitude is below 2^e, and one little-endian
+// level of 'level_bytes' bytes per value (value = level * 2^(e - bits),
+// bits = 8 * level_bytes - 1), then makes e the new 'exponent'. A
+// power-of-two scale costs a byte instead of a double and divides exactly;
+// it keeps each value within 2^-bits of the row's largest.
+void AppendQuantizedRow(const std::vector<double>& values, int level_bytes, int& exponent,
+                        std::vector<uint8_t>& decoded) {
+    const int level_bits = 8 * level_bytes - 1;
+    const int64_t max_level = (int64_t{1} << level_bits) - 1;
+    double max_magnitude = 0.0;
+    for (double value : values) max_magnitude = std::max(max_magnitude, std::abs(value));
+    int row_exponent = exponent;
+    if (max_magnitude > 0.0) std::frexp(max_magnitude, &row_exponent);
+    utils::AppendVarint(utils::ZigZagEncode(row_exponent - exponent), decoded);
+    exponent = row_exponent;
+    for (double value : values) {
+        const int64_t level = std::clamp<int64_t>(std::llround(std::ldexp(value, level_bits - exponent)),
+                                                  -max_level, max_level);
+        const uint64_t bits = static_cast<uint64_t>(level);
+        for (int b = 0; b < level_bytes; ++b) decoded.push_back(static_cast<uint8_t>(bits >> (8 * b)));
+    }
+}
 
-    // Create lookup maps *before* the parallel loop for efficiency
-    std::unordered_map<size_t, size_t> oppo_orig_idx_to_river_idx;
-    oppo_orig_idx_to_river_idx.reserve(opponent_combos.size()); // Optional: reserve space
-    for(size_t rc_idx = 0; rc_idx < opponent_combos.size(); ++rc_idx) {
-        oppo_orig_idx_to_river_idx[opponent_combos[rc_idx].original_range_index] = rc_idx;
+// Inverse of AppendQuantizedRow into 'values', advancing 'cursor'.
+// Throws std::runtime_error if the row runs past 'end' or is out of range.
+void ReadQuantizedRow(const uint8_t*& cursor, const uint8_t* end, int level_bytes, int& exponent,
+                      std::vector<double>& values) {
+    const int level_bits = 8 * level_bytes - 1;
+    const int64_t row_exponent = exponent + utils::ZigZagDecode(utils::ReadVarint(cursor, end));
+    if (row_exponent < std::numeric_limits<double>::min_exponent - std::numeric_limits<double>::digits ||
+        row_exponent > std::numeric_limits<double>::max_exponent) {
+        throw std::runtime_error("LoadCheckpoint: corrupt trainable chunk.");
+    }
+    exponent = static_cast<int>(row_exponent);
+    if (static_cast<size_t>(end - cursor) < static_cast<size_t>(level_bytes) * values.size()) {
+        throw std::runtime_error("LoadCheckpoint: truncated trainable chunk.");
     }
+    for (double& value : values) {
+        uint64_t bits = 0;
+        for (int b = 0; b < level_bytes; ++b) bits |= uint64_t{*cursor++} << (8 * b);
+        // Sign-extends the level from its top stored bit.
+        const int64_t level = static_cast<int64_t>(bits << (64 - 8 * level_bytes)) >> (64 - 8 * level_bytes);
+        value = std::ldexp(static_cast<double>(level), exponent - level_bits);
+    }
+}
 
-    std::unordered_map<size_t, size_t> trav_orig_idx_to_river_idx;
-    trav_orig_idx_to_river_idx.reserve(traverser_combos.size()); // Optional: reserve space
-    for(size_t rc_idx = 0; rc_idx < traverser_combos.size(); ++rc_idx) {
-        trav_orig_idx_to_river_idx[traverser_combos[rc_idx].original_range_index] = rc_idx;
+// Bytes of a compressed regret and strategy sum level.
+constexpr int kCheckpointRegretBytes = 2;
+constexpr int kCheckpointSumBytes = 1;
+
+// A compressed checkpoint chunk decoded, hand by hand: the hand's regrets
+// as 16-bit levels, then its strategy sums as 8-bit ones, each row scaled
+// by a power of two of its own. Scaling per hand rather than per slot keeps
+// every hand's regrets within 1/32768 and its sums within 1/128 of that
+// hand's largest, however far apart hands' magnitudes are; sums only feed
+// the average strategy, regrets the strategy a resumed solve plays.
+void EncodeCheckpointSlot(const Trainable& trainable, size_t num_hands, size_t num_actions,
+                          std::vector<uint8_t>& decoded) {
+    std::vector<double> regrets(num_actions);
+    std::vector<double> sums(num_actions);
+    int regret_exponent = 0;
+    int sum_exponent = 0;
+    decoded.clear();
+    for (size_t h = 0; h < num_hands; ++h) {
+        trainable.GetHandState(h, regrets.data(), sums.data());
+        AppendQuantizedRow(regrets, kCheckpointRegretBytes, regret_exponent, decoded);
+        AppendQuantizedRow(sums, kCheckpointSumBytes, sum_exponent, decoded);
     }
+}
 
-    // --- Parallel Loop over Traverser's Hands ---
-    // Each thread calculates the utility for a subset of the traverser's original hands.
-    // Writes to traverser_utility[trav_orig_idx] are safe because each thread handles distinct indices.
-    #pragma omp parallel for schedule(dynamic) // schedule(dynamic) might help if opponent comparisons vary
-    for (size_t trav_orig_idx = 0; trav_orig_idx < traverser_hands; ++trav_orig_idx) {
-        // --- Per-Hand Calculation (Private within thread/iteration) ---
+// Inverse of EncodeCheckpointSlot into 'trainable'.
+// Throws std::runtime_error if the chunk does not hold exactly the tables.
+void DecodeCheckpointSlot(const std::vector<uint8_t>& decoded, size_t num_hands, size_t num_actions,
+                          Trainable& trainable) {
+    const uint8_t* cursor = decoded.data();
+    const uint8_t* const end = decoded.data() + decoded.size();
+    std::vector<double> regrets(num_actions);
+    std::vector<double> sums(num_actions);
+    int regret_exponent = 0;
+    int sum_exponent = 0;
+    for (size_t h = 0; h < num_hands; ++h) {
+        ReadQuantizedRow(cursor, end, kCheckpointRegretBytes, regret_exponent, regrets);
+        ReadQuantizedRow(cursor, end, kCheckpointSumBytes, sum_exponent, sums);
+        trainable.SetHandState(h, regrets.data(), sums.data());
+    }
+    if (cursor != end) throw std::runtime_error("LoadCheckpoint: trainable chunk has trailing bytes.");
+}
 
-        // Check if traverser can actually reach with this hand
-        // (Bounds check already done before parallel region)
-        if (reach_probs[traverser][trav_orig_idx] < 1e-12) {
-            continue; // Skip this hand if it has zero reach probability
+} // namespace
+
+void PCfrSolver::ForEachActionNode(const std::function<void(nodes::ActionNode&)>& visit) const {
+    std::vector<std::shared_ptr<core::GameTreeNode>> node_stack;
+    if (game_tree_->GetRoot()) node_stack.push_back(game_tree_->GetRoot());
+    while (!node_stack.empty()) {
+        std::shared_ptr<core::GameTreeNode> current = std::move(node_stack.back());
+        node_stack.pop_back();
+        if (auto action_node = std::dynamic_pointer_cast<nodes::ActionNode>(current)) {
+            visit(*action_node);
+            const auto& children = action_node->GetChildren();
+            // Reversed, so the first child is visited first.
+            for (auto it = children.rbegin(); it != children.rend(); ++it) {
+                if (*it) node_stack.push_back(*it);
+            }
+        } else if (auto chance_node = std::dynamic_pointer_cast<nodes::ChanceNode>(current)) {
+            if (chance_node->GetChild()) node_stack.push_back(chance_node->GetChild());
         }
+    }
+}
 
-        // Find the corresponding RiverHandCombo for this original index
-        // This lookup uses the map created before the parallel region (read-only access)
-        auto trav_map_it = trav_orig_idx_to_river_idx.find(trav_orig_idx);
-        if (trav_map_it == trav_orig_idx_to_river_idx.end()) {
-            // This hand wasn't valid on the river (e.g., blocked by final board), utility remains 0.0
-            continue;
+uint64_t PCfrSolver::TreeFingerprint() const {
+    utils::Fnv1a fingerprint;
+    fingerprint.Add(initial_board_mask_);
+    for (size_t p = 0; p < num_players_; ++p) {
+        const auto& range = pcm_->GetPlayerRange(p);
+        fingerprint.Add(range.size());
+        for (const auto& hand : range) {
+            fingerprint.Add(hand.Card1Int());
+            fingerprint.Add(hand.Card2Int());
         }
-        // Get the actual river combo data (read-only access to traverser_combos)
-        const auto& trav_c = traverser_combos[trav_map_it->second];
+    }
+    ForEachActionNode([&](nodes::ActionNode& node) {
+        fingerprint.Add(core::GameTreeNode::GameRoundToInt(node.GetRound()));
+        fingerprint.Add(node.GetPot());
+        fingerprint.Add(node.GetPlayerIndex());
+        fingerprint.Add(node.GetNumPossibleDeals());
+        fingerprint.Add(node.GetActions().size());
+        for (const auto& action : node.GetActions()) fingerprint.Add(action.ToString());
+    });
+    return fingerprint.Value();
+}
 
-        // Variables local to this iteration are private
-        uint64_t traverser_private_mask = trav_c.private_cards.GetBoardMask();
-        double expected_value_for_hand = 0.0; // Accumulator for this specific hand
+void PCfrSolver::SaveCheckpoint(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("SaveCheckpoint: cannot open '" + path + "' for writing.");
+    WriteCheckpoint(out);
+    out.flush();
+    if (!out) throw std::runtime_error("SaveCheckpoint: failed writing '" + path + "'.");
+}
 
-        // Inner loop: Iterate over opponent hands to calculate expected value
-        for (size_t oppo_orig_idx = 0; oppo_orig_idx < opponent_hands; ++oppo_orig_idx) {
-            // Check opponent reach probability (read-only access to reach_probs)
-            if (reach_probs[opponent_player][oppo_orig_idx] < 1e-12) {
-                continue; // Skip opponent hand if it has zero reach probability
+void PCfrSolver::WriteCheckpoint(std::ostream& out) const {
+    uint64_t num_slots = 0;
+    ForEachActionNode([&](nodes::ActionNode& node) { num_slots += node.GetNumPossibleDeals(); });
+
+    const uint32_t kind = (static_cast<uint32_t>(config_.abstraction_buckets) << 16) |
+                          (static_cast<uint32_t>(config_.trainer) << 8) |
+                          static_cast<uint32_t>(config_.precision);
+    const uint64_t fingerprint = TreeFingerprint();
+    const int64_t iterations = completed_iterations_;
+    const uint32_t version = config_.compressed_checkpoints ? kCompressedCheckpointVersion : kCheckpointVersion;
+    utils::WriteRaw(out, kCheckpointMagic, sizeof(kCheckpointMagic));
+    utils::WriteRaw(out, &version, 1);
+    utils::WriteRaw(out, &kind, 1);
+    utils::WriteRaw(out, &fingerprint, 1);
+    utils::WriteRaw(out, &iterations, 1);
+    utils::WriteRaw(out, &num_slots, 1);
+
+    if (!config_.compressed_checkpoints) {
+        ForEachActionNode([&](nodes::ActionNode& node) {
+            for (size_t d = 0; d < node.GetNumPossibleDeals(); ++d) {
+                auto trainable = node.GetTrainableIfExists(d);
+                const uint8_t present = trainable ? 1 : 0;
+                utils::WriteRaw(out, &present, 1);
+                if (trainable) trainable->WriteState(out);
             }
+        });
+        return;
+    }
 
-            // Get opponent's original hand data (read-only access to opponent_range)
-            const core::PrivateCards& oppo_hand_orig = opponent_range[oppo_orig_idx];
-            uint64_t opponent_private_mask = oppo_hand_orig.GetBoardMask();
-
-            // Check for card conflicts (blockers)
-            if (core::Card::DoBoardsOverlap(traverser_private_mask, opponent_private_mask)) {
-                continue; // Skip conflicting hands
+    // Slots are encoded in parallel, then written in order. Locked nodes
+    // have no state to save, as in the raw format.
+    std::vector<std::pair<nodes::ActionNode*, std::shared_ptr<Trainable>>> slots;
+    slots.reserve(num_slots);
+    ForEachActionNode([&](nodes::ActionNode& node) {
+        for (size_t d = 0; d < node.GetNumPossibleDeals(); ++d) slots.emplace_back(&node, node.GetTrainableIfExists(d));
+    });
+    std::vector<std::vector<uint8_t>> chunks(slots.size());
+    std::vector<uint32_t> decoded_sizes(slots.size(), 0);
+    const long slot_count = static_cast<long>(slots.size());
+    std::exception_ptr encode_error;
+    #pragma omp parallel
+    {
+        std::vector<uint8_t> decoded;
+        #pragma omp for schedule(dynamic, 16)
+        for (long i = 0; i < slot_count; ++i) {
+            const auto& [node, trainable] = slots[static_cast<size_t>(i)];
+            if (!trainable || node->IsLocked()) continue;
+            try {
+                EncodeCheckpointSlot(*trainable, pcm_->GetPlayerRange(node->GetPlayerIndex()).size(),
+                                     node->GetActions().size(), decoded);
+                std::vector<uint8_t>& chunk = chunks[static_cast<size_t>(i)];
+                decoded_sizes[static_cast<size_t>(i)] = static_cast<uint32_t>(decoded.size());
+                utils::CompressBlock(decoded.data(), decoded.size(), chunk);
+                if (chunk.size() >= decoded.size()) chunk = decoded;
+            } catch (...) {
+                CaptureFirstError(encode_error);
             }
+        }
+    }
+    if (encode_error) std::rethrow_exception(encode_error);
+    for (size_t i = 0; i < slots.size(); ++i) {
+        const uint8_t present = slots[i].second ? 1 : 0;
+        utils::WriteRaw(out, &present, 1);
+        if (!present || slots[i].first->IsLocked()) continue;
+        const uint32_t stored_size = static_cast<uint32_t>(chunks[i].size());
+        utils::WriteRaw(out, &decoded_sizes[i], 1);
+        utils::WriteRaw(out, &stored_size, 1);
+        utils::WriteRaw(out, chunks[i].data(), chunks[i].size());
+    }
+}
+
+void PCfrSolver::StartBackgroundCheckpoint() {
+    FinishBackgroundCheckpoint();
+    const uint64_t start = utils::TimeSinceEpochMillisec();
+    {
+        VectorSink sink(checkpoint_buffer_);
+        std::ostream out(&sink);
+        WriteCheckpoint(out);
+    }
+    std::cout << "[INFO] Iteration " << completed_iterations_ << ": checkpoint of "
+              << checkpoint_buffer_.size() / (1024 * 1024) << " MiB staged in "
+              << utils::TimeSinceEpochMillisec() - start << " ms, writing in the background." << std::endl;
+    checkpoint_writer_ = std::thread([this, path = config_.checkpoint_path]() {
+        const std::string temporary = path + ".tmp";
+        try {
+            {
+                std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+                if (!out) throw std::runtime_error("cannot open '" + temporary + "' for writing");
+                utils::WriteRaw(out, checkpoint_buffer_.data(), checkpoint_buffer_.size());
+                out.flush();
+                if (!out) throw std::runtime_error("failed writing '" + temporary + "'");
+            }
+            if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+                throw std::runtime_error("cannot rename '" + temporary + "' to '" + path + "'");
+            }
+        } catch (const std::exception& e) {
+            checkpoint_error_ = e.what();
+        }
+    });
+}
+
+void PCfrSolver::FinishBackgroundCheckpoint() {
+    if (checkpoint_writer_.joinable()) checkpoint_writer_.join();
+    if (checkpoint_error_.empty()) return;
+    const std::string error = std::move(checkpoint_error_);
+    checkpoint_error_.clear();
+    throw std::runtime_error("Background checkpoint to '" + config_.checkpoint_path + "' failed: " + error + ".");
+}
+
+void PCfrSolver::LoadCheckpoint(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("LoadCheckpoint: cannot open '" + path + "'.");
+
+    char magic[sizeof(kCheckpointMagic)];
+    uint32_t version = 0;
+    uint32_t kind = 0;
+    uint64_t fingerprint = 0;
+    int64_t iterations = 0;
+    uint64_t num_slots = 0;
+    utils::ReadRaw(in, magic, sizeof(magic));
+    if (std::memcmp(magic, kCheckpointMagic, sizeof(magic)) != 0) {
+        throw std::runtime_error("LoadCheckpoint: '" + path + "' is not a solver checkpoint.");
+    }
+    utils::ReadRaw(in, &version, 1);
+    if (version != kCheckpointVersion && version != kCompressedCheckpointVersion) {
+        std::ostringstream oss;
+        oss << "LoadCheckpoint: unsupported checkpoint version " << version
+            << " (expected " << kCheckpointVersion << " or " << kCompressedCheckpointVersion << ").";
+        throw std::runtime_error(oss.str());
+    }
+    const bool compressed = version == kCompressedCheckpointVersion;
+    utils::ReadRaw(in, &kind, 1);
+    const uint32_t expected_kind = (static_cast<uint32_t>(config_.abstraction_buckets) << 16) |
+                                   (static_cast<uint32_t>(config_.trainer) << 8) |
+                                   static_cast<uint32_t>(config_.precision);
+    if (kind != expected_kind) {
+        throw std::runtime_error(
+            "LoadCheckpoint: checkpoint was written with a different trainer, precision or abstraction.");
+    }
+    utils::ReadRaw(in, &fingerprint, 1);
+    if (fingerprint != TreeFingerprint()) {
+        throw std::runtime_error("LoadCheckpoint: checkpoint does not match this tree and ranges.");
+    }
+    utils::ReadRaw(in, &iterations, 1);
+    utils::ReadRaw(in, &num_slots, 1);
+    if (iterations < 0 || iterations > std::numeric_limits<int>::max()) {
+        throw std::runtime_error("LoadCheckpoint: corrupt iteration count.");
+    }
+
+    // Compressed chunks are read in order and decoded in parallel after.
+    struct PendingChunk {
+        std::shared_ptr<Trainable> trainable;
+        size_t num_hands;
+        size_t num_actions;
+        uint32_t decoded_size;
+        std::vector<uint8_t> stored;
+    };
+    std::vector<PendingChunk> chunks;
+    uint64_t slots_read = 0;
+    ForEachActionNode([&](nodes::ActionNode& node) {
+        for (size_t d = 0; d < node.GetNumPossibleDeals(); ++d, ++slots_read) {
+            uint8_t present = 0;
+            utils::ReadRaw(in, &present, 1);
+            if (present > 1) throw std::runtime_error("LoadCheckpoint: corrupt trainable flag.");
+            if (!present) continue;
+            std::shared_ptr<Trainable> trainable = TrainableFor(node, d);
+            if (!compressed) {
+                trainable->ReadState(in);
+                continue;
+            }
+            if (node.IsLocked()) continue;
+            PendingChunk chunk;
+            chunk.trainable = std::move(trainable);
+            chunk.num_hands = pcm_->GetPlayerRange(node.GetPlayerIndex()).size();
+            chunk.num_actions = node.GetActions().size();
+            uint32_t stored_size = 0;
+            utils::ReadRaw(in, &chunk.decoded_size, 1);
+            utils::ReadRaw(in, &stored_size, 1);
+            // Per hand, two exponent changes plus a regret and a sum level
+            // per action.
+            const uint64_t hand_bytes = 2 * kCheckpointExponentBytes +
+                                        (kCheckpointRegretBytes + kCheckpointSumBytes) * uint64_t{chunk.num_actions};
+            const uint64_t max_decoded_size = uint64_t{chunk.num_hands} * hand_bytes;
+            if (stored_size > chunk.decoded_size || chunk.decoded_size > max_decoded_size) {
+                throw std::runtime_error("LoadCheckpoint: corrupt trainable chunk size.");
+            }
+            chunk.stored.resize(stored_size);
+            utils::ReadRaw(in, chunk.stored.data(), chunk.stored.size());
+            chunks.push_back(std::move(chunk));
+        }
+    });
+    if (slots_read != num_slots || in.peek() != std::char_traits<char>::eof()) {
+        throw std::runtime_error("LoadCheckpoint: checkpoint size does not match this tree.");
+    }
+    std::vector<std::exception_ptr> errors(chunks.size());
+    const long chunk_count = static_cast<long>(chunks.size());
+    #pragma omp parallel
+    {
+        std::vector<uint8_t> decoded;
+        #pragma omp for schedule(dynamic, 16)
+        for (long i = 0; i < chunk_count; ++i) {
+            const PendingChunk& chunk = chunks[static_cast<size_t>(i)];
+            try {
+                if (chunk.stored.size() == chunk.decoded_size) {
+                    decoded = chunk.stored;
+                } else {
+                    decoded.resize(chunk.decoded_size);
+                    utils::DecompressBlock(chunk.stored.data(), chunk.stored.size(), decoded.data(), decoded.size());
+                }
+                DecodeCheckpointSlot(decoded, chunk.num_hands, chunk.num_actions, *chunk.trainable);
+            } catch (...) {
+                errors[static_cast<size_t>(i)] = std::current_exception();
+            }
+        }
+    }
+    for (const std::exception_ptr& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+    completed_iterations_ = static_cast<int>(iterations);
+    evs_calculated_ = false;
+    ClearHandGrids();
+    std::cout << "[INFO] Loaded checkpoint '" << path << "' after " << completed_iterations_
+              << " iterations." << std::endl;
+}
+
+size_t PCfrSolver::WarmStartFrom(const PCfrSolver& prior) {
+    if (prior.initial_board_mask_ != initial_board_mask_ || prior.deal_cards_ != deal_cards_) {
+        throw std::invalid_argument("WarmStartFrom: the prior solve has a different board or deck.");
+    }
+
+    // hand_maps[p][h]: index of this range's hand h in the prior range, or -1.
+    std::array<std::vector<int>, 2> hand_maps;
+    for (size_t p = 0; p < num_players_; ++p) {
+        auto hand_key = [](const core::PrivateCards& hand) {
+            return std::make_pair(std::min(hand.Card1Int(), hand.Card2Int()),
+                                  std::max(hand.Card1Int(), hand.Card2Int()));
+        };
+        std::map<std::pair<int, int>, int> prior_index;
+        const auto& prior_range = prior.pcm_->GetPlayerRange(p);
+        for (size_t h = 0; h < prior_range.size(); ++h) prior_index[hand_key(prior_range[h])] = static_cast<int>(h);
+        for (const auto& hand : pcm_->GetPlayerRange(p)) {
+            auto it = prior_index.find(hand_key(hand));
+            hand_maps[p].push_back(it == prior_index.end() ? -1 : it->second);
+        }
+    }
+
+    const size_t seeded = SeedRegrets(game_tree_->GetRoot(), prior.game_tree_->GetRoot(), hand_maps);
+    // The regrets carry the discounting of the prior's iterations, so the
+    // schedule continues from there.
+    completed_iterations_ = prior.completed_iterations_;
+    evs_calculated_ = false;
+    ClearHandGrids();
+    std::cout << "[INFO] Warm start seeded " << seeded << " deal slots from a prior solve after "
+              << completed_iterations_ << " iterations." << std::endl;
+    return seeded;
+}
+
+size_t PCfrSolver::SeedRegrets(const std::shared_ptr<core::GameTreeNode>& root,
+                               const std::shared_ptr<core::GameTreeNode>& prior_root,
+                               const std::array<std::vector<int>, 2>& hand_maps) {
+    auto same_actions = [](const nodes::ActionNode& a, const nodes::ActionNode& b) {
+        if (a.GetPlayerIndex() != b.GetPlayerIndex() || a.GetRound() != b.GetRound() ||
+            a.GetActions().size() != b.GetActions().size() ||
+            a.GetChildren().size() != b.GetChildren().size()) {
+            return false;
+        }
+        for (size_t i = 0; i < a.GetActions().size(); ++i) {
+            if (a.GetActions()[i].GetAction() != b.GetActions()[i].GetAction()) return false;
+        }
+        return true;
+    };
+
+    size_t seeded = 0;
+    std::vector<double> regrets;
+    std::vector<double> strategy_sums;
+    std::vector<std::pair<std::shared_ptr<core::GameTreeNode>, std::shared_ptr<core::GameTreeNode>>> node_stack;
+    if (root && prior_root) node_stack.emplace_back(root, prior_root);
+    while (!node_stack.empty()) {
+        auto current = std::move(node_stack.back());
+        node_stack.pop_back();
+        if (!current.first || !current.second) continue;
+        auto action_node = std::dynamic_pointer_cast<nodes::ActionNode>(current.first);
+        auto prior_action_node = std::dynamic_pointer_cast<nodes::ActionNode>(current.second);
+        if (action_node && prior_action_node) {
+            if (!same_actions(*action_node, *prior_action_node) ||
+                action_node->GetNumPossibleDeals() != prior_action_node->GetNumPossibleDeals()) {
+                continue;
+            }
+            const std::vector<int>& hand_map = hand_maps[action_node->GetPlayerIndex()];
+            const size_t num_actions = action_node->GetActions().size();
+            regrets.resize(num_actions);
+            strategy_sums.resize(num_actions);
+            for (size_t d = 0; d < action_node->GetNumPossibleDeals(); ++d) {
+                auto prior_trainable = prior_action_node->GetTrainableIfExists(d);
+                if (!prior_trainable) continue;
+                auto trainable = TrainableFor(*action_node, d);
+                for (size_t h = 0; h < hand_map.size(); ++h) {
+                    if (hand_map[h] < 0) continue;
+                    prior_trainable->GetHandState(static_cast<size_t>(hand_map[h]), regrets.data(),
+                                                  strategy_sums.data());
+                    std::fill(strategy_sums.begin(), strategy_sums.end(), 0.0); // See WarmStartFrom
+                    trainable->SetHandState(h, regrets.data(), strategy_sums.data());
+                }
+                ++seeded;
+            }
+            const auto& children = action_node->GetChildren();
+            const auto& prior_children = prior_action_node->GetChildren();
+            for (size_t i = 0; i < children.size(); ++i) node_stack.emplace_back(children[i], prior_children[i]);
+            continue;
+        }
+        auto chance_node = std::dynamic_pointer_cast<nodes::ChanceNode>(current.first);
+        auto prior_chance_node = std::dynamic_pointer_cast<nodes::ChanceNode>(current.second);
+        if (chance_node && prior_chance_node) {
+            node_stack.emplace_back(chance_node->GetChild(), prior_chance_node->GetChild());
+        }
+    }
+    return seeded;
+}
+
+// --- Incremental Tree Edits ---
+
+size_t PCfrSolver::EditBetSizes(const std::vector<std::string>& path, std::vector<double> amounts) {
+    nodes::ActionNode& node = ActionNodeAt(path, "EditBetSizes");
+    if (node.IsLocked()) throw std::logic_error("EditBetSizes: the node is locked; unlock it first.");
+    const size_t num_deals = node.GetNumPossibleDeals();
+    const size_t num_hands = pcm_->GetPlayerRange(node.GetPlayerIndex()).size();
+
+    // The node's tables by hand, laid out for its old actions.
+    const size_t old_num_actions = node.GetActions().size();
+    std::vector<std::vector<double>> old_regrets(num_deals);
+    std::vector<std::vector<double>> old_sums(num_deals);
+    for (size_t d = 0; d < num_deals; ++d) {
+        auto trainable = node.GetTrainableIfExists(d);
+        if (!trainable) continue;
+        old_regrets[d].resize(num_hands * old_num_actions);
+        old_sums[d].resize(num_hands * old_num_actions);
+        for (size_t h = 0; h < num_hands; ++h) {
+            trainable->GetHandState(h, old_regrets[d].data() + h * old_num_actions,
+                                    old_sums[d].data() + h * old_num_actions);
+        }
+    }
+    const std::vector<core::GameAction> old_actions = node.GetActions();
+    const std::vector<std::shared_ptr<core::GameTreeNode>> old_children = node.GetChildren();
+    const std::vector<int> kept = game_tree_->EditBetSizes(path, std::move(amounts));
+
+    // Kept actions carry their regrets and strategy sums over; new bets
+    // start from zero.
+    const size_t num_actions = node.GetActions().size();
+    std::vector<double> regrets(num_actions);
+    std::vector<double> strategy_sums(num_actions);
+    for (size_t d = 0; d < num_deals; ++d) {
+        node.ReplaceTrainable(d, nullptr);
+        if (old_regrets[d].empty()) continue;
+        auto trainable = TrainableFor(node, d);
+        for (size_t h = 0; h < num_hands; ++h) {
+            for (size_t a = 0; a < num_actions; ++a) {
+                const bool has_old = kept[a] >= 0;
+                regrets[a] = has_old ? old_regrets[d][h * old_num_actions + kept[a]] : 0.0;
+                strategy_sums[a] = has_old ? old_sums[d][h * old_num_actions + kept[a]] : 0.0;
+            }
+            trainable->SetHandState(h, regrets.data(), strategy_sums.data());
+        }
+    }
+
+    // New subtrees: ranges and deal slots as the constructor sets them,
+    // then regrets from the kept bet or raise closest in size.
+    std::array<std::vector<int>, 2> same_hands;
+    for (size_t p = 0; p < num_players_; ++p) {
+        same_hands[p].resize(pcm_->GetPlayerRange(p).size());
+        std::iota(same_hands[p].begin(), same_hands[p].end(), 0);
+    }
+    size_t seeded = 0;
+    for (size_t a = 0; a < num_actions; ++a) {
+        if (kept[a] >= 0) continue;
+        std::vector<std::pair<std::shared_ptr<core::GameTreeNode>, size_t>> node_stack = {
+            {node.GetChildren()[a], num_deals}};
+        while (!node_stack.empty()) {
+            auto [current, deals] = node_stack.back();
+            node_stack.pop_back();
+            if (auto action_node = std::dynamic_pointer_cast<nodes::ActionNode>(current)) {
+                action_node->SetPlayerRange(&pcm_->GetPlayerRange(action_node->GetPlayerIndex()));
+                action_node->SetNumPossibleDeals(deals);
+                for (const auto& child : action_node->GetChildren()) node_stack.emplace_back(child, deals);
+            } else if (auto chance_node = std::dynamic_pointer_cast<nodes::ChanceNode>(current)) {
+                if (!chance_node->GetChild()) continue;
+                const bool single_card = chance_node->GetRound() != core::GameRound::kFlop;
+                node_stack.emplace_back(chance_node->GetChild(), single_card ? deals * deal_cards_.size() : deals);
+            }
+        }
+        const double amount = node.GetActions()[a].GetAmount();
+        int closest = -1;
+        for (size_t o = 0; o < old_actions.size(); ++o) {
+            const core::PokerAction type = old_actions[o].GetAction();
+            if (type != core::PokerAction::kBet && type != core::PokerAction::kRaise) continue;
+            if (std::find(kept.begin(), kept.end(), static_cast<int>(o)) == kept.end()) continue;
+            if (closest < 0 || std::abs(old_actions[o].GetAmount() - amount) <
+                                   std::abs(old_actions[closest].GetAmount() - amount)) {
+                closest = static_cast<int>(o);
+            }
+        }
+        if (closest >= 0) seeded += SeedRegrets(node.GetChildren()[a], old_children[closest], same_hands);
+    }
+
+    IndexTree();
+    evs_calculated_ = false;
+    ClearHandGrids();
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    if (!snapshot_nodes_.empty()) {
+        // Dropped bets may have taken snapshot nodes with them.
+        snapshot_nodes_.clear();
+        std::cout << "[INFO] EditBetSizes: the snapshot subtree was cleared; request it again." << std::endl;
+    }
+    std::string where;
+    for (const std::string& step : path) where += (where.empty() ? "" : "/") + step;
+    std::cout << "[INFO] Edited the bet sizes at '" << where << "': " << num_actions << " actions, " << seeded
+              << " deal slots seeded below new sizes." << std::endl;
+    return seeded;
+}
+
+// --- Subgame Re-solving ---
+
+PCfrSolver::Subgame PCfrSolver::ExtractSubgame(const std::vector<std::string>& path) {
+    if (transport_ && transport_->Size() > 1) {
+        // A rank holds the trainables of its own outcomes only.
+        throw std::logic_error("ExtractSubgame: not supported on a distributed solver.");
+    }
+    if (flat_tree_->Empty() || !InitializeRootReach()) {
+        throw std::logic_error("ExtractSubgame: solver has no tree or no valid ranges.");
+    }
+
+    // Follow the path: each player's reach and range weight take the
+    // probability of its own actions, dealt cards remove the hands holding them.
+    std::array<std::vector<double>, 2> reach = root_reach_;
+    std::array<std::vector<double>, 2> weights;
+    for (size_t p = 0; p < num_players_; ++p) {
+        for (const auto& hand : pcm_->GetPlayerRange(p)) weights[p].push_back(hand.Weight());
+    }
+    Subgame subgame;
+    for (int card = 0; card < core::kNumCardsInDeck; ++card) {
+        if ((initial_board_mask_ >> card) & 1ULL) subgame.board.push_back(card);
+    }
+    uint32_t node_index = 0;
+    uint64_t board_mask = initial_board_mask_;
+    size_t deal_index = 0;
+    int deal_layers = 0;
+    double chance_reach = 1.0;
+    bool at_street_start = true;
+    for (const std::string& step : path) {
+        const tree::FlatNode& node = flat_tree_->Node(node_index);
+        if (node.type == core::GameTreeNodeType::kAction) {
+            const nodes::ActionNode& action_node = flat_tree_->Action(node);
+            const auto& actions = action_node.GetActions();
+            size_t a = 0;
+            while (a < actions.size() && actions[a].ToString() != step) ++a;
+            if (a == actions.size()) {
+                std::string expected;
+                for (const auto& action : actions) expected += (expected.empty() ? "" : ", ") + action.ToString();
+                throw std::invalid_argument("ExtractSubgame: no action '" + step + "' here (expected one of: " +
+                                            expected + ").");
+            }
+            const size_t player = node.player;
+            const size_t num_actions = actions.size();
+            std::vector<std::pair<int, int>> swaps;
+            auto trainable = DealTrainable(action_node, deal_index, deal_layers, swaps);
+            std::vector<double> average;
+            if (action_node.IsLocked()) {
+                average = *action_node.GetLockedStrategy();
+            } else if (trainable) {
+                average = trainable->GetAverageStrategy();
+            }
+            for (size_t h = 0; h < num_hands_[player]; ++h) {
+                const double probability = average.size() == num_actions * num_hands_[player]
+                    ? average[SwappedHand(player, h, swaps) * num_actions + a]
+                    : 1.0 / static_cast<double>(num_actions);
+                reach[player][h] *= probability;
+                weights[player][h] *= probability;
+            }
+            node_index = node.first_child + static_cast<uint32_t>(a);
+            at_street_start = false;
+        } else if (node.type == core::GameTreeNodeType::kChance) {
+            const int num_cards = node.round == core::GameRound::kFlop ? 3 : 1;
+            if (step.size() != 2u * num_cards) {
+                throw std::invalid_argument("ExtractSubgame: the chance node deals " + std::to_string(num_cards) +
+                                            " card(s), not '" + step + "'.");
+            }
+            uint64_t dealt_mask = 0;
+            for (size_t i = 0; i < step.size(); i += 2) {
+                auto card = core::Card::StringToInt(step.substr(i, 2));
+                if (!card || (((board_mask | dealt_mask) >> *card) & 1ULL)) {
+                    throw std::invalid_argument("ExtractSubgame: '" + step + "' is not a deal of unused cards.");
+                }
+                dealt_mask |= 1ULL << *card;
+                subgame.board.push_back(*card);
+            }
+            // Outcome probability as cfr_chance_node weighs it.
+            int num_available_cards = 0;
+            for (int card : deal_cards_) num_available_cards += ((board_mask >> card) & 1ULL) ? 0 : 1;
+            double compatible_outcomes = 1.0;
+            for (int c = 0; c < num_cards; ++c) {
+                compatible_outcomes = compatible_outcomes * (num_available_cards - 4 - c) / (c + 1);
+            }
+            chance_reach /= compatible_outcomes;
+            for (size_t p = 0; p < num_players_; ++p) {
+                for (uint64_t cards = dealt_mask; cards != 0; cards &= cards - 1) {
+                    for (int32_t h : pcm_->GetHandsWithCard(p, core::LowestCard(cards))) reach[p][h] = weights[p][h] = 0.0;
+                }
+            }
+            deal_index = NextDealIndex(deal_index, dealt_mask, num_cards);
+            if (node.round != core::GameRound::kFlop) ++deal_layers;
+            board_mask |= dealt_mask;
+            node_index = node.first_child;
+            at_street_start = true;
+        } else {
+            throw std::invalid_argument("ExtractSubgame: the path runs past the end of the tree at '" + step + "'.");
+        }
+    }
+    const tree::FlatNode& cut = flat_tree_->Node(node_index);
+    if (!at_street_start || cut.type != core::GameTreeNodeType::kAction || cut.num_children == 0) {
+        throw std::invalid_argument("ExtractSubgame: the path must end at the start of a betting round.");
+    }
+    subgame.round = cut.round;
+    subgame.pot = cut.pot;
+
+    // Deals skipped by isomorphism are evaluated on their canonical deal,
+    // with every hand moved onto its suit-swapped partner.
+    std::vector<std::pair<int, int>> swaps;
+    size_t eval_deal_index = deal_index;
+    uint64_t eval_board_mask = board_mask;
+    if (config_.use_isomorphism && deal_layers > 0) {
+        eval_deal_index = CanonicalDeal(deal_index, deal_layers, swaps);
+        eval_board_mask = initial_board_mask_;
+        for (uint64_t cards = board_mask & ~initial_board_mask_; cards != 0; cards &= cards - 1) {
+            int card = core::LowestCard(cards);
+            for (const auto& swap : swaps) card = SwapSuit(card, swap.first, swap.second);
+            eval_board_mask |= 1ULL << card;
+        }
+    }
+    std::array<std::vector<double>, 2> eval_reach;
+    for (size_t p = 0; p < num_players_; ++p) {
+        eval_reach[p].assign(num_hands_[p], 0.0);
+        for (size_t h = 0; h < num_hands_[p]; ++h) eval_reach[p][SwappedHand(p, h, swaps)] = reach[p][h];
+    }
+    const ReachPointers eval_reach_probs = {eval_reach[0].data(), eval_reach[1].data()};
+    const ReachSums eval_reach_sums = {kernels::Sum(eval_reach[0].data(), num_hands_[0]),
+                                       kernels::Sum(eval_reach[1].data(), num_hands_[1])};
+
+    evaluating_best_response_ = true;
+    evaluating_average_ = true;
+    for (size_t p = 0; p < num_players_; ++p) {
+        std::vector<double> utility(num_hands_[p]);
+        UtilityPointers outputs = {nullptr, nullptr};
+        outputs[p] = utility.data();
+        try {
+            RunTraversal(node_index, eval_reach_probs, eval_reach_sums, outputs, IterationDiscounts(),
+                         eval_board_mask, chance_reach, eval_deal_index);
+        } catch (...) {
+            evaluating_best_response_ = false;
+            evaluating_average_ = false;
+            throw;
+        }
+        // Counterfactual values over the opponent reach they were weighed with.
+        const size_t opponent = 1 - p;
+        std::vector<double> compatible_reach(num_hands_[p]);
+        FoldUtilityLinear(pcm_->GetPlayerRange(p), pcm_->GetPlayerRange(opponent), reach[opponent].data(),
+                          chance_reach, compatible_reach.data());
+        const auto& range = pcm_->GetPlayerRange(p);
+        for (size_t h = 0; h < num_hands_[p]; ++h) {
+            if (weights[p][h] <= 0.0) continue;
+            const double value = utility[SwappedHand(p, h, swaps)];
+            subgame.ranges[p].emplace_back(range[h].Card1Int(), range[h].Card2Int(), weights[p][h]);
+            subgame.values[p].push_back(compatible_reach[h] > 1e-300 ? value / compatible_reach[h] : 0.0);
+        }
+    }
+    evaluating_best_response_ = false;
+    evaluating_average_ = false;
+    return subgame;
+}
+
+void PCfrSolver::SetResolveGadget(size_t player, std::vector<double> values) {
+    if (player >= num_players_) throw std::invalid_argument("SetResolveGadget: player must be 0 or 1.");
+    if (values.size() != pcm_->GetPlayerRange(player).size()) {
+        throw std::invalid_argument("SetResolveGadget: expected one value per hand of the player's range.");
+    }
+    resolve_gadget_ = std::make_unique<ResolveGadget>();
+    resolve_gadget_->player = player;
+    resolve_gadget_->values = std::move(values);
+}
+
+std::vector<double> PCfrSolver::GetResolveGadgetEnterProbabilities() const {
+    std::vector<double> probabilities;
+    if (!resolve_gadget_) return probabilities;
+    for (size_t h = 0; h < resolve_gadget_->regrets.size() / 2; ++h) {
+        probabilities.push_back(ResolveGadgetEnterProbability(h));
+    }
+    return probabilities;
+}
+
+nodes::ActionNode& PCfrSolver::ActionNodeAt(const std::vector<std::string>& path, const std::string& caller) const {
+    std::shared_ptr<core::GameTreeNode> node = game_tree_->GetRoot();
+    // Chance nodes are passed through, including after the last step.
+    auto skip_chance = [&]() {
+        while (auto chance_node = std::dynamic_pointer_cast<nodes::ChanceNode>(node)) node = chance_node->GetChild();
+    };
+    skip_chance();
+    for (const std::string& step : path) {
+        auto action_node = std::dynamic_pointer_cast<nodes::ActionNode>(node);
+        if (!action_node) throw std::invalid_argument(caller + ": the path leaves the betting at '" + step + "'.");
+        const auto& actions = action_node->GetActions();
+        size_t a = 0;
+        while (a < actions.size() && actions[a].ToString() != step) ++a;
+        if (a == actions.size()) {
+            std::string expected;
+            for (const auto& action : actions) expected += (expected.empty() ? "" : ", ") + action.ToString();
+            throw std::invalid_argument(caller + ": no action '" + step + "' here (expected one of: " + expected +
+                                        ").");
+        }
+        node = action_node->GetChildren()[a];
+        skip_chance();
+    }
+    auto action_node = std::dynamic_pointer_cast<nodes::ActionNode>(node);
+    if (!action_node) throw std::invalid_argument(caller + ": the path does not end at an action node.");
+    return *action_node;
+}
+
+const nodes::ActionNode& PCfrSolver::FindActionNode(const std::vector<std::string>& path) const {
+    return ActionNodeAt(path, "FindActionNode");
+}
+
+std::shared_ptr<const HandGrid> PCfrSolver::GetHandGrid(const std::vector<std::string>& path, size_t deal) const {
+    const nodes::ActionNode& target = ActionNodeAt(path, "GetHandGrid");
+    if (deal >= target.GetNumPossibleDeals()) {
+        throw std::invalid_argument("GetHandGrid: the node has no deal slot " + std::to_string(deal) + ".");
+    }
+    {
+        std::lock_guard<std::mutex> lock(hand_grid_mutex_);
+        auto cached = hand_grids_.find({&target, deal});
+        if (cached != hand_grids_.end()) return cached->second;
+    }
+
+    // The player's own decisions on the way, after how many turn and river
+    // deals each. ActionNodeAt has checked the path.
+    struct Decision {
+        const nodes::ActionNode* node;
+        size_t action;
+        int deal_layers;
+    };
+    const size_t player = target.GetPlayerIndex();
+    std::vector<Decision> decisions;
+    int deal_layers = 0;
+    std::shared_ptr<core::GameTreeNode> node = game_tree_->GetRoot();
+    auto skip_chance = [&]() {
+        while (auto chance_node = std::dynamic_pointer_cast<nodes::ChanceNode>(node)) {
+            if (chance_node->GetRound() != core::GameRound::kFlop) ++deal_layers;
+            node = chance_node->GetChild();
+        }
+    };
+    skip_chance();
+    for (const std::string& step : path) {
+        const auto* action_node = static_cast<const nodes::ActionNode*>(node.get());
+        const auto& actions = action_node->GetActions();
+        size_t a = 0;
+        while (actions[a].ToString() != step) ++a;
+        if (action_node->GetPlayerIndex() == player) decisions.push_back({action_node, a, deal_layers});
+        node = action_node->GetChildren()[a];
+        skip_chance();
+    }
+
+    // Fills 'strategy' (and 'evs', if given and set) hand-major over the
+    // player's range for a node and deal slot: its average strategy, the
+    // locked one on locked nodes, uniform on untrained ones. Returns whether
+    // the slot has a strategy of its own.
+    auto strategy_of = [&](const nodes::ActionNode& action_node, size_t node_deal, int node_layers,
+                           std::vector<double>& strategy, std::vector<double>* evs) {
+        const size_t num_actions = action_node.GetActions().size();
+        const size_t num_hands = pcm_->GetPlayerRange(player).size();
+        std::vector<std::pair<int, int>> swaps;
+        auto trainable = DealTrainable(action_node, node_deal, node_layers, swaps);
+        const std::vector<double>* locked = action_node.GetLockedStrategy();
+        // Copied right away: lazy trainables return a per-thread buffer.
+        std::vector<double> canonical_strategy = locked ? *locked
+                                               : trainable ? trainable->GetAverageStrategy()
+                                                           : std::vector<double>();
+        if (canonical_strategy.size() != num_actions * num_hands) {
+            strategy.assign(num_actions * num_hands, 1.0 / static_cast<double>(num_actions));
+        } else {
+            strategy.resize(num_actions * num_hands);
+            for (size_t h = 0; h < num_hands; ++h) {
+                const size_t source = SwappedHand(player, h, swaps);
+                std::copy(canonical_strategy.begin() + source * num_actions,
+                          canonical_strategy.begin() + (source + 1) * num_actions,
+                          strategy.begin() + h * num_actions);
+            }
+        }
+        if (!evs) return trainable != nullptr || locked != nullptr;
+        const std::vector<double> canonical_evs = trainable ? trainable->GetEvs() : std::vector<double>();
+        evs->clear();
+        if (canonical_evs.size() == num_actions * num_hands) {
+            evs->resize(num_actions * num_hands);
+            for (size_t h = 0; h < num_hands; ++h) {
+                const size_t source = SwappedHand(player, h, swaps);
+                std::copy(canonical_evs.begin() + source * num_actions, canonical_evs.begin() + (source + 1) * num_actions,
+                          evs->begin() + h * num_actions);
+            }
+        }
+        return trainable != nullptr || locked != nullptr;
+    };
+
+    std::vector<double> strategy;
+    std::vector<double> evs;
+    if (!strategy_of(target, deal, deal_layers, strategy, &evs)) return nullptr;
+
+    // Reach: range weights, none for hands holding a dealt card, times the
+    // chosen actions' probabilities. A deal slot's last card is its least
+    // significant digit, so an earlier node's slot drops the later cards.
+    const auto& range = pcm_->GetPlayerRange(player);
+    std::vector<double> reach(range.size());
+    for (size_t h = 0; h < range.size(); ++h) reach[h] = std::max(0.0, range[h].Weight());
+    const size_t num_deal_cards = deal_cards_.size();
+    if (target.GetNumPossibleDeals() > 1) {
+        uint64_t dealt_mask = 0;
+        size_t rest = deal;
+        for (int layer = 0; layer < deal_layers; ++layer) {
+            dealt_mask |= 1ULL << deal_cards_[rest % num_deal_cards];
+            rest /= num_deal_cards;
+        }
+        for (size_t h = 0; h < range.size(); ++h) {
+            if (range[h].GetBoardMask() & dealt_mask) reach[h] = 0.0;
+        }
+    }
+    std::vector<double> decision_strategy;
+    for (const Decision& decision : decisions) {
+        size_t decision_deal = 0;
+        if (decision.node->GetNumPossibleDeals() > 1) {
+            decision_deal = deal;
+            for (int layer = decision.deal_layers; layer < deal_layers; ++layer) decision_deal /= num_deal_cards;
+        }
+        strategy_of(*decision.node, decision_deal, decision.deal_layers, decision_strategy, nullptr);
+        const size_t num_actions = decision.node->GetActions().size();
+        for (size_t h = 0; h < range.size(); ++h) reach[h] *= decision_strategy[h * num_actions + decision.action];
+    }
+
+    auto grid = std::make_shared<const HandGrid>(
+        AggregateHandGrid(range, reach, strategy, evs, target.GetActions().size()));
+    std::lock_guard<std::mutex> lock(hand_grid_mutex_);
+    return hand_grids_.emplace(std::make_pair(&target, deal), std::move(grid)).first->second;
+}
+
+void PCfrSolver::LockNode(const std::vector<std::string>& path, std::vector<double> strategy) {
+    if (config_.use_isomorphism) {
+        throw std::logic_error("LockNode: not supported with use_isomorphism.");
+    }
+    nodes::ActionNode& action_node = ActionNodeAt(path, "LockNode");
+    try {
+        action_node.LockStrategy(std::move(strategy));
+    } catch (const std::invalid_argument& e) {
+        throw std::invalid_argument(std::string("LockNode: ") + e.what());
+    }
+    ClearHandGrids();
+}
+
+void PCfrSolver::UnlockNode(const std::vector<std::string>& path) {
+    ActionNodeAt(path, "UnlockNode").Unlock();
+    ClearHandGrids();
+}
+
+void PCfrSolver::SetSnapshotSubtree(const std::vector<std::string>& path, int max_depth) {
+    std::vector<SnapshotNode> snapshot_nodes;
+    std::function<void(nodes::ActionNode&, std::vector<std::string>&, int)> collect =
+        [&](nodes::ActionNode& node, std::vector<std::string>& node_path, int depth) {
+            snapshot_nodes.push_back({node_path, &node});
+            if (max_depth >= 0 && depth >= max_depth) return;
+            const auto& children = node.GetChildren();
+            for (size_t a = 0; a < children.size(); ++a) {
+                auto child = std::dynamic_pointer_cast<nodes::ActionNode>(children[a]);
+                if (!child) continue; // Chance and terminal nodes end the region
+                node_path.push_back(node.GetActions()[a].ToString());
+                collect(*child, node_path, depth + 1);
+                node_path.pop_back();
+            }
+        };
+    std::vector<std::string> node_path = path;
+    collect(ActionNodeAt(path, "SetSnapshotSubtree"), node_path, 0);
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    snapshot_nodes_ = std::move(snapshot_nodes);
+}
+
+std::shared_ptr<const StrategySnapshot> PCfrSolver::GetStrategySnapshot() const {
+    return std::atomic_load(&published_snapshot_);
+}
+
+void PCfrSolver::PublishStrategySnapshot() {
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    if (snapshot_nodes_.empty()) return;
+    std::shared_ptr<StrategySnapshot> snapshot = std::move(spare_snapshot_);
+    if (!snapshot) snapshot = std::make_shared<StrategySnapshot>();
+    snapshot->iteration = completed_iterations_;
+    snapshot->nodes.resize(snapshot_nodes_.size());
+    for (size_t i = 0; i < snapshot_nodes_.size(); ++i) {
+        const nodes::ActionNode& node = *snapshot_nodes_[i].node;
+        StrategySnapshot::Node& entry = snapshot->nodes[i];
+        entry.path = snapshot_nodes_[i].path;
+        entry.player = node.GetPlayerIndex();
+        entry.actions.clear();
+        for (const auto& action : node.GetActions()) entry.actions.push_back(action.ToString());
+        entry.strategies.resize(node.GetNumPossibleDeals());
+        for (size_t d = 0; d < entry.strategies.size(); ++d) {
+            auto trainable = node.GetTrainableIfExists(d);
+            if (!trainable) {
+                entry.strategies[d].clear();
+                continue;
+            }
+            const std::vector<double>& average = trainable->GetAverageStrategy();
+            entry.strategies[d].assign(average.begin(), average.end());
+        }
+    }
+    std::shared_ptr<const StrategySnapshot> retired =
+        std::atomic_exchange(&published_snapshot_, std::shared_ptr<const StrategySnapshot>(std::move(snapshot)));
+    // No reader can pick 'retired' up any more; reuse its buffers unless one
+    // still holds it.
+    if (retired && retired.use_count() == 1) spare_snapshot_ = std::const_pointer_cast<StrategySnapshot>(retired);
+}
+
+void PCfrSolver::PrepareResolveGadget() {
+    ResolveGadget& gadget = *resolve_gadget_;
+    const size_t player = gadget.player;
+    const size_t opponent = 1 - player;
+    gadget.base_reach = root_reach_[player];
+    // A value in chips per hand becomes a counterfactual value once weighed
+    // by the opponent reach compatible with the hand.
+    gadget.alternative.resize(num_hands_[player]);
+    FoldUtilityLinear(pcm_->GetPlayerRange(player), pcm_->GetPlayerRange(opponent), root_reach_[opponent].data(),
+                      1.0, gadget.alternative.data());
+    for (size_t h = 0; h < num_hands_[player]; ++h) gadget.alternative[h] *= gadget.values[h];
+    // Kept across Train() calls, so a continued solve resumes the choice.
+    if (gadget.regrets.size() != 2 * num_hands_[player]) gadget.regrets.assign(2 * num_hands_[player], 0.0);
+}
+
+double PCfrSolver::ResolveGadgetEnterProbability(size_t hand) const {
+    const double enter = resolve_gadget_->regrets[2 * hand];
+    const double take = resolve_gadget_->regrets[2 * hand + 1];
+    return enter + take > 0.0 ? enter / (enter + take) : 0.5;
+}
+
+void PCfrSolver::ApplyResolveGadget(ReachSums& root_reach_sums) {
+    const size_t player = resolve_gadget_->player;
+    for (size_t h = 0; h < num_hands_[player]; ++h) {
+        root_reach_[player][h] = resolve_gadget_->base_reach[h] * ResolveGadgetEnterProbability(h);
+    }
+    root_reach_sums[player] = kernels::Sum(root_reach_[player].data(), num_hands_[player]);
+}
+
+void PCfrSolver::UpdateResolveGadget(const double* enter_utility) {
+    ResolveGadget& gadget = *resolve_gadget_;
+    for (size_t h = 0; h < num_hands_[gadget.player]; ++h) {
+        const double enter = ResolveGadgetEnterProbability(h);
+        const double value = enter * enter_utility[h] + (1.0 - enter) * gadget.alternative[h];
+        // Regret matching+: regrets are floored at zero.
+        gadget.regrets[2 * h] = std::max(0.0, gadget.regrets[2 * h] + enter_utility[h] - value);
+        gadget.regrets[2 * h + 1] = std::max(0.0, gadget.regrets[2 * h + 1] + gadget.alternative[h] - value);
+    }
+}
+
+// --- Private Recursive CFR Function ---
+void PCfrSolver::RunTraversal(uint32_t node_index, const ReachPointers& reach_probs, const ReachSums& reach_sums,
+                              const UtilityPointers& utility, const IterationDiscounts& discounts,
+                              uint64_t board_mask, double chance_reach, size_t deal_index) {
+    if (config_.parallel_level != ParallelLevel::kTasks) {
+        cfr_utility(node_index, reach_probs, reach_sums, utility, discounts, board_mask, chance_reach, deal_index, 0);
+        return;
+    }
+    // One thread starts the traversal; the team picks up its tasks.
+    std::exception_ptr error;
+    #pragma omp parallel
+    #pragma omp single
+    {
+        try {
+            cfr_utility(node_index, reach_probs, reach_sums, utility, discounts, board_mask, chance_reach,
+                        deal_index, 0);
+        } catch (...) {
+            CaptureFirstError(error);
+        }
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+void PCfrSolver::cfr_utility(
+    uint32_t node_index,
+    const ReachPointers& reach_probs,
+    const ReachSums& reach_sums,
+    const UtilityPointers& utility,
+    const IterationDiscounts& discounts,
+    uint64_t current_board_mask,
+    double chance_reach,
+    size_t deal_index,
+    size_t depth)
+{
+    if (node_index >= flat_tree_->Size()) {
+        throw std::logic_error("cfr_utility called with an invalid node index.");
+    }
+    const tree::FlatNode& node = flat_tree_->Node(node_index);
+
+    bool is_terminal = false;
+    core::GameTreeNodeType node_type = node.type;
+    if (node_type == core::GameTreeNodeType::kTerminal ||
+        node_type == core::GameTreeNodeType::kShowdown) {
+        is_terminal = true;
+    }
+
+    // Counterfactual utility needs the opponent's reach, but regrets need the
+    // values of actions a player currently never takes and the average
+    // strategy keeps accumulating where only the opponent stopped coming. So a
+    // subtree is only skipped once neither player can reach it.
+    if (!is_terminal && reach_sums[0] < 1e-12 && reach_sums[1] < 1e-12) {
+        for (size_t p = 0; p < num_players_; ++p) {
+            if (utility[p]) std::fill(utility[p], utility[p] + num_hands_[p], 0.0);
+        }
+        return;
+    }
+
+    TraversalStatsScope stats_scope(evaluating_best_response_ ? nullptr : traversal_stats_collector_.get(), node_type,
+                                    node.round, (utility[0] ? num_hands_[0] : 0) + (utility[1] ? num_hands_[1] : 0));
+    switch (node_type) {
+        case core::GameTreeNodeType::kTerminal:
+            cfr_terminal_node(node, reach_probs, reach_sums, utility, chance_reach);
+            return;
+        case core::GameTreeNodeType::kShowdown:
+            cfr_showdown_node(node, reach_probs, reach_sums, utility, current_board_mask, chance_reach);
+            return;
+        case core::GameTreeNodeType::kChance:
+            if (node.num_children == 0) {
+                cfr_leaf_node(node, node_index, reach_probs, reach_sums, utility, current_board_mask, chance_reach);
+                return;
+            }
+            cfr_chance_node(node, reach_probs, reach_sums, utility, discounts, current_board_mask, chance_reach, deal_index, depth);
+            return;
+        case core::GameTreeNodeType::kAction:
+            if (evaluating_best_response_) {
+                best_response_action_node(node, reach_probs, reach_sums, utility, current_board_mask, chance_reach, deal_index, depth);
+                return;
+            }
+            cfr_action_node(node, reach_probs, reach_sums, utility, discounts, current_board_mask, chance_reach, deal_index, depth);
+            return;
+        default:
+            throw std::logic_error("cfr_utility encountered unknown node type.");
+    }
+}
+
+
+// --- Action Node Helper ---
+void PCfrSolver::cfr_action_node(
+    const tree::FlatNode& node,
+    const ReachPointers& reach_probs,
+    const ReachSums& reach_sums,
+    const UtilityPointers& utility,
+    const IterationDiscounts& discounts,
+    uint64_t current_board_mask,
+    double chance_reach,
+    size_t deal_index,
+    size_t depth)
+{
+    nodes::ActionNode& action_node = flat_tree_->Action(node);
+    size_t acting_player = node.player;
+    size_t opponent_player = 1 - acting_player;
+    size_t num_actions = node.num_children;
+
+    for (size_t p = 0; p < num_players_; ++p) {
+        if (utility[p]) std::fill(utility[p], utility[p] + num_hands_[p], 0.0);
+    }
+
+    const auto* player_range_ptr = action_node.GetPlayerRangeRaw();
+    if (!player_range_ptr) throw std::runtime_error("Player range not set on ActionNode.");
+    size_t acting_player_num_hands = player_range_ptr->size();
+
+    if (num_actions == 0 || acting_player_num_hands == 0) {
+        return;
+    }
+    if (acting_player >= num_players_ || num_hands_[acting_player] != acting_player_num_hands) {
+        throw std::logic_error("Reach probability size mismatch for acting player in cfr_action_node.");
+    }
+
+    auto trainable = TrainableFor(action_node, deal_index);
+    if (!trainable) throw std::runtime_error("Failed to get Trainable object.");
+
+    // Children only touch deeper levels, so this level's buffers stay intact
+    // across the recursive calls below.
+    TraversalScratch::Level& level = TraversalScratch::ForCurrentThread().At(depth);
+
+    // Either the trainable's own cache, untouched until the update below, or
+    // decoded into this level's buffer.
+    level.strategy.resize(num_actions * acting_player_num_hands);
+    const double* strategy = trainable->CurrentStrategy(level.strategy.data());
+
+    // Only the acting player's reach changes; the other pointer is passed
+    // through. One row per action so children may run as concurrent tasks.
+    std::vector<double>& acting_reach = level.reach[acting_player];
+    acting_reach.resize(num_actions * acting_player_num_hands);
+
+    // Child utilities, action-major, for each player being computed.
+    for (size_t p = 0; p < num_players_; ++p) {
+        if (utility[p]) level.child_utility[p].resize(num_actions * num_hands_[p]);
+    }
+
+    // Only in the acting player's own traversal: its zero reach into a pruned
+    // child would also zero the opponent's utility, but not the opponent's
+    // average strategy below it.
+    bool prune = pruning_this_iteration_ && utility[acting_player] && !utility[opponent_player];
+    // Inside the traversal's region, even a one-thread one, so the same
+    // subtrees become tasks, summed the same way, for any thread count.
+    bool spawn_tasks = config_.parallel_level == ParallelLevel::kTasks && omp_get_level() > 0;
+    std::exception_ptr task_error; // First exception of the tasks below
+    for (size_t a = 0; a < num_actions; ++a) {
+        UtilityPointers child_utility = {nullptr, nullptr};
+        for (size_t p = 0; p < num_players_; ++p) {
+            if (utility[p]) child_utility[p] = level.child_utility[p].data() + a * num_hands_[p];
+        }
+        if (prune && ActionNeverPlayed(strategy, num_actions, a, acting_player_num_hands)) {
+            // Weighted by zero below; the regret row is set after the node utility.
+            std::fill(child_utility[acting_player], child_utility[acting_player] + acting_player_num_hands, 0.0);
+            continue;
+        }
+        double* child_reach = acting_reach.data() + a * acting_player_num_hands;
+        kernels::MultiplyByActionStrategy(child_reach, reach_probs[acting_player],
+                                          strategy, num_actions, a, acting_player_num_hands);
+        ReachPointers next_reach_probs = reach_probs;
+        next_reach_probs[acting_player] = child_reach;
+        ReachSums next_reach_sums = reach_sums;
+        next_reach_sums[acting_player] = reach_sums[acting_player] > 0.0
+                                             ? kernels::Sum(child_reach, acting_player_num_hands) : 0.0;
+        const uint32_t child = node.first_child + static_cast<uint32_t>(a);
+        if (spawn_tasks && SubtreeWork(child) >= config_.task_cutoff) {
+            #pragma omp task default(shared) firstprivate(child, child_utility, next_reach_probs, next_reach_sums)
+            {
+                TraversalScratch::TaskScope scope;
+                try {
+                    cfr_utility(child, next_reach_probs, next_reach_sums, child_utility, discounts,
+                                current_board_mask, chance_reach, deal_index, depth + 1);
+                } catch (...) {
+                    CaptureFirstError(task_error);
+                }
+            }
+        } else {
+            cfr_utility(child, next_reach_probs, next_reach_sums, child_utility, discounts, current_board_mask,
+                        chance_reach, deal_index, depth + 1);
+        }
+    }
+    if (spawn_tasks) {
+        #pragma omp taskwait
+        if (task_error) std::rethrow_exception(task_error);
+    }
+
+    // Acting player: strategy-weighted sum. Other player: the acting player's
+    // strategy is already folded into the reach passed down, so a plain sum.
+    for (size_t p = 0; p < num_players_; ++p) {
+        if (!utility[p]) continue;
+        for (size_t a = 0; a < num_actions; ++a) {
+            const double* child_utility = level.child_utility[p].data() + a * num_hands_[p];
+            if (p == acting_player) {
+                kernels::AccumulateWeightedByAction(utility[p], strategy, num_actions, a,
+                                                    child_utility, num_hands_[p]);
+            } else {
+                kernels::Accumulate(utility[p], child_utility, num_hands_[p]);
+            }
+        }
+    }
+
+    // A locked node plays its fixed strategy and learns nothing.
+    if (utility[acting_player] && !action_node.IsLocked()) {
+        std::vector<double>& weighted_regrets = level.regrets;
+        weighted_regrets.resize(num_actions * acting_player_num_hands);
+        std::vector<double>& player_reach_weights_vec = level.reach_weights;
+        player_reach_weights_vec.resize(acting_player_num_hands);
+        kernels::Scale(player_reach_weights_vec.data(), reach_probs[acting_player],
+                       chance_reach, acting_player_num_hands);
+        for (size_t a = 0; a < num_actions; ++a) {
+            double* action_utility = level.child_utility[acting_player].data() + a * acting_player_num_hands;
+            if (prune && ActionNeverPlayed(strategy, num_actions, a, acting_player_num_hands)) {
+                // No new regret for a pruned action, only the usual discount.
+                std::copy(utility[acting_player], utility[acting_player] + acting_player_num_hands, action_utility);
+            }
+            kernels::StoreActionRegrets(weighted_regrets.data(), num_actions, a, action_utility,
+                                        utility[acting_player], acting_player_num_hands);
+        }
+        // 'strategy' may point into the dense trainable, kept alive until
+        // the update.
+        std::shared_ptr<Trainable> sparse =
+            sparsify_this_iteration_
+                ? SparsifyTrainable(action_node, deal_index, *trainable, player_reach_weights_vec.data())
+                : nullptr;
+        (sparse ? sparse : trainable)->UpdateFromVisit(weighted_regrets.data(), strategy,
+                                                       player_reach_weights_vec.data(), discounts);
+    }
+}
+
+
+// --- Best Response Action Node Helper ---
+void PCfrSolver::best_response_action_node(
+    const tree::FlatNode& node,
+    const ReachPointers& reach_probs,
+    const ReachSums& reach_sums,
+    const UtilityPointers& utility,
+    uint64_t current_board_mask,
+    double chance_reach,
+    size_t deal_index,
+    size_t depth)
+{
+    size_t acting_player = node.player;
+    size_t num_actions = node.num_children;
+    size_t acting_player_num_hands = num_hands_[acting_player];
+
+    // The responder maximizes, unless the average strategies are evaluated
+    // or the node is locked, which binds the responder too.
+    const nodes::ActionNode& action_node = flat_tree_->Action(node);
+    const std::vector<double>* locked_strategy = action_node.GetLockedStrategy();
+    bool responder_acts = utility[acting_player] != nullptr;
+    bool maximize = responder_acts && !evaluating_average_ && !locked_strategy;
+    TraversalScratch::Level& level = TraversalScratch::ForCurrentThread().At(depth);
+    for (size_t p = 0; p < num_players_; ++p) {
+        if (!utility[p]) continue;
+        std::fill(utility[p], utility[p] + num_hands_[p], p == acting_player && maximize && num_actions > 0
+                                                             ? -std::numeric_limits<double>::infinity() : 0.0);
+        level.child_utility[p].resize(num_hands_[p]);
+    }
+    if (num_actions == 0 || acting_player_num_hands == 0) {
+        for (size_t p = 0; p < num_players_; ++p) {
+            if (utility[p]) std::fill(utility[p], utility[p] + num_hands_[p], 0.0);
+        }
+        return;
+    }
+
+    // The responder's own reach is left untouched: its value at a node must
+    // not depend on how often the average strategy goes there.
+    std::vector<double>& strategy = level.strategy;
+    if (!maximize) {
+        auto trainable = locked_strategy ? nullptr : action_node.GetTrainableIfExists(deal_index);
+        // Copied right away: lazy trainables return a per-thread buffer.
+        const std::vector<double>* average = trainable ? &trainable->GetAverageStrategy() : locked_strategy;
+        if (average && average->size() == num_actions * acting_player_num_hands) {
+            strategy.assign(average->begin(), average->end());
+        } else {
+            strategy.assign(num_actions * acting_player_num_hands, 1.0 / static_cast<double>(num_actions));
+        }
+        if (!responder_acts) level.reach[acting_player].resize(acting_player_num_hands);
+    }
+
+    // Action values of the responder's hands, hand-major, for ComputeEvs.
+    std::shared_ptr<Trainable> ev_trainable;
+    std::vector<double> action_values;
+    if (computing_evs_ && responder_acts && (ev_max_depth_ < 0 || depth <= static_cast<size_t>(ev_max_depth_))) {
+        ev_trainable = action_node.GetTrainableIfExists(deal_index);
+        if (ev_trainable) action_values.resize(num_actions * acting_player_num_hands);
+    }
+
+    for (size_t a = 0; a < num_actions; ++a) {
+        UtilityPointers child_utility = {nullptr, nullptr};
+        for (size_t p = 0; p < num_players_; ++p) {
+            if (utility[p]) child_utility[p] = level.child_utility[p].data();
+        }
+        ReachPointers next_reach_probs = reach_probs;
+        ReachSums next_reach_sums = reach_sums;
+        if (!responder_acts) {
+            kernels::MultiplyByActionStrategy(level.reach[acting_player].data(), reach_probs[acting_player],
+                                              strategy.data(), num_actions, a, acting_player_num_hands);
+            next_reach_probs[acting_player] = level.reach[acting_player].data();
+            next_reach_sums[acting_player] = kernels::Sum(next_reach_probs[acting_player], acting_player_num_hands);
+        }
+        cfr_utility(node.first_child + static_cast<uint32_t>(a), next_reach_probs, next_reach_sums, child_utility,
+                    IterationDiscounts(), current_board_mask, chance_reach, deal_index, depth + 1);
+        // Responder: best action per hand, or its average strategy's mix.
+        // Other player: its strategy is in the reach.
+        for (size_t p = 0; p < num_players_; ++p) {
+            if (!utility[p]) continue;
+            if (p == acting_player && maximize) {
+                for (size_t h = 0; h < num_hands_[p]; ++h) {
+                    utility[p][h] = std::max(utility[p][h], child_utility[p][h]);
+                }
+            } else if (p == acting_player) {
+                for (size_t h = 0; h < num_hands_[p]; ++h) {
+                    utility[p][h] += strategy[h * num_actions + a] * child_utility[p][h];
+                }
+            } else {
+                kernels::Accumulate(utility[p], child_utility[p], num_hands_[p]);
+            }
+        }
+        if (!action_values.empty()) {
+            for (size_t h = 0; h < acting_player_num_hands; ++h) {
+                action_values[h * num_actions + a] = child_utility[acting_player][h];
+            }
+        }
+    }
+
+    if (!action_values.empty()) {
+        // Counterfactual values over the opponent reach they were weighed with.
+        const size_t opponent = 1 - acting_player;
+        std::vector<double> compatible_reach(acting_player_num_hands);
+        FoldUtilityLinear(pcm_->GetPlayerRange(acting_player), pcm_->GetPlayerRange(opponent),
+                          reach_probs[opponent], chance_reach, compatible_reach.data());
+        for (size_t h = 0; h < acting_player_num_hands; ++h) {
+            const double scale = compatible_reach[h] > 1e-300 ? 1.0 / compatible_reach[h] : 0.0;
+            for (size_t a = 0; a < num_actions; ++a) action_values[h * num_actions + a] *= scale;
+        }
+        ev_trainable->SetEv(action_values);
+    }
+}
+
+
+// --- Chance Node Helper ---
+void PCfrSolver::cfr_chance_node(
+    const tree::FlatNode& node,
+    const ReachPointers& reach_probs,
+    const ReachSums& reach_sums,
+    const UtilityPointers& utility,
+    const IterationDiscounts& discounts,
+    uint64_t current_board_mask,
+    double parent_chance_reach,
+    size_t deal_index,
+    size_t depth)
+{
+    for (size_t p = 0; p < num_players_; ++p) {
+        if (utility[p]) std::fill(utility[p], utility[p] + num_hands_[p], 0.0);
+    }
+
+    // --- Get necessary info from the node ---
+    if (node.num_children == 0) throw std::logic_error("Chance node has no child.");
+    const uint32_t child = node.first_child;
+
+    core::GameRound round_after_chance = node.round;
+    TraceSpan street_span(trace_recorder_.get(),
+                          round_after_chance == core::GameRound::kRiver  ? "river"
+                          : round_after_chance == core::GameRound::kTurn ? "turn"
+                                                                         : "flop",
+                          "street");
+    int num_cards_to_deal = 0;
+    if (round_after_chance == core::GameRound::kFlop) num_cards_to_deal = 3;
+    else if (round_after_chance == core::GameRound::kTurn) num_cards_to_deal = 1;
+    else if (round_after_chance == core::GameRound::kRiver) num_cards_to_deal = 1;
+    else {
+        std::cerr << "[ERROR] cfr_chance_node: Invalid round after chance: " << core::GameTreeNode::GameRoundToString(round_after_chance) << std::endl;
+        throw std::logic_error("Invalid round after ChanceNode in cfr_chance_node.");
+    }
 
-            // Find the opponent's corresponding RiverHandCombo
-            // (read-only access to oppo_orig_idx_to_river_idx map)
-            auto oppo_map_it = oppo_orig_idx_to_river_idx.find(oppo_orig_idx);
-            if (oppo_map_it == oppo_orig_idx_to_river_idx.end()) {
-                // Opponent hand invalid on river (blocked by final board), skip comparison
-                continue;
+    // --- Look up the deals of this board ---
+    // Boards missing from the table are dealt into this level's buffer,
+    // which this thread's workers below never use.
+    TraversalScratch::Level& level = TraversalScratch::ForCurrentThread().At(depth);
+    const std::vector<uint64_t>* outcome_list = &level.outcomes;
+    std::array<int, core::kNumSuits> untabled_representative;
+    const std::array<int, core::kNumSuits>* representative = &untabled_representative;
+    double outcome_probability = 0.0;
+    if (const ChanceDeals* tabled = chance_deals_.find(current_board_mask)) {
+        outcome_list = &tabled->outcomes;
+        representative = &tabled->suit_representative;
+        outcome_probability = tabled->outcome_probability;
+    } else {
+        outcome_probability = BuildChanceDeals(current_board_mask, num_cards_to_deal, level.outcomes,
+                                               untabled_representative);
+    }
+    // Public chance sampling: the drawn outcomes stand in for all of them.
+    if (config_.sampled_chance_outcomes > 0 && num_cards_to_deal == 1 && !evaluating_best_response_ &&
+        outcome_list->size() > static_cast<size_t>(config_.sampled_chance_outcomes)) {
+        outcome_probability *= SampleChanceOutcomes(*outcome_list, current_board_mask, level.sampled_outcomes);
+        outcome_list = &level.sampled_outcomes;
+    }
+    const std::vector<uint64_t>& outcomes = *outcome_list;
+    const std::array<int, core::kNumSuits>& suit_representative = *representative;
+    if (outcomes.empty()) {
+        return;
+    }
+
+    // Distributed solving (see SetTransport): the first single-card deal on
+    // each path is split among the ranks, round-robin over the outcomes
+    // evaluated below, and their utilities are summed across ranks.
+    // No single card was dealt before this deal if the board is still the
+    // initial one or at most a flop.
+    const bool split_outcomes = transport_ && transport_->Size() > 1 && num_cards_to_deal == 1 &&
+                                (current_board_mask == initial_board_mask_ ||
+                                 core::CountCards(current_board_mask) <= 3);
+    uint64_t owned_outcomes = ~0ULL;
+    if (split_outcomes) {
+        owned_outcomes = 0;
+        int ordinal = 0;
+        for (uint64_t outcome : outcomes) {
+            int outcome_suit = core::LowestCard(outcome) % core::kNumSuits;
+            if (suit_representative[outcome_suit] != outcome_suit) continue;
+            if (ordinal++ % transport_->Size() == transport_->Rank()) owned_outcomes |= outcome;
+        }
+    }
+
+    double next_node_chance_reach = parent_chance_reach * outcome_probability;
+
+    // An all-in on the flop: turn and river come with no betting between,
+    // so each two-card board is evaluated once rather than once per dealing
+    // order, in one batch (split over the threads where the outcome loop
+    // would fan out). Isomorphic, sampled and rank-split deals keep the
+    // outcome loop.
+    const size_t river_choices = outcomes.size() - 1; // Cards left after the turn, as BuildChanceDeals counts them
+    if (node.runout_streets == 2 && num_cards_to_deal == 1 && river_choices > 4 && !config_.use_isomorphism &&
+        config_.sampled_chance_outcomes == 0 && !split_outcomes) {
+        const bool parallel = config_.parallel_level == ParallelLevel::kOutermostChance && !omp_in_parallel() &&
+                              omp_get_level() == 0 && ChanceWork(child, outcomes.size()) >= parallel_cutoff_;
+        cfr_two_card_runout(flat_tree_->Node(flat_tree_->Node(child).first_child), reach_probs, reach_sums,
+                            utility, outcomes, current_board_mask,
+                            next_node_chance_reach / static_cast<double>(river_choices - 4), parallel, level);
+        return;
+    }
+
+    // --- Task Mode: one task per outcome ---
+    // Each task writes its own utility rows; rows are reduced after taskwait.
+    if (config_.parallel_level == ParallelLevel::kTasks && num_cards_to_deal == 1 &&
+        omp_get_level() > 0 && SubtreeWork(child) >= config_.task_cutoff) {
+        for (size_t p = 0; p < num_players_; ++p) {
+            if (utility[p]) level.outcome_utility[p].assign(outcomes.size() * num_hands_[p], 0.0);
+        }
+        std::exception_ptr task_error; // First exception of the tasks below
+        for (size_t i = 0; i < outcomes.size(); ++i) {
+            int outcome_suit = core::LowestCard(outcomes[i]) % core::kNumSuits;
+            if (suit_representative[outcome_suit] != outcome_suit) continue;
+            UtilityPointers rows = {nullptr, nullptr};
+            for (size_t p = 0; p < num_players_; ++p) {
+                if (utility[p]) rows[p] = level.outcome_utility[p].data() + i * num_hands_[p];
+            }
+            #pragma omp task default(shared) firstprivate(i, rows)
+            {
+                TraversalScratch::TaskScope scope;
+                TraceSpan outcome_span(trace_recorder_.get(), "chance outcome", "task", core::LowestCard(outcomes[i]));
+                try {
+                    EvaluateChanceOutcome(child, reach_probs, reach_sums, rows, discounts, current_board_mask,
+                                          outcomes[i], next_node_chance_reach, deal_index, num_cards_to_deal,
+                                          depth, TraversalScratch::ForCurrentThread().At(depth));
+                } catch (...) {
+                    CaptureFirstError(task_error);
+                }
+            }
+        }
+        #pragma omp taskwait
+        if (task_error) std::rethrow_exception(task_error);
+        for (size_t i = 0; i < outcomes.size(); ++i) {
+            int outcome_suit = core::LowestCard(outcomes[i]) % core::kNumSuits;
+            if (suit_representative[outcome_suit] != outcome_suit) continue;
+            UtilityPointers rows = {nullptr, nullptr};
+            for (size_t p = 0; p < num_players_; ++p) {
+                if (utility[p]) rows[p] = level.outcome_utility[p].data() + i * num_hands_[p];
+            }
+            AccumulateOutcome(utility, rows, outcome_suit, suit_representative);
+        }
+        return;
+    }
+
+    // --- Parallel Loop over Chance Outcomes ---
+    // See Config::parallel_level for which chance nodes fan out. Where the
+    // fan-out starts, each outcome's utility goes to its own row and the rows
+    // are summed in outcome order after the loop, the order a serial run sums
+    // them in, so results do not depend on the thread count or on which
+    // thread finished first. Regrets and strategy sums need no merge: every
+    // outcome dealt here has its own deal index, so the threads update
+    // disjoint trainables. Below the fan-out the loop is serial, on one
+    // thread even where a nested region could get a team, and each
+    // outcome is summed as it is evaluated. A node below
+    // Config::parallel_cutoff does not fan out; the chance nodes below it
+    // have less work still, so none of them does either.
+    const double chance_work = ChanceWork(child, outcomes.size());
+    // The level test, rather than omp_in_parallel(), also holds inside
+    // one-thread teams, so only the outermost level is the fan-out.
+    const bool fan_out = config_.parallel_level == ParallelLevel::kOutermostChance && num_cards_to_deal == 1 &&
+                         outcomes.size() > 1 && omp_get_level() == 0 && chance_work >= parallel_cutoff_;
+    const bool time_fan_out = fan_out && parallel_tuning_iterations_left_ > 0;
+    // A showdown child needs no traversal per outcome: its boards go to the
+    // showdown backend in one batch, unless this node is the fan-out.
+    if (!fan_out && num_cards_to_deal == 1 && flat_tree_->Node(child).type == core::GameTreeNodeType::kShowdown) {
+        cfr_showdown_runout(flat_tree_->Node(child), reach_probs, reach_sums, utility, outcomes,
+                            suit_representative, owned_outcomes, current_board_mask, next_node_chance_reach, level);
+        if (split_outcomes) {
+            for (size_t p = 0; p < num_players_; ++p) {
+                if (utility[p]) transport_->AllReduceSum(utility[p], num_hands_[p]);
             }
-            // Get opponent river combo data (read-only access to opponent_combos)
-            const auto& oppo_c = opponent_combos[oppo_map_it->second];
+        }
+        return;
+    }
+    TraceRecorder* const outcome_trace = fan_out ? trace_recorder_.get() : nullptr;
+    // NUMA mode: each node's threads take the outcomes dealing its cards.
+    const bool numa_fan_out = fan_out && !numa_.empty();
+    std::unique_ptr<ScopedThreadAffinity> caller_affinity;
+    if (fan_out) {
+        for (size_t p = 0; p < num_players_; ++p) {
+            if (utility[p]) level.outcome_utility[p].resize(outcomes.size() * num_hands_[p]);
+        }
+        level.outcome_evaluated.assign(outcomes.size(), 0);
+    }
+    if (numa_fan_out) {
+        caller_affinity = std::make_unique<ScopedThreadAffinity>();
+        for (size_t node = 0; node < numa_.NumNodes(); ++node) numa_next_outcome_[node] = 0;
+    }
+    // Even a one-thread region cannot pass an exception on; the first one
+    // is rethrown after it.
+    std::exception_ptr outcome_error;
+    #pragma omp parallel if(fan_out)
+    {
+        TraversalScratch::Level& local = TraversalScratch::ForCurrentThread().At(depth);
+        UtilityPointers outcome_sum = {nullptr, nullptr};
+        UtilityPointers child_utility = {nullptr, nullptr};
+        for (size_t p = 0; p < num_players_; ++p) {
+            if (!utility[p] || fan_out) continue;
+            local.outcome_sum[p].assign(num_hands_[p], 0.0);
+            local.utility[p].resize(num_hands_[p]);
+            outcome_sum[p] = local.outcome_sum[p].data();
+            child_utility[p] = local.utility[p].data();
+        }
+
+        auto evaluate = [&](size_t i) {
+            int outcome_suit = num_cards_to_deal == 1 ? core::LowestCard(outcomes[i]) % core::kNumSuits : 0;
+            if (suit_representative[outcome_suit] != outcome_suit || !(outcomes[i] & owned_outcomes)) return;
+            TraceSpan outcome_span(outcome_trace, "chance outcome", "task", core::LowestCard(outcomes[i]));
+            if (fan_out) {
+                for (size_t p = 0; p < num_players_; ++p) {
+                    if (utility[p]) child_utility[p] = level.outcome_utility[p].data() + i * num_hands_[p];
+                }
+            }
+            try {
+                if (EvaluateChanceOutcome(child, reach_probs, reach_sums, child_utility, discounts,
+                                          current_board_mask, outcomes[i], next_node_chance_reach, deal_index,
+                                          num_cards_to_deal, depth, local)) {
+                    if (fan_out) {
+                        level.outcome_evaluated[i] = 1;
+                    } else {
+                        AccumulateOutcome(outcome_sum, child_utility, outcome_suit, suit_representative);
+                    }
+                }
+            } catch (...) {
+                CaptureFirstError(outcome_error);
+            }
+        };
+
+        const double busy_start = time_fan_out ? omp_get_wtime() : 0.0;
+        if (numa_fan_out) {
+            // The node's own outcomes, then those of nodes without threads.
+            const int num_threads = omp_get_num_threads();
+            const size_t node = EnterNumaNode(omp_get_thread_num(), num_threads);
+            const size_t num_nodes = numa_.NumNodes();
+            const size_t nodes_served = static_cast<size_t>(num_threads) < num_nodes ? num_nodes : 1;
+            for (size_t k = 0; k < nodes_served; ++k) {
+                const size_t served = (node + k) % num_nodes;
+                for (size_t i; (i = numa_next_outcome_[served].fetch_add(1)) < outcomes.size();) {
+                    if (NumaNodeOfCard(core::LowestCard(outcomes[i])) == served) evaluate(i);
+                }
+            }
+        } else {
+            #pragma omp for schedule(dynamic) nowait
+            for (size_t i = 0; i < outcomes.size(); ++i) evaluate(i);
+        } // --- End of parallel loop ---
+        if (time_fan_out) {
+            const double busy = omp_get_wtime() - busy_start;
+            #pragma omp atomic
+            tuning_busy_seconds_ += busy;
+        }
 
-            // Determine payoff based on hand ranks
-            double payoff_for_traverser = 0.0;
-            if (trav_c.rank < oppo_c.rank) { // Traverser has better rank (lower is better)
-                payoff_for_traverser = (traverser == 0) ? p0_wins_payoffs[0] : p1_wins_payoffs[1]; // Payoff for P0 if P0 wins, Payoff for P1 if P1 wins
-            } else if (oppo_c.rank < trav_c.rank) { // Opponent has better rank
-                payoff_for_traverser = (traverser == 0) ? p1_wins_payoffs[0] : p0_wins_payoffs[1]; // Payoff for P0 if P1 wins, Payoff for P1 if P0 wins
-            } else { // Ranks are equal (tie)
-                payoff_for_traverser = tie_payoffs[traverser]; // Payoff for the traverser in case of a tie
+        if (!fan_out) {
+            for (size_t p = 0; p < num_players_; ++p) {
+                if (utility[p]) kernels::Accumulate(utility[p], outcome_sum[p], num_hands_[p]);
             }
+        }
+    }
+    if (numa_fan_out) {
+        caller_affinity.reset();
+        TrainableArena::SetThreadLane(0);
+    }
+    if (outcome_error) std::rethrow_exception(outcome_error);
+
+    if (time_fan_out) tuning_work_ += chance_work;
+    if (fan_out) {
+        for (size_t i = 0; i < outcomes.size(); ++i) {
+            if (!level.outcome_evaluated[i]) continue;
+            UtilityPointers rows = {nullptr, nullptr};
+            for (size_t p = 0; p < num_players_; ++p) {
+                if (utility[p]) rows[p] = level.outcome_utility[p].data() + i * num_hands_[p];
+            }
+            AccumulateOutcome(utility, rows, core::LowestCard(outcomes[i]) % core::kNumSuits, suit_representative);
+        }
+    }
 
-            // Accumulate expected value, weighted by opponent's reach probability
-            expected_value_for_hand += reach_probs[opponent_player][oppo_orig_idx] * payoff_for_traverser;
+    if (split_outcomes) {
+        for (size_t p = 0; p < num_players_; ++p) {
+            if (utility[p]) transport_->AllReduceSum(utility[p], num_hands_[p]);
+        }
+    }
+}
 
-        } // --- End inner loop (opponent hands) ---
+double PCfrSolver::SampleChanceOutcomes(const std::vector<uint64_t>& outcomes, uint64_t board_mask,
+                                        std::vector<uint64_t>& sampled) const {
+    // SplitMix64 over the seed, traversal and board; no state is shared
+    // between threads.
+    uint64_t state = config_.sampling_seed ^ (sampling_round_ * 0x9E3779B97F4A7C15ULL) ^
+                     (board_mask * 0xBF58476D1CE4E5B9ULL);
+    auto next_uniform = [&state]() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        z ^= z >> 31;
+        return static_cast<double>(z >> 11) * 0x1.0p-53;
+    };
+    // Selection sampling (Knuth's algorithm S): each outcome is kept with
+    // probability (still wanted) / (still unseen).
+    const size_t total = outcomes.size();
+    const size_t wanted = static_cast<size_t>(config_.sampled_chance_outcomes);
+    sampled.clear();
+    for (size_t i = 0; i < total && sampled.size() < wanted; ++i) {
+        if (static_cast<double>(total - i) * next_uniform() < static_cast<double>(wanted - sampled.size())) {
+            sampled.push_back(outcomes[i]);
+        }
+    }
+    return static_cast<double>(total) / static_cast<double>(wanted);
+}
 
-        // Write the final calculated utility for this specific hand to the shared result vector.
-        // This is safe because each thread writes to a unique index `trav_orig_idx`.
-        traverser_utility[trav_orig_idx] = expected_value_for_hand * chance_reach;
+bool PCfrSolver::EvaluateChanceOutcome(
+    uint32_t child,
+    const ReachPointers& reach_probs,
+    const ReachSums& reach_sums,
+    const UtilityPointers& utility,
+    const IterationDiscounts& discounts,
+    uint64_t current_board_mask,
+    uint64_t outcome_board_mask,
+    double chance_reach,
+    size_t deal_index,
+    int num_cards_dealt,
+    size_t depth,
+    TraversalScratch::Level& level)
+{
+    // --- Remove hands blocked by the dealt cards ---
+    // A player with no reach left keeps its (all-zero) vector as is.
+    ReachPointers next_reach_probs = reach_probs;
+    ReachSums next_reach_sums = {0.0, 0.0};
+    for (size_t p = 0; p < num_players_; ++p) {
+        if (reach_sums[p] <= 0.0) continue;
+        std::vector<double>& next = level.reach[p];
+        next.assign(reach_probs[p], reach_probs[p] + num_hands_[p]);
+        // Only the hands holding a dealt card are touched.
+        for (uint64_t cards = outcome_board_mask; cards != 0; cards &= cards - 1) {
+            for (int32_t h : pcm_->GetHandsWithCard(p, core::LowestCard(cards))) next[h] = 0.0;
+        }
+        next_reach_probs[p] = next.data();
+        next_reach_sums[p] = kernels::Sum(next.data(), num_hands_[p]);
+    }
 
-    } // --- End of parallel loop ---
+    // --- Recurse if possible ---
+    if (next_reach_sums[0] < 1e-12 && next_reach_sums[1] < 1e-12) {
+        return false;
+    }
+    cfr_utility(child, next_reach_probs, next_reach_sums, utility, discounts, current_board_mask | outcome_board_mask,
+                chance_reach, NextDealIndex(deal_index, outcome_board_mask, num_cards_dealt),
+                depth + 1);
+    return true;
+}
 
-    // Return the completed utility vector
-    return traverser_utility;
+void PCfrSolver::AccumulateOutcome(const UtilityPointers& sum, const UtilityPointers& outcome_utility,
+                                   int outcome_suit,
+                                   const std::array<int, core::kNumSuits>& suit_representative) const {
+    for (size_t p = 0; p < num_players_; ++p) {
+        if (!sum[p]) continue;
+        kernels::Accumulate(sum[p], outcome_utility[p], num_hands_[p]);
+        // The same rank in an isomorphic suit: hand h there plays like its
+        // suit-swapped partner here.
+        for (int suit = 0; suit < core::kNumSuits; ++suit) {
+            if (suit == outcome_suit || suit_representative[suit] != outcome_suit) continue;
+            const std::vector<int>& partner = SuitSwapHands(p, outcome_suit, suit);
+            for (size_t h = 0; h < num_hands_[p]; ++h) {
+                sum[p][h] += outcome_utility[p][partner[h]];
+            }
+        }
+    }
 }
 
 
-// --- Terminal Node Helper (Corrected) ---
-std::vector<double> PCfrSolver::cfr_terminal_node(
-    std::shared_ptr<nodes::TerminalNode> node,
-    const std::vector<std::vector<double>>& reach_probs,
-    int traverser,
+// --- Showdown Node Helper ---
+std::array<double, 3> PCfrSolver::ShowdownPayoffs(const tree::FlatNode& node, int traverser,
+                                                  double chance_reach) const {
+    // Player 0 wins / player 1 wins / tie, two payoffs each.
+    const double* payoffs = flat_tree_->ShowdownPayoffs(node);
+    const double* p0_wins_payoffs = payoffs;
+    const double* p1_wins_payoffs = payoffs + 2;
+    const double* tie_payoffs     = payoffs + 4;
+    // Payoff for the traverser when it wins / loses / ties, scaled by chance reach
+    return {((traverser == 0) ? p0_wins_payoffs[0] : p1_wins_payoffs[1]) * chance_reach,
+            ((traverser == 0) ? p1_wins_payoffs[0] : p0_wins_payoffs[1]) * chance_reach,
+            tie_payoffs[traverser] * chance_reach};
+}
+
+void PCfrSolver::cfr_showdown_node(
+    const tree::FlatNode& node,
+    const ReachPointers& reach_probs,
+    const ReachSums& reach_sums,
+    const UtilityPointers& utility,
+    uint64_t final_board_mask,
     double chance_reach)
 {
-    // --- Basic Setup & Pre-computation (Before Parallel Region) ---
-
-    // Get payoffs for this terminal state
-    const auto& payoffs = node->GetPayoffs(); // Read-only access ok
-    if (traverser < 0 || static_cast<size_t>(traverser) >= payoffs.size()) {
-         throw std::out_of_range("Traverser index out of bounds for payoffs vector in terminal node.");
-    }
-    // Get the specific payoff for the player traversing the tree
-    const double payoff_for_traverser = payoffs[traverser];
-
-    // Determine opponent and get player ranges (read-only access ok)
-    int opponent_player = 1 - traverser;
-    const auto& traverser_range = pcm_->GetPlayerRange(traverser);
-    const auto& opponent_range = pcm_->GetPlayerRange(opponent_player);
-    size_t traverser_hands = traverser_range.size();
-    size_t opponent_hands = opponent_range.size();
-
-    // Initialize result vector
-    std::vector<double> node_utility(traverser_hands, 0.0);
-
-    // --- Safety Checks (Before Parallel Region) ---
-    // Check for potential size mismatches or invalid opponent index
-    if (opponent_player < 0 || static_cast<size_t>(opponent_player) >= reach_probs.size() || (opponent_hands > 0 && opponent_hands != reach_probs[opponent_player].size()) ) {
-        // std::cerr << "[WARN] cfr_terminal_node: Opponent range/reach_probs mismatch or invalid index. Opponent: " << opponent_player
-        //           << ", Opponent Hands: " << opponent_hands
-        //           << ", Reach Probs size for opp: " << (static_cast<size_t>(opponent_player) < reach_probs.size() ? reach_probs[opponent_player].size() : -1)
-        //           << ". Returning zero utility." << std::endl;
-         return node_utility; // Cannot proceed safely
-    }
-     // Check traverser reach_probs size as well
-     if (static_cast<size_t>(traverser) >= reach_probs.size() || (traverser_hands > 0 && traverser_hands != reach_probs[traverser].size())) {
-        // std::cerr << "[WARN] cfr_terminal_node: Traverser range/reach_probs mismatch or invalid index. Traverser: " << traverser
-        //           << ", Traverser Hands: " << traverser_hands
-        //           << ", Reach Probs size for trav: " << (static_cast<size_t>(traverser) < reach_probs.size() ? reach_probs[traverser].size() : -1)
-        //           << ". Returning zero utility." << std::endl;
-         return node_utility; // Cannot proceed safely
-     }
+    for (int traverser = 0; traverser < static_cast<int>(num_players_); ++traverser) {
+        if (!utility[traverser]) continue;
+        int opponent_player = 1 - traverser;
+        if (reach_sums[opponent_player] < 1e-12) { // Nobody left to play against
+            std::fill(utility[traverser], utility[traverser] + num_hands_[traverser], 0.0);
+            continue;
+        }
+        const auto& traverser_range = pcm_->GetPlayerRange(traverser); // Read-only access
+        const auto& opponent_range = pcm_->GetPlayerRange(opponent_player); // Read-only access
+
+        // Combos come back sorted by rank (worst first), which the sweep relies on.
+        // The handles keep them alive if a memory-bounded cache evicts the board.
+        const auto traverser_combos = rrm_->AcquireRiverCombos(traverser, traverser_range, final_board_mask);
+        const auto opponent_combos = rrm_->AcquireRiverCombos(opponent_player, opponent_range, final_board_mask);
+        const ranges::PackedRiverCombos* traverser_combos_ptr = traverser_combos.get();
+        const ranges::PackedRiverCombos* opponent_combos_ptr = opponent_combos.get();
+        double* utility_row = utility[traverser];
+
+        const std::array<double, 3> payoffs = ShowdownPayoffs(node, traverser, chance_reach);
+        ShowdownBackend::Batch batch;
+        batch.num_boards = 1;
+        batch.board_masks = &final_board_mask;
+        batch.traverser_combos = &traverser_combos_ptr;
+        batch.opponent_combos = &opponent_combos_ptr;
+        batch.opponent_reach = reach_probs[opponent_player];
+        batch.traverser_hands = num_hands_[traverser];
+        batch.opponent_hands = num_hands_[opponent_player];
+        batch.win_payoff = payoffs[0];
+        batch.lose_payoff = payoffs[1];
+        batch.tie_payoff = payoffs[2];
+        batch.utility = &utility_row;
+        showdown_backend_->EvaluateShowdowns(batch);
+    }
+}
+
+void PCfrSolver::cfr_showdown_runout(
+    const tree::FlatNode& showdown,
+    const ReachPointers& reach_probs,
+    const ReachSums& reach_sums,
+    const UtilityPointers& utility,
+    const std::vector<uint64_t>& outcomes,
+    const std::array<int, core::kNumSuits>& suit_representative,
+    uint64_t owned_outcomes,
+    uint64_t current_board_mask,
+    double chance_reach,
+    TraversalScratch::Level& level)
+{
+    TraversalScratch::Level::Runout& runout = level.runout;
+    // --- Boards either player still reaches ---
+    // As EvaluateChanceOutcome would find them, without copying the reach:
+    // a board's combos leave out the hands it blocks.
+    runout.outcomes.clear();
+    runout.boards.clear();
+    runout.reach_left.clear();
+    for (size_t i = 0; i < outcomes.size(); ++i) {
+        const int card = core::LowestCard(outcomes[i]);
+        if (suit_representative[card % core::kNumSuits] != card % core::kNumSuits || !(outcomes[i] & owned_outcomes)) {
+            continue;
+        }
+        std::array<double, 2> left = {0.0, 0.0};
+        for (size_t p = 0; p < num_players_; ++p) {
+            if (reach_sums[p] <= 0.0) continue;
+            left[p] = reach_sums[p];
+            for (int32_t h : pcm_->GetHandsWithCard(p, card)) left[p] -= reach_probs[p][h];
+        }
+        if (left[0] < 1e-12 && left[1] < 1e-12) continue;
+        runout.outcomes.push_back(i);
+        runout.boards.push_back(current_board_mask | outcomes[i]);
+        runout.reach_left.push_back(left);
+    }
+    if (runout.boards.empty()) return;
+    EvaluateRunoutBoards(showdown, reach_probs, utility, chance_reach, false, level);
+
+    // --- Sum the boards in outcome order ---
+    for (size_t b = 0; b < runout.boards.size(); ++b) {
+        UtilityPointers rows = {nullptr, nullptr};
+        for (size_t p = 0; p < num_players_; ++p) {
+            if (utility[p]) rows[p] = level.outcome_utility[p].data() + b * num_hands_[p];
+        }
+        const int outcome_suit = core::LowestCard(outcomes[runout.outcomes[b]]) % core::kNumSuits;
+        AccumulateOutcome(utility, rows, outcome_suit, suit_representative);
+    }
+}
+
+
+void PCfrSolver::EvaluateRunoutBoards(
+    const tree::FlatNode& showdown,
+    const ReachPointers& reach_probs,
+    const UtilityPointers& utility,
+    double chance_reach,
+    bool parallel,
+    TraversalScratch::Level& level)
+{
+    TraversalScratch::Level::Runout& runout = level.runout;
+    const size_t num_boards = runout.boards.size();
+    // One visit per batch, with the hands of every board.
+    TraversalStatsScope stats_scope(evaluating_best_response_ ? nullptr : traversal_stats_collector_.get(),
+                                    core::GameTreeNodeType::kShowdown, showdown.round,
+                                    num_boards * ((utility[0] ? num_hands_[0] : 0) + (utility[1] ? num_hands_[1] : 0)));
+    for (size_t p = 0; p < num_players_; ++p) {
+        runout.combos[p].resize(num_boards);
+        for (size_t b = 0; b < num_boards; ++b) {
+            runout.combos[p][b] = rrm_->AcquireRiverCombos(p, pcm_->GetPlayerRange(p), runout.boards[b]);
+        }
+        if (utility[p]) level.outcome_utility[p].resize(num_boards * num_hands_[p]);
+    }
+
+    // --- One batch per traverser, of the boards its opponent reaches ---
+    for (int traverser = 0; traverser < static_cast<int>(num_players_); ++traverser) {
+        if (!utility[traverser]) continue;
+        const int opponent_player = 1 - traverser;
+        runout.batch_boards.clear();
+        runout.batch_combos[0].clear();
+        runout.batch_combos[1].clear();
+        runout.batch_utility.clear();
+        for (size_t b = 0; b < num_boards; ++b) {
+            double* row = level.outcome_utility[traverser].data() + b * num_hands_[traverser];
+            if (runout.reach_left[b][opponent_player] < 1e-12) { // Nobody left to play against
+                std::fill(row, row + num_hands_[traverser], 0.0);
+                continue;
+            }
+            runout.batch_boards.push_back(runout.boards[b]);
+            runout.batch_combos[0].push_back(runout.combos[traverser][b].get());
+            runout.batch_combos[1].push_back(runout.combos[opponent_player][b].get());
+            runout.batch_utility.push_back(row);
+        }
+        if (runout.batch_boards.empty()) continue;
+        const std::array<double, 3> payoffs = ShowdownPayoffs(showdown, traverser, chance_reach);
+        ShowdownBackend::Batch batch;
+        batch.num_boards = runout.batch_boards.size();
+        batch.board_masks = runout.batch_boards.data();
+        batch.traverser_combos = runout.batch_combos[0].data();
+        batch.opponent_combos = runout.batch_combos[1].data();
+        batch.opponent_reach = reach_probs[opponent_player];
+        batch.traverser_hands = num_hands_[traverser];
+        batch.opponent_hands = num_hands_[opponent_player];
+        batch.win_payoff = payoffs[0];
+        batch.lose_payoff = payoffs[1];
+        batch.tie_payoff = payoffs[2];
+        batch.utility = runout.batch_utility.data();
+        // Spread over the threads in slices; each board's row is its own.
+        const size_t num_slices =
+            parallel ? std::min(batch.num_boards, static_cast<size_t>(omp_get_max_threads())) : 1;
+        if (num_slices <= 1) {
+            showdown_backend_->EvaluateShowdowns(batch);
+            continue;
+        }
+        std::exception_ptr slice_error;
+        #pragma omp parallel for schedule(static)
+        for (size_t slice = 0; slice < num_slices; ++slice) {
+            const size_t begin = batch.num_boards * slice / num_slices;
+            ShowdownBackend::Batch part = batch;
+            part.num_boards = batch.num_boards * (slice + 1) / num_slices - begin;
+            part.board_masks += begin;
+            part.traverser_combos += begin;
+            part.opponent_combos += begin;
+            part.utility += begin;
+            try {
+                showdown_backend_->EvaluateShowdowns(part);
+            } catch (...) {
+                CaptureFirstError(slice_error);
+            }
+        }
+        if (slice_error) std::rethrow_exception(slice_error);
+    }
+
+    // Release the boards, so that a memory-bounded cache may evict them.
+    for (size_t p = 0; p < num_players_; ++p) {
+        for (auto& combos : runout.combos[p]) combos.reset();
+    }
+}
+
+void PCfrSolver::cfr_two_card_runout(
+    const tree::FlatNode& showdown,
+    const ReachPointers& reach_probs,
+    const ReachSums& reach_sums,
+    const UtilityPointers& utility,
+    const std::vector<uint64_t>& outcomes,
+    uint64_t current_board_mask,
+    double chance_reach,
+    bool parallel,
+    TraversalScratch::Level& level)
+{
+    TraversalScratch::Level::Runout& runout = level.runout;
+    // Reach of the hands holding each card that can come.
+    std::array<std::vector<double>, 2>& held_reach = runout.held_reach;
+    for (size_t p = 0; p < num_players_; ++p) {
+        held_reach[p].assign(outcomes.size(), 0.0);
+        if (reach_sums[p] <= 0.0) continue;
+        for (size_t i = 0; i < outcomes.size(); ++i) {
+            for (int32_t h : pcm_->GetHandsWithCard(p, core::LowestCard(outcomes[i]))) {
+                held_reach[p][i] += reach_probs[p][h];
+            }
+        }
+    }
+
+    // --- Boards either player still reaches, one per pair of cards ---
+    runout.boards.clear();
+    runout.reach_left.clear();
+    for (size_t i = 0; i < outcomes.size(); ++i) {
+        for (size_t j = i + 1; j < outcomes.size(); ++j) {
+            const uint64_t dealt = outcomes[i] | outcomes[j];
+            std::array<double, 2> left = {0.0, 0.0};
+            for (size_t p = 0; p < num_players_; ++p) {
+                if (reach_sums[p] <= 0.0) continue;
+                // The hand holding both cards was taken off twice.
+                const int both = pcm_->GetHandIndex(
+                    p, core::ComboIndex(core::LowestCard(outcomes[i]), core::LowestCard(outcomes[j])));
+                left[p] = reach_sums[p] - held_reach[p][i] - held_reach[p][j] +
+                          (both >= 0 ? reach_probs[p][both] : 0.0);
+            }
+            if (left[0] < 1e-12 && left[1] < 1e-12) continue;
+            runout.boards.push_back(current_board_mask | dealt);
+            runout.reach_left.push_back(left);
+        }
+    }
+    if (runout.boards.empty()) return;
+    // Each board is dealt in two orders, turn then river.
+    EvaluateRunoutBoards(showdown, reach_probs, utility, 2.0 * chance_reach, parallel, level);
+
+    // --- Sum the boards in dealing order ---
+    for (size_t p = 0; p < num_players_; ++p) {
+        if (!utility[p]) continue;
+        for (size_t b = 0; b < runout.boards.size(); ++b) {
+            kernels::Accumulate(utility[p], level.outcome_utility[p].data() + b * num_hands_[p], num_hands_[p]);
+        }
+    }
+}
+
+// --- Terminal Node Helper ---
+void PCfrSolver::cfr_leaf_node(
+    const tree::FlatNode& node,
+    uint32_t node_index,
+    const ReachPointers& reach_probs,
+    const ReachSums& reach_sums,
+    const UtilityPointers& utility,
+    uint64_t board_mask,
+    double chance_reach)
+{
+    for (size_t traverser = 0; traverser < num_players_; ++traverser) {
+        if (!utility[traverser]) continue;
+        const size_t opponent = 1 - traverser;
+        if (reach_sums[opponent] < 1e-12) {
+            std::fill(utility[traverser], utility[traverser] + num_hands_[traverser], 0.0);
+            continue;
+        }
+        LeafValueEstimator::Leaf leaf;
+        leaf.path = leaf_paths_[node_index];
+        leaf.round = node.round;
+        leaf.board_mask = board_mask;
+        leaf.deck_mask = deck_.GetCardsMask();
+        leaf.pot = node.pot;
+        leaf.player = traverser;
+        leaf.player_range = &pcm_->GetPlayerRange(traverser);
+        leaf.opponent_range = &pcm_->GetPlayerRange(opponent);
+        leaf.opponent_reach = reach_probs[opponent];
+        leaf.values = utility[traverser];
+        leaf_estimator_->EstimateLeafValues(leaf);
+        kernels::Scale(utility[traverser], utility[traverser], chance_reach, num_hands_[traverser]);
+    }
+}
 
+void PCfrSolver::cfr_terminal_node(
+    const tree::FlatNode& node,
+    const ReachPointers& reach_probs,
+    const ReachSums& reach_sums,
+    const UtilityPointers& utility,
+    double chance_reach)
+{
+    for (int traverser = 0; traverser < static_cast<int>(num_players_); ++traverser) {
+        if (!utility[traverser]) continue;
+        // Get the specific payoff for the player traversing the tree
+        const double payoff_for_traverser = flat_tree_->TerminalPayoff(node, traverser);
 
-    // --- Parallel Loop over Traverser's Hands ---
-    // Each thread calculates the utility for a subset of the traverser's hands.
-    // Writes to node_utility[h_i] are safe because each thread handles distinct indices.
-    #pragma omp parallel for schedule(dynamic)
-    for (size_t h_i = 0; h_i < traverser_hands; ++h_i) {
-        // --- Per-Hand Calculation (Private within thread/iteration) ---
+        int opponent_player = 1 - traverser;
+        if (reach_sums[opponent_player] < 1e-12) {
+            std::fill(utility[traverser], utility[traverser] + num_hands_[traverser], 0.0);
+            continue;
+        }
+        const auto& traverser_range = pcm_->GetPlayerRange(traverser);
+        const auto& opponent_range = pcm_->GetPlayerRange(opponent_player);
 
-        // Check if traverser can actually reach with this hand
-        // (Bounds check already done before parallel region)
-        if (reach_probs[traverser][h_i] < 1e-12) {
-            continue; // Skip this hand if it has zero reach probability
+        // Both kernels yield payoff * (reach of non-conflicting opponent hands).
+        if (config_.fold_evaluator == FoldEvaluator::kPairwise) {
+            FoldUtilityPairwise(traverser_range, opponent_range, reach_probs[opponent_player],
+                                payoff_for_traverser * chance_reach, utility[traverser]);
+        } else {
+            FoldUtilityLinear(traverser_range, opponent_range, reach_probs[opponent_player],
+                              payoff_for_traverser * chance_reach, utility[traverser]);
         }
+    }
+}
+
+
+// --- Deal Indexing Helpers ---
+size_t PCfrSolver::NextDealIndex(size_t deal_index, uint64_t outcome_mask, int num_cards_dealt) const {
+    if (num_cards_dealt != 1) {
+        return deal_index; // Multi-card deals share the parent's slot
+    }
+    int card = core::LowestCard(outcome_mask);
+    int position = deal_card_position_[card];
+    if (position < 0) {
+        std::ostringstream oss;
+        oss << "Dealt card " << core::Card::IntToString(card) << " is on the initial board.";
+        throw std::logic_error(oss.str());
+    }
+    return deal_index * deal_cards_.size() + static_cast<size_t>(position);
+}
+
+size_t PCfrSolver::NumaNodeOfCard(int card) const {
+    const int position = card >= 0 && card < core::kNumCardsInDeck ? deal_card_position_[card] : -1;
+    if (position < 0 || numa_.empty()) return 0;
+    return static_cast<size_t>(position) * numa_.NumNodes() / deal_cards_.size();
+}
+
+size_t PCfrSolver::NumaNodeOfBoard(uint64_t board_mask) const {
+    const uint64_t dealt = board_mask & ~initial_board_mask_;
+    return dealt ? NumaNodeOfCard(core::LowestCard(dealt)) : 0;
+}
+
+size_t PCfrSolver::EnterNumaNode(int thread, int num_threads) const {
+    const size_t node = numa_.NodeOfThread(thread, num_threads);
+    numa_.PinCurrentThread(node);
+    TrainableArena::SetThreadLane(node);
+    return node;
+}
+
+std::string PCfrSolver::DealLabel(size_t deal_index, int deal_layers) const {
+    std::string label;
+    for (int layer = 0; layer < deal_layers; ++layer) {
+        size_t position = deal_index % deal_cards_.size();
+        deal_index /= deal_cards_.size();
+        label.insert(0, core::Card::IntToString(deal_cards_[position]));
+    }
+    return label;
+}
+
+
+// --- Chance Deal Helpers ---
+double PCfrSolver::BuildChanceDeals(uint64_t board_mask, int num_cards, std::vector<uint64_t>& outcomes,
+                                    std::array<int, core::kNumSuits>& suit_representative) const {
+    outcomes.clear();
+    // Every deck card off the board is dealt; hands it blocks get zero reach
+    // in EvaluateChanceOutcome. The set must not depend on reach, otherwise
+    // the deals (and thus the per-deal trainables) would drift as strategies
+    // change.
+    std::array<int, core::kNumCardsInDeck> available_cards;
+    int num_available_cards = 0;
+    for (int card : deal_cards_) {
+        if (!((board_mask >> card) & 1ULL)) available_cards[num_available_cards++] = card;
+    }
+    // Both players hold two of the available cards, so any given pair of
+    // hands is compatible with C(n - 4, k) of the outcomes.
+    const int kHeldCards = 4;
+    if (num_available_cards - kHeldCards < num_cards) return 0.0;
+    EnumerateDealMasks(available_cards.data(), num_available_cards, num_cards, outcomes);
+
+    // Single-card deals of a non-representative suit are skipped and filled
+    // in from their representative.
+    if (num_cards == 1) {
+        SuitRepresentatives(board_mask, suit_representative);
+    } else {
+        std::iota(suit_representative.begin(), suit_representative.end(), 0);
+    }
+    double compatible_outcomes = 1.0;
+    for (int c = 0; c < num_cards; ++c) {
+        compatible_outcomes = compatible_outcomes * (num_available_cards - kHeldCards - c) / (c + 1);
+    }
+    return 1.0 / compatible_outcomes;
+}
 
-        // Get traverser's hand mask (read-only access to traverser_range)
-        uint64_t traverser_mask = traverser_range[h_i].GetBoardMask();
-        // Accumulator for the sum of reach probabilities of non-conflicting opponent hands
-        double compatible_opponent_reach_sum = 0.0;
+void PCfrSolver::BuildChanceDealTable() {
+    chance_deals_.clear();
+    // Board cards present when each street is dealt.
+    auto cards_before = [](core::GameRound round) {
+        return round == core::GameRound::kFlop ? 0 : round == core::GameRound::kTurn ? 3 : 4;
+    };
+    const int initial_cards = core::CountCards(initial_board_mask_);
+    std::array<bool, core::kNumCardsInDeck> seen{};
+    for (size_t i = 0; i < flat_tree_->Size(); ++i) {
+        const tree::FlatNode& node = flat_tree_->Node(static_cast<uint32_t>(i));
+        if (node.type != core::GameTreeNodeType::kChance) continue;
+        if (node.round != core::GameRound::kFlop && node.round != core::GameRound::kTurn &&
+            node.round != core::GameRound::kRiver) {
+            continue; // cfr_chance_node rejects it
+        }
+        const int dealt_before = cards_before(node.round) - initial_cards;
+        if (dealt_before < 0 || seen[dealt_before]) continue;
+        seen[dealt_before] = true;
+        if (utils::CombinationCount(deal_cards_.size(), dealt_before) > kMaxTabledChanceBoards) continue;
+
+        // Chance nodes deal every card off the board, so each
+        // 'dealt_before'-card subset of deal_cards_ can precede this node.
+        const int num_cards = node.round == core::GameRound::kFlop ? 3 : 1;
+        utils::CombinationIndices<core::kNumCardsInDeck> dealt(static_cast<int>(deal_cards_.size()), dealt_before);
+        if (!dealt.Valid()) continue;
+        do {
+            uint64_t board_mask = initial_board_mask_;
+            for (int c = 0; c < dealt_before; ++c) board_mask |= 1ULL << deal_cards_[dealt[c]];
+            ChanceDeals& deals = chance_deals_[board_mask];
+            deals.outcome_probability =
+                BuildChanceDeals(board_mask, num_cards, deals.outcomes, deals.suit_representative);
+        } while (dealt.Next());
+    }
+}
 
-        // Inner loop: Iterate over opponent hands
-        for (size_t h_j = 0; h_j < opponent_hands; ++h_j) {
-            // Get opponent's hand mask (read-only access to opponent_range)
-            uint64_t opponent_mask = opponent_range[h_j].GetBoardMask();
 
-            // Check for card conflicts (blockers)
-            if (!core::Card::DoBoardsOverlap(traverser_mask, opponent_mask)) {
-                // If no conflict, add opponent's reach probability to the sum
-                // (Bounds check already done before parallel region)
-                compatible_opponent_reach_sum += reach_probs[opponent_player][h_j];
+// --- Suit Isomorphism Helpers ---
+void PCfrSolver::SuitRepresentatives(uint64_t board_mask,
+                                     std::array<int, core::kNumSuits>& representative) const {
+    std::iota(representative.begin(), representative.end(), 0);
+    if (!config_.use_isomorphism) return;
+    uint64_t dealt_mask = board_mask & ~initial_board_mask_;
+    for (int suit = 1; suit < core::kNumSuits; ++suit) {
+        if ((dealt_mask >> suit) & kSuitRankBits) continue;
+        for (int other = 0; other < suit; ++other) {
+            if (isomorphic_suits_[other][suit] && !((dealt_mask >> other) & kSuitRankBits)) {
+                representative[suit] = other;
+                break;
             }
-        } // --- End inner loop (opponent hands) ---
+        }
+    }
+}
+
+const std::vector<int>& PCfrSolver::SuitSwapHands(size_t player, int suit1, int suit2) const {
+    return suit_swap_hands_[player][suit1 * core::kNumSuits + suit2];
+}
+
+// --- Task Scheduling Helpers ---
+double PCfrSolver::SubtreeWork(uint32_t node_index) const {
+    return node_index < subtree_work_.size() ? subtree_work_[node_index] : 0.0;
+}
+
+double PCfrSolver::ChanceWork(uint32_t child, size_t num_outcomes) const {
+    return SubtreeWork(child) * static_cast<double>(num_outcomes) *
+           static_cast<double>(num_hands_[0] + num_hands_[1]);
+}
 
-        // Calculate and store the utility for this traverser hand.
-        // Write is safe as h_i is unique per thread/iteration.
-        node_utility[h_i] = payoff_for_traverser * compatible_opponent_reach_sum * chance_reach;
+// The OpenMP runtime keeps its team between regions, so opening one costs
+// a wake-up and a join rather than thread creation; the first region below
+// pays for the creation and is not timed. Fan-outs then report the thread
+// time they took, which with their ChanceWork gives the cost of a unit of
+// work on this machine and tree.
+void PCfrSolver::StartParallelCutoffTuning() {
+    constexpr int kTimedRegions = 32;
+    #pragma omp parallel
+    {}
+    const double start = omp_get_wtime();
+    for (int r = 0; r < kTimedRegions; ++r) {
+        #pragma omp parallel
+        {}
+    }
+    parallel_region_seconds_ = (omp_get_wtime() - start) / kTimedRegions;
+    tuning_busy_seconds_ = 0.0;
+    tuning_work_ = 0.0;
+    parallel_cutoff_ = 0.0; // Every candidate fans out and is timed
+    parallel_tuning_iterations_left_ = kParallelTuningIterations;
+}
 
-    } // --- End of parallel loop ---
+void PCfrSolver::FinishParallelCutoffTuning() {
+    parallel_cutoff_tuned_ = true;
+    if (tuning_work_ <= 0.0 || tuning_busy_seconds_ <= 0.0) return; // Nothing fanned out
+    const double seconds_per_unit = tuning_busy_seconds_ / tuning_work_;
+    parallel_cutoff_ = kParallelOverheadRatio * parallel_region_seconds_ / seconds_per_unit;
+    std::cout << "[INFO] Parallel cutoff tuned to " << parallel_cutoff_ << " work units (region "
+              << parallel_region_seconds_ * 1e6 << " us, " << seconds_per_unit * 1e9 << " ns per unit)."
+              << std::endl;
+}
 
-    // Return the completed utility vector
-    return node_utility;
+size_t PCfrSolver::CanonicalDeal(size_t deal_index, int deal_layers,
+                                 std::vector<std::pair<int, int>>& swaps) const {
+    std::vector<int> cards(deal_layers);
+    for (int layer = deal_layers - 1; layer >= 0; --layer) {
+        cards[layer] = deal_cards_[deal_index % deal_cards_.size()];
+        deal_index /= deal_cards_.size();
+    }
+    // Replay the deals, moving each card onto its representative and carrying
+    // every exchange over to the cards dealt after it.
+    uint64_t board_mask = initial_board_mask_;
+    size_t canonical = 0;
+    std::array<int, core::kNumSuits> representative;
+    size_t first_swap = swaps.size();
+    for (int card : cards) {
+        for (size_t i = first_swap; i < swaps.size(); ++i) {
+            card = SwapSuit(card, swaps[i].first, swaps[i].second);
+        }
+        SuitRepresentatives(board_mask, representative);
+        int suit = card % core::kNumSuits;
+        if (representative[suit] != suit) {
+            swaps.emplace_back(suit, representative[suit]);
+            card = SwapSuit(card, suit, representative[suit]);
+        }
+        board_mask |= 1ULL << card;
+        canonical = canonical * deal_cards_.size() + static_cast<size_t>(deal_card_position_[card]);
+    }
+    return canonical;
 }
 
 
@@ -752,7 +3214,8 @@ json PCfrSolver::dump_strategy_recursive(
         const std::shared_ptr<core::GameTreeNode>& node,
         bool dump_evs,
         int current_depth,
-        int max_depth) const {
+        int max_depth,
+        int deal_layers) const {
     json result;
     if (!node || (max_depth >= 0 && current_depth > max_depth)) {
         return nullptr;
@@ -765,11 +3228,25 @@ json PCfrSolver::dump_strategy_recursive(
     if (auto action_node = std::dynamic_pointer_cast<const nodes::ActionNode>(node)) {
         result["node_type"] = "Action";
         result["player"] = action_node->GetPlayerIndex();
-        auto trainable = action_node->GetTrainableIfExists(0);
-        if (trainable) {
-            result["strategy_data"] = trainable->DumpStrategy(dump_evs);
+        if (action_node->GetNumPossibleDeals() == 1) {
+            auto trainable = action_node->GetTrainableIfExists(0);
+            if (trainable) {
+                result["strategy_data"] = trainable->DumpStrategy(dump_evs);
+            } else {
+                result["strategy_data"] = "Not trained";
+            }
         } else {
-            result["strategy_data"] = "Not trained";
+            // Card-specific node: one entry per visited deal, keyed by the dealt cards.
+            json per_deal = json::object();
+            for (size_t d = 0; d < action_node->GetNumPossibleDeals(); ++d) {
+                json dump = dump_deal_strategy(*action_node, d, deal_layers, dump_evs);
+                if (!dump.is_null()) per_deal[DealLabel(d, deal_layers)] = std::move(dump);
+            }
+            if (per_deal.empty()) {
+                result["strategy_data"] = "Not trained";
+            } else {
+                result["strategy_data"] = per_deal;
+            }
         }
         json children_json = json::object();
         const auto& actions = action_node->GetActions();
@@ -777,7 +3254,7 @@ json PCfrSolver::dump_strategy_recursive(
         if (actions.size() == children.size()) {
              for (size_t i = 0; i < actions.size(); ++i) {
                  if (children[i]) {
-                     json child_dump = dump_strategy_recursive(children[i], dump_evs, current_depth + 1, max_depth);
+                     json child_dump = dump_strategy_recursive(children[i], dump_evs, current_depth + 1, max_depth, deal_layers);
                      if (!child_dump.is_null()) {
                          children_json[actions[i].ToString()] = child_dump;
                      }
@@ -801,7 +3278,8 @@ json PCfrSolver::dump_strategy_recursive(
         result["dealt_cards"] = dealt_cards_json;
         // Removed IsDonkOpportunity as it was removed from ChanceNode definition
         if (chance_node->GetChild()) {
-            json child_dump = dump_strategy_recursive(chance_node->GetChild(), dump_evs, current_depth + 1, max_depth);
+            int child_deal_layers = deal_layers + (chance_node->GetRound() != core::GameRound::kFlop ? 1 : 0);
+            json child_dump = dump_strategy_recursive(chance_node->GetChild(), dump_evs, current_depth + 1, max_depth, child_deal_layers);
             if (!child_dump.is_null()) result["child"] = child_dump;
         }
 
@@ -827,5 +3305,262 @@ json PCfrSolver::dump_strategy_recursive(
     return result;
 }
 
+std::shared_ptr<Trainable> PCfrSolver::DealTrainable(
+        const nodes::ActionNode& action_node,
+        size_t deal_index,
+        int deal_layers,
+        std::vector<std::pair<int, int>>& swaps) const {
+    if (auto trainable = action_node.GetTrainableIfExists(deal_index)) return trainable;
+    if (!config_.use_isomorphism) return nullptr;
+    size_t first_swap = swaps.size();
+    auto canonical = action_node.GetTrainableIfExists(CanonicalDeal(deal_index, deal_layers, swaps));
+    if (!canonical || swaps.size() == first_swap) return nullptr;
+    return canonical;
+}
+
+void PCfrSolver::ClearHandGrids() {
+    std::lock_guard<std::mutex> lock(hand_grid_mutex_);
+    hand_grids_.clear();
+}
+
+size_t PCfrSolver::SwappedHand(size_t player, size_t hand, const std::vector<std::pair<int, int>>& swaps) const {
+    for (const auto& swap : swaps) {
+        hand = static_cast<size_t>(SuitSwapHands(player, swap.first, swap.second)[hand]);
+    }
+    return hand;
+}
+
+json PCfrSolver::dump_deal_strategy(
+        const nodes::ActionNode& action_node,
+        size_t deal_index,
+        int deal_layers,
+        bool dump_evs) const {
+    std::vector<std::pair<int, int>> swaps;
+    auto trainable = DealTrainable(action_node, deal_index, deal_layers, swaps);
+    if (!trainable) return nullptr;
+    if (swaps.empty()) return trainable->DumpStrategy(dump_evs);
+    // Skipped by isomorphism: relabel the hands of the traversed deal.
+    const size_t player = action_node.GetPlayerIndex();
+    const auto& range = pcm_->GetPlayerRange(player);
+    json canonical_dump = trainable->DumpStrategy(dump_evs);
+    json dump = canonical_dump;
+    for (const char* key : {"strategy", "evs"}) {
+        if (!canonical_dump.contains(key)) continue;
+        json& per_hand = dump[key];
+        for (size_t h = 0; h < range.size(); ++h) {
+            per_hand[range[h].ToString()] = canonical_dump[key][range[SwappedHand(player, h, swaps)].ToString()];
+        }
+    }
+    return dump;
+}
+
+// --- Strategy Files ---
+
+void PCfrSolver::WriteStrategyFile(const std::string& path, StrategyValueType value_type) const {
+    TraceSpan span(trace_recorder_.get(), "dump", "output");
+    if (!game_tree_ || !game_tree_->GetRoot()) {
+        throw std::runtime_error("WriteStrategyFile: game tree is empty or not initialized.");
+    }
+    // Pass 1 declares every node with a strategy; pass 2 (Write) fetches
+    // their values in the same order, one node at a time.
+    struct NodeDeal {
+        const nodes::ActionNode* node;
+        size_t deal_index;
+        int deal_layers;
+    };
+    StrategyFileWriter writer(value_type, {pcm_->GetPlayerRange(0), pcm_->GetPlayerRange(1)});
+    std::vector<NodeDeal> node_deals;
+    std::vector<std::string> action_labels;
+    std::function<void(const std::shared_ptr<core::GameTreeNode>&, const std::string&, size_t, int, uint64_t)> visit =
+        [&](const std::shared_ptr<core::GameTreeNode>& node, const std::string& node_path, size_t deal_index,
+            int deal_layers, uint64_t dealt_mask) {
+        if (!node) return;
+        auto child_path = [&](const std::string& component) {
+            return node_path.empty() ? component : node_path + "/" + component;
+        };
+        if (node->GetNodeType() == core::GameTreeNodeType::kAction) {
+            const auto* action_node = static_cast<const nodes::ActionNode*>(node.get());
+            const size_t deal = action_node->GetNumPossibleDeals() == 1 ? 0 : deal_index;
+            std::vector<std::pair<int, int>> swaps;
+            if (auto trainable = DealTrainable(*action_node, deal, deal_layers, swaps)) {
+                action_labels.clear();
+                for (const auto& action : action_node->GetActions()) action_labels.push_back(action.ToString());
+                writer.AddNode(node_path, action_node->GetPlayerIndex(), action_labels, !trainable->GetEvs().empty());
+                node_deals.push_back({action_node, deal, deal_layers});
+            }
+            const auto& actions = action_node->GetActions();
+            const auto& children = action_node->GetChildren();
+            if (actions.size() != children.size()) return;
+            for (size_t i = 0; i < actions.size(); ++i) {
+                visit(children[i], child_path(actions[i].ToString()), deal_index, deal_layers, dealt_mask);
+            }
+        } else if (node->GetNodeType() == core::GameTreeNodeType::kChance) {
+            auto chance_node = std::static_pointer_cast<nodes::ChanceNode>(node);
+            if (chance_node->GetRound() == core::GameRound::kFlop) {
+                // Flop deals do not extend the deal index.
+                visit(chance_node->GetChild(), node_path, deal_index, deal_layers, dealt_mask);
+                return;
+            }
+            for (size_t position = 0; position < deal_cards_.size(); ++position) {
+                const int card = deal_cards_[position];
+                if (dealt_mask & (1ULL << card)) continue;
+                visit(chance_node->GetChild(), child_path(core::Card::IntToString(card)),
+                      deal_index * deal_cards_.size() + position, deal_layers + 1, dealt_mask | (1ULL << card));
+            }
+        }
+    };
+    visit(game_tree_->GetRoot(), "", 0, 0, 0);
+
+    std::cout << "[INFO] Writing strategy file " << path << " (" << node_deals.size() << " nodes)" << std::endl;
+    writer.Write(path, [&](size_t index, std::vector<double>& strategy, std::vector<double>& evs) {
+        const NodeDeal& node_deal = node_deals[index];
+        std::vector<std::pair<int, int>> swaps;
+        auto trainable = DealTrainable(*node_deal.node, node_deal.deal_index, node_deal.deal_layers, swaps);
+        strategy = trainable->GetAverageStrategy();
+        evs = trainable->GetEvs();
+        if (swaps.empty()) return;
+        // Relabel the canonical deal's hands, as the JSON dump does.
+        const size_t player = node_deal.node->GetPlayerIndex();
+        const size_t num_actions = node_deal.node->GetActions().size();
+        const size_t num_hands = pcm_->GetPlayerRange(player).size();
+        std::vector<double> canonical_strategy = strategy;
+        std::vector<double> canonical_evs = evs;
+        for (size_t h = 0; h < num_hands; ++h) {
+            const size_t partner = SwappedHand(player, h, swaps);
+            for (size_t a = 0; a < num_actions; ++a) {
+                strategy[h * num_actions + a] = canonical_strategy[partner * num_actions + a];
+                if (!evs.empty()) evs[h * num_actions + a] = canonical_evs[partner * num_actions + a];
+            }
+        }
+    });
+}
+
+// --- Streaming Dump ---
+
+void PCfrSolver::DumpStrategyTo(std::ostream& out, bool dump_evs, int max_depth) const {
+    TraceSpan span(trace_recorder_.get(), "dump", "output");
+    if (!game_tree_ || !game_tree_->GetRoot()) {
+        out << json{{"error", "Game tree is empty or not initialized."}}.dump();
+        return;
+    }
+    std::cout << "[INFO] Streaming strategy dump... (EVs: " << dump_evs << ", MaxDepth: " << max_depth << ")" << std::endl;
+    // The root's members, then the metadata DumpStrategy adds to them.
+    out << '{';
+    if (has_strategy_dump(game_tree_->GetRoot(), 0, max_depth)) {
+        stream_strategy_recursive(out, game_tree_->GetRoot(), dump_evs, 0, max_depth, 0);
+        out << ',';
+    }
+    json range_info = json::array();
+    for (size_t p = 0; p < num_players_; ++p) {
+        range_info.push_back({{"original_size", pcm_->GetOriginalRange(p).size()},
+                              {"original_indices", pcm_->GetOriginalHandIndices(p)}});
+    }
+    json metadata = {{"dump_evs", dump_evs},
+                     {"max_depth", max_depth == -1 ? "unlimited" : std::to_string(max_depth)},
+                     {"ranges", range_info}};
+    out << "\"metadata\":" << metadata.dump() << '}';
+    if (!out) throw std::runtime_error("DumpStrategyTo: failed to write the strategy dump.");
+}
+
+bool PCfrSolver::has_strategy_dump(
+        const std::shared_ptr<core::GameTreeNode>& node,
+        int current_depth,
+        int max_depth) const {
+    if (!node || (max_depth >= 0 && current_depth > max_depth)) return false;
+    switch (node->GetNodeType()) {
+        case core::GameTreeNodeType::kShowdown:
+        case core::GameTreeNodeType::kTerminal:
+            return true;
+        case core::GameTreeNodeType::kChance:
+            return has_strategy_dump(std::static_pointer_cast<nodes::ChanceNode>(node)->GetChild(),
+                                     current_depth + 1, max_depth);
+        case core::GameTreeNodeType::kAction: {
+            // Deals skipped by isomorphism borrow a visited deal's trainable,
+            // so some deal has one whenever any deal dumps.
+            auto action_node = std::static_pointer_cast<nodes::ActionNode>(node);
+            for (size_t d = 0; d < action_node->GetNumPossibleDeals(); ++d) {
+                if (action_node->GetTrainableIfExists(d)) return true;
+            }
+            if (action_node->GetActions().size() != action_node->GetChildren().size()) return false;
+            for (const auto& child : action_node->GetChildren()) {
+                if (has_strategy_dump(child, current_depth + 1, max_depth)) return true;
+            }
+            return false;
+        }
+    }
+    return false;
+}
+
+void PCfrSolver::stream_strategy_recursive(
+        std::ostream& out,
+        const std::shared_ptr<core::GameTreeNode>& node,
+        bool dump_evs,
+        int current_depth,
+        int max_depth,
+        int deal_layers) const {
+    out << "\"round\":" << json(core::GameTreeNode::GameRoundToString(node->GetRound())).dump()
+        << ",\"pot\":" << json(node->GetPot()).dump()
+        << ",\"depth\":" << current_depth;
+
+    switch (node->GetNodeType()) {
+        case core::GameTreeNodeType::kAction: {
+            auto action_node = std::static_pointer_cast<nodes::ActionNode>(node);
+            out << ",\"node_type\":\"Action\",\"player\":" << action_node->GetPlayerIndex() << ",\"strategy_data\":";
+            if (action_node->GetNumPossibleDeals() == 1) {
+                auto trainable = action_node->GetTrainableIfExists(0);
+                out << (trainable ? trainable->DumpStrategy(dump_evs) : json("Not trained")).dump();
+            } else {
+                bool any_deal = false;
+                for (size_t d = 0; d < action_node->GetNumPossibleDeals(); ++d) {
+                    json dump = dump_deal_strategy(*action_node, d, deal_layers, dump_evs);
+                    if (dump.is_null()) continue;
+                    out << (any_deal ? ',' : '{') << json(DealLabel(d, deal_layers)).dump() << ':' << dump.dump();
+                    any_deal = true;
+                }
+                out << (any_deal ? "}" : "\"Not trained\"");
+            }
+            const auto& actions = action_node->GetActions();
+            const auto& children = action_node->GetChildren();
+            if (actions.size() != children.size()) {
+                std::cerr << "[WARN] DumpStrategy: Action/Children size mismatch at depth " << current_depth << std::endl;
+                break;
+            }
+            bool any_child = false;
+            for (size_t i = 0; i < actions.size(); ++i) {
+                if (!has_strategy_dump(children[i], current_depth + 1, max_depth)) continue;
+                out << (any_child ? "," : ",\"children\":{") << json(actions[i].ToString()).dump() << ":{";
+                stream_strategy_recursive(out, children[i], dump_evs, current_depth + 1, max_depth, deal_layers);
+                out << '}';
+                any_child = true;
+            }
+            if (any_child) out << '}';
+            break;
+        }
+        case core::GameTreeNodeType::kChance: {
+            auto chance_node = std::static_pointer_cast<nodes::ChanceNode>(node);
+            json dealt_cards_json = json::array();
+            for (const auto& card : chance_node->GetDealtCards()) {
+                dealt_cards_json.push_back(card.IsEmpty() ? "InvalidCard" : card.ToString());
+            }
+            out << ",\"node_type\":\"Chance\",\"dealt_cards\":" << dealt_cards_json.dump();
+            if (has_strategy_dump(chance_node->GetChild(), current_depth + 1, max_depth)) {
+                int child_deal_layers = deal_layers + (chance_node->GetRound() != core::GameRound::kFlop ? 1 : 0);
+                out << ",\"child\":{";
+                stream_strategy_recursive(out, chance_node->GetChild(), dump_evs, current_depth + 1, max_depth,
+                                          child_deal_layers);
+                out << '}';
+            }
+            break;
+        }
+        case core::GameTreeNodeType::kShowdown:
+            out << ",\"node_type\":\"Showdown\"";
+            break;
+        case core::GameTreeNodeType::kTerminal:
+            out << ",\"node_type\":\"Terminal\",\"payoffs\":"
+                << json(std::static_pointer_cast<nodes::TerminalNode>(node)->GetPayoffs()).dump();
+            break;
+    }
+}
+
 } // namespace solver
 } // namespace poker_solver
\ No newline at end of file
@@ -0,0 +1,16 @@
+#include "solver/ShowdownBackend.h"
+#include "solver/UtilityKernels.h"
+
+namespace poker_solver {
+namespace solver {
+
+void CpuShowdownBackend::EvaluateShowdowns(const Batch& batch) {
+    for (size_t b = 0; b < batch.num_boards; ++b) {
+        ShowdownUtilitySweep(*batch.traverser_combos[b], *batch.opponent_combos[b], batch.traverser_hands,
+                             batch.opponent_reach + b * batch.opponent_reach_stride, batch.opponent_hands,
+                             batch.win_payoff, batch.lose_payoff, batch.tie_payoff, batch.utility[b]);
+    }
+}
+
+} // namespace solver
+} // namespace poker_solver
@@ -0,0 +1,274 @@
+#include "solver/SolutionStore.h"
+#include "tools/BinaryIo.h" // For Fnv1a
+#include <algorithm>
+#include <cstdio>
+#include <filesystem> // For creating the directory and renaming files into place
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace poker_solver {
+namespace solver {
+
+namespace {
+
+using SuitMap = std::array<int, core::kNumSuits>;
+
+struct Combo {
+    int card1; // Lower card
+    int card2;
+    double weight;
+    bool operator<(const Combo& other) const {
+        return std::tie(card1, card2, weight) < std::tie(other.card1, other.card2, other.weight);
+    }
+};
+
+// The board, deck and ranges with suits renamed by one permutation.
+struct RelabeledSpot {
+    std::vector<int> board; // Ascending
+    uint64_t deck_mask = 0;
+    std::array<std::vector<Combo>, 2> ranges; // Ascending
+
+    bool operator<(const RelabeledSpot& other) const {
+        return std::tie(board, deck_mask, ranges[0], ranges[1]) <
+               std::tie(other.board, other.deck_mask, other.ranges[0], other.ranges[1]);
+    }
+};
+
+RelabeledSpot Relabel(const std::vector<int>& board, uint64_t deck_mask,
+                      const std::array<std::vector<Combo>, 2>& ranges, const SuitMap& suits) {
+    RelabeledSpot spot;
+    for (int card : board) spot.board.push_back(MapCardSuit(card, suits));
+    std::sort(spot.board.begin(), spot.board.end());
+    for (int card = 0; card < core::kNumCardsInDeck; ++card) {
+        if (deck_mask & core::Card::CardIntToUint64(card)) {
+            spot.deck_mask |= core::Card::CardIntToUint64(MapCardSuit(card, suits));
+        }
+    }
+    for (size_t p = 0; p < 2; ++p) {
+        spot.ranges[p].reserve(ranges[p].size());
+        for (const Combo& combo : ranges[p]) {
+            const int a = MapCardSuit(combo.card1, suits);
+            const int b = MapCardSuit(combo.card2, suits);
+            spot.ranges[p].push_back({std::min(a, b), std::max(a, b), combo.weight});
+        }
+        std::sort(spot.ranges[p].begin(), spot.ranges[p].end());
+    }
+    return spot;
+}
+
+// Round-trip exact text of a double.
+std::string Number(double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    return buffer;
+}
+
+void AppendSizes(std::ostringstream& out, const std::vector<double>& sizes) {
+    out << '[';
+    for (size_t i = 0; i < sizes.size(); ++i) out << (i ? "," : "") << Number(sizes[i]);
+    out << ']';
+}
+
+void AppendStreetSetting(std::ostringstream& out, const char* name, const config::StreetSetting& setting) {
+    out << name << "=bet";
+    AppendSizes(out, setting.bet_sizes_percent);
+    out << " raise";
+    AppendSizes(out, setting.raise_sizes_percent);
+    out << " donk";
+    AppendSizes(out, setting.donk_sizes_percent);
+    out << " allin=" << setting.allow_all_in << '\n';
+}
+
+// Parts of the key that suits do not change.
+std::string SettingsText(const config::Rule& rule, const PCfrSolver::Config& config) {
+    std::ostringstream out;
+    out << "spot-key 1\n";
+    out << "round=" << static_cast<int>(rule.GetStartingRound()) << '\n';
+    out << "commit=" << Number(rule.GetInitialOopCommit()) << ',' << Number(rule.GetInitialIpCommit()) << '\n';
+    out << "blinds=" << Number(rule.GetSmallBlind()) << ',' << Number(rule.GetBigBlind()) << '\n';
+    out << "stack=" << Number(rule.GetInitialEffectiveStack()) << '\n';
+    out << "raise_limit=" << rule.GetRaiseLimitPerStreet() << '\n';
+    out << "allin_ratio=" << Number(rule.GetAllInThresholdRatio()) << '\n';
+    // Batches value depth-limit leaves with the default estimator. Only
+    // written when set, so full-tree keys stay as they were.
+    if (rule.IsDepthLimited()) out << "depth_limited=1\n";
+    const config::GameTreeBuildingSettings& bets = rule.GetBuildSettings();
+    AppendStreetSetting(out, "flop_ip", bets.flop_ip_setting);
+    AppendStreetSetting(out, "turn_ip", bets.turn_ip_setting);
+    AppendStreetSetting(out, "river_ip", bets.river_ip_setting);
+    AppendStreetSetting(out, "flop_oop", bets.flop_oop_setting);
+    AppendStreetSetting(out, "turn_oop", bets.turn_oop_setting);
+    AppendStreetSetting(out, "river_oop", bets.river_oop_setting);
+    out << "iterations=" << config.iteration_limit << '\n';
+    out << "trainer=" << static_cast<int>(config.trainer) << " dcfr=" << Number(config.dcfr.alpha) << ','
+        << Number(config.dcfr.beta) << ',' << Number(config.dcfr.gamma) << '\n';
+    out << "precision=" << static_cast<int>(config.precision) << '\n';
+    out << "update_scheme=" << static_cast<int>(config.update_scheme) << '\n';
+    out << "isomorphism=" << config.use_isomorphism << '\n';
+    out << "exploitability=" << config.exploitability_interval << ',' << Number(config.target_exploitability)
+        << '\n';
+    out << "pruning=" << config.regret_pruning << ',' << config.pruning_warmup_iterations << ','
+        << config.pruning_full_pass_interval << '\n';
+    out << "sampling=" << config.sampled_chance_outcomes << ',' << config.sampling_seed << '\n';
+    out << "sparse=" << config.sparse_trainable_warmup << ',' << Number(config.sparse_trainable_max_support) << ','
+        << Number(config.sparse_trainable_min_relative_reach) << '\n';
+    // Settings added after keys were first stored are written only when
+    // they differ from their defaults, so existing keys stay as they were.
+    if (config.abstraction_buckets != 0) out << "abstraction=" << config.abstraction_buckets << '\n';
+    if (config.average_warmup_iterations != 0 || config.average_interval != 1)
+        out << "average=" << config.average_warmup_iterations << ',' << config.average_interval << '\n';
+    return out.str();
+}
+
+std::string SpotText(const RelabeledSpot& spot) {
+    std::ostringstream out;
+    out << "board=";
+    for (int card : spot.board) out << core::Card::IntToString(card);
+    out << "\ndeck=" << spot.deck_mask << '\n';
+    for (size_t p = 0; p < 2; ++p) {
+        out << "range" << p << '=';
+        for (size_t i = 0; i < spot.ranges[p].size(); ++i) {
+            const Combo& combo = spot.ranges[p][i];
+            out << (i ? "," : "") << core::Card::IntToString(combo.card1) << core::Card::IntToString(combo.card2)
+                << ':' << Number(combo.weight);
+        }
+        out << '\n';
+    }
+    return out.str();
+}
+
+std::string SuitsLine(const SuitMap& suits) {
+    std::string line = "suits=";
+    for (int s = 0; s < core::kNumSuits; ++s) line += static_cast<char>('0' + suits[s]);
+    return line + '\n';
+}
+
+std::optional<SuitMap> ParseSuitsLine(const std::string& line) {
+    if (line.size() != 6 + core::kNumSuits + 1 || line.compare(0, 6, "suits=") != 0 || line.back() != '\n') {
+        return std::nullopt;
+    }
+    SuitMap suits{};
+    std::array<bool, core::kNumSuits> seen{};
+    for (int s = 0; s < core::kNumSuits; ++s) {
+        const int suit = line[6 + s] - '0';
+        if (suit < 0 || suit >= core::kNumSuits || seen[suit]) return std::nullopt;
+        seen[suit] = true;
+        suits[s] = suit;
+    }
+    return suits;
+}
+
+} // namespace
+
+SpotKey SpotKey::Make(const config::Rule& rule, const std::vector<std::vector<core::PrivateCards>>& ranges,
+                      const PCfrSolver::Config& config) {
+    if (ranges.size() != 2) throw std::invalid_argument("SpotKey: expected two ranges.");
+    const std::vector<int>& board = rule.GetInitialBoardCardsInt();
+    const uint64_t board_mask = core::Card::CardIntsToUint64(board);
+    std::array<std::vector<Combo>, 2> combos;
+    for (size_t p = 0; p < 2; ++p) {
+        for (const core::PrivateCards& hand : ranges[p]) {
+            if (hand.Weight() <= 0.0 || core::Card::DoBoardsOverlap(hand.GetBoardMask(), board_mask)) continue;
+            combos[p].push_back({hand.Card1Int(), hand.Card2Int(), hand.Weight()});
+        }
+    }
+
+    // The smallest relabeling over all 24 suit permutations.
+    const uint64_t deck_mask = rule.GetDeck().GetCardsMask();
+    SuitMap suits = {0, 1, 2, 3};
+    SuitMap best_suits = suits;
+    RelabeledSpot best = Relabel(board, deck_mask, combos, suits);
+    while (std::next_permutation(suits.begin(), suits.end())) {
+        RelabeledSpot candidate = Relabel(board, deck_mask, combos, suits);
+        if (candidate < best) {
+            best = std::move(candidate);
+            best_suits = suits;
+        }
+    }
+
+    SpotKey key;
+    key.canonical = SettingsText(rule, config) + SpotText(best);
+    key.to_canonical_suit = best_suits;
+    utils::Fnv1a hash;
+    hash.Add(key.canonical);
+    key.fingerprint = hash.Value();
+    return key;
+}
+
+SolutionStore::SolutionStore(std::string directory) : directory_(std::move(directory)) {
+    if (directory_.empty()) throw std::invalid_argument("SolutionStore: directory cannot be empty.");
+    std::error_code error;
+    fs::create_directories(directory_, error);
+    if (error || !fs::is_directory(directory_)) {
+        throw std::runtime_error("SolutionStore: cannot create directory " + directory_ + ".");
+    }
+}
+
+std::string SolutionStore::EntryPath(const SpotKey& key, const char* extension) const {
+    char name[17];
+    std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key.fingerprint));
+    return (fs::path(directory_) / (std::string(name) + extension)).string();
+}
+
+std::optional<SolutionStore::Hit> SolutionStore::Lookup(const SpotKey& key) const {
+    std::ifstream in(EntryPath(key, ".key"), std::ios::binary);
+    if (!in) return std::nullopt;
+    const std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (text.size() <= key.canonical.size() || text.compare(0, key.canonical.size(), key.canonical) != 0) {
+        return std::nullopt; // Another spot with the same fingerprint
+    }
+    const std::optional<SuitMap> stored_suits = ParseSuitsLine(text.substr(key.canonical.size()));
+    if (!stored_suits) return std::nullopt;
+
+    Hit hit;
+    hit.strategy_path = EntryPath(key, ".strategy");
+    if (!fs::is_regular_file(hit.strategy_path)) return std::nullopt;
+    // Both spots map to the same canonical suits; go through them.
+    for (int query_suit = 0; query_suit < core::kNumSuits; ++query_suit) {
+        const int canonical = key.to_canonical_suit[query_suit];
+        for (int stored_suit = 0; stored_suit < core::kNumSuits; ++stored_suit) {
+            if ((*stored_suits)[stored_suit] == canonical) hit.suit_map[query_suit] = stored_suit;
+        }
+    }
+    return hit;
+}
+
+SolutionStore::Hit SolutionStore::Store(const SpotKey& key, const PCfrSolver& solver) const {
+    Hit hit;
+    hit.strategy_path = EntryPath(key, ".strategy");
+    hit.suit_map = {0, 1, 2, 3};
+    // A replaced entry stops matching before its strategy is overwritten.
+    const std::string key_path = EntryPath(key, ".key");
+    std::error_code remove_error;
+    fs::remove(key_path, remove_error);
+    solver.WriteStrategyFile(hit.strategy_path);
+
+    const std::string temporary_path = key_path + ".tmp";
+    try {
+        {
+            std::ofstream out(temporary_path, std::ios::binary | std::ios::trunc);
+            out << key.canonical << SuitsLine(key.to_canonical_suit);
+            out.close();
+            if (!out) throw std::runtime_error("SolutionStore: cannot write " + temporary_path + ".");
+        }
+        fs::rename(temporary_path, key_path);
+    } catch (const fs::filesystem_error& e) {
+        std::error_code ignored;
+        fs::remove(temporary_path, ignored);
+        throw std::runtime_error(std::string("SolutionStore: ") + e.what());
+    } catch (...) {
+        std::error_code ignored;
+        fs::remove(temporary_path, ignored);
+        throw;
+    }
+    return hit;
+}
+
+} // namespace solver
+} // namespace poker_solver
@@ -0,0 +1,362 @@
+#include "solver/SolveService.h"
+
+#include "Card.h"
+#include "GameTree.h"
+#include "ranges/PrivateCardsManager.h"
+#include "ranges/RiverRangeManager.h"
+#include "tools/PrivateRangeConverter.h"
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <omp.h>
+
+namespace poker_solver {
+namespace solver {
+
+struct SolveService::Job {
+    explicit Job(SolveJob job) : spec(std::move(job)) {}
+
+    SolveJob spec;
+    SolveJobStatus status; // Guarded by mutex_
+    std::shared_ptr<SolverProgressQueue> progress = std::make_shared<SolverProgressQueue>();
+    PCfrSolver* solver = nullptr; // While training; guarded by mutex_
+    bool cancel_requested = false;
+    bool finished = false;  // RunJob has set the final state
+    bool delivered = false; // Its final event was delivered
+    std::thread thread;
+};
+
+// A river cache kept across jobs with the same board, deck, ranges and
+// warmup setting, like BatchSolver's.
+struct SolveService::RiverCache {
+    std::shared_ptr<ranges::RiverRangeManager> rrm;
+    std::once_flag preloaded;
+};
+
+namespace {
+
+std::vector<std::vector<core::PrivateCards>> ParseRanges(const config::Scenario& scenario) {
+    std::vector<std::vector<core::PrivateCards>> player_ranges;
+    for (const std::string& range : scenario.ranges) {
+        player_ranges.push_back(
+            ranges::PrivateRangeConverter::StringToPrivateCards(range, scenario.rule.GetInitialBoardCardsInt()));
+    }
+    return player_ranges;
+}
+
+std::string RiverCacheKey(const SolveJob& job, uint64_t board_mask) {
+    return std::to_string(board_mask) + '/' + std::to_string(job.scenario.rule.GetDeck().GetCardsMask()) + '/' +
+           (job.config.warmup_river_cache ? "w/" : "l/") + job.scenario.ranges[0] + '/' + job.scenario.ranges[1];
+}
+
+// A progress event of a job whose final state may already be set.
+SolveJobStatus RunningEvent(SolveJobStatus status) {
+    status.state = SolveJobState::kRunning;
+    return status;
+}
+
+} // namespace
+
+const char* SolveJobStateName(SolveJobState state) {
+    switch (state) {
+        case SolveJobState::kQueued: return "queued";
+        case SolveJobState::kRunning: return "running";
+        case SolveJobState::kDone: return "done";
+        case SolveJobState::kFailed: return "failed";
+        case SolveJobState::kCancelled: return "cancelled";
+    }
+    return "unknown";
+}
+
+SolveService::Options::Options()
+    : num_threads(static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))),
+      river_caches(4),
+      poll_interval(100),
+      finished_jobs(1024) {}
+
+SolveService::SolveService(std::shared_ptr<core::Compairer> compairer, Options options, EventCallback on_event)
+    : compairer_(std::move(compairer)), options_(std::move(options)), on_event_(std::move(on_event)) {
+    if (!compairer_) throw std::invalid_argument("SolveService: compairer cannot be null.");
+    options_.num_threads = std::max(1, options_.num_threads);
+    scheduler_ = std::thread([this]() { SchedulerLoop(); });
+}
+
+SolveService::~SolveService() {
+    Shutdown(true);
+}
+
+uint64_t SolveService::Submit(SolveJob job) {
+    auto entry = std::make_shared<Job>(std::move(job));
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (shutting_down_) throw std::logic_error("SolveService: Submit after Shutdown.");
+    entry->status.id = next_id_++;
+    entry->status.threads = std::clamp(entry->spec.config.num_threads, 1, options_.num_threads);
+    jobs_[entry->status.id] = entry;
+    queue_.insert({-entry->spec.priority, entry->status.id});
+    ++active_jobs_;
+    pending_wake_ = true;
+    wake_.notify_one();
+    return entry->status.id;
+}
+
+bool SolveService::Cancel(uint64_t id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = jobs_.find(id);
+    if (it == jobs_.end()) return false;
+    Job& job = *it->second;
+    if (job.status.state == SolveJobState::kQueued) {
+        queue_.erase({-job.spec.priority, id});
+        job.status.state = SolveJobState::kCancelled;
+        job.finished = true;
+        cancelled_queued_.push_back(it->second);
+    } else if (job.status.state == SolveJobState::kRunning && !job.finished) {
+        // Picked up by RunJob if the solver does not exist yet.
+        job.cancel_requested = true;
+        if (job.solver) job.solver->Stop();
+    } else {
+        return false;
+    }
+    pending_wake_ = true;
+    wake_.notify_one();
+    return true;
+}
+
+std::optional<SolveJobStatus> SolveService::Status(uint64_t id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = jobs_.find(id);
+    if (it == jobs_.end()) return std::nullopt;
+    return it->second->status;
+}
+
+std::optional<SolveJobStatus> SolveService::Wait(uint64_t id) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = jobs_.find(id);
+    if (it == jobs_.end()) return std::nullopt;
+    std::shared_ptr<Job> job = it->second; // Outlives being forgotten
+    finished_.wait(lock, [&]() { return job->delivered; });
+    return job->status;
+}
+
+void SolveService::WaitIdle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    finished_.wait(lock, [&]() { return active_jobs_ == 0; });
+}
+
+void SolveService::Shutdown(bool cancel) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        shutting_down_ = true;
+        if (cancel) {
+            for (const auto& queued : queue_) {
+                const std::shared_ptr<Job>& job = jobs_.at(queued.second);
+                job->status.state = SolveJobState::kCancelled;
+                job->finished = true;
+                cancelled_queued_.push_back(job);
+            }
+            queue_.clear();
+            for (const auto& entry : jobs_) {
+                Job& job = *entry.second;
+                if (job.status.state != SolveJobState::kRunning || job.finished) continue;
+                job.cancel_requested = true;
+                if (job.solver) job.solver->Stop();
+            }
+        }
+        pending_wake_ = true;
+        wake_.notify_one();
+    }
+    if (scheduler_.joinable() && scheduler_.get_id() != std::this_thread::get_id()) scheduler_.join();
+}
+
+std::shared_ptr<SolveService::RiverCache> SolveService::AcquireRiverCache(const std::string& key) {
+    std::lock_guard<std::mutex> lock(river_mutex_);
+    for (auto it = river_caches_.begin(); it != river_caches_.end(); ++it) {
+        if (it->first == key) {
+            river_caches_.splice(river_caches_.begin(), river_caches_, it);
+            return it->second;
+        }
+    }
+    auto cache = std::make_shared<RiverCache>();
+    cache->rrm = std::make_shared<ranges::RiverRangeManager>(compairer_);
+    if (options_.river_caches > 0) {
+        river_caches_.emplace_front(key, cache);
+        // Running jobs keep their own reference to an evicted cache.
+        if (river_caches_.size() > options_.river_caches) river_caches_.pop_back();
+    }
+    return cache;
+}
+
+void SolveService::RunJob(const std::shared_ptr<Job>& job) {
+    const auto start = std::chrono::steady_clock::now();
+    const SolveJob& spec = job->spec;
+    SolveJobState state = SolveJobState::kDone;
+    std::string error;
+    std::optional<SolutionStore::Hit> cached;
+    try {
+        const int threads = job->status.threads; // Fixed once queued
+        omp_set_num_threads(threads);
+        PCfrSolver::Config config = spec.config;
+        config.num_threads = threads;
+        // The shared cache is preloaded once below instead of by each solver.
+        config.warmup_river_cache = false;
+
+        std::vector<std::vector<core::PrivateCards>> player_ranges = ParseRanges(spec.scenario);
+        std::optional<SpotKey> key;
+        if (options_.solution_store) {
+            key = SpotKey::Make(spec.scenario.rule, player_ranges, spec.config);
+            cached = options_.solution_store->Lookup(*key);
+        }
+        if (!cached) {
+            const uint64_t board_mask = core::Card::CardIntsToUint64(spec.scenario.rule.GetInitialBoardCardsInt());
+            const uint64_t deck_mask = spec.scenario.rule.GetDeck().GetCardsMask();
+            auto game_tree = std::make_shared<tree::GameTree>(spec.scenario.rule);
+            auto pcm = std::make_shared<ranges::PrivateCardsManager>(std::move(player_ranges), board_mask);
+            std::shared_ptr<RiverCache> river_cache = AcquireRiverCache(RiverCacheKey(spec, board_mask));
+            if (spec.config.warmup_river_cache) {
+                std::call_once(river_cache->preloaded, [&]() {
+                    river_cache->rrm->PreloadRiverBoards(pcm->GetPlayerRange(0), pcm->GetPlayerRange(1), board_mask,
+                                                         deck_mask);
+                });
+            }
+
+            PCfrSolver pcfr_solver(game_tree, pcm, river_cache->rrm, spec.scenario.rule, config);
+            pcfr_solver.SetProgressQueue(job->progress);
+            // Unregisters the solver before it is destroyed, also on exceptions.
+            struct Registration {
+                SolveService* service;
+                Job* job;
+                ~Registration() {
+                    std::lock_guard<std::mutex> lock(service->mutex_);
+                    job->solver = nullptr;
+                }
+            };
+            bool cancelled = false;
+            {
+                Registration registration{this, job.get()};
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    job->solver = &pcfr_solver;
+                    // A Stop() before Train() makes it return at once.
+                    if (job->cancel_requested) pcfr_solver.Stop();
+                }
+                pcfr_solver.Train();
+                std::lock_guard<std::mutex> lock(mutex_);
+                cancelled = job->cancel_requested;
+            }
+            if (cancelled) {
+                state = SolveJobState::kCancelled;
+            } else {
+                if (!spec.output_path.empty()) pcfr_solver.WriteStrategyFile(spec.output_path);
+                if (key) options_.solution_store->Store(*key, pcfr_solver);
+            }
+        }
+    } catch (const std::exception& e) {
+        state = SolveJobState::kFailed;
+        error = e.what();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    job->status.state = state;
+    job->status.error = error;
+    job->status.cached = cached;
+    job->status.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    job->finished = true;
+    pending_wake_ = true;
+    wake_.notify_one();
+}
+
+void SolveService::Emit(std::vector<SolveJobStatus>& events) {
+    if (on_event_) {
+        for (const SolveJobStatus& event : events) {
+            try {
+                on_event_(event);
+            } catch (const std::exception& e) {
+                std::cerr << "[ERROR] SolveService event callback: " << e.what() << std::endl;
+            }
+        }
+    }
+    events.clear();
+}
+
+void SolveService::SchedulerLoop() {
+    std::vector<std::shared_ptr<Job>> running; // Scheduler thread only
+    std::vector<std::shared_ptr<Job>> done;
+    std::vector<SolveJobStatus> events;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        pending_wake_ = false;
+        for (std::shared_ptr<Job>& job : cancelled_queued_) {
+            events.push_back(job->status);
+            done.push_back(std::move(job));
+        }
+        cancelled_queued_.clear();
+
+        // Start queued jobs in order while their budgets fit.
+        while (!queue_.empty()) {
+            std::shared_ptr<Job> job = jobs_.at(queue_.begin()->second);
+            if (running_threads_ + job->status.threads > options_.num_threads) break;
+            queue_.erase(queue_.begin());
+            running_threads_ += job->status.threads;
+            job->status.state = SolveJobState::kRunning;
+            events.push_back(job->status);
+            job->thread = std::thread([this, job]() { RunJob(job); });
+            running.push_back(std::move(job));
+        }
+
+        // Progress of running jobs, then the final state of finished ones.
+        for (size_t i = 0; i < running.size();) {
+            std::shared_ptr<Job> job = running[i];
+            // One event per poll for the latest report, plus any report
+            // that measured exploitability.
+            bool unreported = false;
+            while (std::optional<SolverProgress> progress = job->progress->Pop()) {
+                job->status.progress = *progress;
+                unreported = progress->exploitability < 0.0;
+                if (!unreported) events.push_back(RunningEvent(job->status));
+            }
+            if (unreported) events.push_back(RunningEvent(job->status));
+            if (!job->finished) {
+                ++i;
+                continue;
+            }
+            events.push_back(job->status);
+            running_threads_ -= job->status.threads;
+            done.push_back(std::move(job));
+            running[i] = std::move(running.back());
+            running.pop_back();
+        }
+
+        lock.unlock();
+        Emit(events);
+        for (const std::shared_ptr<Job>& job : done) {
+            if (job->thread.joinable()) job->thread.join();
+        }
+        lock.lock();
+        const bool freed = !done.empty();
+        if (freed) {
+            for (std::shared_ptr<Job>& job : done) {
+                job->delivered = true;
+                --active_jobs_;
+                finished_ids_.push_back(job->status.id);
+            }
+            done.clear();
+            while (finished_ids_.size() > options_.finished_jobs) {
+                jobs_.erase(finished_ids_.front());
+                finished_ids_.pop_front();
+            }
+            finished_.notify_all();
+        }
+
+        if (shutting_down_ && queue_.empty() && running.empty() && cancelled_queued_.empty()) return;
+        if (freed) continue; // Their threads may fit queued jobs
+        if (running.empty()) {
+            wake_.wait(lock, [&]() { return pending_wake_; });
+        } else {
+            wake_.wait_for(lock, options_.poll_interval, [&]() { return pending_wake_; });
+        }
+    }
+}
+
+} // namespace solver
+} // namespace poker_solver
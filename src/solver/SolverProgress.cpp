@@ -0,0 +1,63 @@
+#include "solver/SolverProgress.h"
+
+#include <fstream>
+
+#if defined(__linux__)
+#include <unistd.h> // For sysconf
+#endif
+
+namespace poker_solver {
+namespace solver {
+
+SolverProgressQueue::SolverProgressQueue(size_t capacity) {
+    size_t rounded = 2;
+    while (rounded < capacity) rounded <<= 1;
+    slots_.resize(rounded);
+    mask_ = rounded - 1;
+}
+
+bool SolverProgressQueue::Push(const SolverProgress& progress) {
+    const size_t write = write_index_.load(std::memory_order_relaxed);
+    if (write - read_index_.load(std::memory_order_acquire) >= slots_.size()) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    slots_[write & mask_] = progress;
+    // Publishes the slot to the consumer.
+    write_index_.store(write + 1, std::memory_order_release);
+    return true;
+}
+
+std::optional<SolverProgress> SolverProgressQueue::Pop() {
+    const size_t read = read_index_.load(std::memory_order_relaxed);
+    if (read == write_index_.load(std::memory_order_acquire)) return std::nullopt;
+    SolverProgress progress = slots_[read & mask_];
+    // Hands the slot back to the producer.
+    read_index_.store(read + 1, std::memory_order_release);
+    return progress;
+}
+
+uint64_t CurrentResidentBytes() {
+#if defined(__linux__)
+    // Second field of statm: resident pages.
+    std::ifstream statm("/proc/self/statm");
+    uint64_t total_pages = 0;
+    uint64_t resident_pages = 0;
+    if (statm >> total_pages >> resident_pages) {
+        return resident_pages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif
+    return 0;
+}
+
+uint64_t PhysicalMemoryBytes() {
+#if defined(__linux__)
+    const long pages = sysconf(_SC_PHYS_PAGES);
+    const long page_size = sysconf(_SC_PAGESIZE);
+    if (pages > 0 && page_size > 0) return static_cast<uint64_t>(pages) * static_cast<uint64_t>(page_size);
+#endif
+    return 0;
+}
+
+} // namespace solver
+} // namespace poker_solver
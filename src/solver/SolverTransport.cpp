@@ -0,0 +1,329 @@
+#include "solver/SolverTransport.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <netdb.h>       // For getaddrinfo
+#include <netinet/in.h>  // For sockaddr_in
+#include <netinet/tcp.h> // For TCP_NODELAY
+#include <sys/socket.h>
+#include <unistd.h>      // For close
+#define POKER_SOLVER_HAVE_SOCKETS 1
+#endif
+
+namespace poker_solver {
+namespace solver {
+
+namespace {
+
+// --- In-process group ---
+
+// One AllReduceSum round: ranks deposit their buffers, the last to arrive
+// sums them, then every rank copies the sum out. The next round starts once
+// all have copied, so the sum is never overwritten while being read.
+struct LocalGroupState {
+    explicit LocalGroupState(int size) : size(size), buffers(size), counts(size) {}
+
+    const int size;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<double*> buffers;
+    std::vector<size_t> counts;
+    std::vector<double> sum;
+    int arrived = 0;
+    int copied = 0;
+    bool distributing = false;
+    bool counts_match = true;
+};
+
+class LocalTransport : public SolverTransport {
+ public:
+    LocalTransport(std::shared_ptr<LocalGroupState> state, int rank) : state_(std::move(state)), rank_(rank) {}
+
+    int Rank() const override { return rank_; }
+    int Size() const override { return state_->size; }
+
+    void AllReduceSum(double* data, size_t count) override {
+        LocalGroupState& state = *state_;
+        std::unique_lock<std::mutex> lock(state.mutex);
+        state.changed.wait(lock, [&]() { return !state.distributing; });
+        state.buffers[rank_] = data;
+        state.counts[rank_] = count;
+        if (++state.arrived == state.size) {
+            state.counts_match = true;
+            for (int r = 1; r < state.size; ++r) state.counts_match &= state.counts[r] == state.counts[0];
+            if (state.counts_match) {
+                state.sum.assign(state.buffers[0], state.buffers[0] + count);
+                for (int r = 1; r < state.size; ++r) {
+                    for (size_t i = 0; i < count; ++i) state.sum[i] += state.buffers[r][i];
+                }
+            }
+            state.distributing = true;
+            state.changed.notify_all();
+        } else {
+            state.changed.wait(lock, [&]() { return state.distributing; });
+        }
+        const bool counts_match = state.counts_match;
+        if (counts_match) std::copy(state.sum.begin(), state.sum.end(), data);
+        if (++state.copied == state.size) {
+            state.arrived = 0;
+            state.copied = 0;
+            state.distributing = false;
+            state.changed.notify_all();
+        }
+        if (!counts_match) throw std::runtime_error("SolverTransport: ranks reduced vectors of different sizes.");
+    }
+
+ private:
+    std::shared_ptr<LocalGroupState> state_;
+    int rank_;
+};
+
+#ifdef POKER_SOLVER_HAVE_SOCKETS
+
+// --- TCP star ---
+
+constexpr uint32_t kHelloMagic = 0x50535452; // "PSTR"; a byte-swapped peer fails the check
+
+struct Hello {
+    uint32_t magic;
+    int32_t rank;
+    int32_t size;
+};
+
+void CheckRank(int rank, int size) {
+    if (size < 1 || rank < 0 || rank >= size) {
+        throw std::invalid_argument("SolverTransport: rank " + std::to_string(rank) + " is not in a group of " +
+                                    std::to_string(size) + ".");
+    }
+}
+
+std::string SystemError(const std::string& what) {
+    return "SolverTransport: " + what + ": " + std::strerror(errno);
+}
+
+void SendAll(int fd, const void* data, size_t bytes) {
+    const char* cursor = static_cast<const char*>(data);
+#ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL; // A closed peer is an error, not SIGPIPE
+#else
+    const int flags = 0;
+#endif
+    while (bytes > 0) {
+        ssize_t sent = ::send(fd, cursor, bytes, flags);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) throw std::runtime_error(SystemError("send failed"));
+        cursor += sent;
+        bytes -= static_cast<size_t>(sent);
+    }
+}
+
+void ReceiveAll(int fd, void* data, size_t bytes) {
+    char* cursor = static_cast<char*>(data);
+    while (bytes > 0) {
+        ssize_t received = ::recv(fd, cursor, bytes, 0);
+        if (received < 0 && errno == EINTR) continue;
+        if (received == 0) throw std::runtime_error("SolverTransport: peer disconnected.");
+        if (received < 0) throw std::runtime_error(SystemError("receive failed"));
+        cursor += received;
+        bytes -= static_cast<size_t>(received);
+    }
+}
+
+void SetNoDelay(int fd) {
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+class TcpTransport : public SolverTransport {
+ public:
+    // peers: socket per rank (coordinator: one per worker, -1 for itself;
+    // worker: just the coordinator's at index 0).
+    TcpTransport(int rank, int size, std::vector<int> peers) : rank_(rank), size_(size), peers_(std::move(peers)) {}
+
+    ~TcpTransport() override {
+        for (int fd : peers_) {
+            if (fd >= 0) ::close(fd);
+        }
+    }
+
+    int Rank() const override { return rank_; }
+    int Size() const override { return size_; }
+
+    void AllReduceSum(double* data, size_t count) override {
+        const uint64_t count64 = count;
+        if (rank_ != 0) {
+            SendAll(peers_[0], &count64, sizeof(count64));
+            SendAll(peers_[0], data, count * sizeof(double));
+            uint64_t reply_count = 0;
+            ReceiveAll(peers_[0], &reply_count, sizeof(reply_count));
+            if (reply_count != count64) {
+                throw std::runtime_error("SolverTransport: ranks reduced vectors of different sizes.");
+            }
+            ReceiveAll(peers_[0], data, count * sizeof(double));
+            return;
+        }
+        // Workers are read in rank order, so the sum matches the local group's.
+        buffer_.resize(count);
+        bool counts_match = true;
+        for (int r = 1; r < size_; ++r) {
+            uint64_t worker_count = 0;
+            ReceiveAll(peers_[r], &worker_count, sizeof(worker_count));
+            if (worker_count != count64) {
+                counts_match = false;
+                std::vector<double> discard(worker_count);
+                ReceiveAll(peers_[r], discard.data(), discard.size() * sizeof(double));
+                continue;
+            }
+            ReceiveAll(peers_[r], buffer_.data(), count * sizeof(double));
+            for (size_t i = 0; i < count; ++i) data[i] += buffer_[i];
+        }
+        // A mismatch is sent as a zero count so every worker fails too.
+        const uint64_t reply_count = counts_match ? count64 : 0;
+        for (int r = 1; r < size_; ++r) {
+            SendAll(peers_[r], &reply_count, sizeof(reply_count));
+            if (counts_match) SendAll(peers_[r], data, count * sizeof(double));
+        }
+        if (!counts_match) throw std::runtime_error("SolverTransport: ranks reduced vectors of different sizes.");
+    }
+
+ private:
+    int rank_;
+    int size_;
+    std::vector<int> peers_;
+    std::vector<double> buffer_;
+};
+
+#endif // POKER_SOLVER_HAVE_SOCKETS
+
+} // namespace
+
+std::vector<std::shared_ptr<SolverTransport>> CreateLocalTransportGroup(int size) {
+    if (size < 1) throw std::invalid_argument("CreateLocalTransportGroup: size must be at least 1.");
+    auto state = std::make_shared<LocalGroupState>(size);
+    std::vector<std::shared_ptr<SolverTransport>> group;
+    for (int rank = 0; rank < size; ++rank) group.push_back(std::make_shared<LocalTransport>(state, rank));
+    return group;
+}
+
+#ifdef POKER_SOLVER_HAVE_SOCKETS
+
+std::shared_ptr<SolverTransport> CreateTcpCoordinator(uint16_t port, int size) {
+    CheckRank(0, size);
+    std::vector<int> peers(size, -1);
+    auto close_all = [&]() {
+        for (int fd : peers) {
+            if (fd >= 0) ::close(fd);
+        }
+    };
+    int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listener < 0) throw std::runtime_error(SystemError("cannot create socket"));
+    int one = 1;
+    ::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listener, size) != 0) {
+        const std::string error = SystemError("cannot listen on port " + std::to_string(port));
+        ::close(listener);
+        throw std::runtime_error(error);
+    }
+    try {
+        for (int connected = 1; connected < size; ++connected) {
+            int fd = ::accept(listener, nullptr, nullptr);
+            if (fd < 0) {
+                if (errno == EINTR) {
+                    --connected;
+                    continue;
+                }
+                throw std::runtime_error(SystemError("accept failed"));
+            }
+            Hello hello{};
+            try {
+                ReceiveAll(fd, &hello, sizeof(hello));
+            } catch (...) {
+                ::close(fd);
+                throw;
+            }
+            if (hello.magic != kHelloMagic || hello.size != size || hello.rank < 1 || hello.rank >= size ||
+                peers[hello.rank] >= 0) {
+                ::close(fd);
+                throw std::runtime_error("SolverTransport: rejected worker announcing rank " +
+                                         std::to_string(hello.rank) + " of " + std::to_string(hello.size) + ".");
+            }
+            SetNoDelay(fd);
+            peers[hello.rank] = fd;
+        }
+    } catch (...) {
+        ::close(listener);
+        close_all();
+        throw;
+    }
+    ::close(listener);
+    return std::make_shared<TcpTransport>(0, size, std::move(peers));
+}
+
+std::shared_ptr<SolverTransport> CreateTcpWorker(const std::string& host, uint16_t port, int rank, int size,
+                                                 int connect_timeout_seconds) {
+    CheckRank(rank, size);
+    if (rank == 0) throw std::invalid_argument("CreateTcpWorker: rank 0 is the coordinator.");
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    if (::getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0 || !addresses) {
+        throw std::runtime_error("SolverTransport: cannot resolve coordinator host '" + host + "'.");
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(connect_timeout_seconds);
+    int fd = -1;
+    while (fd < 0) {
+        for (addrinfo* a = addresses; a && fd < 0; a = a->ai_next) {
+            fd = ::socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+            if (fd >= 0 && ::connect(fd, a->ai_addr, a->ai_addrlen) != 0) {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+        if (fd >= 0 || std::chrono::steady_clock::now() >= deadline) break;
+        // The coordinator may not be listening yet.
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+    ::freeaddrinfo(addresses);
+    if (fd < 0) {
+        throw std::runtime_error("SolverTransport: cannot connect to coordinator " + host + ":" +
+                                 std::to_string(port) + ".");
+    }
+    SetNoDelay(fd);
+    const Hello hello{kHelloMagic, rank, size};
+    try {
+        SendAll(fd, &hello, sizeof(hello));
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    return std::make_shared<TcpTransport>(rank, size, std::vector<int>{fd});
+}
+
+#else
+
+std::shared_ptr<SolverTransport> CreateTcpCoordinator(uint16_t, int) {
+    throw std::runtime_error("SolverTransport: TCP is not supported on this platform.");
+}
+
+std::shared_ptr<SolverTransport> CreateTcpWorker(const std::string&, uint16_t, int, int, int) {
+    throw std::runtime_error("SolverTransport: TCP is not supported on this platform.");
+}
+
+#endif // POKER_SOLVER_HAVE_SOCKETS
+
+} // namespace solver
+} // namespace poker_solver
@@ -0,0 +1,507 @@
+#include "solver/StrategyFile.h"
+#include "tools/BinaryIo.h" // For WriteRaw and checksums
+#include <algorithm>  // For std::minmax_element
+#include <cmath>      // For std::ldexp, std::round
+#include <cstring>    // For std::memcpy, std::memcmp
+#include <filesystem> // For renaming files into place
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace poker_solver {
+namespace solver {
+
+namespace {
+
+constexpr char kStrategyMagic[8] = {'P', 'S', 'S', 'T', 'R', 'A', 'T', '1'};
+constexpr uint32_t kStrategyVersion = 1;
+constexpr size_t kValuesAlignment = 64;
+
+struct StrategyFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint8_t value_type;
+    uint8_t reserved[3];
+    uint64_t num_nodes;
+    uint64_t num_slots;
+    uint64_t strings_bytes;
+    uint32_t num_hands[2];
+    uint64_t values_bytes;
+    uint64_t checksum; // FNV-1a of the hands, node table, slots and strings
+};
+static_assert(sizeof(StrategyFileHeader) == 64, "Strategy file header must be 64 bytes");
+
+struct StrategyFileNode {
+    uint64_t path_hash;
+    uint64_t path_offset;    // Into the strings
+    uint64_t actions_offset; // Into the strings
+    uint64_t values_offset;  // Into the values section
+    uint32_t path_length;
+    uint32_t actions_length;
+    uint32_t num_actions;
+    uint32_t num_hands;
+    uint8_t player;
+    uint8_t has_evs;
+    uint8_t reserved[2];
+    float strategy_scale; // kUint8 only, as in QuantizedScale
+    float ev_offset;
+    float ev_scale;
+};
+static_assert(sizeof(StrategyFileNode) == 64, "Strategy file node entry must be 64 bytes");
+
+uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+uint64_t PathHash(std::string_view path) {
+    utils::Fnv1a hash;
+    hash.AddBytes(path.data(), path.size());
+    return hash.Value();
+}
+
+size_t ValueSize(StrategyValueType value_type) {
+    switch (value_type) {
+        case StrategyValueType::kFloat16: return sizeof(uint16_t);
+        case StrategyValueType::kUint8: return sizeof(uint8_t);
+        default: return sizeof(float);
+    }
+}
+
+// Affine scale mapping [min, max] of 'values' onto bytes; strategies keep
+// offset 0 so a zero probability stays exact.
+QuantizedScale ByteScale(const std::vector<double>& values, bool from_zero) {
+    if (values.empty()) return {};
+    const auto [min, max] = std::minmax_element(values.begin(), values.end());
+    QuantizedScale scale;
+    scale.offset = from_zero ? 0.0f : static_cast<float>(*min);
+    scale.scale = static_cast<float>((*max - scale.offset) / 255.0);
+    if (!(scale.scale > 0.0f)) scale.scale = 1.0f; // Constant matrix
+    return scale;
+}
+
+// Bytes of a node's matrices, padded to keep the next node 8-byte aligned.
+uint64_t NodeValueBytes(uint64_t num_actions, uint64_t num_hands, bool has_evs, size_t value_size) {
+    return AlignUp(num_actions * num_hands * value_size * (has_evs ? 2 : 1), 8);
+}
+
+// Section offsets from the start of the file, derived from the header.
+struct StrategyFileLayout {
+    uint64_t nodes;
+    uint64_t slots;
+    uint64_t strings;
+    uint64_t values;
+    uint64_t size;
+
+    StrategyFileLayout(uint64_t num_hands, uint64_t num_nodes, uint64_t num_slots, uint64_t strings_bytes,
+                       uint64_t values_bytes) {
+        nodes = AlignUp(sizeof(StrategyFileHeader) + 2 * num_hands, 8);
+        slots = nodes + num_nodes * sizeof(StrategyFileNode);
+        strings = slots + num_slots * sizeof(uint32_t);
+        values = AlignUp(strings + strings_bytes, kValuesAlignment);
+        size = values + values_bytes;
+    }
+};
+
+StrategyFileNode ReadNodeEntry(const unsigned char* nodes, size_t node) {
+    StrategyFileNode entry;
+    std::memcpy(&entry, nodes + node * sizeof(StrategyFileNode), sizeof(entry));
+    return entry;
+}
+
+} // namespace
+
+// --- Half Precision ---
+
+uint16_t FloatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+    const uint32_t magnitude = bits & 0x7FFFFFFFu;
+    if (magnitude >= 0x7F800000u) { // Infinity or NaN
+        return sign | (magnitude > 0x7F800000u ? 0x7E00u : 0x7C00u);
+    }
+    if (magnitude >= 0x477FF000u) return sign | 0x7C00u; // Rounds past 65504
+    if (magnitude < 0x38800000u) {                        // Below 2^-14: subnormal
+        if (magnitude < 0x33000000u) return sign;         // Below 2^-25: zero
+        const uint32_t mantissa = (magnitude & 0x7FFFFFu) | 0x800000u;
+        const uint32_t shift = 126 - (magnitude >> 23);
+        uint32_t half = mantissa >> shift;
+        const uint32_t remainder = mantissa & ((1u << shift) - 1);
+        const uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half & 1u))) ++half;
+        return static_cast<uint16_t>(sign | half);
+    }
+    // Rebias the exponent and drop 13 mantissa bits; a carry may roll into
+    // the exponent, which is still the right encoding.
+    uint32_t half = (magnitude >> 13) - ((127u - 15u) << 10);
+    const uint32_t remainder = magnitude & 0x1FFFu;
+    if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) ++half;
+    return static_cast<uint16_t>(sign | half);
+}
+
+float HalfToFloat(uint16_t half) {
+    const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+    const uint32_t exponent = (half >> 10) & 0x1Fu;
+    const uint32_t mantissa = half & 0x3FFu;
+    uint32_t bits;
+    if (exponent == 0x1Fu) {
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    } else if (exponent == 0) {
+        const float magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+        return sign ? -magnitude : magnitude;
+    } else {
+        bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+    }
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// --- Writer ---
+
+StrategyFileWriter::StrategyFileWriter(StrategyValueType value_type,
+                                       const std::array<std::vector<core::PrivateCards>, 2>& ranges)
+    : value_type_(value_type) {
+    for (size_t p = 0; p < 2; ++p) {
+        hands_[p].reserve(2 * ranges[p].size());
+        for (const auto& hand : ranges[p]) {
+            hands_[p].push_back(static_cast<uint8_t>(hand.Card1Int()));
+            hands_[p].push_back(static_cast<uint8_t>(hand.Card2Int()));
+        }
+    }
+}
+
+size_t StrategyFileWriter::AddNode(const std::string& path, size_t player,
+                                   const std::vector<std::string>& actions, bool has_evs) {
+    if (player > 1) throw std::invalid_argument("StrategyFileWriter: player must be 0 or 1.");
+    if (actions.empty()) throw std::invalid_argument("StrategyFileWriter: node '" + path + "' has no actions.");
+    PendingNode node;
+    node.path_hash = PathHash(path);
+    node.path_offset = strings_.size();
+    node.path_length = static_cast<uint32_t>(path.size());
+    strings_ += path;
+    node.actions_offset = strings_.size();
+    for (size_t a = 0; a < actions.size(); ++a) {
+        if (actions[a].find('\n') != std::string::npos) {
+            throw std::invalid_argument("StrategyFileWriter: action label '" + actions[a] + "' contains a newline.");
+        }
+        if (a > 0) strings_ += '\n';
+        strings_ += actions[a];
+    }
+    node.actions_length = static_cast<uint32_t>(strings_.size() - node.actions_offset);
+    node.num_actions = static_cast<uint32_t>(actions.size());
+    node.player = static_cast<uint8_t>(player);
+    node.has_evs = has_evs;
+    nodes_.push_back(node);
+    return nodes_.size() - 1;
+}
+
+void StrategyFileWriter::Write(const std::string& path, const NodeValues& values) const {
+    if (nodes_.size() >= std::numeric_limits<uint32_t>::max()) {
+        throw std::invalid_argument("StrategyFileWriter: too many nodes for 32-bit slots.");
+    }
+    const size_t value_size = ValueSize(value_type_);
+
+    // Node table, with each node's values placed back to back.
+    std::vector<StrategyFileNode> entries(nodes_.size());
+    uint64_t values_bytes = 0;
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        const PendingNode& node = nodes_[i];
+        StrategyFileNode& entry = entries[i];
+        entry = StrategyFileNode{};
+        entry.path_hash = node.path_hash;
+        entry.path_offset = node.path_offset;
+        entry.path_length = node.path_length;
+        entry.actions_offset = node.actions_offset;
+        entry.actions_length = node.actions_length;
+        entry.num_actions = node.num_actions;
+        entry.num_hands = static_cast<uint32_t>(hands_[node.player].size() / 2);
+        entry.player = node.player;
+        entry.has_evs = node.has_evs ? 1 : 0;
+        entry.values_offset = values_bytes;
+        values_bytes += NodeValueBytes(entry.num_actions, entry.num_hands, node.has_evs, value_size);
+    }
+
+    // Hash slots: linear probing over a table at most half full.
+    uint64_t num_slots = 2;
+    while (num_slots < 2 * nodes_.size()) num_slots *= 2;
+    std::vector<uint32_t> slots(num_slots, 0);
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        const std::string_view node_path(strings_.data() + nodes_[i].path_offset, nodes_[i].path_length);
+        uint64_t slot = nodes_[i].path_hash & (num_slots - 1);
+        for (; slots[slot] != 0; slot = (slot + 1) & (num_slots - 1)) {
+            const PendingNode& other = nodes_[slots[slot] - 1];
+            if (other.path_hash == nodes_[i].path_hash &&
+                std::string_view(strings_.data() + other.path_offset, other.path_length) == node_path) {
+                throw std::invalid_argument("StrategyFileWriter: repeated node path '" + std::string(node_path) + "'.");
+            }
+        }
+        slots[slot] = static_cast<uint32_t>(i + 1);
+    }
+
+    StrategyFileHeader header{};
+    std::memcpy(header.magic, kStrategyMagic, sizeof(kStrategyMagic));
+    header.version = kStrategyVersion;
+    header.value_type = static_cast<uint8_t>(value_type_);
+    header.num_nodes = nodes_.size();
+    header.num_slots = num_slots;
+    header.strings_bytes = strings_.size();
+    header.num_hands[0] = static_cast<uint32_t>(hands_[0].size() / 2);
+    header.num_hands[1] = static_cast<uint32_t>(hands_[1].size() / 2);
+    header.values_bytes = values_bytes;
+    const StrategyFileLayout layout(header.num_hands[0] + header.num_hands[1], header.num_nodes, num_slots,
+                                    header.strings_bytes, values_bytes);
+    const std::vector<char> hands_padding(layout.nodes - sizeof(StrategyFileHeader) - hands_[0].size() -
+                                          hands_[1].size(), 0);
+    const std::vector<char> strings_padding(layout.values - layout.strings - strings_.size(), 0);
+    std::string temporary_path = path + ".tmp";
+    try {
+        std::ofstream out(temporary_path, std::ios::binary | std::ios::trunc);
+        if (!out) throw std::runtime_error("cannot open for writing");
+        utils::WriteRaw(out, &header, 1);
+        utils::WriteRaw(out, hands_[0].data(), hands_[0].size());
+        utils::WriteRaw(out, hands_[1].data(), hands_[1].size());
+        utils::WriteRaw(out, hands_padding.data(), hands_padding.size());
+        utils::WriteRaw(out, entries.data(), entries.size());
+        utils::WriteRaw(out, slots.data(), slots.size());
+        utils::WriteRaw(out, strings_.data(), strings_.size());
+        utils::WriteRaw(out, strings_padding.data(), strings_padding.size());
+
+        // Values, one node at a time, transposed to action-major.
+        std::vector<double> strategy;
+        std::vector<double> evs;
+        std::vector<unsigned char> buffer;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            StrategyFileNode& entry = entries[i];
+            const size_t count = static_cast<size_t>(entry.num_actions) * entry.num_hands;
+            strategy.clear();
+            evs.clear();
+            values(i, strategy, evs);
+            if (strategy.size() != count || (entry.has_evs && evs.size() != count)) {
+                throw std::runtime_error("values of node '" +
+                                         strings_.substr(entry.path_offset, entry.path_length) +
+                                         "' do not match its actions and hands");
+            }
+            buffer.assign(NodeValueBytes(entry.num_actions, entry.num_hands, entry.has_evs, value_size), 0);
+            unsigned char* cursor = buffer.data();
+            for (const std::vector<double>* matrix : {&strategy, &evs}) {
+                if (matrix == &evs && !entry.has_evs) break;
+                QuantizedScale scale;
+                if (value_type_ == StrategyValueType::kUint8) {
+                    scale = ByteScale(*matrix, matrix == &strategy);
+                    if (matrix == &strategy) {
+                        entry.strategy_scale = scale.scale;
+                    } else {
+                        entry.ev_offset = scale.offset;
+                        entry.ev_scale = scale.scale;
+                    }
+                }
+                for (size_t a = 0; a < entry.num_actions; ++a) {
+                    for (size_t h = 0; h < entry.num_hands; ++h) {
+                        const float value = static_cast<float>((*matrix)[h * entry.num_actions + a]);
+                        if (value_type_ == StrategyValueType::kFloat16) {
+                            const uint16_t half = FloatToHalf(value);
+                            std::memcpy(cursor, &half, sizeof(half));
+                        } else if (value_type_ == StrategyValueType::kUint8) {
+                            const float level = std::round((value - scale.offset) / scale.scale);
+                            *cursor = static_cast<uint8_t>(std::clamp(level, 0.0f, 255.0f));
+                        } else {
+                            std::memcpy(cursor, &value, sizeof(value));
+                        }
+                        cursor += value_size;
+                    }
+                }
+            }
+            utils::WriteRaw(out, buffer.data(), buffer.size());
+        }
+
+        // kUint8 scales are known only now, so the header and node table
+        // are written again with them and the checksum.
+        utils::Fnv1a checksum;
+        checksum.AddBytes(hands_[0].data(), hands_[0].size());
+        checksum.AddBytes(hands_[1].data(), hands_[1].size());
+        checksum.AddBytes(hands_padding.data(), hands_padding.size());
+        checksum.AddBytes(entries.data(), entries.size() * sizeof(StrategyFileNode));
+        checksum.AddBytes(slots.data(), slots.size() * sizeof(uint32_t));
+        checksum.AddBytes(strings_.data(), strings_.size());
+        header.checksum = checksum.Value();
+        out.seekp(0);
+        utils::WriteRaw(out, &header, 1);
+        out.seekp(static_cast<std::streamoff>(layout.nodes));
+        utils::WriteRaw(out, entries.data(), entries.size());
+        out.close();
+        if (!out) throw std::runtime_error("write failed");
+        fs::rename(temporary_path, path);
+    } catch (const std::exception& e) {
+        std::error_code ignored;
+        fs::remove(temporary_path, ignored);
+        throw std::runtime_error("StrategyFileWriter: failed to write strategy file '" + path + "': " + e.what());
+    }
+}
+
+// --- Reader ---
+
+StrategyFile::StrategyFile(const std::string& path) : file_(path) {
+    auto fail = [&](const std::string& reason) {
+        return std::runtime_error("StrategyFile: '" + path + "' " + reason + ".");
+    };
+    if (file_.Size() < sizeof(StrategyFileHeader)) throw fail("is too small to be a strategy file");
+    StrategyFileHeader header;
+    std::memcpy(&header, file_.Data(), sizeof(header));
+    if (std::memcmp(header.magic, kStrategyMagic, sizeof(kStrategyMagic)) != 0) throw fail("is not a strategy file");
+    if (header.version != kStrategyVersion) {
+        throw fail("has unsupported version " + std::to_string(header.version));
+    }
+    if (header.value_type > static_cast<uint8_t>(StrategyValueType::kUint8)) throw fail("has an unknown value type");
+    // Counts are bounded by the file size first, so the layout cannot overflow.
+    const uint64_t size = file_.Size();
+    if (header.num_nodes > size / sizeof(StrategyFileNode) || header.num_slots > size / sizeof(uint32_t) ||
+        header.strings_bytes > size || header.values_bytes > size ||
+        header.num_slots < 2 || (header.num_slots & (header.num_slots - 1)) != 0 ||
+        header.num_slots < header.num_nodes) {
+        throw fail("has an inconsistent layout");
+    }
+    const StrategyFileLayout layout(uint64_t{header.num_hands[0]} + header.num_hands[1], header.num_nodes,
+                                    header.num_slots, header.strings_bytes, header.values_bytes);
+    if (layout.size != size) throw fail("has an inconsistent layout");
+    utils::Fnv1a checksum;
+    checksum.AddBytes(file_.Data() + sizeof(StrategyFileHeader),
+                      layout.strings + header.strings_bytes - sizeof(StrategyFileHeader));
+    if (checksum.Value() != header.checksum) throw fail("fails its checksum");
+
+    value_type_ = static_cast<StrategyValueType>(header.value_type);
+    value_size_ = ValueSize(value_type_);
+    num_nodes_ = header.num_nodes;
+    slot_mask_ = header.num_slots - 1;
+    num_hands_ = {header.num_hands[0], header.num_hands[1]};
+    hands_ = file_.Data() + sizeof(StrategyFileHeader);
+    nodes_ = file_.Data() + layout.nodes;
+    slots_ = file_.Data() + layout.slots;
+    strings_ = reinterpret_cast<const char*>(file_.Data() + layout.strings);
+    values_ = file_.Data() + layout.values;
+
+    // Entries point inside their sections; the accessors rely on it.
+    for (size_t i = 0; i < num_nodes_; ++i) {
+        const StrategyFileNode entry = ReadNodeEntry(nodes_, i);
+        if (entry.player > 1 || entry.num_hands != num_hands_[entry.player] ||
+            entry.path_offset > header.strings_bytes ||
+            entry.path_length > header.strings_bytes - entry.path_offset ||
+            entry.actions_offset > header.strings_bytes ||
+            entry.actions_length > header.strings_bytes - entry.actions_offset ||
+            entry.values_offset > header.values_bytes ||
+            NodeValueBytes(entry.num_actions, entry.num_hands, entry.has_evs, value_size_) >
+                header.values_bytes - entry.values_offset) {
+            throw fail("has an invalid node entry");
+        }
+    }
+    for (uint64_t slot = 0; slot <= slot_mask_; ++slot) {
+        uint32_t value;
+        std::memcpy(&value, slots_ + slot * sizeof(uint32_t), sizeof(value));
+        if (value > num_nodes_) throw fail("has an invalid hash slot");
+    }
+}
+
+std::optional<size_t> StrategyFile::Find(std::string_view path) const {
+    const uint64_t hash = PathHash(path);
+    for (uint64_t slot = hash & slot_mask_, probes = 0; probes <= slot_mask_; slot = (slot + 1) & slot_mask_, ++probes) {
+        uint32_t value;
+        std::memcpy(&value, slots_ + slot * sizeof(uint32_t), sizeof(value));
+        if (value == 0) break;
+        const size_t node = value - 1;
+        if (ReadNodeEntry(nodes_, node).path_hash == hash && Path(node) == path) return node;
+    }
+    return std::nullopt;
+}
+
+std::string_view StrategyFile::Path(size_t node) const {
+    const StrategyFileNode entry = ReadNodeEntry(nodes_, node);
+    return std::string_view(strings_ + entry.path_offset, entry.path_length);
+}
+
+size_t StrategyFile::Player(size_t node) const { return ReadNodeEntry(nodes_, node).player; }
+size_t StrategyFile::NumActions(size_t node) const { return ReadNodeEntry(nodes_, node).num_actions; }
+size_t StrategyFile::NumHands(size_t node) const { return ReadNodeEntry(nodes_, node).num_hands; }
+bool StrategyFile::HasEvs(size_t node) const { return ReadNodeEntry(nodes_, node).has_evs != 0; }
+
+std::vector<std::string> StrategyFile::Actions(size_t node) const {
+    const StrategyFileNode entry = ReadNodeEntry(nodes_, node);
+    std::vector<std::string> actions;
+    std::string_view labels(strings_ + entry.actions_offset, entry.actions_length);
+    for (size_t start = 0;;) {
+        size_t end = labels.find('\n', start);
+        actions.emplace_back(labels.substr(start, end == std::string_view::npos ? end : end - start));
+        if (end == std::string_view::npos) break;
+        start = end + 1;
+    }
+    return actions;
+}
+
+core::PrivateCards StrategyFile::Hand(size_t node, size_t hand) const {
+    const size_t player = Player(node);
+    const unsigned char* cards = hands_ + 2 * ((player == 0 ? 0 : num_hands_[0]) + hand);
+    return core::PrivateCards(cards[0], cards[1]);
+}
+
+float StrategyFile::Value(const unsigned char* values, size_t index, QuantizedScale scale) const {
+    if (value_type_ == StrategyValueType::kUint8) return scale.offset + values[index] * scale.scale;
+    if (value_type_ == StrategyValueType::kFloat16) {
+        uint16_t half;
+        std::memcpy(&half, values + index * sizeof(half), sizeof(half));
+        return HalfToFloat(half);
+    }
+    float value;
+    std::memcpy(&value, values + index * sizeof(value), sizeof(value));
+    return value;
+}
+
+const unsigned char* StrategyFile::StrategyValues(size_t node) const {
+    return values_ + ReadNodeEntry(nodes_, node).values_offset;
+}
+
+const unsigned char* StrategyFile::EvValues(size_t node) const {
+    const StrategyFileNode entry = ReadNodeEntry(nodes_, node);
+    if (!entry.has_evs) return nullptr;
+    return values_ + entry.values_offset + static_cast<size_t>(entry.num_actions) * entry.num_hands * value_size_;
+}
+
+QuantizedScale StrategyFile::StrategyScale(size_t node) const {
+    if (value_type_ != StrategyValueType::kUint8) return {};
+    return {0.0f, ReadNodeEntry(nodes_, node).strategy_scale};
+}
+
+QuantizedScale StrategyFile::EvScale(size_t node) const {
+    const StrategyFileNode entry = ReadNodeEntry(nodes_, node);
+    if (value_type_ != StrategyValueType::kUint8 || !entry.has_evs) return {};
+    return {entry.ev_offset, entry.ev_scale};
+}
+
+std::vector<float> StrategyFile::Matrix(const unsigned char* values, size_t count, QuantizedScale scale) const {
+    std::vector<float> matrix(count);
+    for (size_t i = 0; i < count; ++i) matrix[i] = Value(values, i, scale);
+    return matrix;
+}
+
+float StrategyFile::Strategy(size_t node, size_t action, size_t hand) const {
+    return Value(StrategyValues(node), action * NumHands(node) + hand, StrategyScale(node));
+}
+
+float StrategyFile::Ev(size_t node, size_t action, size_t hand) const {
+    const unsigned char* evs = EvValues(node);
+    if (!evs) return std::numeric_limits<float>::quiet_NaN();
+    return Value(evs, action * NumHands(node) + hand, EvScale(node));
+}
+
+std::vector<float> StrategyFile::StrategyMatrix(size_t node) const {
+    return Matrix(StrategyValues(node), NumActions(node) * NumHands(node), StrategyScale(node));
+}
+
+std::vector<float> StrategyFile::EvMatrix(size_t node) const {
+    const unsigned char* evs = EvValues(node);
+    if (!evs) return {};
+    return Matrix(evs, NumActions(node) * NumHands(node), EvScale(node));
+}
+
+} // namespace solver
+} // namespace poker_solver
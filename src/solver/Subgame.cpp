@@ -0,0 +1,60 @@
+#include "solver/Subgame.h"
+
+#include "Card.h"
+#include "GameTree.h"
+#include "ranges/PrivateCardsManager.h"
+#include "ranges/RiverRangeManager.h"
+
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace poker_solver {
+namespace solver {
+
+config::Rule SubgameRule(const PCfrSolver::Subgame& subgame, const config::Rule& rule,
+                         const config::GameTreeBuildingSettings& build_settings) {
+    config::Rule subgame_rule(rule.GetDeck(), subgame.pot / 2.0, subgame.pot / 2.0, subgame.round, subgame.board,
+                              rule.GetRaiseLimitPerStreet(), rule.GetSmallBlind(), rule.GetBigBlind(),
+                              rule.GetInitialEffectiveStack(), build_settings, rule.GetAllInThresholdRatio());
+    subgame_rule.SetDepthLimited(rule.IsDepthLimited());
+    return subgame_rule;
+}
+
+std::unique_ptr<PCfrSolver> ResolveSubgame(const PCfrSolver::Subgame& subgame, const config::Rule& rule,
+                                           const config::GameTreeBuildingSettings& build_settings,
+                                           std::shared_ptr<core::Compairer> compairer,
+                                           const PCfrSolver::Config& config,
+                                           const ResolveOptions& options) {
+    if (!compairer) throw std::invalid_argument("ResolveSubgame: compairer cannot be null.");
+    if (options.resolving_player > 1) throw std::invalid_argument("ResolveSubgame: resolving_player must be 0 or 1.");
+    for (const auto& range : subgame.ranges) {
+        if (range.empty()) throw std::invalid_argument("ResolveSubgame: a player never reaches the subgame.");
+    }
+
+    config::Rule subgame_rule = SubgameRule(subgame, rule, build_settings);
+    if (options.depth_limited) subgame_rule.SetDepthLimited(true);
+    const uint64_t board_mask = core::Card::CardIntsToUint64(subgame.board);
+    auto game_tree = std::make_shared<tree::GameTree>(subgame_rule);
+    auto pcm = std::make_shared<ranges::PrivateCardsManager>(
+        std::vector<std::vector<core::PrivateCards>>{subgame.ranges[0], subgame.ranges[1]}, board_mask);
+    auto rrm = std::make_shared<ranges::RiverRangeManager>(std::move(compairer));
+    auto solver = std::make_unique<PCfrSolver>(game_tree, pcm, rrm, subgame_rule, config);
+    solver->SetLeafValueEstimator(options.leaf_estimator);
+
+    if (options.safe) {
+        // The manager drops hands the subgame cannot hold; values follow its order.
+        const size_t gadget_player = 1 - options.resolving_player;
+        const std::vector<double>& values = subgame.values[gadget_player];
+        std::vector<double> compact_values;
+        for (int32_t original : pcm->GetOriginalHandIndices(gadget_player)) {
+            compact_values.push_back(static_cast<size_t>(original) < values.size() ? values[original] : 0.0);
+        }
+        solver->SetResolveGadget(gadget_player, std::move(compact_values));
+    }
+    solver->Train();
+    return solver;
+}
+
+} // namespace solver
+} // namespace poker_solver
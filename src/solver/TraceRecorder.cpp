@@ -0,0 +1,112 @@
+#include "solver/TraceRecorder.h"
+
+#include <algorithm> // For std::min
+#include <fstream>
+#include <iomanip>   // For std::setprecision
+#include <stdexcept>
+
+namespace poker_solver {
+namespace solver {
+
+namespace {
+
+std::atomic<uint64_t> g_next_recorder_id{1};
+
+// Ring the calling thread last recorded into, and the recorder it belongs to.
+struct ThreadRing {
+  uint64_t recorder_id = 0;
+  void* ring = nullptr;
+};
+thread_local ThreadRing tls_ring;
+
+} // namespace
+
+TraceRecorder::TraceRecorder(size_t events_per_thread)
+    : id_(g_next_recorder_id++),
+      events_per_thread_(events_per_thread),
+      origin_(std::chrono::steady_clock::now()) {
+    if (events_per_thread_ == 0) {
+        throw std::invalid_argument("TraceRecorder: events_per_thread must be positive.");
+    }
+}
+
+TraceRecorder::Ring& TraceRecorder::ForCurrentThread() {
+    if (tls_ring.recorder_id != id_) {
+        const std::thread::id self = std::this_thread::get_id();
+        std::lock_guard<std::mutex> lock(mutex_);
+        Ring* mine = nullptr;
+        for (const std::unique_ptr<Ring>& ring : rings_) {
+            if (ring->owner == self) mine = ring.get();
+        }
+        if (!mine) {
+            rings_.push_back(std::make_unique<Ring>());
+            mine = rings_.back().get();
+            mine->events.resize(events_per_thread_);
+            mine->owner = self;
+        }
+        tls_ring.recorder_id = id_;
+        tls_ring.ring = mine;
+    }
+    return *static_cast<Ring*>(tls_ring.ring);
+}
+
+void TraceRecorder::Record(const char* name, const char* category, int64_t start_ns, int64_t end_ns, int64_t arg) {
+    Ring& ring = ForCurrentThread();
+    const uint64_t written = ring.written.load(std::memory_order_relaxed);
+    Event& event = ring.events[written % events_per_thread_];
+    event.name = name;
+    event.category = category;
+    event.start_ns = start_ns;
+    event.duration_ns = end_ns - start_ns;
+    event.arg = arg;
+    ring.written.store(written + 1, std::memory_order_release);
+}
+
+void TraceRecorder::WriteChromeTrace(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    auto separator = [&]() {
+        out << (first ? "\n" : ",\n");
+        first = false;
+    };
+    out << std::fixed << std::setprecision(3);
+    for (size_t tid = 0; tid < rings_.size(); ++tid) {
+        separator();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+            << ",\"args\":{\"name\":\"solver thread " << tid << "\"}}";
+        const Ring& ring = *rings_[tid];
+        const uint64_t written = ring.written.load(std::memory_order_acquire);
+        const uint64_t kept = std::min<uint64_t>(written, events_per_thread_);
+        for (uint64_t n = written - kept; n < written; ++n) {
+            const Event& event = ring.events[n % events_per_thread_];
+            separator();
+            out << "{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category
+                << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid << ",\"ts\":" << event.start_ns / 1000.0
+                << ",\"dur\":" << event.duration_ns / 1000.0;
+            if (event.arg >= 0) out << ",\"args\":{\"value\":" << event.arg << "}";
+            out << "}";
+        }
+    }
+    out << "\n]}\n";
+}
+
+void TraceRecorder::WriteChromeTrace(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) throw std::runtime_error("Cannot write trace " + path);
+    WriteChromeTrace(out);
+    if (!out) throw std::runtime_error("Failed writing trace " + path);
+}
+
+uint64_t TraceRecorder::Overwritten() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t overwritten = 0;
+    for (const std::unique_ptr<Ring>& ring : rings_) {
+        const uint64_t written = ring->written.load(std::memory_order_acquire);
+        if (written > events_per_thread_) overwritten += written - events_per_thread_;
+    }
+    return overwritten;
+}
+
+} // namespace solver
+} // namespace poker_solver
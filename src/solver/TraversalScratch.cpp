@@ -0,0 +1,72 @@
+#include "solver/TraversalScratch.h"
+
+#include <algorithm> // For std::max
+#include <mutex> // For std::mutex, std::lock_guard
+
+namespace poker_solver {
+namespace solver {
+
+namespace {
+
+// Scratch of the task the calling thread is running, if any.
+thread_local TraversalScratch* tls_task_scratch = nullptr;
+
+// Stacks released by finished tasks, ready for reuse.
+std::mutex g_pool_mutex;
+std::vector<std::unique_ptr<TraversalScratch>>& Pool() {
+    static std::vector<std::unique_ptr<TraversalScratch>> pool;
+    return pool;
+}
+
+} // namespace
+
+TraversalScratch::Level& TraversalScratch::At(size_t depth) {
+    while (levels_.size() <= depth) {
+        levels_.push_back(std::make_unique<Level>());
+    }
+    return *levels_[depth];
+}
+
+size_t TraversalScratch::LevelBytes(const std::array<size_t, 2>& num_hands, size_t max_actions,
+                                    size_t max_outcomes) {
+    const size_t both = num_hands[0] + num_hands[1];
+    const size_t widest = std::max(num_hands[0], num_hands[1]);
+    // reach, utility and outcome_sum: one vector per player each.
+    size_t doubles = 3 * both;
+    doubles += max_actions * both;       // child_utility
+    doubles += 2 * max_actions * widest; // strategy, regrets
+    doubles += widest;                   // reach_weights
+    doubles += max_outcomes * both;      // outcome_utility
+    // outcomes and outcome_evaluated, then the runout batch.
+    size_t per_outcome = sizeof(uint64_t) + sizeof(uint8_t);
+    per_outcome += sizeof(size_t) + 2 * sizeof(uint64_t) + 2 * sizeof(double) + sizeof(double*) +
+                   2 * (sizeof(std::shared_ptr<const ranges::PackedRiverCombos>) + sizeof(void*));
+    return sizeof(Level) + doubles * sizeof(double) + max_outcomes * per_outcome;
+}
+
+TraversalScratch& TraversalScratch::ForCurrentThread() {
+    if (tls_task_scratch) return *tls_task_scratch;
+    thread_local TraversalScratch scratch;
+    return scratch;
+}
+
+TraversalScratch::TaskScope::TaskScope() : previous_(tls_task_scratch) {
+    {
+        std::lock_guard<std::mutex> lock(g_pool_mutex);
+        if (!Pool().empty()) {
+            scratch_ = std::move(Pool().back());
+            Pool().pop_back();
+        }
+    }
+    if (!scratch_) scratch_ = std::make_unique<TraversalScratch>();
+    tls_task_scratch = scratch_.get();
+}
+
+TraversalScratch::TaskScope::~TaskScope() {
+    tls_task_scratch = previous_;
+    std::lock_guard<std::mutex> lock(g_pool_mutex);
+    Pool().push_back(std::move(scratch_));
+}
+
+} // namespace solver
+} // namespace poker_solver
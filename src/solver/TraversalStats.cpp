@@ -0,0 +1,103 @@
+#include "solver/TraversalStats.h"
+
+#include <atomic>
+#include <string>
+
+namespace poker_solver {
+namespace solver {
+
+namespace {
+
+constexpr const char* kNodeTypeNames[TraversalStats::kNumNodeTypes] = {"action", "chance", "showdown", "terminal"};
+constexpr const char* kRoundNames[TraversalStats::kNumRounds] = {"preflop", "flop", "turn", "river"};
+
+std::atomic<uint64_t> g_next_collector_id{1};
+
+// Buffer the calling thread last used, and the collector it belongs to.
+struct ThreadBuffer {
+  uint64_t collector_id = 0;
+  TraversalStats* stats = nullptr;
+};
+thread_local ThreadBuffer tls_buffer;
+
+nlohmann::json WorkJson(const NodeWorkStats& work) {
+    return {{"visits", work.visits}, {"hands", work.hands}, {"nanoseconds", work.nanoseconds}};
+}
+
+} // namespace
+
+NodeWorkStats TraversalStats::Total(core::GameTreeNodeType type) const {
+    NodeWorkStats total;
+    for (const NodeWorkStats& work : nodes[static_cast<size_t>(type)]) total += work;
+    return total;
+}
+
+NodeWorkStats TraversalStats::Total() const {
+    NodeWorkStats total;
+    for (size_t t = 0; t < kNumNodeTypes; ++t) total += Total(static_cast<core::GameTreeNodeType>(t));
+    return total;
+}
+
+TraversalStats& TraversalStats::operator+=(const TraversalStats& other) {
+    iterations += other.iterations;
+    for (size_t t = 0; t < kNumNodeTypes; ++t) {
+        for (size_t r = 0; r < kNumRounds; ++r) nodes[t][r] += other.nodes[t][r];
+    }
+    return *this;
+}
+
+nlohmann::json TraversalStats::ToJson() const {
+    nlohmann::json result;
+    result["iterations"] = iterations;
+    result["total"] = WorkJson(Total());
+    for (size_t t = 0; t < kNumNodeTypes; ++t) {
+        nlohmann::json type_json;
+        type_json["total"] = WorkJson(Total(static_cast<core::GameTreeNodeType>(t)));
+        for (size_t r = 0; r < kNumRounds; ++r) {
+            if (nodes[t][r].visits > 0) type_json[kRoundNames[r]] = WorkJson(nodes[t][r]);
+        }
+        result[kNodeTypeNames[t]] = type_json;
+    }
+    return result;
+}
+
+TraversalStatsCollector::TraversalStatsCollector() : id_(g_next_collector_id++) {}
+
+TraversalStats& TraversalStatsCollector::ForCurrentThread() {
+    if (tls_buffer.collector_id != id_) {
+        // First record of this thread for this collector (or since it last
+        // recorded for another one): find or register its buffer.
+        const std::thread::id self = std::this_thread::get_id();
+        std::lock_guard<std::mutex> lock(mutex_);
+        Buffer* mine = nullptr;
+        for (const std::unique_ptr<Buffer>& buffer : buffers_) {
+            if (buffer->owner == self) mine = buffer.get();
+        }
+        if (!mine) {
+            buffers_.push_back(std::make_unique<Buffer>());
+            mine = buffers_.back().get();
+            mine->owner = self;
+        }
+        tls_buffer.collector_id = id_;
+        tls_buffer.stats = &mine->stats;
+    }
+    return *tls_buffer.stats;
+}
+
+TraversalStats TraversalStatsCollector::Collect() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    TraversalStats total;
+    for (const std::unique_ptr<Buffer>& buffer : buffers_) {
+        total += buffer->stats;
+        buffer->stats = TraversalStats();
+    }
+    return total;
+}
+
+TraversalStatsCollector::ThreadClock& TraversalStatsCollector::CurrentThreadClock() {
+    thread_local ThreadClock clock;
+    return clock;
+}
+
+} // namespace solver
+} // namespace poker_solver
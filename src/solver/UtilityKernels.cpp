@@ -0,0 +1,306 @@
+#include "solver/UtilityKernels.h"
+#include "solver/KernelDispatch.h"
+#include "Card.h" // For kNumCardsInDeck
+
+#include <algorithm> // For std::fill
+#include <array>
+#include <vector>
+#include <stdexcept>
+#include <sstream>
+
+// Use aliases for namespaces
+namespace core = poker_solver::core;
+namespace ranges = poker_solver::ranges;
+
+namespace poker_solver {
+namespace solver {
+
+namespace {
+
+// Accumulates reach per card so that the reach of all hands sharing a card
+// with a given hand can be removed by inclusion-exclusion.
+struct CardReachAccumulator {
+    std::array<double, core::kNumCardsInDeck> per_card{};
+    double total = 0.0;
+
+    void Add(const core::PrivateCards& hand, double reach) {
+        Add(hand.Card1Int(), hand.Card2Int(), reach);
+    }
+
+    void Add(int card1, int card2, double reach) {
+        total += reach;
+        per_card[card1] += reach;
+        per_card[card2] += reach;
+    }
+
+    // Sum of accumulated reach for hands that share no card with 'hand',
+    // excluding the identical hand (it has both cards and is subtracted twice).
+    double CompatibleExcludingSame(const core::PrivateCards& hand) const {
+        return CompatibleExcludingSame(hand.Card1Int(), hand.Card2Int());
+    }
+
+    double CompatibleExcludingSame(int card1, int card2) const {
+        return total - per_card[card1] - per_card[card2];
+    }
+};
+
+// Dense combo index of a two-card hand (see HandIndex.h).
+inline size_t PairIndex(const core::PrivateCards& hand) {
+    return static_cast<size_t>(hand.GetComboIndex());
+}
+
+inline size_t PairIndex(int card1, int card2) {
+    return static_cast<size_t>(core::ComboIndex(card1, card2));
+}
+
+void ValidateRangeReach(const std::vector<core::PrivateCards>& range,
+                        const std::vector<double>& reach, const char* who) {
+    if (range.size() != reach.size()) {
+        std::ostringstream oss;
+        oss << "Fold utility: " << who << " reach size " << reach.size()
+            << " does not match range size " << range.size() << ".";
+        throw std::invalid_argument(oss.str());
+    }
+}
+
+void ValidateComboIndices(const ranges::PackedRiverCombos& combos,
+                          size_t num_hands, const char* who) {
+    for (uint16_t original_index : combos.original_indices) {
+        if (original_index >= num_hands) {
+            std::ostringstream oss;
+            oss << "ShowdownUtilitySweep: " << who << " combo original index "
+                << original_index << " out of range for " << num_hands
+                << " hands.";
+            throw std::out_of_range(oss.str());
+        }
+    }
+}
+
+} // namespace
+
+std::vector<double> ShowdownUtilitySweep(
+    const std::vector<ranges::RiverCombs>& traverser_combos,
+    const std::vector<ranges::RiverCombs>& opponent_combos,
+    size_t traverser_hands,
+    const std::vector<double>& opponent_reach,
+    double win_payoff,
+    double lose_payoff,
+    double tie_payoff)
+{
+    std::vector<double> utility(traverser_hands, 0.0);
+    ShowdownUtilitySweep(traverser_combos, opponent_combos, traverser_hands,
+                         opponent_reach.data(), opponent_reach.size(),
+                         win_payoff, lose_payoff, tie_payoff, utility.data());
+    return utility;
+}
+
+void ShowdownUtilitySweep(
+    const std::vector<ranges::RiverCombs>& traverser_combos,
+    const std::vector<ranges::RiverCombs>& opponent_combos,
+    size_t traverser_hands,
+    const double* opponent_reach, size_t opponent_hands,
+    double win_payoff,
+    double lose_payoff,
+    double tie_payoff,
+    double* utility)
+{
+    ShowdownUtilitySweep(ranges::PackRiverCombos(traverser_combos),
+                         ranges::PackRiverCombos(opponent_combos),
+                         traverser_hands,
+                         opponent_reach, opponent_hands,
+                         win_payoff, lose_payoff, tie_payoff, utility);
+}
+
+namespace {
+
+// The three passes of ShowdownUtilitySweep, on validated indices. Kept apart
+// from the validation because GCC assumes target_clones dispatchers do not
+// throw, so an exception raised inside a clone would terminate.
+POKER_SOLVER_KERNEL
+void ShowdownSweepPasses(
+    const ranges::PackedRiverCombos& traverser_combos,
+    const ranges::PackedRiverCombos& opponent_combos,
+    size_t traverser_hands,
+    const double* opponent_reach,
+    double win_payoff,
+    double lose_payoff,
+    double tie_payoff,
+    double* utility)
+{
+    std::fill(utility, utility + traverser_hands, 0.0);
+    if (traverser_combos.empty() || opponent_combos.empty()) {
+        return;
+    }
+
+    // u = W*win + L*lose + T*tie, with tie = compatible - win - lose, so
+    // u = (W-T)*win + (L-T)*lose + T*compatible. Three linear passes.
+    const double win_delta = win_payoff - tie_payoff;
+    const double lose_delta = lose_payoff - tie_payoff;
+    const size_t num_opp = opponent_combos.size();
+    const size_t num_runs = traverser_combos.NumRuns();
+    const int32_t* trav_ranks = traverser_combos.ranks.data();
+    const uint16_t* trav_index = traverser_combos.original_indices.data();
+    const uint8_t* trav_card1 = traverser_combos.card1s.data();
+    const uint8_t* trav_card2 = traverser_combos.card2s.data();
+    const uint32_t* trav_runs = traverser_combos.run_starts.data();
+    const int32_t* opp_ranks = opponent_combos.ranks.data();
+    const uint16_t* opp_index = opponent_combos.original_indices.data();
+    const uint8_t* opp_card1 = opponent_combos.card1s.data();
+    const uint8_t* opp_card2 = opponent_combos.card2s.data();
+
+    // --- Pass 1: worst -> best, accumulate strictly weaker opponent hands ---
+    // The opponent pointer only moves between runs of equal traverser rank.
+    {
+        CardReachAccumulator weaker;
+        size_t j = 0;
+        for (size_t run = 0; run < num_runs; ++run) {
+            const int32_t rank = trav_ranks[trav_runs[run]];
+            while (j < num_opp && opp_ranks[j] > rank) {
+                weaker.Add(opp_card1[j], opp_card2[j], opponent_reach[opp_index[j]]);
+                ++j;
+            }
+            // An identical opponent hand has the same rank, so it is never in 'weaker'.
+            for (uint32_t t = trav_runs[run]; t < trav_runs[run + 1]; ++t) {
+                utility[trav_index[t]] +=
+                    win_delta * weaker.CompatibleExcludingSame(trav_card1[t], trav_card2[t]);
+            }
+        }
+    }
+
+    // --- Pass 2: best -> worst, accumulate strictly stronger opponent hands ---
+    {
+        CardReachAccumulator stronger;
+        size_t j = num_opp;
+        for (size_t run = num_runs; run-- > 0;) {
+            const int32_t rank = trav_ranks[trav_runs[run]];
+            while (j > 0 && opp_ranks[j - 1] < rank) {
+                --j;
+                stronger.Add(opp_card1[j], opp_card2[j], opponent_reach[opp_index[j]]);
+            }
+            for (uint32_t t = trav_runs[run]; t < trav_runs[run + 1]; ++t) {
+                utility[trav_index[t]] +=
+                    lose_delta * stronger.CompatibleExcludingSame(trav_card1[t], trav_card2[t]);
+            }
+        }
+    }
+
+    // --- Pass 3: all compatible opponent hands (tie baseline) ---
+    if (tie_payoff != 0.0) {
+        // Reach of the opponent hand holding exactly the same two cards, which
+        // inclusion-exclusion subtracts twice and must be added back once.
+        thread_local std::array<double, core::kNumHandCombos> same_hand_reach{};
+        CardReachAccumulator all;
+        for (size_t j = 0; j < num_opp; ++j) {
+            double reach = opponent_reach[opp_index[j]];
+            all.Add(opp_card1[j], opp_card2[j], reach);
+            same_hand_reach[PairIndex(opp_card1[j], opp_card2[j])] += reach;
+        }
+        for (size_t t = 0; t < traverser_combos.size(); ++t) {
+            double compatible = all.CompatibleExcludingSame(trav_card1[t], trav_card2[t]) +
+                                same_hand_reach[PairIndex(trav_card1[t], trav_card2[t])];
+            utility[trav_index[t]] += tie_payoff * compatible;
+        }
+        // Leave the scratch table zeroed for the next call on this thread.
+        for (size_t j = 0; j < num_opp; ++j) {
+            same_hand_reach[PairIndex(opp_card1[j], opp_card2[j])] = 0.0;
+        }
+    }
+}
+
+} // namespace
+
+void ShowdownUtilitySweep(
+    const ranges::PackedRiverCombos& traverser_combos,
+    const ranges::PackedRiverCombos& opponent_combos,
+    size_t traverser_hands,
+    const double* opponent_reach, size_t opponent_hands,
+    double win_payoff,
+    double lose_payoff,
+    double tie_payoff,
+    double* utility)
+{
+    ValidateComboIndices(traverser_combos, traverser_hands, "traverser");
+    ValidateComboIndices(opponent_combos, opponent_hands, "opponent");
+    ShowdownSweepPasses(traverser_combos, opponent_combos, traverser_hands, opponent_reach,
+                        win_payoff, lose_payoff, tie_payoff, utility);
+}
+
+std::vector<double> FoldUtilityLinear(
+    const std::vector<core::PrivateCards>& traverser_range,
+    const std::vector<core::PrivateCards>& opponent_range,
+    const std::vector<double>& opponent_reach,
+    double payoff)
+{
+    ValidateRangeReach(opponent_range, opponent_reach, "opponent");
+
+    std::vector<double> utility(traverser_range.size(), 0.0);
+    FoldUtilityLinear(traverser_range, opponent_range, opponent_reach.data(), payoff, utility.data());
+    return utility;
+}
+
+void FoldUtilityLinear(
+    const std::vector<core::PrivateCards>& traverser_range,
+    const std::vector<core::PrivateCards>& opponent_range,
+    const double* opponent_reach,
+    double payoff,
+    double* utility)
+{
+    std::fill(utility, utility + traverser_range.size(), 0.0);
+    if (payoff == 0.0) return;
+
+    thread_local std::array<double, core::kNumHandCombos> same_hand_reach{};
+    CardReachAccumulator all;
+    for (size_t j = 0; j < opponent_range.size(); ++j) {
+        all.Add(opponent_range[j], opponent_reach[j]);
+        same_hand_reach[PairIndex(opponent_range[j])] += opponent_reach[j];
+    }
+    for (size_t i = 0; i < traverser_range.size(); ++i) {
+        double compatible = all.CompatibleExcludingSame(traverser_range[i]) +
+                            same_hand_reach[PairIndex(traverser_range[i])];
+        utility[i] = payoff * compatible;
+    }
+    for (const auto& hand : opponent_range) {
+        same_hand_reach[PairIndex(hand)] = 0.0;
+    }
+}
+
+std::vector<double> FoldUtilityPairwise(
+    const std::vector<core::PrivateCards>& traverser_range,
+    const std::vector<core::PrivateCards>& opponent_range,
+    const std::vector<double>& opponent_reach,
+    double payoff)
+{
+    ValidateRangeReach(opponent_range, opponent_reach, "opponent");
+
+    std::vector<double> utility(traverser_range.size(), 0.0);
+    FoldUtilityPairwise(traverser_range, opponent_range, opponent_reach.data(), payoff, utility.data());
+    return utility;
+}
+
+POKER_SOLVER_KERNEL
+void FoldUtilityPairwise(
+    const std::vector<core::PrivateCards>& traverser_range,
+    const std::vector<core::PrivateCards>& opponent_range,
+    const double* opponent_reach,
+    double payoff,
+    double* utility)
+{
+    size_t traverser_hands = traverser_range.size();
+    size_t opponent_hands = opponent_range.size();
+    std::fill(utility, utility + traverser_hands, 0.0);
+
+    // Serial: the solver parallelizes across chance outcomes, above this kernel.
+    for (size_t h_i = 0; h_i < traverser_hands; ++h_i) {
+        uint64_t traverser_mask = traverser_range[h_i].GetBoardMask();
+        double compatible_opponent_reach_sum = 0.0;
+        for (size_t h_j = 0; h_j < opponent_hands; ++h_j) {
+            if (!core::Card::DoBoardsOverlap(traverser_mask, opponent_range[h_j].GetBoardMask())) {
+                compatible_opponent_reach_sum += opponent_reach[h_j];
+            }
+        }
+        utility[h_i] = payoff * compatible_opponent_reach_sum;
+    }
+}
+
+} // namespace solver
+} // namespace poker_solver
@@ -0,0 +1,74 @@
+#include "solver/VectorKernels.h"
+#include "solver/KernelDispatch.h"
+
+#include <cstddef>
+
+namespace poker_solver {
+namespace solver {
+namespace kernels {
+
+const char* ActiveInstructionSet() {
+#if POKER_SOLVER_KERNEL_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return "avx512f";
+    if (__builtin_cpu_supports("avx2")) return "avx2";
+#endif
+    return "scalar";
+}
+
+POKER_SOLVER_KERNEL
+void MultiplyByActionStrategy(double* __restrict dst, const double* __restrict src,
+                              const double* __restrict strategy, size_t num_actions,
+                              size_t action, size_t num_hands) {
+    const double* strat = strategy + action;
+    for (size_t h = 0; h < num_hands; ++h) {
+        dst[h] = src[h] * strat[h * num_actions];
+    }
+}
+
+POKER_SOLVER_KERNEL
+void AccumulateWeightedByAction(double* __restrict dst, const double* __restrict strategy,
+                                size_t num_actions, size_t action,
+                                const double* __restrict child_utility, size_t num_hands) {
+    const double* strat = strategy + action;
+    for (size_t h = 0; h < num_hands; ++h) {
+        dst[h] += strat[h * num_actions] * child_utility[h];
+    }
+}
+
+POKER_SOLVER_KERNEL
+void StoreActionRegrets(double* __restrict regrets, size_t num_actions, size_t action,
+                        const double* __restrict child_utility,
+                        const double* __restrict node_utility, size_t num_hands) {
+    double* out = regrets + action;
+    for (size_t h = 0; h < num_hands; ++h) {
+        out[h * num_actions] = child_utility[h] - node_utility[h];
+    }
+}
+
+POKER_SOLVER_KERNEL
+void Accumulate(double* __restrict dst, const double* __restrict src, size_t num_hands) {
+    for (size_t h = 0; h < num_hands; ++h) {
+        dst[h] += src[h];
+    }
+}
+
+POKER_SOLVER_KERNEL
+void Scale(double* dst, const double* src, double scale, size_t num_hands) {
+    for (size_t h = 0; h < num_hands; ++h) {
+        dst[h] = src[h] * scale;
+    }
+}
+
+double Sum(const double* src, size_t num_hands) {
+    // Kept strictly sequential so results do not depend on the dispatch target.
+    double total = 0.0;
+    for (size_t h = 0; h < num_hands; ++h) {
+        total += src[h];
+    }
+    return total;
+}
+
+} // namespace kernels
+} // namespace solver
+} // namespace poker_solver
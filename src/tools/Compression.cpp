@@ -0,0 +1,121 @@
+#include "tools/Compression.h"
+
+#include <cstring>   // For std::memcpy
+#include <stdexcept> // For std::runtime_error
+
+namespace poker_solver {
+namespace utils {
+
+namespace {
+
+constexpr size_t kMinMatch = 4;
+constexpr size_t kMaxOffset = 65535;
+constexpr int kHashBits = 14;
+
+uint32_t Load32(const uint8_t* data) {
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+// A length of 15 or more continues in bytes of up to 255.
+void AppendLength(size_t length, std::vector<uint8_t>& out) {
+    for (length -= 15; length >= 255; length -= 255) out.push_back(255);
+    out.push_back(static_cast<uint8_t>(length));
+}
+
+size_t ReadLength(size_t nibble, const uint8_t*& cursor, const uint8_t* end) {
+    if (nibble < 15) return nibble;
+    size_t length = 15;
+    for (;;) {
+        if (cursor == end) throw std::runtime_error("DecompressBlock: truncated length.");
+        const uint8_t byte = *cursor++;
+        length += byte;
+        if (byte != 255) return length;
+    }
+}
+
+void AppendSequence(const uint8_t* literals, size_t num_literals, size_t offset, size_t match_length,
+                    std::vector<uint8_t>& out) {
+    const size_t match_code = match_length >= kMinMatch ? match_length - kMinMatch : 0;
+    out.push_back(static_cast<uint8_t>(((num_literals < 15 ? num_literals : 15) << 4) |
+                                       (match_code < 15 ? match_code : 15)));
+    if (num_literals >= 15) AppendLength(num_literals, out);
+    out.insert(out.end(), literals, literals + num_literals);
+    if (match_length == 0) return; // The last sequence
+    out.push_back(static_cast<uint8_t>(offset & 0xFF));
+    out.push_back(static_cast<uint8_t>(offset >> 8));
+    if (match_code >= 15) AppendLength(match_code, out);
+}
+
+} // namespace
+
+void CompressBlock(const uint8_t* data, size_t size, std::vector<uint8_t>& out) {
+    out.clear();
+    out.reserve(size / 2 + 16);
+    // Last position + 1 of each hashed 4-byte sequence (0: none).
+    std::vector<uint32_t> table(size_t{1} << kHashBits, 0);
+    size_t anchor = 0;
+    size_t pos = 0;
+    while (pos + kMinMatch <= size) {
+        const uint32_t sequence = Load32(data + pos);
+        const uint32_t hash = (sequence * 2654435761u) >> (32 - kHashBits);
+        const size_t candidate = table[hash];
+        table[hash] = static_cast<uint32_t>(pos + 1);
+        if (candidate == 0 || pos - (candidate - 1) > kMaxOffset || Load32(data + candidate - 1) != sequence) {
+            ++pos;
+            continue;
+        }
+        const size_t match = candidate - 1;
+        size_t length = kMinMatch;
+        while (pos + length < size && data[match + length] == data[pos + length]) ++length;
+        AppendSequence(data + anchor, pos - anchor, pos - match, length, out);
+        pos += length;
+        anchor = pos;
+    }
+    AppendSequence(data + anchor, size - anchor, 0, 0, out);
+}
+
+void DecompressBlock(const uint8_t* data, size_t size, uint8_t* out, size_t out_size) {
+    const uint8_t* cursor = data;
+    const uint8_t* const end = data + size;
+    size_t written = 0;
+    for (;;) {
+        // Every block ends with a literals-only sequence.
+        if (cursor == end) throw std::runtime_error("DecompressBlock: truncated block.");
+        const uint8_t token = *cursor++;
+        const size_t num_literals = ReadLength(token >> 4, cursor, end);
+        if (num_literals > static_cast<size_t>(end - cursor) || num_literals > out_size - written) {
+            throw std::runtime_error("DecompressBlock: literals overrun the block.");
+        }
+        std::memcpy(out + written, cursor, num_literals);
+        cursor += num_literals;
+        written += num_literals;
+        if (cursor == end) break; // The last sequence
+
+        if (end - cursor < 2) throw std::runtime_error("DecompressBlock: truncated match.");
+        const size_t offset = cursor[0] | (static_cast<size_t>(cursor[1]) << 8);
+        cursor += 2;
+        const size_t length = ReadLength(token & 0x0F, cursor, end) + kMinMatch;
+        if (offset == 0 || offset > written || length > out_size - written) {
+            throw std::runtime_error("DecompressBlock: match out of range.");
+        }
+        // Byte by byte: a match may overlap the bytes it produces.
+        for (size_t i = 0; i < length; ++i, ++written) out[written] = out[written - offset];
+    }
+    if (written != out_size) throw std::runtime_error("DecompressBlock: block does not fill its output.");
+}
+
+uint64_t ReadVarint(const uint8_t*& cursor, const uint8_t* end) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (cursor == end) throw std::runtime_error("ReadVarint: truncated value.");
+        const uint8_t byte = *cursor++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return value;
+    }
+    throw std::runtime_error("ReadVarint: value exceeds 64 bits.");
+}
+
+} // namespace utils
+} // namespace poker_solver
@@ -0,0 +1,54 @@
+#include "tools/MappedFile.h"
+
+#include <fstream>   // For the read fallback
+#include <iterator>  // For std::istreambuf_iterator
+#include <stdexcept> // For std::runtime_error
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>    // For open
+#include <sys/mman.h> // For mmap
+#include <sys/stat.h> // For fstat
+#include <unistd.h>   // For close
+#define POKER_SOLVER_HAVE_MMAP 1
+#endif
+
+namespace poker_solver {
+namespace utils {
+
+MappedFile::MappedFile(const std::string& path) {
+#ifdef POKER_SOLVER_HAVE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("MappedFile: cannot open '" + path + "'.");
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("MappedFile: cannot stat '" + path + "'.");
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    if (size_ > 0) {
+        void* address = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        if (address != MAP_FAILED) {
+            data_ = static_cast<const unsigned char*>(address);
+            mapped_ = true;
+        }
+    }
+    ::close(fd); // The mapping stays valid
+    if (mapped_ || size_ == 0) return;
+#endif
+    // Not mappable here: fall back to a private copy.
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("MappedFile: cannot open '" + path + "'.");
+    buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    if (in.bad()) throw std::runtime_error("MappedFile: failed reading '" + path + "'.");
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+}
+
+MappedFile::~MappedFile() {
+#ifdef POKER_SOLVER_HAVE_MMAP
+    if (mapped_) ::munmap(const_cast<unsigned char*>(data_), size_);
+#endif
+}
+
+} // namespace utils
+} // namespace poker_solver
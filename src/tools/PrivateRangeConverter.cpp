@@ -1,5 +1,5 @@
 #include "tools/PrivateRangeConverter.h" // Adjust path if necessary
-#include "Library.h" // For StringSplit (adjust path if needed)
+#include "ranges/HandIndex.h" // For kNumHandCombos
 #include "Card.h"    // Need full Card definition for static methods
 
 #include <vector>
@@ -7,87 +7,200 @@
 #include <string_view>
 #include <sstream>
 #include <stdexcept>
-#include <unordered_set> // To check for duplicate generated hands
-#include <charconv>      // For std::from_chars (C++17) - REMOVED FOR DOUBLE
-#include <system_error>  // For std::errc - REMOVED
-#include <functional>    // For std::hash<PrivateCards>
-#include <cstdlib>       // For std::strtod (alternative to stod)
+#include <bitset>        // Dense duplicate-hand detection
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <cstring>       // For std::memcpy
+#include <cstdlib>       // For std::strtod
 #include <cerrno>        // For errno with strtod
 #include <cctype>        // For std::tolower
 
 // Use aliases for namespaces
 // Assuming namespaces defined elsewhere match our structure
 namespace core = poker_solver::core;
-namespace utils = poker_solver::utils;
 namespace ranges = poker_solver::ranges; // Assuming this namespace
 
 namespace poker_solver {
 namespace ranges { // Assuming this namespace
 
-// --- Static Public Method ---
+namespace {
 
-std::vector<core::PrivateCards> PrivateRangeConverter::StringToPrivateCards(
-    std::string_view range_string,
-    const std::vector<int>& initial_board_ints) {
+constexpr std::string_view kWhitespace = " \t\n\r";
 
-    std::vector<core::PrivateCards> result_cards;
-    uint64_t initial_board_mask = 0;
+// Strips leading/trailing whitespace without copying.
+std::string_view Trim(std::string_view text) {
+    size_t first = text.find_first_not_of(kWhitespace);
+    if (first == std::string_view::npos) return {};
+    size_t last = text.find_last_not_of(kWhitespace);
+    return text.substr(first, last - first + 1);
+}
+
+// Card int from rank/suit indices (same layout as Card::StringToInt).
+inline int CardFromIndices(int rank_index, int suit_index) {
+    return rank_index * core::kNumSuits + suit_index;
+}
+
+// Parses a weight with strtod on a stack buffer, so the hot path never
+// allocates. Weights longer than the buffer are rejected.
+double ParseWeight(std::string_view weight_str, std::string_view component) {
+    char buffer[64];
+    if (weight_str.size() >= sizeof(buffer)) {
+        throw std::invalid_argument("Invalid weight format (too long) specified for component: " + std::string(component));
+    }
+    std::memcpy(buffer, weight_str.data(), weight_str.size());
+    buffer[weight_str.size()] = '\0';
+
+    char* end = nullptr;
+    errno = 0;
+    double weight = std::strtod(buffer, &end);
+    if (end == buffer) {
+        throw std::invalid_argument("Invalid weight format (not a number) specified for component: " + std::string(component));
+    }
+    if (end != buffer + weight_str.size()) {
+        throw std::invalid_argument("Invalid characters after weight value for component: " + std::string(component));
+    }
+    if (errno == ERANGE) {
+        throw std::invalid_argument("Weight value out of range for component: " + std::string(component));
+    }
+    return weight;
+}
+
+// Interning cache key: the range string and the board it was filtered against.
+struct RangeCacheKey {
+    std::string range_string;
+    uint64_t board_mask;
+};
+
+// Orders stored keys and (string_view, mask) probes alike, so cache hits do
+// not allocate a key string.
+struct RangeCacheKeyLess {
+    using is_transparent = void;
+    using Probe = std::pair<std::string_view, uint64_t>;
+
+    static Probe AsProbe(const RangeCacheKey& key) {
+        return {key.range_string, key.board_mask};
+    }
+    static Probe AsProbe(const Probe& probe) { return probe; }
+
+    template <typename A, typename B>
+    bool operator()(const A& a, const B& b) const {
+        Probe pa = AsProbe(a);
+        Probe pb = AsProbe(b);
+        return std::tie(pa.second, pa.first) < std::tie(pb.second, pb.first);
+    }
+};
+
+struct RangeCache {
+    std::mutex mutex;
+    std::map<RangeCacheKey, PrivateRangeConverter::SharedRange, RangeCacheKeyLess> ranges;
+};
+
+RangeCache& GetRangeCache() {
+    static RangeCache cache;
+    return cache;
+}
+
+uint64_t BoardIntsToMask(const std::vector<int>& initial_board_ints) {
     try {
-        initial_board_mask = core::Card::CardIntsToUint64(initial_board_ints);
+        return core::Card::CardIntsToUint64(initial_board_ints);
     } catch (const std::out_of_range& e) {
         throw std::invalid_argument(
             "Invalid card integer found in initial_board_ints.");
     }
+}
 
-    // Split the main string by commas
-    std::vector<std::string> components = utils::StringSplit(range_string, ',');
+} // namespace
 
-    // Keep track of generated hands to detect duplicates from input string
-    std::unordered_set<core::PrivateCards, std::hash<core::PrivateCards>> generated_hands;
+// --- Static Public Methods ---
 
-    for (const std::string& component_str : components) {
-        // Trim whitespace (optional but good practice)
-        std::string_view component = component_str;
-        size_t first = component.find_first_not_of(" \t\n\r");
-        if (first == std::string_view::npos) continue; // Skip empty/whitespace components
-        size_t last = component.find_last_not_of(" \t\n\r");
-        component = component.substr(first, (last - first + 1));
+std::vector<core::PrivateCards> PrivateRangeConverter::StringToPrivateCards(
+    std::string_view range_string,
+    const std::vector<int>& initial_board_ints) {
+    return ParseRangeString(range_string, BoardIntsToMask(initial_board_ints));
+}
+
+PrivateRangeConverter::SharedRange PrivateRangeConverter::GetSharedRange(
+    std::string_view range_string,
+    const std::vector<int>& initial_board_ints) {
+
+    uint64_t initial_board_mask = BoardIntsToMask(initial_board_ints);
+    RangeCache& cache = GetRangeCache();
+    const RangeCacheKeyLess::Probe probe{range_string, initial_board_mask};
+    {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        auto it = cache.ranges.find(probe);
+        if (it != cache.ranges.end()) return it->second;
+    }
 
-        if (component.empty()) continue;
+    // Parse outside the lock; invalid strings throw and are never cached.
+    SharedRange parsed = std::make_shared<const std::vector<core::PrivateCards>>(
+        ParseRangeString(range_string, initial_board_mask));
+
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto it = cache.ranges.find(probe);
+    if (it != cache.ranges.end()) return it->second; // Another thread won the race
+    cache.ranges.emplace(RangeCacheKey{std::string(range_string), initial_board_mask}, parsed);
+    return parsed;
+}
+
+size_t PrivateRangeConverter::GetRangeCacheSize() {
+    RangeCache& cache = GetRangeCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    return cache.ranges.size();
+}
+
+void PrivateRangeConverter::ClearRangeCache() {
+    RangeCache& cache = GetRangeCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.ranges.clear();
+}
+
+
+// --- Private Static Helpers ---
+
+std::vector<core::PrivateCards> PrivateRangeConverter::ParseRangeString(
+    std::string_view range_string,
+    uint64_t initial_board_mask) {
+
+    std::vector<core::PrivateCards> result_cards;
+    // Hands generated so far, by dense combo index, to detect duplicates
+    std::bitset<core::kNumHandCombos> generated_hands;
+
+    // Walk the comma-separated components in place.
+    size_t pos = 0;
+    while (pos <= range_string.size()) {
+        size_t comma = range_string.find(',', pos);
+        if (comma == std::string_view::npos) comma = range_string.size();
+        std::string_view component = Trim(range_string.substr(pos, comma - pos));
+        pos = comma + 1;
+        if (component.empty()) continue; // Skip empty/whitespace components
 
         // Store current size to check for duplicates added by this component
         size_t cards_before_component = result_cards.size();
 
         // Parse the component (handles weights and calls generation helpers)
-        try {
-             ParseRangeComponent(component, initial_board_mask, result_cards);
-        } catch (const std::invalid_argument& e) {
-             // Re-throw parsing errors with more context if desired, or just let them propagate
-             throw; // Propagate argument errors
-        } catch (const std::out_of_range& e) {
-            // Propagate card errors
-            throw;
-        }
-
+        ParseRangeComponent(component, initial_board_mask, result_cards);
 
         // Check for duplicates introduced by this component against previous ones
         for (size_t i = cards_before_component; i < result_cards.size(); ++i) {
-            if (!generated_hands.insert(result_cards[i]).second) {
-                // Insertion failed -> duplicate hand
+            int combo = result_cards[i].GetComboIndex();
+            if (generated_hands.test(combo)) {
                  std::ostringstream oss;
                  oss << "Duplicate hand definition found in range string for component '"
-                     << std::string(component) << "'. Hand: " << result_cards[i].ToString(); // Convert component back to string for message
+                     << component << "'. Hand: " << result_cards[i].ToString();
                  throw std::invalid_argument(oss.str());
             }
+            generated_hands.set(combo);
         }
     }
 
     return result_cards;
 }
 
-
-// --- Private Static Helpers ---
-
 void PrivateRangeConverter::ParseRangeComponent(
     std::string_view component,
     uint64_t initial_board_mask,
@@ -100,32 +213,11 @@ void PrivateRangeConverter::ParseRangeComponent(
     size_t colon_pos = component.find(':');
     if (colon_pos != std::string_view::npos) {
         hand_notation = component.substr(0, colon_pos);
-        std::string_view weight_str_view = component.substr(colon_pos + 1);
-
-        // Trim whitespace from weight string
-        size_t first = weight_str_view.find_first_not_of(" \t");
-        size_t last = weight_str_view.find_last_not_of(" \t");
-        if (first == std::string_view::npos) {
+        std::string_view weight_str_view = Trim(component.substr(colon_pos + 1));
+        if (weight_str_view.empty()) {
              throw std::invalid_argument("Empty weight specified after colon for component: " + std::string(component));
         }
-        weight_str_view = weight_str_view.substr(first, (last - first + 1));
-
-        // *** FIX: Use std::stod (or strtod) instead of std::from_chars for double ***
-        std::string weight_str(weight_str_view); // Need null-terminated string for stod/strtod
-        try {
-            size_t processed_chars = 0;
-            weight = std::stod(weight_str, &processed_chars);
-            // Check if the entire string was consumed
-            if (processed_chars != weight_str.length()) {
-                 throw std::invalid_argument("Invalid characters after weight value.");
-            }
-        } catch (const std::invalid_argument& ) {
-            throw std::invalid_argument("Invalid weight format (not a number) specified for component: " + std::string(component));
-        } catch (const std::out_of_range& ) {
-             throw std::invalid_argument("Weight value out of range for component: " + std::string(component));
-        }
-        // **************************************************************************
-
+        weight = ParseWeight(weight_str_view, component);
 
         // Ignore components with near-zero weight (as in original)
         if (weight <= 0.005) {
@@ -133,14 +225,10 @@ void PrivateRangeConverter::ParseRangeComponent(
         }
     }
 
-    // Trim whitespace from hand notation
-    size_t first = hand_notation.find_first_not_of(" \t");
-    size_t last = hand_notation.find_last_not_of(" \t");
-    if (first == std::string_view::npos) {
+    hand_notation = Trim(hand_notation);
+    if (hand_notation.empty()) {
         throw std::invalid_argument("Empty hand notation in component: " + std::string(component));
     }
-    hand_notation = hand_notation.substr(first, (last - first + 1));
-
 
     // Determine hand notation type and call appropriate generator
     size_t len = hand_notation.length();
@@ -155,7 +243,7 @@ void PrivateRangeConverter::ParseRangeComponent(
         if (hand_notation[0] == hand_notation[1]) {
              throw std::invalid_argument("Invalid notation: Cannot specify suited/offsuit for pairs: " + std::string(hand_notation));
         }
-        char suffix = std::tolower(hand_notation[2]); // Use std::tolower
+        char suffix = std::tolower(static_cast<unsigned char>(hand_notation[2]));
         if (suffix == 's') {
             GenerateSuitedCombos(hand_notation[0], hand_notation[1], weight, initial_board_mask, output_cards);
         } else if (suffix == 'o') {
@@ -183,25 +271,11 @@ void PrivateRangeConverter::GeneratePairCombos(
         throw std::invalid_argument("Invalid rank character for pair: " + std::string(1, rank_char));
     }
 
-    const auto& suits = core::Card::GetAllSuitChars(); // Get {'c', 'd', 'h', 's'}
-
     // Iterate through all pairs of suits
     for (int i = 0; i < core::kNumSuits; ++i) {
         for (int j = i + 1; j < core::kNumSuits; ++j) {
-            // *** ERROR: Incorrectly calling StringToInt with initializer list ***
-            // std::optional<int> c1_opt = core::Card::StringToInt({&rank_char, 1, &suits[i], 1});
-            // std::optional<int> c2_opt = core::Card::StringToInt({&rank_char, 1, &suits[j], 1});
-            // *** CORRECTED CODE: ***
-            std::string card1_str; card1_str += rank_char; card1_str += suits[i];
-            std::string card2_str; card2_str += rank_char; card2_str += suits[j];
-            std::optional<int> c1_opt = core::Card::StringToInt(card1_str);
-            std::optional<int> c2_opt = core::Card::StringToInt(card2_str);
-            // ***********************
-
-            if (!c1_opt || !c2_opt) continue; // Should not happen if rank_char is valid
-
-            int c1 = c1_opt.value();
-            int c2 = c2_opt.value();
+            int c1 = CardFromIndices(rank_index, i);
+            int c2 = CardFromIndices(rank_index, j);
 
             uint64_t hand_mask = core::Card::CardIntToUint64(c1) | core::Card::CardIntToUint64(c2);
             if (!core::Card::DoBoardsOverlap(hand_mask, initial_board_mask)) {
@@ -224,24 +298,10 @@ void PrivateRangeConverter::GenerateSuitedCombos(
          throw std::invalid_argument("Invalid rank characters for suited hand: " + std::string(1, rank1_char) + std::string(1, rank2_char) + "s");
      }
 
-    const auto& suits = core::Card::GetAllSuitChars();
-
     // Iterate through each suit
     for (int i = 0; i < core::kNumSuits; ++i) {
-        // *** ERROR: Incorrectly calling StringToInt with initializer list ***
-        // std::optional<int> c1_opt = core::Card::StringToInt({&rank1_char, 1, &suits[i], 1});
-        // std::optional<int> c2_opt = core::Card::StringToInt({&rank2_char, 1, &suits[i], 1});
-        // *** CORRECTED CODE: ***
-        std::string card1_str; card1_str += rank1_char; card1_str += suits[i];
-        std::string card2_str; card2_str += rank2_char; card2_str += suits[i];
-        std::optional<int> c1_opt = core::Card::StringToInt(card1_str);
-        std::optional<int> c2_opt = core::Card::StringToInt(card2_str);
-        // ***********************
-
-        if (!c1_opt || !c2_opt) continue;
-
-        int c1 = c1_opt.value();
-        int c2 = c2_opt.value();
+        int c1 = CardFromIndices(rank1_index, i);
+        int c2 = CardFromIndices(rank2_index, i);
 
         uint64_t hand_mask = core::Card::CardIntToUint64(c1) | core::Card::CardIntToUint64(c2);
         if (!core::Card::DoBoardsOverlap(hand_mask, initial_board_mask)) {
@@ -263,27 +323,13 @@ void PrivateRangeConverter::GenerateOffsuitCombos(
          throw std::invalid_argument("Invalid rank characters for offsuit hand: " + std::string(1, rank1_char) + std::string(1, rank2_char) + "o");
      }
 
-    const auto& suits = core::Card::GetAllSuitChars();
-
     // Iterate through all pairs of different suits
     for (int i = 0; i < core::kNumSuits; ++i) { // Suit for first rank
         for (int j = 0; j < core::kNumSuits; ++j) { // Suit for second rank
             if (i == j) continue; // Skip suited combinations
 
-            // *** ERROR: Incorrectly calling StringToInt with initializer list ***
-            // std::optional<int> c1_opt = core::Card::StringToInt({&rank1_char, 1, &suits[i], 1});
-            // std::optional<int> c2_opt = core::Card::StringToInt({&rank2_char, 1, &suits[j], 1});
-            // *** CORRECTED CODE: ***
-            std::string card1_str; card1_str += rank1_char; card1_str += suits[i];
-            std::string card2_str; card2_str += rank2_char; card2_str += suits[j];
-            std::optional<int> c1_opt = core::Card::StringToInt(card1_str);
-            std::optional<int> c2_opt = core::Card::StringToInt(card2_str);
-            // ***********************
-
-             if (!c1_opt || !c2_opt) continue;
-
-            int c1 = c1_opt.value();
-            int c2 = c2_opt.value();
+            int c1 = CardFromIndices(rank1_index, i);
+            int c2 = CardFromIndices(rank2_index, j);
 
             uint64_t hand_mask = core::Card::CardIntToUint64(c1) | core::Card::CardIntToUint64(c2);
             if (!core::Card::DoBoardsOverlap(hand_mask, initial_board_mask)) {
@@ -303,11 +349,8 @@ void PrivateRangeConverter::GenerateSpecificCombo(
         throw std::invalid_argument("Invalid specific combo length: " + std::string(combo_str));
     }
 
-    std::string_view card1_str = combo_str.substr(0, 2);
-    std::string_view card2_str = combo_str.substr(2, 2);
-
-    std::optional<int> c1_opt = core::Card::StringToInt(card1_str);
-    std::optional<int> c2_opt = core::Card::StringToInt(card2_str);
+    std::optional<int> c1_opt = core::Card::StringToInt(combo_str.substr(0, 2));
+    std::optional<int> c2_opt = core::Card::StringToInt(combo_str.substr(2, 2));
 
     if (!c1_opt || !c2_opt) {
          throw std::invalid_argument("Invalid card string in specific combo: " + std::string(combo_str));
@@ -316,7 +359,6 @@ void PrivateRangeConverter::GenerateSpecificCombo(
          throw std::invalid_argument("Specific combo cards cannot be identical: " + std::string(combo_str));
     }
 
-
     int c1 = c1_opt.value();
     int c2 = c2_opt.value();
 
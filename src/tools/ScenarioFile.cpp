@@ -0,0 +1,111 @@
+#include "tools/ScenarioFile.h"
+
+#include "Card.h"
+#include "tools/GameTreeBuildingSettings.h"
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace poker_solver {
+namespace config {
+
+namespace {
+
+std::vector<double> SizesOrEmpty(const json& j_setting, const char* key) {
+    if (j_setting.contains(key) && j_setting.at(key).is_array()) {
+        return j_setting.at(key).get<std::vector<double>>();
+    }
+    return {};
+}
+
+core::GameRound ParseStartingRound(const std::string& round) {
+    if (round == "Preflop") return core::GameRound::kPreflop;
+    if (round == "Flop") return core::GameRound::kFlop;
+    if (round == "Turn") return core::GameRound::kTurn;
+    if (round == "River") return core::GameRound::kRiver;
+    throw std::invalid_argument("Invalid starting_round in scenario: " + round);
+}
+
+} // namespace
+
+StreetSetting StreetSettingFromJson(const json& j_setting) {
+    bool allow_all_in = j_setting.contains("allow_all_in") && j_setting.at("allow_all_in").is_boolean() &&
+                        j_setting.at("allow_all_in").get<bool>();
+    return StreetSetting(SizesOrEmpty(j_setting, "bet_sizes_percent"),
+                         SizesOrEmpty(j_setting, "raise_sizes_percent"),
+                         SizesOrEmpty(j_setting, "donk_sizes_percent"), allow_all_in);
+}
+
+Rule RuleFromJson(const json& j_rule, const core::Deck& deck) {
+    try {
+        core::GameRound starting_round = ParseStartingRound(j_rule.at("starting_round").get<std::string>());
+        const json commitments = j_rule.value("initial_commitments", json::object());
+        const json blinds = j_rule.value("blinds", json::object());
+
+        std::vector<int> board;
+        if (j_rule.contains("initial_board") && j_rule.at("initial_board").is_array()) {
+            for (const auto& j_card : j_rule.at("initial_board")) {
+                std::string card = j_card.get<std::string>();
+                std::optional<int> card_int = core::Card::StringToInt(card);
+                if (!card_int) throw std::invalid_argument("Invalid card in initial_board: " + card);
+                board.push_back(*card_int);
+            }
+        }
+
+        GameTreeBuildingSettings build_settings;
+        if (j_rule.contains("building_settings") && j_rule.at("building_settings").is_object()) {
+            const json& j_settings = j_rule.at("building_settings");
+            build_settings = GameTreeBuildingSettings(
+                StreetSettingFromJson(j_settings.at("flop_ip")), StreetSettingFromJson(j_settings.at("turn_ip")),
+                StreetSettingFromJson(j_settings.at("river_ip")), StreetSettingFromJson(j_settings.at("flop_oop")),
+                StreetSettingFromJson(j_settings.at("turn_oop")), StreetSettingFromJson(j_settings.at("river_oop")));
+        }
+
+        Rule rule(deck, commitments.value("oop", 0.0), commitments.value("ip", 0.0), starting_round, board,
+                  j_rule.at("raise_limit_per_street").get<int>(), blinds.value("sb", 0.0), blinds.value("bb", 0.0),
+                  j_rule.at("effective_stack").get<double>(), build_settings,
+                  j_rule.value("all_in_threshold_ratio", 0.98));
+        rule.SetDepthLimited(j_rule.value("depth_limited", false));
+        return rule;
+    } catch (const json::exception& e) {
+        throw std::invalid_argument(std::string("Invalid game_rule in scenario: ") + e.what());
+    }
+}
+
+Scenario ScenarioFromJson(const json& j_scenario, const core::Deck& deck) {
+    if (!j_scenario.is_object() || !j_scenario.contains("game_rule")) {
+        throw std::invalid_argument("Scenario has no game_rule.");
+    }
+    Scenario scenario{j_scenario.value("test_case_name", std::string()),
+                      j_scenario.value("description", std::string()),
+                      RuleFromJson(j_scenario.at("game_rule"), deck),
+                      {}};
+    try {
+        const json& j_ranges = j_scenario.at("player_ranges");
+        scenario.ranges = {j_ranges.at("ip").get<std::string>(), j_ranges.at("oop").get<std::string>()};
+        const json solver_config = j_scenario.value("solver_config", json::object());
+        scenario.iterations = solver_config.value("iterations", 0);
+        scenario.threads = solver_config.value("threads", 0);
+    } catch (const json::exception& e) {
+        throw std::invalid_argument(std::string("Invalid scenario: ") + e.what());
+    }
+    return scenario;
+}
+
+Scenario LoadScenarioFile(const std::string& path, const core::Deck& deck) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Cannot open scenario file: " + path);
+    json j_scenario;
+    try {
+        in >> j_scenario;
+    } catch (const json::parse_error& e) {
+        throw std::runtime_error("Cannot parse scenario file " + path + ": " + e.what());
+    }
+    return ScenarioFromJson(j_scenario, deck);
+}
+
+} // namespace config
+} // namespace poker_solver
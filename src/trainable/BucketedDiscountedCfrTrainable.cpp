@@ -0,0 +1,260 @@
+#include "trainable/BucketedDiscountedCfrTrainable.h"
+#include "nodes/ActionNode.h"  // Need full definition for constructor
+#include "nodes/GameActions.h" // For dumping action strings
+#include "tools/BinaryIo.h"    // For checkpoint I/O
+
+#include <algorithm> // For std::fill, std::max
+#include <limits>    // For numeric_limits
+#include <stdexcept> // For exceptions
+#include <string>
+#include <utility>   // For std::move
+
+namespace poker_solver {
+namespace solver {
+
+namespace {
+
+// Buffers returned by Get*Strategy (see the class comment).
+thread_local std::vector<double> tls_current_strategy;
+thread_local std::vector<double> tls_average_strategy;
+
+} // namespace
+
+BucketedDiscountedCfrTrainable::BucketedDiscountedCfrTrainable(
+    const std::vector<core::PrivateCards>* player_range,
+    const nodes::ActionNode& action_node,
+    std::shared_ptr<const HandBuckets> buckets)
+    : action_node_(action_node),
+      player_range_(player_range),
+      buckets_(std::move(buckets)) {
+
+    if (!player_range_) {
+        throw std::invalid_argument("BucketedDiscountedCfrTrainable: Player range pointer cannot be null.");
+    }
+    if (!buckets_) {
+        throw std::invalid_argument("BucketedDiscountedCfrTrainable: Buckets cannot be null.");
+    }
+    num_actions_ = action_node_.GetActions().size();
+    num_hands_ = player_range_->size();
+    if (buckets_->bucket_of_hand.size() != num_hands_) {
+        throw std::invalid_argument("BucketedDiscountedCfrTrainable: Buckets do not match the range.");
+    }
+    for (uint32_t bucket : buckets_->bucket_of_hand) {
+        if (bucket >= buckets_->num_buckets) {
+            throw std::invalid_argument("BucketedDiscountedCfrTrainable: Hand bucket out of range.");
+        }
+    }
+
+    const size_t table_size = buckets_->num_buckets * num_actions_;
+    cumulative_regrets_.assign(table_size, 0.0);
+    cumulative_strategy_sum_.assign(table_size, 0.0);
+    bucket_regret_scratch_.assign(table_size, 0.0);
+}
+
+void BucketedDiscountedCfrTrainable::RegretMatchRow(size_t bucket, double* out) const {
+    const double default_prob = 1.0 / static_cast<double>(num_actions_);
+    const double* regrets = cumulative_regrets_.data() + bucket * num_actions_;
+    double regret_sum = 0.0;
+    for (size_t a = 0; a < num_actions_; ++a) regret_sum += std::max(0.0, regrets[a]);
+    for (size_t a = 0; a < num_actions_; ++a) {
+        out[a] = (regret_sum > 1e-12) ? std::max(0.0, regrets[a]) / regret_sum : default_prob;
+    }
+}
+
+// --- Strategies ---
+
+const double* BucketedDiscountedCfrTrainable::CurrentStrategy(double* scratch) const {
+    if (num_actions_ == 0) return scratch;
+    for (size_t h = 0; h < num_hands_; ++h) {
+        RegretMatchRow(buckets_->bucket_of_hand[h], scratch + h * num_actions_);
+    }
+    return scratch;
+}
+
+const std::vector<double>& BucketedDiscountedCfrTrainable::GetCurrentStrategy() const {
+    tls_current_strategy.resize(num_actions_ * num_hands_);
+    CurrentStrategy(tls_current_strategy.data());
+    return tls_current_strategy;
+}
+
+const std::vector<double>& BucketedDiscountedCfrTrainable::GetAverageStrategy() const {
+    tls_average_strategy.resize(num_actions_ * num_hands_);
+    if (num_actions_ == 0) return tls_average_strategy;
+    const double default_prob = 1.0 / static_cast<double>(num_actions_);
+    for (size_t h = 0; h < num_hands_; ++h) {
+        const double* sums = cumulative_strategy_sum_.data() + buckets_->bucket_of_hand[h] * num_actions_;
+        double* out = tls_average_strategy.data() + h * num_actions_;
+        double total = 0.0;
+        for (size_t a = 0; a < num_actions_; ++a) total += sums[a];
+        for (size_t a = 0; a < num_actions_; ++a) out[a] = (total > 1e-12) ? sums[a] / total : default_prob;
+    }
+    return tls_average_strategy;
+}
+
+// --- Updates ---
+
+void BucketedDiscountedCfrTrainable::AddRegrets(const double* weighted_regrets, const IterationDiscounts& discounts) {
+    std::fill(bucket_regret_scratch_.begin(), bucket_regret_scratch_.end(), 0.0);
+    for (size_t h = 0; h < num_hands_; ++h) {
+        double* incoming = bucket_regret_scratch_.data() + buckets_->bucket_of_hand[h] * num_actions_;
+        for (size_t a = 0; a < num_actions_; ++a) incoming[a] += weighted_regrets[h * num_actions_ + a];
+    }
+    for (size_t i = 0; i < cumulative_regrets_.size(); ++i) {
+        const double discount = cumulative_regrets_[i] > 0 ? discounts.positive_regret : discounts.negative_regret;
+        cumulative_regrets_[i] = cumulative_regrets_[i] * discount + bucket_regret_scratch_[i];
+    }
+}
+
+void BucketedDiscountedCfrTrainable::UpdateRegrets(const std::vector<double>& weighted_regrets, int iteration,
+                                                   double /*reach_prob_opponent_chance_scalar*/) {
+    if (weighted_regrets.size() != num_actions_ * num_hands_) {
+        throw std::invalid_argument("Regret vector size mismatch in UpdateRegrets.");
+    }
+    if (iteration <= 0) {
+        throw std::invalid_argument("Iteration number must be positive in UpdateRegrets.");
+    }
+    AddRegrets(weighted_regrets.data(), IterationDiscounts::For(iteration));
+}
+
+void BucketedDiscountedCfrTrainable::AccumulateAverageStrategy(const std::vector<double>& current_strategy,
+                                                               int iteration,
+                                                               const std::vector<double>& reach_probs_player_chance_vector) {
+    if (current_strategy.size() != num_actions_ * num_hands_ ||
+        reach_probs_player_chance_vector.size() != num_hands_) {
+        throw std::invalid_argument("Size mismatch in AccumulateAverageStrategy.");
+    }
+    if (iteration <= 0) {
+        throw std::invalid_argument("Iteration number must be positive in AccumulateAverageStrategy.");
+    }
+    const double gamma_discount_factor = IterationDiscounts::For(iteration).strategy_weight;
+    for (size_t h = 0; h < num_hands_; ++h) {
+        const double weight = std::max(0.0, reach_probs_player_chance_vector[h]) * gamma_discount_factor;
+        if (weight < 1e-12) continue;
+        double* sums = cumulative_strategy_sum_.data() + buckets_->bucket_of_hand[h] * num_actions_;
+        for (size_t a = 0; a < num_actions_; ++a) sums[a] += weight * current_strategy[h * num_actions_ + a];
+    }
+}
+
+void BucketedDiscountedCfrTrainable::UpdateFromVisit(const double* weighted_regrets,
+                                                     const double* current_strategy,
+                                                     const double* reach_weights,
+                                                     const IterationDiscounts& discounts) {
+    if (discounts.iteration <= 0) {
+        throw std::invalid_argument("Iteration number must be positive in UpdateFromVisit.");
+    }
+    if (num_actions_ == 0 || num_hands_ == 0) return;
+
+    // The strategy the visit played comes from the regrets before the
+    // update, so it is accumulated first.
+    const double gamma_discount_factor = discounts.strategy_weight;
+    for (size_t h = 0; h < num_hands_; ++h) {
+        const double weight = std::max(0.0, reach_weights[h]) * gamma_discount_factor;
+        if (weight < 1e-12) continue;
+        double* sums = cumulative_strategy_sum_.data() + buckets_->bucket_of_hand[h] * num_actions_;
+        for (size_t a = 0; a < num_actions_; ++a) sums[a] += weight * current_strategy[h * num_actions_ + a];
+    }
+    AddRegrets(weighted_regrets, discounts);
+}
+
+// --- Checkpointing and warm starts ---
+
+void BucketedDiscountedCfrTrainable::WriteState(std::ostream& out) const {
+    utils::WriteRaw(out, cumulative_regrets_.data(), cumulative_regrets_.size());
+    utils::WriteRaw(out, cumulative_strategy_sum_.data(), cumulative_strategy_sum_.size());
+}
+
+void BucketedDiscountedCfrTrainable::ReadState(std::istream& in) {
+    utils::ReadRaw(in, cumulative_regrets_.data(), cumulative_regrets_.size());
+    utils::ReadRaw(in, cumulative_strategy_sum_.data(), cumulative_strategy_sum_.size());
+}
+
+void BucketedDiscountedCfrTrainable::GetHandState(size_t hand, double* regrets, double* strategy_sums) const {
+    const size_t row = buckets_->bucket_of_hand[hand] * num_actions_;
+    std::copy(cumulative_regrets_.begin() + row, cumulative_regrets_.begin() + row + num_actions_, regrets);
+    std::copy(cumulative_strategy_sum_.begin() + row, cumulative_strategy_sum_.begin() + row + num_actions_,
+              strategy_sums);
+}
+
+void BucketedDiscountedCfrTrainable::SetHandState(size_t hand, const double* regrets, const double* strategy_sums) {
+    const size_t row = buckets_->bucket_of_hand[hand] * num_actions_;
+    std::copy(regrets, regrets + num_actions_, cumulative_regrets_.begin() + row);
+    std::copy(strategy_sums, strategy_sums + num_actions_, cumulative_strategy_sum_.begin() + row);
+}
+
+uint64_t BucketedDiscountedCfrTrainable::TableBytes() const {
+    return (cumulative_regrets_.capacity() + cumulative_strategy_sum_.capacity() +
+            bucket_regret_scratch_.capacity()) * sizeof(double);
+}
+
+// --- EVs and dumps ---
+
+void BucketedDiscountedCfrTrainable::SetEv(const std::vector<double>& evs) {
+    if (evs.size() != num_actions_ * num_hands_) {
+        throw std::invalid_argument("EV vector size mismatch in SetEv.");
+    }
+    expected_values_ = evs;
+}
+
+json BucketedDiscountedCfrTrainable::DumpStrategy(bool with_ev) const {
+    json result = json::object(); json strategy_map = json::object(); json ev_map = json::object();
+    const std::vector<double>& avg_strategy = GetAverageStrategy();
+    if (num_hands_ == 0) { result["warning"] = "Player range is empty"; }
+    std::vector<std::string> action_strings; action_strings.reserve(num_actions_);
+    for (const auto& action : action_node_.GetActions()) { action_strings.push_back(action.ToString()); }
+    result["actions"] = action_strings;
+
+    for (size_t h = 0; h < num_hands_; ++h) {
+        const std::string hand_str = (*player_range_)[h].ToString();
+        std::vector<double> hand_avg_strategy(avg_strategy.begin() + h * num_actions_,
+                                              avg_strategy.begin() + (h + 1) * num_actions_);
+        strategy_map[hand_str] = hand_avg_strategy;
+        if (with_ev) {
+            std::vector<double> hand_evs(num_actions_, std::numeric_limits<double>::quiet_NaN());
+            if (!expected_values_.empty()) {
+                std::copy(expected_values_.begin() + h * num_actions_, expected_values_.begin() + (h + 1) * num_actions_,
+                          hand_evs.begin());
+            }
+            ev_map[hand_str] = hand_evs;
+        }
+    }
+    result["strategy"] = strategy_map; if (with_ev) { result["evs"] = ev_map; } return result;
+}
+
+json BucketedDiscountedCfrTrainable::DumpEvs() const {
+    json result = json::object(); json ev_map = json::object();
+    if (num_hands_ == 0) { result["warning"] = "Player range is empty"; }
+    std::vector<std::string> action_strings; action_strings.reserve(num_actions_);
+    for (const auto& action : action_node_.GetActions()) { action_strings.push_back(action.ToString()); }
+    result["actions"] = action_strings;
+    for (size_t h = 0; h < num_hands_; ++h) {
+        std::vector<double> hand_evs(num_actions_, std::numeric_limits<double>::quiet_NaN());
+        if (!expected_values_.empty()) {
+            std::copy(expected_values_.begin() + h * num_actions_, expected_values_.begin() + (h + 1) * num_actions_,
+                      hand_evs.begin());
+        }
+        ev_map[(*player_range_)[h].ToString()] = hand_evs;
+    }
+    result["evs"] = ev_map; return result;
+}
+
+std::vector<double> BucketedDiscountedCfrTrainable::GetEvs() const {
+    return expected_values_;
+}
+
+void BucketedDiscountedCfrTrainable::CopyStateFrom(const Trainable& other) {
+    const auto* other_bucketed = dynamic_cast<const BucketedDiscountedCfrTrainable*>(&other);
+    if (!other_bucketed) {
+        throw std::invalid_argument("Cannot copy state: 'other' is not a BucketedDiscountedCfrTrainable.");
+    }
+    if (num_actions_ != other_bucketed->num_actions_ || num_hands_ != other_bucketed->num_hands_) {
+        throw std::invalid_argument("Cannot copy state: Dimensions mismatch.");
+    }
+    buckets_ = other_bucketed->buckets_;
+    cumulative_regrets_ = other_bucketed->cumulative_regrets_;
+    cumulative_strategy_sum_ = other_bucketed->cumulative_strategy_sum_;
+    bucket_regret_scratch_.assign(cumulative_regrets_.size(), 0.0);
+    expected_values_ = other_bucketed->expected_values_;
+}
+
+} // namespace solver
+} // namespace poker_solver
@@ -1,117 +1,266 @@
 #include "trainable/CFRPlus.h"
-#include <cmath>
-#include <limits>
-#include <nlohmann/json.hpp>
-
-namespace PokerSolver {
-
-CFRPlus::CFRPlus(int numActions)
-    : numActions_(numActions),
-      cumulativeRegrets_(numActions, 0.0f),
-      strategySum_(numActions, 0.0f),
-      currentStrategy_(numActions, 1.0f / numActions),
-      evs_(numActions, 0.0f)
-{
-    if (numActions_ <= 0) {
-        throw std::invalid_argument("CFRPlus: Number of actions must be positive.");
+#include "nodes/ActionNode.h"             // Need full definition for constructor
+#include "nodes/GameActions.h"            // For dumping action strings
+#include "ranges/PrivateCards.h"          // For PrivateCards info
+
+#include <json.hpp>
+#include <vector>
+#include <stdexcept> // For exceptions
+#include <sstream>   // For error messages
+#include <limits>    // For numeric_limits
+#include <iostream>  // For std::cerr
+#include <algorithm> // For std::max
+
+// Use aliases
+using json = nlohmann::json;
+namespace core = poker_solver::core;
+namespace nodes = poker_solver::nodes;
+
+namespace poker_solver {
+namespace solver {
+
+namespace {
+
+// Per-thread scratch buffers returned by Get*Strategy (see header note).
+thread_local std::vector<double> tls_current_strategy;
+thread_local std::vector<double> tls_average_strategy;
+// Per-thread row buffer for read-modify-write of one hand.
+thread_local std::vector<double> tls_row;
+
+} // namespace
+
+template <typename Storage>
+CfrPlusTrainable<Storage>::CfrPlusTrainable(
+    const std::vector<core::PrivateCards>* player_range,
+    const nodes::ActionNode& action_node)
+    : action_node_(action_node),
+      player_range_(player_range) {
+    if (!player_range_) {
+        throw std::invalid_argument("CfrPlusTrainable: Player range pointer cannot be null.");
+    }
+    num_actions_ = action_node_.GetActions().size();
+    num_hands_ = player_range_->size();
+    if (num_actions_ == 0) {
+        std::cerr << "[WARN] CfrPlusTrainable created for ActionNode with 0 actions." << std::endl;
     }
+    cumulative_regrets_.Resize(num_hands_, num_actions_);
+    cumulative_strategy_sum_.Resize(num_hands_, num_actions_);
 }
 
-std::vector<float> CFRPlus::getAverageStrategy() const {
-    std::vector<float> avgStrategy(numActions_, 0.0f);
-    float sum = std::accumulate(strategySum_.begin(), strategySum_.end(), 0.0f);
-    if (sum > std::numeric_limits<float>::epsilon()) {
-        for (int i = 0; i < numActions_; ++i) {
-            avgStrategy[i] = strategySum_[i] / sum;
+// --- Helpers ---
+
+template <typename Storage>
+void CfrPlusTrainable<Storage>::NormalizeRows(const Storage& storage, double* out) const {
+    if (num_actions_ == 0) return;
+    double default_prob = 1.0 / static_cast<double>(num_actions_);
+    for (size_t h = 0; h < num_hands_; ++h) {
+        double* row = out + h * num_actions_;
+        storage.DecodeRow(h, row);
+        double row_sum = 0.0;
+        for (size_t a = 0; a < num_actions_; ++a) {
+            row[a] = std::max(0.0, row[a]); // Quantization may leave -0.0
+            row_sum += row[a];
+        }
+        for (size_t a = 0; a < num_actions_; ++a) {
+            row[a] = (row_sum > 1e-12) ? row[a] / row_sum : default_prob;
         }
-    } else {
-        // If no strategy sum, return uniform distribution.
-        std::fill(avgStrategy.begin(), avgStrategy.end(), 1.0f / numActions_);
     }
-    return avgStrategy;
 }
 
-std::vector<float> CFRPlus::getCurrentStrategy() const {
-    return currentStrategy_;
+template <typename Storage>
+void CfrPlusTrainable<Storage>::AddRegrets(const double* weighted_regrets) {
+    tls_row.resize(num_actions_);
+    double* row = tls_row.data();
+    for (size_t h = 0; h < num_hands_; ++h) {
+        cumulative_regrets_.DecodeRow(h, row);
+        const double* incoming = weighted_regrets + h * num_actions_;
+        for (size_t a = 0; a < num_actions_; ++a) {
+            row[a] = std::max(0.0, row[a] + incoming[a]);
+        }
+        cumulative_regrets_.EncodeRow(h, row);
+    }
 }
 
-void CFRPlus::updateRegrets(const std::vector<float>& regrets,
-                            int /*iterationNumber*/,
-                            const std::vector<float>& reachProbs)
-{
-    if (regrets.size() != static_cast<size_t>(numActions_) || reachProbs.size() != static_cast<size_t>(numActions_)) {
-        throw std::invalid_argument("CFRPlus::updateRegrets: Size mismatch for regrets or reach probabilities.");
+template <typename Storage>
+void CfrPlusTrainable<Storage>::AddStrategy(const double* current_strategy,
+                                            const double* reach_weights, double weight) {
+    tls_row.resize(num_actions_);
+    double* row = tls_row.data();
+    for (size_t h = 0; h < num_hands_; ++h) {
+        double hand_weight = std::max(0.0, reach_weights[h]) * weight;
+        if (hand_weight < 1e-12) continue;
+        cumulative_strategy_sum_.DecodeRow(h, row);
+        const double* strat = current_strategy + h * num_actions_;
+        for (size_t a = 0; a < num_actions_; ++a) {
+            row[a] += hand_weight * strat[a];
+        }
+        cumulative_strategy_sum_.EncodeRow(h, row);
     }
+}
 
-    // Update cumulative regrets using CFR+ update rule: only accumulate if positive.
-    for (int i = 0; i < numActions_; ++i) {
-        float newRegret = cumulativeRegrets_[i] + regrets[i];
-        cumulativeRegrets_[i] = std::max(newRegret, 0.0f);
-    }
+// --- Overridden Interface Methods ---
+
+template <typename Storage>
+const std::vector<double>& CfrPlusTrainable<Storage>::GetCurrentStrategy() const {
+    tls_current_strategy.resize(num_actions_ * num_hands_);
+    NormalizeRows(cumulative_regrets_, tls_current_strategy.data());
+    return tls_current_strategy;
+}
 
-    // Recalculate current strategy based on the positive cumulative regrets.
-    recalcCurrentStrategy();
+template <typename Storage>
+const std::vector<double>& CfrPlusTrainable<Storage>::GetAverageStrategy() const {
+    tls_average_strategy.resize(num_actions_ * num_hands_);
+    NormalizeRows(cumulative_strategy_sum_, tls_average_strategy.data());
+    return tls_average_strategy;
+}
 
-    // Update strategy sum weighted by the reach probabilities.
-    for (int i = 0; i < numActions_; ++i) {
-        strategySum_[i] += reachProbs[i] * currentStrategy_[i];
-    }
+template <typename Storage>
+const double* CfrPlusTrainable<Storage>::CurrentStrategy(double* scratch) const {
+    NormalizeRows(cumulative_regrets_, scratch);
+    return scratch;
 }
 
-void CFRPlus::setEv(const std::vector<float>& evs) {
-    if (evs.size() != static_cast<size_t>(numActions_)) {
-        throw std::invalid_argument("CFRPlus::setEv: EV vector size does not match number of actions.");
+template <typename Storage>
+void CfrPlusTrainable<Storage>::UpdateRegrets(
+    const std::vector<double>& weighted_regrets, int iteration,
+    double /*reach_prob_opponent_chance_scalar*/) {
+    if (weighted_regrets.size() != num_actions_ * num_hands_) {
+        throw std::invalid_argument("Regret vector size mismatch in UpdateRegrets.");
     }
-    evs_ = evs;
+    if (iteration <= 0) {
+        throw std::invalid_argument("Iteration number must be positive in UpdateRegrets.");
+    }
+    AddRegrets(weighted_regrets.data());
 }
 
-void CFRPlus::copyStrategy(const std::shared_ptr<Trainable>& other) {
-    // Attempt dynamic_cast to ensure that 'other' is a CFRPlus instance.
-    auto otherCFR = std::dynamic_pointer_cast<CFRPlus>(other);
-    if (!otherCFR) {
-        throw std::invalid_argument("CFRPlus::copyStrategy: Incompatible Trainable type.");
+template <typename Storage>
+void CfrPlusTrainable<Storage>::AccumulateAverageStrategy(
+    const std::vector<double>& current_strategy, int iteration,
+    const std::vector<double>& reach_probs_player_chance_vector) {
+    size_t total_size = num_actions_ * num_hands_;
+    if (current_strategy.size() != total_size || reach_probs_player_chance_vector.size() != num_hands_) {
+        std::ostringstream oss;
+        oss << "Size mismatch in AccumulateAverageStrategy: strategy=" << current_strategy.size()
+            << " (expected " << total_size << "), reach_probs=" << reach_probs_player_chance_vector.size()
+            << " (expected " << num_hands_ << ")";
+        throw std::invalid_argument(oss.str());
     }
-    cumulativeRegrets_ = otherCFR->cumulativeRegrets_;
-    strategySum_ = otherCFR->strategySum_;
-    currentStrategy_ = otherCFR->currentStrategy_;
-    evs_ = otherCFR->evs_;
-}
-
-json CFRPlus::dumpStrategy(bool withState, int /*depth*/) const {
-    json j;
-    j["currentStrategy"] = currentStrategy_;
-    j["averageStrategy"] = getAverageStrategy();
-    if (withState) {
-        j["cumulativeRegrets"] = cumulativeRegrets_;
-        j["strategySum"] = strategySum_;
+    if (iteration <= 0) {
+        throw std::invalid_argument("Iteration number must be positive in AccumulateAverageStrategy.");
     }
-    return j;
+    AddStrategy(current_strategy.data(), reach_probs_player_chance_vector.data(),
+                static_cast<double>(iteration));
 }
 
-json CFRPlus::dumpEvs() const {
-    json j;
-    j["evs"] = evs_;
-    return j;
+template <typename Storage>
+void CfrPlusTrainable<Storage>::UpdateFromVisit(
+    const double* weighted_regrets, const double* current_strategy,
+    const double* reach_weights, const IterationDiscounts& discounts) {
+    if (discounts.iteration <= 0) {
+        throw std::invalid_argument("Iteration number must be positive in UpdateFromVisit.");
+    }
+    AddRegrets(weighted_regrets);
+    AddStrategy(current_strategy, reach_weights, discounts.strategy_weight);
 }
 
-Trainable::Type CFRPlus::getType() const {
-    return Trainable::Type::CFR_PLUS;
+template <typename Storage>
+void CfrPlusTrainable<Storage>::WriteState(std::ostream& out) const {
+    cumulative_regrets_.Write(out);
+    cumulative_strategy_sum_.Write(out);
 }
 
-void CFRPlus::recalcCurrentStrategy() {
-    float sumPos = 0.0f;
-    for (int i = 0; i < numActions_; ++i) {
-        // Use the positive part of the cumulative regret.
-        sumPos += cumulativeRegrets_[i];
+template <typename Storage>
+void CfrPlusTrainable<Storage>::ReadState(std::istream& in) {
+    cumulative_regrets_.Read(in);
+    cumulative_strategy_sum_.Read(in);
+}
+
+template <typename Storage>
+void CfrPlusTrainable<Storage>::GetHandState(size_t hand, double* regrets, double* strategy_sums) const {
+    cumulative_regrets_.DecodeRow(hand, regrets);
+    cumulative_strategy_sum_.DecodeRow(hand, strategy_sums);
+}
+
+template <typename Storage>
+void CfrPlusTrainable<Storage>::SetHandState(size_t hand, const double* regrets, const double* strategy_sums) {
+    cumulative_regrets_.EncodeRow(hand, regrets);
+    cumulative_strategy_sum_.EncodeRow(hand, strategy_sums);
+}
+
+template <typename Storage>
+void CfrPlusTrainable<Storage>::SetEv(const std::vector<double>& evs) {
+    if (evs.size() != num_actions_ * num_hands_) {
+        throw std::invalid_argument("EV vector size mismatch in SetEv.");
+    }
+    expected_values_.assign(evs.begin(), evs.end());
+}
+
+template <typename Storage>
+json CfrPlusTrainable<Storage>::DumpStrategy(bool with_ev) const {
+    json result = json::object(); json strategy_map = json::object(); json ev_map = json::object();
+    const auto& avg_strategy = GetAverageStrategy();
+    if (num_hands_ == 0) { result["warning"] = "Player range is empty"; }
+    std::vector<std::string> action_strings; action_strings.reserve(num_actions_);
+    for (const auto& action : action_node_.GetActions()) { action_strings.push_back(action.ToString()); }
+    result["actions"] = action_strings;
+
+    for (size_t h = 0; h < num_hands_; ++h) {
+        std::string hand_str = (*player_range_)[h].ToString();
+        std::vector<double> hand_avg_strategy(avg_strategy.begin() + h * num_actions_,
+                                              avg_strategy.begin() + (h + 1) * num_actions_);
+        strategy_map[hand_str] = hand_avg_strategy;
+        if (with_ev) {
+            std::vector<double> hand_evs(num_actions_, std::numeric_limits<double>::quiet_NaN());
+            if (!expected_values_.empty()) {
+                for (size_t a = 0; a < num_actions_; ++a) hand_evs[a] = expected_values_[h * num_actions_ + a];
+            }
+            ev_map[hand_str] = hand_evs;
+        }
     }
-    if (sumPos > std::numeric_limits<float>::epsilon()) {
-        for (int i = 0; i < numActions_; ++i) {
-            currentStrategy_[i] = cumulativeRegrets_[i] / sumPos;
+    result["strategy"] = strategy_map; if (with_ev) { result["evs"] = ev_map; } return result;
+}
+
+template <typename Storage>
+json CfrPlusTrainable<Storage>::DumpEvs() const {
+    json result = json::object(); json ev_map = json::object();
+    if (num_hands_ == 0) { result["warning"] = "Player range is empty"; }
+    std::vector<std::string> action_strings; action_strings.reserve(num_actions_);
+    for (const auto& action : action_node_.GetActions()) { action_strings.push_back(action.ToString()); }
+    result["actions"] = action_strings;
+    for (size_t h = 0; h < num_hands_; ++h) {
+        std::vector<double> hand_evs(num_actions_, std::numeric_limits<double>::quiet_NaN());
+        if (!expected_values_.empty()) {
+            for (size_t a = 0; a < num_actions_; ++a) hand_evs[a] = expected_values_[h * num_actions_ + a];
         }
-    } else {
-        // When no positive regrets exist, fallback to uniform distribution.
-        std::fill(currentStrategy_.begin(), currentStrategy_.end(), 1.0f / numActions_);
+        ev_map[(*player_range_)[h].ToString()] = hand_evs;
     }
+    result["evs"] = ev_map; return result;
+}
+
+template <typename Storage>
+std::vector<double> CfrPlusTrainable<Storage>::GetEvs() const {
+    return std::vector<double>(expected_values_.begin(), expected_values_.end());
 }
 
-} // namespace PokerSolver
+template <typename Storage>
+void CfrPlusTrainable<Storage>::CopyStateFrom(const Trainable& other) {
+    const auto* other_ptr = dynamic_cast<const CfrPlusTrainable<Storage>*>(&other);
+    if (!other_ptr) { throw std::invalid_argument("Cannot copy state: 'other' is not the same CFR+ trainable type."); }
+    if (num_actions_ != other_ptr->num_actions_ || num_hands_ != other_ptr->num_hands_) { throw std::invalid_argument("Cannot copy state: Dimensions mismatch."); }
+    cumulative_regrets_ = other_ptr->cumulative_regrets_;
+    cumulative_strategy_sum_ = other_ptr->cumulative_strategy_sum_;
+    expected_values_ = other_ptr->expected_values_;
+}
+
+template <typename Storage>
+size_t CfrPlusTrainable<Storage>::MemoryBytes() const {
+    return cumulative_regrets_.MemoryBytes() + cumulative_strategy_sum_.MemoryBytes() +
+           expected_values_.capacity() * sizeof(float);
+}
+
+// --- Explicit Instantiations ---
+template class CfrPlusTrainable<FloatRowStorage>;
+template class CfrPlusTrainable<Int16RowStorage>;
+
+} // namespace solver
+} // namespace poker_solver
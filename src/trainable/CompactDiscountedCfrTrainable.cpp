@@ -0,0 +1,361 @@
+#include "trainable/CompactDiscountedCfrTrainable.h"
+#include "nodes/ActionNode.h"             // Need full definition for constructor
+#include "nodes/GameActions.h"            // For dumping action strings
+#include "ranges/PrivateCards.h"          // For PrivateCards info
+#include "tools/BinaryIo.h"               // For checkpoint I/O
+
+#include <json.hpp>
+#include <vector>
+#include <cmath>     // For std::lround, std::abs
+#include <stdexcept> // For exceptions
+#include <sstream>   // For error messages
+#include <limits>    // For numeric_limits
+#include <iostream>  // For std::cerr
+#include <algorithm> // For std::max, std::min
+
+// Use aliases
+using json = nlohmann::json;
+namespace core = poker_solver::core;
+namespace nodes = poker_solver::nodes;
+
+namespace poker_solver {
+namespace solver {
+
+namespace {
+
+// Per-thread scratch buffers returned by Get*Strategy (see header note).
+thread_local std::vector<double> tls_current_strategy;
+thread_local std::vector<double> tls_average_strategy;
+// Per-thread row buffer for read-modify-write of one hand.
+thread_local std::vector<double> tls_row;
+
+constexpr double kInt16Max = 32767.0;
+
+} // namespace
+
+// --- FloatRowStorage ---
+
+void FloatRowStorage::Resize(size_t rows, size_t cols) {
+    cols_ = cols;
+    data_.assign(rows * cols, 0.0f);
+}
+
+void FloatRowStorage::DecodeRow(size_t row, double* out) const {
+    const float* src = data_.data() + row * cols_;
+    for (size_t c = 0; c < cols_; ++c) out[c] = static_cast<double>(src[c]);
+}
+
+void FloatRowStorage::EncodeRow(size_t row, const double* in) {
+    float* dst = data_.data() + row * cols_;
+    for (size_t c = 0; c < cols_; ++c) dst[c] = static_cast<float>(in[c]);
+}
+
+size_t FloatRowStorage::MemoryBytes() const {
+    return data_.capacity() * sizeof(float);
+}
+
+void FloatRowStorage::Write(std::ostream& out) const {
+    utils::WriteRaw(out, data_.data(), data_.size());
+}
+
+void FloatRowStorage::Read(std::istream& in) {
+    utils::ReadRaw(in, data_.data(), data_.size());
+}
+
+// --- Int16RowStorage ---
+
+void Int16RowStorage::Resize(size_t rows, size_t cols) {
+    cols_ = cols;
+    data_.assign(rows * cols, 0);
+    row_scales_.assign(rows, 0.0f);
+}
+
+void Int16RowStorage::DecodeRow(size_t row, double* out) const {
+    const int16_t* src = data_.data() + row * cols_;
+    double scale = static_cast<double>(row_scales_[row]);
+    for (size_t c = 0; c < cols_; ++c) out[c] = static_cast<double>(src[c]) * scale;
+}
+
+void Int16RowStorage::EncodeRow(size_t row, const double* in) {
+    int16_t* dst = data_.data() + row * cols_;
+    double max_abs = 0.0;
+    for (size_t c = 0; c < cols_; ++c) max_abs = std::max(max_abs, std::abs(in[c]));
+    if (max_abs == 0.0 || !std::isfinite(max_abs)) {
+        row_scales_[row] = 0.0f;
+        for (size_t c = 0; c < cols_; ++c) dst[c] = 0;
+        return;
+    }
+    float scale = static_cast<float>(max_abs / kInt16Max);
+    row_scales_[row] = scale;
+    double inv_scale = 1.0 / static_cast<double>(scale);
+    for (size_t c = 0; c < cols_; ++c) {
+        double q = std::max(-kInt16Max, std::min(kInt16Max, in[c] * inv_scale));
+        dst[c] = static_cast<int16_t>(std::lround(q));
+    }
+}
+
+size_t Int16RowStorage::MemoryBytes() const {
+    return data_.capacity() * sizeof(int16_t) + row_scales_.capacity() * sizeof(float);
+}
+
+void Int16RowStorage::Write(std::ostream& out) const {
+    utils::WriteRaw(out, data_.data(), data_.size());
+    utils::WriteRaw(out, row_scales_.data(), row_scales_.size());
+}
+
+void Int16RowStorage::Read(std::istream& in) {
+    utils::ReadRaw(in, data_.data(), data_.size());
+    utils::ReadRaw(in, row_scales_.data(), row_scales_.size());
+}
+
+// --- CompactDiscountedCfrTrainable ---
+
+template <typename Storage>
+CompactDiscountedCfrTrainable<Storage>::CompactDiscountedCfrTrainable(
+    const std::vector<core::PrivateCards>* player_range,
+    const nodes::ActionNode& action_node)
+    : action_node_(action_node),
+      player_range_(player_range) {
+    if (!player_range_) {
+        throw std::invalid_argument("CompactDiscountedCfrTrainable: Player range pointer cannot be null.");
+    }
+    num_actions_ = action_node_.GetActions().size();
+    num_hands_ = player_range_->size();
+    if (num_actions_ == 0) {
+        std::cerr << "[WARN] CompactDiscountedCfrTrainable created for ActionNode with 0 actions." << std::endl;
+    }
+    cumulative_regrets_.Resize(num_hands_, num_actions_);
+    cumulative_strategy_sum_.Resize(num_hands_, num_actions_);
+}
+
+template <typename Storage>
+void CompactDiscountedCfrTrainable<Storage>::NormalizeRows(
+    const Storage& storage, bool positive_part, double* out) const {
+    if (num_actions_ == 0) return;
+    double default_prob = 1.0 / static_cast<double>(num_actions_);
+    for (size_t h = 0; h < num_hands_; ++h) {
+        double* row = out + h * num_actions_;
+        storage.DecodeRow(h, row);
+        double row_sum = 0.0;
+        for (size_t a = 0; a < num_actions_; ++a) {
+            if (positive_part) row[a] = std::max(0.0, row[a]);
+            row_sum += row[a];
+        }
+        for (size_t a = 0; a < num_actions_; ++a) {
+            row[a] = (row_sum > 1e-12) ? row[a] / row_sum : default_prob;
+        }
+    }
+}
+
+template <typename Storage>
+const std::vector<double>& CompactDiscountedCfrTrainable<Storage>::GetCurrentStrategy() const {
+    tls_current_strategy.resize(num_actions_ * num_hands_);
+    NormalizeRows(cumulative_regrets_, true, tls_current_strategy.data());
+    return tls_current_strategy;
+}
+
+template <typename Storage>
+const std::vector<double>& CompactDiscountedCfrTrainable<Storage>::GetAverageStrategy() const {
+    tls_average_strategy.resize(num_actions_ * num_hands_);
+    NormalizeRows(cumulative_strategy_sum_, false, tls_average_strategy.data());
+    return tls_average_strategy;
+}
+
+template <typename Storage>
+const double* CompactDiscountedCfrTrainable<Storage>::CurrentStrategy(double* scratch) const {
+    NormalizeRows(cumulative_regrets_, true, scratch);
+    return scratch;
+}
+
+template <typename Storage>
+void CompactDiscountedCfrTrainable<Storage>::UpdateRegrets(
+    const std::vector<double>& weighted_regrets, int iteration,
+    double /*reach_prob_opponent_chance_scalar*/) {
+    if (weighted_regrets.size() != num_actions_ * num_hands_) {
+        throw std::invalid_argument("Regret vector size mismatch in UpdateRegrets.");
+    }
+    if (iteration <= 0) {
+        throw std::invalid_argument("Iteration number must be positive in UpdateRegrets.");
+    }
+    IterationDiscounts discounts = IterationDiscounts::For(iteration);
+    double alpha_discount = discounts.positive_regret;
+    double beta_discount = discounts.negative_regret;
+
+    tls_row.resize(num_actions_);
+    double* row = tls_row.data();
+    for (size_t h = 0; h < num_hands_; ++h) {
+        cumulative_regrets_.DecodeRow(h, row);
+        const double* incoming = weighted_regrets.data() + h * num_actions_;
+        for (size_t a = 0; a < num_actions_; ++a) {
+            double discount_factor = (row[a] > 0) ? alpha_discount : beta_discount;
+            row[a] = row[a] * discount_factor + incoming[a];
+        }
+        cumulative_regrets_.EncodeRow(h, row);
+    }
+}
+
+template <typename Storage>
+void CompactDiscountedCfrTrainable<Storage>::AccumulateAverageStrategy(
+    const std::vector<double>& current_strategy, int iteration,
+    const std::vector<double>& reach_probs_player_chance_vector) {
+    size_t total_size = num_actions_ * num_hands_;
+    if (current_strategy.size() != total_size || reach_probs_player_chance_vector.size() != num_hands_) {
+        std::ostringstream oss;
+        oss << "Size mismatch in AccumulateAverageStrategy: strategy=" << current_strategy.size()
+            << " (expected " << total_size << "), reach_probs=" << reach_probs_player_chance_vector.size()
+            << " (expected " << num_hands_ << ")";
+        throw std::invalid_argument(oss.str());
+    }
+    if (iteration <= 0) {
+        throw std::invalid_argument("Iteration number must be positive in AccumulateAverageStrategy.");
+    }
+    double gamma_discount_factor = IterationDiscounts::For(iteration).strategy_weight;
+
+    tls_row.resize(num_actions_);
+    double* row = tls_row.data();
+    for (size_t h = 0; h < num_hands_; ++h) {
+        double weight = std::max(0.0, reach_probs_player_chance_vector[h]) * gamma_discount_factor;
+        if (weight < 1e-12) continue;
+        cumulative_strategy_sum_.DecodeRow(h, row);
+        const double* strat = current_strategy.data() + h * num_actions_;
+        for (size_t a = 0; a < num_actions_; ++a) {
+            row[a] += weight * strat[a];
+        }
+        cumulative_strategy_sum_.EncodeRow(h, row);
+    }
+}
+
+template <typename Storage>
+void CompactDiscountedCfrTrainable<Storage>::UpdateFromVisit(
+    const double* weighted_regrets, const double* current_strategy,
+    const double* reach_weights, const IterationDiscounts& discounts) {
+    if (discounts.iteration <= 0) {
+        throw std::invalid_argument("Iteration number must be positive in UpdateFromVisit.");
+    }
+    double alpha_discount = discounts.positive_regret;
+    double beta_discount = discounts.negative_regret;
+    double gamma_discount_factor = discounts.strategy_weight;
+
+    tls_row.resize(num_actions_);
+    double* row = tls_row.data();
+    for (size_t h = 0; h < num_hands_; ++h) {
+        cumulative_regrets_.DecodeRow(h, row);
+        const double* incoming = weighted_regrets + h * num_actions_;
+        for (size_t a = 0; a < num_actions_; ++a) {
+            double discount_factor = (row[a] > 0) ? alpha_discount : beta_discount;
+            row[a] = row[a] * discount_factor + incoming[a];
+        }
+        cumulative_regrets_.EncodeRow(h, row);
+
+        double weight = std::max(0.0, reach_weights[h]) * gamma_discount_factor;
+        if (weight < 1e-12) continue;
+        cumulative_strategy_sum_.DecodeRow(h, row);
+        const double* strat = current_strategy + h * num_actions_;
+        for (size_t a = 0; a < num_actions_; ++a) {
+            row[a] += weight * strat[a];
+        }
+        cumulative_strategy_sum_.EncodeRow(h, row);
+    }
+}
+
+template <typename Storage>
+void CompactDiscountedCfrTrainable<Storage>::WriteState(std::ostream& out) const {
+    cumulative_regrets_.Write(out);
+    cumulative_strategy_sum_.Write(out);
+}
+
+template <typename Storage>
+void CompactDiscountedCfrTrainable<Storage>::ReadState(std::istream& in) {
+    cumulative_regrets_.Read(in);
+    cumulative_strategy_sum_.Read(in);
+}
+
+template <typename Storage>
+void CompactDiscountedCfrTrainable<Storage>::GetHandState(size_t hand, double* regrets, double* strategy_sums) const {
+    cumulative_regrets_.DecodeRow(hand, regrets);
+    cumulative_strategy_sum_.DecodeRow(hand, strategy_sums);
+}
+
+template <typename Storage>
+void CompactDiscountedCfrTrainable<Storage>::SetHandState(size_t hand, const double* regrets, const double* strategy_sums) {
+    cumulative_regrets_.EncodeRow(hand, regrets);
+    cumulative_strategy_sum_.EncodeRow(hand, strategy_sums);
+}
+
+template <typename Storage>
+void CompactDiscountedCfrTrainable<Storage>::SetEv(const std::vector<double>& evs) {
+    if (evs.size() != num_actions_ * num_hands_) {
+        throw std::invalid_argument("EV vector size mismatch in SetEv.");
+    }
+    expected_values_.assign(evs.begin(), evs.end());
+}
+
+template <typename Storage>
+json CompactDiscountedCfrTrainable<Storage>::DumpStrategy(bool with_ev) const {
+    json result = json::object(); json strategy_map = json::object(); json ev_map = json::object();
+    const auto& avg_strategy = GetAverageStrategy();
+    if (num_hands_ == 0) { result["warning"] = "Player range is empty"; }
+    std::vector<std::string> action_strings; action_strings.reserve(num_actions_);
+    for (const auto& action : action_node_.GetActions()) { action_strings.push_back(action.ToString()); }
+    result["actions"] = action_strings;
+
+    for (size_t h = 0; h < num_hands_; ++h) {
+        std::string hand_str = (*player_range_)[h].ToString();
+        std::vector<double> hand_avg_strategy(avg_strategy.begin() + h * num_actions_,
+                                              avg_strategy.begin() + (h + 1) * num_actions_);
+        strategy_map[hand_str] = hand_avg_strategy;
+        if (with_ev) {
+            std::vector<double> hand_evs(num_actions_, std::numeric_limits<double>::quiet_NaN());
+            if (!expected_values_.empty()) {
+                for (size_t a = 0; a < num_actions_; ++a) hand_evs[a] = expected_values_[h * num_actions_ + a];
+            }
+            ev_map[hand_str] = hand_evs;
+        }
+    }
+    result["strategy"] = strategy_map; if (with_ev) { result["evs"] = ev_map; } return result;
+}
+
+template <typename Storage>
+json CompactDiscountedCfrTrainable<Storage>::DumpEvs() const {
+    json result = json::object(); json ev_map = json::object();
+    if (num_hands_ == 0) { result["warning"] = "Player range is empty"; }
+    std::vector<std::string> action_strings; action_strings.reserve(num_actions_);
+    for (const auto& action : action_node_.GetActions()) { action_strings.push_back(action.ToString()); }
+    result["actions"] = action_strings;
+    for (size_t h = 0; h < num_hands_; ++h) {
+        std::vector<double> hand_evs(num_actions_, std::numeric_limits<double>::quiet_NaN());
+        if (!expected_values_.empty()) {
+            for (size_t a = 0; a < num_actions_; ++a) hand_evs[a] = expected_values_[h * num_actions_ + a];
+        }
+        ev_map[(*player_range_)[h].ToString()] = hand_evs;
+    }
+    result["evs"] = ev_map; return result;
+}
+
+template <typename Storage>
+std::vector<double> CompactDiscountedCfrTrainable<Storage>::GetEvs() const {
+    return std::vector<double>(expected_values_.begin(), expected_values_.end());
+}
+
+template <typename Storage>
+void CompactDiscountedCfrTrainable<Storage>::CopyStateFrom(const Trainable& other) {
+    const auto* other_ptr = dynamic_cast<const CompactDiscountedCfrTrainable<Storage>*>(&other);
+    if (!other_ptr) { throw std::invalid_argument("Cannot copy state: 'other' is not the same compact trainable type."); }
+    if (num_actions_ != other_ptr->num_actions_ || num_hands_ != other_ptr->num_hands_) { throw std::invalid_argument("Cannot copy state: Dimensions mismatch."); }
+    cumulative_regrets_ = other_ptr->cumulative_regrets_;
+    cumulative_strategy_sum_ = other_ptr->cumulative_strategy_sum_;
+    expected_values_ = other_ptr->expected_values_;
+}
+
+template <typename Storage>
+size_t CompactDiscountedCfrTrainable<Storage>::MemoryBytes() const {
+    return cumulative_regrets_.MemoryBytes() + cumulative_strategy_sum_.MemoryBytes() +
+           expected_values_.capacity() * sizeof(float);
+}
+
+// --- Explicit Instantiations ---
+template class CompactDiscountedCfrTrainable<FloatRowStorage>;
+template class CompactDiscountedCfrTrainable<Int16RowStorage>;
+
+} // namespace solver
+} // namespace poker_solver
@@ -0,0 +1,29 @@
+#include "trainable/DcfrDiscounts.h"
+
+#include <cmath>     // For std::pow
+#include <sstream>   // For error messages
+#include <stdexcept> // For exceptions
+
+namespace poker_solver {
+namespace solver {
+
+IterationDiscounts IterationDiscounts::For(int iteration, const DcfrParameters& parameters) {
+    if (iteration <= 0) {
+        std::ostringstream oss;
+        oss << "Iteration number must be positive for DCFR discounts, got " << iteration << ".";
+        throw std::invalid_argument(oss.str());
+    }
+    double iter_d = static_cast<double>(iteration);
+    double alpha_power = std::pow(iter_d, parameters.alpha);
+    double beta_power = std::pow(iter_d, parameters.beta);
+
+    IterationDiscounts discounts;
+    discounts.iteration = iteration;
+    discounts.positive_regret = alpha_power / (alpha_power + 1.0);
+    discounts.negative_regret = beta_power / (beta_power + 1.0);
+    discounts.strategy_weight = std::pow(iter_d, parameters.gamma);
+    return discounts;
+}
+
+} // namespace solver
+} // namespace poker_solver
@@ -2,10 +2,11 @@
 #include "nodes/ActionNode.h"             // Need full definition for constructor
 #include "nodes/GameActions.h"            // For dumping action strings
 #include "ranges/PrivateCards.h"          // For PrivateCards info
+#include "tools/BinaryIo.h"               // For checkpoint I/O
 
 #include <json.hpp> // Include the actual JSON library header
 #include <vector>
-#include <cmath>     // For std::pow, std::max, std::isnan
+#include <cmath>     // For std::max, std::isnan
 #include <numeric>   // For std::accumulate
 #include <stdexcept> // For exceptions
 #include <limits>    // For numeric_limits
@@ -25,12 +26,25 @@ namespace nodes = poker_solver::nodes;
 namespace poker_solver {
 namespace solver {
 
+namespace {
+
+// Buffers returned by Get*Strategy with lazy strategies (see header note).
+thread_local std::vector<double> tls_current_strategy;
+thread_local std::vector<double> tls_average_strategy;
+
+} // namespace
+
 // --- Constructor ---
 DiscountedCfrTrainable::DiscountedCfrTrainable(
     const std::vector<core::PrivateCards>* player_range,
-    const nodes::ActionNode& action_node)
+    const nodes::ActionNode& action_node,
+    std::shared_ptr<TrainableArena> arena,
+    bool lazy_strategies,
+    bool defer_strategy_sums)
     : action_node_(action_node),
-      player_range_(player_range) {
+      player_range_(player_range),
+      lazy_strategies_(lazy_strategies),
+      arena_(std::move(arena)) {
 
     if (!player_range_) {
         throw std::invalid_argument("DiscountedCfrTrainable: Player range pointer cannot be null.");
@@ -48,109 +62,98 @@ DiscountedCfrTrainable::DiscountedCfrTrainable(
 
     size_t total_size = num_actions_ * num_hands_;
     if (total_size > 0) {
-        cumulative_regrets_.resize(total_size, 0.0);
-        cumulative_strategy_sum_.resize(total_size, 0.0);
-
-        double initial_prob = (num_actions_ > 0) ? 1.0 / static_cast<double>(num_actions_) : 0.0;
-        // Initialize Hand-Major: Iterate hands outer, actions inner
-        current_strategy_.resize(total_size);
-        average_strategy_.resize(total_size);
-        for (size_t h = 0; h < num_hands_; ++h) {
-            for (size_t a = 0; a < num_actions_; ++a) {
-                size_t index = h * num_actions_ + a; // Hand-Major index
-                current_strategy_[index] = initial_prob;
-                average_strategy_[index] = initial_prob;
-            }
+        // Regrets, strategy sums (unless deferred), current strategy (unless
+        // lazy).
+        size_t block_size = BlockDoubles(total_size, lazy_strategies_) - (defer_strategy_sums ? total_size : 0);
+        double* block = nullptr;
+        if (arena_) {
+            block = arena_->Allocate(block_size);
+        } else {
+            owned_storage_.resize(block_size);
+            block = owned_storage_.data();
+        }
+        cumulative_regrets_ = block;
+        std::fill(cumulative_regrets_, cumulative_regrets_ + total_size, 0.0);
+        size_t used = total_size;
+        if (!defer_strategy_sums) {
+            cumulative_strategy_sum_ = block + used;
+            std::fill(cumulative_strategy_sum_, cumulative_strategy_sum_ + total_size, 0.0);
+            used += total_size;
+        }
+        if (!lazy_strategies_) {
+            current_strategy_ = block + used;
+            std::fill(current_strategy_, current_strategy_ + total_size,
+                      1.0 / static_cast<double>(num_actions_));
         }
-        expected_values_.resize(total_size, std::numeric_limits<double>::quiet_NaN());
-
-        current_strategy_valid_ = true;
-        average_strategy_valid_ = true;
-    } else {
-        current_strategy_valid_ = true;
-        average_strategy_valid_ = true;
     }
+    current_strategy_valid_ = true;
+    average_strategy_valid_ = false; // Uniform until strategy sums arrive
 }
 
 // --- Strategy Calculation Helpers ---
 
-void DiscountedCfrTrainable::CalculateCurrentStrategy() {
-    if (current_strategy_valid_) return;
-
-    if (num_actions_ == 0 || num_hands_ == 0) {
-        current_strategy_.clear();
-        current_strategy_valid_ = true;
-        return;
-    }
-
-    double default_prob = (num_actions_ > 0) ? 1.0 / static_cast<double>(num_actions_) : 0.0;
-    size_t total_size = num_actions_ * num_hands_;
-    if(current_strategy_.size() != total_size) current_strategy_.resize(total_size);
-
+void DiscountedCfrTrainable::RegretMatch(double* out) const {
+    if (num_actions_ == 0) return;
+    double default_prob = 1.0 / static_cast<double>(num_actions_);
     for (size_t h = 0; h < num_hands_; ++h) {
+        size_t row = h * num_actions_; // Hand-Major index of action 0
         double regret_sum = 0.0;
         for (size_t a = 0; a < num_actions_; ++a) {
-            // *** FIXED INDEXING ***
-            size_t index = h * num_actions_ + a; // Hand-Major index
-            if(index < cumulative_regrets_.size()) {
-                regret_sum += std::max(0.0, cumulative_regrets_[index]);
-            }
+            regret_sum += std::max(0.0, cumulative_regrets_[row + a]);
         }
-
         for (size_t a = 0; a < num_actions_; ++a) {
-             // *** FIXED INDEXING ***
-            size_t index = h * num_actions_ + a; // Hand-Major index
-            if (index < current_strategy_.size() && index < cumulative_regrets_.size()) {
-                if (regret_sum > 1e-12) {
-                    current_strategy_[index] =
-                        std::max(0.0, cumulative_regrets_[index]) / regret_sum;
-                } else {
-                    current_strategy_[index] = default_prob;
-                }
-            }
+            out[row + a] = (regret_sum > 1e-12)
+                ? std::max(0.0, cumulative_regrets_[row + a]) / regret_sum : default_prob;
         }
     }
-    current_strategy_valid_ = true;
 }
 
-
-
-void DiscountedCfrTrainable::CalculateAverageStrategy() const {
-    if (average_strategy_valid_) return;
-
-    if (num_actions_ == 0 || num_hands_ == 0) {
-        average_strategy_.clear();
-        average_strategy_valid_ = true;
+void DiscountedCfrTrainable::NormalizeStrategySums(double* out) const {
+    if (num_actions_ == 0) return;
+    double default_prob = 1.0 / static_cast<double>(num_actions_);
+    if (!cumulative_strategy_sum_) {
+        std::fill(out, out + num_actions_ * num_hands_, default_prob);
         return;
     }
-
-    double default_prob = (num_actions_ > 0) ? 1.0 / static_cast<double>(num_actions_) : 0.0;
-    size_t total_size = num_actions_ * num_hands_;
-    if(average_strategy_.size() != total_size) average_strategy_.resize(total_size);
-
     for (size_t h = 0; h < num_hands_; ++h) {
+        size_t row = h * num_actions_; // Hand-Major index of action 0
         double strategy_sum_total = 0.0;
         for (size_t a = 0; a < num_actions_; ++a) {
-            // *** FIXED INDEXING ***
-             size_t index = h * num_actions_ + a; // Hand-Major index
-             if (index < cumulative_strategy_sum_.size()) {
-                 strategy_sum_total += cumulative_strategy_sum_[index];
-             }
+            strategy_sum_total += cumulative_strategy_sum_[row + a];
         }
-
         for (size_t a = 0; a < num_actions_; ++a) {
-            // *** FIXED INDEXING ***
-            size_t index = h * num_actions_ + a; // Hand-Major index
-            if (index < average_strategy_.size() && index < cumulative_strategy_sum_.size()) {
-                 if (strategy_sum_total > 1e-12) {
-                     average_strategy_[index] =
-                        cumulative_strategy_sum_[index] / strategy_sum_total;
-                 } else {
-                     average_strategy_[index] = default_prob;
-                 }
-            }
+            out[row + a] = (strategy_sum_total > 1e-12)
+                ? cumulative_strategy_sum_[row + a] / strategy_sum_total : default_prob;
         }
     }
+}
+
+void DiscountedCfrTrainable::EnsureStrategySums() {
+    if (cumulative_strategy_sum_) return;
+    const size_t total_size = num_actions_ * num_hands_;
+    if (total_size == 0) return;
+    if (arena_) {
+        cumulative_strategy_sum_ = arena_->Allocate(total_size);
+    } else {
+        owned_strategy_sums_.resize(total_size);
+        cumulative_strategy_sum_ = owned_strategy_sums_.data();
+    }
+    std::fill(cumulative_strategy_sum_, cumulative_strategy_sum_ + total_size, 0.0);
+}
+
+void DiscountedCfrTrainable::CalculateCurrentStrategy() {
+    if (current_strategy_valid_) return;
+    if (current_strategy_) RegretMatch(current_strategy_);
+    current_strategy_valid_ = true;
+}
+
+
+
+void DiscountedCfrTrainable::CalculateAverageStrategy() const {
+    if (average_strategy_valid_) return;
+
+    average_strategy_.resize(num_actions_ * num_hands_);
+    NormalizeStrategySums(average_strategy_.data());
     average_strategy_valid_ = true;
 }
 
@@ -158,13 +161,24 @@ void DiscountedCfrTrainable::CalculateAverageStrategy() const {
 // --- Overridden Interface Methods ---
 
 const std::vector<double>& DiscountedCfrTrainable::GetCurrentStrategy() const {
+    if (lazy_strategies_) {
+        tls_current_strategy.resize(num_actions_ * num_hands_);
+        RegretMatch(tls_current_strategy.data());
+        return tls_current_strategy;
+    }
     if (!current_strategy_valid_) {
         const_cast<DiscountedCfrTrainable*>(this)->CalculateCurrentStrategy();
     }
-    return current_strategy_;
+    current_strategy_view_.assign(current_strategy_, current_strategy_ + num_actions_ * num_hands_);
+    return current_strategy_view_;
 }
 
 const std::vector<double>& DiscountedCfrTrainable::GetAverageStrategy() const {
+    if (lazy_strategies_) {
+        tls_average_strategy.resize(num_actions_ * num_hands_);
+        NormalizeStrategySums(tls_average_strategy.data());
+        return tls_average_strategy;
+    }
     if (!average_strategy_valid_) {
         CalculateAverageStrategy();
     }
@@ -184,14 +198,12 @@ void DiscountedCfrTrainable::UpdateRegrets(const std::vector<double>& weighted_r
         throw std::invalid_argument("Iteration number must be positive in UpdateRegrets.");
     }
 
-    double iter_d = static_cast<double>(iteration);
-    double alpha_discount = std::pow(iter_d, kAlpha) / (std::pow(iter_d, kAlpha) + 1.0);
-    double beta_discount = std::pow(iter_d, kBeta) / (std::pow(iter_d, kBeta) + 1.0);
+    IterationDiscounts discounts = IterationDiscounts::For(iteration);
 
     // Loop over flat index, calculation is independent of layout here
     for (size_t i = 0; i < total_size; ++i) {
         double current_cum_regret = cumulative_regrets_[i];
-        double discount_factor = (current_cum_regret > 0) ? alpha_discount : beta_discount;
+        double discount_factor = (current_cum_regret > 0) ? discounts.positive_regret : discounts.negative_regret;
         double discounted_regret = current_cum_regret * discount_factor;
         cumulative_regrets_[i] = discounted_regret + weighted_regrets[i]; // Add pre-weighted regret
     }
@@ -216,8 +228,8 @@ void DiscountedCfrTrainable::AccumulateAverageStrategy(
          throw std::invalid_argument("Iteration number must be positive in AccumulateAverageStrategy.");
      }
 
-     double iter_d = static_cast<double>(iteration);
-     double gamma_discount_factor = std::pow(iter_d, kGamma); // Using t^gamma
+     double gamma_discount_factor = IterationDiscounts::For(iteration).strategy_weight; // Using t^gamma
+     if (gamma_discount_factor > 0.0) EnsureStrategySums();
 
 
      for (size_t h = 0; h < num_hands_; ++h) { // Iterate hands
@@ -227,11 +239,8 @@ void DiscountedCfrTrainable::AccumulateAverageStrategy(
          if (final_weight_for_hand < 1e-12) continue; // Skip if weight is zero
 
          for (size_t a = 0; a < num_actions_; ++a) { // Iterate actions
-            // *** FIXED INDEXING ***
              size_t index = h * num_actions_ + a; // Hand-Major index
-             if(index < current_strategy.size() && index < cumulative_strategy_sum_.size()) {
-                cumulative_strategy_sum_[index] += final_weight_for_hand * current_strategy[index];
-             }
+             cumulative_strategy_sum_[index] += final_weight_for_hand * current_strategy[index];
          }
      }
 
@@ -239,6 +248,114 @@ void DiscountedCfrTrainable::AccumulateAverageStrategy(
 }
 
 
+const double* DiscountedCfrTrainable::CurrentStrategy(double* scratch) const {
+    if (lazy_strategies_) {
+        RegretMatch(scratch);
+        return scratch;
+    }
+    if (!current_strategy_valid_) {
+        const_cast<DiscountedCfrTrainable*>(this)->CalculateCurrentStrategy();
+    }
+    return current_strategy_;
+}
+void DiscountedCfrTrainable::UpdateFromVisit(const double* weighted_regrets,
+    const double* current_strategy,
+    const double* reach_weights,
+    const IterationDiscounts& discounts) {
+
+    if (discounts.iteration <= 0) {
+        throw std::invalid_argument("Iteration number must be positive in UpdateFromVisit.");
+    }
+    if (num_actions_ == 0 || num_hands_ == 0) return;
+
+    double alpha_discount = discounts.positive_regret;
+    double beta_discount = discounts.negative_regret;
+    double gamma_discount_factor = discounts.strategy_weight;
+    double default_prob = 1.0 / static_cast<double>(num_actions_);
+    if (gamma_discount_factor > 0.0) EnsureStrategySums();
+
+    for (size_t h = 0; h < num_hands_; ++h) {
+        size_t row = h * num_actions_; // Hand-Major index of action 0
+        // Average first: 'current_strategy' may alias the row rewritten below.
+        double final_weight_for_hand = std::max(0.0, reach_weights[h]) * gamma_discount_factor;
+        if (final_weight_for_hand >= 1e-12) {
+            for (size_t a = 0; a < num_actions_; ++a) {
+                cumulative_strategy_sum_[row + a] += final_weight_for_hand * current_strategy[row + a];
+            }
+        }
+
+        double regret_sum = 0.0;
+        for (size_t a = 0; a < num_actions_; ++a) {
+            double current_cum_regret = cumulative_regrets_[row + a];
+            double discount_factor = (current_cum_regret > 0) ? alpha_discount : beta_discount;
+            cumulative_regrets_[row + a] = current_cum_regret * discount_factor + weighted_regrets[row + a];
+            regret_sum += std::max(0.0, cumulative_regrets_[row + a]);
+        }
+        if (!current_strategy_) continue; // Regret-matched on the next visit
+        for (size_t a = 0; a < num_actions_; ++a) {
+            current_strategy_[row + a] = (regret_sum > 1e-12)
+                ? std::max(0.0, cumulative_regrets_[row + a]) / regret_sum : default_prob;
+        }
+    }
+
+    current_strategy_valid_ = true;
+    average_strategy_valid_ = false;
+}
+
+
+void DiscountedCfrTrainable::WriteState(std::ostream& out) const {
+    const size_t total_size = num_actions_ * num_hands_;
+    utils::WriteRaw(out, cumulative_regrets_, total_size);
+    if (cumulative_strategy_sum_) {
+        utils::WriteRaw(out, cumulative_strategy_sum_, total_size);
+    } else {
+        const std::vector<double> zeros(total_size, 0.0);
+        utils::WriteRaw(out, zeros.data(), total_size);
+    }
+}
+
+void DiscountedCfrTrainable::ReadState(std::istream& in) {
+    const size_t total_size = num_actions_ * num_hands_;
+    utils::ReadRaw(in, cumulative_regrets_, total_size);
+    if (cumulative_strategy_sum_) {
+        utils::ReadRaw(in, cumulative_strategy_sum_, total_size);
+    } else {
+        // Deferred sums stay unallocated while the checkpoint has none.
+        std::vector<double> sums(total_size);
+        utils::ReadRaw(in, sums.data(), total_size);
+        if (std::any_of(sums.begin(), sums.end(), [](double value) { return value != 0.0; })) {
+            EnsureStrategySums();
+            std::copy(sums.begin(), sums.end(), cumulative_strategy_sum_);
+        }
+    }
+    current_strategy_valid_ = false;
+    average_strategy_valid_ = false;
+}
+
+void DiscountedCfrTrainable::GetHandState(size_t hand, double* regrets, double* strategy_sums) const {
+    const size_t offset = hand * num_actions_;
+    std::copy(cumulative_regrets_ + offset, cumulative_regrets_ + offset + num_actions_, regrets);
+    if (cumulative_strategy_sum_) {
+        std::copy(cumulative_strategy_sum_ + offset, cumulative_strategy_sum_ + offset + num_actions_, strategy_sums);
+    } else {
+        std::fill(strategy_sums, strategy_sums + num_actions_, 0.0);
+    }
+}
+
+void DiscountedCfrTrainable::SetHandState(size_t hand, const double* regrets, const double* strategy_sums) {
+    const size_t offset = hand * num_actions_;
+    std::copy(regrets, regrets + num_actions_, cumulative_regrets_ + offset);
+    if (!cumulative_strategy_sum_ &&
+        std::any_of(strategy_sums, strategy_sums + num_actions_, [](double value) { return value != 0.0; })) {
+        EnsureStrategySums();
+    }
+    if (cumulative_strategy_sum_) {
+        std::copy(strategy_sums, strategy_sums + num_actions_, cumulative_strategy_sum_ + offset);
+    }
+    current_strategy_valid_ = false;
+    average_strategy_valid_ = false;
+}
+
 void DiscountedCfrTrainable::SetEv(const std::vector<double>& evs) {
     size_t total_size = num_actions_ * num_hands_;
     if (evs.size() != total_size) { throw std::invalid_argument("EV vector size mismatch in SetEv."); }
@@ -292,18 +409,35 @@ json DiscountedCfrTrainable::DumpEvs() const {
      result["evs"] = ev_map; return result;
 }
 
+std::vector<double> DiscountedCfrTrainable::GetEvs() const {
+    return expected_values_;
+}
+
 
 void DiscountedCfrTrainable::CopyStateFrom(const Trainable& other) {
-    // Implementation remains the same (copies whole vectors)
     const auto* other_dcfr_ptr = dynamic_cast<const DiscountedCfrTrainable*>(&other);
     if (!other_dcfr_ptr) { throw std::invalid_argument("Cannot copy state: 'other' is not a DiscountedCfrTrainable."); }
     const DiscountedCfrTrainable& other_dcfr = *other_dcfr_ptr;
     if (num_actions_ != other_dcfr.num_actions_ || num_hands_ != other_dcfr.num_hands_) { throw std::invalid_argument("Cannot copy state: Dimensions mismatch."); }
-    this->cumulative_regrets_ = other_dcfr.cumulative_regrets_;
-    this->cumulative_strategy_sum_ = other_dcfr.cumulative_strategy_sum_;
-    this->current_strategy_ = other_dcfr.current_strategy_;
+    size_t total_size = num_actions_ * num_hands_;
+    // The current strategy is copied too when both sides keep it.
+    if (total_size > 0) {
+        std::copy(other_dcfr.cumulative_regrets_, other_dcfr.cumulative_regrets_ + total_size,
+                  this->cumulative_regrets_);
+        if (other_dcfr.cumulative_strategy_sum_) {
+            EnsureStrategySums();
+            std::copy(other_dcfr.cumulative_strategy_sum_, other_dcfr.cumulative_strategy_sum_ + total_size,
+                      this->cumulative_strategy_sum_);
+        } else if (this->cumulative_strategy_sum_) {
+            std::fill(this->cumulative_strategy_sum_, this->cumulative_strategy_sum_ + total_size, 0.0);
+        }
+        if (this->current_strategy_ && other_dcfr.current_strategy_) {
+            std::copy(other_dcfr.current_strategy_, other_dcfr.current_strategy_ + total_size,
+                      this->current_strategy_);
+        }
+    }
     this->average_strategy_ = other_dcfr.average_strategy_;
-    this->current_strategy_valid_ = other_dcfr.current_strategy_valid_;
+    this->current_strategy_valid_ = other_dcfr.current_strategy_valid_ && other_dcfr.current_strategy_;
     this->average_strategy_valid_ = other_dcfr.average_strategy_valid_;
     this->expected_values_ = other_dcfr.expected_values_;
 }
@@ -0,0 +1,94 @@
+#include "trainable/LockedTrainable.h"
+#include "nodes/ActionNode.h"             // Need full definition for constructor
+#include "nodes/GameActions.h"            // For dumping action strings
+#include "ranges/PrivateCards.h"          // For PrivateCards info
+
+#include <json.hpp>
+#include <vector>
+#include <stdexcept> // For exceptions
+#include <limits>    // For numeric_limits
+#include <algorithm> // For std::copy
+#include <utility>   // For std::move
+
+// Use aliases
+using json = nlohmann::json;
+namespace core = poker_solver::core;
+namespace nodes = poker_solver::nodes;
+
+namespace poker_solver {
+namespace solver {
+
+LockedTrainable::LockedTrainable(const std::vector<core::PrivateCards>* player_range,
+                                 const nodes::ActionNode& action_node,
+                                 std::shared_ptr<const std::vector<double>> strategy)
+    : action_node_(action_node),
+      player_range_(player_range),
+      strategy_(std::move(strategy)) {
+    if (!player_range_) {
+        throw std::invalid_argument("LockedTrainable: Player range pointer cannot be null.");
+    }
+    if (!strategy_) {
+        throw std::invalid_argument("LockedTrainable: Strategy cannot be null.");
+    }
+    num_actions_ = action_node_.GetActions().size();
+    num_hands_ = player_range_->size();
+    if (strategy_->size() != num_actions_ * num_hands_) {
+        throw std::invalid_argument("LockedTrainable: Strategy size does not match actions * hands.");
+    }
+}
+
+void LockedTrainable::GetHandState(size_t hand, double* regrets, double* strategy_sums) const {
+    const double* row = strategy_->data() + hand * num_actions_;
+    std::fill(regrets, regrets + num_actions_, 0.0);
+    std::copy(row, row + num_actions_, strategy_sums);
+}
+
+void LockedTrainable::SetEv(const std::vector<double>& evs) {
+    if (evs.size() != num_actions_ * num_hands_) {
+        throw std::invalid_argument("EV vector size mismatch in SetEv.");
+    }
+    expected_values_ = evs;
+}
+
+json LockedTrainable::HandMap(const std::vector<double>& values) const {
+    json map = json::object();
+    for (size_t h = 0; h < num_hands_; ++h) {
+        std::vector<double> row(num_actions_, std::numeric_limits<double>::quiet_NaN());
+        if (!values.empty()) {
+            std::copy(values.begin() + h * num_actions_, values.begin() + (h + 1) * num_actions_, row.begin());
+        }
+        map[(*player_range_)[h].ToString()] = row;
+    }
+    return map;
+}
+
+json LockedTrainable::DumpStrategy(bool with_ev) const {
+    json result = json::object();
+    if (num_hands_ == 0) { result["warning"] = "Player range is empty"; }
+    std::vector<std::string> action_strings;
+    for (const auto& action : action_node_.GetActions()) { action_strings.push_back(action.ToString()); }
+    result["actions"] = action_strings;
+    result["strategy"] = HandMap(*strategy_);
+    if (with_ev) { result["evs"] = HandMap(expected_values_); }
+    return result;
+}
+
+json LockedTrainable::DumpEvs() const {
+    json result = json::object();
+    if (num_hands_ == 0) { result["warning"] = "Player range is empty"; }
+    std::vector<std::string> action_strings;
+    for (const auto& action : action_node_.GetActions()) { action_strings.push_back(action.ToString()); }
+    result["actions"] = action_strings;
+    result["evs"] = HandMap(expected_values_);
+    return result;
+}
+
+void LockedTrainable::CopyStateFrom(const Trainable& other) {
+    const auto* other_ptr = dynamic_cast<const LockedTrainable*>(&other);
+    if (!other_ptr) { throw std::invalid_argument("Cannot copy state: 'other' is not a LockedTrainable."); }
+    if (num_actions_ != other_ptr->num_actions_ || num_hands_ != other_ptr->num_hands_) { throw std::invalid_argument("Cannot copy state: Dimensions mismatch."); }
+    expected_values_ = other_ptr->expected_values_;
+}
+
+} // namespace solver
+} // namespace poker_solver
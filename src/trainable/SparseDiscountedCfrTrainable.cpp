@@ -0,0 +1,374 @@
+#include "trainable/SparseDiscountedCfrTrainable.h"
+#include "nodes/ActionNode.h"  // Need full definition for constructor
+#include "nodes/GameActions.h" // For dumping action strings
+#include "tools/BinaryIo.h"    // For checkpoint I/O
+
+#include <algorithm> // For std::lower_bound, std::fill
+#include <limits>    // For numeric_limits
+#include <stdexcept> // For exceptions
+#include <string>
+#include <utility>   // For std::move
+
+namespace poker_solver {
+namespace solver {
+
+namespace {
+
+// Buffers returned by Get*Strategy (see the class comment).
+thread_local std::vector<double> tls_current_strategy;
+thread_local std::vector<double> tls_average_strategy;
+
+bool AnyNonZero(const double* values, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (values[i] != 0.0) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+SparseDiscountedCfrTrainable::SparseDiscountedCfrTrainable(
+    const std::vector<core::PrivateCards>* player_range,
+    const nodes::ActionNode& action_node,
+    std::vector<uint32_t> live_hands,
+    bool lazy_strategies)
+    : action_node_(action_node),
+      player_range_(player_range),
+      lazy_strategies_(lazy_strategies),
+      live_hands_(std::move(live_hands)) {
+
+    if (!player_range_) {
+        throw std::invalid_argument("SparseDiscountedCfrTrainable: Player range pointer cannot be null.");
+    }
+    num_actions_ = action_node_.GetActions().size();
+    num_hands_ = player_range_->size();
+    slot_of_hand_.assign(num_hands_, kNotLive);
+    for (size_t i = 0; i < live_hands_.size(); ++i) {
+        if (live_hands_[i] >= num_hands_ || (i > 0 && live_hands_[i] <= live_hands_[i - 1])) {
+            throw std::invalid_argument("SparseDiscountedCfrTrainable: live hands must be ascending range indices.");
+        }
+        slot_of_hand_[live_hands_[i]] = static_cast<uint32_t>(i);
+    }
+
+    const size_t table_size = live_hands_.size() * num_actions_;
+    cumulative_regrets_.assign(table_size, 0.0);
+    cumulative_strategy_sum_.assign(table_size, 0.0);
+    if (!lazy_strategies_ && num_actions_ > 0) {
+        current_strategy_.assign(table_size, 1.0 / static_cast<double>(num_actions_));
+    }
+}
+
+uint32_t SparseDiscountedCfrTrainable::MakeLive(size_t hand) {
+    const auto position = std::lower_bound(live_hands_.begin(), live_hands_.end(), static_cast<uint32_t>(hand));
+    const size_t slot = static_cast<size_t>(position - live_hands_.begin());
+    live_hands_.insert(position, static_cast<uint32_t>(hand));
+    const auto row = static_cast<std::ptrdiff_t>(slot * num_actions_);
+    cumulative_regrets_.insert(cumulative_regrets_.begin() + row, num_actions_, 0.0);
+    cumulative_strategy_sum_.insert(cumulative_strategy_sum_.begin() + row, num_actions_, 0.0);
+    if (!lazy_strategies_) {
+        current_strategy_.insert(current_strategy_.begin() + row, num_actions_,
+                                 1.0 / static_cast<double>(num_actions_));
+    }
+    for (size_t i = slot; i < live_hands_.size(); ++i) slot_of_hand_[live_hands_[i]] = static_cast<uint32_t>(i);
+    return static_cast<uint32_t>(slot);
+}
+
+void SparseDiscountedCfrTrainable::RegretMatchRows(double* out) const {
+    const double default_prob = 1.0 / static_cast<double>(num_actions_);
+    for (size_t i = 0; i < live_hands_.size(); ++i) {
+        const double* regrets = cumulative_regrets_.data() + i * num_actions_;
+        double regret_sum = 0.0;
+        for (size_t a = 0; a < num_actions_; ++a) regret_sum += std::max(0.0, regrets[a]);
+        for (size_t a = 0; a < num_actions_; ++a) {
+            out[i * num_actions_ + a] = (regret_sum > 1e-12) ? std::max(0.0, regrets[a]) / regret_sum : default_prob;
+        }
+    }
+}
+
+// --- Strategies ---
+
+const double* SparseDiscountedCfrTrainable::CurrentStrategy(double* scratch) const {
+    if (num_actions_ == 0) return scratch;
+    std::fill(scratch, scratch + num_actions_ * num_hands_, 1.0 / static_cast<double>(num_actions_));
+    if (lazy_strategies_) {
+        const double default_prob = 1.0 / static_cast<double>(num_actions_);
+        for (size_t i = 0; i < live_hands_.size(); ++i) {
+            const double* regrets = cumulative_regrets_.data() + i * num_actions_;
+            double* out = scratch + live_hands_[i] * num_actions_;
+            double regret_sum = 0.0;
+            for (size_t a = 0; a < num_actions_; ++a) regret_sum += std::max(0.0, regrets[a]);
+            for (size_t a = 0; a < num_actions_; ++a) {
+                out[a] = (regret_sum > 1e-12) ? std::max(0.0, regrets[a]) / regret_sum : default_prob;
+            }
+        }
+        return scratch;
+    }
+    for (size_t i = 0; i < live_hands_.size(); ++i) {
+        std::copy(current_strategy_.begin() + i * num_actions_, current_strategy_.begin() + (i + 1) * num_actions_,
+                  scratch + live_hands_[i] * num_actions_);
+    }
+    return scratch;
+}
+
+const std::vector<double>& SparseDiscountedCfrTrainable::GetCurrentStrategy() const {
+    tls_current_strategy.resize(num_actions_ * num_hands_);
+    CurrentStrategy(tls_current_strategy.data());
+    return tls_current_strategy;
+}
+
+const std::vector<double>& SparseDiscountedCfrTrainable::GetAverageStrategy() const {
+    tls_average_strategy.resize(num_actions_ * num_hands_);
+    if (num_actions_ == 0) return tls_average_strategy;
+    const double default_prob = 1.0 / static_cast<double>(num_actions_);
+    std::fill(tls_average_strategy.begin(), tls_average_strategy.end(), default_prob);
+    for (size_t i = 0; i < live_hands_.size(); ++i) {
+        const double* sums = cumulative_strategy_sum_.data() + i * num_actions_;
+        double* out = tls_average_strategy.data() + live_hands_[i] * num_actions_;
+        double total = 0.0;
+        for (size_t a = 0; a < num_actions_; ++a) total += sums[a];
+        for (size_t a = 0; a < num_actions_; ++a) out[a] = (total > 1e-12) ? sums[a] / total : default_prob;
+    }
+    return tls_average_strategy;
+}
+
+// --- Updates ---
+
+void SparseDiscountedCfrTrainable::UpdateRegrets(const std::vector<double>& weighted_regrets, int iteration,
+                                                 double /*reach_prob_opponent_chance_scalar*/) {
+    if (weighted_regrets.size() != num_actions_ * num_hands_) {
+        throw std::invalid_argument("Regret vector size mismatch in UpdateRegrets.");
+    }
+    if (iteration <= 0) {
+        throw std::invalid_argument("Iteration number must be positive in UpdateRegrets.");
+    }
+    const IterationDiscounts discounts = IterationDiscounts::For(iteration);
+    for (size_t i = 0; i < live_hands_.size(); ++i) {
+        const double* incoming = weighted_regrets.data() + live_hands_[i] * num_actions_;
+        double* regrets = cumulative_regrets_.data() + i * num_actions_;
+        for (size_t a = 0; a < num_actions_; ++a) {
+            double discount = regrets[a] > 0 ? discounts.positive_regret : discounts.negative_regret;
+            regrets[a] = regrets[a] * discount + incoming[a];
+        }
+    }
+    if (!lazy_strategies_) RegretMatchRows(current_strategy_.data());
+}
+
+void SparseDiscountedCfrTrainable::AccumulateAverageStrategy(const std::vector<double>& current_strategy,
+                                                             int iteration,
+                                                             const std::vector<double>& reach_probs_player_chance_vector) {
+    if (current_strategy.size() != num_actions_ * num_hands_ ||
+        reach_probs_player_chance_vector.size() != num_hands_) {
+        throw std::invalid_argument("Size mismatch in AccumulateAverageStrategy.");
+    }
+    if (iteration <= 0) {
+        throw std::invalid_argument("Iteration number must be positive in AccumulateAverageStrategy.");
+    }
+    const double gamma_discount_factor = IterationDiscounts::For(iteration).strategy_weight;
+    for (size_t h = 0; h < num_hands_; ++h) {
+        const double weight = std::max(0.0, reach_probs_player_chance_vector[h]) * gamma_discount_factor;
+        if (weight < 1e-12) continue;
+        uint32_t slot = slot_of_hand_[h];
+        if (slot == kNotLive) slot = MakeLive(h);
+        double* sums = cumulative_strategy_sum_.data() + slot * num_actions_;
+        for (size_t a = 0; a < num_actions_; ++a) sums[a] += weight * current_strategy[h * num_actions_ + a];
+    }
+}
+
+void SparseDiscountedCfrTrainable::UpdateFromVisit(const double* weighted_regrets,
+                                                   const double* current_strategy,
+                                                   const double* reach_weights,
+                                                   const IterationDiscounts& discounts) {
+    if (discounts.iteration <= 0) {
+        throw std::invalid_argument("Iteration number must be positive in UpdateFromVisit.");
+    }
+    if (num_actions_ == 0 || num_hands_ == 0) return;
+
+    // Hands reaching the node for the first time join before the update.
+    if (live_hands_.size() < num_hands_) {
+        for (size_t h = 0; h < num_hands_; ++h) {
+            if (reach_weights[h] > 0.0 && slot_of_hand_[h] == kNotLive) MakeLive(h);
+        }
+    }
+
+    const double alpha_discount = discounts.positive_regret;
+    const double beta_discount = discounts.negative_regret;
+    const double gamma_discount_factor = discounts.strategy_weight;
+    const double default_prob = 1.0 / static_cast<double>(num_actions_);
+    for (size_t i = 0; i < live_hands_.size(); ++i) {
+        const size_t hand_row = live_hands_[i] * num_actions_;
+        const size_t row = i * num_actions_;
+        double final_weight_for_hand = std::max(0.0, reach_weights[live_hands_[i]]) * gamma_discount_factor;
+        if (final_weight_for_hand >= 1e-12) {
+            for (size_t a = 0; a < num_actions_; ++a) {
+                cumulative_strategy_sum_[row + a] += final_weight_for_hand * current_strategy[hand_row + a];
+            }
+        }
+
+        double regret_sum = 0.0;
+        for (size_t a = 0; a < num_actions_; ++a) {
+            double current_cum_regret = cumulative_regrets_[row + a];
+            double discount_factor = (current_cum_regret > 0) ? alpha_discount : beta_discount;
+            cumulative_regrets_[row + a] = current_cum_regret * discount_factor + weighted_regrets[hand_row + a];
+            regret_sum += std::max(0.0, cumulative_regrets_[row + a]);
+        }
+        if (lazy_strategies_) continue; // Regret-matched on the next visit
+        for (size_t a = 0; a < num_actions_; ++a) {
+            current_strategy_[row + a] = (regret_sum > 1e-12)
+                ? std::max(0.0, cumulative_regrets_[row + a]) / regret_sum : default_prob;
+        }
+    }
+}
+
+// --- Checkpointing and warm starts ---
+
+void SparseDiscountedCfrTrainable::WriteState(std::ostream& out) const {
+    std::vector<double> dense(num_actions_ * num_hands_);
+    for (const std::vector<double>* table : {&cumulative_regrets_, &cumulative_strategy_sum_}) {
+        std::fill(dense.begin(), dense.end(), 0.0);
+        for (size_t i = 0; i < live_hands_.size(); ++i) {
+            std::copy(table->begin() + i * num_actions_, table->begin() + (i + 1) * num_actions_,
+                      dense.begin() + live_hands_[i] * num_actions_);
+        }
+        utils::WriteRaw(out, dense.data(), dense.size());
+    }
+}
+
+void SparseDiscountedCfrTrainable::ReadState(std::istream& in) {
+    const size_t table_size = num_actions_ * num_hands_;
+    std::vector<double> dense(2 * table_size);
+    utils::ReadRaw(in, dense.data(), dense.size());
+    // Live hands are the rows with any value.
+    live_hands_.clear();
+    cumulative_regrets_.clear();
+    cumulative_strategy_sum_.clear();
+    std::fill(slot_of_hand_.begin(), slot_of_hand_.end(), kNotLive);
+    for (size_t h = 0; h < num_hands_; ++h) {
+        const double* regrets = dense.data() + h * num_actions_;
+        const double* sums = regrets + table_size;
+        if (!AnyNonZero(regrets, num_actions_) && !AnyNonZero(sums, num_actions_)) continue;
+        slot_of_hand_[h] = static_cast<uint32_t>(live_hands_.size());
+        live_hands_.push_back(static_cast<uint32_t>(h));
+        cumulative_regrets_.insert(cumulative_regrets_.end(), regrets, regrets + num_actions_);
+        cumulative_strategy_sum_.insert(cumulative_strategy_sum_.end(), sums, sums + num_actions_);
+    }
+    if (!lazy_strategies_) {
+        current_strategy_.resize(cumulative_regrets_.size());
+        RegretMatchRows(current_strategy_.data());
+    }
+}
+
+void SparseDiscountedCfrTrainable::GetHandState(size_t hand, double* regrets, double* strategy_sums) const {
+    const uint32_t slot = slot_of_hand_[hand];
+    if (slot == kNotLive) {
+        std::fill(regrets, regrets + num_actions_, 0.0);
+        std::fill(strategy_sums, strategy_sums + num_actions_, 0.0);
+        return;
+    }
+    const size_t row = slot * num_actions_;
+    std::copy(cumulative_regrets_.begin() + row, cumulative_regrets_.begin() + row + num_actions_, regrets);
+    std::copy(cumulative_strategy_sum_.begin() + row, cumulative_strategy_sum_.begin() + row + num_actions_,
+              strategy_sums);
+}
+
+void SparseDiscountedCfrTrainable::SetHandState(size_t hand, const double* regrets, const double* strategy_sums) {
+    uint32_t slot = slot_of_hand_[hand];
+    if (slot == kNotLive) {
+        if (!AnyNonZero(regrets, num_actions_) && !AnyNonZero(strategy_sums, num_actions_)) return;
+        slot = MakeLive(hand);
+    }
+    const size_t row = slot * num_actions_;
+    std::copy(regrets, regrets + num_actions_, cumulative_regrets_.begin() + row);
+    std::copy(strategy_sums, strategy_sums + num_actions_, cumulative_strategy_sum_.begin() + row);
+    if (lazy_strategies_) return;
+    const double default_prob = 1.0 / static_cast<double>(num_actions_);
+    double regret_sum = 0.0;
+    for (size_t a = 0; a < num_actions_; ++a) regret_sum += std::max(0.0, regrets[a]);
+    for (size_t a = 0; a < num_actions_; ++a) {
+        current_strategy_[row + a] = (regret_sum > 1e-12) ? std::max(0.0, regrets[a]) / regret_sum : default_prob;
+    }
+}
+
+uint64_t SparseDiscountedCfrTrainable::TableBytes() const {
+    return (cumulative_regrets_.capacity() + cumulative_strategy_sum_.capacity() + current_strategy_.capacity()) *
+               sizeof(double) +
+           (live_hands_.capacity() + slot_of_hand_.capacity()) * sizeof(uint32_t);
+}
+
+// --- EVs and dumps ---
+
+void SparseDiscountedCfrTrainable::SetEv(const std::vector<double>& evs) {
+    if (evs.size() != num_actions_ * num_hands_) {
+        throw std::invalid_argument("EV vector size mismatch in SetEv.");
+    }
+    expected_values_ = evs;
+}
+
+json SparseDiscountedCfrTrainable::DumpStrategy(bool with_ev) const {
+    json result = json::object(); json strategy_map = json::object(); json ev_map = json::object();
+    const std::vector<double>& avg_strategy = GetAverageStrategy();
+    if (num_hands_ == 0) { result["warning"] = "Player range is empty"; }
+    std::vector<std::string> action_strings; action_strings.reserve(num_actions_);
+    for (const auto& action : action_node_.GetActions()) { action_strings.push_back(action.ToString()); }
+    result["actions"] = action_strings;
+
+    for (size_t h = 0; h < num_hands_; ++h) {
+        const std::string hand_str = (*player_range_)[h].ToString();
+        std::vector<double> hand_avg_strategy(avg_strategy.begin() + h * num_actions_,
+                                              avg_strategy.begin() + (h + 1) * num_actions_);
+        strategy_map[hand_str] = hand_avg_strategy;
+        if (with_ev) {
+            std::vector<double> hand_evs(num_actions_, std::numeric_limits<double>::quiet_NaN());
+            if (!expected_values_.empty()) {
+                std::copy(expected_values_.begin() + h * num_actions_, expected_values_.begin() + (h + 1) * num_actions_,
+                          hand_evs.begin());
+            }
+            ev_map[hand_str] = hand_evs;
+        }
+    }
+    result["strategy"] = strategy_map; if (with_ev) { result["evs"] = ev_map; } return result;
+}
+
+json SparseDiscountedCfrTrainable::DumpEvs() const {
+    json result = json::object(); json ev_map = json::object();
+    if (num_hands_ == 0) { result["warning"] = "Player range is empty"; }
+    std::vector<std::string> action_strings; action_strings.reserve(num_actions_);
+    for (const auto& action : action_node_.GetActions()) { action_strings.push_back(action.ToString()); }
+    result["actions"] = action_strings;
+    for (size_t h = 0; h < num_hands_; ++h) {
+        std::vector<double> hand_evs(num_actions_, std::numeric_limits<double>::quiet_NaN());
+        if (!expected_values_.empty()) {
+            std::copy(expected_values_.begin() + h * num_actions_, expected_values_.begin() + (h + 1) * num_actions_,
+                      hand_evs.begin());
+        }
+        ev_map[(*player_range_)[h].ToString()] = hand_evs;
+    }
+    result["evs"] = ev_map; return result;
+}
+
+std::vector<double> SparseDiscountedCfrTrainable::GetEvs() const {
+    return expected_values_;
+}
+
+void SparseDiscountedCfrTrainable::CopyStateFrom(const Trainable& other) {
+    const auto* other_sparse = dynamic_cast<const SparseDiscountedCfrTrainable*>(&other);
+    if (!other_sparse) {
+        throw std::invalid_argument("Cannot copy state: 'other' is not a SparseDiscountedCfrTrainable.");
+    }
+    if (num_actions_ != other_sparse->num_actions_ || num_hands_ != other_sparse->num_hands_) {
+        throw std::invalid_argument("Cannot copy state: Dimensions mismatch.");
+    }
+    live_hands_ = other_sparse->live_hands_;
+    slot_of_hand_ = other_sparse->slot_of_hand_;
+    cumulative_regrets_ = other_sparse->cumulative_regrets_;
+    cumulative_strategy_sum_ = other_sparse->cumulative_strategy_sum_;
+    if (lazy_strategies_) {
+        current_strategy_.clear();
+    } else {
+        current_strategy_.resize(cumulative_regrets_.size());
+        RegretMatchRows(current_strategy_.data());
+    }
+    expected_values_ = other_sparse->expected_values_;
+}
+
+} // namespace solver
+} // namespace poker_solver
@@ -0,0 +1,176 @@
+#include "trainable/TrainableArena.h"
+
+#include <algorithm> // For std::max
+#include <cstdlib>   // For std::aligned_alloc, std::free
+#include <iostream>  // For std::cerr
+#include <new>       // For std::bad_alloc
+#include <stdexcept> // For std::runtime_error
+#include <string>    // For std::to_string
+
+#ifdef __linux__
+#include <cerrno>     // For errno
+#include <cstring>    // For std::strerror
+#include <fcntl.h>    // For O_CLOEXEC, posix_fallocate
+#include <sys/mman.h> // For madvise, mmap
+#include <unistd.h>   // For ftruncate, unlink, close
+#endif
+
+namespace poker_solver {
+namespace solver {
+
+namespace {
+
+constexpr size_t kCacheLineBytes = 64;
+constexpr size_t kHugePageBytes = size_t{2} << 20;
+constexpr size_t kDoublesPerCacheLine = kCacheLineBytes / sizeof(double);
+
+thread_local size_t tls_lane = 0;
+
+size_t RoundUp(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+} // namespace
+
+TrainableArena::TrainableArena(size_t capacity_hint, bool huge_pages, size_t lanes)
+    : huge_pages_(huge_pages), lanes_(std::max<size_t>(lanes, 1)) {
+    if (capacity_hint == 0) return;
+    const size_t lane_hint = (capacity_hint + lanes_.size() - 1) / lanes_.size();
+    try {
+        for (std::vector<Slab>& lane : lanes_) AddSlab(lane, lane_hint);
+    } catch (const std::bad_alloc&) {
+        // Too much address space for the OS; grow slab by slab instead.
+        std::cerr << "[WARN] TrainableArena: could not reserve " << capacity_hint
+                  << " doubles up front, allocating on demand." << std::endl;
+    }
+}
+
+TrainableArena::TrainableArena(size_t capacity_hint, const FileBacking& file, size_t lanes)
+    : huge_pages_(false), sequential_access_(file.sequential_access), lanes_(std::max<size_t>(lanes, 1)) {
+#ifdef __linux__
+    std::string path = (file.directory.empty() ? std::string(".") : file.directory) +
+                       "/poker_solver_trainables_XXXXXX";
+    file_ = mkostemp(&path[0], O_CLOEXEC);
+    if (file_ < 0) {
+        throw std::runtime_error("TrainableArena: cannot create a backing file in '" + file.directory +
+                                 "': " + std::strerror(errno));
+    }
+    unlink(path.c_str());
+#else
+    throw std::runtime_error("TrainableArena: file-backed arenas need mmap, which this platform lacks.");
+#endif
+    if (capacity_hint == 0) return;
+    const size_t lane_hint = (capacity_hint + lanes_.size() - 1) / lanes_.size();
+    try {
+        for (std::vector<Slab>& lane : lanes_) AddSlab(lane, lane_hint);
+    } catch (const std::exception& e) {
+        std::cerr << "[WARN] TrainableArena: could not map " << capacity_hint
+                  << " doubles up front (" << e.what() << "), mapping on demand." << std::endl;
+    }
+}
+
+TrainableArena::~TrainableArena() {
+    for (const std::vector<Slab>& lane : lanes_) {
+        for (const Slab& slab : lane) {
+#ifdef __linux__
+            if (file_ >= 0) {
+                munmap(slab.data, slab.capacity * sizeof(double));
+                continue;
+            }
+#endif
+            std::free(slab.data);
+        }
+    }
+#ifdef __linux__
+    if (file_ >= 0) close(file_);
+#endif
+}
+
+void TrainableArena::SetThreadLane(size_t lane) {
+    tls_lane = lane;
+}
+
+void TrainableArena::AddSlab(std::vector<Slab>& lane, size_t min_doubles) {
+    if (file_ >= 0) {
+        size_t bytes = RoundUp(min_doubles * sizeof(double), kHugePageBytes);
+        lane.push_back({static_cast<double*>(MapFileSlab(bytes)), bytes / sizeof(double), 0});
+        return;
+    }
+    size_t alignment = huge_pages_ ? kHugePageBytes : kCacheLineBytes;
+    size_t bytes = RoundUp(min_doubles * sizeof(double), alignment);
+    void* memory = std::aligned_alloc(alignment, bytes);
+    if (!memory) throw std::bad_alloc();
+#ifdef __linux__
+    if (huge_pages_) madvise(memory, bytes, MADV_HUGEPAGE); // Advisory; failure is harmless
+#endif
+    lane.push_back({static_cast<double*>(memory), bytes / sizeof(double), 0});
+}
+
+void* TrainableArena::MapFileSlab(size_t bytes) {
+#ifdef __linux__
+    // Grow the file with its blocks allocated, so a full disk fails here
+    // rather than as SIGBUS on the first write to the mapping, then map the
+    // new tail; 2 MiB multiples keep every offset page aligned.
+    int error;
+    do {
+        error = posix_fallocate(file_, static_cast<off_t>(file_bytes_), static_cast<off_t>(bytes));
+    } while (error == EINTR);
+    if (error != 0) {
+        if (ftruncate(file_, static_cast<off_t>(file_bytes_)) != 0) { /* The tail stays unused */ }
+        throw std::runtime_error("TrainableArena: cannot grow the backing file by " + std::to_string(bytes) +
+                                 " bytes: " + std::strerror(error));
+    }
+    void* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, file_, static_cast<off_t>(file_bytes_));
+    if (memory == MAP_FAILED) {
+        if (ftruncate(file_, static_cast<off_t>(file_bytes_)) != 0) { /* The tail stays unused */ }
+        throw std::bad_alloc();
+    }
+    file_bytes_ += bytes;
+    madvise(memory, bytes, sequential_access_ ? MADV_SEQUENTIAL : MADV_NORMAL); // Advisory
+    return memory;
+#else
+    (void)bytes;
+    throw std::bad_alloc();
+#endif
+}
+
+double* TrainableArena::Allocate(size_t count) {
+    // Keep every block cache-line aligned.
+    size_t rounded = RoundUp(std::max<size_t>(count, 1), kDoublesPerCacheLine);
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<Slab>& lane = lanes_[tls_lane < lanes_.size() ? tls_lane : 0];
+    if (lane.empty() || lane.back().capacity - lane.back().used < rounded) {
+        AddSlab(lane, std::max(rounded, kDefaultSlabDoubles));
+    }
+    Slab& slab = lane.back();
+    double* block = slab.data + slab.used;
+    slab.used += rounded;
+    allocated_doubles_ += rounded;
+    return block;
+}
+
+size_t TrainableArena::AllocatedDoubles() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return allocated_doubles_;
+}
+
+size_t TrainableArena::ReservedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t bytes = 0;
+    for (const std::vector<Slab>& lane : lanes_) {
+        for (const Slab& slab : lane) bytes += slab.capacity * sizeof(double);
+    }
+    return bytes;
+}
+
+std::vector<std::pair<const double*, size_t>> TrainableArena::Regions() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::pair<const double*, size_t>> regions;
+    for (const std::vector<Slab>& lane : lanes_) {
+        for (const Slab& slab : lane) regions.emplace_back(slab.data, slab.used);
+    }
+    return regions;
+}
+
+} // namespace solver
+} // namespace poker_solver
@@ -180,3 +180,19 @@ TEST(ActionNodeMultiDeal, Constructor) {
     EXPECT_NO_THROW(node_multi_deal.GetTrainableIfExists(num_deals - 1)); // Index 4 is in bounds
     EXPECT_EQ(node_multi_deal.GetTrainableIfExists(num_deals - 1), nullptr); // Should be null initially
 }
+
+// Test resizing the per-deal storage: slots are independent and lazily filled
+TEST_F(ActionNodeTest, SetNumPossibleDeals) {
+    auto first = action_node_->GetTrainable(0);
+    ASSERT_NO_THROW(action_node_->SetNumPossibleDeals(48));
+    EXPECT_EQ(action_node_->GetNumPossibleDeals(), 48u);
+    EXPECT_EQ(action_node_->GetTrainableIfExists(0), first); // Existing slot kept
+    EXPECT_EQ(action_node_->GetTrainableIfExists(47), nullptr);
+
+    auto last = action_node_->GetTrainable(47);
+    ASSERT_NE(last, nullptr);
+    EXPECT_NE(last, first);
+    EXPECT_EQ(action_node_->GetTrainableIfExists(1), nullptr); // Untouched deals stay empty
+    EXPECT_THROW(action_node_->GetTrainable(48), std::out_of_range);
+    EXPECT_THROW(action_node_->SetNumPossibleDeals(0), std::invalid_argument);
+}
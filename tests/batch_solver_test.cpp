@@ -0,0 +1,131 @@
+#include "gtest/gtest.h"
+#include "solver/BatchSolver.h"
+#include "solver/PCfrSolver.h"
+#include "toy_compairer.h"
+#include "ranges/PrivateCardsManager.h"
+#include "ranges/RiverRangeManager.h"
+#include "tools/PrivateRangeConverter.h"
+#include "tools/ScenarioFile.h"
+#include "tools/Rule.h"
+#include "tools/GameTreeBuildingSettings.h"
+#include "tools/StreetSetting.h"
+#include "GameTree.h"
+#include "Deck.h"
+#include "Card.h"
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace poker_solver::core;
+using namespace poker_solver::config;
+using namespace poker_solver::ranges;
+using namespace poker_solver::solver;
+using namespace poker_solver::tree;
+
+// Small turn spots; spots built with the same ranges share a river cache.
+class BatchSolverTest : public ::testing::Test {
+ protected:
+  Deck deck_;
+  StreetSetting setting_{{50.0}, {100.0}, {}, true};
+  GameTreeBuildingSettings build_settings_{setting_, setting_, setting_,
+                                           setting_, setting_, setting_};
+  std::vector<int> board_ = {Card::StringToInt("Ac").value(), Card::StringToInt("Kd").value(),
+                             Card::StringToInt("5h").value(), Card::StringToInt("9s").value()};
+  std::shared_ptr<Compairer> compairer_ = std::make_shared<test_support::ToyCompairer>();
+
+  BatchSpot MakeSpot(double commitment, const std::string& ip_range, const std::string& oop_range) const {
+      Scenario scenario{"spot", "",
+                        Rule(deck_, commitment, commitment, GameRound::kTurn, board_, 1, 0.5, 1.0, 50.0,
+                             build_settings_),
+                        {ip_range, oop_range}};
+      BatchSpot spot{scenario, PCfrSolver::Config()};
+      spot.config.iteration_limit = 5;
+      return spot;
+  }
+
+  // The same spot solved on its own, without the batch driver.
+  nlohmann::json SolveAlone(const BatchSpot& spot) const {
+      std::vector<std::vector<PrivateCards>> player_ranges;
+      for (const std::string& range : spot.scenario.ranges) {
+          player_ranges.push_back(PrivateRangeConverter::StringToPrivateCards(range, board_));
+      }
+      auto pcm = std::make_shared<PrivateCardsManager>(std::move(player_ranges), Card::CardIntsToUint64(board_));
+      PCfrSolver::Config config = spot.config;
+      config.num_threads = 1;
+      PCfrSolver solver(std::make_shared<GameTree>(spot.scenario.rule), pcm,
+                        std::make_shared<RiverRangeManager>(compairer_), spot.scenario.rule, config);
+      solver.Train();
+      return solver.DumpStrategy(false);
+  }
+};
+
+TEST_F(BatchSolverTest, SharesRiverCachesAndMatchesSeparateSolves) {
+    std::vector<BatchSpot> spots = {MakeSpot(10.0, "QQ,JJ,AQs", "TT,KQs"),
+                                    MakeSpot(20.0, "QQ,JJ,AQs", "TT,KQs"),
+                                    MakeSpot(10.0, "QQ,88", "TT,KQs")};
+    BatchSolver::Options options;
+    options.num_threads = 1; // Spots in input order, so the reuse flags are fixed
+    BatchSolver batch(compairer_, options);
+    std::vector<nlohmann::json> dumps(spots.size());
+    std::vector<BatchSpotResult> results =
+        batch.Solve(spots, [&](size_t i, PCfrSolver& solver) { dumps[i] = solver.DumpStrategy(false); });
+
+    ASSERT_EQ(results.size(), spots.size());
+    for (size_t i = 0; i < spots.size(); ++i) {
+        EXPECT_TRUE(results[i].solved) << results[i].error;
+        EXPECT_EQ(results[i].iterations, 5);
+        EXPECT_EQ(results[i].threads, 1);
+        EXPECT_GT(results[i].estimated_bytes, 0u);
+        EXPECT_GT(results[i].memory_bytes, 0u);
+        EXPECT_EQ(dumps[i], SolveAlone(spots[i])) << "spot " << i;
+    }
+    EXPECT_FALSE(results[0].reused_river_cache);
+    EXPECT_TRUE(results[1].reused_river_cache);
+    EXPECT_FALSE(results[2].reused_river_cache);
+}
+
+TEST_F(BatchSolverTest, SmallSpotsRunSideBySideAndLargeOnesOnAllThreads) {
+    std::vector<BatchSpot> spots(4, MakeSpot(10.0, "QQ,JJ,AQs", "TT,KQs"));
+    BatchSolver::Options options;
+    options.num_threads = 3;
+    std::vector<BatchSpotResult> results = BatchSolver(compairer_, options).Solve(spots);
+    int reused = 0;
+    for (const BatchSpotResult& result : results) {
+        EXPECT_TRUE(result.solved) << result.error;
+        EXPECT_EQ(result.threads, 1);
+        reused += result.reused_river_cache ? 1 : 0;
+    }
+    EXPECT_EQ(reused, 3);
+
+    options.small_spot_bytes = 0;
+    results = BatchSolver(compairer_, options).Solve(spots);
+    for (const BatchSpotResult& result : results) {
+        EXPECT_TRUE(result.solved) << result.error;
+        EXPECT_EQ(result.threads, 3);
+    }
+}
+
+TEST_F(BatchSolverTest, FailedSpotsDoNotStopTheBatch) {
+    std::vector<BatchSpot> spots = {MakeSpot(10.0, "QQ,JJ", "TT"), MakeSpot(10.0, "not a range", "TT"),
+                                    MakeSpot(10.0, "QQ", "TT")};
+    BatchSolver batch(compairer_);
+    std::vector<BatchSpotResult> results = batch.Solve(spots, [](size_t i, PCfrSolver&) {
+        if (i == 2) throw std::runtime_error("cannot write output");
+    });
+    EXPECT_TRUE(results[0].solved);
+    EXPECT_FALSE(results[1].solved);
+    EXPECT_FALSE(results[1].error.empty());
+    EXPECT_FALSE(results[2].solved);
+    EXPECT_EQ(results[2].error, "cannot write output");
+
+    BatchSolver::Options options;
+    options.memory_limit = 1;
+    results = BatchSolver(compairer_, options).Solve({spots[0]});
+    EXPECT_FALSE(results[0].solved);
+    EXPECT_NE(results[0].error.find("byte limit"), std::string::npos);
+}
+
+TEST(BatchSolverConstructorTest, RejectsNullCompairer) {
+    EXPECT_THROW(BatchSolver(nullptr), std::invalid_argument);
+}
@@ -175,3 +175,21 @@ TEST_F(CardTest, StaticRankSuitHelpers) {
     EXPECT_EQ(Card::SuitIndexToChar(4), '?');
 }
 
+
+TEST_F(CardTest, MaskPrimitives) {
+    static_assert(CountCards(0x13ULL) == 3, "CountCards is a constant expression");
+    static_assert(LowestCard(0x18ULL) == 3, "LowestCard is a constant expression");
+    static_assert(Card::CardIntToUint64(51) == 1ULL << 51, "CardIntToUint64 is a constant expression");
+    static_assert(Card::DoBoardsOverlap(0x6ULL, 0x2ULL), "DoBoardsOverlap is a constant expression");
+
+    const uint64_t mask = (1ULL << 0) | (1ULL << 17) | (1ULL << 51);
+    EXPECT_EQ(CountCards(mask), 3);
+    EXPECT_EQ(LowestCard(mask), 0);
+    std::vector<int> visited;
+    ForEachCard(mask, [&](int card) { visited.push_back(card); });
+    EXPECT_EQ(visited, Card::Uint64ToCardInts(mask));
+    int cards[3];
+    ASSERT_EQ(CardMaskToInts(mask, cards), 3);
+    EXPECT_EQ(std::vector<int>(cards, cards + 3), visited);
+    EXPECT_EQ(CardMaskToInts(0, cards), 0);
+}
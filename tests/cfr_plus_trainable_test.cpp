@@ -0,0 +1,90 @@
+#include "gtest/gtest.h"
+#include "trainable/CFRPlus.h"
+#include "nodes/ActionNode.h"
+#include "nodes/TerminalNode.h"
+#include "nodes/GameActions.h"
+#include "nodes/GameTreeNode.h"
+#include "ranges/PrivateCards.h"
+#include "Card.h"
+#include <vector>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+// Use namespaces
+using namespace poker_solver::core;
+using namespace poker_solver::nodes;
+using namespace poker_solver::solver;
+
+// Regret matching+ and linear averaging on a two-hand, two-action node.
+class CfrPlusTrainableTest : public ::testing::Test {
+ protected:
+  std::vector<PrivateCards> player_range_;
+  std::shared_ptr<ActionNode> action_node_;
+
+  void SetUp() override {
+      player_range_.emplace_back(Card::StringToInt("Ac").value(), Card::StringToInt("Kc").value());
+      player_range_.emplace_back(Card::StringToInt("Ad").value(), Card::StringToInt("Kd").value());
+      action_node_ = std::make_shared<ActionNode>(
+          0, GameRound::kRiver, 10.0, std::weak_ptr<GameTreeNode>(), 1);
+      auto terminal = std::make_shared<TerminalNode>(std::vector<double>{0.0, 0.0}, GameRound::kRiver, 10.0,
+                                                     std::weak_ptr<GameTreeNode>(action_node_));
+      action_node_->AddChild(GameAction(PokerAction::kCheck), terminal);
+      action_node_->AddChild(GameAction(PokerAction::kBet, 5.0), terminal);
+      action_node_->SetPlayerRange(&player_range_);
+  }
+};
+
+TEST_F(CfrPlusTrainableTest, RegretsAreFlooredAtZero) {
+    CfrPlusTrainableSF trainable(&player_range_, *action_node_);
+    // Hand 0 prefers action 1, hand 1 regrets both.
+    trainable.UpdateRegrets({-4.0, 2.0, -1.0, -3.0}, 1, 1.0);
+    EXPECT_EQ(trainable.GetCurrentStrategy(), (std::vector<double>{0.0, 1.0, 0.5, 0.5}));
+
+    // Plain CFR would still have -4 for hand 0 action 0; CFR+ restarts from 0.
+    trainable.UpdateRegrets({3.0, 1.0, 1.0, 0.0}, 2, 1.0);
+    EXPECT_EQ(trainable.GetCurrentStrategy(), (std::vector<double>{0.5, 0.5, 1.0, 0.0}));
+}
+
+TEST_F(CfrPlusTrainableTest, AverageIsWeightedByIteration) {
+    CfrPlusTrainableSF trainable(&player_range_, *action_node_);
+    std::vector<double> reach = {1.0, 0.0};
+    trainable.AccumulateAverageStrategy({1.0, 0.0, 0.3, 0.7}, 1, reach);
+    trainable.AccumulateAverageStrategy({0.0, 1.0, 0.3, 0.7}, 3, reach);
+    const std::vector<double>& average = trainable.GetAverageStrategy();
+    EXPECT_NEAR(average[0], 0.25, 1e-7);
+    EXPECT_NEAR(average[1], 0.75, 1e-7);
+    EXPECT_DOUBLE_EQ(average[2], 0.5); // Never reached: uniform
+
+    // The fused update takes the weight from the discounts.
+    CfrPlusTrainableSF fused(&player_range_, *action_node_);
+    std::vector<double> no_regret(4, 0.0);
+    std::vector<double> first = {1.0, 0.0, 0.3, 0.7};
+    std::vector<double> second = {0.0, 1.0, 0.3, 0.7};
+    DcfrParameters linear;
+    linear.gamma = 1.0;
+    fused.UpdateFromVisit(no_regret.data(), first.data(), reach.data(), IterationDiscounts::For(1, linear));
+    fused.UpdateFromVisit(no_regret.data(), second.data(), reach.data(), IterationDiscounts::For(3, linear));
+    EXPECT_EQ(fused.GetAverageStrategy(), trainable.GetAverageStrategy());
+}
+
+TEST_F(CfrPlusTrainableTest, CopyStateAndMemory) {
+    CfrPlusTrainableSF source(&player_range_, *action_node_);
+    CfrPlusTrainableSF target(&player_range_, *action_node_);
+    CfrPlusTrainableHF half(&player_range_, *action_node_);
+    source.UpdateRegrets({1.0, 2.0, 3.0, 0.0}, 1, 1.0);
+    ASSERT_NO_THROW(target.CopyStateFrom(source));
+    std::vector<double> source_current = source.GetCurrentStrategy();
+    EXPECT_EQ(target.GetCurrentStrategy(), source_current);
+    EXPECT_THROW(target.CopyStateFrom(half), std::invalid_argument);
+
+    EXPECT_EQ(source.MemoryBytes(), 2 * 4 * sizeof(float));
+    // 16-bit values plus one float scale per hand row.
+    EXPECT_EQ(half.MemoryBytes(), 2 * (4 * sizeof(int16_t) + 2 * sizeof(float)));
+}
+
+TEST_F(CfrPlusTrainableTest, ActionNodeCreatesCfrPlus) {
+    auto trainable = action_node_->GetTrainable(0, ActionNode::TrainablePrecision::kFloat,
+                                                ActionNode::TrainableAlgorithm::kCfrPlus);
+    EXPECT_NE(std::dynamic_pointer_cast<CfrPlusTrainableSF>(trainable), nullptr);
+}
@@ -0,0 +1,177 @@
+#include "gtest/gtest.h"
+#include "trainable/CompactDiscountedCfrTrainable.h"
+#include "trainable/DiscountedCfrTrainable.h"
+#include "nodes/ActionNode.h"
+#include "nodes/TerminalNode.h"
+#include "nodes/GameActions.h"
+#include "nodes/GameTreeNode.h"
+#include "ranges/PrivateCards.h"
+#include "Card.h"
+#include <vector>
+#include <memory>
+#include <random>
+#include <stdexcept>
+
+// Use namespaces
+using namespace poker_solver::core;
+using namespace poker_solver::nodes;
+using namespace poker_solver::solver;
+
+// Runs the same DCFR updates through the double, single and 16-bit
+// trainables and checks the reduced-precision strategies stay close.
+class CompactTrainableTest : public ::testing::Test {
+ protected:
+  std::vector<PrivateCards> player_range_;
+  std::shared_ptr<ActionNode> action_node_;
+  const size_t kNumActions = 3;
+
+  void SetUp() override {
+      for (int c = 0; c + 1 < 20; c += 2) {
+          player_range_.emplace_back(c, c + 1);
+      }
+      action_node_ = std::make_shared<ActionNode>(
+          0, GameRound::kRiver, 10.0, std::weak_ptr<GameTreeNode>(), 1);
+      auto terminal = std::make_shared<TerminalNode>(std::vector<double>{0.0, 0.0}, GameRound::kRiver, 10.0,
+                                                     std::weak_ptr<GameTreeNode>(action_node_));
+      action_node_->AddChild(GameAction(PokerAction::kCheck), terminal);
+      action_node_->AddChild(GameAction(PokerAction::kBet, 5.0), terminal);
+      action_node_->AddChild(GameAction(PokerAction::kBet, 10.0), terminal);
+      action_node_->SetPlayerRange(&player_range_);
+  }
+
+  // Applies 'iterations' rounds of random regrets/reach to each trainable.
+  void Train(std::vector<Trainable*> trainables, int iterations) {
+      std::mt19937 rng(7);
+      std::uniform_real_distribution<double> regret_dist(-5.0, 5.0);
+      std::uniform_real_distribution<double> reach_dist(0.0, 1.0);
+      size_t num_hands = player_range_.size();
+      for (int t = 1; t <= iterations; ++t) {
+          std::vector<double> regrets(num_hands * kNumActions);
+          std::vector<double> reach(num_hands);
+          for (auto& r : regrets) r = regret_dist(rng);
+          for (auto& r : reach) r = reach_dist(rng);
+          // Strategy from the double reference so all see identical inputs.
+          std::vector<double> strategy = trainables[0]->GetCurrentStrategy();
+          for (auto* trainable : trainables) {
+              trainable->UpdateRegrets(regrets, t, 1.0);
+              trainable->AccumulateAverageStrategy(strategy, t, reach);
+          }
+      }
+  }
+
+  // Drives 'separate' through UpdateRegrets/AccumulateAverageStrategy and
+  // 'fused' through CurrentStrategy/UpdateFromVisit with the same random
+  // visits, each playing its own current strategy, and expects identical state.
+  void ExpectFusedMatchesSeparate(Trainable& separate, Trainable& fused, int iterations) {
+      std::mt19937 rng(11);
+      std::uniform_real_distribution<double> regret_dist(-5.0, 5.0);
+      std::uniform_real_distribution<double> reach_dist(0.0, 1.0);
+      size_t num_hands = player_range_.size();
+      std::vector<double> scratch(num_hands * kNumActions);
+      for (int t = 1; t <= iterations; ++t) {
+          std::vector<double> regrets(num_hands * kNumActions);
+          std::vector<double> reach(num_hands);
+          for (auto& r : regrets) r = regret_dist(rng);
+          for (auto& r : reach) r = reach_dist(rng);
+          reach[0] = 0.0; // A hand that never reaches the node
+
+          std::vector<double> strategy = separate.GetCurrentStrategy();
+          separate.UpdateRegrets(regrets, t, 1.0);
+          separate.AccumulateAverageStrategy(strategy, t, reach);
+
+          const double* played = fused.CurrentStrategy(scratch.data());
+          ASSERT_EQ(std::vector<double>(played, played + strategy.size()), strategy);
+          fused.UpdateFromVisit(regrets.data(), played, reach.data(), IterationDiscounts::For(t));
+      }
+      std::vector<double> separate_current = separate.GetCurrentStrategy();
+      EXPECT_EQ(fused.GetCurrentStrategy(), separate_current);
+      std::vector<double> separate_average = separate.GetAverageStrategy();
+      EXPECT_EQ(fused.GetAverageStrategy(), separate_average);
+  }
+};
+
+// --- Tests ---
+
+TEST_F(CompactTrainableTest, InitialStrategyIsUniform) {
+    DiscountedCfrTrainableSF sf(&player_range_, *action_node_);
+    DiscountedCfrTrainableHF hf(&player_range_, *action_node_);
+    for (double p : sf.GetCurrentStrategy()) EXPECT_DOUBLE_EQ(p, 1.0 / 3.0);
+    for (double p : hf.GetAverageStrategy()) EXPECT_DOUBLE_EQ(p, 1.0 / 3.0);
+}
+
+TEST_F(CompactTrainableTest, MatchesDoublePrecision) {
+    DiscountedCfrTrainable reference(&player_range_, *action_node_);
+    DiscountedCfrTrainableSF sf(&player_range_, *action_node_);
+    DiscountedCfrTrainableHF hf(&player_range_, *action_node_);
+    Train({&reference, &sf, &hf}, 50);
+
+    std::vector<double> ref_current = reference.GetCurrentStrategy();
+    std::vector<double> ref_average = reference.GetAverageStrategy();
+    std::vector<double> sf_current = sf.GetCurrentStrategy();
+    std::vector<double> sf_average = sf.GetAverageStrategy();
+    std::vector<double> hf_current = hf.GetCurrentStrategy();
+    std::vector<double> hf_average = hf.GetAverageStrategy();
+    ASSERT_EQ(sf_current.size(), ref_current.size());
+    ASSERT_EQ(hf_average.size(), ref_average.size());
+    for (size_t i = 0; i < ref_current.size(); ++i) {
+        EXPECT_NEAR(sf_current[i], ref_current[i], 1e-5);
+        EXPECT_NEAR(sf_average[i], ref_average[i], 1e-5);
+        EXPECT_NEAR(hf_current[i], ref_current[i], 2e-3);
+        EXPECT_NEAR(hf_average[i], ref_average[i], 2e-3);
+    }
+}
+
+TEST_F(CompactTrainableTest, MemoryIsSmaller) {
+    DiscountedCfrTrainableSF sf(&player_range_, *action_node_);
+    DiscountedCfrTrainableHF hf(&player_range_, *action_node_);
+    size_t entries = player_range_.size() * kNumActions;
+    EXPECT_EQ(sf.MemoryBytes(), 2 * entries * sizeof(float));
+    EXPECT_LT(hf.MemoryBytes(), sf.MemoryBytes());
+    sf.SetEv(std::vector<double>(entries, 1.0));
+    EXPECT_EQ(sf.MemoryBytes(), 3 * entries * sizeof(float));
+}
+
+TEST_F(CompactTrainableTest, CopyStateAndDump) {
+    DiscountedCfrTrainableHF a(&player_range_, *action_node_);
+    DiscountedCfrTrainableHF b(&player_range_, *action_node_);
+    DiscountedCfrTrainableSF other(&player_range_, *action_node_);
+    Train({&a}, 5);
+    ASSERT_NO_THROW(b.CopyStateFrom(a));
+    std::vector<double> a_avg = a.GetAverageStrategy();
+    std::vector<double> b_avg = b.GetAverageStrategy();
+    EXPECT_EQ(a_avg, b_avg);
+    EXPECT_THROW(b.CopyStateFrom(other), std::invalid_argument);
+
+    json dump = a.DumpStrategy(true);
+    ASSERT_TRUE(dump.contains("strategy"));
+    ASSERT_TRUE(dump.contains("evs"));
+    EXPECT_EQ(dump["strategy"].size(), player_range_.size());
+    EXPECT_EQ(dump["actions"].size(), kNumActions);
+}
+
+TEST_F(CompactTrainableTest, FusedUpdateMatchesSeparateCalls) {
+    DiscountedCfrTrainable reference_separate(&player_range_, *action_node_);
+    DiscountedCfrTrainable reference_fused(&player_range_, *action_node_);
+    ExpectFusedMatchesSeparate(reference_separate, reference_fused, 30);
+
+    DiscountedCfrTrainableSF sf_separate(&player_range_, *action_node_);
+    DiscountedCfrTrainableSF sf_fused(&player_range_, *action_node_);
+    ExpectFusedMatchesSeparate(sf_separate, sf_fused, 30);
+
+    DiscountedCfrTrainableHF hf_separate(&player_range_, *action_node_);
+    DiscountedCfrTrainableHF hf_fused(&player_range_, *action_node_);
+    ExpectFusedMatchesSeparate(hf_separate, hf_fused, 30);
+}
+
+TEST_F(CompactTrainableTest, ActionNodeCreatesRequestedPrecision) {
+    auto single = action_node_->GetTrainable(0, ActionNode::TrainablePrecision::kSingle);
+    EXPECT_NE(std::dynamic_pointer_cast<DiscountedCfrTrainableSF>(single), nullptr);
+
+    auto half_node = std::make_shared<ActionNode>(0, GameRound::kRiver, 10.0, std::weak_ptr<GameTreeNode>(), 1);
+    auto terminal = std::make_shared<TerminalNode>(std::vector<double>{0.0, 0.0}, GameRound::kRiver, 10.0,
+                                                   std::weak_ptr<GameTreeNode>(half_node));
+    half_node->AddChild(GameAction(PokerAction::kCheck), terminal);
+    half_node->SetPlayerRange(&player_range_);
+    auto half = half_node->GetTrainable(0, ActionNode::TrainablePrecision::kHalf);
+    EXPECT_NE(std::dynamic_pointer_cast<DiscountedCfrTrainableHF>(half), nullptr);
+}
@@ -0,0 +1,72 @@
+#include "gtest/gtest.h"
+#include "tools/Compression.h"
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace poker_solver::utils;
+
+namespace {
+
+std::vector<uint8_t> RoundTrip(const std::vector<uint8_t>& data, size_t* compressed_size = nullptr) {
+    std::vector<uint8_t> compressed;
+    CompressBlock(data.data(), data.size(), compressed);
+    if (compressed_size) *compressed_size = compressed.size();
+    std::vector<uint8_t> decoded(data.size());
+    DecompressBlock(compressed.data(), compressed.size(), decoded.data(), decoded.size());
+    return decoded;
+}
+
+} // namespace
+
+TEST(CompressionTest, RoundTripsEdgeCases) {
+    EXPECT_EQ(RoundTrip({}), std::vector<uint8_t>());
+    EXPECT_EQ(RoundTrip({7}), std::vector<uint8_t>({7}));
+    EXPECT_EQ(RoundTrip({1, 2, 3, 4, 1, 2, 3, 4}), std::vector<uint8_t>({1, 2, 3, 4, 1, 2, 3, 4}));
+}
+
+TEST(CompressionTest, ShrinksRepetitiveDataAndKeepsRandomData) {
+    // Long runs and repeats: lengths past the 15 and 255 nibble/byte limits.
+    std::vector<uint8_t> repetitive(100000, 0);
+    for (size_t i = 0; i < repetitive.size(); ++i) repetitive[i] = static_cast<uint8_t>((i / 300) % 5);
+    size_t compressed_size = 0;
+    EXPECT_EQ(RoundTrip(repetitive, &compressed_size), repetitive);
+    EXPECT_LT(compressed_size, repetitive.size() / 20);
+
+    std::mt19937 random(5);
+    std::vector<uint8_t> noise(70000);
+    for (uint8_t& byte : noise) byte = static_cast<uint8_t>(random());
+    EXPECT_EQ(RoundTrip(noise, &compressed_size), noise);
+    EXPECT_LT(compressed_size, noise.size() + noise.size() / 200 + 16);
+}
+
+TEST(CompressionTest, RejectsCorruptBlocks) {
+    std::vector<uint8_t> data(1000);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<uint8_t>(i % 7);
+    std::vector<uint8_t> compressed;
+    CompressBlock(data.data(), data.size(), compressed);
+    std::vector<uint8_t> decoded(data.size());
+    EXPECT_THROW(DecompressBlock(compressed.data(), compressed.size(), decoded.data(), decoded.size() - 1),
+                 std::runtime_error);
+    EXPECT_THROW(DecompressBlock(compressed.data(), compressed.size() - 1, decoded.data(), decoded.size()),
+                 std::runtime_error);
+    const uint8_t far_match[] = {0x10, 'a', 0x09, 0x00}; // One literal, then offset 9
+    EXPECT_THROW(DecompressBlock(far_match, sizeof(far_match), decoded.data(), 5), std::runtime_error);
+}
+
+TEST(CompressionTest, ZigZagVarintsRoundTrip) {
+    std::vector<uint8_t> bytes;
+    const std::vector<int64_t> values = {0, -1, 1, -64, 64, 32767, -32768, INT64_MAX, INT64_MIN};
+    for (int64_t value : values) AppendVarint(ZigZagEncode(value), bytes);
+    EXPECT_EQ(bytes[0], 0);
+    EXPECT_EQ(bytes[1], 1);
+    EXPECT_EQ(bytes[2], 2);
+    const uint8_t* cursor = bytes.data();
+    for (int64_t value : values) EXPECT_EQ(ZigZagDecode(ReadVarint(cursor, bytes.data() + bytes.size())), value);
+    EXPECT_EQ(cursor, bytes.data() + bytes.size());
+
+    const uint8_t truncated[] = {0x80, 0x80};
+    cursor = truncated;
+    EXPECT_THROW(ReadVarint(cursor, truncated + sizeof(truncated)), std::runtime_error);
+}
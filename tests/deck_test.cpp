@@ -98,3 +98,17 @@ TEST_F(DeckTest, FindCardByString) {
   EXPECT_TRUE(c_empty_str.IsEmpty());
 }
 
+
+// The short deck keeps sixes to aces with their standard card integers.
+TEST_F(DeckTest, ShortDeckHoldsSixesToAces) {
+  Deck d = Deck::ShortDeck();
+  const auto& cards = d.GetCards();
+  ASSERT_EQ(cards.size(), static_cast<size_t>(kNumCardsInShortDeck));
+  EXPECT_EQ(cards.front().card_int().value(), kShortDeckLowestRank * kNumSuits);
+  EXPECT_EQ(cards.front().ToString(), "6c");
+  EXPECT_EQ(cards.back().ToString(), "As");
+  EXPECT_EQ(__builtin_popcountll(d.GetCardsMask()), kNumCardsInShortDeck);
+  EXPECT_EQ(Deck().GetCardsMask(), (1ULL << kNumCardsInDeck) - 1);
+  EXPECT_TRUE(d.FindCard("2c").IsEmpty());
+  EXPECT_FALSE(d.FindCard("6c").IsEmpty());
+}
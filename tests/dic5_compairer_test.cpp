@@ -7,6 +7,7 @@
 #include <stdexcept> // For std::exception
 #include <optional>  // Include optional for Card::StringToInt
 #include <sstream>   // Include for ostringstream in helper
+#include <random>    // For sampled hands
 
 // Use namespaces for convenience
 using namespace poker_solver::core;
@@ -165,6 +166,39 @@ TEST_F(Dic5CompairerTest, GetHandRankMasks) {
     EXPECT_EQ(compairer_->GetHandRank(private_overlap, public_rf), Dic5Compairer::kInvalidRank);
 }
 
+TEST_F(Dic5CompairerTest, RankRangeMatchesGetHandRank) {
+    ASSERT_NE(compairer_, nullptr);
+    uint64_t board = Card::CardIntsToUint64(StringsToInts({"Qh", "Jh", "Th", "2c", "2d"}));
+    std::vector<uint64_t> hands;
+    for (int c1 = 0; c1 < kNumCardsInDeck; c1 += 3) {
+        for (int c2 = c1 + 1; c2 < kNumCardsInDeck; c2 += 5) hands.push_back((1ULL << c1) | (1ULL << c2));
+    }
+    hands.push_back(Card::CardIntsToUint64(StringsToInts({"Ah", "Qh"}))); // Overlaps the board
+    std::vector<int> ranks(hands.size());
+    compairer_->RankRange(hands.data(), hands.size(), board, ranks.data());
+    for (size_t i = 0; i < hands.size(); ++i) {
+        EXPECT_EQ(ranks[i], compairer_->GetHandRank(hands[i], board)) << "hand 0x" << std::hex << hands[i];
+    }
+    EXPECT_EQ(ranks.back(), Dic5Compairer::kInvalidRank);
+}
+
+TEST_F(Dic5CompairerTest, GeneratedRanksMatchDictionary) {
+    ASSERT_NE(compairer_, nullptr);
+    Dic5Compairer generated; // No file involved
+    std::mt19937_64 rng(5);
+    std::uniform_int_distribution<int> card(0, kNumCardsInDeck - 1);
+    for (int i = 0; i < 30000; ++i) {
+        int num_cards = 5 + i % 3;
+        uint64_t mask = 0;
+        while (__builtin_popcountll(mask) < num_cards) mask |= 1ULL << card(rng);
+        std::vector<int> cards = Card::Uint64ToCardInts(mask);
+        ASSERT_EQ(generated.GetBestRankForCards(cards), compairer_->GetBestRankForCards(cards))
+            << "mask 0x" << std::hex << mask;
+    }
+    EXPECT_EQ(generated.GetBestRankForCards(StringsToInts({"Ah", "Kh", "Qh", "Jh", "Th"})), 1);
+    EXPECT_EQ(generated.GetBestRankForCards(StringsToInts({"7c", "5d", "4h", "3s", "2c"})), 7462);
+}
+
 TEST_F(Dic5CompairerTest, CompareHandsVectors) {
      ASSERT_NE(compairer_, nullptr);
     std::vector<int> p1_royal = StringsToInts({"Ah", "Kh"});
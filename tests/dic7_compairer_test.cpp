@@ -0,0 +1,168 @@
+#include "gtest/gtest.h"
+#include "compairer/Dic7Compairer.h"
+#include "compairer/Dic5Compairer.h"
+#include "Card.h"
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Use namespaces for convenience
+using namespace poker_solver::core;
+using namespace poker_solver::eval;
+
+// Dic7Compairer must rank exactly like Dic5Compairer. Both are built once
+// for the suite; loading the dictionary dominates the run time.
+class Dic7CompairerTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+      five_ = std::make_unique<Dic5Compairer>("five_card_strength.txt");
+      seven_ = std::make_unique<Dic7Compairer>(*five_);
+  }
+  void SetUp() override { ASSERT_NE(seven_, nullptr); }
+  static void TearDownTestSuite() {
+      seven_.reset();
+      five_.reset();
+  }
+
+  // Mask of 'num_cards' distinct random cards.
+  static uint64_t RandomMask(std::mt19937_64& rng, int num_cards) {
+      std::uniform_int_distribution<int> card(0, kNumCardsInDeck - 1);
+      uint64_t mask = 0;
+      while (__builtin_popcountll(mask) < num_cards) mask |= 1ULL << card(rng);
+      return mask;
+  }
+
+  static std::unique_ptr<Dic5Compairer> five_;
+  static std::unique_ptr<Dic7Compairer> seven_;
+};
+
+std::unique_ptr<Dic5Compairer> Dic7CompairerTest::five_;
+std::unique_ptr<Dic7Compairer> Dic7CompairerTest::seven_;
+
+TEST_F(Dic7CompairerTest, MatchesDic5OnRandomHands) {
+    std::mt19937_64 rng(7);
+    for (int num_cards = Dic7Compairer::kMinCards; num_cards <= Dic7Compairer::kMaxCards; ++num_cards) {
+        for (int i = 0; i < 20000; ++i) {
+            uint64_t mask = RandomMask(rng, num_cards);
+            ASSERT_EQ(seven_->RankOfMask(mask), five_->GetBestRankForCards(Card::Uint64ToCardInts(mask)))
+                << "mask 0x" << std::hex << mask;
+        }
+    }
+}
+
+TEST_F(Dic7CompairerTest, MatchesDic5OnFlushesAndStraights) {
+    // Every 7-card hand with at least 5 hearts on a fixed two-card remainder.
+    std::vector<int> hearts;
+    for (int rank = 0; rank < kNumRanks; ++rank) hearts.push_back(rank * kNumSuits + 2);
+    uint64_t extra = (1ULL << Card::StringToInt("Ac").value()) | (1ULL << Card::StringToInt("Kd").value());
+    for (uint32_t pattern = 0; pattern < (1u << kNumRanks); ++pattern) {
+        if (__builtin_popcount(pattern) != 5) continue;
+        uint64_t mask = extra;
+        for (int rank = 0; rank < kNumRanks; ++rank) {
+            if (pattern & (1u << rank)) mask |= 1ULL << hearts[rank];
+        }
+        ASSERT_EQ(seven_->RankOfMask(mask), five_->GetBestRankForCards(Card::Uint64ToCardInts(mask)))
+            << "mask 0x" << std::hex << mask;
+    }
+    std::vector<int> royal = {Card::StringToInt("Ah").value(), Card::StringToInt("Kh").value()};
+    std::vector<int> board = {Card::StringToInt("Qh").value(), Card::StringToInt("Jh").value(),
+                              Card::StringToInt("Th").value(), Card::StringToInt("2c").value(),
+                              Card::StringToInt("3d").value()};
+    EXPECT_EQ(seven_->GetHandRank(royal, board), 1);
+}
+
+TEST_F(Dic7CompairerTest, RankRangeMatchesGetHandRank) {
+    std::mt19937_64 rng(23);
+    for (int board_size = 3; board_size <= 5; ++board_size) {
+        for (int b = 0; b < 50; ++b) {
+            uint64_t board = RandomMask(rng, board_size);
+            std::vector<uint64_t> hands;
+            for (int i = 0; i < 100; ++i) hands.push_back(RandomMask(rng, 2));
+            std::vector<int> ranks(hands.size());
+            seven_->RankRange(hands.data(), hands.size(), board, ranks.data());
+            for (size_t i = 0; i < hands.size(); ++i) {
+                ASSERT_EQ(ranks[i], seven_->GetHandRank(hands[i], board))
+                    << "hand 0x" << std::hex << hands[i] << " board 0x" << board;
+            }
+        }
+    }
+}
+
+TEST_F(Dic7CompairerTest, InvalidInputsAndComparisons) {
+    std::mt19937_64 rng(11);
+    uint64_t board = RandomMask(rng, 5);
+    std::vector<int> board_cards = Card::Uint64ToCardInts(board);
+    uint64_t overlapping = 1ULL << board_cards[0];
+    EXPECT_EQ(seven_->GetHandRank(overlapping | (1ULL << 51), board), Dic7Compairer::kInvalidRank);
+    EXPECT_EQ(seven_->RankOfMask(0xFULL), Dic7Compairer::kInvalidRank);        // 4 cards
+    EXPECT_EQ(seven_->RankOfMask(0xFFULL), Dic7Compairer::kInvalidRank);       // 8 cards
+
+    for (int i = 0; i < 2000; ++i) {
+        uint64_t hands = RandomMask(rng, 4) & ~board;
+        std::vector<int> cards = Card::Uint64ToCardInts(hands);
+        if (cards.size() < 4) continue;
+        uint64_t hand1 = (1ULL << cards[0]) | (1ULL << cards[1]);
+        uint64_t hand2 = (1ULL << cards[2]) | (1ULL << cards[3]);
+        EXPECT_EQ(seven_->CompareHands(hand1, hand2, board), five_->CompareHands(hand1, hand2, board));
+    }
+}
+
+TEST_F(Dic7CompairerTest, TableFileIsMappedInPlace) {
+    std::string path = ::testing::TempDir() + "dic7_compairer_test.rank7";
+    seven_->WriteTableFile(path);
+    auto mapped = Dic7Compairer::FromTableFile(path);
+    EXPECT_FALSE(seven_->IsMapped());
+    EXPECT_TRUE(mapped->IsMapped());
+    EXPECT_EQ(mapped->MemoryBytes(), seven_->MemoryBytes());
+
+    std::mt19937_64 rng(5);
+    for (int i = 0; i < 20000; ++i) {
+        uint64_t mask = RandomMask(rng, Dic7Compairer::kMaxCards);
+        ASSERT_EQ(mapped->RankOfMask(mask), seven_->RankOfMask(mask));
+    }
+    mapped.reset();
+    std::remove(path.c_str());
+}
+
+TEST_F(Dic7CompairerTest, RejectsCorruptTableFiles) {
+    std::string path = ::testing::TempDir() + "dic7_compairer_corrupt_test.rank7";
+    seven_->WriteTableFile(path);
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    auto write = [&](const std::string& contents) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << contents;
+    };
+
+    std::string flipped = bytes;
+    flipped[bytes.size() / 2] ^= 1;
+    write(flipped);
+    EXPECT_THROW(Dic7Compairer::FromTableFile(path), std::runtime_error);
+    write(bytes.substr(0, bytes.size() - 4));
+    EXPECT_THROW(Dic7Compairer::FromTableFile(path), std::runtime_error);
+    std::string old_version = bytes;
+    old_version[8] = 0;
+    write(old_version);
+    EXPECT_THROW(Dic7Compairer::FromTableFile(path), std::runtime_error);
+    std::remove(path.c_str());
+    EXPECT_THROW(Dic7Compairer::FromTableFile(path), std::runtime_error);
+}
+
+TEST_F(Dic7CompairerTest, DictionaryConstructorReusesTableFile) {
+    std::remove("five_card_strength.rank7");
+    Dic7Compairer built("five_card_strength.txt");
+    EXPECT_FALSE(built.IsMapped());
+    Dic7Compairer mapped("five_card_strength.txt");
+    EXPECT_TRUE(mapped.IsMapped());
+    uint64_t mask = Card::CardIntsToUint64({0, 5, 10, 15, 20, 25, 30});
+    EXPECT_EQ(mapped.RankOfMask(mask), seven_->RankOfMask(mask));
+}
@@ -261,13 +261,66 @@ TEST_F(DiscountedCfrTrainableTest, CopyStateFromThrowsOnIncompatibleType) {
          const std::vector<double>& GetAverageStrategy() const override { static std::vector<double> v; return v;}
          void UpdateRegrets(const std::vector<double>&, int, double) override {}
          void AccumulateAverageStrategy(const std::vector<double>&, int, const std::vector<double>&) override {}
+         const double* CurrentStrategy(double* scratch) const override { return scratch; }
+         void UpdateFromVisit(const double*, const double*, const double*, const IterationDiscounts&) override {}
+         void WriteState(std::ostream&) const override {}
+         void ReadState(std::istream&) override {}
+         void GetHandState(size_t, double*, double*) const override {}
+         void SetHandState(size_t, const double*, const double*) override {}
          void SetEv(const std::vector<double>&) override {}
          json DumpStrategy(bool) const override { return nullptr; }
          json DumpEvs() const override { return nullptr; }
+         std::vector<double> GetEvs() const override { return {}; }
          void CopyStateFrom(const Trainable&) override {}
     };
     DummyTrainable incompatible_source;
 
     // ACT & ASSERT
     EXPECT_THROW(trainable_->CopyStateFrom(incompatible_source), std::invalid_argument);
-}
\ No newline at end of file
+}
+
+// Deferred strategy sums stay unallocated through visits that add nothing
+// to them, then follow the eager ones.
+TEST_F(DiscountedCfrTrainableTest, DeferredStrategySumsMatchEagerOnes) {
+    DiscountedCfrTrainable deferred(&player_range_, *action_node_, nullptr, false, true);
+    const std::vector<double> regrets = {1.0, -2.0, 0.5, 3.0};
+    const std::vector<double> reach = {0.4, 0.6};
+    std::vector<double> scratch(kTotalSize);
+    for (int t = 1; t <= 6; ++t) {
+        IterationDiscounts discounts = IterationDiscounts::For(t);
+        if (t <= 3) discounts.strategy_weight = 0.0; // Not averaging yet
+        for (Trainable* trainable : std::vector<Trainable*>{trainable_.get(), &deferred}) {
+            const double* played = trainable->CurrentStrategy(scratch.data());
+            trainable->UpdateFromVisit(regrets.data(), played, reach.data(), discounts);
+        }
+        if (t == 3) {
+            EXPECT_EQ(deferred.StrategySums(), nullptr);
+            std::vector<double> hand_regrets(kNumActions), hand_sums(kNumActions, 1.0);
+            deferred.GetHandState(0, hand_regrets.data(), hand_sums.data());
+            EXPECT_EQ(hand_sums, std::vector<double>(kNumActions, 0.0));
+            EXPECT_EQ(deferred.GetAverageStrategy(), std::vector<double>(kTotalSize, 0.5));
+        }
+    }
+    ASSERT_NE(deferred.StrategySums(), nullptr);
+    EXPECT_EQ(deferred.GetAverageStrategy(), trainable_->GetAverageStrategy());
+    EXPECT_EQ(deferred.GetCurrentStrategy(), trainable_->GetCurrentStrategy());
+}
+
+TEST(IterationDiscountsTest, ComputesDcfrFactors) {
+    IterationDiscounts discounts = IterationDiscounts::For(4);
+    EXPECT_EQ(discounts.iteration, 4);
+    EXPECT_DOUBLE_EQ(discounts.positive_regret, 8.0 / 9.0); // 4^1.5 = 8
+    EXPECT_DOUBLE_EQ(discounts.negative_regret, 2.0 / 3.0); // 4^0.5 = 2
+    EXPECT_DOUBLE_EQ(discounts.strategy_weight, 16.0);      // 4^2
+
+    DcfrParameters linear;
+    linear.alpha = 1.0;
+    linear.beta = 1.0;
+    linear.gamma = 1.0;
+    discounts = IterationDiscounts::For(4, linear);
+    EXPECT_DOUBLE_EQ(discounts.positive_regret, 0.8);
+    EXPECT_DOUBLE_EQ(discounts.negative_regret, 0.8);
+    EXPECT_DOUBLE_EQ(discounts.strategy_weight, 4.0);
+
+    EXPECT_THROW(IterationDiscounts::For(0), std::invalid_argument);
+}
@@ -0,0 +1,132 @@
+#include "gtest/gtest.h"
+#include "solver/EquityCalculator.h"
+#include "compairer/Dic5Compairer.h"
+#include "tools/PrivateRangeConverter.h"
+#include "ranges/PrivateCards.h"
+#include "Card.h"
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+using namespace poker_solver::core;
+using namespace poker_solver::eval;
+using namespace poker_solver::ranges;
+using namespace poker_solver::solver;
+
+namespace {
+
+std::vector<int> Board(const std::vector<std::string>& cards) {
+    std::vector<int> board;
+    for (const auto& card : cards) board.push_back(Card::StringToInt(card).value());
+    return board;
+}
+
+} // namespace
+
+class EquityCalculatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+      compairer_ = std::make_shared<Dic5Compairer>("five_card_strength.txt");
+  }
+
+  // Pairwise reference: every runout, every non-conflicting hand pair.
+  std::vector<double> ReferenceEquities(const std::vector<PrivateCards>& hero,
+                                        const std::vector<PrivateCards>& villain,
+                                        uint64_t board_mask) const {
+      std::vector<uint64_t> runouts = {board_mask};
+      while (__builtin_popcountll(runouts.front()) < 5) {
+          std::vector<uint64_t> next;
+          for (uint64_t board : runouts) {
+              int highest = 63 - __builtin_clzll(board & ~board_mask ? board & ~board_mask : 1ULL);
+              int first = (board & ~board_mask) ? highest + 1 : 0;
+              for (int card = first; card < kNumCardsInDeck; ++card) {
+                  if (!((board >> card) & 1ULL)) next.push_back(board | (1ULL << card));
+              }
+          }
+          runouts = std::move(next);
+      }
+      std::vector<double> won(hero.size(), 0.0), faced(hero.size(), 0.0), equity(hero.size(), 0.0);
+      for (uint64_t board : runouts) {
+          for (size_t i = 0; i < hero.size(); ++i) {
+              if (hero[i].GetBoardMask() & board) continue;
+              int hero_rank = compairer_->GetHandRank(hero[i].GetBoardMask(), board);
+              for (const auto& v : villain) {
+                  if (v.GetBoardMask() & (board | hero[i].GetBoardMask())) continue;
+                  int villain_rank = compairer_->GetHandRank(v.GetBoardMask(), board);
+                  faced[i] += v.Weight();
+                  if (hero_rank < villain_rank) won[i] += v.Weight();
+                  else if (hero_rank == villain_rank) won[i] += 0.5 * v.Weight();
+              }
+          }
+      }
+      for (size_t i = 0; i < hero.size(); ++i) {
+          if (faced[i] > 0.0) equity[i] = won[i] / faced[i];
+      }
+      return equity;
+  }
+
+  std::shared_ptr<Dic5Compairer> compairer_;
+};
+
+TEST_F(EquityCalculatorTest, MatchesPairwiseEnumerationOnTurnAndRiver) {
+    EquityCalculator calculator(compairer_);
+    for (const auto& board : {Board({"Ah", "Kd", "7c", "2s"}), Board({"Ah", "Kd", "7c", "2s", "9h"})}) {
+        auto hero = PrivateRangeConverter::StringToPrivateCards("AA,KK,AKs,QJs,T9o:0.5,76s");
+        auto villain = PrivateRangeConverter::StringToPrivateCards("QQ,JJ,AQo,KQs:0.7,98s,55,7c6c");
+        EquityResult result = calculator.Compute(hero, villain, board);
+        std::vector<double> expected = ReferenceEquities(hero, villain, Card::CardIntsToUint64(board));
+
+        EXPECT_EQ(result.num_runouts, board.size() == 4 ? 48u : 1u);
+        ASSERT_EQ(result.equities.size(), hero.size());
+        for (size_t i = 0; i < hero.size(); ++i) {
+            EXPECT_NEAR(result.equities[i], expected[i], 1e-9) << hero[i].ToString();
+        }
+        // Hands blocked by the board face nothing.
+        for (size_t i = 0; i < hero.size(); ++i) {
+            if (hero[i].GetBoardMask() & Card::CardIntsToUint64(board)) {
+                EXPECT_EQ(result.matchup_weights[i], 0.0);
+                EXPECT_EQ(result.equities[i], 0.0);
+            }
+        }
+    }
+}
+
+TEST_F(EquityCalculatorTest, SymmetricFlopRangesSplitEvenly) {
+    EquityCalculator calculator(compairer_);
+    auto range = PrivateRangeConverter::StringToPrivateCards(
+        "AA,KK,QQ,JJ,TT,99,88,AKs,AQs,AJs,KQs,KJs,QJs,JTs,T9s,98s,AKo,AQo,KQo:0.5");
+    EquityResult result = calculator.Compute(range, range, Board({"Qh", "8d", "3c"}));
+
+    EXPECT_EQ(result.num_runouts, 49u * 48u / 2u);
+    EXPECT_NEAR(result.range_equity, 0.5, 1e-9);
+    for (double equity : result.equities) {
+        EXPECT_GE(equity, 0.0);
+        EXPECT_LE(equity, 1.0);
+    }
+}
+
+TEST_F(EquityCalculatorTest, ThreadCountIndependent) {
+    EquityCalculator calculator(compairer_);
+    auto hero = PrivateRangeConverter::StringToPrivateCards("AA,KK,AKs,QJs,T9o:0.5,76s");
+    auto villain = PrivateRangeConverter::StringToPrivateCards("QQ,JJ,AQo,KQs,98s:0.7");
+    omp_set_num_threads(1);
+    const EquityResult expected = calculator.Compute(hero, villain, Board({"Ah", "Kd", "7c"}));
+    for (int threads : {2, 5}) {
+        omp_set_num_threads(threads);
+        const EquityResult result = calculator.Compute(hero, villain, Board({"Ah", "Kd", "7c"}));
+        EXPECT_EQ(result.equities, expected.equities) << threads << " threads";
+        EXPECT_EQ(result.range_equity, expected.range_equity) << threads << " threads";
+    }
+    omp_set_num_threads(1);
+}
+
+TEST_F(EquityCalculatorTest, InvalidInputs) {
+    EXPECT_THROW(EquityCalculator(nullptr), std::invalid_argument);
+    EquityCalculator calculator(compairer_);
+    auto range = PrivateRangeConverter::StringToPrivateCards("AA");
+    EXPECT_THROW(calculator.Compute(range, range, Board({"Ah", "Kd"})), std::invalid_argument);
+    EXPECT_THROW(calculator.Compute(range, range, Board({"Ah", "Kd", "Ah"})), std::invalid_argument);
+    EXPECT_THROW(calculator.Compute(range, range, {0, 1, 52}), std::invalid_argument);
+}
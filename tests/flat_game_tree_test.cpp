@@ -0,0 +1,140 @@
+#include "gtest/gtest.h"
+#include "FlatGameTree.h"
+#include "GameTree.h"
+#include "tools/Rule.h"
+#include "tools/GameTreeBuildingSettings.h"
+#include "tools/StreetSetting.h"
+#include "nodes/ActionNode.h"
+#include "nodes/ChanceNode.h"
+#include "nodes/ShowdownNode.h"
+#include "nodes/TerminalNode.h"
+#include "Deck.h"
+#include "Card.h"
+#include <array>
+#include <functional>
+#include <memory>
+#include <vector>
+
+using namespace poker_solver::core;
+using namespace poker_solver::config;
+using namespace poker_solver::nodes;
+using namespace poker_solver::tree;
+
+class FlatGameTreeTest : public ::testing::Test {
+ protected:
+  Deck deck_;
+  StreetSetting setting_{{50.0}, {100.0}, {}, true};
+  GameTreeBuildingSettings build_settings_{setting_, setting_, setting_, setting_, setting_, setting_};
+  std::unique_ptr<Rule> rule_;
+  std::unique_ptr<GameTree> game_tree_;
+
+  void SetUp() override {
+      std::vector<int> board = {Card::StringToInt("Ac").value(), Card::StringToInt("Kd").value(),
+                                Card::StringToInt("5h").value()};
+      rule_ = std::make_unique<Rule>(deck_, 5.0, 5.0, GameRound::kFlop, board, 3, 0.5, 1.0, 100.0,
+                                     build_settings_, 0.98);
+      game_tree_ = std::make_unique<GameTree>(*rule_);
+  }
+};
+
+// Node counts per type match the build statistics
+TEST_F(FlatGameTreeTest, CountsMatchBuildStats) {
+    FlatGameTree flat(*game_tree_);
+    const TreeBuildStats& stats = game_tree_->GetBuildStats();
+    EXPECT_EQ(flat.Count(GameTreeNodeType::kAction), stats.action_nodes);
+    EXPECT_EQ(flat.Count(GameTreeNodeType::kChance), stats.chance_nodes);
+    EXPECT_EQ(flat.Count(GameTreeNodeType::kShowdown), stats.showdown_nodes);
+    EXPECT_EQ(flat.Count(GameTreeNodeType::kTerminal), stats.terminal_nodes);
+    EXPECT_EQ(flat.Size(), stats.action_nodes + stats.chance_nodes + stats.showdown_nodes + stats.terminal_nodes);
+    EXPECT_EQ(flat.NumActionNodes(), stats.action_nodes);
+}
+
+// Walking both trees in lockstep visits the same nodes with the same data
+TEST_F(FlatGameTreeTest, MirrorsSourceTree) {
+    FlatGameTree flat(*game_tree_);
+    ASSERT_FALSE(flat.Empty());
+    std::function<void(const std::shared_ptr<GameTreeNode>&, uint32_t)> check =
+        [&](const std::shared_ptr<GameTreeNode>& source, uint32_t index) {
+        const FlatNode& node = flat.Node(index);
+        ASSERT_EQ(node.type, source->GetNodeType());
+        EXPECT_EQ(node.round, source->GetRound());
+        EXPECT_DOUBLE_EQ(node.pot, source->GetPot());
+        if (node.num_children > 0) {
+            EXPECT_GT(node.first_child, index);
+        }
+        switch (node.type) {
+            case GameTreeNodeType::kAction: {
+                auto action = std::static_pointer_cast<ActionNode>(source);
+                EXPECT_EQ(&flat.Action(node), action.get());
+                EXPECT_EQ(node.player, action->GetPlayerIndex());
+                ASSERT_EQ(node.num_children, action->GetChildren().size());
+                for (uint32_t a = 0; a < node.num_children; ++a) {
+                    check(action->GetChildren()[a], node.first_child + a);
+                }
+                break;
+            }
+            case GameTreeNodeType::kChance: {
+                auto chance = std::static_pointer_cast<ChanceNode>(source);
+                ASSERT_EQ(node.num_children, 1u);
+                check(chance->GetChild(), node.first_child);
+                break;
+            }
+            case GameTreeNodeType::kShowdown: {
+                auto showdown = std::static_pointer_cast<ShowdownNode>(source);
+                const double* payoffs = flat.ShowdownPayoffs(node);
+                EXPECT_EQ(payoffs[0], showdown->GetPayoffs(ComparisonResult::kPlayer1Wins)[0]);
+                EXPECT_EQ(payoffs[3], showdown->GetPayoffs(ComparisonResult::kPlayer2Wins)[1]);
+                EXPECT_EQ(payoffs[4], showdown->GetPayoffs(ComparisonResult::kTie)[0]);
+                EXPECT_EQ(node.num_children, 0u);
+                break;
+            }
+            case GameTreeNodeType::kTerminal: {
+                auto terminal = std::static_pointer_cast<TerminalNode>(source);
+                EXPECT_EQ(flat.TerminalPayoff(node, 0), terminal->GetPayoffs()[0]);
+                EXPECT_EQ(flat.TerminalPayoff(node, 1), terminal->GetPayoffs()[1]);
+                EXPECT_EQ(node.num_children, 0u);
+                break;
+            }
+        }
+    };
+    check(game_tree_->GetRoot(), 0);
+}
+
+// Chance nodes count the streets left to a showdown when no action comes between
+TEST_F(FlatGameTreeTest, MarksAllInRunouts) {
+    FlatGameTree flat(*game_tree_);
+    std::array<size_t, 3> counts = {0, 0, 0};
+    for (uint32_t i = 0; i < flat.Size(); ++i) {
+        const FlatNode& node = flat.Node(i);
+        if (node.type != GameTreeNodeType::kChance) {
+            EXPECT_EQ(node.runout_streets, 0u);
+            continue;
+        }
+        ASSERT_LE(node.runout_streets, 2u);
+        ++counts[node.runout_streets];
+        // Follow the chance nodes down to whatever comes next.
+        uint32_t index = i;
+        int streets = 0;
+        while (flat.Node(index).type == GameTreeNodeType::kChance) {
+            index = flat.Node(index).first_child;
+            ++streets;
+        }
+        if (flat.Node(index).type == GameTreeNodeType::kShowdown) {
+            EXPECT_EQ(node.runout_streets, streets);
+            EXPECT_EQ(node.round == GameRound::kTurn ? 2 : 1, streets);
+        } else {
+            EXPECT_EQ(node.runout_streets, 0u);
+        }
+    }
+    // All-ins on the flop and on the turn, and chance nodes followed by betting.
+    EXPECT_GT(counts[0], 0u);
+    EXPECT_GT(counts[1], 0u);
+    EXPECT_GT(counts[2], 0u);
+}
+
+// A null root flattens to an empty tree
+TEST(FlatGameTreeEmpty, NullRoot) {
+    FlatGameTree flat(std::shared_ptr<GameTreeNode>{});
+    EXPECT_TRUE(flat.Empty());
+    EXPECT_EQ(flat.Size(), 0u);
+}
@@ -0,0 +1,72 @@
+#include "gtest/gtest.h"
+#include "tools/FlatHashMap.h"
+#include "tools/lookup8.h"
+#include <cstdint>
+#include <map>
+#include <random>
+#include <stdexcept>
+
+using poker_solver::hashing::FlatHashMap;
+using poker_solver::hashing::HashWord;
+using poker_solver::hashing::lookup8_hash;
+
+TEST(FlatHashMapTest, HashWordIsLookup8OfTheKeyBytes) {
+    for (uint64_t key : {0ULL, 1ULL, 0x000F000000000001ULL, 0xFFFFFFFFFFFFFULL}) {
+        uint8_t bytes[8];
+        for (int i = 0; i < 8; ++i) bytes[i] = static_cast<uint8_t>(key >> (8 * i));
+        EXPECT_EQ(HashWord(key), lookup8_hash(bytes, 8));
+        EXPECT_EQ(HashWord(key, 7), lookup8_hash(bytes, 8, 7));
+    }
+}
+
+// Random inserts and erases of board-like keys, checked against std::map.
+TEST(FlatHashMapTest, MatchesStdMapUnderInsertAndErase) {
+    FlatHashMap<int> map;
+    std::map<uint64_t, int> expected;
+    std::mt19937_64 rng(5);
+    for (int step = 0; step < 20000; ++step) {
+        // Few distinct keys, so erases hit and probe runs wrap and shift.
+        const uint64_t key = (1ULL << (rng() % 52)) | (1ULL << (rng() % 52));
+        if (rng() % 3 == 0) {
+            EXPECT_EQ(map.erase(key), expected.erase(key) == 1);
+        } else {
+            const int value = static_cast<int>(rng() % 1000);
+            auto inserted = map.try_emplace(key, value);
+            auto reference = expected.emplace(key, value);
+            EXPECT_EQ(inserted.second, reference.second);
+            EXPECT_EQ(*inserted.first, reference.first->second);
+        }
+    }
+    ASSERT_EQ(map.size(), expected.size());
+    for (const auto& entry : expected) {
+        ASSERT_TRUE(map.contains(entry.first));
+        EXPECT_EQ(map.at(entry.first), entry.second);
+    }
+    size_t visited = 0;
+    for (const auto& entry : map) {
+        EXPECT_EQ(expected.at(entry.first), entry.second);
+        ++visited;
+    }
+    EXPECT_EQ(visited, expected.size());
+}
+
+TEST(FlatHashMapTest, EdgeCases) {
+    FlatHashMap<int> map;
+    EXPECT_EQ(map.find(0), nullptr);
+    EXPECT_FALSE(map.erase(0));
+    EXPECT_EQ(map.begin(), map.end());
+    map[0] = 3; // The empty board is an ordinary key
+    EXPECT_EQ(*map.find(0), 3);
+    EXPECT_THROW(map.try_emplace(FlatHashMap<int>::kEmptyKey, 1), std::invalid_argument);
+    EXPECT_THROW(map.at(1), std::out_of_range);
+
+    map.reserve(1000);
+    const size_t bytes = map.MemoryBytes();
+    for (uint64_t key = 1; key <= 1000; ++key) map[key] = static_cast<int>(key);
+    EXPECT_EQ(map.MemoryBytes(), bytes); // Reserved: no rehash
+    EXPECT_EQ(map.size(), 1001u);
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find(5), nullptr);
+    EXPECT_EQ(map.MemoryBytes(), bytes);
+}
@@ -16,6 +16,10 @@
 #include <stdexcept>
 #include <json.hpp>
 #include <cstdio> // For std::remove
+#include <functional>
+#include "ranges/PrivateCards.h"
+#include "trainable/CompactDiscountedCfrTrainable.h"
+#include <omp.h>
 
 
 // Use namespaces
@@ -182,6 +186,269 @@ TEST_F(GameTreeBuildTest, EstimateMemory) {
     EXPECT_GT(game_tree_->EstimateTrainableMemory(p0_range, p1_range), 0);
 }
 
+// Build statistics match a walk of the built tree, with the solver's deals
+TEST_F(GameTreeBuildTest, BuildStatsMatchTree) {
+    const TreeBuildStats& stats = game_tree_->GetBuildStats();
+    const uint64_t num_deal_cards = 52 - 3;
+    TreeBuildStats walked;
+    std::function<void(const std::shared_ptr<GameTreeNode>&, uint64_t, uint64_t, int)> walk =
+        [&](const std::shared_ptr<GameTreeNode>& node, uint64_t slots, uint64_t reachable, int dealt) {
+        if (auto action = std::dynamic_pointer_cast<ActionNode>(node)) {
+            ++walked.action_nodes;
+            walked.deal_slots += slots;
+            size_t num_actions = action->GetActions().size();
+            if (num_actions > 0) {
+                auto& per_actions = walked.trainables_by_actions[action->GetPlayerIndex()];
+                if (per_actions.size() <= num_actions) per_actions.resize(num_actions + 1, 0);
+                per_actions[num_actions] += reachable;
+            }
+            for (const auto& child : action->GetChildren()) walk(child, slots, reachable, dealt);
+        } else if (auto chance = std::dynamic_pointer_cast<ChanceNode>(node)) {
+            ++walked.chance_nodes;
+            walk(chance->GetChild(), slots * num_deal_cards, reachable * (num_deal_cards - dealt), dealt + 1);
+        } else if (std::dynamic_pointer_cast<ShowdownNode>(node)) {
+            ++walked.showdown_nodes;
+        } else if (std::dynamic_pointer_cast<TerminalNode>(node)) {
+            ++walked.terminal_nodes;
+        }
+    };
+    walk(game_tree_->GetRoot(), 1, 1, 0);
+
+    EXPECT_EQ(stats.action_nodes, walked.action_nodes);
+    EXPECT_EQ(stats.chance_nodes, walked.chance_nodes);
+    EXPECT_EQ(stats.showdown_nodes, walked.showdown_nodes);
+    EXPECT_EQ(stats.terminal_nodes, walked.terminal_nodes);
+    EXPECT_EQ(stats.deal_slots, walked.deal_slots);
+    EXPECT_EQ(stats.NumTrainables(), walked.NumTrainables());
+    EXPECT_EQ(static_cast<size_t>(game_tree_->GetRoot()->GetSubtreeSize()),
+              stats.action_nodes + stats.chance_nodes + stats.showdown_nodes + stats.terminal_nodes);
+
+    // Bytes scale with precision as the trainables do.
+    uint64_t double_bytes = game_tree_->EstimateTrainableMemory(100, 150);
+    uint64_t single_bytes = game_tree_->EstimateTrainableMemory(100, 150, ActionNode::TrainablePrecision::kSingle);
+    EXPECT_GT(double_bytes, single_bytes);
+    EXPECT_EQ(single_bytes, stats.TrainableBytes({100, 150}, ActionNode::TrainablePrecision::kSingle));
+}
+
+// Parallel builds give the same tree, stats and build-time metadata as serial ones
+TEST_F(GameTreeBuildTest, ParallelBuildMatchesSerial) {
+    StreetSetting wide{{33.0, 75.0, 150.0}, {60.0, 100.0}, {}, true};
+    GameTreeBuildingSettings wide_settings{wide, wide, wide, wide, wide, wide};
+    Rule rule(deck_, 5.0, 5.0, GameRound::kFlop, initial_flop_board_cards_, 3, 0.5, 1.0, 100.0, wide_settings, 0.98);
+
+    int saved_threads = omp_get_max_threads();
+    omp_set_num_threads(1);
+    GameTree serial(rule);
+    omp_set_num_threads(4);
+    GameTree parallel(rule);
+    omp_set_num_threads(saved_threads);
+
+    const TreeBuildStats& a = serial.GetBuildStats();
+    const TreeBuildStats& b = parallel.GetBuildStats();
+    EXPECT_EQ(a.action_nodes, b.action_nodes);
+    EXPECT_EQ(a.chance_nodes, b.chance_nodes);
+    EXPECT_EQ(a.showdown_nodes, b.showdown_nodes);
+    EXPECT_EQ(a.terminal_nodes, b.terminal_nodes);
+    EXPECT_EQ(a.deal_slots, b.deal_slots);
+    EXPECT_EQ(a.trainables_by_actions, b.trainables_by_actions);
+
+    // Same shape and metadata, node by node; the metadata also matches a
+    // separate CalculateTreeMetadata pass.
+    std::vector<std::pair<int, int>> built;
+    std::function<void(const std::shared_ptr<GameTreeNode>&, const std::shared_ptr<GameTreeNode>&)> compare =
+        [&](const std::shared_ptr<GameTreeNode>& x, const std::shared_ptr<GameTreeNode>& y) {
+        ASSERT_EQ(x->GetNodeType(), y->GetNodeType());
+        EXPECT_DOUBLE_EQ(x->GetPot(), y->GetPot());
+        EXPECT_EQ(x->GetDepth(), y->GetDepth());
+        EXPECT_EQ(x->GetSubtreeSize(), y->GetSubtreeSize());
+        built.emplace_back(y->GetDepth(), y->GetSubtreeSize());
+        if (auto action = std::dynamic_pointer_cast<ActionNode>(x)) {
+            auto other = std::static_pointer_cast<ActionNode>(y);
+            ASSERT_EQ(action->GetChildren().size(), other->GetChildren().size());
+            for (size_t i = 0; i < action->GetChildren().size(); ++i) {
+                EXPECT_EQ(action->GetActions()[i].ToString(), other->GetActions()[i].ToString());
+                compare(action->GetChildren()[i], other->GetChildren()[i]);
+            }
+        } else if (auto chance = std::dynamic_pointer_cast<ChanceNode>(x)) {
+            compare(chance->GetChild(), std::static_pointer_cast<ChanceNode>(y)->GetChild());
+        }
+    };
+    compare(serial.GetRoot(), parallel.GetRoot());
+
+    parallel.CalculateTreeMetadata();
+    size_t index = 0;
+    std::function<void(const std::shared_ptr<GameTreeNode>&)> recheck = [&](const std::shared_ptr<GameTreeNode>& node) {
+        ASSERT_LT(index, built.size());
+        EXPECT_EQ(built[index].first, node->GetDepth());
+        EXPECT_EQ(built[index].second, node->GetSubtreeSize());
+        ++index;
+        if (auto action = std::dynamic_pointer_cast<ActionNode>(node)) {
+            for (const auto& child : action->GetChildren()) recheck(child);
+        } else if (auto chance = std::dynamic_pointer_cast<ChanceNode>(node)) {
+            recheck(chance->GetChild());
+        }
+    };
+    recheck(parallel.GetRoot());
+    EXPECT_EQ(index, built.size());
+}
+
+// One subtree per chance node serves every card: only the deal slots depend on the deck
+TEST_F(GameTreeBuildTest, SubtreesSharedAcrossDeals) {
+    std::vector<int> board = {Card::StringToInt("Ac").value(), Card::StringToInt("Kd").value(),
+                              Card::StringToInt("9h").value()};
+    Rule full_rule(deck_, 5.0, 5.0, GameRound::kFlop, board, 3, 0.5, 1.0, 100.0, build_settings_, 0.98);
+    Rule short_rule(Deck::ShortDeck(), 5.0, 5.0, GameRound::kFlop, board, 3, 0.5, 1.0, 100.0, build_settings_, 0.98);
+    GameTree full(full_rule);
+    GameTree short_deck(short_rule);
+
+    const TreeBuildStats& a = full.GetBuildStats();
+    const TreeBuildStats& b = short_deck.GetBuildStats();
+    EXPECT_EQ(a.action_nodes, b.action_nodes);
+    EXPECT_EQ(a.chance_nodes, b.chance_nodes);
+    EXPECT_EQ(a.showdown_nodes + a.terminal_nodes, b.showdown_nodes + b.terminal_nodes);
+    EXPECT_GT(a.deal_slots, b.deal_slots);
+    EXPECT_EQ(full.EstimateTreeMemory() - short_deck.EstimateTreeMemory(),
+              (a.deal_slots - b.deal_slots) * sizeof(std::shared_ptr<poker_solver::solver::Trainable>));
+
+    auto root = std::dynamic_pointer_cast<ActionNode>(full.GetRoot());
+    ASSERT_NE(root, nullptr);
+    for (const auto& child : root->GetChildren()) {
+        if (auto chance = std::dynamic_pointer_cast<ChanceNode>(child)) {
+            EXPECT_TRUE(chance->GetDealtCards().empty());
+            EXPECT_NE(chance->GetChild(), nullptr);
+        }
+    }
+}
+
+// The per-trainable byte count agrees with what the trainables hold
+TEST(ActionNodeTrainableBytes, MatchesAllocatedTables) {
+    std::vector<PrivateCards> range = {PrivateCards(0, 1), PrivateCards(2, 3), PrivateCards(4, 5)};
+    for (auto precision : {ActionNode::TrainablePrecision::kSingle, ActionNode::TrainablePrecision::kHalf}) {
+        auto node = std::make_shared<ActionNode>(0, GameRound::kRiver, 10.0, std::weak_ptr<GameTreeNode>());
+        auto check = std::make_shared<TerminalNode>(std::vector<double>{5.0, -5.0}, GameRound::kRiver, 10.0, node);
+        auto bet = std::make_shared<TerminalNode>(std::vector<double>{10.0, -10.0}, GameRound::kRiver, 20.0, node);
+        node->SetActionsAndChildren({GameAction(PokerAction::kCheck), GameAction(PokerAction::kBet, 5.0)},
+                                    {check, bet});
+        node->SetPlayerRange(&range);
+        auto trainable = node->GetTrainable(0, precision);
+        size_t held = precision == ActionNode::TrainablePrecision::kSingle
+            ? std::dynamic_pointer_cast<poker_solver::solver::DiscountedCfrTrainableSF>(trainable)->MemoryBytes()
+            : std::dynamic_pointer_cast<poker_solver::solver::DiscountedCfrTrainableHF>(trainable)->MemoryBytes();
+        EXPECT_EQ(ActionNode::TrainableBytes(2, range.size(), precision), held);
+    }
+    // Double precision: three tables of doubles, padded to a cache line (144 -> 192).
+    EXPECT_EQ(ActionNode::TrainableBytes(2, 3, ActionNode::TrainablePrecision::kFloat), 192u);
+    EXPECT_EQ(ActionNode::TrainableBytes(0, 3, ActionNode::TrainablePrecision::kFloat), 0u);
+}
+
+// A memory budget thins bet sizes from the river up
+TEST_F(GameTreeBuildTest, MemoryBudgetThinsDeepStreetsFirst) {
+    StreetSetting wide{{33.0, 50.0, 75.0, 100.0}, {60.0, 100.0}, {}, true};
+    GameTreeBuildingSettings wide_settings{wide, wide, wide, wide, wide, wide};
+    Rule rule(deck_, 5.0, 5.0, GameRound::kFlop, initial_flop_board_cards_, 2, 0.5, 1.0, 100.0, wide_settings, 0.98);
+
+    TreeMemoryBudget budget;
+    budget.range_sizes = {200, 200};
+    budget.precision = ActionNode::TrainablePrecision::kSingle;
+
+    GameTree full(rule, budget); // No budget set: same as the Rule constructor
+    uint64_t full_bytes = full.GetBuildStats().TrainableBytes(budget.range_sizes, budget.precision);
+    EXPECT_EQ(full.GetBuildStats().action_nodes, GameTree(rule).GetBuildStats().action_nodes);
+
+    budget.max_bytes = full_bytes / 2;
+    GameTree reduced(rule, budget);
+    uint64_t reduced_bytes = reduced.GetBuildStats().TrainableBytes(budget.range_sizes, budget.precision);
+    EXPECT_LE(reduced_bytes, budget.max_bytes);
+    EXPECT_LT(reduced.GetBuildStats().action_nodes, full.GetBuildStats().action_nodes);
+
+    const auto& used = reduced.GetBuildRule()->GetBuildSettings();
+    EXPECT_LT(used.river_oop_setting.bet_sizes_percent.size(), wide.bet_sizes_percent.size());
+    EXPECT_EQ(used.flop_oop_setting.bet_sizes_percent.size(), wide.bet_sizes_percent.size());
+    EXPECT_TRUE(used.river_oop_setting.allow_all_in);
+
+    // An impossible budget ends at one size everywhere.
+    budget.max_bytes = 1;
+    GameTree smallest(rule, budget);
+    const auto& minimal = smallest.GetBuildRule()->GetBuildSettings();
+    EXPECT_EQ(minimal.flop_ip_setting.bet_sizes_percent.size(), 1u);
+    EXPECT_EQ(minimal.river_oop_setting.raise_sizes_percent.size(), 1u);
+}
+
+// A binary tree file loads back into the same tree, statistics and metadata included
+TEST_F(GameTreeBuildTest, BinaryFileRoundTrip) {
+    std::string path = ::testing::TempDir() + "game_tree_test.pstree";
+    game_tree_->WriteBinaryFile(path);
+    auto loaded = GameTree::FromBinaryFile(path, deck_);
+    std::remove(path.c_str());
+
+    const TreeBuildStats& a = game_tree_->GetBuildStats();
+    const TreeBuildStats& b = loaded->GetBuildStats();
+    EXPECT_EQ(a.action_nodes, b.action_nodes);
+    EXPECT_EQ(a.chance_nodes, b.chance_nodes);
+    EXPECT_EQ(a.showdown_nodes, b.showdown_nodes);
+    EXPECT_EQ(a.terminal_nodes, b.terminal_nodes);
+    EXPECT_EQ(a.deal_slots, b.deal_slots);
+    EXPECT_EQ(a.trainables_by_actions, b.trainables_by_actions);
+    EXPECT_FALSE(loaded->GetBuildRule().has_value());
+
+    std::function<void(const std::shared_ptr<GameTreeNode>&, const std::shared_ptr<GameTreeNode>&)> compare =
+        [&](const std::shared_ptr<GameTreeNode>& x, const std::shared_ptr<GameTreeNode>& y) {
+        ASSERT_EQ(x->GetNodeType(), y->GetNodeType());
+        EXPECT_EQ(x->GetRound(), y->GetRound());
+        EXPECT_DOUBLE_EQ(x->GetPot(), y->GetPot());
+        EXPECT_EQ(x->GetDepth(), y->GetDepth());
+        EXPECT_EQ(x->GetSubtreeSize(), y->GetSubtreeSize());
+        if (auto action = std::dynamic_pointer_cast<ActionNode>(x)) {
+            auto other = std::static_pointer_cast<ActionNode>(y);
+            EXPECT_EQ(action->GetPlayerIndex(), other->GetPlayerIndex());
+            ASSERT_EQ(action->GetChildren().size(), other->GetChildren().size());
+            for (size_t i = 0; i < action->GetChildren().size(); ++i) {
+                EXPECT_EQ(action->GetActions()[i].ToString(), other->GetActions()[i].ToString());
+                EXPECT_EQ(other->GetChildren()[i]->GetParent().get(), other.get());
+                compare(action->GetChildren()[i], other->GetChildren()[i]);
+            }
+        } else if (auto chance = std::dynamic_pointer_cast<ChanceNode>(x)) {
+            compare(chance->GetChild(), std::static_pointer_cast<ChanceNode>(y)->GetChild());
+        } else if (auto showdown = std::dynamic_pointer_cast<ShowdownNode>(x)) {
+            auto other = std::static_pointer_cast<ShowdownNode>(y);
+            for (auto result : {ComparisonResult::kPlayer1Wins, ComparisonResult::kPlayer2Wins, ComparisonResult::kTie}) {
+                EXPECT_EQ(showdown->GetPayoffs(result), other->GetPayoffs(result));
+            }
+        } else {
+            EXPECT_EQ(std::static_pointer_cast<TerminalNode>(x)->GetPayoffs(),
+                      std::static_pointer_cast<TerminalNode>(y)->GetPayoffs());
+        }
+    };
+    compare(game_tree_->GetRoot(), loaded->GetRoot());
+}
+
+TEST_F(GameTreeBuildTest, BinaryFileRejectsCorruptFiles) {
+    std::string path = ::testing::TempDir() + "game_tree_corrupt_test.pstree";
+    game_tree_->WriteBinaryFile(path);
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    auto write = [&](const std::string& contents) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << contents;
+    };
+
+    std::string flipped = bytes;
+    flipped[bytes.size() / 2] ^= 1;
+    write(flipped);
+    EXPECT_THROW(GameTree::FromBinaryFile(path, deck_), std::runtime_error);
+    write(bytes.substr(0, bytes.size() - 8));
+    EXPECT_THROW(GameTree::FromBinaryFile(path, deck_), std::runtime_error);
+    std::string bad_magic = bytes;
+    bad_magic[0] = 'X';
+    write(bad_magic);
+    EXPECT_THROW(GameTree::FromBinaryFile(path, deck_), std::runtime_error);
+    std::remove(path.c_str());
+    EXPECT_THROW(GameTree::FromBinaryFile(path, deck_), std::runtime_error);
+}
+
 // Test JSON Loading Constructor
 TEST(GameTreeJsonTest, JsonLoadThrows) {
     Deck deck;
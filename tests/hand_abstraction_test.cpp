@@ -0,0 +1,218 @@
+#include "gtest/gtest.h"
+#include "solver/HandAbstraction.h"
+#include "solver/PCfrSolver.h"
+#include "trainable/BucketedDiscountedCfrTrainable.h"
+#include "trainable/DiscountedCfrTrainable.h"
+#include "toy_spot.h"
+#include "nodes/ActionNode.h"
+#include "nodes/ChanceNode.h"
+#include "nodes/TerminalNode.h"
+#include "nodes/GameActions.h"
+#include "ranges/PrivateCards.h"
+#include "Deck.h"
+#include "Card.h"
+#include <cmath>
+#include <memory>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+using namespace poker_solver::core;
+using namespace poker_solver::config;
+using namespace poker_solver::nodes;
+using namespace poker_solver::ranges;
+using namespace poker_solver::solver;
+using namespace poker_solver::tree;
+using test_support::MakeRange;
+using test_support::MakeToyRiverRanges;
+
+// A turn spot of pot 20 and stacks 50 with 50% bets and all-ins, and the
+// ranges of its players.
+class HandAbstractionTest : public ::testing::Test {
+ protected:
+  Deck deck_;
+  std::vector<int> board_ = test_support::TurnBoard();
+
+  std::unique_ptr<PCfrSolver> MakeSolver(const std::vector<int>& board, const PCfrSolver::Config& config) const {
+      return test_support::MakeToySolver(test_support::MakeSpotRule(deck_, board),
+                                         {MakeRange(0, 14, board), MakeRange(6, 20, board)}, config);
+  }
+
+  // First action node of the next street after both players check.
+  static const ActionNode& NextStreetRoot(const PCfrSolver& solver) {
+      const ActionNode& second = solver.FindActionNode({"CHECK"});
+      size_t check = 0;
+      while (second.GetActions()[check].GetAction() != PokerAction::kCheck) ++check;
+      const auto& chance = dynamic_cast<const ChanceNode&>(*second.GetChildren()[check]);
+      return dynamic_cast<const ActionNode&>(*chance.GetChild());
+  }
+};
+
+// --- Tests ---
+
+TEST_F(HandAbstractionTest, BucketsPartitionTheRange) {
+    const std::vector<PrivateCards> player = MakeRange(0, 14, board_);
+    const std::vector<PrivateCards> opponent = MakeRange(6, 20, board_);
+    const uint64_t board_mask = Card::CardIntsToUint64(board_);
+    HandAbstraction abstraction(MakeToyRiverRanges(), deck_.GetCardsMask(), 6);
+    auto buckets = abstraction.BucketsFor(0, player, opponent, board_mask);
+    ASSERT_EQ(buckets->bucket_of_hand.size(), player.size());
+    EXPECT_GT(buckets->num_buckets, 1u);
+    EXPECT_LE(buckets->num_buckets, 6u);
+    std::set<uint32_t> used(buckets->bucket_of_hand.begin(), buckets->bucket_of_hand.end());
+    EXPECT_EQ(used.size(), buckets->num_buckets); // Empty clusters are dropped
+    EXPECT_EQ(*used.rbegin(), buckets->num_buckets - 1);
+
+    // Cached per player and board, and the same from a fresh abstraction.
+    EXPECT_EQ(abstraction.BucketsFor(0, player, opponent, board_mask), buckets);
+    HandAbstraction again(MakeToyRiverRanges(), deck_.GetCardsMask(), 6);
+    EXPECT_EQ(again.BucketsFor(0, player, opponent, board_mask)->bucket_of_hand, buckets->bucket_of_hand);
+
+    HandAbstraction single(MakeToyRiverRanges(), deck_.GetCardsMask(), 1);
+    auto one = single.BucketsFor(1, opponent, player, board_mask);
+    EXPECT_EQ(one->num_buckets, 1u);
+    EXPECT_EQ(std::set<uint32_t>(one->bucket_of_hand.begin(), one->bucket_of_hand.end()), std::set<uint32_t>{0});
+
+    const uint64_t river_board = board_mask | (1ULL << Card::StringToInt("2c").value());
+    EXPECT_THROW(abstraction.BucketsFor(0, player, opponent, river_board), std::invalid_argument);
+    EXPECT_THROW(HandAbstraction(MakeToyRiverRanges(), deck_.GetCardsMask(), 0), std::invalid_argument);
+    EXPECT_THROW(HandAbstraction(nullptr, deck_.GetCardsMask(), 4), std::invalid_argument);
+}
+
+// One bucket per hand is plain Discounted CFR; hands sharing a bucket share
+// its regrets and strategy.
+TEST_F(HandAbstractionTest, BucketedTrainableSharesRows) {
+    std::vector<PrivateCards> range;
+    for (int c = 0; c + 1 < 16; c += 2) range.emplace_back(c, c + 1);
+    auto node = std::make_shared<ActionNode>(0, GameRound::kTurn, 10.0, std::weak_ptr<GameTreeNode>(), 1);
+    auto terminal = std::make_shared<TerminalNode>(std::vector<double>{0.0, 0.0}, GameRound::kTurn, 10.0,
+                                                   std::weak_ptr<GameTreeNode>(node));
+    node->AddChild(GameAction(PokerAction::kCheck), terminal);
+    node->AddChild(GameAction(PokerAction::kBet, 5.0), terminal);
+    node->SetPlayerRange(&range);
+    const size_t num_hands = range.size();
+    const size_t num_actions = 2;
+
+    auto identity = std::make_shared<HandBuckets>();
+    identity->num_buckets = num_hands;
+    for (size_t h = 0; h < num_hands; ++h) identity->bucket_of_hand.push_back(static_cast<uint32_t>(h));
+    auto pairs = std::make_shared<HandBuckets>();
+    pairs->num_buckets = num_hands / 2;
+    for (size_t h = 0; h < num_hands; ++h) pairs->bucket_of_hand.push_back(static_cast<uint32_t>(h / 2));
+
+    DiscountedCfrTrainable dense(&range, *node);
+    BucketedDiscountedCfrTrainable per_hand(&range, *node, identity);
+    BucketedDiscountedCfrTrainable paired(&range, *node, pairs);
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> regret_dist(-5.0, 5.0);
+    std::uniform_real_distribution<double> reach_dist(0.1, 1.0);
+    std::vector<double> scratch(num_hands * num_actions);
+    for (int t = 1; t <= 30; ++t) {
+        std::vector<double> regrets(num_hands * num_actions);
+        std::vector<double> reach(num_hands);
+        for (auto& r : regrets) r = regret_dist(rng);
+        for (auto& r : reach) r = reach_dist(rng);
+        for (Trainable* trainable : std::vector<Trainable*>{&dense, &per_hand, &paired}) {
+            const double* played = trainable->CurrentStrategy(scratch.data());
+            trainable->UpdateFromVisit(regrets.data(), played, reach.data(), IterationDiscounts::For(t));
+        }
+    }
+
+    const std::vector<double> dense_average = dense.GetAverageStrategy();
+    const std::vector<double> per_hand_average = per_hand.GetAverageStrategy();
+    for (size_t i = 0; i < dense_average.size(); ++i) EXPECT_NEAR(per_hand_average[i], dense_average[i], 1e-12);
+    const std::vector<double> paired_average = paired.GetAverageStrategy();
+    for (size_t h = 0; h < num_hands; h += 2) {
+        for (size_t a = 0; a < num_actions; ++a) {
+            EXPECT_EQ(paired_average[h * num_actions + a], paired_average[(h + 1) * num_actions + a]);
+        }
+    }
+    EXPECT_LT(paired.TableBytes(), per_hand.TableBytes());
+
+    std::vector<double> regrets(num_actions), sums(num_actions);
+    paired.GetHandState(3, regrets.data(), sums.data());
+    std::vector<double> other_regrets(num_actions), other_sums(num_actions);
+    paired.GetHandState(2, other_regrets.data(), other_sums.data());
+    EXPECT_EQ(regrets, other_regrets);
+    EXPECT_EQ(sums, other_sums);
+
+    auto bad = std::make_shared<HandBuckets>();
+    bad->num_buckets = 1;
+    bad->bucket_of_hand.assign(num_hands, 1);
+    EXPECT_THROW(BucketedDiscountedCfrTrainable(&range, *node, bad), std::invalid_argument);
+}
+
+// Turn nodes get bucketed trainables, and the coarser tables still train to
+// a finite exploitability in less memory.
+TEST_F(HandAbstractionTest, SolverBucketsEarlyStreets) {
+    PCfrSolver::Config config;
+    config.iteration_limit = 30;
+    config.num_threads = 1;
+    auto exact = MakeSolver(board_, config);
+    exact->Train();
+    const PCfrSolver::MemoryStats exact_memory = exact->GetMemoryStats();
+
+    config.abstraction_buckets = 4;
+    auto bucketed = MakeSolver(board_, config);
+    bucketed->Train();
+    const double exploitability = bucketed->ComputeExploitability();
+    EXPECT_TRUE(std::isfinite(exploitability));
+    EXPECT_GT(exploitability, 0.0);
+    EXPECT_LT(bucketed->GetMemoryStats().trainable_bytes, exact_memory.trainable_bytes);
+
+    const ActionNode& root = bucketed->FindActionNode({});
+    auto root_trainable = root.GetTrainableIfExists(0);
+    ASSERT_NE(dynamic_cast<const BucketedDiscountedCfrTrainable*>(root_trainable.get()), nullptr);
+    EXPECT_LE(dynamic_cast<const BucketedDiscountedCfrTrainable&>(*root_trainable).NumBuckets(), 4u);
+
+    config.abstraction_buckets = -1;
+    EXPECT_THROW(MakeSolver(board_, config), std::invalid_argument);
+    config.abstraction_buckets = 4;
+    config.precision = ActionNode::TrainablePrecision::kHalf;
+    EXPECT_THROW(MakeSolver(board_, config), std::invalid_argument);
+}
+
+// On a flop tree the turn nodes' deal slots decode to their own boards.
+TEST_F(HandAbstractionTest, FlopTreeBucketsEachTurnBoard) {
+    const std::vector<int> flop(board_.begin(), board_.begin() + 3);
+    PCfrSolver::Config config;
+    config.iteration_limit = 2;
+    config.num_threads = 1;
+    config.abstraction_buckets = 3;
+    auto solver = MakeSolver(flop, config);
+    solver->Train();
+    EXPECT_TRUE(std::isfinite(solver->ComputeExploitability()));
+
+    const auto& turn = NextStreetRoot(*solver);
+    HandAbstraction reference(MakeToyRiverRanges(), deck_.GetCardsMask(), 3);
+    const std::vector<PrivateCards> player = MakeRange(0, 14, flop);
+    const std::vector<PrivateCards> opponent = MakeRange(6, 20, flop);
+    int checked_boards = 0;
+    for (int card = 0; card < kNumCardsInDeck && checked_boards < 3; ++card) {
+        const uint64_t board_mask = Card::CardIntsToUint64(flop) | (1ULL << card);
+        if (CountCards(board_mask) != 4) continue;
+        // Deal slots of the turn are positions among the cards off the flop.
+        size_t slot = 0;
+        for (int other = 0; other < card; ++other) slot += (Card::CardIntsToUint64(flop) >> other) & 1ULL ? 0 : 1;
+        auto trainable = turn.GetTrainableIfExists(slot);
+        ASSERT_NE(trainable, nullptr);
+        const auto expected = reference.BucketsFor(turn.GetPlayerIndex(), turn.GetPlayerIndex() == 0 ? player : opponent,
+                                                   turn.GetPlayerIndex() == 0 ? opponent : player, board_mask);
+        const std::vector<double> average = trainable->GetAverageStrategy();
+        const size_t num_actions = turn.GetActions().size();
+        // Hands of one reference bucket play alike.
+        for (size_t h = 1; h < expected->bucket_of_hand.size(); ++h) {
+            for (size_t g = 0; g < h; ++g) {
+                if (expected->bucket_of_hand[g] != expected->bucket_of_hand[h]) continue;
+                for (size_t a = 0; a < num_actions; ++a) {
+                    EXPECT_EQ(average[g * num_actions + a], average[h * num_actions + a]);
+                }
+                break;
+            }
+        }
+        EXPECT_EQ(dynamic_cast<const BucketedDiscountedCfrTrainable&>(*trainable).NumBuckets(),
+                  expected->num_buckets);
+        ++checked_boards;
+    }
+}
@@ -0,0 +1,201 @@
+#include "gtest/gtest.h"
+#include "solver/HandGrid.h"
+#include "solver/PCfrSolver.h"
+#include "solver/StrategyFile.h"
+#include "toy_spot.h"
+#include "nodes/ActionNode.h"
+#include "nodes/GameActions.h"
+#include "ranges/PrivateCards.h"
+#include "Deck.h"
+#include "Card.h"
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+using namespace poker_solver::core;
+using namespace poker_solver::config;
+using namespace poker_solver::nodes;
+using namespace poker_solver::ranges;
+using namespace poker_solver::solver;
+using namespace poker_solver::tree;
+
+namespace {
+
+PrivateCards Hand(const char* card1, const char* card2) {
+    return PrivateCards(Card::StringToInt(card1).value(), Card::StringToInt(card2).value());
+}
+
+} // namespace
+
+// A flop spot of pot 20 and stacks 50 with 50% bets and all-ins, solved
+// briefly.
+class HandGridTest : public ::testing::Test {
+ protected:
+  Deck deck_;
+  std::vector<int> board_ = test_support::FlopBoard();
+  std::unique_ptr<PCfrSolver> solver_;
+
+  std::vector<PrivateCards> MakeRange(int first_card, int last_card) const {
+      return test_support::MakeRange(first_card, last_card, board_);
+  }
+
+  void SetUp() override {
+      PCfrSolver::Config config;
+      config.iteration_limit = 10;
+      config.num_threads = 1;
+      solver_ = test_support::MakeToySolver(test_support::MakeSpotRule(deck_, board_),
+                                            {MakeRange(0, 14), MakeRange(6, 20)}, config);
+      solver_->Train();
+  }
+
+  static size_t ActionIndex(const ActionNode& node, PokerAction action) {
+      size_t a = 0;
+      while (a < node.GetActions().size() && node.GetActions()[a].GetAction() != action) ++a;
+      return a;
+  }
+};
+
+// --- Tests ---
+
+TEST(HandGridCellTest, AcesFirstSuitedAboveTheDiagonal) {
+    EXPECT_EQ(HandGridCell(Card::StringToInt("Ac").value(), Card::StringToInt("Ad").value()), 0u);
+    EXPECT_EQ(HandGridCell(Card::StringToInt("Ac").value(), Card::StringToInt("Kc").value()), 1u);
+    EXPECT_EQ(HandGridCell(Card::StringToInt("Kc").value(), Card::StringToInt("Ad").value()), 13u);
+    EXPECT_EQ(HandGridCell(Card::StringToInt("2c").value(), Card::StringToInt("2h").value()), kHandGridCells - 1);
+}
+
+TEST(HandGridAggregateTest, CellsAverageTheirHandsByReach) {
+    const std::vector<PrivateCards> hands = {Hand("Ac", "Kd"), Hand("Ah", "Ks"), Hand("As", "Kh"), Hand("Qc", "Qd")};
+    const std::vector<double> reach = {1.0, 3.0, 0.0, 2.0};
+    const std::vector<double> strategy = {1.0, 0.0, 0.0, 1.0, 0.5, 0.5, 0.25, 0.75};
+    const std::vector<double> evs = {4.0, 0.0, 0.0, 8.0, 1.0, 1.0, 2.0, 6.0};
+    const HandGrid grid = AggregateHandGrid(hands, reach, strategy, evs, 2);
+
+    const size_t ako = 13;
+    EXPECT_EQ(grid.num_hands[ako], 2u); // The hand without reach is out
+    EXPECT_DOUBLE_EQ(grid.reach[ako], 4.0);
+    EXPECT_DOUBLE_EQ(grid.strategy[ako * 2], 0.25);
+    EXPECT_DOUBLE_EQ(grid.strategy[ako * 2 + 1], 0.75);
+    EXPECT_DOUBLE_EQ(grid.evs[ako * 2], 1.0);
+    EXPECT_DOUBLE_EQ(grid.evs[ako * 2 + 1], 6.0);
+    const size_t qq = 2 * 13 + 2;
+    EXPECT_DOUBLE_EQ(grid.strategy[qq * 2 + 1], 0.75);
+    EXPECT_EQ(grid.num_hands[0], 0u);
+    EXPECT_DOUBLE_EQ(grid.strategy[0], 0.0);
+    EXPECT_DOUBLE_EQ(grid.action_combos[0], 1.5);
+    EXPECT_DOUBLE_EQ(grid.action_combos[1], 4.5);
+
+    EXPECT_FALSE(AggregateHandGrid(hands, reach, strategy, {}, 2).has_evs);
+    EXPECT_THROW(AggregateHandGrid(hands, reach, strategy, evs, 3), std::invalid_argument);
+    EXPECT_THROW(AggregateHandGrid(hands, {1.0}, strategy, evs, 2), std::invalid_argument);
+    EXPECT_THROW(AggregateHandGrid(hands, reach, strategy, evs, 0), std::invalid_argument);
+}
+
+// Large grids are summed in parallel, a cell per thread at a time.
+TEST(HandGridAggregateTest, ResultsDoNotDependOnTheThreadCount) {
+    std::vector<PrivateCards> hands;
+    for (int c1 = 0; c1 < kNumCardsInDeck; ++c1) {
+        for (int c2 = c1 + 1; c2 < kNumCardsInDeck; ++c2) hands.emplace_back(c1, c2);
+    }
+    const size_t num_actions = 16;
+    std::vector<double> reach(hands.size());
+    std::vector<double> strategy(hands.size() * num_actions);
+    for (size_t h = 0; h < hands.size(); ++h) {
+        reach[h] = 0.1 + 0.7 * static_cast<double>(h % 11) / 11.0;
+        for (size_t a = 0; a < num_actions; ++a) strategy[h * num_actions + a] = static_cast<double>((h + a) % 7) / 21.0;
+    }
+    const int threads = omp_get_max_threads();
+    omp_set_num_threads(1);
+    const HandGrid serial = AggregateHandGrid(hands, reach, strategy, strategy, num_actions);
+    omp_set_num_threads(4);
+    const HandGrid parallel = AggregateHandGrid(hands, reach, strategy, strategy, num_actions);
+    omp_set_num_threads(threads);
+    EXPECT_EQ(parallel.strategy, serial.strategy);
+    EXPECT_EQ(parallel.evs, serial.evs);
+    EXPECT_EQ(parallel.reach, serial.reach);
+    EXPECT_EQ(parallel.action_combos, serial.action_combos);
+}
+
+// The root's reach is the range itself; a turn node's is the range times
+// the root player's flop check, without the hands holding the turn card.
+TEST_F(HandGridTest, SolverGridsWeighTheTrainablesByReach) {
+    const ActionNode& root = solver_->FindActionNode({});
+    const size_t player = root.GetPlayerIndex();
+    const std::vector<PrivateCards> range = MakeRange(6, 20);
+    ASSERT_EQ(player, 1u);
+    const std::vector<double> root_strategy = root.GetTrainableIfExists(0)->GetAverageStrategy();
+    const std::shared_ptr<const HandGrid> root_grid = solver_->GetHandGrid({});
+    ASSERT_NE(root_grid, nullptr);
+    const HandGrid expected_root = AggregateHandGrid(range, std::vector<double>(range.size(), 1.0), root_strategy, {},
+                                                     root.GetActions().size());
+    EXPECT_EQ(root_grid->strategy, expected_root.strategy);
+    EXPECT_EQ(root_grid->reach, expected_root.reach);
+    EXPECT_FALSE(root_grid->has_evs);
+    EXPECT_EQ(solver_->GetHandGrid({}), root_grid); // Cached
+
+    const ActionNode& turn = solver_->FindActionNode({"CHECK", "CHECK"});
+    ASSERT_EQ(turn.GetPlayerIndex(), player);
+    // A turn card some hands of the range hold; slots follow the cards off
+    // the board in ascending order.
+    const int dealt_card = 10;
+    size_t deal = 0;
+    for (int card = 0; card < dealt_card; ++card) {
+        if (!(Card::CardIntsToUint64(board_) & (1ULL << card))) ++deal;
+    }
+    ASSERT_NE(turn.GetTrainableIfExists(deal), nullptr);
+    const size_t check = ActionIndex(root, PokerAction::kCheck);
+    const size_t num_root_actions = root.GetActions().size();
+    std::vector<double> reach(range.size());
+    for (size_t h = 0; h < range.size(); ++h) {
+        const bool blocked = range[h].GetBoardMask() & (1ULL << dealt_card);
+        reach[h] = blocked ? 0.0 : root_strategy[h * num_root_actions + check];
+    }
+    const HandGrid expected_turn = AggregateHandGrid(range, reach, turn.GetTrainableIfExists(deal)->GetAverageStrategy(),
+                                                     {}, turn.GetActions().size());
+    const std::shared_ptr<const HandGrid> turn_grid = solver_->GetHandGrid({"CHECK", "CHECK"}, deal);
+    ASSERT_NE(turn_grid, nullptr);
+    EXPECT_EQ(turn_grid->num_hands, expected_turn.num_hands);
+    for (size_t i = 0; i < expected_turn.strategy.size(); ++i) {
+        EXPECT_NEAR(turn_grid->strategy[i], expected_turn.strategy[i], 1e-12);
+    }
+    EXPECT_THROW(solver_->GetHandGrid({"CHECK", "CHECK"}, turn.GetNumPossibleDeals()), std::invalid_argument);
+    EXPECT_THROW(solver_->GetHandGrid({}, 1), std::invalid_argument);
+
+    // EVs refresh the cache.
+    solver_->ComputeEvs(0);
+    const std::shared_ptr<const HandGrid> with_evs = solver_->GetHandGrid({});
+    EXPECT_NE(with_evs, root_grid);
+    EXPECT_TRUE(with_evs->has_evs);
+    EXPECT_EQ(with_evs->strategy, root_grid->strategy);
+}
+
+TEST_F(HandGridTest, StrategyFileGridsCountEveryHandOnce) {
+    const std::string path = ::testing::TempDir() + "hand_grid_test.strategy";
+    solver_->WriteStrategyFile(path);
+    auto file = std::make_shared<const StrategyFile>(path);
+    HandGridCache cache(file);
+    const size_t root = file->Find("").value();
+    const std::shared_ptr<const HandGrid> grid = cache.Get(root);
+    EXPECT_EQ(cache.Get(root), grid);
+    const std::shared_ptr<const HandGrid> solver_grid = solver_->GetHandGrid({});
+    EXPECT_EQ(grid->num_hands, solver_grid->num_hands);
+    EXPECT_EQ(grid->reach, solver_grid->reach);
+    for (size_t i = 0; i < grid->strategy.size(); ++i) EXPECT_NEAR(grid->strategy[i], solver_grid->strategy[i], 1e-6);
+
+    // The turn card's hands are out of play.
+    const int dealt_card = 10;
+    const size_t turn = file->Find("CHECK/CHECK/" + Card::IntToString(dealt_card)).value();
+    size_t in_play = 0;
+    for (size_t count : cache.Get(turn)->num_hands) in_play += count;
+    size_t expected = 0;
+    for (const PrivateCards& hand : MakeRange(6, 20)) {
+        if (!(hand.GetBoardMask() & (1ULL << dealt_card))) ++expected;
+    }
+    ASSERT_LT(expected, MakeRange(6, 20).size());
+    EXPECT_EQ(in_play, expected);
+    EXPECT_THROW(cache.Get(file->NumNodes()), std::out_of_range);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,59 @@
+#include "gtest/gtest.h"
+#include "kuhn/kuhn_poker_setup.h"
+#include "nodes/ActionNode.h"
+#include "solver/PCfrSolver.h"
+#include "GameTree.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace poker_solver::kuhn;
+using namespace poker_solver::nodes;
+using namespace poker_solver::solver;
+
+namespace {
+
+std::vector<std::string> ActionStrings(const ActionNode& node) {
+    std::vector<std::string> actions;
+    for (const auto& action : node.GetActions()) actions.push_back(action.ToString());
+    return actions;
+}
+
+} // namespace
+
+// --- Tests ---
+
+TEST(KuhnPokerTest, TreeIsKuhnPoker) {
+    PCfrSolver::Config config;
+    config.iteration_limit = 1;
+    auto solver = make_kuhn_solver(config);
+    const ActionNode& root = solver->FindActionNode({});
+    EXPECT_EQ(root.GetPlayerIndex(), KUHN_FIRST_PLAYER);
+    EXPECT_EQ(ActionStrings(root), (std::vector<std::string>{"CHECK", "BET 1"}));
+    EXPECT_EQ(ActionStrings(solver->FindActionNode({"CHECK"})), (std::vector<std::string>{"CHECK", "BET 1"}));
+    EXPECT_EQ(ActionStrings(solver->FindActionNode({"BET 1"})), (std::vector<std::string>{"CALL", "FOLD"}));
+    EXPECT_EQ(ActionStrings(solver->FindActionNode({"CHECK", "BET 1"})), (std::vector<std::string>{"CALL", "FOLD"}));
+
+    KuhnCompairer compairer;
+    EXPECT_EQ(compairer.CompareHands(kuhn_hand_mask(KUHN_CARD_K), kuhn_hand_mask(KUHN_CARD_Q), 0),
+              poker_solver::core::ComparisonResult::kPlayer1Wins);
+    EXPECT_EQ(compairer.CompareHands(kuhn_hand_mask(KUHN_CARD_J), kuhn_hand_mask(KUHN_CARD_Q), 0),
+              poker_solver::core::ComparisonResult::kPlayer2Wins);
+    EXPECT_THROW(compairer.GetHandRank(kuhn_hand_mask(KUHN_CARD_J) | kuhn_hand_mask(KUHN_CARD_Q), 0), std::invalid_argument);
+}
+
+// Every mode reaches its exploitability bound, and the first player's best
+// response value brackets the game value: at an epsilon-equilibrium it lies
+// within twice the exploitability above it.
+TEST(KuhnPokerTest, ModesConverge) {
+    for (const KuhnConvergenceMode& mode : kuhn_convergence_modes()) {
+        auto solver = make_kuhn_solver(mode.config);
+        solver->Train();
+        const double exploitability = solver->ComputeExploitability();
+        EXPECT_LE(exploitability, mode.max_exploitability) << mode.name;
+        const double pot = 2.0;
+        const double first_player_value = solver->GetBestResponseValues()[KUHN_FIRST_PLAYER];
+        EXPECT_GE(first_player_value, KUHN_GAME_VALUE - 1e-9) << mode.name;
+        EXPECT_LE(first_player_value, KUHN_GAME_VALUE + 2.0 * exploitability / 100.0 * pot + 1e-9) << mode.name;
+    }
+}
@@ -0,0 +1,153 @@
+#include "gtest/gtest.h"
+#include "solver/MultiBoardRiverSolver.h"
+#include "solver/PCfrSolver.h"
+#include "toy_spot.h"
+#include "ranges/PrivateCards.h"
+#include "GameTree.h"
+#include "Deck.h"
+#include "Card.h"
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Use namespaces
+using namespace poker_solver::core;
+using namespace poker_solver::config;
+using namespace poker_solver::ranges;
+using namespace poker_solver::solver;
+using namespace poker_solver::tree;
+
+namespace {
+
+// Forwards to the CPU backend, recording the largest batch.
+class CountingBackend : public ShowdownBackend {
+ public:
+  const char* Name() const override { return "counting"; }
+  void EvaluateShowdowns(const Batch& batch) override {
+      size_t seen = largest_batch.load();
+      while (batch.num_boards > seen && !largest_batch.compare_exchange_weak(seen, batch.num_boards)) {}
+      cpu_.EvaluateShowdowns(batch);
+  }
+
+  std::atomic<size_t> largest_batch{0};
+
+ private:
+  CpuShowdownBackend cpu_;
+};
+
+} // namespace
+
+// Every river of a turn, with ranges some of the rivers block: the lockstep
+// solve must give each board the strategies of a solve of that board alone.
+class MultiBoardRiverSolverTest : public ::testing::Test {
+ protected:
+  Deck deck_;
+  std::vector<int> turn_ = test_support::TurnBoard();
+  std::vector<std::string> rivers_ = {"2c", "Qs", "3d", "4h", "Jc"};
+  // Not filtered by any river: each board drops the hands it blocks.
+  std::array<std::vector<PrivateCards>, 2> ranges_ = {test_support::MakeRange(0, 14, {}),
+                                                      test_support::MakeRange(6, 20, {})};
+
+  std::vector<int> Board(size_t river) const {
+      std::vector<int> board = turn_;
+      board.push_back(Card::StringToInt(rivers_[river]).value());
+      return board;
+  }
+
+  std::shared_ptr<GameTree> MakeTree(const std::vector<int>& board) const {
+      return std::make_shared<GameTree>(test_support::MakeSpotRule(deck_, board));
+  }
+
+  std::vector<uint64_t> BoardMasks() const {
+      std::vector<uint64_t> masks;
+      for (size_t r = 0; r < rivers_.size(); ++r) masks.push_back(Card::CardIntsToUint64(Board(r)));
+      return masks;
+  }
+
+  json SolveAlone(size_t river, int iterations) const {
+      PCfrSolver::Config config;
+      config.iteration_limit = iterations;
+      config.parallel_level = PCfrSolver::ParallelLevel::kNone;
+      auto solver = test_support::MakeToySolver(test_support::MakeSpotRule(deck_, Board(river)),
+                                                {ranges_.begin(), ranges_.end()}, config);
+      solver->Train();
+      return solver->DumpStrategy(false);
+  }
+
+  static void ExpectSameStrategies(const json& expected, const json& actual, const std::string& where) {
+      ASSERT_EQ(expected["node_type"], actual["node_type"]) << where;
+      if (expected["node_type"] != "Action") return;
+      const json& expected_strategy = expected["strategy_data"]["strategy"];
+      const json& actual_strategy = actual["strategy_data"]["strategy"];
+      ASSERT_EQ(expected_strategy.size(), actual_strategy.size()) << where;
+      for (auto it = expected_strategy.begin(); it != expected_strategy.end(); ++it) {
+          ASSERT_TRUE(actual_strategy.contains(it.key())) << where << " " << it.key();
+          for (size_t a = 0; a < it.value().size(); ++a) {
+              EXPECT_NEAR(it.value()[a].get<double>(), actual_strategy[it.key()][a].get<double>(), 1e-9)
+                  << where << " " << it.key();
+          }
+      }
+      for (auto it = expected["children"].begin(); it != expected["children"].end(); ++it) {
+          ExpectSameStrategies(it.value(), actual["children"][it.key()], where + "/" + it.key());
+      }
+  }
+};
+
+TEST_F(MultiBoardRiverSolverTest, MatchesSeparateSolves) {
+    for (int threads : {1, 3}) {
+        MultiBoardRiverSolver::Config config;
+        config.iteration_limit = 20;
+        config.num_threads = threads;
+        MultiBoardRiverSolver solver(MakeTree(Board(0)), ranges_, BoardMasks(), test_support::MakeToyRiverRanges(),
+                                     config);
+        auto counting = std::make_shared<CountingBackend>();
+        solver.SetShowdownBackend(counting);
+        solver.Train();
+        EXPECT_EQ(solver.GetCompletedIterations(), 20);
+        // One batch per showdown, or one slice per thread.
+        EXPECT_EQ(counting->largest_batch.load(), threads == 1 ? rivers_.size() : 2u);
+        for (size_t r = 0; r < rivers_.size(); ++r) {
+            const json dump = solver.DumpStrategy(r);
+            std::string board; // Lowest card first
+            for (int card : Card::Uint64ToCardInts(BoardMasks()[r])) board += Card::IntToString(card);
+            EXPECT_EQ(dump["metadata"]["board"], board);
+            ExpectSameStrategies(SolveAlone(r, 20), dump, rivers_[r]);
+        }
+    }
+}
+
+TEST_F(MultiBoardRiverSolverTest, AverageStrategyFollowsPaths) {
+    MultiBoardRiverSolver::Config config;
+    config.iteration_limit = 5;
+    MultiBoardRiverSolver solver(MakeTree(Board(0)), ranges_, BoardMasks(), test_support::MakeToyRiverRanges(),
+                                 config);
+    solver.Train();
+    const json dump = solver.DumpStrategy(1);
+    const json& node = dump["children"]["CHECK"];
+    ASSERT_EQ(node["node_type"], "Action");
+    const std::vector<double> strategy = solver.GetAverageStrategy({"CHECK"}, 1);
+    const auto& range = solver.GetPlayerRange(node["player"].get<size_t>());
+    const size_t num_actions = node["strategy_data"]["actions"].size();
+    ASSERT_EQ(strategy.size(), range.size() * num_actions);
+    for (size_t h = 0; h < range.size(); ++h) {
+        const std::string hand = range[h].ToString();
+        if (!node["strategy_data"]["strategy"].contains(hand)) continue; // Blocked by the river
+        for (size_t a = 0; a < num_actions; ++a) {
+            EXPECT_EQ(strategy[h * num_actions + a], node["strategy_data"]["strategy"][hand][a].get<double>());
+        }
+    }
+    EXPECT_THROW(solver.GetAverageStrategy({"RAISE 1000"}, 0), std::invalid_argument);
+    EXPECT_THROW(solver.GetAverageStrategy({}, rivers_.size()), std::out_of_range);
+}
+
+TEST_F(MultiBoardRiverSolverTest, RejectsUnsupportedInput) {
+    auto rrm = test_support::MakeToyRiverRanges();
+    EXPECT_THROW(MultiBoardRiverSolver(std::make_shared<GameTree>(test_support::MakeSpotRule(deck_, turn_)), ranges_, BoardMasks(), rrm),
+                 std::invalid_argument);
+    EXPECT_THROW(MultiBoardRiverSolver(MakeTree(Board(0)), ranges_, {Card::CardIntsToUint64(turn_)}, rrm),
+                 std::invalid_argument);
+    EXPECT_THROW(MultiBoardRiverSolver(MakeTree(Board(0)), ranges_, {}, rrm), std::invalid_argument);
+    EXPECT_THROW(MultiBoardRiverSolver(MakeTree(Board(0)), ranges_, BoardMasks(), nullptr), std::invalid_argument);
+}
@@ -0,0 +1,48 @@
+#include "gtest/gtest.h"
+#include "solver/NumaTopology.h"
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace poker_solver::solver;
+
+TEST(NumaTopologyTest, ParsesKernelCpuLists) {
+    EXPECT_EQ(ParseCpuList("0-3,8,10-11\n"), (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    EXPECT_EQ(ParseCpuList("5"), (std::vector<int>{5}));
+    EXPECT_EQ(ParseCpuList(""), (std::vector<int>{}));
+    EXPECT_THROW(ParseCpuList("3-1"), std::invalid_argument);
+    EXPECT_THROW(ParseCpuList("0-"), std::invalid_argument);
+    EXPECT_THROW(ParseCpuList("a"), std::invalid_argument);
+}
+
+TEST(NumaTopologyTest, SplitsTeamsIntoContiguousBlocks) {
+    NumaTopology topology({{0, 1}, {2, 3}});
+    std::vector<size_t> nodes;
+    for (int thread = 0; thread < 6; ++thread) nodes.push_back(topology.NodeOfThread(thread, 6));
+    EXPECT_EQ(nodes, (std::vector<size_t>{0, 0, 0, 1, 1, 1}));
+    EXPECT_EQ(topology.NodeOfThread(0, 1), 0u);
+    EXPECT_EQ(topology.NodeOfThread(2, 3), 1u);
+    EXPECT_THROW(NumaTopology({{0}, {}}), std::invalid_argument);
+}
+
+TEST(NumaTopologyTest, DetectsAllowedCpusAndRestoresAffinity) {
+    const NumaTopology detected = NumaTopology::Detect();
+    ASSERT_GE(detected.NumNodes(), 1u);
+    for (size_t node = 0; node < detected.NumNodes(); ++node) EXPECT_FALSE(detected.Cpus(node).empty());
+
+    // On a separate thread, so the test runner keeps its affinity either way.
+    std::thread([&detected] {
+        const NumaTopology one_cpu(std::vector<std::vector<int>>{{detected.Cpus(0).front()}});
+        {
+            ScopedThreadAffinity restore;
+            if (one_cpu.PinCurrentThread(0)) {
+                EXPECT_EQ(NumaTopology::Detect().NumNodes(), 1u);
+                EXPECT_EQ(NumaTopology::Detect().Cpus(0), one_cpu.Cpus(0));
+            }
+        }
+        const NumaTopology restored = NumaTopology::Detect();
+        ASSERT_EQ(restored.NumNodes(), detected.NumNodes());
+        for (size_t node = 0; node < detected.NumNodes(); ++node) EXPECT_EQ(restored.Cpus(node), detected.Cpus(node));
+    }).join();
+    EXPECT_FALSE(detected.PinCurrentThread(detected.NumNodes())); // No such node
+}
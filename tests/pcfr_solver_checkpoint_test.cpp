@@ -0,0 +1,268 @@
+#include "gtest/gtest.h"
+#include "solver/PCfrSolver.h"
+#include "toy_spot.h"
+#include "nodes/ActionNode.h"
+#include "ranges/PrivateCards.h"
+#include "tools/Rule.h"
+#include "Deck.h"
+#include "Card.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Use namespaces
+using namespace poker_solver::core;
+using namespace poker_solver::config;
+using namespace poker_solver::nodes;
+using namespace poker_solver::ranges;
+using namespace poker_solver::solver;
+using namespace poker_solver::tree;
+
+// PCfrSolver::SaveCheckpoint/LoadCheckpoint on a small turn spot.
+class PCfrSolverCheckpointTest : public ::testing::Test {
+ protected:
+  Deck deck_;
+  std::vector<int> board_ = test_support::TurnBoard();
+  std::unique_ptr<Rule> rule_;
+  std::string path_;
+
+  void SetUp() override {
+      rule_ = std::make_unique<Rule>(test_support::MakeSpotRule(deck_, board_));
+      path_ = ::testing::TempDir() + "pcfr_solver_checkpoint_test.bin";
+  }
+
+  void TearDown() override { std::remove(path_.c_str()); }
+
+  std::vector<PrivateCards> MakeRange(int first_card, int last_card) const {
+      return test_support::MakeRange(first_card, last_card, board_);
+  }
+
+  // Fresh tree and (untrained) solver for 'config'; 'last_card' bounds player 1's range.
+  std::unique_ptr<PCfrSolver> MakeSolver(PCfrSolver::Config config, int last_card = 24) const {
+      config.num_threads = 1;
+      return test_support::MakeToySolver(*rule_, {MakeRange(0, 16), MakeRange(8, last_card)}, config);
+  }
+
+  // Trains 'config' straight to 'total' iterations, and separately to
+  // 'split', through a checkpoint into a fresh solver, then on to 'total'.
+  void ExpectResumeMatchesStraightRun(PCfrSolver::Config config, int split, int total) {
+      config.iteration_limit = total;
+      auto straight = MakeSolver(config);
+      straight->Train();
+
+      config.iteration_limit = split;
+      auto first = MakeSolver(config);
+      first->Train();
+      first->SaveCheckpoint(path_);
+
+      config.iteration_limit = total;
+      auto resumed = MakeSolver(config);
+      resumed->LoadCheckpoint(path_);
+      EXPECT_EQ(resumed->GetCompletedIterations(), split);
+      resumed->Train();
+      EXPECT_EQ(resumed->GetCompletedIterations(), total);
+      EXPECT_EQ(resumed->DumpStrategy(false), straight->DumpStrategy(false));
+  }
+};
+
+TEST_F(PCfrSolverCheckpointTest, ResumeMatchesStraightRun) {
+    PCfrSolver::Config config;
+    ExpectResumeMatchesStraightRun(config, 10, 20);
+}
+
+TEST_F(PCfrSolverCheckpointTest, ResumeMatchesStraightRunForCompactTrainers) {
+    PCfrSolver::Config config;
+    config.precision = ActionNode::TrainablePrecision::kHalf;
+    ExpectResumeMatchesStraightRun(config, 7, 15);
+    config.precision = ActionNode::TrainablePrecision::kSingle;
+    config.trainer = PCfrSolver::Trainer::kCfrPlus;
+    ExpectResumeMatchesStraightRun(config, 7, 15);
+}
+
+TEST_F(PCfrSolverCheckpointTest, BackgroundCheckpointsHoldTheLatestState) {
+    PCfrSolver::Config config;
+    config.iteration_limit = 10;
+    config.checkpoint_interval = 4;
+    config.checkpoint_path = path_;
+    auto solver = MakeSolver(config);
+    solver->Train();
+    // The last one, after iteration 10, was written before Train returned.
+    const std::string saved_path = path_ + ".saved";
+    solver->SaveCheckpoint(saved_path);
+    std::ifstream background(path_, std::ios::binary);
+    std::ifstream saved(saved_path, std::ios::binary);
+    const std::string background_bytes((std::istreambuf_iterator<char>(background)), std::istreambuf_iterator<char>());
+    const std::string saved_bytes((std::istreambuf_iterator<char>(saved)), std::istreambuf_iterator<char>());
+    std::remove(saved_path.c_str());
+    EXPECT_FALSE(background_bytes.empty());
+    EXPECT_EQ(background_bytes, saved_bytes);
+    EXPECT_FALSE(std::ifstream(path_ + ".tmp").good());
+
+    config.checkpoint_path = ::testing::TempDir() + "missing_directory/checkpoint.bin";
+    EXPECT_THROW(MakeSolver(config)->Train(), std::runtime_error);
+    config.checkpoint_path.clear();
+    EXPECT_THROW(MakeSolver(config), std::invalid_argument);
+}
+
+TEST_F(PCfrSolverCheckpointTest, CompressedCheckpointsAreSmallAndResumeClose) {
+    PCfrSolver::Config config;
+    config.iteration_limit = 30;
+    auto solver = MakeSolver(config);
+    solver->Train();
+    solver->SaveCheckpoint(path_);
+    const std::string compressed_path = path_ + ".compressed";
+    PCfrSolver::Config compressed = config;
+    compressed.compressed_checkpoints = true;
+    auto compressing = MakeSolver(compressed);
+    compressing->LoadCheckpoint(path_);
+    compressing->SaveCheckpoint(compressed_path);
+    auto file_size = [](const std::string& path) {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        return static_cast<size_t>(in.tellg());
+    };
+    EXPECT_LT(file_size(compressed_path) * 4, file_size(path_));
+
+    // Either config reads either format. Every hand's regrets come back
+    // within 1/32768 of its largest, and the solve plays close to the
+    // original.
+    auto restored = MakeSolver(config);
+    restored->LoadCheckpoint(compressed_path);
+    EXPECT_EQ(restored->GetCompletedIterations(), 30);
+    const ActionNode& original_root = solver->FindActionNode({});
+    const ActionNode& restored_root = restored->FindActionNode({});
+    const size_t num_actions = original_root.GetActions().size();
+    std::vector<double> original_regrets(num_actions), restored_regrets(num_actions), sums(num_actions);
+    for (size_t h = 0; h < original_root.GetPlayerRangeRaw()->size(); ++h) {
+        original_root.GetTrainableIfExists(0)->GetHandState(h, original_regrets.data(), sums.data());
+        restored_root.GetTrainableIfExists(0)->GetHandState(h, restored_regrets.data(), sums.data());
+        double largest = 0.0;
+        for (double regret : original_regrets) largest = std::max(largest, std::abs(regret));
+        for (size_t a = 0; a < num_actions; ++a) {
+            EXPECT_NEAR(restored_regrets[a], original_regrets[a], largest / 32768.0) << h;
+        }
+    }
+    const double exploitability = solver->ComputeExploitability();
+    EXPECT_NEAR(restored->ComputeExploitability(), exploitability, 0.05 * exploitability + 1e-3);
+    config.iteration_limit = 40;
+    auto resumed = MakeSolver(config);
+    resumed->LoadCheckpoint(compressed_path);
+    resumed->Train();
+    EXPECT_EQ(resumed->GetCompletedIterations(), 40);
+    EXPECT_LT(resumed->ComputeExploitability(), exploitability);
+
+    std::string bytes;
+    {
+        std::ifstream in(compressed_path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream out(compressed_path, std::ios::binary | std::ios::trunc);
+        out << bytes.substr(0, bytes.size() - 1); // Ends inside the last chunk
+    }
+    EXPECT_THROW(MakeSolver(config)->LoadCheckpoint(compressed_path), std::runtime_error);
+    std::remove(compressed_path.c_str());
+}
+
+TEST_F(PCfrSolverCheckpointTest, RejectsMismatchingCheckpoints) {
+    PCfrSolver::Config config;
+    config.iteration_limit = 3;
+    auto solver = MakeSolver(config);
+    solver->Train();
+    solver->SaveCheckpoint(path_);
+
+    // Different range, so a different fingerprint.
+    EXPECT_THROW(MakeSolver(config, 20)->LoadCheckpoint(path_), std::runtime_error);
+    // Different trainer.
+    PCfrSolver::Config cfr_plus = config;
+    cfr_plus.trainer = PCfrSolver::Trainer::kCfrPlus;
+    EXPECT_THROW(MakeSolver(cfr_plus)->LoadCheckpoint(path_), std::runtime_error);
+    // Same setup still loads.
+    EXPECT_NO_THROW(MakeSolver(config)->LoadCheckpoint(path_));
+}
+
+TEST_F(PCfrSolverCheckpointTest, RejectsCorruptOrTruncatedFiles) {
+    PCfrSolver::Config config;
+    config.iteration_limit = 3;
+    auto solver = MakeSolver(config);
+    solver->Train();
+    solver->SaveCheckpoint(path_);
+
+    std::string bytes;
+    {
+        std::ifstream in(path_, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    auto write = [&](const std::string& contents) {
+        std::ofstream out(path_, std::ios::binary | std::ios::trunc);
+        out << contents;
+    };
+
+    write(bytes.substr(0, bytes.size() - 1));
+    EXPECT_THROW(MakeSolver(config)->LoadCheckpoint(path_), std::runtime_error);
+    write(bytes + "x");
+    EXPECT_THROW(MakeSolver(config)->LoadCheckpoint(path_), std::runtime_error);
+    std::string bad_magic = bytes;
+    bad_magic[0] = 'X';
+    write(bad_magic);
+    EXPECT_THROW(MakeSolver(config)->LoadCheckpoint(path_), std::runtime_error);
+    EXPECT_THROW(MakeSolver(config)->LoadCheckpoint(path_ + ".missing"), std::runtime_error);
+}
+
+TEST_F(PCfrSolverCheckpointTest, WarmStartFromCheckpointConvergesFaster) {
+    PCfrSolver::Config config;
+    config.iteration_limit = 60;
+    auto prior = MakeSolver(config);
+    prior->Train();
+    prior->SaveCheckpoint(path_);
+
+    // The prior as a nightly job would see it: rebuilt and restored.
+    auto restored = MakeSolver(config);
+    restored->LoadCheckpoint(path_);
+
+    // Player 1's range loses some hands; the rest map by hole cards.
+    config.iteration_limit = 10;
+    auto cold = MakeSolver(config, 23);
+    cold->Train();
+    config.iteration_limit = 60 + 10;
+    auto warm = MakeSolver(config, 23);
+    EXPECT_GT(warm->WarmStartFrom(*restored), 0u);
+    EXPECT_EQ(warm->GetCompletedIterations(), 60);
+    warm->Train();
+    EXPECT_EQ(warm->GetCompletedIterations(), 70);
+    EXPECT_LT(warm->ComputeExploitability(), 0.5 * cold->ComputeExploitability());
+}
+
+TEST_F(PCfrSolverCheckpointTest, WarmStartAcrossTrainers) {
+    PCfrSolver::Config config;
+    config.iteration_limit = 30;
+    auto prior = MakeSolver(config);
+    prior->Train();
+
+    // Same spot, half-precision CFR+: a few iterations from the copied
+    // regrets beat as many from scratch by far.
+    PCfrSolver::Config cfr_plus = config;
+    cfr_plus.precision = ActionNode::TrainablePrecision::kHalf;
+    cfr_plus.trainer = PCfrSolver::Trainer::kCfrPlus;
+    cfr_plus.iteration_limit = 3;
+    auto cold = MakeSolver(cfr_plus);
+    cold->Train();
+    cfr_plus.iteration_limit = 30 + 3;
+    auto warm = MakeSolver(cfr_plus);
+    warm->WarmStartFrom(*prior);
+    warm->Train();
+    EXPECT_LT(warm->ComputeExploitability(), 0.1 * cold->ComputeExploitability());
+}
+
+TEST_F(PCfrSolverCheckpointTest, WarmStartRejectsOtherBoards) {
+    PCfrSolver::Config config;
+    auto solver = MakeSolver(config);
+    board_[3] = Card::StringToInt("8s").value();
+    rule_ = std::make_unique<Rule>(test_support::MakeSpotRule(deck_, board_));
+    EXPECT_THROW(MakeSolver(config)->WarmStartFrom(*solver), std::invalid_argument);
+}
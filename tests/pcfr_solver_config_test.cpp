@@ -0,0 +1,551 @@
+#include "gtest/gtest.h"
+#include "solver/PCfrSolver.h"
+#include "toy_spot.h"
+#include "nodes/ActionNode.h"
+#include "ranges/PrivateCardsManager.h"
+#include "ranges/RiverRangeManager.h"
+#include "ranges/PrivateCards.h"
+#include "tools/Rule.h"
+#include "trainable/CFRPlus.h"
+#include "GameTree.h"
+#include "Deck.h"
+#include "Card.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Use namespaces
+using namespace poker_solver::core;
+using namespace poker_solver::config;
+using namespace poker_solver::nodes;
+using namespace poker_solver::ranges;
+using namespace poker_solver::solver;
+using namespace poker_solver::tree;
+
+// Behaviour of the optional PCfrSolver::Config switches on a small turn spot.
+class PCfrSolverConfigTest : public ::testing::Test {
+ protected:
+  Deck deck_;
+  std::vector<int> board_ = test_support::TurnBoard();
+  std::unique_ptr<Rule> rule_;
+  std::shared_ptr<GameTree> tree_;
+  std::shared_ptr<PrivateCardsManager> pcm_;
+  std::shared_ptr<RiverRangeManager> rrm_;
+  std::unique_ptr<PCfrSolver> solver_;
+
+  void SetUp() override {
+      rule_ = std::make_unique<Rule>(test_support::MakeSpotRule(deck_, board_));
+  }
+
+  std::vector<PrivateCards> MakeRange(int first_card, int last_card) const {
+      return test_support::MakeRange(first_card, last_card, board_);
+  }
+
+  // Builds a fresh tree and untrained solver in tree_/solver_ (and pcm_/rrm_).
+  void MakeSolver(const PCfrSolver::Config& config) {
+      tree_ = std::make_shared<GameTree>(*rule_);
+      pcm_ = test_support::MakeRangeManager(*rule_, {MakeRange(0, 16), MakeRange(8, 24)});
+      rrm_ = test_support::MakeToyRiverRanges();
+      solver_ = test_support::MakeToySolver(*rule_, pcm_, config, tree_, rrm_);
+  }
+
+  // Builds a fresh tree and solver in tree_/solver_ and trains it.
+  void Solve(PCfrSolver::Config config) {
+      config.num_threads = 1;
+      MakeSolver(config);
+      solver_->Train();
+  }
+
+  std::shared_ptr<ActionNode> Root() const {
+      return std::dynamic_pointer_cast<ActionNode>(tree_->GetRoot());
+  }
+
+  // First child of the root that is an action node of the other player.
+  std::shared_ptr<ActionNode> ResponseNode() const {
+      for (const auto& child : Root()->GetChildren()) {
+          auto action = std::dynamic_pointer_cast<ActionNode>(child);
+          if (action && action->GetPlayerIndex() != Root()->GetPlayerIndex()) return action;
+      }
+      return nullptr;
+  }
+};
+
+TEST_F(PCfrSolverConfigTest, SimultaneousUpdatesTrainBothPlayersInOnePass) {
+    PCfrSolver::Config config;
+    config.iteration_limit = 1;
+    config.update_scheme = PCfrSolver::UpdateScheme::kAlternating;
+    Solve(config);
+    ASSERT_NE(ResponseNode(), nullptr);
+    ASSERT_EQ(ResponseNode()->GetPlayerIndex(), 0u);
+    std::vector<double> alternating_root = Root()->GetTrainableIfExists(0)->GetCurrentStrategy();
+    std::vector<double> alternating_response = ResponseNode()->GetTrainableIfExists(0)->GetCurrentStrategy();
+
+    config.update_scheme = PCfrSolver::UpdateScheme::kSimultaneous;
+    Solve(config);
+    ASSERT_NE(Root()->GetTrainableIfExists(0), nullptr);
+    ASSERT_NE(ResponseNode()->GetTrainableIfExists(0), nullptr);
+    // Strategies from the first iteration's regrets. Player 0 goes first in
+    // the alternating scheme, so both schemes show it the same uniform opponent.
+    EXPECT_EQ(ResponseNode()->GetTrainableIfExists(0)->GetCurrentStrategy(), alternating_response);
+    // Player 1 only sees player 0's update in the alternating scheme.
+    EXPECT_NE(Root()->GetTrainableIfExists(0)->GetCurrentStrategy(), alternating_root);
+}
+
+TEST_F(PCfrSolverConfigTest, ExploitabilityShrinksWithTraining) {
+    PCfrSolver::Config config;
+    config.iteration_limit = 1;
+    Solve(config);
+    double after_one = solver_->ComputeExploitability();
+    EXPECT_DOUBLE_EQ(solver_->GetLastExploitability(), after_one);
+
+    config.iteration_limit = 200;
+    Solve(config);
+    EXPECT_LT(solver_->GetLastExploitability(), 0.0); // Nothing measured yet
+    double after_many = solver_->ComputeExploitability();
+    // Each best response is at least the value of the average profile, and
+    // those sum to zero.
+    EXPECT_GE(after_many, -1e-9);
+    EXPECT_GT(after_one, 5.0);
+    EXPECT_LT(after_many, 0.05);
+    const auto& values = solver_->GetBestResponseValues();
+    EXPECT_NEAR(values[0] + values[1], 2.0 * after_many / 100.0 * Root()->GetPot(), 1e-9);
+}
+
+TEST_F(PCfrSolverConfigTest, TargetExploitabilityStopsEarly) {
+    PCfrSolver::Config config;
+    config.iteration_limit = 1000;
+    config.exploitability_interval = 2;
+    config.target_exploitability = 1.0;
+    Solve(config);
+    double reported = solver_->GetLastExploitability();
+    EXPECT_GE(reported, 0.0);
+    EXPECT_LE(reported, 1.0);
+    // Training stopped at the check: the strategies are the ones it measured.
+    EXPECT_NEAR(solver_->ComputeExploitability(), reported, 1e-12);
+
+    // The checks accumulate the average even between average_interval-th
+    // iterations, so sparse averaging still reaches the target early.
+    const int every_iteration_stop = solver_->GetCompletedIterations();
+    config.average_interval = config.iteration_limit;
+    Solve(config);
+    EXPECT_LT(solver_->GetCompletedIterations(), 2 * every_iteration_stop);
+    EXPECT_LE(solver_->GetLastExploitability(), 1.0);
+    EXPECT_NEAR(solver_->ComputeExploitability(), solver_->GetLastExploitability(), 1e-12);
+    config.average_interval = 1;
+
+    config.exploitability_interval = 0;
+    Solve(config);
+    EXPECT_LT(solver_->ComputeExploitability(), reported / 10.0);
+}
+
+TEST_F(PCfrSolverConfigTest, RegretPruningKeepsConverging) {
+    PCfrSolver::Config config;
+    config.iteration_limit = 200;
+    Solve(config);
+    std::vector<double> unpruned = Root()->GetTrainableIfExists(0)->GetAverageStrategy();
+    EXPECT_LT(solver_->ComputeExploitability(), 0.01);
+
+    config.regret_pruning = true;
+    config.pruning_warmup_iterations = 5;
+    config.pruning_full_pass_interval = 10;
+    Solve(config);
+    // Some lines were skipped, so the solution differs slightly...
+    std::vector<double> pruned = Root()->GetTrainableIfExists(0)->GetAverageStrategy();
+    ASSERT_EQ(pruned.size(), unpruned.size());
+    double max_difference = 0.0;
+    for (size_t i = 0; i < pruned.size(); ++i) {
+        max_difference = std::max(max_difference, std::abs(pruned[i] - unpruned[i]));
+    }
+    EXPECT_GT(max_difference, 1e-9);
+    // ...but the full passes keep it converging.
+    EXPECT_LT(solver_->ComputeExploitability(), 0.01);
+}
+
+TEST_F(PCfrSolverConfigTest, RegretPruningWithFullPassesOnlyChangesNothing) {
+    PCfrSolver::Config config;
+    config.iteration_limit = 30;
+    Solve(config);
+    std::vector<double> unpruned = Root()->GetTrainableIfExists(0)->GetAverageStrategy();
+
+    config.regret_pruning = true;
+    config.pruning_warmup_iterations = 0;
+    config.pruning_full_pass_interval = 1; // Every iteration is a full pass
+    Solve(config);
+    EXPECT_EQ(Root()->GetTrainableIfExists(0)->GetAverageStrategy(), unpruned);
+}
+
+TEST_F(PCfrSolverConfigTest, DcfrParametersAreConfigurable) {
+    PCfrSolver::Config config;
+    config.iteration_limit = 100;
+    Solve(config);
+    std::vector<double> default_average = Root()->GetTrainableIfExists(0)->GetAverageStrategy();
+
+    // Linear CFR weighting.
+    config.dcfr.alpha = 1.0;
+    config.dcfr.beta = 1.0;
+    config.dcfr.gamma = 1.0;
+    Solve(config);
+    EXPECT_NE(Root()->GetTrainableIfExists(0)->GetAverageStrategy(), default_average);
+    EXPECT_LT(solver_->ComputeExploitability(), 0.5);
+}
+
+TEST_F(PCfrSolverConfigTest, AllTrainersConverge) {
+    PCfrSolver::Config config;
+    config.iteration_limit = 200;
+    for (auto trainer : {PCfrSolver::Trainer::kDiscounted, PCfrSolver::Trainer::kLinear,
+                         PCfrSolver::Trainer::kCfrPlus}) {
+        config.trainer = trainer;
+        Solve(config);
+        EXPECT_LT(solver_->ComputeExploitability(), 0.05) << static_cast<int>(trainer);
+    }
+    // Still the last solve.
+    EXPECT_NE(std::dynamic_pointer_cast<CfrPlusTrainableSF>(Root()->GetTrainableIfExists(0)), nullptr);
+}
+
+TEST_F(PCfrSolverConfigTest, LazyStrategiesMatchResidentStrategies) {
+    PCfrSolver::Config config;
+    config.iteration_limit = 30;
+    Solve(config);
+    json resident = solver_->DumpStrategy(false);
+    double resident_exploitability = solver_->ComputeExploitability();
+
+    config.lazy_strategies = true;
+    Solve(config);
+    EXPECT_EQ(solver_->DumpStrategy(false), resident);
+    EXPECT_EQ(solver_->ComputeExploitability(), resident_exploitability);
+}
+
+TEST_F(PCfrSolverConfigTest, RiverCacheWarmupPreloadsEveryRiver) {
+    PCfrSolver::Config config;
+    config.iteration_limit = 5;
+    config.warmup_river_cache = false;
+    Solve(config);
+    json lazy = solver_->DumpStrategy(false);
+    EXPECT_EQ(rrm_->GetNumPreloadedBoards(), 0u);
+    EXPECT_GT(rrm_->GetCacheStats().misses, 0u);
+
+    config.warmup_river_cache = true;
+    Solve(config);
+    EXPECT_EQ(rrm_->GetNumPreloadedBoards(), 48u); // One per river card
+    EXPECT_EQ(rrm_->GetCacheStats().misses, 0u);   // Nothing left for the lazy cache
+    EXPECT_EQ(solver_->DumpStrategy(false), lazy);
+}
+
+
+TEST_F(PCfrSolverConfigTest, ProgressQueueGetsEveryIteration) {
+    PCfrSolver::Config config;
+    config.iteration_limit = 6;
+    config.exploitability_interval = 4;
+    config.num_threads = 1;
+    MakeSolver(config);
+    auto queue = std::make_shared<SolverProgressQueue>(16);
+    solver_->SetProgressQueue(queue);
+    solver_->Train();
+
+    std::vector<SolverProgress> reports;
+    while (auto progress = queue->Pop()) reports.push_back(*progress);
+    ASSERT_EQ(reports.size(), 6u);
+    for (size_t i = 0; i < reports.size(); ++i) {
+        EXPECT_EQ(reports[i].iteration, static_cast<int>(i) + 1);
+        EXPECT_GE(reports[i].elapsed_seconds, i > 0 ? reports[i - 1].elapsed_seconds : 0.0);
+        // Measured after iteration 4 and the last one only.
+        if (i == 3 || i == 5) {
+            EXPECT_GE(reports[i].exploitability, 0.0);
+        } else {
+            EXPECT_LT(reports[i].exploitability, 0.0);
+        }
+    }
+    EXPECT_DOUBLE_EQ(reports.back().exploitability, solver_->GetLastExploitability());
+    EXPECT_EQ(queue->Dropped(), 0u);
+}
+
+TEST_F(PCfrSolverConfigTest, StopBeforeTrainSkipsTraining) {
+    PCfrSolver::Config config;
+    config.iteration_limit = 5;
+    config.num_threads = 1;
+    MakeSolver(config);
+    solver_->Stop();
+    solver_->Train();
+    EXPECT_EQ(solver_->GetCompletedIterations(), 0);
+    // The request was used up; training again runs to the limit.
+    solver_->Train();
+    EXPECT_EQ(solver_->GetCompletedIterations(), 5);
+}
+
+TEST_F(PCfrSolverConfigTest, MemoryEstimateBoundsASolve) {
+    PCfrSolver::Config config;
+    config.iteration_limit = 2;
+    config.warmup_river_cache = false; // Fill the lazy cache, which keeps stats
+    Solve(config);
+    const std::array<size_t, 2> range_sizes = {MakeRange(0, 16).size(), MakeRange(8, 24).size()};
+    PCfrSolver::MemoryEstimate estimate = PCfrSolver::EstimateMemory(*tree_, *rule_, range_sizes, config);
+
+    EXPECT_EQ(estimate.trainable_bytes, tree_->EstimateTrainableMemory(range_sizes[0], range_sizes[1]));
+    EXPECT_GT(estimate.tree_bytes, tree_->EstimateTreeMemory());
+    // Training reached every river board; the estimate covers them all.
+    RiverCacheStats cache = rrm_->GetCacheStats();
+    EXPECT_EQ(cache.entries, 2u * 48u);
+    EXPECT_GE(estimate.river_cache_bytes, cache.bytes);
+    EXPECT_LT(estimate.river_cache_bytes, 2 * cache.bytes);
+    EXPECT_EQ(estimate.Total(), estimate.tree_bytes + estimate.trainable_bytes + estimate.river_cache_bytes +
+                                    estimate.scratch_bytes);
+
+    config.num_threads = 4;
+    EXPECT_EQ(PCfrSolver::EstimateMemory(*tree_, *rule_, range_sizes, config).scratch_bytes,
+              4 * estimate.scratch_bytes);
+    config.precision = ActionNode::TrainablePrecision::kHalf;
+    EXPECT_LT(PCfrSolver::EstimateMemory(*tree_, *rule_, range_sizes, config).trainable_bytes,
+              estimate.trainable_bytes);
+}
+
+TEST_F(PCfrSolverConfigTest, MemoryStatsCountWhatTrainingCreated) {
+    PCfrSolver::Config config;
+    config.iteration_limit = 2;
+    config.memory_log_interval = 1;
+    Solve(config);
+
+    const PCfrSolver::MemoryStats stats = solver_->GetMemoryStats();
+    const PCfrSolver::MemoryEstimate estimate =
+        PCfrSolver::EstimateMemory(*tree_, *rule_, {MakeRange(0, 16).size(), MakeRange(8, 24).size()}, config);
+    EXPECT_GT(stats.tree_bytes, 0u);
+    EXPECT_GT(stats.trainable_count, 0u);
+    EXPECT_GT(stats.trainable_bytes, 0u);
+    EXPECT_LE(stats.trainable_bytes, estimate.trainable_bytes);
+    // The warmup preloaded every river board.
+    EXPECT_EQ(stats.river_cache_bytes, rrm_->GetPreloadedBytes());
+    EXPECT_GT(stats.river_cache_bytes, 0u);
+    EXPECT_LE(stats.river_cache_bytes, estimate.river_cache_bytes);
+    EXPECT_EQ(stats.Total(), stats.tree_bytes + stats.trainable_bytes + stats.river_cache_bytes);
+}
+
+TEST_F(PCfrSolverConfigTest, ChanceSamplingGivesAnApproximateSolve) {
+    PCfrSolver::Config config;
+    config.iteration_limit = 30;
+    Solve(config);
+    json enumerated = solver_->DumpStrategy(false);
+
+    // Drawing every outcome is enumeration.
+    config.sampled_chance_outcomes = 48;
+    Solve(config);
+    EXPECT_EQ(solver_->DumpStrategy(false), enumerated);
+
+    config.iteration_limit = 400;
+    config.sampled_chance_outcomes = 4;
+    Solve(config);
+    json sampled = solver_->DumpStrategy(false);
+    EXPECT_NE(sampled, enumerated);
+    EXPECT_LT(solver_->ComputeExploitability(), 1.0);
+
+    // The draws follow the seed.
+    Solve(config);
+    EXPECT_EQ(solver_->DumpStrategy(false), sampled);
+    config.sampling_seed = 7;
+    Solve(config);
+    EXPECT_NE(solver_->DumpStrategy(false), sampled);
+}
+
+TEST_F(PCfrSolverConfigTest, ChanceSamplingRejectsIsomorphism) {
+    PCfrSolver::Config config;
+    config.sampled_chance_outcomes = 4;
+    config.use_isomorphism = true;
+    EXPECT_THROW(Solve(config), std::invalid_argument);
+    config.use_isomorphism = false;
+    config.sampled_chance_outcomes = -1;
+    EXPECT_THROW(Solve(config), std::invalid_argument);
+}
+
+TEST_F(PCfrSolverConfigTest, OutOfCoreTrainablesMatchResidentOnes) {
+    PCfrSolver::Config config;
+    config.iteration_limit = 20;
+    Solve(config);
+    json resident = solver_->DumpStrategy(false);
+
+    // Every action node of this spot is on the turn.
+    config.trainable_file_directory = ::testing::TempDir();
+    config.trainable_file_round = GameRound::kTurn;
+    Solve(config);
+    EXPECT_EQ(solver_->DumpStrategy(false), resident);
+
+    const std::array<size_t, 2> range_sizes = {MakeRange(0, 16).size(), MakeRange(8, 24).size()};
+    const uint64_t total = tree_->EstimateTrainableMemory(range_sizes[0], range_sizes[1]);
+    GameTree::TrainableMemorySplit split =
+        tree_->EstimateTrainableMemorySplit(range_sizes[0], range_sizes[1], GameRound::kTurn);
+    EXPECT_EQ(split.on_disk_bytes, total);
+    EXPECT_EQ(split.resident_bytes, 0u);
+    EXPECT_EQ(PCfrSolver::EstimateMemory(*tree_, *rule_, range_sizes, config).trainable_file_bytes, total);
+    split = tree_->EstimateTrainableMemorySplit(range_sizes[0], range_sizes[1], GameRound::kRiver);
+    EXPECT_EQ(split.on_disk_bytes, 0u);
+    EXPECT_EQ(split.resident_bytes, total);
+    split = tree_->EstimateTrainableMemorySplit(range_sizes[0], range_sizes[1], GameRound::kTurn,
+                                                ActionNode::TrainablePrecision::kHalf);
+    EXPECT_EQ(split.on_disk_bytes, 0u); // Only double tables go to the file
+
+    config.trainable_file_directory = "/nonexistent/trainables";
+    EXPECT_THROW(Solve(config), std::runtime_error);
+}
+
+TEST_F(PCfrSolverConfigTest, SparseTrainablesKeepTheSolveClose) {
+    // The root player only checks three hands, so its node facing a bet
+    // after checking has few live hands.
+    auto solve_locked = [&](PCfrSolver::Config config) {
+        config.num_threads = 1;
+        MakeSolver(config);
+        const ActionNode& root = *Root();
+        const size_t num_hands = root.GetPlayerRangeRaw()->size();
+        const size_t num_actions = root.GetActions().size();
+        size_t bet = 0;
+        while (root.GetActions()[bet].GetAction() != PokerAction::kBet) ++bet;
+        std::vector<double> strategy(num_hands * num_actions, 0.0);
+        for (size_t h = 0; h < num_hands; ++h) strategy[h * num_actions + (h < 3 ? 0 : bet)] = 1.0;
+        solver_->LockNode({}, strategy);
+        solver_->Train();
+    };
+    PCfrSolver::Config config;
+    config.iteration_limit = 200;
+    solve_locked(config);
+    const double dense_exploitability = solver_->ComputeExploitability();
+    const PCfrSolver::MemoryStats dense_memory = solver_->GetMemoryStats();
+
+    config.sparse_trainable_warmup = 50;
+    solve_locked(config);
+    const PCfrSolver::MemoryStats sparse_memory = solver_->GetMemoryStats();
+    EXPECT_EQ(sparse_memory.trainable_count, dense_memory.trainable_count);
+    EXPECT_LT(sparse_memory.trainable_bytes, dense_memory.trainable_bytes);
+    EXPECT_NEAR(solver_->ComputeExploitability(), dense_exploitability, 1e-3);
+
+    config.precision = ActionNode::TrainablePrecision::kSingle;
+    EXPECT_THROW(Solve(config), std::invalid_argument);
+    config.precision = ActionNode::TrainablePrecision::kFloat;
+    config.sparse_trainable_warmup = -1;
+    EXPECT_THROW(Solve(config), std::invalid_argument);
+}
+
+// Leaving out the first iterations and accumulating every few iterations
+// barely moves the solve; before averaging starts the strategy sums are
+// not even allocated, and the average strategy is uniform.
+TEST_F(PCfrSolverConfigTest, DelayedAveragingKeepsTheSolveClose) {
+    PCfrSolver::Config config;
+    config.iteration_limit = 200;
+    Solve(config);
+    const double every_iteration = solver_->ComputeExploitability();
+
+    config.average_warmup_iterations = 20;
+    config.average_interval = 3;
+    Solve(config);
+    EXPECT_NEAR(solver_->ComputeExploitability(), every_iteration, 0.25 * every_iteration);
+
+    config.iteration_limit = 5;
+    config.average_warmup_iterations = 0;
+    config.average_interval = 1;
+    Solve(config);
+    const PCfrSolver::MemoryStats eager_memory = solver_->GetMemoryStats();
+    config.average_warmup_iterations = 10;
+    Solve(config);
+    const PCfrSolver::MemoryStats deferred_memory = solver_->GetMemoryStats();
+    EXPECT_EQ(deferred_memory.trainable_count, eager_memory.trainable_count);
+    EXPECT_LT(deferred_memory.trainable_bytes, eager_memory.trainable_bytes);
+    const ActionNode& root = solver_->FindActionNode({});
+    const std::vector<double> average = root.GetTrainableIfExists(0)->GetAverageStrategy();
+    for (double probability : average) EXPECT_DOUBLE_EQ(probability, 1.0 / root.GetActions().size());
+
+    config.average_interval = 0;
+    EXPECT_THROW(Solve(config), std::invalid_argument);
+    config.average_interval = 1;
+    config.average_warmup_iterations = -1;
+    EXPECT_THROW(Solve(config), std::invalid_argument);
+}
+
+// EVs come from a pass of their own over the requested depth only. Folding
+// forfeits the same chips with every hand.
+TEST_F(PCfrSolverConfigTest, ComputeEvsFillsTheRequestedDepth) {
+    PCfrSolver::Config config;
+    config.iteration_limit = 50;
+    Solve(config);
+    std::shared_ptr<ActionNode> facing_bet;
+    size_t fold = 0;
+    for (const auto& child : Root()->GetChildren()) {
+        auto action = std::dynamic_pointer_cast<ActionNode>(child);
+        if (!action) continue;
+        for (size_t a = 0; a < action->GetActions().size(); ++a) {
+            if (action->GetActions()[a].GetAction() != PokerAction::kFold) continue;
+            facing_bet = action;
+            fold = a;
+        }
+    }
+    ASSERT_NE(facing_bet, nullptr);
+    EXPECT_FALSE(solver_->EvsCalculated());
+    EXPECT_TRUE(Root()->GetTrainableIfExists(0)->GetEvs().empty());
+
+    const std::vector<double> strategy_before = Root()->GetTrainableIfExists(0)->GetAverageStrategy();
+    solver_->ComputeEvs(0);
+    EXPECT_TRUE(solver_->EvsCalculated());
+    EXPECT_EQ(Root()->GetTrainableIfExists(0)->GetEvs().size(), strategy_before.size());
+    EXPECT_EQ(Root()->GetTrainableIfExists(0)->GetAverageStrategy(), strategy_before);
+    EXPECT_TRUE(facing_bet->GetTrainableIfExists(0)->GetEvs().empty());
+
+    solver_->ComputeEvs(1);
+    const size_t num_actions = facing_bet->GetActions().size();
+    const std::vector<double> evs = facing_bet->GetTrainableIfExists(0)->GetEvs();
+    ASSERT_EQ(evs.size() % num_actions, 0u);
+    ASSERT_GT(evs.size(), 0u);
+    for (size_t h = 0; h < evs.size() / num_actions; ++h) {
+        EXPECT_NEAR(evs[h * num_actions + fold], evs[fold], 1e-9);
+    }
+    EXPECT_LT(evs[fold], 0.0);
+    EXPECT_TRUE(solver_->DumpStrategy(true, 1)["strategy_data"].contains("evs"));
+
+    solver_->Train();
+    EXPECT_FALSE(solver_->EvsCalculated());
+}
+
+TEST_F(PCfrSolverConfigTest, LiveSnapshotsFollowTraining) {
+    PCfrSolver::Config config;
+    config.iteration_limit = 40;
+    config.snapshot_interval = 5;
+    config.num_threads = 1;
+    MakeSolver(config);
+    EXPECT_EQ(solver_->GetStrategySnapshot(), nullptr);
+    EXPECT_THROW(solver_->SetSnapshotSubtree({"RAISE 1000"}), std::invalid_argument);
+    solver_->SetSnapshotSubtree({}, 1);
+
+    // A viewer polling while training sees whole snapshots, in order.
+    std::atomic<bool> done{false};
+    std::vector<int> seen;
+    std::thread viewer([&] {
+        while (!done) {
+            auto snapshot = solver_->GetStrategySnapshot();
+            if (snapshot && (seen.empty() || seen.back() != snapshot->iteration)) seen.push_back(snapshot->iteration);
+        }
+    });
+    solver_->Train();
+    done = true;
+    viewer.join();
+    EXPECT_TRUE(std::is_sorted(seen.begin(), seen.end()));
+    for (int iteration : seen) EXPECT_EQ(iteration % 5, 0);
+
+    auto snapshot = solver_->GetStrategySnapshot();
+    ASSERT_NE(snapshot, nullptr);
+    EXPECT_EQ(snapshot->iteration, 40);
+    // The root and its action children.
+    ASSERT_EQ(snapshot->nodes.size(), 1 + Root()->GetChildren().size());
+    EXPECT_TRUE(snapshot->nodes[0].path.empty());
+    const json dump = solver_->DumpStrategy(false);
+    for (const StrategySnapshot::Node& node : snapshot->nodes) {
+        const json* entry = &dump;
+        for (const std::string& step : node.path) entry = &(*entry)["children"][step];
+        ASSERT_EQ(node.actions, (*entry)["strategy_data"]["actions"].get<std::vector<std::string>>());
+        ASSERT_EQ(node.strategies.size(), 1u);
+        const auto& range = pcm_->GetPlayerRange(node.player);
+        for (size_t h = 0; h < range.size(); ++h) {
+            const std::vector<double> expected = (*entry)["strategy_data"]["strategy"][range[h].ToString()];
+            for (size_t a = 0; a < node.actions.size(); ++a) {
+                EXPECT_EQ(node.strategies[0][h * node.actions.size() + a], expected[a]);
+            }
+        }
+    }
+}
@@ -0,0 +1,224 @@
+#include "gtest/gtest.h"
+#include "solver/PCfrSolver.h"
+#include "solver/StrategyFile.h"
+#include "toy_spot.h"
+#include "compairer/ShortDeckCompairer.h"
+#include "nodes/ActionNode.h"
+#include "nodes/ChanceNode.h"
+#include "ranges/RiverRangeManager.h"
+#include "ranges/PrivateCards.h"
+#include "tools/Rule.h"
+#include "tools/GameTreeBuildingSettings.h"
+#include "tools/StreetSetting.h"
+#include "GameTree.h"
+#include "Deck.h"
+#include "Card.h"
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+// Use namespaces
+using namespace poker_solver::core;
+using namespace poker_solver::config;
+using namespace poker_solver::nodes;
+using namespace poker_solver::ranges;
+using namespace poker_solver::solver;
+using namespace poker_solver::tree;
+
+// Per-deal trainables on a flop spot: turn action nodes get one slot per card
+// that can come on the turn, filled lazily the first time that card is dealt.
+class PCfrSolverDealTest : public ::testing::Test {
+ protected:
+  Deck deck_;
+  std::vector<int> board_ = test_support::FlopBoard();
+  std::unique_ptr<Rule> rule_;
+  std::shared_ptr<GameTree> tree_;
+  std::unique_ptr<PCfrSolver> solver_;
+
+  void SetUp() override {
+      rule_ = std::make_unique<Rule>(test_support::MakeSpotRule(deck_, board_));
+      tree_ = std::make_shared<GameTree>(*rule_);
+      PCfrSolver::Config config;
+      config.iteration_limit = 4;
+      config.num_threads = 1;
+      solver_ = test_support::MakeToySolver(*rule_, {MakeRange(0, 16), MakeRange(8, 24)}, config, tree_);
+  }
+
+  std::vector<PrivateCards> MakeRange(int first_card, int last_card) const {
+      return test_support::MakeRange(first_card, last_card, board_);
+  }
+
+  // First action node directly below the turn chance node (depth-first).
+  static std::shared_ptr<ActionNode> FindTurnActionNode(const std::shared_ptr<GameTreeNode>& node) {
+      if (auto chance = std::dynamic_pointer_cast<ChanceNode>(node)) {
+          if (chance->GetRound() == GameRound::kTurn) {
+              return std::dynamic_pointer_cast<ActionNode>(chance->GetChild());
+          }
+          return nullptr;
+      }
+      if (auto action = std::dynamic_pointer_cast<ActionNode>(node)) {
+          for (const auto& child : action->GetChildren()) {
+              if (auto found = FindTurnActionNode(child)) return found;
+          }
+      }
+      return nullptr;
+  }
+
+  // Every action node directly below a turn chance node.
+  static void CollectTurnActionNodes(const std::shared_ptr<GameTreeNode>& node,
+                                     std::vector<std::shared_ptr<ActionNode>>& found) {
+      if (auto chance = std::dynamic_pointer_cast<ChanceNode>(node)) {
+          if (chance->GetRound() == GameRound::kTurn) {
+              if (auto action = std::dynamic_pointer_cast<ActionNode>(chance->GetChild())) found.push_back(action);
+          }
+          return;
+      }
+      if (auto action = std::dynamic_pointer_cast<ActionNode>(node)) {
+          for (const auto& child : action->GetChildren()) CollectTurnActionNodes(child, found);
+      }
+  }
+};
+
+TEST_F(PCfrSolverDealTest, DealSlotsFollowChanceNodes) {
+    auto root = std::dynamic_pointer_cast<ActionNode>(tree_->GetRoot());
+    ASSERT_NE(root, nullptr);
+    EXPECT_EQ(root->GetNumPossibleDeals(), 1u);
+
+    auto turn_node = FindTurnActionNode(tree_->GetRoot());
+    ASSERT_NE(turn_node, nullptr);
+    EXPECT_EQ(turn_node->GetNumPossibleDeals(), 49u); // 52 cards minus the 3 on the flop
+    for (size_t d = 0; d < turn_node->GetNumPossibleDeals(); ++d) {
+        EXPECT_EQ(turn_node->GetTrainableIfExists(d), nullptr); // Nothing allocated before training
+    }
+}
+
+TEST_F(PCfrSolverDealTest, TrainsOneStrategyPerTurnCard) {
+    ASSERT_NO_THROW(solver_->Train());
+    auto turn_node = FindTurnActionNode(tree_->GetRoot());
+    ASSERT_NE(turn_node, nullptr);
+
+    std::vector<std::shared_ptr<poker_solver::solver::Trainable>> trainables;
+    for (size_t d = 0; d < turn_node->GetNumPossibleDeals(); ++d) {
+        if (auto trainable = turn_node->GetTrainableIfExists(d)) trainables.push_back(trainable);
+    }
+    EXPECT_EQ(trainables.size(), 49u);
+
+    // Hand ranks depend on the board, so some turn cards must end up with
+    // different strategies. Lines the players stop taking keep uniform
+    // strategies, so look at every turn node.
+    std::vector<std::shared_ptr<ActionNode>> turn_nodes;
+    CollectTurnActionNodes(tree_->GetRoot(), turn_nodes);
+    bool any_difference = false;
+    for (const auto& node : turn_nodes) {
+        auto first = node->GetTrainableIfExists(0);
+        for (size_t d = 1; first && d < node->GetNumPossibleDeals(); ++d) {
+            auto trainable = node->GetTrainableIfExists(d);
+            if (trainable && trainable->GetAverageStrategy() != first->GetAverageStrategy()) any_difference = true;
+        }
+    }
+    EXPECT_TRUE(any_difference);
+}
+
+TEST_F(PCfrSolverDealTest, DumpKeysStrategiesByDealtCard) {
+    ASSERT_NO_THROW(solver_->Train());
+    json dump = solver_->DumpStrategy(false);
+    auto root = std::dynamic_pointer_cast<ActionNode>(tree_->GetRoot());
+    ASSERT_NE(root, nullptr);
+    ASSERT_TRUE(dump["strategy_data"].contains("strategy")); // Root: single deal, unchanged layout
+
+    // Follow CHECK, CHECK through the turn chance node.
+    const json& turn = dump["children"]["CHECK"]["children"]["CHECK"]["child"];
+    ASSERT_EQ(turn["node_type"], "Action");
+    const json& per_deal = turn["strategy_data"];
+    ASSERT_TRUE(per_deal.is_object());
+    EXPECT_EQ(per_deal.size(), 49u);
+    EXPECT_TRUE(per_deal.contains("Qs"));
+    EXPECT_FALSE(per_deal.contains("5h")); // On the flop
+    EXPECT_TRUE(per_deal["Qs"].contains("strategy"));
+}
+
+// The streamed dump parses to the same document as the in-memory one
+TEST_F(PCfrSolverDealTest, StreamedDumpMatchesDump) {
+    ASSERT_NO_THROW(solver_->Train());
+    for (bool dump_evs : {false, true}) {
+        for (int max_depth : {-1, 0, 3}) {
+            std::ostringstream streamed;
+            solver_->DumpStrategyTo(streamed, dump_evs, max_depth);
+            // Through text on both sides: NaN EVs become null.
+            EXPECT_EQ(json::parse(streamed.str()), json::parse(solver_->DumpStrategy(dump_evs, max_depth).dump()))
+                << "dump_evs " << dump_evs << ", max_depth " << max_depth;
+        }
+    }
+}
+
+// The strategy file holds the dumped strategies, addressed by action and card path
+TEST_F(PCfrSolverDealTest, StrategyFileMatchesDump) {
+    ASSERT_NO_THROW(solver_->Train());
+    json dump = solver_->DumpStrategy(false);
+    std::string path = ::testing::TempDir() + "pcfr_solver_deal_test.strategy";
+    for (StrategyValueType value_type : {StrategyValueType::kFloat32, StrategyValueType::kFloat16}) {
+        solver_->WriteStrategyFile(path, value_type);
+        StrategyFile file(path);
+        const float tolerance = value_type == StrategyValueType::kFloat16 ? 1e-3f : 1e-6f;
+        auto check = [&](const std::string& node_path, const json& strategy_data) {
+            auto node = file.Find(node_path);
+            ASSERT_TRUE(node.has_value()) << node_path;
+            EXPECT_EQ(file.Path(*node), node_path);
+            ASSERT_EQ(file.NumActions(*node), strategy_data["actions"].size());
+            EXPECT_EQ(file.Actions(*node)[0], strategy_data["actions"][0]);
+            EXPECT_FALSE(file.HasEvs(*node));
+            for (size_t h = 0; h < file.NumHands(*node); ++h) {
+                const json& hand = strategy_data["strategy"][file.Hand(*node, h).ToString()];
+                for (size_t a = 0; a < file.NumActions(*node); ++a) {
+                    EXPECT_NEAR(file.Strategy(*node, a, h), hand[a].get<double>(), tolerance);
+                }
+            }
+        };
+        check("", dump["strategy_data"]);
+        check("CHECK/CHECK/Qs", dump["children"]["CHECK"]["children"]["CHECK"]["child"]["strategy_data"]["Qs"]);
+        EXPECT_FALSE(file.Find("CHECK/CHECK/5h").has_value()); // On the flop
+    }
+    std::remove(path.c_str());
+}
+
+// A short deck deals only its 36 cards: 33 turn cards after the flop.
+TEST(PCfrSolverShortDeckTest, DealsOnlyShortDeckCards) {
+    Deck deck = Deck::ShortDeck();
+    const GameTreeBuildingSettings build_settings =
+        test_support::SameOnEveryStreet(StreetSetting({50.0}, {}, {}, false));
+    std::vector<int> board = {Card::StringToInt("Ac").value(), Card::StringToInt("Kd").value(),
+                              Card::StringToInt("6h").value()};
+    Rule rule(deck, 10.0, 10.0, GameRound::kFlop, board, 1, 0.5, 1.0, 20.0, build_settings);
+    auto tree = std::make_shared<GameTree>(rule);
+    const std::vector<PrivateCards> range = test_support::MakeRange(40, 52, board); // Tens and up
+    auto pcm = test_support::MakeRangeManager(rule, {range, range});
+    auto rrm = std::make_shared<RiverRangeManager>(std::make_shared<poker_solver::eval::ShortDeckCompairer>());
+    PCfrSolver::Config config;
+    config.iteration_limit = 2;
+    PCfrSolver solver(tree, pcm, rrm, rule, config);
+    ASSERT_NO_THROW(solver.Train());
+
+    auto root = std::dynamic_pointer_cast<ActionNode>(tree->GetRoot());
+    ASSERT_NE(root, nullptr);
+    std::shared_ptr<ActionNode> turn_node;
+    for (const auto& child : root->GetChildren()) {
+        auto chance = std::dynamic_pointer_cast<ChanceNode>(child);
+        if (chance) turn_node = std::dynamic_pointer_cast<ActionNode>(chance->GetChild());
+        if (auto action = std::dynamic_pointer_cast<ActionNode>(child)) {
+            for (const auto& grandchild : action->GetChildren()) {
+                if (auto chance2 = std::dynamic_pointer_cast<ChanceNode>(grandchild)) {
+                    turn_node = std::dynamic_pointer_cast<ActionNode>(chance2->GetChild());
+                }
+            }
+        }
+        if (turn_node) break;
+    }
+    ASSERT_NE(turn_node, nullptr);
+    EXPECT_EQ(turn_node->GetNumPossibleDeals(), 33u);
+    json dump = solver.DumpStrategy(false);
+    const json& per_deal = dump["children"]["CHECK"]["children"]["CHECK"]["child"]["strategy_data"];
+    ASSERT_TRUE(per_deal.is_object());
+    EXPECT_EQ(per_deal.size(), 33u);
+    EXPECT_FALSE(per_deal.contains("2s")); // Not in a short deck
+}
@@ -0,0 +1,222 @@
+#include "gtest/gtest.h"
+#include "solver/PCfrSolver.h"
+#include "solver/LeafValueEstimator.h"
+#include "toy_spot.h"
+#include "nodes/ActionNode.h"
+#include "nodes/ChanceNode.h"
+#include "ranges/RiverRangeManager.h"
+#include "ranges/PrivateCards.h"
+#include "trainable/Trainable.h"
+#include "tools/Rule.h"
+#include "tools/GameTreeBuildingSettings.h"
+#include "tools/StreetSetting.h"
+#include "FlatGameTree.h"
+#include "GameTree.h"
+#include "Deck.h"
+#include "Card.h"
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+using namespace poker_solver::core;
+using namespace poker_solver::config;
+using namespace poker_solver::nodes;
+using namespace poker_solver::ranges;
+using namespace poker_solver::solver;
+using namespace poker_solver::tree;
+
+namespace {
+
+// Forwards to the check-down estimator, recording the leaves it is asked about.
+class RecordingEstimator : public LeafValueEstimator {
+ public:
+  explicit RecordingEstimator(std::shared_ptr<RiverRangeManager> rrm) : check_down_(std::move(rrm)) {}
+  const char* Name() const override { return "recording"; }
+  void EstimateLeafValues(const Leaf& leaf) override {
+      {
+          std::lock_guard<std::mutex> lock(mutex);
+          paths.insert(std::string(leaf.path));
+          rounds.insert(leaf.round);
+      }
+      check_down_.EstimateLeafValues(leaf);
+  }
+
+  std::mutex mutex;
+  std::set<std::string> paths;
+  std::set<GameRound> rounds;
+
+ private:
+  CheckDownLeafEstimator check_down_;
+};
+
+} // namespace
+
+// A flop spot that may bet on the flop only: later streets can just check,
+// so the full tree checks them down, which is what the default leaf
+// estimator assumes.
+class DepthLimitTest : public ::testing::Test {
+ protected:
+  Deck deck_;
+  StreetSetting flop_ = test_support::HalfPotAndAllIn();
+  StreetSetting checks_{{}, {}, {}, false};
+  GameTreeBuildingSettings build_settings_{flop_, checks_, checks_, flop_, checks_, checks_};
+  std::vector<int> board_ = test_support::FlopBoard();
+  std::shared_ptr<Compairer> compairer_ = std::make_shared<test_support::ToyCompairer>();
+
+  Rule MakeRule(bool depth_limited) const {
+      Rule rule = test_support::MakeSpotRule(deck_, board_, build_settings_);
+      rule.SetDepthLimited(depth_limited);
+      return rule;
+  }
+
+  std::vector<PrivateCards> MakeRange(int first_card, int last_card) const {
+      return test_support::MakeRange(first_card, last_card, board_);
+  }
+
+  std::unique_ptr<PCfrSolver> MakeSolver(bool depth_limited, std::shared_ptr<RiverRangeManager> rrm = nullptr) const {
+      if (!rrm) rrm = std::make_shared<RiverRangeManager>(compairer_);
+      PCfrSolver::Config config;
+      config.iteration_limit = 5;
+      config.num_threads = 1;
+      return test_support::MakeToySolver(MakeRule(depth_limited), {MakeRange(0, 16), MakeRange(8, 24)}, config,
+                                         nullptr, std::move(rrm));
+  }
+
+  // Compares the average strategies of the flop action nodes of two trees.
+  static void ExpectSameFlopStrategies(const std::shared_ptr<GameTreeNode>& expected,
+                                       const std::shared_ptr<GameTreeNode>& actual, const std::string& where) {
+      auto expected_node = std::dynamic_pointer_cast<ActionNode>(expected);
+      auto actual_node = std::dynamic_pointer_cast<ActionNode>(actual);
+      if (!expected_node || expected_node->GetRound() != GameRound::kFlop) return;
+      ASSERT_TRUE(actual_node) << where;
+      const std::vector<double>& expected_strategy = expected_node->GetTrainableIfExists(0)->GetAverageStrategy();
+      const std::vector<double>& actual_strategy = actual_node->GetTrainableIfExists(0)->GetAverageStrategy();
+      ASSERT_EQ(expected_strategy.size(), actual_strategy.size()) << where;
+      for (size_t i = 0; i < expected_strategy.size(); ++i) {
+          EXPECT_NEAR(expected_strategy[i], actual_strategy[i], 1e-9) << where << " [" << i << "]";
+      }
+      for (size_t a = 0; a < expected_node->GetActions().size(); ++a) {
+          ExpectSameFlopStrategies(expected_node->GetChildren()[a], actual_node->GetChildren()[a],
+                                   where + "/" + expected_node->GetActions()[a].ToString());
+      }
+  }
+};
+
+// --- Tests ---
+
+TEST_F(DepthLimitTest, TreeStopsBeforeTheNextStreetsBetting) {
+    GameTree full(MakeRule(false));
+    GameTree limited(MakeRule(true));
+    const TreeBuildStats& stats = limited.GetBuildStats();
+    EXPECT_EQ(full.GetBuildStats().leaf_nodes, 0u);
+    EXPECT_GT(stats.leaf_nodes, 0u);
+    EXPECT_LT(stats.NumTrainables(), full.GetBuildStats().NumTrainables());
+    EXPECT_LT(limited.EstimateTreeMemory(), full.EstimateTreeMemory());
+    for (size_t p = 0; p < 2; ++p) {
+        for (GameRound round : {GameRound::kTurn, GameRound::kRiver}) {
+            for (uint64_t count : stats.trainables_by_round[GameTreeNode::GameRoundToInt(round)][p]) {
+                EXPECT_EQ(count, 0u);
+            }
+        }
+    }
+    // All-in runouts are kept.
+    EXPECT_GT(stats.showdown_nodes, 0u);
+
+    FlatGameTree flat(limited);
+    size_t childless = 0;
+    for (const FlatNode& node : flat.Nodes()) {
+        if (node.type == GameTreeNodeType::kChance && node.num_children == 0) {
+            ++childless;
+            EXPECT_EQ(node.round, GameRound::kTurn);
+        }
+    }
+    EXPECT_EQ(childless, stats.leaf_nodes);
+}
+
+TEST_F(DepthLimitTest, CheckDownValuesMatchBruteForce) {
+    const std::vector<PrivateCards> player_range = MakeRange(0, 12);
+    const std::vector<PrivateCards> opponent_range = MakeRange(6, 18);
+    std::vector<double> opponent_reach(opponent_range.size());
+    for (size_t o = 0; o < opponent_reach.size(); ++o) opponent_reach[o] = 0.1 + 0.05 * static_cast<double>(o % 7);
+    const uint64_t flop = Card::CardIntsToUint64(board_);
+    const uint64_t turn = flop | (1ULL << Card::StringToInt("9s").value());
+
+    for (uint64_t board : {flop, turn}) {
+        // Each pair of hands averaged over the river boards it does not block.
+        std::vector<uint64_t> rivers;
+        const uint64_t remaining = deck_.GetCardsMask() & ~board;
+        ForEachCard(remaining, [&](int first) {
+            if (CountCards(board) == 4) {
+                rivers.push_back(board | (1ULL << first));
+                return;
+            }
+            ForEachCard(remaining & ~((2ULL << first) - 1),
+                        [&](int second) { rivers.push_back(board | (1ULL << first) | (1ULL << second)); });
+        });
+        std::vector<double> expected(player_range.size(), 0.0);
+        for (size_t h = 0; h < player_range.size(); ++h) {
+            const uint64_t hand = player_range[h].GetBoardMask();
+            for (size_t o = 0; o < opponent_range.size(); ++o) {
+                const uint64_t opponent_hand = opponent_range[o].GetBoardMask();
+                if (hand & (opponent_hand | board) || opponent_hand & board) continue;
+                double net = 0.0;
+                int compatible = 0;
+                for (uint64_t river : rivers) {
+                    if (river & (hand | opponent_hand)) continue;
+                    const ComparisonResult result = compairer_->CompareHands(hand, opponent_hand, river);
+                    net += result == ComparisonResult::kPlayer1Wins   ? 10.0
+                           : result == ComparisonResult::kPlayer2Wins ? -10.0
+                                                                      : 0.0;
+                    ++compatible;
+                }
+                expected[h] += opponent_reach[o] * net / compatible;
+            }
+        }
+
+        for (int threads : {1, 4}) {
+            omp_set_num_threads(threads);
+            CheckDownLeafEstimator estimator(std::make_shared<RiverRangeManager>(compairer_));
+            std::vector<double> values(player_range.size(), -1.0);
+            LeafValueEstimator::Leaf leaf;
+            leaf.board_mask = board;
+            leaf.deck_mask = deck_.GetCardsMask();
+            leaf.pot = 20.0;
+            leaf.player = 0;
+            leaf.player_range = &player_range;
+            leaf.opponent_range = &opponent_range;
+            leaf.opponent_reach = opponent_reach.data();
+            leaf.values = values.data();
+            estimator.EstimateLeafValues(leaf);
+            for (size_t h = 0; h < values.size(); ++h) {
+                EXPECT_NEAR(values[h], expected[h], 1e-9) << "hand " << h << ", threads " << threads;
+            }
+        }
+    }
+    omp_set_num_threads(1);
+    EXPECT_THROW(CheckDownLeafEstimator(nullptr), std::invalid_argument);
+}
+
+TEST_F(DepthLimitTest, CheckDownLeavesMatchACheckedDownTree) {
+    // Turn and river only check here, so valuing the leaves by check-down
+    // equity is exact and the flop strategies come out the same.
+    auto full = MakeSolver(false);
+    full->Train();
+    auto rrm = std::make_shared<RiverRangeManager>(compairer_);
+    auto limited = MakeSolver(true, rrm);
+    auto recording = std::make_shared<RecordingEstimator>(rrm);
+    limited->SetLeafValueEstimator(recording);
+    limited->Train();
+    ExpectSameFlopStrategies(full->GetGameTree()->GetRoot(), limited->GetGameTree()->GetRoot(), "root");
+
+    EXPECT_EQ(recording->rounds, std::set<GameRound>{GameRound::kTurn});
+    EXPECT_EQ(recording->paths.count("CHECK/CHECK"), 1u);
+    EXPECT_EQ(recording->paths.size(), limited->GetGameTree()->GetBuildStats().leaf_nodes);
+
+    const double exploitability = limited->ComputeExploitability();
+    EXPECT_TRUE(std::isfinite(exploitability));
+    EXPECT_NEAR(exploitability, full->ComputeExploitability(), 1e-9);
+}
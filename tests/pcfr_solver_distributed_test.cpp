@@ -0,0 +1,200 @@
+#include "gtest/gtest.h"
+#include "solver/PCfrSolver.h"
+#include "solver/SolverTransport.h"
+#include "toy_spot.h"
+#include "nodes/ActionNode.h"
+#include "nodes/ChanceNode.h"
+#include "ranges/PrivateCards.h"
+#include "tools/Rule.h"
+#include "GameTree.h"
+#include "Deck.h"
+#include "Card.h"
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace poker_solver::core;
+using namespace poker_solver::config;
+using namespace poker_solver::nodes;
+using namespace poker_solver::ranges;
+using namespace poker_solver::solver;
+using namespace poker_solver::tree;
+
+// A flop spot split by turn card across the ranks of an in-process group.
+class PCfrSolverDistributedTest : public ::testing::Test {
+ protected:
+  Deck deck_;
+  std::vector<int> board_ = test_support::FlopBoard();
+  std::unique_ptr<Rule> rule_;
+
+  void SetUp() override {
+      rule_ = std::make_unique<Rule>(test_support::MakeSpotRule(deck_, board_));
+  }
+
+  std::vector<PrivateCards> MakeRange(int first_card, int last_card) const {
+      return test_support::MakeRange(first_card, last_card, board_);
+  }
+
+  struct Rank {
+      std::shared_ptr<GameTree> tree;
+      std::unique_ptr<PCfrSolver> solver;
+  };
+
+  Rank MakeRank(const PCfrSolver::Config& config) const {
+      Rank rank;
+      rank.tree = std::make_shared<GameTree>(*rule_);
+      rank.solver = test_support::MakeToySolver(*rule_, {MakeRange(0, 16), MakeRange(8, 24)}, config, rank.tree);
+      return rank;
+  }
+
+  static std::vector<double> RootStrategy(const Rank& rank) {
+      auto root = std::dynamic_pointer_cast<ActionNode>(rank.tree->GetRoot());
+      return root->GetTrainableIfExists(0)->GetAverageStrategy();
+  }
+
+  // Trainables created anywhere below 'node'.
+  static size_t CountTrainables(const std::shared_ptr<GameTreeNode>& node) {
+      size_t count = 0;
+      if (auto action = std::dynamic_pointer_cast<ActionNode>(node)) {
+          for (size_t d = 0; d < action->GetNumPossibleDeals(); ++d) count += action->GetTrainableIfExists(d) ? 1 : 0;
+          for (const auto& child : action->GetChildren()) count += CountTrainables(child);
+      } else if (auto chance = std::dynamic_pointer_cast<ChanceNode>(node)) {
+          count += CountTrainables(chance->GetChild());
+      }
+      return count;
+  }
+
+  // Trains 'ranks' solvers of the group in parallel, one thread each, and
+  // computes exploitability on all of them.
+  std::vector<Rank> SolveDistributed(int num_ranks, const PCfrSolver::Config& config) const {
+      std::vector<std::shared_ptr<SolverTransport>> group = CreateLocalTransportGroup(num_ranks);
+      std::vector<Rank> ranks;
+      for (int r = 0; r < num_ranks; ++r) {
+          ranks.push_back(MakeRank(config));
+          ranks.back().solver->SetTransport(group[r]);
+      }
+      std::vector<std::thread> threads;
+      for (int r = 0; r < num_ranks; ++r) {
+          threads.emplace_back([&ranks, r]() {
+              ranks[r].solver->Train();
+              ranks[r].solver->ComputeExploitability();
+          });
+      }
+      for (std::thread& thread : threads) thread.join();
+      return ranks;
+  }
+};
+
+TEST_F(PCfrSolverDistributedTest, MatchesSingleProcessSolve) {
+    PCfrSolver::Config config;
+    config.iteration_limit = 4;
+    config.num_threads = 1;
+    config.warmup_river_cache = false;
+    Rank single = MakeRank(config);
+    single.solver->Train();
+    const double exploitability = single.solver->ComputeExploitability();
+
+    std::vector<Rank> ranks = SolveDistributed(3, config);
+    const std::vector<double> expected = RootStrategy(single);
+    for (const Rank& rank : ranks) {
+        // Ranks share bit-identical sums, so their shared levels agree exactly.
+        EXPECT_EQ(RootStrategy(rank), RootStrategy(ranks[0]));
+        EXPECT_NEAR(rank.solver->GetLastExploitability(), exploitability, 1e-9);
+        EXPECT_EQ(rank.solver->GetCompletedIterations(), 4);
+    }
+    // Each rank only holds the turn subtrees it owns.
+    const size_t single_trainables = CountTrainables(single.tree->GetRoot());
+    for (const Rank& rank : ranks) EXPECT_LT(CountTrainables(rank.tree->GetRoot()), single_trainables * 2 / 3);
+    // Only the summation order differs from one process.
+    const std::vector<double> actual = RootStrategy(ranks[0]);
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) EXPECT_NEAR(actual[i], expected[i], 1e-9);
+}
+
+TEST_F(PCfrSolverDistributedTest, StopOnOneRankStopsTheGroup) {
+    PCfrSolver::Config config;
+    config.iteration_limit = 5;
+    config.warmup_river_cache = false;
+    std::vector<std::shared_ptr<SolverTransport>> group = CreateLocalTransportGroup(2);
+    std::vector<Rank> ranks;
+    ranks.push_back(MakeRank(config));
+    ranks.push_back(MakeRank(config));
+    ranks[0].solver->SetTransport(group[0]);
+    ranks[1].solver->SetTransport(group[1]);
+    ranks[1].solver->Stop();
+    std::thread other([&ranks]() { ranks[1].solver->Train(); });
+    ranks[0].solver->Train();
+    other.join();
+    EXPECT_EQ(ranks[0].solver->GetCompletedIterations(), 0);
+    EXPECT_EQ(ranks[1].solver->GetCompletedIterations(), 0);
+}
+
+TEST_F(PCfrSolverDistributedTest, RejectsTaskParallelism) {
+    PCfrSolver::Config config;
+    config.parallel_level = PCfrSolver::ParallelLevel::kTasks;
+    Rank rank = MakeRank(config);
+    EXPECT_THROW(rank.solver->SetTransport(CreateLocalTransportGroup(2)[0]), std::invalid_argument);
+}
+
+TEST(SolverTransportTest, LocalGroupSumsInRankOrder) {
+    std::vector<std::shared_ptr<SolverTransport>> group = CreateLocalTransportGroup(3);
+    std::vector<std::vector<double>> data = {{1.0, 2.0}, {10.0, 20.0}, {100.0, 200.0}};
+    std::vector<std::thread> threads;
+    for (int r = 0; r < 3; ++r) {
+        threads.emplace_back([&, r]() {
+            EXPECT_EQ(group[r]->Rank(), r);
+            EXPECT_EQ(group[r]->Size(), 3);
+            group[r]->AllReduceSum(data[r].data(), data[r].size());
+            group[r]->AllReduceSum(data[r].data(), data[r].size()); // Rounds do not mix
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+    for (const std::vector<double>& values : data) EXPECT_EQ(values, (std::vector<double>{333.0, 666.0}));
+    EXPECT_THROW(CreateLocalTransportGroup(0), std::invalid_argument);
+}
+
+TEST(SolverTransportTest, TcpStarSumsAcrossWorkers) {
+    const uint16_t port = 47613;
+    std::shared_ptr<SolverTransport> coordinator;
+    std::string coordinator_error;
+    std::thread coordinator_thread([&]() {
+        try {
+            coordinator = CreateTcpCoordinator(port, 3);
+        } catch (const std::exception& e) {
+            coordinator_error = e.what();
+        }
+    });
+    std::vector<std::shared_ptr<SolverTransport>> workers(2);
+    std::vector<std::thread> worker_threads;
+    for (int r = 1; r <= 2; ++r) {
+        worker_threads.emplace_back([&, r]() {
+            try {
+                workers[r - 1] = CreateTcpWorker("127.0.0.1", port, r, 3, 5);
+            } catch (const std::exception&) {
+            }
+        });
+    }
+    coordinator_thread.join();
+    for (std::thread& thread : worker_threads) thread.join();
+    if (!coordinator) GTEST_SKIP() << "Cannot set up TCP on localhost: " << coordinator_error;
+    ASSERT_NE(workers[0], nullptr);
+    ASSERT_NE(workers[1], nullptr);
+
+    std::vector<std::vector<double>> data = {{1.0, 2.0, 3.0}, {10.0, 20.0, 30.0}, {100.0, 200.0, 300.0}};
+    std::vector<std::shared_ptr<SolverTransport>> ranks = {coordinator, workers[0], workers[1]};
+    std::vector<std::thread> threads;
+    for (int r = 0; r < 3; ++r) {
+        threads.emplace_back([&, r]() { ranks[r]->AllReduceSum(data[r].data(), data[r].size()); });
+    }
+    for (std::thread& thread : threads) thread.join();
+    for (const std::vector<double>& values : data) EXPECT_EQ(values, (std::vector<double>{111.0, 222.0, 333.0}));
+
+    // A worker that goes away makes the coordinator fail instead of hang.
+    workers[0].reset();
+    ranks[1].reset();
+    double value = 1.0;
+    EXPECT_THROW(coordinator->AllReduceSum(&value, 1), std::runtime_error);
+}
@@ -0,0 +1,142 @@
+#include "gtest/gtest.h"
+#include "solver/PCfrSolver.h"
+#include "toy_spot.h"
+#include "nodes/ActionNode.h"
+#include "nodes/ChanceNode.h"
+#include "ranges/RiverRangeManager.h"
+#include "ranges/PrivateCards.h"
+#include "tools/Rule.h"
+#include "GameTree.h"
+#include "Deck.h"
+#include "Card.h"
+#include <memory>
+#include <vector>
+
+// Use namespaces
+using namespace poker_solver::core;
+using namespace poker_solver::config;
+using namespace poker_solver::nodes;
+using namespace poker_solver::ranges;
+using namespace poker_solver::solver;
+using namespace poker_solver::tree;
+
+// Monotone flop with suit-symmetric ranges: clubs, diamonds and spades are
+// interchangeable at the turn, so isomorphism solves one of each three.
+class PCfrSolverIsomorphismTest : public ::testing::Test {
+ protected:
+  Deck deck_;
+  std::vector<int> board_ = test_support::ParseCards({"Ah", "Kh", "5h"});
+  std::unique_ptr<Rule> rule_;
+
+  void SetUp() override { rule_ = std::make_unique<Rule>(test_support::MakeSpotRule(deck_, board_)); }
+
+  // All hands of ranks [first_rank, last_rank) that miss the board.
+  std::vector<PrivateCards> MakeRange(int first_rank, int last_rank) const {
+      return test_support::MakeRange(first_rank * 4, last_rank * 4, board_);
+  }
+
+  static std::shared_ptr<RiverRangeManager> SuitBlindRiverRanges() {
+      return std::make_shared<RiverRangeManager>(std::make_shared<test_support::SuitBlindToyCompairer>());
+  }
+
+  // Trains a fresh tree and returns the dump; 'tree' receives the tree.
+  json Solve(bool use_isomorphism, std::shared_ptr<GameTree>& tree) {
+      tree = std::make_shared<GameTree>(*rule_);
+      PCfrSolver::Config config;
+      config.iteration_limit = 4;
+      config.num_threads = 1;
+      config.use_isomorphism = use_isomorphism;
+      auto solver = test_support::MakeToySolver(*rule_, {MakeRange(0, 4), MakeRange(2, 6)}, config, tree,
+                                                SuitBlindRiverRanges());
+      solver->Train();
+      return solver->DumpStrategy(false);
+  }
+
+  static std::shared_ptr<ActionNode> FindTurnActionNode(const std::shared_ptr<GameTreeNode>& node) {
+      if (auto chance = std::dynamic_pointer_cast<ChanceNode>(node)) {
+          if (chance->GetRound() == GameRound::kTurn) {
+              return std::dynamic_pointer_cast<ActionNode>(chance->GetChild());
+          }
+          return nullptr;
+      }
+      if (auto action = std::dynamic_pointer_cast<ActionNode>(node)) {
+          for (const auto& child : action->GetChildren()) {
+              if (auto found = FindTurnActionNode(child)) return found;
+          }
+      }
+      return nullptr;
+  }
+
+  static void ExpectSameStrategies(const json& expected, const json& actual) {
+      ASSERT_EQ(expected.size(), actual.size());
+      for (auto it = expected.begin(); it != expected.end(); ++it) {
+          ASSERT_TRUE(actual.contains(it.key())) << it.key();
+          const auto& expected_probs = it.value();
+          const auto& actual_probs = actual[it.key()];
+          ASSERT_EQ(expected_probs.size(), actual_probs.size());
+          for (size_t a = 0; a < expected_probs.size(); ++a) {
+              EXPECT_NEAR(expected_probs[a].get<double>(), actual_probs[a].get<double>(), 1e-9) << it.key();
+          }
+      }
+  }
+};
+
+TEST_F(PCfrSolverIsomorphismTest, TraversesOneTurnCardPerSuitClass) {
+    std::shared_ptr<GameTree> full_tree, iso_tree;
+    Solve(false, full_tree);
+    Solve(true, iso_tree);
+
+    auto count_trained = [](const std::shared_ptr<ActionNode>& node) {
+        size_t trained = 0;
+        for (size_t d = 0; d < node->GetNumPossibleDeals(); ++d) {
+            if (node->GetTrainableIfExists(d)) ++trained;
+        }
+        return trained;
+    };
+    auto full_turn = FindTurnActionNode(full_tree->GetRoot());
+    auto iso_turn = FindTurnActionNode(iso_tree->GetRoot());
+    ASSERT_NE(full_turn, nullptr);
+    ASSERT_NE(iso_turn, nullptr);
+    EXPECT_EQ(count_trained(full_turn), 49u);
+    // 10 hearts left, plus one representative of {c, d, s} for each of 13 ranks.
+    EXPECT_EQ(count_trained(iso_turn), 23u);
+}
+
+TEST_F(PCfrSolverIsomorphismTest, MatchesFullEnumeration) {
+    std::shared_ptr<GameTree> full_tree, iso_tree;
+    json full = Solve(false, full_tree);
+    json iso = Solve(true, iso_tree);
+
+    ExpectSameStrategies(full["strategy_data"]["strategy"], iso["strategy_data"]["strategy"]);
+
+    // Skipped turn cards are dumped from their representative with the hands relabelled.
+    const json& full_turn = full["children"]["CHECK"]["children"]["CHECK"]["child"]["strategy_data"];
+    const json& iso_turn = iso["children"]["CHECK"]["children"]["CHECK"]["child"]["strategy_data"];
+    ASSERT_EQ(iso_turn.size(), 49u);
+    for (const char* card : {"Qc", "Qd", "Qs", "Qh", "7s"}) {
+        ASSERT_TRUE(iso_turn.contains(card)) << card;
+        ExpectSameStrategies(full_turn[card]["strategy"], iso_turn[card]["strategy"]);
+    }
+}
+
+TEST_F(PCfrSolverIsomorphismTest, AsymmetricRangesAreNotMerged) {
+    auto tree = std::make_shared<GameTree>(*rule_);
+    std::vector<PrivateCards> lopsided = MakeRange(0, 4);
+    lopsided.emplace_back(Card::StringToInt("Qs").value(), Card::StringToInt("Js").value());
+    PCfrSolver::Config config;
+    config.iteration_limit = 1;
+    config.num_threads = 1;
+    config.use_isomorphism = true;
+    auto solver = test_support::MakeToySolver(*rule_, {lopsided, MakeRange(2, 6)}, config, tree, SuitBlindRiverRanges());
+    solver->Train();
+
+    auto turn = FindTurnActionNode(tree->GetRoot());
+    ASSERT_NE(turn, nullptr);
+    // Spades can no longer stand in for clubs/diamonds, but those two still merge.
+    EXPECT_NE(turn->GetTrainableIfExists(turn->GetNumPossibleDeals() - 1), nullptr); // As
+    size_t trained = 0;
+    for (size_t d = 0; d < turn->GetNumPossibleDeals(); ++d) {
+        if (turn->GetTrainableIfExists(d)) ++trained;
+    }
+    EXPECT_EQ(trained, 36u); // 10 hearts, 13 spades, 13 clubs-or-diamonds
+}
@@ -0,0 +1,141 @@
+#include "gtest/gtest.h"
+#include "solver/PCfrSolver.h"
+#include "trainable/LockedTrainable.h"
+#include "toy_spot.h"
+#include "ranges/PrivateCardsManager.h"
+#include "ranges/PrivateCards.h"
+#include "nodes/ActionNode.h"
+#include "nodes/ChanceNode.h"
+#include "tools/Rule.h"
+#include "GameTree.h"
+#include "Deck.h"
+#include "Card.h"
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace poker_solver::core;
+using namespace poker_solver::config;
+using namespace poker_solver::nodes;
+using namespace poker_solver::ranges;
+using namespace poker_solver::solver;
+using namespace poker_solver::tree;
+
+// PCfrSolver::LockNode on a small flop spot.
+class PCfrSolverLockingTest : public ::testing::Test {
+ protected:
+  Deck deck_;
+  std::vector<int> board_ = test_support::FlopBoard();
+  std::unique_ptr<Rule> rule_;
+  std::shared_ptr<GameTree> tree_;
+
+  void SetUp() override {
+      rule_ = std::make_unique<Rule>(test_support::MakeSpotRule(deck_, board_));
+      tree_ = std::make_shared<GameTree>(*rule_);
+  }
+
+  std::vector<PrivateCards> MakeRange(int first_card, int last_card) const {
+      return test_support::MakeRange(first_card, last_card, board_);
+  }
+
+  std::unique_ptr<PCfrSolver> MakeSolver(int iterations, bool use_isomorphism = false) {
+      pcm_ = test_support::MakeRangeManager(*rule_, {MakeRange(0, 16), MakeRange(8, 24)});
+      PCfrSolver::Config config;
+      config.iteration_limit = iterations;
+      config.num_threads = 1;
+      config.use_isomorphism = use_isomorphism;
+      return test_support::MakeToySolver(*rule_, pcm_, config, tree_);
+  }
+
+  // Every hand of 'player' plays 'action' of 'node' with probability 1.
+  std::vector<double> PureStrategy(const ActionNode& node, size_t player, size_t action) const {
+      const size_t num_actions = node.GetActions().size();
+      std::vector<double> strategy(num_actions * pcm_->GetPlayerRange(player).size(), 0.0);
+      for (size_t i = action; i < strategy.size(); i += num_actions) strategy[i] = 1.0;
+      return strategy;
+  }
+
+  ActionNode& Root() const { return dynamic_cast<ActionNode&>(*tree_->GetRoot()); }
+
+  std::shared_ptr<PrivateCardsManager> pcm_;
+};
+
+TEST_F(PCfrSolverLockingTest, LockedRootPlaysItsStrategyWithoutTables) {
+    auto solver = MakeSolver(5);
+    ActionNode& root = Root();
+    ASSERT_EQ(root.GetActions()[0].ToString(), "CHECK");
+    std::vector<double> always_check = PureStrategy(root, root.GetPlayerIndex(), 0);
+    solver->LockNode({}, always_check);
+    solver->Train();
+
+    auto trainable = root.GetTrainableIfExists(0);
+    ASSERT_NE(trainable, nullptr);
+    EXPECT_NE(std::dynamic_pointer_cast<LockedTrainable>(trainable), nullptr);
+    EXPECT_EQ(trainable->GetAverageStrategy(), always_check);
+    const json dump = solver->DumpStrategy(false);
+    const std::string hand = pcm_->GetPlayerRange(root.GetPlayerIndex())[0].ToString();
+    EXPECT_EQ(dump["strategy_data"]["strategy"][hand][0], 1.0);
+}
+
+TEST_F(PCfrSolverLockingTest, LockBelowAChanceNodeCoversEveryDeal) {
+    auto solver = MakeSolver(3);
+    auto& after_check = dynamic_cast<ActionNode&>(*Root().GetChildren()[0]);
+    auto& chance = dynamic_cast<ChanceNode&>(*after_check.GetChildren()[0]);
+    auto& turn_root = dynamic_cast<ActionNode&>(*chance.GetChild());
+    // The path skips the chance node: the lock holds on every turn card.
+    solver->LockNode({"CHECK", "CHECK"}, PureStrategy(turn_root, turn_root.GetPlayerIndex(), 0));
+    EXPECT_TRUE(turn_root.IsLocked());
+    solver->Train();
+
+    size_t locked_slots = 0;
+    for (size_t d = 0; d < turn_root.GetNumPossibleDeals(); ++d) {
+        auto trainable = turn_root.GetTrainableIfExists(d);
+        if (!trainable) continue;
+        EXPECT_NE(std::dynamic_pointer_cast<LockedTrainable>(trainable), nullptr);
+        ++locked_slots;
+    }
+    EXPECT_GT(locked_slots, 1u);
+}
+
+TEST_F(PCfrSolverLockingTest, BestResponseKeepsLockedNodesFixed) {
+    // Out of position always checks. Were the best response free to bet
+    // there, the locked player's lost value would keep the exploitability up.
+    auto solver = MakeSolver(10);
+    solver->LockNode({}, PureStrategy(Root(), Root().GetPlayerIndex(), 0));
+    solver->Train();
+    EXPECT_LT(solver->ComputeExploitability(), 2.0);
+}
+
+TEST_F(PCfrSolverLockingTest, RejectsBadLocks) {
+    auto solver = MakeSolver(1);
+    const size_t player = Root().GetPlayerIndex();
+    std::vector<double> strategy = PureStrategy(Root(), player, 0);
+    EXPECT_THROW(solver->LockNode({"RAISE 3"}, strategy), std::invalid_argument);
+    EXPECT_THROW(solver->LockNode({"BET 10", "FOLD"}, strategy), std::invalid_argument);
+    EXPECT_THROW(solver->LockNode({}, std::vector<double>(strategy.begin() + 1, strategy.end())),
+                 std::invalid_argument);
+    std::vector<double> half = strategy;
+    half[0] = 0.5;
+    EXPECT_THROW(solver->LockNode({}, half), std::invalid_argument);
+    std::vector<double> negative = strategy;
+    negative[0] = 2.0;
+    negative[1] = -1.0;
+    EXPECT_THROW(solver->LockNode({}, negative), std::invalid_argument);
+    EXPECT_FALSE(Root().IsLocked());
+
+    auto isomorphic = MakeSolver(1, true);
+    EXPECT_THROW(isomorphic->LockNode({}, strategy), std::logic_error);
+}
+
+TEST_F(PCfrSolverLockingTest, UnlockedNodeTrainsAgain) {
+    auto solver = MakeSolver(2);
+    solver->LockNode({}, PureStrategy(Root(), Root().GetPlayerIndex(), 0));
+    solver->Train();
+    ASSERT_NE(Root().GetTrainableIfExists(0), nullptr);
+    solver->UnlockNode({});
+    EXPECT_FALSE(Root().IsLocked());
+    EXPECT_EQ(Root().GetTrainableIfExists(0), nullptr);
+    auto trainable = Root().GetTrainable(0);
+    EXPECT_EQ(std::dynamic_pointer_cast<LockedTrainable>(trainable), nullptr);
+}
@@ -0,0 +1,158 @@
+#include "gtest/gtest.h"
+#include "solver/PCfrSolver.h"
+#include "toy_spot.h"
+#include "ranges/PrivateCards.h"
+#include "tools/Rule.h"
+#include "Deck.h"
+#include "Card.h"
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+// Use namespaces
+using namespace poker_solver::core;
+using namespace poker_solver::config;
+using namespace poker_solver::ranges;
+using namespace poker_solver::solver;
+using namespace poker_solver::tree;
+
+// The threaded traversal must produce the same strategies as the serial one.
+class PCfrSolverParallelTest : public ::testing::Test {
+ protected:
+  Deck deck_;
+  std::vector<int> board_ = test_support::FlopBoard();
+  std::unique_ptr<Rule> rule_;
+
+  void SetUp() override {
+      rule_ = std::make_unique<Rule>(test_support::MakeSpotRule(deck_, board_));
+  }
+
+  std::vector<PrivateCards> MakeRange(int first_card, int last_card) const {
+      return test_support::MakeRange(first_card, last_card, board_);
+  }
+
+  void ExpectSameSolution(const json& expected, const json& actual) {
+      ExpectSameStrategies(expected["strategy_data"]["strategy"], actual["strategy_data"]["strategy"]);
+      const json& expected_turn = expected["children"]["CHECK"]["children"]["CHECK"]["child"]["strategy_data"];
+      const json& actual_turn = actual["children"]["CHECK"]["children"]["CHECK"]["child"]["strategy_data"];
+      for (const char* card : {"2c", "Qs", "Ah"}) {
+          ExpectSameStrategies(expected_turn[card]["strategy"], actual_turn[card]["strategy"]);
+      }
+  }
+
+  json Solve(PCfrSolver::Config config, double* parallel_cutoff = nullptr) {
+      config.iteration_limit = 3;
+      auto solver = test_support::MakeToySolver(*rule_, {MakeRange(0, 16), MakeRange(8, 24)}, config);
+      solver->Train();
+      if (parallel_cutoff) *parallel_cutoff = solver->GetParallelCutoff();
+      return solver->DumpStrategy(false);
+  }
+
+  static void ExpectSameStrategies(const json& expected, const json& actual) {
+      ASSERT_EQ(expected.size(), actual.size());
+      for (auto it = expected.begin(); it != expected.end(); ++it) {
+          ASSERT_TRUE(actual.contains(it.key())) << it.key();
+          for (size_t a = 0; a < it.value().size(); ++a) {
+              EXPECT_NEAR(it.value()[a].get<double>(), actual[it.key()][a].get<double>(), 1e-9) << it.key();
+          }
+      }
+  }
+};
+
+TEST_F(PCfrSolverParallelTest, OutermostChanceMatchesSerial) {
+    PCfrSolver::Config serial;
+    serial.num_threads = 1;
+    serial.parallel_level = PCfrSolver::ParallelLevel::kNone;
+    PCfrSolver::Config threaded;
+    threaded.num_threads = 4;
+    threaded.parallel_level = PCfrSolver::ParallelLevel::kOutermostChance;
+
+    ExpectSameSolution(Solve(serial), Solve(threaded));
+}
+
+// Outcome utilities are summed in outcome order whatever the thread count,
+// so the fan-out reproduces the serial solve bit for bit.
+TEST_F(PCfrSolverParallelTest, OutermostChanceIsThreadCountIndependent) {
+    PCfrSolver::Config serial;
+    serial.num_threads = 1;
+    serial.parallel_level = PCfrSolver::ParallelLevel::kNone;
+    const json expected = Solve(serial);
+    for (int threads : {1, 3, 8}) {
+        PCfrSolver::Config threaded;
+        threaded.num_threads = threads;
+        threaded.parallel_level = PCfrSolver::ParallelLevel::kOutermostChance;
+        EXPECT_EQ(Solve(threaded), expected) << threads << " threads";
+    }
+}
+
+// The cutoff only picks which chance nodes fan out, so every cutoff, the
+// tuned one included, reproduces the serial solve.
+TEST_F(PCfrSolverParallelTest, ParallelCutoffKeepsResults) {
+    PCfrSolver::Config serial;
+    serial.num_threads = 1;
+    serial.parallel_level = PCfrSolver::ParallelLevel::kNone;
+    const json expected = Solve(serial);
+    PCfrSolver::Config threaded;
+    threaded.num_threads = 4;
+    for (double cutoff : {1.0, 1e4, 1e6, 1e8, 1e12}) {
+        threaded.parallel_cutoff = cutoff;
+        double in_use = 0.0;
+        EXPECT_EQ(Solve(threaded, &in_use), expected) << "cutoff " << cutoff;
+        EXPECT_EQ(in_use, cutoff);
+    }
+
+    threaded.parallel_cutoff = 0.0; // Tuned over the first iterations
+    double tuned = 0.0;
+    EXPECT_EQ(Solve(threaded, &tuned), expected);
+    EXPECT_GT(tuned, 0.0);
+
+    threaded.parallel_cutoff = -1.0;
+    EXPECT_THROW(Solve(threaded), std::invalid_argument);
+}
+
+// Two nodes sharing this machine's CPUs: the pinning is a no-op, but the
+// outcomes and arena lanes are split as on a two-socket machine.
+TEST_F(PCfrSolverParallelTest, NumaModeMatchesSerial) {
+    PCfrSolver::Config serial;
+    serial.num_threads = 1;
+    serial.parallel_level = PCfrSolver::ParallelLevel::kNone;
+    const json expected = Solve(serial);
+    const std::vector<int> cpus = NumaTopology::Detect().Cpus(0);
+    for (int threads : {1, 2, 5}) {
+        PCfrSolver::Config numa;
+        numa.num_threads = threads;
+        numa.numa_aware = true;
+        numa.numa_topology = NumaTopology({cpus, cpus});
+        EXPECT_EQ(Solve(numa), expected) << threads << " threads";
+    }
+}
+
+TEST_F(PCfrSolverParallelTest, TasksMatchSerial) {
+    PCfrSolver::Config serial;
+    serial.num_threads = 1;
+    serial.parallel_level = PCfrSolver::ParallelLevel::kNone;
+    json expected = Solve(serial);
+
+    PCfrSolver::Config tasks;
+    tasks.num_threads = 4;
+    tasks.parallel_level = PCfrSolver::ParallelLevel::kTasks;
+    tasks.task_cutoff = 1.0; // Every action child and outcome becomes a task
+    ExpectSameSolution(expected, Solve(tasks));
+
+    tasks.task_cutoff = 1e12; // Nothing is big enough: fully inline
+    ExpectSameSolution(expected, Solve(tasks));
+}
+
+// Tasks are spawned inside the traversal's region whatever its size, so a
+// one-thread run takes the same path and sums as a threaded one.
+TEST_F(PCfrSolverParallelTest, TasksAreThreadCountIndependent) {
+    PCfrSolver::Config tasks;
+    tasks.parallel_level = PCfrSolver::ParallelLevel::kTasks;
+    tasks.task_cutoff = 1.0;
+    tasks.num_threads = 1;
+    const json expected = Solve(tasks);
+    for (int threads : {2, 4}) {
+        tasks.num_threads = threads;
+        EXPECT_EQ(Solve(tasks), expected) << threads << " threads";
+    }
+}
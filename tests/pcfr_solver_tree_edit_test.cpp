@@ -0,0 +1,135 @@
+#include "gtest/gtest.h"
+#include "solver/PCfrSolver.h"
+#include "toy_spot.h"
+#include "nodes/ActionNode.h"
+#include "ranges/PrivateCards.h"
+#include "trainable/Trainable.h"
+#include "tools/Rule.h"
+#include "tools/GameTreeBuildingSettings.h"
+#include "tools/StreetSetting.h"
+#include "FlatGameTree.h"
+#include "GameTree.h"
+#include "Deck.h"
+#include "Card.h"
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace poker_solver::core;
+using namespace poker_solver::config;
+using namespace poker_solver::nodes;
+using namespace poker_solver::ranges;
+using namespace poker_solver::solver;
+using namespace poker_solver::tree;
+
+// A turn spot of pot 20 and stacks 50: OOP opens with a 50% (10 chip) bet
+// or all-in, so adding a 20 chip bet at the root gives the tree a 50% and
+// 100% opening builds.
+class TreeEditTest : public ::testing::Test {
+ protected:
+  Deck deck_;
+  StreetSetting ip_ = test_support::HalfPotAndAllIn();
+  StreetSetting oop_half_ = test_support::HalfPotAndAllIn();
+  StreetSetting oop_half_and_pot_{{50.0, 100.0}, {100.0}, {}, true};
+  std::vector<int> board_ = test_support::TurnBoard();
+
+  Rule MakeRule(const StreetSetting& oop) const {
+      return test_support::MakeSpotRule(deck_, board_, GameTreeBuildingSettings(ip_, ip_, ip_, oop, oop, oop));
+  }
+
+  std::unique_ptr<PCfrSolver> MakeSolver(const StreetSetting& oop, int iterations) const {
+      PCfrSolver::Config config;
+      config.iteration_limit = iterations;
+      config.num_threads = 1;
+      return test_support::MakeToySolver(
+          MakeRule(oop), {test_support::MakeRange(0, 14, board_), test_support::MakeRange(6, 20, board_)}, config);
+  }
+
+  static std::vector<std::string> ActionStrings(const ActionNode& node) {
+      std::vector<std::string> actions;
+      for (const auto& action : node.GetActions()) actions.push_back(action.ToString());
+      return actions;
+  }
+};
+
+// --- Tests ---
+
+TEST_F(TreeEditTest, EditedTreeMatchesAFreshBuild) {
+    GameTree edited(MakeRule(oop_half_));
+    GameTree fresh(MakeRule(oop_half_and_pot_));
+    EXPECT_EQ(edited.EditBetSizes({}, {40.0, 20.0, 10.0}), (std::vector<int>{0, 1, -1, 2}));
+
+    const TreeBuildStats& stats = edited.GetBuildStats();
+    const TreeBuildStats& expected = fresh.GetBuildStats();
+    EXPECT_EQ(stats.action_nodes, expected.action_nodes);
+    EXPECT_EQ(stats.chance_nodes, expected.chance_nodes);
+    EXPECT_EQ(stats.showdown_nodes, expected.showdown_nodes);
+    EXPECT_EQ(stats.terminal_nodes, expected.terminal_nodes);
+    EXPECT_EQ(stats.deal_slots, expected.deal_slots);
+    EXPECT_EQ(stats.trainables_by_actions, expected.trainables_by_actions);
+    EXPECT_EQ(edited.GetRoot()->GetSubtreeSize(), fresh.GetRoot()->GetSubtreeSize());
+
+    FlatGameTree edited_flat(edited);
+    FlatGameTree fresh_flat(fresh);
+    ASSERT_EQ(edited_flat.Size(), fresh_flat.Size());
+    for (uint32_t i = 0; i < edited_flat.Size(); ++i) {
+        const FlatNode& node = edited_flat.Node(i);
+        const FlatNode& fresh_node = fresh_flat.Node(i);
+        ASSERT_EQ(node.type, fresh_node.type) << "node " << i;
+        EXPECT_EQ(node.num_children, fresh_node.num_children) << "node " << i;
+        EXPECT_EQ(node.pot, fresh_node.pot) << "node " << i;
+        if (node.type == GameTreeNodeType::kAction) {
+            EXPECT_EQ(ActionStrings(edited_flat.Action(node)), ActionStrings(fresh_flat.Action(fresh_node)));
+        }
+    }
+
+    EXPECT_THROW(edited.EditBetSizes({"FOLD"}, {10.0}), std::invalid_argument);
+    EXPECT_THROW(edited.EditBetSizes({}, {0.0}), std::invalid_argument);
+    EXPECT_THROW(edited.EditBetSizes({}, {41.0}), std::invalid_argument);
+    EXPECT_THROW(edited.EditBetSizes({"BET 40"}, {5.0}), std::invalid_argument); // Facing an all-in
+}
+
+TEST_F(TreeEditTest, KeepsTrainedState) {
+    auto solver = MakeSolver(oop_half_, 6);
+    solver->Train();
+    const ActionNode& root = solver->FindActionNode({});
+    ASSERT_EQ(ActionStrings(root), (std::vector<std::string>{"CHECK", "BET 10", "BET 40"}));
+    const std::shared_ptr<Trainable> check_trainable = solver->FindActionNode({"CHECK"}).GetTrainableIfExists(0);
+    const std::shared_ptr<Trainable> call_trainable = solver->FindActionNode({"BET 10"}).GetTrainableIfExists(0);
+    ASSERT_TRUE(check_trainable);
+    ASSERT_TRUE(call_trainable);
+    const size_t num_hands = root.GetPlayerRangeRaw()->size();
+    std::vector<std::vector<double>> old_regrets(num_hands, std::vector<double>(3));
+    std::vector<std::vector<double>> old_sums(num_hands, std::vector<double>(3));
+    for (size_t h = 0; h < num_hands; ++h) {
+        root.GetTrainableIfExists(0)->GetHandState(h, old_regrets[h].data(), old_sums[h].data());
+    }
+
+    // Adds a pot-sized bet and drops the all-in.
+    const size_t seeded = solver->EditBetSizes({}, {10.0, 20.0});
+    const ActionNode& edited = solver->FindActionNode({});
+    ASSERT_EQ(ActionStrings(edited), (std::vector<std::string>{"CHECK", "BET 10", "BET 20"}));
+    EXPECT_THROW(solver->FindActionNode({"BET 40"}), std::invalid_argument);
+    EXPECT_EQ(solver->FindActionNode({"CHECK"}).GetTrainableIfExists(0), check_trainable);
+    EXPECT_EQ(solver->FindActionNode({"BET 10"}).GetTrainableIfExists(0), call_trainable);
+    std::vector<double> regrets(3);
+    std::vector<double> sums(3);
+    for (size_t h = 0; h < num_hands; ++h) {
+        edited.GetTrainableIfExists(0)->GetHandState(h, regrets.data(), sums.data());
+        for (size_t a = 0; a < 2; ++a) {
+            EXPECT_FLOAT_EQ(regrets[a], old_regrets[h][a]) << "hand " << h;
+            EXPECT_FLOAT_EQ(sums[a], old_sums[h][a]) << "hand " << h;
+        }
+        EXPECT_EQ(regrets[2], 0.0);
+        EXPECT_EQ(sums[2], 0.0);
+    }
+    // IP facing 20 is seeded from IP facing 10: same fold, call and raise.
+    EXPECT_GT(seeded, 0u);
+    EXPECT_TRUE(solver->FindActionNode({"BET 20"}).GetTrainableIfExists(0));
+
+    // The edited tree evaluates without another Train().
+    EXPECT_TRUE(std::isfinite(solver->ComputeExploitability()));
+    EXPECT_THROW(solver->EditBetSizes({"CALL"}, {10.0}), std::invalid_argument);
+}
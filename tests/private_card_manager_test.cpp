@@ -145,6 +145,28 @@ TEST_F(PrivateCardsManagerTest, GetOpponentHandIndex) {
      EXPECT_FALSE(pcm.GetOpponentHandIndex(0, 1, 99).has_value()); // Invalid hand index
      EXPECT_FALSE(pcm.GetOpponentHandIndex(2, 1, 0).has_value()); // Invalid player index
      EXPECT_FALSE(pcm.GetOpponentHandIndex(0, 2, 0).has_value()); // Invalid player index
+
+     // Dense combo lookups.
+     EXPECT_EQ(pcm.GetHandIndex(1, range_p1_[6].GetComboIndex()), 6);
+     EXPECT_EQ(pcm.GetHandIndex(0, range_p1_[6].GetComboIndex()), -1);
+     EXPECT_EQ(pcm.GetHandIndex(0, -1), -1);
+     EXPECT_EQ(pcm.GetHandIndex(2, 0), -1);
+}
+
+TEST_F(PrivateCardsManagerTest, GetHandsWithCard) {
+     std::vector<std::vector<PrivateCards>> ranges = {range_p0_, range_p1_};
+     PrivateCardsManager pcm(ranges, 0ULL);
+     for (size_t p = 0; p < 2; ++p) {
+         for (int card = 0; card < kNumCardsInDeck; ++card) {
+             std::vector<int32_t> expected;
+             for (size_t h = 0; h < ranges[p].size(); ++h) {
+                 if (ranges[p][h].GetBoardMask() & (1ULL << card)) expected.push_back(static_cast<int32_t>(h));
+             }
+             EXPECT_EQ(pcm.GetHandsWithCard(p, card), expected) << "player " << p << " card " << card;
+         }
+     }
+     EXPECT_THROW(pcm.GetHandsWithCard(2, 0), std::out_of_range);
+     EXPECT_THROW(pcm.GetHandsWithCard(0, 52), std::out_of_range);
 }
 
 TEST_F(PrivateCardsManagerTest, GetInitialReachProbsEmptyBoard) {
@@ -193,22 +215,29 @@ TEST_F(PrivateCardsManagerTest, GetInitialReachProbsWithBoard) {
     std::vector<std::vector<PrivateCards>> ranges = {range_p0_, range_p1_};
     PrivateCardsManager pcm(ranges, board_mask);
 
-    const auto& probs_p0 = pcm.GetInitialReachProbs(0);
-    const auto& probs_p1 = pcm.GetInitialReachProbs(1);
-
-    EXPECT_EQ(probs_p0.size(), range_p0_.size());
-    EXPECT_EQ(probs_p1.size(), range_p1_.size());
+    // Reach probabilities index the compacted ranges; look hands up by
+    // their index in the original ranges.
+    std::vector<double> probs_p0(range_p0_.size(), 0.0);
+    std::vector<double> probs_p1(range_p1_.size(), 0.0);
+    for (size_t i = 0; i < pcm.GetPlayerRange(0).size(); ++i) {
+        probs_p0[pcm.GetOriginalHandIndices(0)[i]] = pcm.GetInitialReachProbs(0)[i];
+    }
+    for (size_t i = 0; i < pcm.GetPlayerRange(1).size(); ++i) {
+        probs_p1[pcm.GetOriginalHandIndices(1)[i]] = pcm.GetInitialReachProbs(1)[i];
+    }
 
-    // 1. Check hands blocked DIRECTLY by board have zero probability
-    EXPECT_DOUBLE_EQ(probs_p0[0], 0.0) << "AcAd blocked by Ac"; // AcAd index 0
-    EXPECT_DOUBLE_EQ(probs_p0[1], 0.0) << "AcAh blocked by Ac"; // AcAh index 1
-    EXPECT_DOUBLE_EQ(probs_p0[2], 0.0) << "AcAs blocked by Ac"; // AcAs index 2
-    EXPECT_DOUBLE_EQ(probs_p0[12], 0.0) << "AcKc blocked by Ac"; // AcKc index 12
-    EXPECT_DOUBLE_EQ(probs_p1[0], 0.0) << "QcQd blocked by Qd"; // QcQd index 0
-    EXPECT_DOUBLE_EQ(probs_p1[3], 0.0) << "QdQh blocked by Qd"; // QdQh index 3
-    EXPECT_DOUBLE_EQ(probs_p1[4], 0.0) << "QdQs blocked by Qd"; // QdQs index 4
-    EXPECT_DOUBLE_EQ(probs_p1[6], 0.0) << "AcKd blocked by Ac"; // AcKd index 6
+    // 1. Check hands blocked DIRECTLY by board are dropped
+    EXPECT_EQ(pcm.GetCompactHandIndex(0, 0), -1) << "AcAd blocked by Ac"; // AcAd index 0
+    EXPECT_EQ(pcm.GetCompactHandIndex(0, 1), -1) << "AcAh blocked by Ac"; // AcAh index 1
+    EXPECT_EQ(pcm.GetCompactHandIndex(0, 2), -1) << "AcAs blocked by Ac"; // AcAs index 2
+    EXPECT_EQ(pcm.GetCompactHandIndex(0, 12), -1) << "AcKc blocked by Ac"; // AcKc index 12
+    EXPECT_EQ(pcm.GetCompactHandIndex(1, 0), -1) << "QcQd blocked by Qd"; // QcQd index 0
+    EXPECT_EQ(pcm.GetCompactHandIndex(1, 3), -1) << "QdQh blocked by Qd"; // QdQh index 3
+    EXPECT_EQ(pcm.GetCompactHandIndex(1, 4), -1) << "QdQs blocked by Qd"; // QdQs index 4
+    EXPECT_EQ(pcm.GetCompactHandIndex(1, 6), -1) << "AcKd blocked by Ac"; // AcKd index 6
     // AdKc (Index 9) is NOT blocked by Ac Qd 5h
+    EXPECT_EQ(pcm.GetPlayerRange(0).size(), range_p0_.size() - 4);
+    EXPECT_EQ(pcm.GetPlayerRange(1).size(), range_p1_.size() - 6); // QdXx x3, AcKx x3
 
     // 2. Check hands NOT blocked by board have NON-ZERO probability
     EXPECT_GT(probs_p0[11], 0.0) << "KhKs should be possible"; // KhKs (Index 11)
@@ -266,3 +295,42 @@ TEST_F(PrivateCardsManagerTest, GetInitialReachProbsWithBoard) {
     EXPECT_NEAR(total_prob_p0, 1.0, 1e-9) << "P0 probabilities do not sum to 1.0";
     EXPECT_NEAR(total_prob_p1, 1.0, 1e-9) << "P1 probabilities do not sum to 1.0";
 }
+
+TEST_F(PrivateCardsManagerTest, CompactsDeadHands) {
+    // Zero-weight hands are dropped along with board-blocked ones.
+    std::vector<PrivateCards> p0 = range_p0_;
+    p0[6] = PrivateCards(kc_, kd_, 0.0);   // KcKd, no weight
+    std::vector<std::vector<PrivateCards>> ranges = {p0, range_p1_};
+    uint64_t board_mask = Card::CardIntsToUint64({ah_, h5_, qs_});
+    PrivateCardsManager pcm(ranges, board_mask);
+
+    for (size_t p = 0; p < 2; ++p) {
+        const auto& compact = pcm.GetPlayerRange(p);
+        const auto& original = pcm.GetOriginalRange(p);
+        const auto& back = pcm.GetOriginalHandIndices(p);
+        ASSERT_EQ(back.size(), compact.size());
+        EXPECT_EQ(original.size(), ranges[p].size());
+        size_t kept = 0;
+        for (size_t h = 0; h < original.size(); ++h) {
+            bool dead = original[h].Weight() <= 0.0 ||
+                        Card::DoBoardsOverlap(original[h].GetBoardMask(), board_mask);
+            int c = pcm.GetCompactHandIndex(p, h);
+            if (dead) {
+                EXPECT_EQ(c, -1) << "player " << p << " hand " << original[h].ToString();
+                continue;
+            }
+            ASSERT_EQ(c, static_cast<int>(kept)); // Relative order is kept
+            EXPECT_EQ(back[c], static_cast<int32_t>(h));
+            EXPECT_EQ(compact[c], original[h]);
+            ++kept;
+        }
+        EXPECT_EQ(kept, compact.size());
+        EXPECT_EQ(pcm.GetInitialReachProbs(p).size(), compact.size());
+    }
+    // AhXx (3 AA, AhKh) and KcKd for P0; QsXx (3 QQ) and AhKx (3 AKo) for P1.
+    EXPECT_EQ(pcm.GetPlayerRange(0).size(), 16u - 5u);
+    EXPECT_EQ(pcm.GetPlayerRange(1).size(), 18u - 6u);
+    EXPECT_EQ(pcm.GetCompactHandIndex(0, 99), -1);
+    EXPECT_THROW(pcm.GetOriginalRange(2), std::out_of_range);
+    EXPECT_THROW(pcm.GetOriginalHandIndices(2), std::out_of_range);
+}
@@ -2,6 +2,7 @@
 #include "ranges/PrivateCards.h" // Adjust path if needed
 #include "Card.h"          // For Card validation/conversion
 
+#include <algorithm>
 #include <unordered_set>
 #include <vector>
 #include <stdexcept>
@@ -123,3 +124,32 @@ TEST_F(PrivateCardsTest, Hashing) {
   EXPECT_TRUE(card_set.insert(pc3).second); // Insert should succeed
   EXPECT_EQ(card_set.size(), 2);
 }
+
+// Dense combo indices cover 0..1325 once, with matching tables.
+TEST_F(PrivateCardsTest, ComboIndex) {
+  const HandIndexTables& tables = GetHandIndexTables();
+  std::vector<bool> seen(kNumHandCombos, false);
+  for (int c2 = 1; c2 < kNumCardsInDeck; ++c2) {
+    for (int c1 = 0; c1 < c2; ++c1) {
+      int combo = PrivateCards(c2, c1).GetComboIndex();
+      ASSERT_GE(combo, 0);
+      ASSERT_LT(combo, kNumHandCombos);
+      EXPECT_FALSE(seen[combo]);
+      seen[combo] = true;
+      EXPECT_EQ(combo, ComboIndex(c1, c2));
+      EXPECT_EQ(tables.card1[combo], c1);
+      EXPECT_EQ(tables.card2[combo], c2);
+    }
+  }
+  EXPECT_EQ(ComboIndex(0, 1), 0);
+  EXPECT_EQ(ComboIndex(50, 51), kNumHandCombos - 1);
+
+  // Each card's blocker list holds exactly the combos containing it.
+  for (int card = 0; card < kNumCardsInDeck; ++card) {
+    for (uint16_t combo : tables.blockers[card]) {
+      EXPECT_TRUE(tables.card1[combo] == card || tables.card2[combo] == card);
+    }
+    EXPECT_TRUE(std::is_sorted(tables.blockers[card].begin(), tables.blockers[card].end()));
+  }
+}
+
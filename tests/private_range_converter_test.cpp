@@ -177,3 +177,39 @@ TEST(PrivateRangeConverterTest, DuplicateDefinitions) {
     EXPECT_THROW(PrivateRangeConverter::StringToPrivateCards("QQ:0.5,QcQd:0.2"), std::invalid_argument);
 }
 
+
+// Interned ranges are shared per (range string, board) and match a fresh parse
+TEST(PrivateRangeConverterTest, SharedRangeCache) {
+    PrivateRangeConverter::ClearRangeCache();
+    std::vector<int> board = {Card::StringToInt("Ac").value(),
+                              Card::StringToInt("Kd").value(),
+                              Card::StringToInt("7h").value()};
+
+    auto first = PrivateRangeConverter::GetSharedRange("AKs,QQ:0.5, T9o", board);
+    auto again = PrivateRangeConverter::GetSharedRange(std::string("AKs,QQ:0.5, T9o"), board);
+    EXPECT_EQ(first.get(), again.get());
+    EXPECT_EQ(PrivateRangeConverter::GetRangeCacheSize(), 1u);
+
+    std::vector<PrivateCards> expected =
+        PrivateRangeConverter::StringToPrivateCards("AKs,QQ:0.5, T9o", board);
+    ASSERT_EQ(first->size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ((*first)[i], expected[i]);
+        EXPECT_DOUBLE_EQ((*first)[i].Weight(), expected[i].Weight());
+    }
+
+    // A different board is a different entry
+    auto preflop = PrivateRangeConverter::GetSharedRange("AKs,QQ:0.5, T9o");
+    EXPECT_NE(first.get(), preflop.get());
+    EXPECT_EQ(preflop->size(), 4u + 6u + 12u);
+    EXPECT_EQ(PrivateRangeConverter::GetRangeCacheSize(), 2u);
+
+    // Invalid strings throw and are not cached
+    EXPECT_THROW(PrivateRangeConverter::GetSharedRange("QQ:abc"), std::invalid_argument);
+    EXPECT_EQ(PrivateRangeConverter::GetRangeCacheSize(), 2u);
+
+    // Clearing keeps handed-out ranges alive
+    PrivateRangeConverter::ClearRangeCache();
+    EXPECT_EQ(PrivateRangeConverter::GetRangeCacheSize(), 0u);
+    EXPECT_EQ(first->size(), expected.size());
+}
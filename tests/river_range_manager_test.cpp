@@ -7,6 +7,7 @@
 #include <memory>
 #include <stdexcept>
 #include <optional>
+#include <atomic>
 #include <string>        // Include string for error message concatenation
 #include <sstream>       // Include sstream for HandVectorToString helper
 #include <iostream>      // For potential debug output
@@ -198,9 +199,9 @@ TEST_F(RiverRangeManagerTest, SortingOrder) {
 
 TEST_F(RiverRangeManagerTest, Caching) {
     ASSERT_NE(manager_, nullptr);
-    const auto& results1 = manager_->GetRiverCombos(0, range_p0_, board_mask_);
+    const auto& results1 = manager_->GetPackedRiverCombos(0, range_p0_, board_mask_);
     ASSERT_FALSE(results1.empty());
-    const auto& results2 = manager_->GetRiverCombos(0, range_p0_, board_mask_);
+    const auto& results2 = manager_->GetPackedRiverCombos(0, range_p0_, board_mask_);
     ASSERT_FALSE(results2.empty());
     EXPECT_EQ(&results1, &results2) << "Second call did not return the cached object.";
 
@@ -208,11 +209,11 @@ TEST_F(RiverRangeManagerTest, Caching) {
         Card::StringToInt("Kh").value(), Card::StringToInt("Ks").value(),
         Card::StringToInt("5c").value(), Card::StringToInt("8d").value(),
         Card::StringToInt("9h").value() });
-    const auto& results_p1_b2 = manager_->GetRiverCombos(1, range_p1_, board2_mask);
+    const auto& results_p1_b2 = manager_->GetPackedRiverCombos(1, range_p1_, board2_mask);
     ASSERT_FALSE(results_p1_b2.empty());
-    const auto& results_p1_b2_again = manager_->GetRiverCombos(1, range_p1_, board2_mask);
+    const auto& results_p1_b2_again = manager_->GetPackedRiverCombos(1, range_p1_, board2_mask);
     EXPECT_EQ(&results_p1_b2, &results_p1_b2_again);
-    const auto& results1_again = manager_->GetRiverCombos(0, range_p0_, board_mask_);
+    const auto& results1_again = manager_->GetPackedRiverCombos(0, range_p0_, board_mask_);
     EXPECT_EQ(&results1, &results1_again);
 }
 
@@ -229,10 +230,157 @@ TEST_F(RiverRangeManagerTest, InvalidInputs) {
 
 TEST_F(RiverRangeManagerTest, BoardVectorOverload) {
      ASSERT_NE(manager_, nullptr);
-     const auto& results_vec = manager_->GetRiverCombos(0, range_p0_, board_ints_);
-     const auto& results_mask = manager_->GetRiverCombos(0, range_p0_, board_mask_);
-     EXPECT_EQ(&results_vec, &results_mask);
+     const auto results_vec = manager_->GetRiverCombos(0, range_p0_, board_ints_);
+     const auto results_mask = manager_->GetRiverCombos(0, range_p0_, board_mask_);
+     ASSERT_EQ(results_vec.size(), results_mask.size());
+     for (size_t r = 0; r < results_vec.size(); ++r) {
+         EXPECT_EQ(results_vec[r].original_range_index, results_mask[r].original_range_index);
+     }
      EXPECT_EQ(results_vec.size(), 4); // Corrected Expected Size
+     EXPECT_EQ(manager_->GetCacheStats().misses, 1u); // Both overloads share the entry
      std::vector<int> board_4ints = {board_ints_[0], board_ints_[1], board_ints_[2], board_ints_[3]};
      EXPECT_THROW(manager_->GetRiverCombos(0, range_p0_, board_4ints), std::invalid_argument);
 }
+
+TEST_F(RiverRangeManagerTest, ComboIndexTables) {
+    ASSERT_NE(manager_, nullptr);
+    // Append a hand that conflicts with the board (5h is on the board).
+    std::vector<PrivateCards> range = range_p0_;
+    range.emplace_back(Card::StringToInt("5h").value(), Card::StringToInt("4h").value());
+
+    const auto combos = manager_->GetRiverCombos(0, range, board_mask_);
+    const auto& index = manager_->GetRiverComboIndex(0, range, board_mask_);
+    ASSERT_EQ(index.original_to_river.size(), range.size());
+    ASSERT_EQ(index.river_to_original.size(), combos.size());
+    EXPECT_EQ(index.original_to_river.back(), RiverComboIndex::kNotOnRiver);
+
+    for (size_t r = 0; r < combos.size(); ++r) {
+        size_t orig = static_cast<size_t>(index.river_to_original[r]);
+        EXPECT_EQ(orig, combos[r].original_range_index);
+        EXPECT_EQ(index.original_to_river[orig], static_cast<int32_t>(r));
+    }
+    // Shares the cache entry with GetRiverCombos.
+    EXPECT_EQ(&index, &manager_->GetRiverComboIndex(0, range, board_mask_));
+}
+
+TEST_F(RiverRangeManagerTest, PreloadedBoardsMatchLazyCache) {
+    ASSERT_NE(manager_, nullptr);
+    uint64_t turn_mask = board_mask_ & ~Card::CardIntToUint64(Card::StringToInt("Td").value());
+    manager_->PreloadRiverBoards(range_p0_, range_p1_, turn_mask);
+    EXPECT_EQ(manager_->GetNumPreloadedBoards(), 48u);
+
+    RiverRangeManager lazy(compairer_);
+    for (int card = 0; card < kNumCardsInDeck; ++card) {
+        uint64_t river = turn_mask | Card::CardIntToUint64(card);
+        if (river == turn_mask) continue;
+        for (size_t player = 0; player < 2; ++player) {
+            const auto& range = player == 0 ? range_p0_ : range_p1_;
+            const auto& preloaded = manager_->GetRiverCombos(player, range, river);
+            const auto& expected = lazy.GetRiverCombos(player, range, river);
+            ASSERT_EQ(preloaded.size(), expected.size()) << "card " << card;
+            for (size_t r = 0; r < preloaded.size(); ++r) {
+                EXPECT_EQ(preloaded[r].rank, expected[r].rank);
+                EXPECT_EQ(preloaded[r].original_range_index, expected[r].original_range_index);
+            }
+            EXPECT_EQ(manager_->GetRiverComboIndex(player, range, river).original_to_river,
+                      lazy.GetRiverComboIndex(player, range, river).original_to_river);
+        }
+    }
+
+    // Boards off the preloaded turn still go through the lazy cache.
+    uint64_t other = Card::CardIntsToUint64(StringsToInts({"Kh", "Ks", "5c", "8d", "9h"}));
+    EXPECT_EQ(manager_->GetRiverCombos(1, range_p1_, other).size(), lazy.GetRiverCombos(1, range_p1_, other).size());
+    EXPECT_THROW(manager_->GetRiverCombos(0, range_p0_, turn_mask), std::invalid_argument);
+    EXPECT_THROW(manager_->PreloadRiverBoards(range_p0_, range_p1_, board_mask_ | 1ULL), std::invalid_argument);
+}
+
+TEST_F(RiverRangeManagerTest, PreloadFromFlopCoversEveryTurnAndRiver) {
+    ASSERT_NE(manager_, nullptr);
+    uint64_t flop_mask = Card::CardIntsToUint64({board_ints_[0], board_ints_[1], board_ints_[2]});
+    manager_->PreloadRiverBoards(range_p0_, range_p1_, flop_mask);
+    EXPECT_EQ(manager_->GetNumPreloadedBoards(), 49u * 48u / 2u);
+    const auto& combos = manager_->GetPackedRiverCombos(0, range_p0_, board_mask_);
+    EXPECT_EQ(&combos, &manager_->GetPackedRiverCombos(0, range_p0_, board_mask_));
+    EXPECT_EQ(combos.size(), 4u);
+}
+
+TEST_F(RiverRangeManagerTest, PlacedPreloadComputesEveryBoard) {
+    ASSERT_NE(manager_, nullptr);
+    uint64_t flop_mask = Card::CardIntsToUint64({board_ints_[0], board_ints_[1], board_ints_[2]});
+    RiverPreloadPlacement placement;
+    placement.num_homes = 3;
+    placement.home_of_board = [](uint64_t board_mask) { return static_cast<size_t>(board_mask % 3); };
+    std::atomic<int> threads_entered{0};
+    placement.enter_thread = [&threads_entered](int thread, int num_threads) {
+        ++threads_entered;
+        return static_cast<size_t>(thread % num_threads);
+    };
+    manager_->PreloadRiverBoards(range_p0_, range_p1_, flop_mask, (1ULL << kNumCardsInDeck) - 1, &placement);
+    EXPECT_GE(threads_entered.load(), 1);
+
+    RiverRangeManager unplaced(compairer_);
+    unplaced.PreloadRiverBoards(range_p0_, range_p1_, flop_mask);
+    ASSERT_EQ(manager_->GetNumPreloadedBoards(), unplaced.GetNumPreloadedBoards());
+    EXPECT_EQ(manager_->GetPreloadedBytes(), unplaced.GetPreloadedBytes());
+    EXPECT_EQ(manager_->GetPackedRiverCombos(1, range_p1_, board_mask_).ranks,
+              unplaced.GetPackedRiverCombos(1, range_p1_, board_mask_).ranks);
+}
+
+TEST_F(RiverRangeManagerTest, MemoryBudgetEvictsAndCounts) {
+    ASSERT_NE(manager_, nullptr);
+    uint64_t turn_mask = board_mask_ & ~Card::CardIntToUint64(Card::StringToInt("Td").value());
+    std::vector<uint64_t> rivers;
+    for (int card = 0; card < kNumCardsInDeck; ++card) {
+        uint64_t river = turn_mask | Card::CardIntToUint64(card);
+        if (river != turn_mask) rivers.push_back(river);
+    }
+
+    manager_->GetRiverCombos(0, range_p0_, rivers[0]);
+    RiverCacheStats one = manager_->GetCacheStats();
+    EXPECT_EQ(one.misses, 1u);
+    EXPECT_EQ(one.entries, 1u);
+    ASSERT_GT(one.bytes, 0u);
+
+    // Room for about three boards of player 0.
+    manager_->SetMemoryBudget(3 * one.bytes + one.bytes / 2);
+    auto held = manager_->AcquireRiverCombos(0, range_p0_, rivers[0]);
+    PackedRiverCombos held_copy = *held;
+    for (uint64_t river : rivers) manager_->GetRiverCombos(0, range_p0_, river);
+    RiverCacheStats stats = manager_->GetCacheStats();
+    EXPECT_EQ(stats.hits, 2u); // The acquire and the first loop lookup
+    EXPECT_EQ(stats.misses, rivers.size());
+    EXPECT_EQ(stats.entries, 3u);
+    EXPECT_EQ(stats.evictions, rivers.size() - 3);
+    EXPECT_LE(stats.bytes, manager_->GetMemoryBudget());
+
+    // The evicted board's handle is still valid and a lookup recomputes it.
+    ASSERT_EQ(held->size(), held_copy.size());
+    EXPECT_EQ(held->ranks, held_copy.ranks);
+    EXPECT_EQ(manager_->GetRiverCombos(0, range_p0_, rivers[0]).size(), held_copy.size());
+
+    // Shrinking the budget evicts down to one board.
+    manager_->SetMemoryBudget(1);
+    EXPECT_EQ(manager_->GetCacheStats().entries, 1u);
+}
+
+TEST_F(RiverRangeManagerTest, PackedCombosMatchUnpacked) {
+    ASSERT_NE(manager_, nullptr);
+    // 22 and 33 both make trips of their own rank; add a second AK for a run.
+    std::vector<PrivateCards> range = range_p0_;
+    range.emplace_back(Card::StringToInt("Ad").value(), Card::StringToInt("Kc").value());
+    const auto& packed = manager_->GetPackedRiverCombos(0, range, board_mask_);
+    const auto combos = manager_->GetRiverCombos(0, range, board_mask_);
+    ASSERT_EQ(packed.size(), combos.size());
+    for (size_t r = 0; r < combos.size(); ++r) {
+        EXPECT_EQ(packed.ranks[r], combos[r].rank);
+        EXPECT_EQ(packed.original_indices[r], combos[r].original_range_index);
+        EXPECT_EQ(packed.card1s[r], combos[r].private_cards.Card1Int());
+        EXPECT_EQ(packed.card2s[r], combos[r].private_cards.Card2Int());
+    }
+    // The two AK straights share a run; the other three hands are alone.
+    ASSERT_EQ(packed.NumRuns(), 4u);
+    EXPECT_EQ(packed.run_starts.back(), packed.size());
+    EXPECT_EQ(packed.run_starts[3], 3u);
+    EXPECT_LT(packed.MemoryBytes(), combos.size() * sizeof(RiverCombs));
+}
+
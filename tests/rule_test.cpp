@@ -4,6 +4,7 @@
 #include "tools/StreetSetting.h"              // Adjust path
 #include "Deck.h"                          // Adjust path
 #include "nodes/GameTreeNode.h"                // For GameRound
+#include "tools/ScenarioFile.h"
 #include <vector>
 #include <stdexcept>
 #include <memory> // For std::unique_ptr
@@ -113,3 +114,57 @@ TEST(RuleConstructorValidationTest, InvalidInputs) {
   EXPECT_NO_THROW(Rule(deck, 50, 100, GameRound::kPreflop, empty_board, 3, 1, 2, 200, bs, 0.98));
   EXPECT_NO_THROW(Rule(deck, 50, 100, GameRound::kFlop, flop_board, 3, 1, 2, 200, bs, 0.98));
 }
+
+TEST(ScenarioFileTest, ParsesScenarioObject) {
+  Deck deck;
+  nlohmann::json j = nlohmann::json::parse(R"({
+    "test_case_name": "spot",
+    "solver_config": {"iterations": 50},
+    "game_rule": {
+      "starting_round": "Flop",
+      "initial_commitments": {"ip": 10, "oop": 10},
+      "effective_stack": 90,
+      "raise_limit_per_street": 2,
+      "initial_board": ["Ts", "Jh", "2h"],
+      "building_settings": {
+        "flop_ip": {"bet_sizes_percent": [33, 75], "allow_all_in": true},
+        "turn_ip": {}, "river_ip": {}, "flop_oop": {}, "turn_oop": {}, "river_oop": {}
+      }
+    },
+    "player_ranges": {"ip": "AA", "oop": "KK,QQ"}
+  })");
+  poker_solver::config::Scenario scenario = poker_solver::config::ScenarioFromJson(j, deck);
+  EXPECT_EQ(scenario.name, "spot");
+  EXPECT_EQ(scenario.iterations, 50);
+  EXPECT_EQ(scenario.threads, 0);
+  EXPECT_EQ(scenario.ranges[0], "AA");
+  EXPECT_EQ(scenario.ranges[1], "KK,QQ");
+  EXPECT_EQ(scenario.rule.GetStartingRound(), GameRound::kFlop);
+  EXPECT_EQ(scenario.rule.GetInitialBoardCardsInt().size(), 3u);
+  EXPECT_EQ(scenario.rule.GetRaiseLimitPerStreet(), 2);
+  EXPECT_DOUBLE_EQ(scenario.rule.GetInitialCommitment(0), 10);
+}
+
+TEST(ScenarioFileTest, RejectsBadRules) {
+  Deck deck;
+  nlohmann::json rule = {{"starting_round", "Flop"},
+                         {"effective_stack", 100},
+                         {"raise_limit_per_street", 1},
+                         {"initial_board", {"Ts", "Jh", "2h"}}};
+  EXPECT_NO_THROW(poker_solver::config::RuleFromJson(rule, deck));
+
+  nlohmann::json bad_round = rule;
+  bad_round["starting_round"] = "Fourth";
+  EXPECT_THROW(poker_solver::config::RuleFromJson(bad_round, deck), std::invalid_argument);
+
+  nlohmann::json bad_card = rule;
+  bad_card["initial_board"] = {"Ts", "Xx", "2h"};
+  EXPECT_THROW(poker_solver::config::RuleFromJson(bad_card, deck), std::invalid_argument);
+
+  nlohmann::json missing_stack = rule;
+  missing_stack.erase("effective_stack");
+  EXPECT_THROW(poker_solver::config::RuleFromJson(missing_stack, deck), std::invalid_argument);
+
+  nlohmann::json no_ranges = {{"game_rule", rule}};
+  EXPECT_THROW(poker_solver::config::ScenarioFromJson(no_ranges, deck), std::invalid_argument);
+}
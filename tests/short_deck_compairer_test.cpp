@@ -0,0 +1,85 @@
+#include "gtest/gtest.h"
+#include "compairer/ShortDeckCompairer.h"
+#include "Card.h"
+#include "Deck.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// Use namespaces for convenience
+using namespace poker_solver::core;
+using namespace poker_solver::eval;
+
+class ShortDeckCompairerTest : public ::testing::Test {
+ protected:
+  ShortDeckCompairer compairer_;
+
+  static uint64_t Mask(const std::vector<std::string>& cards) {
+      uint64_t mask = 0;
+      for (const auto& card : cards) mask |= 1ULL << Card::StringToInt(card).value();
+      return mask;
+  }
+
+  int Rank(const std::vector<std::string>& cards) const { return compairer_.RankOfMask(Mask(cards)); }
+};
+
+TEST_F(ShortDeckCompairerTest, CategoryOrder) {
+    int royal = Rank({"Ah", "Kh", "Qh", "Jh", "Th"});
+    int quads = Rank({"9c", "9d", "9h", "9s", "Ac"});
+    int flush = Rank({"6h", "7h", "8h", "Th", "Jh"});
+    int full_house = Rank({"Ac", "Ad", "Ah", "Kc", "Kd"});
+    int trips = Rank({"Ac", "Ad", "Ah", "Kc", "Qd"});
+    int straight = Rank({"Tc", "Jd", "Qh", "Kc", "Ad"});
+    int two_pair = Rank({"Ac", "Ad", "Kh", "Kc", "Qd"});
+    int pair = Rank({"Ac", "Ad", "Kh", "Qc", "Jd"});
+    int high_card = Rank({"6c", "7d", "8h", "9c", "Jd"});
+    EXPECT_EQ(royal, 1);
+    EXPECT_LT(royal, quads);
+    EXPECT_LT(quads, flush);
+    EXPECT_LT(flush, full_house); // Flushes are rarer with 36 cards
+    EXPECT_LT(full_house, trips);
+    EXPECT_LT(trips, straight);
+    EXPECT_LT(straight, two_pair);
+    EXPECT_LT(two_pair, pair);
+    EXPECT_LT(pair, high_card);
+    EXPECT_EQ(high_card, ShortDeckCompairer::kNumHandClasses);
+
+    // A-6-7-8-9 is the lowest straight, above any trips-free non-straight.
+    int wheel = Rank({"Ac", "6d", "7h", "8c", "9d"});
+    EXPECT_GT(wheel, Rank({"6c", "7d", "8h", "9c", "Td"}));
+    EXPECT_LT(wheel, two_pair);
+}
+
+TEST_F(ShortDeckCompairerTest, SevenCardsTakeBestFive) {
+    Deck deck = Deck::ShortDeck();
+    std::vector<int> deck_cards;
+    for (const auto& card : deck.GetCards()) deck_cards.push_back(card.card_int().value());
+    std::mt19937_64 rng(36);
+    for (int i = 0; i < 5000; ++i) {
+        std::shuffle(deck_cards.begin(), deck_cards.end(), rng);
+        int num_cards = ShortDeckCompairer::kMinCards + i % 3;
+        std::vector<int> cards(deck_cards.begin(), deck_cards.begin() + num_cards);
+        uint64_t mask = Card::CardIntsToUint64(cards);
+        int best = ShortDeckCompairer::kInvalidRank;
+        for (uint64_t subset = mask; subset != 0; subset = (subset - 1) & mask) {
+            if (__builtin_popcountll(subset) == ShortDeckCompairer::kMinCards) {
+                best = std::min(best, compairer_.RankOfMask(subset));
+            }
+        }
+        ASSERT_EQ(compairer_.RankOfMask(mask), best) << "mask 0x" << std::hex << mask;
+    }
+}
+
+TEST_F(ShortDeckCompairerTest, InvalidInputsAndComparisons) {
+    EXPECT_EQ(Rank({"2c", "6d", "7h", "8c", "9d"}), ShortDeckCompairer::kInvalidRank); // Not in the deck
+    EXPECT_EQ(Rank({"6d", "7h", "8c", "9d"}), ShortDeckCompairer::kInvalidRank);
+
+    uint64_t board = Mask({"6h", "7h", "8h", "Kc", "Kd"});
+    uint64_t flush = Mask({"Ah", "Jh"});
+    uint64_t boat = Mask({"Ks", "6c"});
+    EXPECT_EQ(compairer_.CompareHands(flush, boat, board), ComparisonResult::kPlayer1Wins);
+    EXPECT_EQ(compairer_.GetHandRank(Mask({"6h", "Ac"}), board), ShortDeckCompairer::kInvalidRank);
+    EXPECT_EQ(compairer_.CompareHands(Mask({"Ah", "Jc"}), Mask({"Ah", "Td"}), board), ComparisonResult::kTie);
+}
@@ -0,0 +1,175 @@
+#include "gtest/gtest.h"
+#include "solver/PCfrSolver.h"
+#include "solver/ShowdownBackend.h"
+#include "toy_spot.h"
+#include "ranges/PrivateCards.h"
+#include "tools/Rule.h"
+#include "Deck.h"
+#include "Card.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Use namespaces
+using namespace poker_solver::core;
+using namespace poker_solver::config;
+using namespace poker_solver::ranges;
+using namespace poker_solver::solver;
+using namespace poker_solver::tree;
+
+namespace {
+
+// Forwards to the CPU backend, recording the batch sizes it sees.
+class CountingBackend : public ShowdownBackend {
+ public:
+  const char* Name() const override { return "counting"; }
+  void EvaluateShowdowns(const Batch& batch) override {
+      ++batches;
+      boards += batch.num_boards;
+      size_t seen = largest_batch.load();
+      while (batch.num_boards > seen && !largest_batch.compare_exchange_weak(seen, batch.num_boards)) {}
+      cpu_.EvaluateShowdowns(batch);
+  }
+
+  std::atomic<size_t> batches{0};
+  std::atomic<size_t> boards{0};
+  std::atomic<size_t> largest_batch{0};
+
+ private:
+  CpuShowdownBackend cpu_;
+};
+
+// Fails every batch, as a backend that lost its device would.
+class FailingBackend : public ShowdownBackend {
+ public:
+  const char* Name() const override { return "failing"; }
+  void EvaluateShowdowns(const Batch&) override { throw std::runtime_error("device lost"); }
+};
+
+} // namespace
+
+// A flop spot with all-in, so the river chance nodes after an all-in lead
+// straight to a showdown and their runouts reach the backend as batches.
+class ShowdownBackendTest : public ::testing::Test {
+ protected:
+  Deck deck_;
+  std::vector<int> board_ = test_support::FlopBoard();
+  std::unique_ptr<Rule> rule_;
+
+  void SetUp() override {
+      rule_ = std::make_unique<Rule>(test_support::MakeSpotRule(deck_, board_));
+  }
+
+  std::vector<PrivateCards> MakeRange(int first_card, int last_card) const {
+      return test_support::MakeRange(first_card, last_card, board_);
+  }
+
+  static void ExpectSameStrategies(const json& expected, const json& actual, const std::string& where) {
+      ASSERT_EQ(expected["node_type"], actual["node_type"]) << where;
+      if (expected.contains("strategy_data")) {
+          const json& expected_strategy = expected["strategy_data"]["strategy"];
+          const json& actual_strategy = actual["strategy_data"]["strategy"];
+          for (auto it = expected_strategy.begin(); it != expected_strategy.end(); ++it) {
+              for (size_t a = 0; a < it.value().size(); ++a) {
+                  EXPECT_NEAR(it.value()[a].get<double>(), actual_strategy[it.key()][a].get<double>(), 1e-9)
+                      << where << " " << it.key();
+              }
+          }
+      }
+      if (!expected.contains("children")) return;
+      for (auto it = expected["children"].begin(); it != expected["children"].end(); ++it) {
+          ExpectSameStrategies(it.value(), actual["children"][it.key()], where + "/" + it.key());
+      }
+  }
+
+  std::unique_ptr<PCfrSolver> MakeSolver(PCfrSolver::Config config) const {
+      config.iteration_limit = 3;
+      return test_support::MakeToySolver(*rule_, {MakeRange(0, 16), MakeRange(8, 24)}, config);
+  }
+
+  json Solve(PCfrSolver::Config config, std::shared_ptr<ShowdownBackend> backend) {
+      auto solver = MakeSolver(config);
+      solver->SetShowdownBackend(std::move(backend));
+      solver->Train();
+      return solver->DumpStrategy(false);
+  }
+};
+
+TEST_F(ShowdownBackendTest, BatchesAllInRunouts) {
+    PCfrSolver::Config config;
+    config.num_threads = 1;
+    config.parallel_level = PCfrSolver::ParallelLevel::kNone;
+    const json expected = Solve(config, nullptr); // The default CPU backend
+
+    auto counting = std::make_shared<CountingBackend>();
+    EXPECT_EQ(Solve(config, counting), expected);
+    EXPECT_GT(counting->batches.load(), 0u);
+    // A flop all-in deals turn and river, one board per pair of the 49
+    // cards left in the deck.
+    EXPECT_GT(counting->largest_batch.load(), 48u);
+    EXPECT_LE(counting->largest_batch.load(), 49u * 48u / 2u);
+    EXPECT_GT(counting->boards.load(), counting->batches.load());
+}
+
+TEST_F(ShowdownBackendTest, BatchesInsideParallelOutcomes) {
+    PCfrSolver::Config serial;
+    serial.num_threads = 1;
+    serial.parallel_level = PCfrSolver::ParallelLevel::kNone;
+    const json expected = Solve(serial, nullptr);
+
+    // The turn is the fan-out; the river runouts under it are still batched,
+    // from every thread at once.
+    PCfrSolver::Config threaded;
+    threaded.num_threads = 4;
+    threaded.parallel_level = PCfrSolver::ParallelLevel::kOutermostChance;
+    auto counting = std::make_shared<CountingBackend>();
+    EXPECT_EQ(Solve(threaded, counting), expected);
+    EXPECT_GT(counting->largest_batch.load(), 1u);
+}
+
+TEST_F(ShowdownBackendTest, FlopAllInsEvaluateEachBoardOnce) {
+    // Nothing on this board and ranges is suit-isomorphic, so
+    // use_isomorphism only keeps the turn-then-river outcome loop.
+    PCfrSolver::Config outcome_loop;
+    outcome_loop.num_threads = 1;
+    outcome_loop.parallel_level = PCfrSolver::ParallelLevel::kNone;
+    outcome_loop.use_isomorphism = true;
+    const json expected = Solve(outcome_loop, nullptr);
+
+    for (int threads : {1, 4}) {
+        PCfrSolver::Config config;
+        config.num_threads = threads;
+        ExpectSameStrategies(expected, Solve(config, nullptr), "threads " + std::to_string(threads));
+    }
+}
+
+TEST_F(ShowdownBackendTest, BackendErrorsReachTheCaller) {
+    // The backend runs inside tasks or the threads of a chance fan-out; the
+    // error still ends Train() rather than the process.
+    for (auto level : {PCfrSolver::ParallelLevel::kNone, PCfrSolver::ParallelLevel::kOutermostChance}) {
+        PCfrSolver::Config config;
+        config.num_threads = 4;
+        config.parallel_level = level;
+        EXPECT_THROW(Solve(config, std::make_shared<FailingBackend>()), std::runtime_error);
+    }
+    PCfrSolver::Config config;
+    config.num_threads = 4;
+    config.parallel_level = PCfrSolver::ParallelLevel::kTasks;
+    config.task_cutoff = 0.0;
+    EXPECT_THROW(Solve(config, std::make_shared<FailingBackend>()), std::runtime_error);
+
+    auto solver = MakeSolver(config);
+    solver->Train();
+    solver->SetShowdownBackend(std::make_shared<FailingBackend>());
+    EXPECT_THROW(solver->ComputeExploitability(), std::runtime_error);
+    EXPECT_THROW(solver->ComputeEvs(), std::runtime_error);
+    EXPECT_THROW(solver->ExtractSubgame({}), std::runtime_error);
+    EXPECT_FALSE(solver->EvsCalculated());
+    // The failed passes left no evaluation mode behind.
+    solver->SetShowdownBackend(nullptr);
+    solver->ComputeEvs();
+    EXPECT_TRUE(solver->EvsCalculated());
+}
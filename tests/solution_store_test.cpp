@@ -0,0 +1,176 @@
+#include "gtest/gtest.h"
+#include "solver/SolutionStore.h"
+#include "solver/BatchSolver.h"
+#include "solver/PCfrSolver.h"
+#include "solver/StrategyFile.h"
+#include "toy_compairer.h"
+#include "ranges/PrivateCardsManager.h"
+#include "ranges/RiverRangeManager.h"
+#include "tools/PrivateRangeConverter.h"
+#include "tools/ScenarioFile.h"
+#include "tools/Rule.h"
+#include "tools/GameTreeBuildingSettings.h"
+#include "tools/StreetSetting.h"
+#include "GameTree.h"
+#include "Deck.h"
+#include "Card.h"
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace poker_solver::core;
+using namespace poker_solver::config;
+using namespace poker_solver::ranges;
+using namespace poker_solver::solver;
+using namespace poker_solver::tree;
+
+// One turn spot on two boards that differ only by swapping clubs and hearts.
+class SolutionStoreTest : public ::testing::Test {
+ protected:
+  Deck deck_;
+  StreetSetting setting_{{50.0}, {100.0}, {}, true};
+  GameTreeBuildingSettings build_settings_{setting_, setting_, setting_,
+                                           setting_, setting_, setting_};
+  std::shared_ptr<Compairer> compairer_ = std::make_shared<test_support::ToyCompairer>();
+  std::string directory_;
+
+  void SetUp() override {
+      directory_ = ::testing::TempDir() + "solution_store_test_" +
+                   ::testing::UnitTest::GetInstance()->current_test_info()->name();
+      std::filesystem::remove_all(directory_);
+  }
+  void TearDown() override { std::filesystem::remove_all(directory_); }
+
+  static std::vector<int> Board(const std::vector<std::string>& cards) {
+      std::vector<int> board;
+      for (const std::string& card : cards) board.push_back(Card::StringToInt(card).value());
+      return board;
+  }
+  std::vector<int> Board() const { return Board({"Ac", "Kd", "5h", "9s"}); }
+  std::vector<int> SwappedBoard() const { return Board({"Ah", "Kd", "5c", "9s"}); }
+
+  BatchSpot MakeSpot(const std::vector<int>& board, const GameTreeBuildingSettings& bets) const {
+      Scenario scenario{"spot", "", Rule(deck_, 10.0, 10.0, GameRound::kTurn, board, 1, 0.5, 1.0, 50.0, bets),
+                        {"QQ,JJ,AQs", "TT,KQs"}};
+      BatchSpot spot{scenario, PCfrSolver::Config()};
+      spot.config.iteration_limit = 5;
+      return spot;
+  }
+  BatchSpot MakeSpot(const std::vector<int>& board) const { return MakeSpot(board, build_settings_); }
+
+  static std::vector<std::vector<PrivateCards>> Ranges(const BatchSpot& spot) {
+      std::vector<std::vector<PrivateCards>> player_ranges;
+      for (const std::string& range : spot.scenario.ranges) {
+          player_ranges.push_back(
+              PrivateRangeConverter::StringToPrivateCards(range, spot.scenario.rule.GetInitialBoardCardsInt()));
+      }
+      return player_ranges;
+  }
+  static SpotKey Key(const BatchSpot& spot) { return SpotKey::Make(spot.scenario.rule, Ranges(spot), spot.config); }
+};
+
+// --- Tests ---
+
+TEST_F(SolutionStoreTest, KeysIgnoreSuitsButNotSettings) {
+    const BatchSpot spot = MakeSpot(Board());
+    const BatchSpot swapped = MakeSpot(SwappedBoard());
+    const SpotKey key = Key(spot);
+    const SpotKey swapped_key = Key(swapped);
+    EXPECT_EQ(key.canonical, swapped_key.canonical);
+    EXPECT_EQ(key.fingerprint, swapped_key.fingerprint);
+    // Both aces land on the same canonical card.
+    EXPECT_EQ(MapCardSuit(Card::StringToInt("Ac").value(), key.to_canonical_suit),
+              MapCardSuit(Card::StringToInt("Ah").value(), swapped_key.to_canonical_suit));
+
+    BatchSpot threads = spot;
+    threads.config.num_threads = 4;
+    EXPECT_EQ(Key(threads).canonical, key.canonical);
+
+    BatchSpot iterations = spot;
+    iterations.config.iteration_limit = 6;
+    EXPECT_NE(Key(iterations).fingerprint, key.fingerprint);
+    StreetSetting larger{{75.0}, {100.0}, {}, true};
+    const BatchSpot bets = MakeSpot(Board(), GameTreeBuildingSettings(setting_, setting_, larger, setting_,
+                                                                      setting_, setting_));
+    EXPECT_NE(Key(bets).fingerprint, key.fingerprint);
+    BatchSpot range = spot;
+    range.scenario.ranges[1] = "TT,KQs,99";
+    EXPECT_NE(Key(range).fingerprint, key.fingerprint);
+    BatchSpot bucketed = spot;
+    bucketed.config.abstraction_buckets = 8;
+    EXPECT_NE(Key(bucketed).fingerprint, key.fingerprint);
+    BatchSpot coarser = spot;
+    coarser.config.abstraction_buckets = 4;
+    EXPECT_NE(Key(coarser).fingerprint, Key(bucketed).fingerprint);
+    BatchSpot warmed_up = spot;
+    warmed_up.config.average_warmup_iterations = 20;
+    EXPECT_NE(Key(warmed_up).fingerprint, key.fingerprint);
+    BatchSpot sparse = spot;
+    sparse.config.average_interval = 3;
+    EXPECT_NE(Key(sparse).fingerprint, key.fingerprint);
+    EXPECT_NE(Key(sparse).fingerprint, Key(warmed_up).fingerprint);
+}
+
+TEST_F(SolutionStoreTest, LookupsMapSuitsAndRejectOtherKeys) {
+    SolutionStore store(directory_);
+    const BatchSpot spot = MakeSpot(Board());
+    const SpotKey key = Key(spot);
+    EXPECT_FALSE(store.Lookup(key).has_value());
+
+    auto pcm = std::make_shared<PrivateCardsManager>(Ranges(spot), Card::CardIntsToUint64(Board()));
+    PCfrSolver solver(std::make_shared<GameTree>(spot.scenario.rule), pcm,
+                      std::make_shared<RiverRangeManager>(compairer_), spot.scenario.rule, spot.config);
+    solver.Train();
+    store.Store(key, solver);
+
+    // The swapped spot finds the entry, with clubs and hearts exchanged.
+    const std::optional<SolutionStore::Hit> hit = store.Lookup(Key(MakeSpot(SwappedBoard())));
+    ASSERT_TRUE(hit.has_value());
+    const int clubs = Card::SuitCharToIndex('c');
+    const int hearts = Card::SuitCharToIndex('h');
+    const int diamonds = Card::SuitCharToIndex('d');
+    EXPECT_EQ(hit->suit_map[clubs], hearts);
+    EXPECT_EQ(hit->suit_map[hearts], clubs);
+    EXPECT_EQ(hit->suit_map[diamonds], diamonds);
+    StrategyFile file(hit->strategy_path);
+    EXPECT_TRUE(file.Find("CHECK").has_value());
+    const int card = MapCardSuit(Card::StringToInt("Qc").value(), hit->suit_map);
+    EXPECT_EQ(Card::IntToString(card), "Qh");
+
+    // An entry whose full key differs (a fingerprint collision) is a miss.
+    const std::string key_path = std::filesystem::path(hit->strategy_path).replace_extension(".key").string();
+    {
+        std::ofstream out(key_path, std::ios::binary | std::ios::trunc);
+        out << "another spot\nsuits=0123\n";
+    }
+    EXPECT_FALSE(store.Lookup(key).has_value());
+    EXPECT_THROW(SolutionStore(""), std::invalid_argument);
+}
+
+TEST_F(SolutionStoreTest, BatchesReuseStoredSolutions) {
+    BatchSolver::Options options;
+    options.num_threads = 1;
+    options.solution_store = std::make_shared<SolutionStore>(directory_);
+    BatchSolver batch(compairer_, options);
+    size_t callbacks = 0;
+    auto count = [&](size_t, PCfrSolver&) { ++callbacks; };
+
+    std::vector<BatchSpotResult> first = batch.Solve({MakeSpot(Board())}, count);
+    ASSERT_TRUE(first[0].solved) << first[0].error;
+    EXPECT_FALSE(first[0].cached.has_value());
+    EXPECT_EQ(callbacks, 1u);
+
+    std::vector<BatchSpotResult> second = batch.Solve({MakeSpot(SwappedBoard()), MakeSpot(Board())}, count);
+    EXPECT_EQ(callbacks, 1u);
+    for (const BatchSpotResult& result : second) {
+        EXPECT_TRUE(result.solved) << result.error;
+        ASSERT_TRUE(result.cached.has_value());
+        EXPECT_EQ(result.iterations, 0);
+        EXPECT_EQ(StrategyFile(result.cached->strategy_path).NumNodes(),
+                  StrategyFile(second[0].cached->strategy_path).NumNodes());
+    }
+    EXPECT_EQ(second[1].cached->suit_map[Card::SuitCharToIndex('c')], Card::SuitCharToIndex('c'));
+    EXPECT_EQ(second[0].cached->suit_map[Card::SuitCharToIndex('c')], Card::SuitCharToIndex('h'));
+}
@@ -0,0 +1,140 @@
+#include "gtest/gtest.h"
+#include "solver/SolveService.h"
+#include "solver/StrategyFile.h"
+#include "toy_compairer.h"
+#include "tools/ScenarioFile.h"
+#include "tools/Rule.h"
+#include "tools/GameTreeBuildingSettings.h"
+#include "tools/StreetSetting.h"
+#include "Deck.h"
+#include "Card.h"
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace poker_solver::core;
+using namespace poker_solver::config;
+using namespace poker_solver::solver;
+
+// Small turn jobs on one service thread, recording every event.
+class SolveServiceTest : public ::testing::Test {
+ protected:
+  Deck deck_;
+  StreetSetting setting_{{50.0}, {100.0}, {}, true};
+  GameTreeBuildingSettings build_settings_{setting_, setting_, setting_,
+                                           setting_, setting_, setting_};
+  std::vector<int> board_ = {Card::StringToInt("Ac").value(), Card::StringToInt("Kd").value(),
+                             Card::StringToInt("5h").value(), Card::StringToInt("9s").value()};
+  std::shared_ptr<Compairer> compairer_ = std::make_shared<test_support::ToyCompairer>();
+  std::mutex events_mutex_;
+  std::vector<SolveJobStatus> events_;
+
+  SolveService::EventCallback Recorder() {
+      return [this](const SolveJobStatus& status) {
+          std::lock_guard<std::mutex> lock(events_mutex_);
+          events_.push_back(status);
+      };
+  }
+
+  SolveJob MakeJob(int iterations, int priority = 0, const std::string& ip_range = "QQ,JJ,AQs") const {
+      Scenario scenario{"job", "",
+                        Rule(deck_, 10.0, 10.0, GameRound::kTurn, board_, 1, 0.5, 1.0, 50.0, build_settings_),
+                        {ip_range, "TT,KQs"}};
+      PCfrSolver::Config config;
+      config.iteration_limit = iterations;
+      return SolveJob{std::move(scenario), config, priority, std::string()};
+  }
+
+  // Job ids in the order they started running.
+  std::vector<uint64_t> StartOrder() {
+      std::lock_guard<std::mutex> lock(events_mutex_);
+      std::vector<uint64_t> order;
+      for (const SolveJobStatus& event : events_) {
+          if (event.state == SolveJobState::kRunning && !event.progress) order.push_back(event.id);
+      }
+      return order;
+  }
+};
+
+// --- Tests ---
+
+TEST_F(SolveServiceTest, ReportsProgressAndWritesOutput) {
+    const std::string output = ::testing::TempDir() + "solve_service_test.strategy";
+    std::remove(output.c_str());
+    SolveService::Options options;
+    options.num_threads = 1;
+    SolveService service(compairer_, options, Recorder());
+    SolveJob job = MakeJob(8);
+    job.output_path = output;
+    const uint64_t id = service.Submit(job);
+    EXPECT_EQ(id, 1u);
+
+    const std::optional<SolveJobStatus> status = service.Wait(id);
+    ASSERT_TRUE(status.has_value());
+    EXPECT_EQ(status->state, SolveJobState::kDone) << status->error;
+    ASSERT_TRUE(status->progress.has_value());
+    EXPECT_EQ(status->progress->iteration, 8);
+    EXPECT_GT(status->seconds, 0.0);
+    EXPECT_GT(StrategyFile(output).NumNodes(), 0u);
+
+    // running, progress with rising iterations, then done.
+    std::lock_guard<std::mutex> lock(events_mutex_);
+    ASSERT_GE(events_.size(), 2u);
+    EXPECT_EQ(events_.front().state, SolveJobState::kRunning);
+    EXPECT_FALSE(events_.front().progress.has_value());
+    EXPECT_EQ(events_.back().state, SolveJobState::kDone);
+    int last_iteration = 0;
+    for (size_t i = 1; i + 1 < events_.size(); ++i) {
+        ASSERT_TRUE(events_[i].progress.has_value());
+        EXPECT_GT(events_[i].progress->iteration, last_iteration);
+        last_iteration = events_[i].progress->iteration;
+    }
+    std::remove(output.c_str());
+}
+
+TEST_F(SolveServiceTest, RunsByPriorityAndCancels) {
+    SolveService::Options options;
+    options.num_threads = 2;
+    SolveService service(compairer_, options, Recorder());
+    // The blocker takes the whole budget until it is cancelled.
+    SolveJob blocker = MakeJob(1000000);
+    blocker.config.num_threads = 2;
+    const uint64_t blocker_id = service.Submit(blocker);
+    while (service.Status(blocker_id)->state == SolveJobState::kQueued) std::this_thread::yield();
+    const uint64_t low = service.Submit(MakeJob(3, 0));
+    const uint64_t high = service.Submit(MakeJob(3, 5));
+    const uint64_t dropped = service.Submit(MakeJob(3, 1));
+    EXPECT_TRUE(service.Cancel(dropped));
+    EXPECT_EQ(service.Status(dropped)->state, SolveJobState::kCancelled);
+    EXPECT_EQ(service.Status(low)->state, SolveJobState::kQueued);
+    EXPECT_TRUE(service.Cancel(blocker_id));
+
+    EXPECT_EQ(service.Wait(blocker_id)->state, SolveJobState::kCancelled);
+    EXPECT_EQ(service.Wait(high)->state, SolveJobState::kDone);
+    EXPECT_EQ(service.Wait(low)->state, SolveJobState::kDone);
+    EXPECT_EQ(service.Wait(dropped)->state, SolveJobState::kCancelled);
+    EXPECT_FALSE(service.Cancel(low));
+    EXPECT_EQ(StartOrder(), (std::vector<uint64_t>{blocker_id, high, low}));
+    EXPECT_FALSE(service.Status(99).has_value());
+}
+
+TEST_F(SolveServiceTest, FailuresAndShutdown) {
+    SolveService::Options options;
+    options.num_threads = 1;
+    SolveService service(compairer_, options, Recorder());
+    const uint64_t bad = service.Submit(MakeJob(3, 0, "not a range"));
+    const uint64_t good = service.Submit(MakeJob(3));
+    service.WaitIdle();
+    EXPECT_EQ(service.Status(bad)->state, SolveJobState::kFailed);
+    EXPECT_FALSE(service.Status(bad)->error.empty());
+    EXPECT_EQ(service.Status(good)->state, SolveJobState::kDone);
+
+    service.Shutdown();
+    EXPECT_THROW(service.Submit(MakeJob(3)), std::logic_error);
+    EXPECT_THROW(SolveService(nullptr), std::invalid_argument);
+}
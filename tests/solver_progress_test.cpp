@@ -0,0 +1,66 @@
+#include "gtest/gtest.h"
+#include "solver/SolverProgress.h"
+#include <thread>
+#include <vector>
+
+using namespace poker_solver::solver;
+
+TEST(SolverProgressQueueTest, PopsInOrderAndDropsWhenFull) {
+    SolverProgressQueue queue(3);
+    EXPECT_EQ(queue.Capacity(), 4u); // Rounded up to a power of two
+    EXPECT_FALSE(queue.Pop().has_value());
+    for (int i = 1; i <= 6; ++i) {
+        SolverProgress progress;
+        progress.iteration = i;
+        EXPECT_EQ(queue.Push(progress), i <= 4);
+    }
+    EXPECT_EQ(queue.Dropped(), 2u);
+    for (int i = 1; i <= 4; ++i) {
+        auto progress = queue.Pop();
+        ASSERT_TRUE(progress.has_value());
+        EXPECT_EQ(progress->iteration, i);
+    }
+    EXPECT_FALSE(queue.Pop().has_value());
+
+    // Slots are reused once popped.
+    SolverProgress progress;
+    progress.iteration = 7;
+    EXPECT_TRUE(queue.Push(progress));
+    EXPECT_EQ(queue.Pop()->iteration, 7);
+}
+
+TEST(SolverProgressQueueTest, ProducerAndConsumerThreads) {
+    constexpr int kReports = 100000;
+    SolverProgressQueue queue(64);
+    std::thread producer([&] {
+        for (int i = 1; i <= kReports; ++i) {
+            SolverProgress progress;
+            progress.iteration = i;
+            progress.elapsed_seconds = i * 0.5;
+            queue.Push(progress);
+        }
+    });
+    // Whatever is not dropped arrives in order and intact.
+    std::vector<int> seen;
+    int last = 0;
+    while (last < kReports && static_cast<uint64_t>(seen.size()) + queue.Dropped() < kReports) {
+        if (auto progress = queue.Pop()) {
+            EXPECT_GT(progress->iteration, last);
+            EXPECT_DOUBLE_EQ(progress->elapsed_seconds, progress->iteration * 0.5);
+            last = progress->iteration;
+            seen.push_back(last);
+        }
+    }
+    producer.join();
+    while (auto progress = queue.Pop()) seen.push_back(progress->iteration);
+    EXPECT_EQ(seen.size() + queue.Dropped(), static_cast<size_t>(kReports));
+}
+
+TEST(SolverProgressTest, MemoryQueries) {
+#if defined(__linux__)
+    EXPECT_GT(CurrentResidentBytes(), 0u);
+    EXPECT_GT(PhysicalMemoryBytes(), CurrentResidentBytes());
+#else
+    GTEST_SKIP() << "Memory sizes are only read on Linux.";
+#endif
+}
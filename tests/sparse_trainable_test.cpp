@@ -0,0 +1,147 @@
+#include "gtest/gtest.h"
+#include "trainable/SparseDiscountedCfrTrainable.h"
+#include "trainable/DiscountedCfrTrainable.h"
+#include "nodes/ActionNode.h"
+#include "nodes/TerminalNode.h"
+#include "nodes/GameActions.h"
+#include "nodes/GameTreeNode.h"
+#include "ranges/PrivateCards.h"
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+// Use namespaces
+using namespace poker_solver::core;
+using namespace poker_solver::nodes;
+using namespace poker_solver::solver;
+
+// Visits in which only some hands reach the node: the sparse trainable
+// must follow the dense one on those hands.
+class SparseTrainableTest : public ::testing::Test {
+ protected:
+  std::vector<PrivateCards> player_range_;
+  std::shared_ptr<ActionNode> action_node_;
+  const size_t kNumActions = 3;
+
+  void SetUp() override {
+      for (int c = 0; c + 1 < 24; c += 2) {
+          player_range_.emplace_back(c, c + 1);
+      }
+      action_node_ = std::make_shared<ActionNode>(
+          0, GameRound::kRiver, 10.0, std::weak_ptr<GameTreeNode>(), 1);
+      auto terminal = std::make_shared<TerminalNode>(std::vector<double>{0.0, 0.0}, GameRound::kRiver, 10.0,
+                                                     std::weak_ptr<GameTreeNode>(action_node_));
+      action_node_->AddChild(GameAction(PokerAction::kCheck), terminal);
+      action_node_->AddChild(GameAction(PokerAction::kBet, 5.0), terminal);
+      action_node_->AddChild(GameAction(PokerAction::kBet, 10.0), terminal);
+      action_node_->SetPlayerRange(&player_range_);
+  }
+
+  // Visits every trainable with the same random regrets; only the hands in
+  // 'reaching' get a reach. Each plays its own current strategy.
+  void Visit(std::vector<Trainable*> trainables, const std::vector<uint32_t>& reaching, int first_iteration,
+             int iterations) {
+      std::mt19937 rng(5 + first_iteration);
+      std::uniform_real_distribution<double> regret_dist(-5.0, 5.0);
+      std::uniform_real_distribution<double> reach_dist(0.1, 1.0);
+      const size_t num_hands = player_range_.size();
+      std::vector<double> scratch(num_hands * kNumActions);
+      for (int t = first_iteration; t < first_iteration + iterations; ++t) {
+          std::vector<double> regrets(num_hands * kNumActions);
+          std::vector<double> reach(num_hands, 0.0);
+          for (auto& r : regrets) r = regret_dist(rng);
+          for (uint32_t h : reaching) reach[h] = reach_dist(rng);
+          for (auto* trainable : trainables) {
+              const double* played = trainable->CurrentStrategy(scratch.data());
+              trainable->UpdateFromVisit(regrets.data(), played, reach.data(), IterationDiscounts::For(t));
+          }
+      }
+  }
+};
+
+// --- Tests ---
+
+TEST_F(SparseTrainableTest, MatchesDenseOnLiveHands) {
+    const std::vector<uint32_t> live = {1, 4, 5, 9};
+    DiscountedCfrTrainable dense(&player_range_, *action_node_);
+    SparseDiscountedCfrTrainable sparse(&player_range_, *action_node_, live);
+    SparseDiscountedCfrTrainable lazy(&player_range_, *action_node_, live, true);
+    Visit({&dense, &sparse, &lazy}, live, 1, 30);
+    EXPECT_EQ(sparse.NumLiveHands(), live.size());
+
+    std::vector<double> dense_current = dense.GetCurrentStrategy();
+    std::vector<double> dense_average = dense.GetAverageStrategy();
+    std::vector<double> sparse_current = sparse.GetCurrentStrategy();
+    std::vector<double> sparse_average = sparse.GetAverageStrategy();
+    std::vector<double> lazy_current = lazy.GetCurrentStrategy();
+    ASSERT_EQ(sparse_current.size(), dense_current.size());
+    for (size_t h = 0; h < player_range_.size(); ++h) {
+        for (size_t a = 0; a < kNumActions; ++a) {
+            const size_t i = h * kNumActions + a;
+            EXPECT_EQ(lazy_current[i], sparse_current[i]);
+            if (sparse.IsLive(h)) {
+                EXPECT_EQ(sparse_current[i], dense_current[i]);
+                EXPECT_EQ(sparse_average[i], dense_average[i]);
+            } else {
+                EXPECT_DOUBLE_EQ(sparse_current[i], 1.0 / 3.0);
+                EXPECT_DOUBLE_EQ(sparse_average[i], 1.0 / 3.0);
+            }
+        }
+    }
+    EXPECT_LT(sparse.TableBytes(), DiscountedCfrTrainable::BlockDoubles(player_range_.size() * kNumActions, false) *
+                                       sizeof(double));
+}
+
+TEST_F(SparseTrainableTest, ReachingHandsBecomeLive) {
+    SparseDiscountedCfrTrainable sparse(&player_range_, *action_node_, {2, 7});
+    DiscountedCfrTrainable fresh(&player_range_, *action_node_);
+    Visit({&sparse}, {2, 7}, 1, 5);
+    // Hand 3 joins with zero state, like a dense trainable it never reached.
+    Visit({&sparse, &fresh}, {3}, 6, 4);
+    EXPECT_TRUE(sparse.IsLive(3));
+    EXPECT_EQ(sparse.NumLiveHands(), 3u);
+    std::vector<double> regrets(kNumActions), sums(kNumActions);
+    std::vector<double> expected_regrets(kNumActions), expected_sums(kNumActions);
+    sparse.GetHandState(3, regrets.data(), sums.data());
+    fresh.GetHandState(3, expected_regrets.data(), expected_sums.data());
+    EXPECT_EQ(regrets, expected_regrets);
+    EXPECT_EQ(sums, expected_sums);
+
+    // Zero state leaves a hand out; any other value makes it live.
+    const std::vector<double> zeros(kNumActions, 0.0);
+    sparse.SetHandState(0, zeros.data(), zeros.data());
+    EXPECT_FALSE(sparse.IsLive(0));
+    sparse.SetHandState(0, regrets.data(), zeros.data());
+    EXPECT_TRUE(sparse.IsLive(0));
+
+    EXPECT_THROW(SparseDiscountedCfrTrainable(&player_range_, *action_node_, {4, 2}), std::invalid_argument);
+    EXPECT_THROW(SparseDiscountedCfrTrainable(&player_range_, *action_node_, {100}), std::invalid_argument);
+}
+
+TEST_F(SparseTrainableTest, CheckpointsUseTheDenseLayout) {
+    SparseDiscountedCfrTrainable sparse(&player_range_, *action_node_, {0, 6, 11});
+    Visit({&sparse}, {0, 6, 11}, 1, 10);
+    std::stringstream state;
+    sparse.WriteState(state);
+
+    DiscountedCfrTrainable dense(&player_range_, *action_node_);
+    dense.ReadState(state);
+    std::vector<double> dense_average = dense.GetAverageStrategy();
+    EXPECT_EQ(sparse.GetAverageStrategy(), dense_average);
+
+    std::stringstream dense_state;
+    dense.WriteState(dense_state);
+    SparseDiscountedCfrTrainable restored(&player_range_, *action_node_, {});
+    restored.ReadState(dense_state);
+    EXPECT_EQ(restored.NumLiveHands(), 3u);
+    std::vector<double> sparse_current = sparse.GetCurrentStrategy();
+    EXPECT_EQ(restored.GetCurrentStrategy(), sparse_current);
+
+    SparseDiscountedCfrTrainable copy(&player_range_, *action_node_, {});
+    ASSERT_NO_THROW(copy.CopyStateFrom(sparse));
+    std::vector<double> sparse_average = sparse.GetAverageStrategy();
+    EXPECT_EQ(copy.GetAverageStrategy(), sparse_average);
+    EXPECT_THROW(copy.CopyStateFrom(dense), std::invalid_argument);
+}
@@ -0,0 +1,170 @@
+#include "gtest/gtest.h"
+#include "solver/StrategyFile.h"
+#include "ranges/PrivateCards.h"
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace poker_solver::core;
+using namespace poker_solver::solver;
+
+TEST(HalfFloatTest, RoundTripsRepresentableValues) {
+    for (float value : {0.0f, -0.0f, 1.0f, -2.5f, 0.333251953125f, 65504.0f,
+                        std::ldexp(1.0f, -14), std::ldexp(3.0f, -24)}) { // Smallest normal, a subnormal
+        EXPECT_EQ(HalfToFloat(FloatToHalf(value)), value) << value;
+    }
+    EXPECT_EQ(FloatToHalf(1.0f), 0x3C00);
+    EXPECT_EQ(FloatToHalf(-2.0f), 0xC000);
+}
+
+TEST(HalfFloatTest, RoundsToNearestEven) {
+    EXPECT_EQ(FloatToHalf(1.0f + 1.0f / 2048.0f), 0x3C00); // Halfway, rounds to even
+    EXPECT_EQ(FloatToHalf(1.0f + 3.0f / 2048.0f), 0x3C02); // Halfway, rounds to even
+    EXPECT_EQ(FloatToHalf(65520.0f), 0x7C00);              // Past the largest half
+    EXPECT_EQ(FloatToHalf(1e-8f), 0x0000);
+    EXPECT_TRUE(std::isinf(HalfToFloat(FloatToHalf(std::numeric_limits<float>::infinity()))));
+    EXPECT_TRUE(std::isnan(HalfToFloat(FloatToHalf(std::numeric_limits<float>::quiet_NaN()))));
+    for (float value = 0.0f; value <= 1.0f; value += 0.001f) {
+        EXPECT_NEAR(HalfToFloat(FloatToHalf(value)), value, 1e-3f * value + 1e-7f);
+    }
+}
+
+class StrategyFileTest : public ::testing::Test {
+ protected:
+  std::array<std::vector<PrivateCards>, 2> ranges_{
+      std::vector<PrivateCards>{PrivateCards(0, 1), PrivateCards(2, 3), PrivateCards(4, 5)},
+      std::vector<PrivateCards>{PrivateCards(6, 7), PrivateCards(8, 9)}};
+  std::string path_;
+
+  void SetUp() override { path_ = ::testing::TempDir() + "strategy_file_test.strategy"; }
+  void TearDown() override { std::remove(path_.c_str()); }
+
+  // Three nodes; hand-major values encode (node, hand, action).
+  void WriteSample(StrategyValueType value_type) {
+      StrategyFileWriter writer(value_type, ranges_);
+      EXPECT_EQ(writer.AddNode("", 1, {"CHECK", "BET 2.000000"}, false), 0u);
+      EXPECT_EQ(writer.AddNode("CHECK", 0, {"CHECK", "BET 2.000000", "FOLD"}, true), 1u);
+      EXPECT_EQ(writer.AddNode("CHECK/CHECK/Qs", 1, {"CHECK"}, false), 2u);
+      writer.Write(path_, [&](size_t node, std::vector<double>& strategy, std::vector<double>& evs) {
+          const size_t num_actions = node == 0 ? 2 : node == 1 ? 3 : 1;
+          const size_t num_hands = ranges_[node == 1 ? 0 : 1].size();
+          for (size_t h = 0; h < num_hands; ++h) {
+              for (size_t a = 0; a < num_actions; ++a) strategy.push_back(Value(node, h, a));
+          }
+          if (node == 1) {
+              for (double value : strategy) evs.push_back(-value);
+          }
+      });
+  }
+
+  static double Value(size_t node, size_t hand, size_t action) {
+      return 0.5 * static_cast<double>(node) + 0.125 * static_cast<double>(hand) + 0.0625 * static_cast<double>(action);
+  }
+};
+
+TEST_F(StrategyFileTest, RoundTrip) {
+    for (StrategyValueType value_type : {StrategyValueType::kFloat32, StrategyValueType::kFloat16}) {
+        WriteSample(value_type);
+        StrategyFile file(path_);
+        EXPECT_EQ(file.ValueType(), value_type);
+        ASSERT_EQ(file.NumNodes(), 3u);
+        auto node = file.Find("CHECK");
+        ASSERT_TRUE(node.has_value());
+        EXPECT_EQ(*node, 1u);
+        EXPECT_EQ(file.Player(1), 0u);
+        EXPECT_EQ(file.NumHands(1), 3u);
+        EXPECT_EQ(file.Actions(1), (std::vector<std::string>{"CHECK", "BET 2.000000", "FOLD"}));
+        EXPECT_EQ(file.Hand(1, 2).ToString(), ranges_[0][2].ToString());
+        EXPECT_EQ(file.Hand(0, 1).ToString(), ranges_[1][1].ToString());
+        ASSERT_TRUE(file.HasEvs(1));
+        EXPECT_FALSE(file.HasEvs(0));
+        EXPECT_TRUE(std::isnan(file.Ev(0, 0, 0)));
+        EXPECT_TRUE(file.EvMatrix(0).empty());
+        for (size_t n = 0; n < 3; ++n) {
+            std::vector<float> matrix = file.StrategyMatrix(n);
+            ASSERT_EQ(matrix.size(), file.NumActions(n) * file.NumHands(n));
+            for (size_t a = 0; a < file.NumActions(n); ++a) {
+                for (size_t h = 0; h < file.NumHands(n); ++h) {
+                    EXPECT_EQ(file.Strategy(n, a, h), static_cast<float>(Value(n, h, a)));
+                    EXPECT_EQ(matrix[a * file.NumHands(n) + h], file.Strategy(n, a, h)); // Action-major
+                }
+            }
+        }
+        EXPECT_EQ(file.Ev(1, 2, 1), -static_cast<float>(Value(1, 1, 2)));
+        EXPECT_EQ(*file.Find(""), 0u);
+        EXPECT_EQ(*file.Find("CHECK/CHECK/Qs"), 2u);
+        EXPECT_FALSE(file.Find("CHECK/CHECK").has_value());
+    }
+}
+
+TEST_F(StrategyFileTest, QuantizedRoundTrip) {
+    WriteSample(StrategyValueType::kUint8);
+    StrategyFile file(path_);
+    EXPECT_EQ(file.ValueType(), StrategyValueType::kUint8);
+    for (size_t n = 0; n < 3; ++n) {
+        const QuantizedScale scale = file.StrategyScale(n);
+        EXPECT_EQ(scale.offset, 0.0f);
+        const std::vector<float> matrix = file.StrategyMatrix(n);
+        for (size_t a = 0; a < file.NumActions(n); ++a) {
+            for (size_t h = 0; h < file.NumHands(n); ++h) {
+                const size_t index = a * file.NumHands(n) + h;
+                EXPECT_NEAR(file.Strategy(n, a, h), Value(n, h, a), 0.5 * scale.scale + 1e-6);
+                EXPECT_EQ(matrix[index], scale.offset + file.StrategyValues(n)[index] * scale.scale);
+            }
+        }
+    }
+    // EVs span [min, max], both exact.
+    const QuantizedScale ev_scale = file.EvScale(1);
+    EXPECT_FLOAT_EQ(ev_scale.offset, -static_cast<float>(Value(1, 2, 2)));
+    EXPECT_FLOAT_EQ(file.Ev(1, 2, 2), -static_cast<float>(Value(1, 2, 2)));
+    EXPECT_FLOAT_EQ(file.Ev(1, 0, 0), -static_cast<float>(Value(1, 0, 0)));
+    EXPECT_NEAR(file.Ev(1, 1, 1), -Value(1, 1, 1), 0.5 * ev_scale.scale + 1e-6);
+    EXPECT_EQ(file.EvScale(0).scale, 1.0f); // No EVs: the identity
+}
+
+TEST_F(StrategyFileTest, RejectsRepeatedPathsAndBadValues) {
+    StrategyFileWriter writer(StrategyValueType::kFloat32, ranges_);
+    EXPECT_THROW(writer.AddNode("X", 2, {"CHECK"}, false), std::invalid_argument);
+    EXPECT_THROW(writer.AddNode("X", 0, {}, false), std::invalid_argument);
+    writer.AddNode("X", 0, {"CHECK"}, false);
+    writer.AddNode("X", 1, {"CHECK"}, false);
+    EXPECT_THROW(writer.Write(path_, [](size_t, std::vector<double>&, std::vector<double>&) {}), std::invalid_argument);
+
+    StrategyFileWriter short_values(StrategyValueType::kFloat32, ranges_);
+    short_values.AddNode("", 0, {"CHECK"}, false);
+    EXPECT_THROW(short_values.Write(path_, [](size_t, std::vector<double>& strategy, std::vector<double>&) {
+                     strategy.assign(1, 1.0);
+                 }),
+                 std::runtime_error);
+}
+
+TEST_F(StrategyFileTest, RejectsCorruptFiles) {
+    WriteSample(StrategyValueType::kFloat32);
+    std::string bytes;
+    {
+        std::ifstream in(path_, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    auto write = [&](const std::string& contents) {
+        std::ofstream out(path_, std::ios::binary | std::ios::trunc);
+        out << contents;
+    };
+
+    std::string flipped = bytes;
+    flipped[80] ^= 1; // In the node table
+    write(flipped);
+    EXPECT_THROW(StrategyFile file(path_), std::runtime_error);
+    write(bytes.substr(0, bytes.size() - 4));
+    EXPECT_THROW(StrategyFile file(path_), std::runtime_error);
+    std::string bad_magic = bytes;
+    bad_magic[0] = 'X';
+    write(bad_magic);
+    EXPECT_THROW(StrategyFile file(path_), std::runtime_error);
+    std::remove(path_.c_str());
+    EXPECT_THROW(StrategyFile file(path_), std::runtime_error);
+}
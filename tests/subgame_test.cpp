@@ -0,0 +1,142 @@
+#include "gtest/gtest.h"
+#include "solver/Subgame.h"
+#include "solver/PCfrSolver.h"
+#include "toy_spot.h"
+#include "ranges/PrivateCards.h"
+#include "tools/Rule.h"
+#include "tools/GameTreeBuildingSettings.h"
+#include "tools/StreetSetting.h"
+#include "Deck.h"
+#include "Card.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace poker_solver::core;
+using namespace poker_solver::config;
+using namespace poker_solver::nodes;
+using namespace poker_solver::ranges;
+using namespace poker_solver::solver;
+using namespace poker_solver::tree;
+
+// PCfrSolver::ExtractSubgame and ResolveSubgame on a small flop spot.
+class SubgameTest : public ::testing::Test {
+ protected:
+  Deck deck_;
+  std::vector<int> board_ = test_support::FlopBoard();
+  std::unique_ptr<Rule> rule_;
+
+  void SetUp() override {
+      rule_ = std::make_unique<Rule>(test_support::MakeSpotRule(deck_, board_));
+  }
+
+  std::vector<PrivateCards> MakeRange(int first_card, int last_card) const {
+      return test_support::MakeRange(first_card, last_card, board_);
+  }
+
+  static PCfrSolver::Config SmallConfig(int iterations) {
+      PCfrSolver::Config config;
+      config.iteration_limit = iterations;
+      config.num_threads = 1;
+      return config;
+  }
+
+  std::unique_ptr<PCfrSolver> Solve(int iterations) const {
+      auto solver = test_support::MakeToySolver(*rule_, {MakeRange(0, 16), MakeRange(8, 24)}, SmallConfig(iterations));
+      solver->Train();
+      return solver;
+  }
+};
+
+TEST_F(SubgameTest, RootSubgameResolvesToTheSameStrategy) {
+    auto blueprint = Solve(3);
+    PCfrSolver::Subgame subgame = blueprint->ExtractSubgame({});
+    EXPECT_EQ(subgame.round, GameRound::kFlop);
+    EXPECT_DOUBLE_EQ(subgame.pot, 20.0);
+    EXPECT_EQ(subgame.ranges[0].size(), MakeRange(0, 16).size());
+
+    ResolveOptions unsafe;
+    unsafe.safe = false;
+    auto resolved = ResolveSubgame(subgame, *rule_, rule_->GetBuildSettings(), std::make_shared<test_support::ToyCompairer>(),
+                                   SmallConfig(3), unsafe);
+    EXPECT_EQ(resolved->DumpStrategy(false), blueprint->DumpStrategy(false));
+}
+
+TEST_F(SubgameTest, ExtractsRangesAtATurnCard) {
+    auto blueprint = Solve(4);
+    const int turn = Card::StringToInt("4s").value();
+    PCfrSolver::Subgame subgame = blueprint->ExtractSubgame({"CHECK", "CHECK", "4s"});
+    EXPECT_EQ(subgame.round, GameRound::kTurn);
+    EXPECT_DOUBLE_EQ(subgame.pot, 20.0);
+    ASSERT_EQ(subgame.board.size(), 4u);
+    EXPECT_NE(std::find(subgame.board.begin(), subgame.board.end(), turn), subgame.board.end());
+
+    for (size_t p = 0; p < 2; ++p) {
+        ASSERT_FALSE(subgame.ranges[p].empty());
+        ASSERT_EQ(subgame.values[p].size(), subgame.ranges[p].size());
+        bool some_hand_checks_less = false;
+        for (size_t h = 0; h < subgame.ranges[p].size(); ++h) {
+            const PrivateCards& hand = subgame.ranges[p][h];
+            EXPECT_NE(hand.Card1Int(), turn);
+            EXPECT_NE(hand.Card2Int(), turn);
+            EXPECT_GT(hand.Weight(), 0.0);
+            EXPECT_LE(hand.Weight(), 1.0 + 1e-12);
+            some_hand_checks_less |= hand.Weight() < 1.0 - 1e-6;
+            // Net of the hand's commitment: between losing it all and winning the opponent's.
+            EXPECT_TRUE(std::isfinite(subgame.values[p][h]));
+            EXPECT_GE(subgame.values[p][h], -50.0 - 1e-9);
+            EXPECT_LE(subgame.values[p][h], 50.0 + 1e-9);
+        }
+        EXPECT_TRUE(some_hand_checks_less) << "player " << p;
+    }
+}
+
+TEST_F(SubgameTest, RejectsPathsThatDoNotEndAtAStreetStart) {
+    auto blueprint = Solve(1);
+    EXPECT_THROW(blueprint->ExtractSubgame({"RAISE 3"}), std::invalid_argument);
+    EXPECT_THROW(blueprint->ExtractSubgame({"CHECK"}), std::invalid_argument);
+    EXPECT_THROW(blueprint->ExtractSubgame({"CHECK", "CHECK", "Ac"}), std::invalid_argument);
+    EXPECT_THROW(blueprint->ExtractSubgame({"CHECK", "CHECK", "4s4h"}), std::invalid_argument);
+    EXPECT_THROW(blueprint->ExtractSubgame({"CHECK", "CHECK", "4s", "CHECK", "CHECK"}), std::invalid_argument);
+}
+
+TEST_F(SubgameTest, GadgetTakesTheBetterAlternative) {
+    auto blueprint = Solve(2);
+    PCfrSolver::Subgame subgame = blueprint->ExtractSubgame({"CHECK", "CHECK", "4s"});
+    for (double value : {1000.0, -1000.0}) {
+        PCfrSolver::Subgame changed = subgame;
+        changed.values[1].assign(changed.values[1].size(), value);
+        ResolveOptions options;
+        options.resolving_player = 0;
+        auto resolved = ResolveSubgame(changed, *rule_, rule_->GetBuildSettings(),
+                                       std::make_shared<test_support::ToyCompairer>(), SmallConfig(5), options);
+        const std::vector<double> enter = resolved->GetResolveGadgetEnterProbabilities();
+        ASSERT_FALSE(enter.empty());
+        for (double probability : enter) {
+            if (value > 0.0) {
+                EXPECT_LT(probability, 0.01);
+            } else {
+                EXPECT_GT(probability, 0.99);
+            }
+        }
+    }
+}
+
+TEST_F(SubgameTest, SafeResolveWithNewBetSizes) {
+    auto blueprint = Solve(4);
+    PCfrSolver::Subgame subgame = blueprint->ExtractSubgame({"CHECK", "CHECK", "4s"});
+    const GameTreeBuildingSettings what_if = test_support::SameOnEveryStreet(StreetSetting({33.0}, {75.0}, {}, true));
+    auto resolved = ResolveSubgame(subgame, *rule_, what_if, std::make_shared<test_support::ToyCompairer>(),
+                                   SmallConfig(20));
+    EXPECT_EQ(resolved->GetCompletedIterations(), 20);
+    const json dump = resolved->DumpStrategy(false);
+    EXPECT_EQ(dump["round"], "Turn");
+    // In position bets a third of the pot after a check, rounded to the small blind.
+    EXPECT_TRUE(dump["children"]["CHECK"]["children"].contains("BET 6.5"));
+    EXPECT_LT(resolved->ComputeExploitability(), 5.0);
+    EXPECT_EQ(resolved->GetResolveGadgetEnterProbabilities().size(),
+              resolved->ExtractSubgame({}).ranges[1].size());
+}
@@ -9,6 +9,7 @@
 #include "tools/StreetSetting.h"
 #include "Card.h"
 #include "tools/GameTreeBuildingSettings.h"
+#include "tools/ScenarioFile.h"
 #include <string>
 #include <vector>
 #include <map>
@@ -64,78 +65,12 @@ inline std::string get_json_value_or_default(const json& j, const std::string& k
 }
 
 inline config::StreetSetting parse_street_setting(const json& j_ss) {
-    std::vector<double> bets, raises, donks;
-    bool allow_all_in = false;
-
-    if (j_ss.contains("bet_sizes_percent") && j_ss.at("bet_sizes_percent").is_array()) {
-        bets = j_ss.at("bet_sizes_percent").get<std::vector<double>>();
-    }
-    if (j_ss.contains("raise_sizes_percent") && j_ss.at("raise_sizes_percent").is_array()) {
-        raises = j_ss.at("raise_sizes_percent").get<std::vector<double>>();
-    }
-    if (j_ss.contains("donk_sizes_percent") && j_ss.at("donk_sizes_percent").is_array()) {
-        donks = j_ss.at("donk_sizes_percent").get<std::vector<double>>();
-    }
-    allow_all_in = get_json_value_or_default(j_ss, "allow_all_in", false);
-
-    return config::StreetSetting(bets, raises, donks, allow_all_in);
+    return config::StreetSettingFromJson(j_ss);
 }
 
 // Helper function to create Rule from JSON (also inline in header)
 inline config::Rule create_rule_from_json(const json& j_rule, const core::Deck& deck) {
-    std::string starting_round_str = j_rule.at("starting_round").get<std::string>();
-    core::GameRound starting_round_enum;
-    if (starting_round_str == "Preflop") starting_round_enum = core::GameRound::kPreflop;
-    else if (starting_round_str == "Flop") starting_round_enum = core::GameRound::kFlop;
-    else if (starting_round_str == "Turn") starting_round_enum = core::GameRound::kTurn;
-    else if (starting_round_str == "River") starting_round_enum = core::GameRound::kRiver;
-    else throw std::invalid_argument("Invalid starting_round in JSON: " + starting_round_str);
-
-    double initial_ip_commit = get_json_value_or_default(j_rule.value("initial_commitments", json::object()), "ip", 0.0);
-    double initial_oop_commit = get_json_value_or_default(j_rule.value("initial_commitments", json::object()), "oop", 0.0);
-
-    double sb = get_json_value_or_default(j_rule.value("blinds", json::object()), "sb", 0.0);
-    double bb = get_json_value_or_default(j_rule.value("blinds", json::object()), "bb", 0.0);
-
-    double effective_stack = j_rule.at("effective_stack").get<double>();
-    int raise_limit = j_rule.at("raise_limit_per_street").get<int>();
-    double all_in_thresh = get_json_value_or_default(j_rule, "all_in_threshold_ratio", 0.98);
-
-    std::vector<int> initial_board_cards_for_rule; // << PARSE THIS
-    if (j_rule.contains("initial_board") && j_rule.at("initial_board").is_array()) {
-        std::cout << "[DEBUG_LOADER] Raw initial_board from JSON: " << j_rule.at("initial_board") << std::endl; // Print raw JSON array
-        for (const auto& card_str_json : j_rule.at("initial_board")) {
-            std::string card_str = card_str_json.get<std::string>();
-            std::cout << "[DEBUG_LOADER] Parsing card string: " << card_str << std::endl;
-            std::optional<int> card_val = core::Card::StringToInt(card_str);
-            if (!card_val) {
-                throw std::invalid_argument("Invalid card string in initial_board for Rule: " + card_str);
-            }
-            initial_board_cards_for_rule.push_back(card_val.value());
-            std::cout << "[DEBUG_LOADER] Parsed to int: " << card_val.value() << std::endl;
-        }
-    }
-    std::cout << "[DEBUG_LOADER] Final initial_board_cards_for_rule (ints): ";
-    for(int c_int : initial_board_cards_for_rule) std::cout << c_int << " ";
-    std::cout << std::endl;
-
-
-    config::GameTreeBuildingSettings build_settings;
-    if (j_rule.contains("building_settings") && j_rule.at("building_settings").is_object()) {
-        const auto& j_bs = j_rule.at("building_settings");
-        build_settings = config::GameTreeBuildingSettings(
-            parse_street_setting(j_bs.at("flop_ip")),
-            parse_street_setting(j_bs.at("turn_ip")),
-            parse_street_setting(j_bs.at("river_ip")),
-            parse_street_setting(j_bs.at("flop_oop")),
-            parse_street_setting(j_bs.at("turn_oop")),
-            parse_street_setting(j_bs.at("river_oop"))
-        );
-    }
-
-    return config::Rule(deck, initial_oop_commit, initial_ip_commit, starting_round_enum,
-                        initial_board_cards_for_rule, // <<< PASS PARSED BOARD CARDS
-                        raise_limit, sb, bb, effective_stack, build_settings, all_in_thresh);
+    return config::RuleFromJson(j_rule, deck);
 }
 // --- End of Inline Helper Function Definitions ---
 
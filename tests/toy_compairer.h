@@ -0,0 +1,61 @@
+#ifndef TOY_COMPAIRER_H
+#define TOY_COMPAIRER_H
+
+#include "compairer/Compairer.h"
+#include "Card.h"
+#include <cstdint>
+#include <vector>
+
+namespace test_support {
+
+// Cheap deterministic evaluator for solver tests that do not need real hand
+// strengths (and would otherwise pay for loading the dictionary). The rank is
+// a hash of the seven-card mask, so it depends on the board as well as the hand.
+class ToyCompairer : public poker_solver::core::Compairer {
+ public:
+  using ComparisonResult = poker_solver::core::ComparisonResult;
+  using Card = poker_solver::core::Card;
+
+  ComparisonResult CompareHands(const std::vector<int>& private_hand1,
+                                const std::vector<int>& private_hand2,
+                                const std::vector<int>& public_board) const override {
+      return CompareHands(Card::CardIntsToUint64(private_hand1),
+                          Card::CardIntsToUint64(private_hand2),
+                          Card::CardIntsToUint64(public_board));
+  }
+  ComparisonResult CompareHands(uint64_t private_mask1, uint64_t private_mask2,
+                                uint64_t public_mask) const override {
+      int r1 = GetHandRank(private_mask1, public_mask);
+      int r2 = GetHandRank(private_mask2, public_mask);
+      if (r1 == r2) return ComparisonResult::kTie;
+      return r1 < r2 ? ComparisonResult::kPlayer1Wins : ComparisonResult::kPlayer2Wins;
+  }
+  int GetHandRank(const std::vector<int>& private_hand,
+                  const std::vector<int>& public_board) const override {
+      return GetHandRank(Card::CardIntsToUint64(private_hand), Card::CardIntsToUint64(public_board));
+  }
+  int GetHandRank(uint64_t private_mask, uint64_t public_mask) const override {
+      return static_cast<int>(((private_mask | public_mask) * 0x9E3779B97F4A7C15ULL) >> 54);
+  }
+};
+
+// Like ToyCompairer but the rank only depends on how many cards of each rank
+// the seven cards hold, so suit-swapped boards and hands rank the same (as
+// they do with a real evaluator). Needed by the suit isomorphism tests.
+class SuitBlindToyCompairer : public ToyCompairer {
+ public:
+  using ToyCompairer::GetHandRank;
+  int GetHandRank(uint64_t private_mask, uint64_t public_mask) const override {
+      uint64_t cards = private_mask | public_mask;
+      uint64_t signature = 0;
+      for (int rank = 0; rank < poker_solver::core::kNumRanks; ++rank) {
+          uint64_t count = __builtin_popcountll((cards >> (rank * poker_solver::core::kNumSuits)) & 0xFULL);
+          signature = signature * 5 + count;
+      }
+      return static_cast<int>(((signature + 1) * 0x9E3779B97F4A7C15ULL) >> 54);
+  }
+};
+
+} // namespace test_support
+
+#endif // TOY_COMPAIRER_H
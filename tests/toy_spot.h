@@ -0,0 +1,105 @@
+#ifndef TOY_SPOT_H
+#define TOY_SPOT_H
+
+#include "toy_compairer.h"
+#include "solver/PCfrSolver.h"
+#include "ranges/PrivateCardsManager.h"
+#include "ranges/RiverRangeManager.h"
+#include "ranges/PrivateCards.h"
+#include "tools/Rule.h"
+#include "tools/GameTreeBuildingSettings.h"
+#include "tools/StreetSetting.h"
+#include "GameTree.h"
+#include "Deck.h"
+#include "Card.h"
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace test_support {
+
+// The small spot the solver tests share: pot 20 (10 chips each) and stacks
+// of 50, 50% bets and all-ins on every street, ranges drawn from the lowest
+// cards, and the ToyCompairer for showdowns.
+
+inline std::vector<int> ParseCards(std::initializer_list<const char*> names) {
+    std::vector<int> cards;
+    for (const char* name : names) cards.push_back(poker_solver::core::Card::StringToInt(name).value());
+    return cards;
+}
+
+inline std::vector<int> FlopBoard() { return ParseCards({"Ac", "Kd", "5h"}); }
+inline std::vector<int> TurnBoard() { return ParseCards({"Ac", "Kd", "5h", "9s"}); }
+
+inline poker_solver::config::StreetSetting HalfPotAndAllIn() {
+    return poker_solver::config::StreetSetting({50.0}, {100.0}, {}, true);
+}
+
+// 'setting' for both players on every street.
+inline poker_solver::config::GameTreeBuildingSettings SameOnEveryStreet(
+        const poker_solver::config::StreetSetting& setting = HalfPotAndAllIn()) {
+    return poker_solver::config::GameTreeBuildingSettings(setting, setting, setting, setting, setting, setting);
+}
+
+// The spot's rule on 'board'; the starting round follows the board's size.
+inline poker_solver::config::Rule MakeSpotRule(
+        const poker_solver::core::Deck& deck, const std::vector<int>& board,
+        const poker_solver::config::GameTreeBuildingSettings& settings = SameOnEveryStreet()) {
+    const poker_solver::core::GameRound round = board.size() == 3   ? poker_solver::core::GameRound::kFlop
+                                                : board.size() == 4 ? poker_solver::core::GameRound::kTurn
+                                                                    : poker_solver::core::GameRound::kRiver;
+    return poker_solver::config::Rule(deck, 10.0, 10.0, round, board, 1, 0.5, 1.0, 50.0, settings);
+}
+
+// All hands made of cards in [first_card, last_card) that miss 'board'.
+inline std::vector<poker_solver::core::PrivateCards> MakeRange(int first_card, int last_card,
+                                                                 const std::vector<int>& board) {
+    const uint64_t board_mask = poker_solver::core::Card::CardIntsToUint64(board);
+    std::vector<poker_solver::core::PrivateCards> range;
+    for (int c1 = first_card; c1 < last_card; ++c1) {
+        for (int c2 = c1 + 1; c2 < last_card; ++c2) {
+            const uint64_t hand_mask = (1ULL << c1) | (1ULL << c2);
+            if (!poker_solver::core::Card::DoBoardsOverlap(hand_mask, board_mask)) range.emplace_back(c1, c2);
+        }
+    }
+    return range;
+}
+
+inline std::shared_ptr<poker_solver::ranges::RiverRangeManager> MakeToyRiverRanges() {
+    return std::make_shared<poker_solver::ranges::RiverRangeManager>(std::make_shared<ToyCompairer>());
+}
+
+// The two players' 'ranges' on the board of 'rule'.
+inline std::shared_ptr<poker_solver::ranges::PrivateCardsManager> MakeRangeManager(
+        const poker_solver::config::Rule& rule, std::vector<std::vector<poker_solver::core::PrivateCards>> ranges) {
+    return std::make_shared<poker_solver::ranges::PrivateCardsManager>(
+        std::move(ranges), poker_solver::core::Card::CardIntsToUint64(rule.GetInitialBoardCardsInt()));
+}
+
+// Untrained solver of 'rule' for 'pcm'. Builds a fresh tree and ToyCompairer
+// river ranges unless given them.
+inline std::unique_ptr<poker_solver::solver::PCfrSolver> MakeToySolver(
+        const poker_solver::config::Rule& rule, std::shared_ptr<poker_solver::ranges::PrivateCardsManager> pcm,
+        const poker_solver::solver::PCfrSolver::Config& config,
+        std::shared_ptr<poker_solver::tree::GameTree> tree = nullptr,
+        std::shared_ptr<poker_solver::ranges::RiverRangeManager> river_ranges = nullptr) {
+    if (!tree) tree = std::make_shared<poker_solver::tree::GameTree>(rule);
+    if (!river_ranges) river_ranges = MakeToyRiverRanges();
+    return std::make_unique<poker_solver::solver::PCfrSolver>(std::move(tree), std::move(pcm),
+                                                              std::move(river_ranges), rule, config);
+}
+
+inline std::unique_ptr<poker_solver::solver::PCfrSolver> MakeToySolver(
+        const poker_solver::config::Rule& rule, std::vector<std::vector<poker_solver::core::PrivateCards>> ranges,
+        const poker_solver::solver::PCfrSolver::Config& config,
+        std::shared_ptr<poker_solver::tree::GameTree> tree = nullptr,
+        std::shared_ptr<poker_solver::ranges::RiverRangeManager> river_ranges = nullptr) {
+    return MakeToySolver(rule, MakeRangeManager(rule, std::move(ranges)), config, std::move(tree),
+                         std::move(river_ranges));
+}
+
+} // namespace test_support
+
+#endif // TOY_SPOT_H
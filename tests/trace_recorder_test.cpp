@@ -0,0 +1,128 @@
+#include "gtest/gtest.h"
+#include "solver/PCfrSolver.h"
+#include "solver/TraceRecorder.h"
+#include "toy_compairer.h"
+#include "ranges/PrivateCardsManager.h"
+#include "ranges/RiverRangeManager.h"
+#include "ranges/PrivateCards.h"
+#include "tools/Rule.h"
+#include "tools/GameTreeBuildingSettings.h"
+#include "tools/StreetSetting.h"
+#include "GameTree.h"
+#include "Deck.h"
+#include "Card.h"
+#include <json.hpp>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace poker_solver::core;
+using namespace poker_solver::config;
+using namespace poker_solver::ranges;
+using namespace poker_solver::solver;
+using namespace poker_solver::tree;
+
+namespace {
+
+nlohmann::json TraceJson(const TraceRecorder& recorder) {
+    std::ostringstream out;
+    recorder.WriteChromeTrace(out);
+    return nlohmann::json::parse(out.str());
+}
+
+// Complete ("X") events by name.
+std::map<std::string, int> CountSpans(const nlohmann::json& trace) {
+    std::map<std::string, int> counts;
+    for (const auto& event : trace["traceEvents"]) {
+        if (event["ph"] == "X") ++counts[event["name"].get<std::string>()];
+    }
+    return counts;
+}
+
+} // namespace
+
+TEST(TraceRecorderTest, WritesOneTrackPerThread) {
+    TraceRecorder recorder;
+    auto work = [&recorder](int id) {
+        for (int i = 0; i < 3; ++i) TraceSpan span(&recorder, "work", "test", id);
+    };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t) threads.emplace_back(work, t);
+    for (std::thread& thread : threads) thread.join();
+    work(3);
+
+    const nlohmann::json trace = TraceJson(recorder);
+    std::set<int> tids;
+    int thread_names = 0;
+    for (const auto& event : trace["traceEvents"]) {
+        if (event["ph"] == "M") {
+            ++thread_names;
+            continue;
+        }
+        EXPECT_EQ(event["name"], "work");
+        EXPECT_GE(event["dur"].get<double>(), 0.0);
+        EXPECT_TRUE(event["args"].contains("value"));
+        tids.insert(event["tid"].get<int>());
+    }
+    EXPECT_EQ(thread_names, 4);
+    EXPECT_EQ(tids.size(), 4u);
+    EXPECT_EQ(CountSpans(trace)["work"], 12);
+    EXPECT_EQ(recorder.Overwritten(), 0u);
+}
+
+TEST(TraceRecorderTest, FullRingKeepsTheLatestSpans) {
+    TraceRecorder recorder(4);
+    for (int i = 0; i < 10; ++i) recorder.Record("tick", "test", i * 1000, i * 1000 + 500, i);
+    const nlohmann::json trace = TraceJson(recorder);
+    std::vector<int> kept;
+    for (const auto& event : trace["traceEvents"]) {
+        if (event["ph"] == "X") kept.push_back(event["args"]["value"].get<int>());
+    }
+    EXPECT_EQ(kept, (std::vector<int>{6, 7, 8, 9}));
+    EXPECT_EQ(recorder.Overwritten(), 6u);
+    EXPECT_THROW(TraceRecorder(0), std::invalid_argument);
+
+    TraceSpan untraced(nullptr, "nothing", "test"); // A null recorder records nothing.
+}
+
+TEST(TraceRecorderTest, SolverRecordsIterationsStreetsAndDumps) {
+    Deck deck;
+    StreetSetting setting{{50.0}, {100.0}, {}, true};
+    GameTreeBuildingSettings build_settings{setting, setting, setting, setting, setting, setting};
+    const std::vector<int> board = {Card::StringToInt("Ac").value(), Card::StringToInt("Kd").value(),
+                                    Card::StringToInt("5h").value()};
+    Rule rule(deck, 10.0, 10.0, GameRound::kFlop, board, 1, 0.5, 1.0, 50.0, build_settings);
+    auto tree = std::make_shared<GameTree>(rule);
+    const uint64_t board_mask = Card::CardIntsToUint64(board);
+    std::vector<PrivateCards> range;
+    for (int c1 = 0; c1 < 12; ++c1) {
+        for (int c2 = c1 + 1; c2 < 12; ++c2) {
+            if (!Card::DoBoardsOverlap((1ULL << c1) | (1ULL << c2), board_mask)) range.emplace_back(c1, c2);
+        }
+    }
+    auto pcm = std::make_shared<PrivateCardsManager>(std::vector<std::vector<PrivateCards>>{range, range}, board_mask);
+    auto rrm = std::make_shared<RiverRangeManager>(std::make_shared<test_support::ToyCompairer>());
+    PCfrSolver::Config config;
+    config.iteration_limit = 2;
+    config.num_threads = 2;
+    config.exploitability_interval = 2;
+    PCfrSolver solver(tree, pcm, rrm, rule, config);
+    auto recorder = std::make_shared<TraceRecorder>();
+    solver.SetTraceRecorder(recorder);
+    solver.Train();
+    solver.DumpStrategy(false);
+
+    std::map<std::string, int> spans = CountSpans(TraceJson(*recorder));
+    EXPECT_EQ(spans["iteration"], 2);
+    EXPECT_EQ(spans["exploitability"], 1);
+    EXPECT_EQ(spans["river cache"], 1);
+    EXPECT_GT(spans["turn"], 0);
+    EXPECT_GT(spans["river"], 0);
+    EXPECT_GT(spans["chance outcome"], 0);
+    EXPECT_EQ(spans["dump"], 1);
+}
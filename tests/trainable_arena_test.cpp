@@ -0,0 +1,203 @@
+#include "gtest/gtest.h"
+#include "trainable/TrainableArena.h"
+#include "trainable/DiscountedCfrTrainable.h"
+#include "nodes/ActionNode.h"
+#include "nodes/TerminalNode.h"
+#include "nodes/GameActions.h"
+#include "nodes/GameTreeNode.h"
+#include "ranges/PrivateCards.h"
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <csignal>        // For sigaction
+#include <sys/resource.h> // For setrlimit
+#endif
+
+// Use namespaces
+using namespace poker_solver::core;
+using namespace poker_solver::nodes;
+using namespace poker_solver::solver;
+
+TEST(TrainableArenaTest, BlocksAreAlignedAndAdjacent) {
+    TrainableArena arena(1000);
+    double* first = arena.Allocate(10);
+    double* second = arena.Allocate(3);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(first) % 64, 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(second) % 64, 0u);
+    EXPECT_EQ(second, first + 16); // 10 rounded up to two cache lines
+    EXPECT_EQ(arena.AllocatedDoubles(), 24u);
+
+    auto regions = arena.Regions();
+    ASSERT_EQ(regions.size(), 1u);
+    EXPECT_EQ(regions[0].first, first);
+    EXPECT_EQ(regions[0].second, 24u);
+}
+
+TEST(TrainableArenaTest, GrowsBeyondTheHint) {
+    TrainableArena arena(64);
+    arena.Allocate(64);
+    double* overflow = arena.Allocate(100);
+    overflow[99] = 1.0; // Writable
+    EXPECT_EQ(arena.Regions().size(), 2u);
+    EXPECT_GE(arena.ReservedBytes(), (64 + TrainableArena::kDefaultSlabDoubles) * sizeof(double));
+
+    TrainableArena empty(0, true);
+    EXPECT_EQ(empty.ReservedBytes(), 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(empty.Allocate(1)) % (2u << 20), 0u); // Huge page aligned slab
+}
+
+TEST(TrainableArenaTest, FileBackedSlabsAreWritable) {
+    TrainableArena arena(64, TrainableArena::FileBacking{::testing::TempDir(), true});
+    EXPECT_TRUE(arena.IsFileBacked());
+    double* first = arena.Allocate(64);
+    double* overflow = arena.Allocate(100);
+    for (size_t i = 0; i < 64; ++i) first[i] = static_cast<double>(i);
+    overflow[99] = 1.0; // Writable
+    EXPECT_EQ(first[63], 63.0);
+    // Mapped in 2 MiB steps, so the hint was rounded up.
+    EXPECT_EQ(overflow, first + 64);
+    EXPECT_EQ(arena.Regions().size(), 1u);
+    EXPECT_EQ(arena.ReservedBytes(), 2u << 20);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(first) % 64, 0u);
+
+    EXPECT_FALSE(TrainableArena(64).IsFileBacked());
+    EXPECT_THROW(TrainableArena(64, TrainableArena::FileBacking{"/nonexistent/trainables", false}),
+                 std::runtime_error);
+}
+
+#ifdef __linux__
+TEST(TrainableArenaTest, FileThatCannotGrowThrows) {
+    // A file size limit stands in for a full disk: the file cannot grow past
+    // 1 MiB, so the first 2 MiB slab fails when it is reserved.
+    struct sigaction ignore = {};
+    struct sigaction previous_action = {};
+    ignore.sa_handler = SIG_IGN;
+    sigaction(SIGXFSZ, &ignore, &previous_action);
+    rlimit previous_limit;
+    getrlimit(RLIMIT_FSIZE, &previous_limit);
+    rlimit limit = previous_limit;
+    limit.rlim_cur = 1 << 20;
+    setrlimit(RLIMIT_FSIZE, &limit);
+
+    TrainableArena arena(0, TrainableArena::FileBacking{::testing::TempDir(), false});
+    EXPECT_THROW(arena.Allocate(64), std::runtime_error);
+    EXPECT_EQ(arena.ReservedBytes(), 0u);
+
+    setrlimit(RLIMIT_FSIZE, &previous_limit);
+    sigaction(SIGXFSZ, &previous_action, nullptr);
+}
+#endif
+
+TEST(TrainableArenaTest, ThreadsAllocateFromTheirLane) {
+    TrainableArena arena(1024, false, 2);
+    double* lane0 = arena.Allocate(8);
+    std::thread([&arena, lane0] {
+        TrainableArena::SetThreadLane(1);
+        double* lane1 = arena.Allocate(8);
+        EXPECT_NE(lane1, lane0 + 8); // A separate slab chain
+        EXPECT_EQ(arena.Allocate(8), lane1 + 8);
+        TrainableArena::SetThreadLane(5); // Past the arena's lanes: lane 0
+        EXPECT_EQ(arena.Allocate(8), lane0 + 8);
+    }).join();
+    EXPECT_EQ(arena.Allocate(8), lane0 + 16);
+    EXPECT_EQ(arena.Regions().size(), 2u);
+    EXPECT_EQ(arena.AllocatedDoubles(), 40u);
+}
+
+TEST(TrainableArenaTest, ConcurrentAllocationsDoNotOverlap) {
+    TrainableArena arena(0);
+    const int kThreads = 4;
+    const int kBlocks = 1000;
+    std::vector<std::vector<double*>> blocks(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < kBlocks; ++i) {
+                double* block = arena.Allocate(8);
+                for (int j = 0; j < 8; ++j) block[j] = t * kBlocks + i;
+                blocks[t].push_back(block);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    for (int t = 0; t < kThreads; ++t) {
+        for (int i = 0; i < kBlocks; ++i) {
+            for (int j = 0; j < 8; ++j) ASSERT_EQ(blocks[t][i][j], t * kBlocks + i);
+        }
+    }
+    EXPECT_EQ(arena.AllocatedDoubles(), static_cast<size_t>(kThreads * kBlocks * 8));
+}
+
+TEST(TrainableArenaTest, ArenaBackedTrainableMatchesOwnedStorage) {
+    std::vector<PrivateCards> range = {PrivateCards(0, 1), PrivateCards(2, 3), PrivateCards(4, 5)};
+    auto node = std::make_shared<ActionNode>(0, GameRound::kRiver, 10.0, std::weak_ptr<GameTreeNode>(), 1);
+    auto terminal = std::make_shared<TerminalNode>(std::vector<double>{0.0, 0.0}, GameRound::kRiver, 10.0,
+                                                   std::weak_ptr<GameTreeNode>(node));
+    node->AddChild(GameAction(PokerAction::kCheck), terminal);
+    node->AddChild(GameAction(PokerAction::kBet, 5.0), terminal);
+    node->SetPlayerRange(&range);
+
+    auto arena = std::make_shared<TrainableArena>(256);
+    DiscountedCfrTrainable owned(&range, *node);
+    auto backed = std::make_unique<DiscountedCfrTrainable>(&range, *node, arena);
+    // 3 tables of 6 values, rounded up to a cache line multiple.
+    EXPECT_EQ(arena->AllocatedDoubles(), 24u);
+
+    std::vector<double> regrets = {1.0, -2.0, 0.5, 0.5, -1.0, 3.0};
+    std::vector<double> reach = {1.0, 0.5, 0.0};
+    for (int t = 1; t <= 3; ++t) {
+        std::vector<double> strategy = owned.GetCurrentStrategy();
+        for (Trainable* trainable : {static_cast<Trainable*>(&owned), static_cast<Trainable*>(backed.get())}) {
+            trainable->UpdateRegrets(regrets, t, 1.0);
+            trainable->AccumulateAverageStrategy(strategy, t, reach);
+        }
+    }
+    std::vector<double> owned_current = owned.GetCurrentStrategy();
+    EXPECT_EQ(backed->GetCurrentStrategy(), owned_current);
+    std::vector<double> owned_average = owned.GetAverageStrategy();
+    EXPECT_EQ(backed->GetAverageStrategy(), owned_average);
+
+    // The trainable keeps the arena alive.
+    std::weak_ptr<TrainableArena> weak_arena = arena;
+    arena.reset();
+    EXPECT_FALSE(weak_arena.expired());
+    backed.reset();
+    EXPECT_TRUE(weak_arena.expired());
+}
+
+TEST(TrainableArenaTest, LazyStrategiesKeepTwoTables) {
+    std::vector<PrivateCards> range = {PrivateCards(0, 1), PrivateCards(2, 3), PrivateCards(4, 5)};
+    auto node = std::make_shared<ActionNode>(0, GameRound::kRiver, 10.0, std::weak_ptr<GameTreeNode>(), 1);
+    auto terminal = std::make_shared<TerminalNode>(std::vector<double>{0.0, 0.0}, GameRound::kRiver, 10.0,
+                                                   std::weak_ptr<GameTreeNode>(node));
+    node->AddChild(GameAction(PokerAction::kCheck), terminal);
+    node->AddChild(GameAction(PokerAction::kBet, 5.0), terminal);
+    node->SetPlayerRange(&range);
+
+    auto arena = std::make_shared<TrainableArena>(256);
+    DiscountedCfrTrainable resident(&range, *node);
+    DiscountedCfrTrainable lazy(&range, *node, arena, true);
+    // 2 tables of 6 values, rounded up to a cache line multiple.
+    EXPECT_EQ(arena->AllocatedDoubles(), 16u);
+
+    std::vector<double> regrets = {1.0, -2.0, 0.5, 0.5, -1.0, 3.0};
+    std::vector<double> reach = {1.0, 0.5, 0.0};
+    std::vector<double> scratch(6);
+    for (int t = 1; t <= 3; ++t) {
+        IterationDiscounts discounts = IterationDiscounts::For(t);
+        for (Trainable* trainable : {static_cast<Trainable*>(&resident), static_cast<Trainable*>(&lazy)}) {
+            const double* strategy = trainable->CurrentStrategy(scratch.data());
+            trainable->UpdateFromVisit(regrets.data(), strategy, reach.data(), discounts);
+        }
+        EXPECT_EQ(lazy.CurrentStrategy(scratch.data()), scratch.data());
+    }
+    std::vector<double> resident_current = resident.GetCurrentStrategy();
+    EXPECT_EQ(lazy.GetCurrentStrategy(), resident_current);
+    std::vector<double> resident_average = resident.GetAverageStrategy();
+    EXPECT_EQ(lazy.GetAverageStrategy(), resident_average);
+    EXPECT_EQ(lazy.DumpStrategy(false), resident.DumpStrategy(false));
+}
@@ -0,0 +1,68 @@
+#include "gtest/gtest.h"
+#include "solver/PCfrSolver.h"
+#include "solver/TraversalScratch.h"
+#include "toy_spot.h"
+#include "ranges/PrivateCards.h"
+#include "Deck.h"
+#include "Card.h"
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <vector>
+
+// Counts every global operator new in this test binary so the solver's
+// steady-state allocation rate can be measured.
+namespace {
+std::atomic<size_t> g_allocation_count{0};
+} // namespace
+
+void* operator new(std::size_t size) {
+    g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) return ptr;
+    throw std::bad_alloc();
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+// Use namespaces
+using namespace poker_solver::core;
+using namespace poker_solver::config;
+using namespace poker_solver::ranges;
+using namespace poker_solver::solver;
+using namespace poker_solver::tree;
+
+// Solves a small turn spot (one chance node per line) and checks that,
+// once the first iterations have created trainables, river caches and
+// scratch levels, further iterations do not touch the heap.
+class TraversalAllocationTest : public ::testing::Test {
+ protected:
+  Deck deck_;
+  std::vector<int> board_ = test_support::TurnBoard();
+
+  // Allocations performed by a fresh solver running 'iterations' iterations.
+  size_t CountTrainAllocations(int iterations) {
+      PCfrSolver::Config config;
+      config.iteration_limit = iterations;
+      config.num_threads = 1;
+      auto solver = test_support::MakeToySolver(
+          test_support::MakeSpotRule(deck_, board_),
+          {test_support::MakeRange(0, 16, board_), test_support::MakeRange(8, 24, board_)}, config);
+
+      size_t before = g_allocation_count.load();
+      solver->Train();
+      return g_allocation_count.load() - before;
+  }
+};
+
+TEST_F(TraversalAllocationTest, SteadyStateIterationsDoNotAllocate) {
+    CountTrainAllocations(2); // Grow this thread's scratch stack once.
+    size_t short_run = CountTrainAllocations(2);
+    size_t long_run = CountTrainAllocations(6);
+    ASSERT_GE(long_run, short_run);
+    double per_iteration = static_cast<double>(long_run - short_run) / 4.0;
+    std::cout << "[INFO] Heap allocations per steady-state iteration: " << per_iteration << std::endl;
+    EXPECT_EQ(long_run, short_run);
+    EXPECT_GT(TraversalScratch::ForCurrentThread().Depth(), 0u);
+}
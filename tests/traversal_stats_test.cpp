@@ -0,0 +1,117 @@
+#include "gtest/gtest.h"
+#include "solver/PCfrSolver.h"
+#include "solver/TraversalStats.h"
+#include "toy_compairer.h"
+#include "ranges/PrivateCardsManager.h"
+#include "ranges/RiverRangeManager.h"
+#include "ranges/PrivateCards.h"
+#include "tools/Rule.h"
+#include "tools/GameTreeBuildingSettings.h"
+#include "tools/StreetSetting.h"
+#include "GameTree.h"
+#include "Deck.h"
+#include "Card.h"
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace poker_solver::core;
+using namespace poker_solver::config;
+using namespace poker_solver::ranges;
+using namespace poker_solver::solver;
+using namespace poker_solver::tree;
+
+TEST(TraversalStatsTest, SumsAndSerializesByTypeAndStreet) {
+    TraversalStats stats;
+    stats.iterations = 1;
+    stats.At(GameTreeNodeType::kShowdown, GameRound::kRiver) = {10, 200, 3000};
+    stats.At(GameTreeNodeType::kAction, GameRound::kTurn) = {4, 40, 500};
+    stats.At(GameTreeNodeType::kAction, GameRound::kRiver) = {6, 60, 700};
+
+    TraversalStats total;
+    total += stats;
+    total += stats;
+    EXPECT_EQ(total.iterations, 2);
+    EXPECT_EQ(total.Total(GameTreeNodeType::kAction).visits, 20u);
+    EXPECT_EQ(total.Total(GameTreeNodeType::kAction).nanoseconds, 2400u);
+    EXPECT_EQ(total.Total().hands, 600u);
+
+    const nlohmann::json j = total.ToJson();
+    EXPECT_EQ(j["iterations"], 2);
+    EXPECT_EQ(j["showdown"]["river"]["visits"], 20);
+    EXPECT_EQ(j["action"]["total"]["hands"], 200);
+    EXPECT_FALSE(j["action"].contains("flop"));
+    EXPECT_EQ(j["chance"]["total"]["visits"], 0);
+}
+
+TEST(TraversalStatsTest, CollectorSumsThreadsAndResets) {
+    TraversalStatsCollector collector;
+    auto record = [&collector]() {
+        for (int i = 0; i < 100; ++i) ++collector.ForCurrentThread().At(GameTreeNodeType::kTerminal, GameRound::kFlop).visits;
+    };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) threads.emplace_back(record);
+    for (std::thread& thread : threads) thread.join();
+    record();
+
+    EXPECT_EQ(collector.Collect().At(GameTreeNodeType::kTerminal, GameRound::kFlop).visits, 500u);
+    EXPECT_EQ(collector.Collect().Total().visits, 0u);
+
+    // A thread alternating between collectors keeps one buffer in each.
+    TraversalStatsCollector other;
+    ++other.ForCurrentThread().At(GameTreeNodeType::kChance, GameRound::kTurn).visits;
+    record();
+    EXPECT_EQ(other.Collect().Total().visits, 1u);
+    EXPECT_EQ(collector.Collect().Total().visits, 100u);
+}
+
+// A turn spot: action, chance, showdown and terminal nodes on two streets.
+TEST(TraversalStatsTest, SolverCountsTrainingTraversals) {
+    Deck deck;
+    StreetSetting setting{{50.0}, {100.0}, {}, true};
+    GameTreeBuildingSettings build_settings{setting, setting, setting, setting, setting, setting};
+    const std::vector<int> board = {Card::StringToInt("Ac").value(), Card::StringToInt("Kd").value(),
+                                    Card::StringToInt("5h").value(), Card::StringToInt("9s").value()};
+    Rule rule(deck, 10.0, 10.0, GameRound::kTurn, board, 1, 0.5, 1.0, 50.0, build_settings);
+    auto tree = std::make_shared<GameTree>(rule);
+    const uint64_t board_mask = Card::CardIntsToUint64(board);
+    std::vector<PrivateCards> range;
+    for (int c1 = 0; c1 < 16; ++c1) {
+        for (int c2 = c1 + 1; c2 < 16; ++c2) {
+            if (!Card::DoBoardsOverlap((1ULL << c1) | (1ULL << c2), board_mask)) range.emplace_back(c1, c2);
+        }
+    }
+    auto pcm = std::make_shared<PrivateCardsManager>(std::vector<std::vector<PrivateCards>>{range, range}, board_mask);
+    auto rrm = std::make_shared<RiverRangeManager>(std::make_shared<test_support::ToyCompairer>());
+    PCfrSolver::Config config;
+    config.iteration_limit = 3;
+    config.num_threads = 1;
+    config.exploitability_interval = 1;
+    PCfrSolver solver(tree, pcm, rrm, rule, config);
+    solver.Train();
+
+    const TraversalStats& stats = solver.GetTraversalStats();
+    const TraversalStats& last = solver.GetLastIterationTraversalStats();
+    if (!kTraversalStatsEnabled) {
+        EXPECT_EQ(stats.iterations, 0);
+        EXPECT_EQ(stats.Total().visits, 0u);
+        return;
+    }
+    EXPECT_EQ(stats.iterations, 3);
+    EXPECT_EQ(last.iterations, 1);
+    // Alternating updates: each visit computes the traverser's utility only.
+    // The best responses of the exploitability checks are not counted.
+    const NodeWorkStats turn_actions = stats.At(GameTreeNodeType::kAction, GameRound::kTurn);
+    EXPECT_GT(last.At(GameTreeNodeType::kAction, GameRound::kTurn).visits, 0u);
+    EXPECT_LT(last.At(GameTreeNodeType::kAction, GameRound::kTurn).visits, turn_actions.visits);
+    EXPECT_EQ(turn_actions.hands, turn_actions.visits * range.size());
+    EXPECT_GT(stats.Total(GameTreeNodeType::kChance).visits, 0u);
+    EXPECT_GT(stats.At(GameTreeNodeType::kShowdown, GameRound::kRiver).visits, 0u);
+    EXPECT_GT(stats.Total(GameTreeNodeType::kTerminal).visits, 0u);
+    EXPECT_EQ(stats.Total(GameTreeNodeType::kAction).visits +
+                  stats.Total(GameTreeNodeType::kChance).visits +
+                  stats.Total(GameTreeNodeType::kShowdown).visits +
+                  stats.Total(GameTreeNodeType::kTerminal).visits,
+              stats.Total().visits);
+    EXPECT_GT(stats.Total().nanoseconds, 0u);
+}
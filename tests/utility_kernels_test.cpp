@@ -0,0 +1,148 @@
+#include "gtest/gtest.h"
+#include "solver/UtilityKernels.h"
+#include "ranges/RiverCombs.h"
+#include "ranges/PrivateCards.h"
+#include "Card.h"
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+
+// Use namespaces
+using namespace poker_solver::core;
+using namespace poker_solver::ranges;
+using namespace poker_solver::solver;
+
+// Test fixture building synthetic river ranges with random ranks (including
+// plenty of ties) so the kernels can be compared against brute force.
+class UtilityKernelsTest : public ::testing::Test {
+ protected:
+  std::vector<PrivateCards> range_p0_;
+  std::vector<PrivateCards> range_p1_;
+  std::vector<double> reach_p0_;
+  std::vector<double> reach_p1_;
+  std::vector<int> ranks_p0_; // Rank per original index
+  std::vector<int> ranks_p1_;
+  uint64_t board_mask_ = 0;
+  std::mt19937 rng_{12345};
+
+  void SetUp() override {
+      // Board: 2c 7d 9h Js Ks (cards 0, 21, 30, 39, 47)
+      board_mask_ = Card::CardIntsToUint64({0, 21, 30, 39, 47});
+      std::uniform_real_distribution<double> reach_dist(0.0, 1.0);
+      std::uniform_int_distribution<int> rank_dist(1, 40); // Narrow range -> many ties
+      std::bernoulli_distribution keep(0.35);
+      for (int c1 = 0; c1 < kNumCardsInDeck; ++c1) {
+          for (int c2 = c1 + 1; c2 < kNumCardsInDeck; ++c2) {
+              uint64_t mask = (1ULL << c1) | (1ULL << c2);
+              if (Card::DoBoardsOverlap(mask, board_mask_)) continue;
+              // One rank per hand: identical hands in both ranges always tie.
+              int rank = rank_dist(rng_);
+              if (keep(rng_)) {
+                  range_p0_.emplace_back(c1, c2);
+                  reach_p0_.push_back(reach_dist(rng_));
+                  ranks_p0_.push_back(rank);
+              }
+              if (keep(rng_)) {
+                  range_p1_.emplace_back(c1, c2);
+                  reach_p1_.push_back(reach_dist(rng_));
+                  ranks_p1_.push_back(rank);
+              }
+          }
+      }
+      // A few zero-reach hands on each side.
+      reach_p0_[0] = 0.0;
+      reach_p1_[1] = 0.0;
+  }
+
+  // Builds combos sorted the way RiverRangeManager does (worst first).
+  std::vector<RiverCombs> MakeCombos(const std::vector<PrivateCards>& range,
+                                     const std::vector<int>& ranks) const {
+      std::vector<RiverCombs> combos;
+      for (size_t i = 0; i < range.size(); ++i) {
+          combos.emplace_back(range[i], ranks[i], i);
+      }
+      std::sort(combos.begin(), combos.end(),
+                [](const RiverCombs& a, const RiverCombs& b) { return a.rank > b.rank; });
+      return combos;
+  }
+
+  static std::vector<double> BruteForceShowdown(
+      const std::vector<RiverCombs>& trav, const std::vector<RiverCombs>& opp,
+      const std::vector<double>& trav_reach, const std::vector<double>& opp_reach,
+      double win, double lose, double tie) {
+      std::vector<double> result(trav_reach.size(), 0.0);
+      for (const auto& t : trav) {
+          double ev = 0.0;
+          for (const auto& o : opp) {
+              if (Card::DoBoardsOverlap(t.private_cards.GetBoardMask(), o.private_cards.GetBoardMask())) continue;
+              double r = opp_reach[o.original_range_index];
+              if (t.rank < o.rank) ev += r * win;
+              else if (o.rank < t.rank) ev += r * lose;
+              else ev += r * tie;
+          }
+          result[t.original_range_index] = ev;
+      }
+      return result;
+  }
+};
+
+// --- Tests ---
+
+TEST_F(UtilityKernelsTest, ShowdownSweepMatchesBruteForce) {
+    auto trav = MakeCombos(range_p0_, ranks_p0_);
+    auto opp = MakeCombos(range_p1_, ranks_p1_);
+
+    const double win = 7.5, lose = -4.0, tie = 1.75;
+    auto expected = BruteForceShowdown(trav, opp, reach_p0_, reach_p1_, win, lose, tie);
+    auto actual = ShowdownUtilitySweep(trav, opp, reach_p0_.size(), reach_p1_, win, lose, tie);
+
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_NEAR(actual[i], expected[i], 1e-9) << "Hand " << range_p0_[i].ToString();
+    }
+    EXPECT_NE(actual[0], 0.0); // Zero own reach still gets its counterfactual value
+}
+
+TEST_F(UtilityKernelsTest, ShowdownSweepZeroTiePayoff) {
+    auto trav = MakeCombos(range_p1_, ranks_p1_);
+    auto opp = MakeCombos(range_p0_, ranks_p0_);
+    auto expected = BruteForceShowdown(trav, opp, reach_p1_, reach_p0_, 10.0, -10.0, 0.0);
+    auto actual = ShowdownUtilitySweep(trav, opp, reach_p1_.size(), reach_p0_, 10.0, -10.0, 0.0);
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_NEAR(actual[i], expected[i], 1e-9);
+    }
+}
+
+TEST_F(UtilityKernelsTest, ShowdownSweepInvalidIndexThrows) {
+    auto trav = MakeCombos(range_p0_, ranks_p0_);
+    auto opp = MakeCombos(range_p1_, ranks_p1_);
+    EXPECT_THROW(ShowdownUtilitySweep(trav, opp, 1, reach_p1_, 1.0, -1.0, 0.0), std::out_of_range);
+    std::vector<double> short_reach(1, 1.0);
+    EXPECT_THROW(ShowdownUtilitySweep(trav, opp, reach_p0_.size(), short_reach, 1.0, -1.0, 0.0), std::out_of_range);
+}
+
+TEST_F(UtilityKernelsTest, FoldLinearMatchesPairwise) {
+    auto expected = FoldUtilityPairwise(range_p0_, range_p1_, reach_p1_, -3.25);
+    auto actual = FoldUtilityLinear(range_p0_, range_p1_, reach_p1_, -3.25);
+    ASSERT_EQ(actual.size(), range_p0_.size());
+    ASSERT_EQ(expected.size(), range_p0_.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_NEAR(actual[i], expected[i], 1e-9) << "Hand " << range_p0_[i].ToString();
+    }
+    EXPECT_NE(actual[0], 0.0); // Zero own reach still gets its counterfactual value
+
+    // Same range on both sides exercises the identical-hand correction.
+    auto expected_self = FoldUtilityPairwise(range_p1_, range_p1_, reach_p1_, 2.0);
+    auto actual_self = FoldUtilityLinear(range_p1_, range_p1_, reach_p1_, 2.0);
+    for (size_t i = 0; i < expected_self.size(); ++i) {
+        EXPECT_NEAR(actual_self[i], expected_self[i], 1e-9);
+    }
+}
+
+TEST_F(UtilityKernelsTest, FoldReachSizeMismatchThrows) {
+    std::vector<double> short_reach(1, 1.0);
+    EXPECT_THROW(FoldUtilityLinear(range_p0_, range_p1_, short_reach, 1.0), std::invalid_argument);
+    EXPECT_THROW(FoldUtilityPairwise(range_p0_, range_p1_, short_reach, 1.0), std::invalid_argument);
+}
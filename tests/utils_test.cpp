@@ -2,6 +2,7 @@
 #include "tools/utils.h"        // Adjust path if needed
 #include "ranges/PrivateCards.h" // Adjust path if needed
 #include "Card.h"          // Adjust path if needed
+#include "Library.h"
 #include <vector>
 #include <string>
 #include <numeric> // For std::iota
@@ -157,3 +158,64 @@ TEST_F(UtilsTest, EdgeCases) {
     EXPECT_THROW(ExchangeColorIsomorphism(test_values_, test_range_, -1, s), std::out_of_range);
     EXPECT_THROW(ExchangeColorIsomorphism(test_values_, test_range_, c, 4), std::out_of_range);
 }
+
+// Test the precomputed suit-swap permutation
+TEST(UtilsPermutationTest, ColorIsomorphismPermutation) {
+    auto hand = [](const char* c1, const char* c2, double weight = 1.0) {
+        return PrivateCards(Card::StringToInt(c1).value(), Card::StringToInt(c2).value(), weight);
+    };
+    std::vector<PrivateCards> range = {hand("Ac", "Kc"), hand("As", "Ks"), hand("Qc", "Qd"),
+                                       hand("Qs", "Qd", 0.5), hand("7h", "2h"), hand("Jc", "Tc")};
+    std::vector<int> permutation = ColorIsomorphismPermutation(range, 0, 3);
+    ASSERT_EQ(permutation.size(), range.size());
+    EXPECT_EQ(permutation[0], 1);
+    EXPECT_EQ(permutation[1], 0);
+    EXPECT_EQ(permutation[2], -1); // Partner QsQd has a different weight
+    EXPECT_EQ(permutation[3], -1);
+    EXPECT_EQ(permutation[4], 4);  // No club or spade: maps to itself
+    EXPECT_EQ(permutation[5], -1); // JsTs is not in the range
+    EXPECT_THROW(ColorIsomorphismPermutation(range, 0, 4), std::out_of_range);
+}
+
+// The lazy generator walks the same order the eager Combinations class
+// stores, and unranking lands on the same combination as stepping.
+TEST(UtilsCombinationTest, GeneratorMatchesCombinationsAndUnranking) {
+    using poker_solver::utils::CombinationCount;
+    using poker_solver::utils::CombinationIndices;
+    using poker_solver::utils::Combinations;
+    using poker_solver::utils::UnrankCombination;
+    const int n = 9;
+    const int k = 4;
+    std::vector<int> items(n);
+    std::iota(items.begin(), items.end(), 0);
+    Combinations<int> eager(items, k);
+    ASSERT_EQ(eager.GetCombinations().size(), CombinationCount(n, k));
+
+    CombinationIndices<4> combo(n, k);
+    ASSERT_TRUE(combo.Valid());
+    uint64_t rank = 0;
+    do {
+        const std::vector<int>& expected = eager.GetCombinations()[rank];
+        EXPECT_EQ(std::vector<int>(combo.Indices(), combo.Indices() + k), expected);
+        int unranked[4];
+        ASSERT_TRUE(UnrankCombination(rank, n, k, unranked));
+        EXPECT_EQ(std::vector<int>(unranked, unranked + k), expected);
+        ++rank;
+    } while (combo.Next());
+    EXPECT_EQ(rank, CombinationCount(n, k));
+
+    // Seeking splits the enumeration into independent ranges.
+    CombinationIndices<4> second_half(n, k);
+    ASSERT_TRUE(second_half.Seek(rank / 2));
+    uint64_t remaining = 1;
+    while (second_half.Next()) ++remaining;
+    EXPECT_EQ(remaining, rank - rank / 2);
+
+    int out[4];
+    EXPECT_FALSE(UnrankCombination(rank, n, k, out));
+    EXPECT_FALSE(second_half.Seek(rank));
+    EXPECT_FALSE(CombinationIndices<4>(3, 4).Valid());
+    EXPECT_FALSE(CombinationIndices<2>(9, 3).Valid());
+    EXPECT_EQ(CombinationCount(52, 5), 2598960u);
+    EXPECT_EQ(CombinationCount(3, 4), 0u);
+}